@@ -24,6 +24,7 @@ Backup Command
 #include "common/log.h"
 #include "common/regExp.h"
 #include "common/time.h"
+#include "common/trace.h"
 #include "common/type/convert.h"
 #include "common/type/json.h"
 #include "config/config.h"
@@ -134,6 +135,198 @@ backupLabelCreate(BackupType type, const String *backupLabelPrior, time_t timest
     FUNCTION_LOG_RETURN(STRING, result);
 }
 
+/***********************************************************************************************************************************
+Repos that the backup is also written to (see the tee-repo option). Files are encrypted with the backup cipher subpass, which is the
+same in all the repos, so the bytes stored in the repos are identical and files can be copied between them as stored. The manifest
+and backup.info are saved in each repo with the cipher pass of the repo.
+***********************************************************************************************************************************/
+typedef struct BackupRepoTee
+{
+    unsigned int repoIdx;                                           // Repo index
+    InfoBackup *infoBackup;                                         // Backup info loaded from the repo
+    bool failed;                                                    // Has writing the backup to the repo failed?
+} BackupRepoTee;
+
+// Stop writing the backup to a repo after an error. The backup continues in the other repos.
+static void
+backupRepoTeeFail(BackupRepoTee *const repoTee, const String *const error)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM_P(VOID, repoTee);
+        FUNCTION_LOG_PARAM(STRING, error);
+    FUNCTION_LOG_END();
+
+    ASSERT(repoTee != NULL);
+    ASSERT(!repoTee->failed);
+    ASSERT(error != NULL);
+
+    LOG_WARN_FMT(
+        "%s: %s\nHINT: the backup will not be written to this repo.", cfgOptionGroupName(cfgOptGrpRepo, repoTee->repoIdx),
+        strZ(error));
+
+    repoTee->failed = true;
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+// Stop writing the backup to a repo after the error that was caught
+static void
+backupRepoTeeFailCatch(BackupRepoTee *const repoTee)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, repoTee);
+    FUNCTION_TEST_END();
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        backupRepoTeeFail(repoTee, strNewFmt("[%s] %s", errorTypeName(errorType()), errorMessage()));
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+// Get the repos listed in the tee-repo option. A repo that can't be loaded or does not match the stanza is skipped with a warning.
+static List *
+backupRepoTeeInit(const InfoBackup *const infoBackup)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(INFO_BACKUP, infoBackup);
+    FUNCTION_LOG_END();
+
+    ASSERT(infoBackup != NULL);
+
+    List *const result = lstNewP(sizeof(BackupRepoTee));
+
+    if (cfgOptionTest(cfgOptTeeRepo))
+    {
+        const unsigned int repoIdxDefault = cfgOptionGroupIdxDefault(cfgOptGrpRepo);
+
+        // Hardlinks and the dedup store refer to files in prior backups that are only known to exist in the repo of the backup
+        if (cfgOptionBool(cfgOptRepoHardlink) || (cfgOptionTest(cfgOptRepoDedup) && cfgOptionBool(cfgOptRepoDedup)))
+        {
+            THROW_FMT(
+                OptionInvalidError, "option '" CFGOPT_TEE_REPO "' not valid with '%s' or '%s' options",
+                cfgOptionIdxName(cfgOptRepoHardlink, repoIdxDefault), cfgOptionIdxName(cfgOptRepoDedup, repoIdxDefault));
+        }
+
+        // Resume is disabled since a resumable backup would need to be found and checked in each repo
+        if (cfgOptionBool(cfgOptResume))
+        {
+            LOG_INFO("resume is disabled since option '" CFGOPT_TEE_REPO "' is set");
+            cfgOptionSet(cfgOptResume, cfgSourceParam, BOOL_FALSE_VAR);
+        }
+
+        const StringList *const teeRepoList = strLstNewVarLst(cfgOptionLst(cfgOptTeeRepo));
+
+        for (unsigned int teeRepoIdx = 0; teeRepoIdx < strLstSize(teeRepoList); teeRepoIdx++)
+        {
+            const String *const teeRepo = strLstGet(teeRepoList, teeRepoIdx);
+            unsigned int repoIdx = 0;
+
+            // Find the repo index for the key
+            for (; repoIdx < cfgOptionGroupIdxTotal(cfgOptGrpRepo); repoIdx++)
+            {
+                if (strEq(teeRepo, strNewFmt("%u", cfgOptionGroupIdxToKey(cfgOptGrpRepo, repoIdx))))
+                    break;
+            }
+
+            bool listed = false;
+
+            for (unsigned int repoTeeIdx = 0; repoTeeIdx < lstSize(result); repoTeeIdx++)
+            {
+                if (((BackupRepoTee *)lstGet(result, repoTeeIdx))->repoIdx == repoIdx)
+                    listed = true;
+            }
+
+            if (repoIdx == cfgOptionGroupIdxTotal(cfgOptGrpRepo) || repoIdx == repoIdxDefault || listed)
+            {
+                THROW_FMT(
+                    OptionInvalidError, "'%s' is not valid for '" CFGOPT_TEE_REPO "' option\n"
+                    "HINT: repos must be configured, listed once, and not be the repo selected for the backup.", strZ(teeRepo));
+            }
+
+            // The repo must be encrypted the same way so files can be written to all repos as they are stored
+            if (cfgOptionIdxStrId(cfgOptRepoCipherType, repoIdx) != cfgOptionIdxStrId(cfgOptRepoCipherType, repoIdxDefault))
+            {
+                THROW_FMT(
+                    OptionInvalidError, "'%s' is not valid for '" CFGOPT_TEE_REPO "' option\n"
+                    "HINT: the repo must have the same '%s' as the repo selected for the backup.", strZ(teeRepo),
+                    cfgOptionIdxName(cfgOptRepoCipherType, repoIdx));
+            }
+
+            repoIsLocalVerifyIdx(repoIdx);
+
+            lstAdd(result, &(BackupRepoTee){.repoIdx = repoIdx});
+        }
+
+        // Load backup.info from each repo and check that it matches the stanza
+        const InfoPgData infoPg = infoPgDataCurrent(infoBackupPg(infoBackup));
+
+        for (unsigned int repoTeeIdx = 0; repoTeeIdx < lstSize(result); repoTeeIdx++)
+        {
+            BackupRepoTee *const repoTee = lstGet(result, repoTeeIdx);
+
+            TRY_BEGIN()
+            {
+                repoTee->infoBackup = infoBackupLoadFileReconstruct(
+                    storageRepoIdx(repoTee->repoIdx), INFO_BACKUP_PATH_FILE_STR,
+                    cfgOptionIdxStrId(cfgOptRepoCipherType, repoTee->repoIdx),
+                    cfgOptionIdxStrNull(cfgOptRepoCipherPass, repoTee->repoIdx));
+
+                const InfoPgData infoPgTee = infoPgDataCurrent(infoBackupPg(repoTee->infoBackup));
+
+                if (infoPgTee.id != infoPg.id || infoPgTee.version != infoPg.version || infoPgTee.systemId != infoPg.systemId)
+                {
+                    THROW_FMT(
+                        BackupMismatchError, "stanza does not match the stanza in %s",
+                        cfgOptionGroupName(cfgOptGrpRepo, repoIdxDefault));
+                }
+            }
+            CATCH_ANY()
+            {
+                backupRepoTeeFailCatch(repoTee);
+            }
+            TRY_END();
+        }
+    }
+
+    FUNCTION_LOG_RETURN(LIST, result);
+}
+
+// Copy a file in the repo of the backup to the repos the backup is also written to
+static void
+backupRepoTeeCopy(const List *const repoTeeList, const String *const file)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(LIST, repoTeeList);
+        FUNCTION_LOG_PARAM(STRING, file);
+    FUNCTION_LOG_END();
+
+    ASSERT(repoTeeList != NULL);
+    ASSERT(file != NULL);
+
+    for (unsigned int repoTeeIdx = 0; repoTeeIdx < lstSize(repoTeeList); repoTeeIdx++)
+    {
+        BackupRepoTee *const repoTee = lstGet(repoTeeList, repoTeeIdx);
+
+        if (!repoTee->failed)
+        {
+            TRY_BEGIN()
+            {
+                storageCopyP(storageNewReadP(storageRepo(), file), storageNewWriteP(storageRepoIdxWrite(repoTee->repoIdx), file));
+            }
+            CATCH_ANY()
+            {
+                backupRepoTeeFailCatch(repoTee);
+            }
+            TRY_END();
+        }
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
 /***********************************************************************************************************************************
 Get the postgres database and storage objects
 ***********************************************************************************************************************************/
@@ -160,6 +353,8 @@ typedef struct BackupData
     unsigned int timeline;                                          // Primary timeline
     unsigned int version;                                           // PostgreSQL version
     unsigned int walSegmentSize;                                    // PostgreSQL wal segment size
+
+    List *repoTeeList;                                              // Repos the backup is also written to (see BackupRepoTee)
 } BackupData;
 
 static BackupData *
@@ -486,6 +681,44 @@ backupBuildIncr(const InfoBackup *infoBackup, Manifest *manifest, Manifest *mani
     FUNCTION_LOG_RETURN(BOOL, result);
 }
 
+/***********************************************************************************************************************************
+Get the bytes between checkpoints of large files so they can be resumed (see backupFile()). Checkpoints are not made for bundled
+files, files in the dedup store, files teed to other repos, or when the repo storage is remote.
+***********************************************************************************************************************************/
+static uint64_t
+backupCheckpointSize(void)
+{
+    FUNCTION_TEST_VOID();
+
+    uint64_t result = 0;
+
+    if (cfgOptionBool(cfgOptResume) && !cfgOptionBool(cfgOptRepoBundle) &&
+        !(cfgOptionTest(cfgOptRepoDedup) && cfgOptionBool(cfgOptRepoDedup)) && !cfgOptionTest(cfgOptTeeRepo) &&
+        repoIsLocal(cfgOptionGroupIdxDefault(cfgOptGrpRepo)))
+    {
+        result = cfgOptionUInt64(cfgOptResumeCheckpoint);
+    }
+
+    FUNCTION_TEST_RETURN(UINT64, result);
+}
+
+/***********************************************************************************************************************************
+Get the size of the parts that large files are split into so the parts can be copied in parallel. The size is rounded down to a
+multiple of the page size so page checksums can be validated in each part. Files are not split when stored in the dedup store.
+***********************************************************************************************************************************/
+static uint64_t
+backupSplitSize(void)
+{
+    FUNCTION_TEST_VOID();
+
+    uint64_t result = 0;
+
+    if (!(cfgOptionTest(cfgOptRepoDedup) && cfgOptionBool(cfgOptRepoDedup)))
+        result = cfgOptionUInt64(cfgOptSplitSize) / PG_PAGE_SIZE_DEFAULT * PG_PAGE_SIZE_DEFAULT;
+
+    FUNCTION_TEST_RETURN(UINT64, result);
+}
+
 /***********************************************************************************************************************************
 Check for a backup that can be resumed and merge into the manifest if found
 ***********************************************************************************************************************************/
@@ -493,7 +726,8 @@ Check for a backup that can be resumed and merge into the manifest if found
 static void
 backupResumeClean(
     StorageIterator *const storageItr, Manifest *const manifest, const Manifest *const manifestResume,
-    const CompressType compressType, const bool delta, const String *const backupParentPath, const String *const manifestParentName)
+    const CompressType compressType, const bool delta, const uint64_t checkpointSize, const String *const backupParentPath,
+    const String *const manifestParentName)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(STORAGE_ITERATOR, storageItr);           // Storage info
@@ -501,6 +735,7 @@ backupResumeClean(
         FUNCTION_LOG_PARAM(MANIFEST, manifestResume);               // Resumed manifest
         FUNCTION_LOG_PARAM(ENUM, compressType);                     // Backup compression type
         FUNCTION_LOG_PARAM(BOOL, delta);                            // Is this a delta backup?
+        FUNCTION_LOG_PARAM(UINT64, checkpointSize);                 // Bytes between checkpoints of large files
         FUNCTION_LOG_PARAM(STRING, backupParentPath);               // Path to the current level of the backup being cleaned
         FUNCTION_LOG_PARAM(STRING, manifestParentName);             // Parent manifest name used to construct manifest name
     FUNCTION_LOG_END();
@@ -546,7 +781,7 @@ backupResumeClean(
                     {
                         backupResumeClean(
                             storageNewItrP(storageRepo(), backupPath, .sortOrder = sortOrderAsc), manifest, manifestResume,
-                            compressType, delta, backupPath, manifestName);
+                            compressType, delta, checkpointSize, backupPath, manifestName);
                     }
 
                     break;
@@ -556,6 +791,12 @@ backupResumeClean(
                 // -----------------------------------------------------------------------------------------------------------------
                 case storageTypeFile:
                 {
+                    // A checkpoint is checked with the file it belongs to so strip off the extension before doing the lookup
+                    const bool checkpoint = strEndsWithZ(manifestName, BACKUP_FILE_CHECKPOINT_EXT);
+
+                    if (checkpoint)
+                        manifestName = strSubN(manifestName, 0, strSize(manifestName) - (sizeof(BACKUP_FILE_CHECKPOINT_EXT) - 1));
+
                     // If the file is compressed then strip off the extension before doing the lookup
                     const CompressType fileCompressType = compressTypeFromName(manifestName);
 
@@ -583,8 +824,24 @@ backupResumeClean(
 
                             if (fileResume.reference != NULL)
                                 removeReason = "reference in resumed manifest";
+                            // A file without a checksum was not completed. It can be resumed when it has a checkpoint and has not
+                            // changed.
                             else if (fileResume.checksumSha1[0] == '\0')
-                                removeReason = "no checksum in resumed manifest";
+                            {
+                                if (checkpointSize == 0 || file.size < checkpointSize ||
+                                    (!checkpoint &&
+                                     !storageExistsP(
+                                         storageRepo(), strNewFmt("%s" BACKUP_FILE_CHECKPOINT_EXT, strZ(backupPath)))))
+                                {
+                                    removeReason = "no checksum in resumed manifest";
+                                }
+                                else if (file.size != fileResume.size)
+                                    removeReason = "mismatched size";
+                                else if (!delta && file.timestamp != fileResume.timestamp)
+                                    removeReason = "mismatched timestamp";
+                            }
+                            else if (checkpoint)
+                                removeReason = "checkpoint of completed file";
                             else if (file.size != fileResume.size)
                                 removeReason = "mismatched size";
                             else if (!delta && file.timestamp != fileResume.timestamp)
@@ -596,7 +853,8 @@ backupResumeClean(
                             {
                                 manifestFileUpdate(
                                     manifest, manifestName, file.size, fileResume.sizeRepo, fileResume.checksumSha1, NULL,
-                                    fileResume.checksumPage, fileResume.checksumPageError, fileResume.checksumPageErrorList, 0, 0);
+                                    fileResume.checksumPage, fileResume.checksumPageError, fileResume.checksumPageErrorList, 0, 0,
+                                    false, false, fileResume.compressFast, fileResume.checksumRepo, 0, NULL);
                             }
                         }
                     }
@@ -798,7 +1056,8 @@ backupResume(Manifest *manifest, const String *cipherPassBackup)
 
             backupResumeClean(
                 storageNewItrP(storageRepo(), backupPath, .sortOrder = sortOrderAsc), manifest, manifestResume,
-                compressTypeEnum(cfgOptionStrId(cfgOptCompressType)), cfgOptionBool(cfgOptDelta), backupPath, NULL);
+                compressTypeEnum(cfgOptionStrId(cfgOptCompressType)), cfgOptionBool(cfgOptDelta), backupCheckpointSize(),
+                backupPath, NULL);
         }
     }
     MEM_CONTEXT_TEMP_END();
@@ -929,13 +1188,11 @@ backupFilePut(BackupData *backupData, Manifest *manifest, const String *name, ti
             // Create file
             const String *manifestName = strNewFmt(MANIFEST_TARGET_PGDATA "/%s", strZ(name));
             CompressType compressType = compressTypeEnum(cfgOptionStrId(cfgOptCompressType));
+            const String *const repoFile = strNewFmt(
+                STORAGE_REPO_BACKUP "/%s/%s%s", strZ(manifestData(manifest)->backupLabel), strZ(manifestName),
+                strZ(compressExtStr(compressType)));
 
-            StorageWrite *write = storageNewWriteP(
-                storageRepoWrite(),
-                strNewFmt(
-                    STORAGE_REPO_BACKUP "/%s/%s%s", strZ(manifestData(manifest)->backupLabel), strZ(manifestName),
-                    strZ(compressExtStr(compressType))),
-                .compressible = true);
+            StorageWrite *write = storageNewWriteP(storageRepoWrite(), repoFile, .compressible = true);
 
             IoFilterGroup *filterGroup = ioWriteFilterGroup(storageWriteIo(write));
 
@@ -958,6 +1215,7 @@ backupFilePut(BackupData *backupData, Manifest *manifest, const String *name, ti
 
             // Write file
             storagePutP(write, BUFSTR(content));
+            backupRepoTeeCopy(backupData->repoTeeList, repoFile);
 
             // Use base path to set ownership and mode
             const ManifestPath *basePath = manifestPathFind(manifest, MANIFEST_TARGET_PGDATA_STR);
@@ -1131,14 +1389,205 @@ backupJobResultPageChecksum(PackRead *const checksumPageResult)
     FUNCTION_LOG_RETURN(VARIANT_LIST, result);
 }
 
+/***********************************************************************************************************************************
+Files larger than split-size are split into parts that are copied by separate jobs so a very large file can be copied by all the
+processes. The file is stored in the manifest when all the parts have been copied. In a delta backup each part of a file that was
+split into the same parts in the prior backup is checked against the checksum of the part so only the changed parts are copied.
+***********************************************************************************************************************************/
+typedef struct BackupJobSplitPart
+{
+    ProtocolParallelJob *job;                                       // Job copying the part
+    bool done;                                                      // Has the part been copied or matched?
+    bool skip;                                                      // Was the pg file missing when the part was copied?
+    bool noOp;                                                      // Did the part match the part in the prior backup?
+    bool compressFast;                                              // Was the part compressed at the fastest level?
+    uint64_t copySize;                                              // Bytes copied from the pg file
+    uint64_t repoSize;                                              // Size of the part in the repo
+    String *checksum;                                               // SHA1 checksum of the bytes copied
+    Pack *pageChecksum;                                             // Page checksum result
+} BackupJobSplitPart;
+
+typedef struct BackupJobSplit
+{
+    const String *name;                                             // Manifest file name (must be first member)
+    List *queue;                                                    // Queue to return the file to when it must be copied whole
+    uint64_t size;                                                  // File size
+    uint64_t splitSize;                                             // Size of each part (the last part may be smaller)
+    StringList *repoFileList;                                       // Repo file of each part
+    List *partList;                                                 // Parts of the file
+    unsigned int partNext;                                          // Next part to copy
+    unsigned int partDone;                                          // Parts that have been copied or matched
+    bool delta;                                                     // Check the parts against the parts in the prior backup?
+    bool whole;                                                     // Copy the file whole, e.g. because it changed size
+} BackupJobSplit;
+
+// Expected size of a part
+static uint64_t
+backupJobSplitPartSize(const BackupJobSplit *const split, const unsigned int partIdx)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, split);
+        FUNCTION_TEST_PARAM(UINT, partIdx);
+    FUNCTION_TEST_END();
+
+    ASSERT(split != NULL);
+
+    const uint64_t offset = partIdx * split->splitSize;
+
+    FUNCTION_TEST_RETURN(UINT64, split->size - offset < split->splitSize ? split->size - offset : split->splitSize);
+}
+
+// Find the split file and part copied by a job
+static BackupJobSplit *
+backupJobSplitFind(const List *const splitList, const ProtocolParallelJob *const job, unsigned int *const partIdx)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(LIST, splitList);
+        FUNCTION_TEST_PARAM(PROTOCOL_PARALLEL_JOB, job);
+        FUNCTION_TEST_PARAM_P(UINT, partIdx);
+    FUNCTION_TEST_END();
+
+    ASSERT(job != NULL);
+    ASSERT(partIdx != NULL);
+
+    BackupJobSplit *result = NULL;
+
+    for (unsigned int splitIdx = 0; splitIdx < lstSize(splitList) && result == NULL; splitIdx++)
+    {
+        BackupJobSplit *const split = lstGet(splitList, splitIdx);
+
+        for (unsigned int splitPartIdx = 0; splitPartIdx < lstSize(split->partList); splitPartIdx++)
+        {
+            if (((BackupJobSplitPart *)lstGet(split->partList, splitPartIdx))->job == job)
+            {
+                result = split;
+                *partIdx = splitPartIdx;
+                break;
+            }
+        }
+    }
+
+    FUNCTION_TEST_RETURN_TYPE_P(BackupJobSplit, result);
+}
+
+// Remove the parts of a split file from the repos when the file will not be stored in parts
+static void
+backupJobSplitRemove(const BackupJobSplit *const split, const List *const repoTeeList)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM_P(VOID, split);
+        FUNCTION_LOG_PARAM(LIST, repoTeeList);
+    FUNCTION_LOG_END();
+
+    ASSERT(split != NULL);
+
+    for (unsigned int partIdx = 0; partIdx < strLstSize(split->repoFileList); partIdx++)
+    {
+        const String *const repoFile = strLstGet(split->repoFileList, partIdx);
+
+        storageRemoveP(storageRepoWrite(), repoFile);
+
+        for (unsigned int repoTeeIdx = 0; repoTeeIdx < lstSize(repoTeeList); repoTeeIdx++)
+        {
+            BackupRepoTee *const repoTee = lstGet(repoTeeList, repoTeeIdx);
+
+            if (!repoTee->failed)
+            {
+                TRY_BEGIN()
+                {
+                    storageRemoveP(storageRepoIdxWrite(repoTee->repoIdx), repoFile);
+                }
+                CATCH_ANY()
+                {
+                    backupRepoTeeFailCatch(repoTee);
+                }
+                TRY_END();
+            }
+        }
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+// Merge the page checksum results of the parts into the result for the file. Page numbers are relative to the file so the errors
+// of the parts can be concatenated in order.
+static Pack *
+backupJobSplitPageChecksum(const BackupJobSplit *const split)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM_P(VOID, split);
+    FUNCTION_LOG_END();
+
+    ASSERT(split != NULL);
+
+    Pack *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        PackWrite *const pageChecksum = pckWriteNewP();
+        bool error = false;
+        bool valid = true;
+        bool align = true;
+
+        for (unsigned int partIdx = 0; partIdx < lstSize(split->partList); partIdx++)
+        {
+            PackRead *const partPageChecksum = pckReadNew(((BackupJobSplitPart *)lstGet(split->partList, partIdx))->pageChecksum);
+
+            if (!pckReadNullP(partPageChecksum))
+            {
+                if (!error)
+                {
+                    pckWriteArrayBeginP(pageChecksum);
+                    error = true;
+                }
+
+                pckReadArrayBeginP(partPageChecksum);
+
+                while (pckReadNext(partPageChecksum))
+                {
+                    const unsigned int pageId = pckReadId(partPageChecksum);
+
+                    pckReadObjBeginP(partPageChecksum, .id = pageId);
+                    pckReadObjEndP(partPageChecksum);
+
+                    pckWriteObjBeginP(pageChecksum, .id = pageId);
+                    pckWriteObjEndP(pageChecksum);
+                }
+
+                pckReadArrayEndP(partPageChecksum);
+            }
+
+            if (!pckReadBoolP(partPageChecksum))
+                valid = false;
+
+            if (!pckReadBoolP(partPageChecksum))
+                align = false;
+        }
+
+        if (error)
+            pckWriteArrayEndP(pageChecksum);
+        else
+            pckWriteNullP(pageChecksum);
+
+        pckWriteBoolP(pageChecksum, valid, .defaultWrite = true);
+        pckWriteBoolP(pageChecksum, align, .defaultWrite = true);
+        pckWriteEndP(pageChecksum);
+
+        result = pckMove(pckWriteResult(pageChecksum), memContextPrior());
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(PACK, result);
+}
+
 /***********************************************************************************************************************************
 Log the results of a job and throw errors
 ***********************************************************************************************************************************/
 static void
 backupJobResult(
     Manifest *const manifest, const String *const host, const Storage *const storagePg, StringList *const fileRemove,
-    ProtocolParallelJob *const job, const bool bundle, const uint64_t sizeTotal, uint64_t *const sizeProgress,
-    unsigned int *const currentPercentComplete)
+    ProtocolParallelJob *const job, const List *const repoTeeList, const List *const splitList, const bool bundle,
+    const bool bundleDict, const uint64_t sizeTotal, uint64_t *const sizeProgress, unsigned int *const currentPercentComplete)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(MANIFEST, manifest);
@@ -1146,7 +1595,10 @@ backupJobResult(
         FUNCTION_LOG_PARAM(STORAGE, storagePg);
         FUNCTION_LOG_PARAM(STRING_LIST, fileRemove);
         FUNCTION_LOG_PARAM(PROTOCOL_PARALLEL_JOB, job);
+        FUNCTION_LOG_PARAM(LIST, repoTeeList);
+        FUNCTION_LOG_PARAM(LIST, splitList);
         FUNCTION_LOG_PARAM(BOOL, bundle);
+        FUNCTION_LOG_PARAM(BOOL, bundleDict);
         FUNCTION_LOG_PARAM(UINT64, sizeTotal);
         FUNCTION_LOG_PARAM_P(UINT64, sizeProgress);
         FUNCTION_LOG_PARAM_P(UINT, currentPercentComplete);
@@ -1168,15 +1620,40 @@ backupJobResult(
             PackRead *const jobResult = protocolParallelJobResult(job);
             unsigned int percentComplete = 0;
 
+            // Stop writing to repos that failed to tee
+            pckReadArrayBeginP(jobResult);
+
+            while (!pckReadNullP(jobResult))
+            {
+                const unsigned int repoIdx = pckReadU32P(jobResult);
+                const String *const error = pckReadStrP(jobResult);
+
+                for (unsigned int repoTeeIdx = 0; repoTeeIdx < lstSize(repoTeeList); repoTeeIdx++)
+                {
+                    BackupRepoTee *const repoTee = lstGet(repoTeeList, repoTeeIdx);
+
+                    // The repo may have failed already, e.g. in another job
+                    if (repoTee->repoIdx == repoIdx && !repoTee->failed)
+                        backupRepoTeeFail(repoTee, error);
+                }
+            }
+
+            pckReadArrayEndP(jobResult);
+
             while (!pckReadNullP(jobResult))
             {
                 const ManifestFile file = manifestFileFind(manifest, pckReadStrP(jobResult));
-                const BackupCopyResult copyResult = (BackupCopyResult)pckReadU32P(jobResult);
-                const uint64_t copySize = pckReadU64P(jobResult);
+                BackupCopyResult copyResult = (BackupCopyResult)pckReadU32P(jobResult);
+                uint64_t copySize = pckReadU64P(jobResult);
                 const uint64_t bundleOffset = pckReadU64P(jobResult);
-                const uint64_t repoSize = pckReadU64P(jobResult);
-                const String *const copyChecksum = pckReadStrP(jobResult);
-                PackRead *const checksumPageResult = pckReadPackReadP(jobResult);
+                uint64_t repoSize = pckReadU64P(jobResult);
+                const String *copyChecksum = pckReadStrP(jobResult);
+                Pack *checksumPagePack = pckReadPackP(jobResult);
+                const bool dedup = pckReadBoolP(jobResult);
+                bool compressFast = pckReadBoolP(jobResult);
+                const String *repoChecksum = pckReadStrP(jobResult);
+                uint64_t splitSize = 0;
+                String *splitChecksum = NULL;
 
                 // Increment backup copy progress
                 *sizeProgress += copySize;
@@ -1185,37 +1662,178 @@ backupJobResult(
                 const String *const fileName = storagePathP(storagePg, manifestPathPg(file.name));
                 const String *const fileLog = host == NULL ? fileName : strNewFmt("%s:%s", strZ(host), strZ(fileName));
 
-                // Format log progress
-                String *const logProgress = strNew();
-
-                if (bundleId != 0)
-                    strCatFmt(logProgress, "bundle %" PRIu64 "/%" PRIu64 ", ", bundleId, bundleOffset);
-
                 // Store percentComplete as an integer
                 percentComplete = sizeTotal == 0 ? 10000 : (unsigned int)(((double)*sizeProgress / (double)sizeTotal) * 10000);
 
-                strCatFmt(
-                    logProgress, "%s, %u.%02u%%", strZ(strSizeFormat(copySize)), percentComplete / 100, percentComplete % 100);
-
-                // Format log checksum
-                const String *const logChecksum = copySize != 0 ? strNewFmt(" checksum %s", strZ(copyChecksum)) : EMPTY_STR;
+                // If the job copied a part of a split file then store the result of the part. The file is stored in the manifest
+                // when all the parts have been copied.
+                unsigned int partIdx = 0;
+                BackupJobSplit *const split = backupJobSplitFind(splitList, job, &partIdx);
 
-                // If the file is in a prior backup and nothing changed, just log it
-                if (copyResult == backupCopyResultNoOp)
-                {
-                    LOG_DETAIL_PID_FMT(
-                        processId, "match file from prior backup %s (%s)%s", strZ(fileLog), strZ(logProgress), strZ(logChecksum));
-                }
-                // Else if the repo matched the expect checksum, just log it
-                else if (copyResult == backupCopyResultChecksum)
-                {
-                    LOG_DETAIL_PID_FMT(
-                        processId, "checksum resumed file %s (%s)%s", strZ(fileLog), strZ(logProgress), strZ(logChecksum));
-                }
-                // Else if the file was removed during backup add it to the list of files to be removed from the manifest when the
-                // backup is complete. It can't be removed right now because that will invalidate the pointers that are being used
-                // for processing.
-                else if (copyResult == backupCopyResultSkip)
+                if (split != NULL)
+                {
+                    ASSERT(
+                        copyResult == backupCopyResultCopy || copyResult == backupCopyResultSkip ||
+                        copyResult == backupCopyResultNoOp);
+
+                    const unsigned int partTotal = lstSize(split->partList);
+                    BackupJobSplitPart *const part = lstGet(split->partList, partIdx);
+
+                    MEM_CONTEXT_BEGIN(lstMemContext(split->partList))
+                    {
+                        part->job = NULL;
+                        part->done = true;
+                        part->skip = copyResult == backupCopyResultSkip;
+                        part->noOp = copyResult == backupCopyResultNoOp;
+                        part->compressFast = compressFast;
+                        part->copySize = copySize;
+                        part->repoSize = repoSize;
+                        part->checksum = strDup(copyChecksum);
+                        part->pageChecksum = checksumPagePack != NULL ? pckDup(checksumPagePack) : NULL;
+                    }
+                    MEM_CONTEXT_END();
+
+                    if (!part->skip)
+                    {
+                        LOG_DETAIL_PID_FMT(
+                            processId, "%s %s part %u/%u (%s, %u.%02u%%)%s",
+                            part->noOp ? "match file from prior backup" : "backup file", strZ(fileLog), partIdx + 1, partTotal,
+                            strZ(strSizeFormat(copySize)), percentComplete / 100, percentComplete % 100,
+                            copySize != 0 ? strZ(strNewFmt(" checksum %s", strZ(copyChecksum))) : "");
+                    }
+
+                    // Continue until all the parts have been copied
+                    split->partDone++;
+
+                    if (split->partDone < partTotal)
+                        continue;
+
+                    // Assemble the result of the file from the parts. If the pg file was removed during the copy then skip it. If
+                    // the file changed size then the parts do not fit together so the file is copied again whole. If all the parts
+                    // matched the prior backup then the file matched.
+                    bool skip = false;
+                    bool whole = false;
+                    unsigned int noOpTotal = 0;
+
+                    copySize = 0;
+                    repoSize = 0;
+                    compressFast = true;
+                    splitChecksum = strNew();
+
+                    for (partIdx = 0; partIdx < partTotal; partIdx++)
+                    {
+                        const BackupJobSplitPart *const partCopy = lstGet(split->partList, partIdx);
+
+                        if (partCopy->skip)
+                            skip = true;
+                        else if (partCopy->noOp)
+                            noOpTotal++;
+                        else if (partCopy->copySize != backupJobSplitPartSize(split, partIdx))
+                            whole = true;
+
+                        copySize += partCopy->copySize;
+                        repoSize += partCopy->repoSize;
+                        compressFast = compressFast && partCopy->compressFast;
+
+                        if (partCopy->checksum != NULL)
+                            strCat(splitChecksum, partCopy->checksum);
+                    }
+
+                    if (skip || whole)
+                        backupJobSplitRemove(split, repoTeeList);
+
+                    if (skip)
+                        copyResult = backupCopyResultSkip;
+                    // Return the file to the queue to copy it whole
+                    else if (whole)
+                    {
+                        LOG_DETAIL_PID_FMT(
+                            processId, "file %s changed size while the parts were copied, copy whole", strZ(fileLog));
+
+                        *sizeProgress -= copySize;
+                        split->whole = true;
+                        lstInsert(split->queue, 0, &(const ManifestFilePack *){manifestFilePackFind(manifest, file.name)});
+
+                        continue;
+                    }
+                    else if (noOpTotal == partTotal)
+                    {
+                        copyResult = backupCopyResultNoOp;
+                        copyChecksum = strNewZ(file.checksumSha1);
+                        checksumPagePack = NULL;
+                        splitSize = split->splitSize;
+                    }
+                    // Else copy the parts that matched the prior backup since the file cannot reference the prior backup for some
+                    // parts and this backup for the others
+                    else if (noOpTotal != 0)
+                    {
+                        LOG_DETAIL_PID_FMT(
+                            processId, "file %s changed in %u/%u parts, copy matched parts", strZ(fileLog), partTotal - noOpTotal,
+                            partTotal);
+
+                        split->delta = false;
+                        split->partNext = partTotal;
+
+                        for (partIdx = 0; partIdx < partTotal; partIdx++)
+                        {
+                            BackupJobSplitPart *const partCopy = lstGet(split->partList, partIdx);
+
+                            if (partCopy->noOp)
+                            {
+                                *sizeProgress -= partCopy->copySize;
+                                partCopy->done = false;
+                                partCopy->noOp = false;
+                                split->partDone--;
+
+                                if (split->partNext == partTotal)
+                                    split->partNext = partIdx;
+                            }
+                        }
+
+                        continue;
+                    }
+                    else
+                    {
+                        copyChecksum = cryptoHashSplitCombine(hashTypeSha1, splitChecksum);
+                        checksumPagePack = file.checksumPage ? backupJobSplitPageChecksum(split) : NULL;
+                        repoChecksum = NULL;
+                        splitSize = split->splitSize;
+                    }
+                }
+
+                PackRead *const checksumPageResult = checksumPagePack != NULL ? pckReadNew(checksumPagePack) : NULL;
+
+                // Format log progress
+                String *const logProgress = strNew();
+
+                if (bundleId != 0)
+                    strCatFmt(logProgress, "bundle %" PRIu64 "/%" PRIu64 ", ", bundleId, bundleOffset);
+
+                if (splitSize != 0)
+                    strCatFmt(logProgress, "%u parts, ", lstSize(split->partList));
+
+                strCatFmt(
+                    logProgress, "%s, %u.%02u%%", strZ(strSizeFormat(copySize)), percentComplete / 100, percentComplete % 100);
+
+                // Format log checksum
+                const String *const logChecksum = copySize != 0 ? strNewFmt(" checksum %s", strZ(copyChecksum)) : EMPTY_STR;
+
+                // If the file is in a prior backup and nothing changed, just log it
+                if (copyResult == backupCopyResultNoOp)
+                {
+                    LOG_DETAIL_PID_FMT(
+                        processId, "match file from prior backup %s (%s)%s", strZ(fileLog), strZ(logProgress), strZ(logChecksum));
+                }
+                // Else if the repo matched the expect checksum, just log it
+                else if (copyResult == backupCopyResultChecksum)
+                {
+                    LOG_DETAIL_PID_FMT(
+                        processId, "checksum resumed file %s (%s)%s", strZ(fileLog), strZ(logProgress), strZ(logChecksum));
+                }
+                // Else if the file was removed during backup add it to the list of files to be removed from the manifest when the
+                // backup is complete. It can't be removed right now because that will invalidate the pointers that are being used
+                // for processing.
+                else if (copyResult == backupCopyResultSkip)
                 {
                     LOG_DETAIL_PID_FMT(processId, "skip file removed by database %s", strZ(fileLog));
                     strLstAdd(fileRemove, file.name);
@@ -1236,7 +1854,17 @@ backupJobResult(
                             strZ(file.name), file.checksumSha1);
                     }
 
-                    LOG_DETAIL_PID_FMT(processId, "backup file %s (%s)%s", strZ(fileLog), strZ(logProgress), strZ(logChecksum));
+                    // If the file content was already in the dedup store then nothing was copied
+                    if (copyResult == backupCopyResultDedup)
+                    {
+                        LOG_DETAIL_PID_FMT(
+                            processId, "dedup file %s (%s)%s", strZ(fileLog), strZ(logProgress), strZ(logChecksum));
+                    }
+                    else
+                    {
+                        LOG_DETAIL_PID_FMT(
+                            processId, "backup file %s (%s)%s", strZ(fileLog), strZ(logProgress), strZ(logChecksum));
+                    }
 
                     // If the file had page checksums calculated during the copy
                     ASSERT((!file.checksumPage && checksumPageResult == NULL) || (file.checksumPage && checksumPageResult != NULL));
@@ -1315,7 +1943,8 @@ backupJobResult(
                     manifestFileUpdate(
                         manifest, file.name, copySize, repoSize, strZ(copyChecksum), VARSTR(NULL), file.checksumPage,
                         checksumPageError, checksumPageErrorList != NULL ? jsonFromVar(varNewVarLst(checksumPageErrorList)) : NULL,
-                        bundleId, bundleOffset);
+                        bundleId, bundleOffset, bundleId != 0 && bundleDict, dedup, compressFast, strZNull(repoChecksum), splitSize,
+                        splitChecksum);
                 }
             }
 
@@ -1343,9 +1972,11 @@ Save a copy of the backup manifest during processing to preserve checksums for a
 resume is disabled since an incremental copy will not be used in a future backup unless resume is enabled beforehand.
 ***********************************************************************************************************************************/
 static void
-backupManifestSaveCopy(Manifest *const manifest, const String *const cipherPassBackup, const bool final)
+backupManifestSaveCopy(
+    const unsigned int repoIdx, Manifest *const manifest, const String *const cipherPassBackup, const bool final)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(UINT, repoIdx);
         FUNCTION_LOG_PARAM(MANIFEST, manifest);
         FUNCTION_TEST_PARAM(STRING, cipherPassBackup);
         FUNCTION_LOG_PARAM(BOOL, final);
@@ -1355,23 +1986,27 @@ backupManifestSaveCopy(Manifest *const manifest, const String *const cipherPassB
 
     if (final || cfgOptionBool(cfgOptResume))
     {
+        const uint64_t timeBegin = traceBegin();
+
         MEM_CONTEXT_TEMP_BEGIN()
         {
             // Open file for write
             IoWrite *write = storageWriteIo(
                 storageNewWriteP(
-                    storageRepoWrite(),
+                    storageRepoIdxWrite(repoIdx),
                     strNewFmt(
                         STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE INFO_COPY_EXT, strZ(manifestData(manifest)->backupLabel))));
 
             // Add encryption filter if required
             cipherBlockFilterGroupAdd(
-                ioWriteFilterGroup(write), cfgOptionStrId(cfgOptRepoCipherType), cipherModeEncrypt, cipherPassBackup);
+                ioWriteFilterGroup(write), cfgOptionIdxStrId(cfgOptRepoCipherType, repoIdx), cipherModeEncrypt, cipherPassBackup);
 
             // Save file
             manifestSave(manifest, write);
         }
         MEM_CONTEXT_TEMP_END();
+
+        traceEndP("manifestSave", timeBegin);
     }
 
     FUNCTION_LOG_RETURN_VOID();
@@ -1401,6 +2036,145 @@ backupDbPing(const BackupData *const backupData, const bool force)
     FUNCTION_LOG_RETURN_VOID();
 }
 
+/***********************************************************************************************************************************
+Get the dictionary used to compress bundled files. The dictionary of the prior backup is reused when there is one, otherwise the
+dictionary is trained from a sample of the files that will be bundled. The dictionary is stored in the backup so it can be used to
+decompress the files. Returns NULL when a dictionary could not be trained.
+***********************************************************************************************************************************/
+// Dictionary size and sample limits. Samples larger than 128KiB are truncated since they do not improve training.
+#define BACKUP_BUNDLE_DICT_SIZE                                     (32 * 1024)
+#define BACKUP_BUNDLE_DICT_SAMPLE_SIZE                              (4 * 1024 * 1024)
+#define BACKUP_BUNDLE_DICT_SAMPLE_FILE_SIZE                         (128 * 1024)
+
+static Buffer *
+backupBundleDict(
+    const BackupData *const backupData, Manifest *const manifest, const CompressType compressType, const uint64_t bundleLimit)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(BACKUP_DATA, backupData);
+        FUNCTION_LOG_PARAM(MANIFEST, manifest);
+        FUNCTION_LOG_PARAM(ENUM, compressType);
+        FUNCTION_LOG_PARAM(UINT64, bundleLimit);
+    FUNCTION_LOG_END();
+
+    ASSERT(backupData != NULL);
+    ASSERT(manifest != NULL);
+    ASSERT(compressDictSupported(compressType));
+
+    Buffer *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const ManifestData *const data = manifestData(manifest);
+        const CipherType cipherType = cfgOptionStrId(cfgOptRepoCipherType);
+
+        // Reuse the dictionary of the prior backup
+        if (data->backupLabelPrior != NULL)
+        {
+            StorageRead *const read = storageNewReadP(
+                storageRepo(), strNewFmt(STORAGE_REPO_BACKUP "/%s/" MANIFEST_FILE_BUNDLE_DICT, strZ(data->backupLabelPrior)),
+                .ignoreMissing = true);
+            cipherBlockFilterGroupAdd(
+                ioReadFilterGroup(storageReadIo(read)), cipherType, cipherModeDecrypt, manifestCipherSubPass(manifest));
+
+            result = storageGetP(read);
+
+            if (result != NULL)
+                LOG_DETAIL_FMT("reuse bundle dictionary from prior backup %s", strZ(data->backupLabelPrior));
+        }
+
+        // Else train a dictionary from a sample of the files that will be bundled
+        if (result == NULL)
+        {
+            const uint64_t timeBegin = traceBegin();
+
+            // Get the total size that could be sampled so samples can be spread evenly across the files
+            uint64_t sampleSizeTotal = 0;
+
+            for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(manifest); fileIdx++)
+            {
+                const ManifestFile file = manifestFile(manifest, fileIdx);
+
+                if (file.reference == NULL && file.size > 0 && file.size <= bundleLimit)
+                {
+                    sampleSizeTotal +=
+                        file.size < BACKUP_BUNDLE_DICT_SAMPLE_FILE_SIZE ? file.size : BACKUP_BUNDLE_DICT_SAMPLE_FILE_SIZE;
+                }
+            }
+
+            // Sample every nth file so the sample is taken from the entire cluster rather than just the first files
+            const uint64_t sampleStep = sampleSizeTotal / BACKUP_BUNDLE_DICT_SAMPLE_SIZE + 1;
+            Buffer *const sample = bufNew(0);
+            List *const sampleSizeList = lstNewP(sizeof(size_t));
+            uint64_t sampleIdx = 0;
+
+            for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(manifest); fileIdx++)
+            {
+                const ManifestFile file = manifestFile(manifest, fileIdx);
+
+                if (file.reference != NULL || file.size == 0 || file.size > bundleLimit || sampleIdx++ % sampleStep != 0)
+                    continue;
+
+                if (bufUsed(sample) >= BACKUP_BUNDLE_DICT_SAMPLE_SIZE)
+                    break;
+
+                // Files removed by the database since the manifest was built are skipped
+                Buffer *const content = storageGetP(
+                    storageNewReadP(
+                        backupData->storagePrimary, manifestPathPg(file.name), .ignoreMissing = true,
+                        .limit = VARUINT64(
+                            file.size < BACKUP_BUNDLE_DICT_SAMPLE_FILE_SIZE ? file.size : BACKUP_BUNDLE_DICT_SAMPLE_FILE_SIZE)));
+
+                if (content != NULL && !bufEmpty(content))
+                {
+                    bufCat(sample, content);
+                    lstAdd(sampleSizeList, &(size_t){bufUsed(content)});
+                }
+
+                bufFree(content);
+            }
+
+            if (!lstEmpty(sampleSizeList))
+            {
+                result = compressDictTrain(
+                    compressType, sample, lstGet(sampleSizeList, 0), lstSize(sampleSizeList), BACKUP_BUNDLE_DICT_SIZE);
+            }
+
+            if (result == NULL)
+            {
+                LOG_DETAIL_FMT(
+                    "unable to train bundle dictionary from %u file(s), bundled files will be compressed without a dictionary",
+                    lstSize(sampleSizeList));
+            }
+            else
+            {
+                LOG_DETAIL_FMT(
+                    "train bundle dictionary (%s) from %u file(s)", strZ(strSizeFormat(bufUsed(result))), lstSize(sampleSizeList));
+            }
+
+            traceEndP("bundleDictTrain", timeBegin);
+        }
+
+        // Store the dictionary in the backup
+        if (result != NULL)
+        {
+            const String *const dictFile = strNewFmt(STORAGE_REPO_BACKUP "/%s/" MANIFEST_FILE_BUNDLE_DICT, strZ(data->backupLabel));
+            StorageWrite *const write = storageNewWriteP(storageRepoWrite(), dictFile);
+            cipherBlockFilterGroupAdd(
+                ioWriteFilterGroup(storageWriteIo(write)), cipherType, cipherModeEncrypt, manifestCipherSubPass(manifest));
+
+            storagePutP(write, result);
+            backupRepoTeeCopy(backupData->repoTeeList, dictFile);
+            manifestBundleDictSet(manifest, true);
+
+            bufMove(result, memContextPrior());
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(BUFFER, result);
+}
+
 /***********************************************************************************************************************************
 Process the backup manifest
 ***********************************************************************************************************************************/
@@ -1414,13 +2188,22 @@ typedef struct BackupJobData
     const String *const cipherSubPass;                              // Passphrase used to encrypt files in the backup
     const CompressType compressType;                                // Backup compression type
     const int compressLevel;                                        // Compress level if backup is compressed
+    int compressLevelMin;                                           // Min compress level when the level is adapted
+    int compressLevelMax;                                           // Max compress level when the level is adapted
     const bool delta;                                               // Is this a checksum delta backup?
+    const bool dedup;                                               // Store files in the dedup store?
     const bool bundle;                                              // Bundle files?
     uint64_t bundleSize;                                            // Target bundle size
     uint64_t bundleLimit;                                           // Limit on files to bundle
     uint64_t bundleId;                                              // Bundle id
+    const Buffer *bundleDict;                                       // Dictionary to compress bundled files
+    List *bundleDictClientList;                                     // Clients the dictionary has been sent to
+    const List *const repoTeeList;                                  // Repos the backup is also written to
+    const uint64_t checkpointSize;                                  // Bytes between checkpoints of large files (0 to disable)
+    const uint64_t splitSize;                                       // Split files larger than this into parts (0 to disable)
 
     List *queueList;                                                // List of processing queues
+    List *splitList;                                                // Files split into parts (see BackupJobSplit)
 } BackupJobData;
 
 // Identify files that must be copied from the primary
@@ -1545,7 +2328,8 @@ backupProcessQueue(const BackupData *const backupData, Manifest *const manifest,
                 LOG_DETAIL_FMT(
                     "store zero-length file %s", strZ(storagePathP(backupData->storagePrimary, manifestPathPg(file.name))));
                 manifestFileUpdate(
-                    manifest, file.name, 0, 0, strZ(HASH_TYPE_SHA1_ZERO_STR), VARSTR(NULL), file.checksumPage, false, NULL, 0, 0);
+                    manifest, file.name, 0, 0, strZ(HASH_TYPE_SHA1_ZERO_STR), VARSTR(NULL), file.checksumPage, false, NULL, 0, 0,
+                    false, false, false, NULL, 0, NULL);
 
                 continue;
             }
@@ -1639,6 +2423,224 @@ backupJobQueueNext(unsigned int clientIdx, int queueIdx, unsigned int queueTotal
     FUNCTION_TEST_RETURN(INT, queueIdx);
 }
 
+// Helper to add the parameters that apply to all the files in a job
+static PackWrite *
+backupJobParam(
+    const BackupJobData *const jobData, ProtocolCommand *const command, const String *const repoFile, const bool dedup,
+    const Buffer *const compressDict, const bool compressDictSend, const uint64_t checkpointSize)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, jobData);
+        FUNCTION_TEST_PARAM(PROTOCOL_COMMAND, command);
+        FUNCTION_TEST_PARAM(STRING, repoFile);
+        FUNCTION_TEST_PARAM(BOOL, dedup);
+        FUNCTION_TEST_PARAM(BUFFER, compressDict);
+        FUNCTION_TEST_PARAM(BOOL, compressDictSend);
+        FUNCTION_TEST_PARAM(UINT64, checkpointSize);
+    FUNCTION_TEST_END();
+
+    ASSERT(jobData != NULL);
+    ASSERT(command != NULL);
+    ASSERT(repoFile != NULL);
+
+    PackWrite *const result = protocolCommandParam(command);
+
+    pckWriteStrP(result, repoFile);
+    pckWriteU32P(result, jobData->compressType);
+    pckWriteI32P(result, jobData->compressLevel);
+    pckWriteI32P(result, jobData->compressLevelMin);
+    pckWriteI32P(result, jobData->compressLevelMax);
+    pckWriteBoolP(result, jobData->delta);
+    pckWriteU64P(result, jobData->cipherSubPass == NULL ? cipherTypeNone : cipherTypeAes256Cbc);
+    pckWriteStrP(result, jobData->cipherSubPass);
+    pckWriteBoolP(result, dedup);
+    compressDictPackWrite(result, jobData->compressType, compressDict, compressDictSend);
+    pckWriteU64P(result, checkpointSize);
+
+    // Repos to tee the repo file to
+    pckWriteArrayBeginP(result);
+
+    for (unsigned int repoTeeIdx = 0; repoTeeIdx < lstSize(jobData->repoTeeList); repoTeeIdx++)
+    {
+        const BackupRepoTee *const repoTee = lstGet(jobData->repoTeeList, repoTeeIdx);
+
+        if (!repoTee->failed)
+            pckWriteU32P(result, repoTee->repoIdx, .defaultWrite = true);
+    }
+
+    pckWriteArrayEndP(result);
+
+    FUNCTION_TEST_RETURN(PACK_WRITE, result);
+}
+
+// Helper to add the parameters for a file in a job. A part of a split file is copied from offset.
+static void
+backupJobParamFile(
+    const BackupJobData *const jobData, PackWrite *const param, const ManifestFile *const file, const uint64_t offset,
+    const uint64_t size)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, jobData);
+        FUNCTION_TEST_PARAM(PACK_WRITE, param);
+        FUNCTION_TEST_PARAM(MANIFEST_FILE, file);
+        FUNCTION_TEST_PARAM(UINT64, offset);
+        FUNCTION_TEST_PARAM(UINT64, size);
+    FUNCTION_TEST_END();
+
+    ASSERT(jobData != NULL);
+    ASSERT(param != NULL);
+    ASSERT(file != NULL);
+
+    pckWriteStrP(param, manifestPathPg(file->name));
+    pckWriteBoolP(param, !strEq(file->name, STRDEF(MANIFEST_TARGET_PGDATA "/" PG_PATH_GLOBAL "/" PG_FILE_PGCONTROL)));
+    pckWriteU64P(param, size);
+    pckWriteBoolP(param, !backupProcessFilePrimary(jobData->standbyExp, file->name));
+    pckWriteStrP(param, file->checksumSha1[0] != 0 ? STR(file->checksumSha1) : NULL);
+    pckWriteBoolP(param, file->checksumPage);
+    pckWriteStrP(param, file->name);
+    pckWriteBoolP(param, file->reference != NULL);
+    pckWriteU64P(param, offset);
+    pckWriteU64P(param, file->checksumSha1[0] != 0 ? file->splitSize : 0);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+// Should the file be split into parts? Files that are bundled or copied beyond the size in the manifest (see
+// backupProcessFilePrimary()) are not split. A file that is checked against a checksum is split only when it was split into the
+// same parts in the prior backup so each part can be checked against the checksum of the part.
+static bool
+backupJobSplit(const BackupJobData *const jobData, const ManifestFile *const file)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, jobData);
+        FUNCTION_TEST_PARAM(MANIFEST_FILE, file);
+    FUNCTION_TEST_END();
+
+    ASSERT(jobData != NULL);
+    ASSERT(file != NULL);
+
+    bool result = false;
+
+    if (jobData->splitSize != 0 && file->size > jobData->splitSize &&
+        (file->checksumSha1[0] == '\0' || (file->reference != NULL && file->splitSize == jobData->splitSize)) &&
+        !(jobData->bundle && file->size <= jobData->bundleLimit) && !backupProcessFilePrimary(jobData->standbyExp, file->name))
+    {
+        // A file that could not be copied in parts is copied whole
+        const BackupJobSplit *const split = lstFind(jobData->splitList, &file->name);
+
+        result = split == NULL || !split->whole;
+    }
+
+    FUNCTION_TEST_RETURN(BOOL, result);
+}
+
+// Create a job to copy the next part of a split file
+static ProtocolParallelJob *
+backupJobSplitNext(const BackupJobData *const jobData, BackupJobSplit *const split)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, jobData);
+        FUNCTION_TEST_PARAM_P(VOID, split);
+    FUNCTION_TEST_END();
+
+    ASSERT(jobData != NULL);
+    ASSERT(split != NULL);
+    ASSERT(split->partNext < lstSize(split->partList));
+
+    ProtocolParallelJob *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const unsigned int partIdx = split->partNext;
+        const String *const repoFile = strLstGet(split->repoFileList, partIdx);
+        ManifestFile file = manifestFileFind(jobData->manifest, split->name);
+        ProtocolCommand *const command = protocolCommandNew(PROTOCOL_COMMAND_BACKUP_FILE);
+
+        // Check the part against the checksum of the part in the prior backup, else copy it
+        if (split->delta)
+            memcpy(file.checksumSha1, strZ(manifestSplitChecksum(&file, partIdx)), HASH_TYPE_SHA1_SIZE_HEX + 1);
+        else
+            file.checksumSha1[0] = '\0';
+
+        file.splitSize = 0;
+
+        // The parts are not checkpointed since a resumed backup does not keep parts
+        PackWrite *const param = backupJobParam(jobData, command, repoFile, false, NULL, false, 0);
+        backupJobParamFile(jobData, param, &file, partIdx * split->splitSize, backupJobSplitPartSize(split, partIdx));
+
+        MEM_CONTEXT_PRIOR_BEGIN()
+        {
+            result = protocolParallelJobNew(VARSTR(repoFile), command);
+        }
+        MEM_CONTEXT_PRIOR_END();
+
+        ((BackupJobSplitPart *)lstGet(split->partList, partIdx))->job = result;
+
+        // Skip parts that are already done, e.g. when only the parts that matched the prior backup are copied
+        do
+        {
+            split->partNext++;
+        }
+        while (
+            split->partNext < lstSize(split->partList) && ((BackupJobSplitPart *)lstGet(split->partList, split->partNext))->done);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN(PROTOCOL_PARALLEL_JOB, result);
+}
+
+// Split a file into parts and create a job to copy the first part
+static ProtocolParallelJob *
+backupJobSplitNew(BackupJobData *const jobData, List *const queue, const ManifestFile *const file)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, jobData);
+        FUNCTION_TEST_PARAM(LIST, queue);
+        FUNCTION_TEST_PARAM(MANIFEST_FILE, file);
+    FUNCTION_TEST_END();
+
+    ASSERT(jobData != NULL);
+    ASSERT(queue != NULL);
+    ASSERT(file != NULL);
+
+    ASSERT(lstFind(jobData->splitList, &file->name) == NULL);
+
+    BackupJobSplit *split = NULL;
+
+    MEM_CONTEXT_BEGIN(lstMemContext(jobData->splitList))
+    {
+        split = lstAdd(
+            jobData->splitList,
+            &(BackupJobSplit)
+            {
+                .name = strDup(file->name),
+                .queue = queue,
+                .size = file->size,
+                .splitSize = jobData->splitSize,
+                .delta = file->checksumSha1[0] != '\0',
+                .repoFileList = strLstNew(),
+                .partList = lstNewP(sizeof(BackupJobSplitPart)),
+            });
+    }
+    MEM_CONTEXT_END();
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const unsigned int partTotal = (unsigned int)((file->size + jobData->splitSize - 1) / jobData->splitSize);
+
+        for (unsigned int partIdx = 0; partIdx < partTotal; partIdx++)
+        {
+            strLstAddFmt(
+                split->repoFileList, STORAGE_REPO_BACKUP "/%s/%s", strZ(jobData->backupLabel),
+                strZ(manifestSplitFile(file->name, partIdx, jobData->compressType)));
+            lstAdd(split->partList, &(BackupJobSplitPart){0});
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN(PROTOCOL_PARALLEL_JOB, backupJobSplitNext(jobData, split));
+}
+
 // Callback to fetch backup jobs for the parallel executor
 static ProtocolParallelJob *backupJobCallback(void *data, unsigned int clientIdx)
 {
@@ -1663,100 +2665,214 @@ static ProtocolParallelJob *backupJobCallback(void *data, unsigned int clientIdx
             0 : (int)(clientIdx % (lstSize(jobData->queueList) - queueOffset));
         int queueEnd = queueIdx;
 
-        // Create backup job
-        ProtocolCommand *command = protocolCommandNew(PROTOCOL_COMMAND_BACKUP_FILE);
-        PackWrite *param = NULL;
-        uint64_t fileTotal = 0;
-        uint64_t fileSize = 0;
-
-        do
+        // Copy the remaining parts of split files first so the files are completed as soon as possible. When copying from the
+        // primary during backup from standby no files are split.
+        if (!jobData->backupStandby || clientIdx > 0)
         {
-            List *queue = *(List **)lstGet(jobData->queueList, (unsigned int)queueIdx + queueOffset);
-            unsigned int fileIdx = 0;
-            bool bundle = jobData->bundle;
-            const String *fileName = NULL;
-
-            while (fileIdx < lstSize(queue))
+            for (unsigned int splitIdx = 0; splitIdx < lstSize(jobData->splitList); splitIdx++)
             {
-                const ManifestFile file = manifestFileUnpack(jobData->manifest, *(ManifestFilePack **)lstGet(queue, fileIdx));
+                BackupJobSplit *const split = lstGet(jobData->splitList, splitIdx);
 
-                // Continue if the next file would make the bundle too large. There may be a smaller one that will fit.
-                if (fileTotal > 0 && fileSize + file.size >= jobData->bundleSize)
+                if (split->partNext < lstSize(split->partList))
                 {
-                    fileIdx++;
-                    continue;
+                    MEM_CONTEXT_PRIOR_BEGIN()
+                    {
+                        result = backupJobSplitNext(jobData, split);
+                    }
+                    MEM_CONTEXT_PRIOR_END();
+
+                    break;
                 }
+            }
+        }
+
+        // Else get the next job from the queues
+        if (result == NULL)
+        {
+            // Create backup job
+            ProtocolCommand *command = protocolCommandNew(PROTOCOL_COMMAND_BACKUP_FILE);
+            PackWrite *param = NULL;
+            uint64_t fileTotal = 0;
+            uint64_t fileSize = 0;
+
+            do
+            {
+                List *queue = *(List **)lstGet(jobData->queueList, (unsigned int)queueIdx + queueOffset);
+                unsigned int fileIdx = 0;
+                bool bundle = jobData->bundle;
+                const String *fileName = NULL;
 
-                // Add common parameters before first file
-                if (param == NULL)
+                while (fileIdx < lstSize(queue))
                 {
-                    param = protocolCommandParam(command);
+                    const ManifestFile file = manifestFileUnpack(jobData->manifest, *(ManifestFilePack **)lstGet(queue, fileIdx));
 
-                    String *const repoFile = strCatFmt(strNew(), STORAGE_REPO_BACKUP "/%s/", strZ(jobData->backupLabel));
+                    // Continue if the next file would make the bundle too large. There may be a smaller one that will fit.
+                    if (fileTotal > 0 && fileSize + file.size >= jobData->bundleSize)
+                    {
+                        fileIdx++;
+                        continue;
+                    }
 
-                    if (bundle && file.size <= jobData->bundleLimit)
-                        strCatFmt(repoFile, MANIFEST_PATH_BUNDLE "/%" PRIu64, jobData->bundleId);
-                    else
+                    // Split a large file into parts and copy the first part
+                    if (fileTotal == 0 && backupJobSplit(jobData, &file))
                     {
-                        CHECK(AssertError, fileTotal == 0, "cannot bundle file");
+                        lstRemoveIdx(queue, fileIdx);
 
-                        strCatFmt(repoFile, "%s%s", strZ(file.name), strZ(compressExtStr(jobData->compressType)));
-                        fileName = file.name;
-                        bundle = false;
+                        MEM_CONTEXT_PRIOR_BEGIN()
+                        {
+                            result = backupJobSplitNew(jobData, queue, &file);
+                        }
+                        MEM_CONTEXT_PRIOR_END();
+
+                        break;
                     }
 
-                    pckWriteStrP(param, repoFile);
-                    pckWriteU32P(param, jobData->compressType);
-                    pckWriteI32P(param, jobData->compressLevel);
-                    pckWriteBoolP(param, jobData->delta);
-                    pckWriteU64P(param, jobData->cipherSubPass == NULL ? cipherTypeNone : cipherTypeAes256Cbc);
-                    pckWriteStrP(param, jobData->cipherSubPass);
+                    // Add common parameters before first file
+                    if (param == NULL)
+                    {
+                        String *const repoFile = strCatFmt(strNew(), STORAGE_REPO_BACKUP "/%s/", strZ(jobData->backupLabel));
+
+                        if (bundle && file.size <= jobData->bundleLimit)
+                            strCatFmt(repoFile, MANIFEST_PATH_BUNDLE "/%" PRIu64, jobData->bundleId);
+                        else
+                        {
+                            CHECK(AssertError, fileTotal == 0, "cannot bundle file");
+
+                            strCatFmt(repoFile, "%s%s", strZ(file.name), strZ(compressExtStr(jobData->compressType)));
+                            fileName = file.name;
+                            bundle = false;
+                        }
+
+                        // The dictionary is only sent with the first bundle for each client. After that the client finds the
+                        // dictionary by id.
+                        const Buffer *const bundleDict = bundle ? jobData->bundleDict : NULL;
+                        const bool bundleDictSend =
+                            bundleDict != NULL && !lstExists(jobData->bundleDictClientList, &clientIdx);
+
+                        if (bundleDictSend)
+                            lstAdd(jobData->bundleDictClientList, &clientIdx);
+
+                        param = backupJobParam(
+                            jobData, command, repoFile, jobData->dedup && !bundle && file.size > 0, bundleDict, bundleDictSend,
+                            jobData->checkpointSize);
+                    }
+
+                    backupJobParamFile(jobData, param, &file, 0, file.size);
+
+                    fileTotal++;
+                    fileSize += file.size;
+
+                    // Remove job from the queue
+                    lstRemoveIdx(queue, fileIdx);
+
+                    // Break if not bundling or bundle size has been reached
+                    if (!bundle || fileSize >= jobData->bundleSize)
+                        break;
                 }
 
-                pckWriteStrP(param, manifestPathPg(file.name));
-                pckWriteBoolP(param, !strEq(file.name, STRDEF(MANIFEST_TARGET_PGDATA "/" PG_PATH_GLOBAL "/" PG_FILE_PGCONTROL)));
-                pckWriteU64P(param, file.size);
-                pckWriteBoolP(param, !backupProcessFilePrimary(jobData->standbyExp, file.name));
-                pckWriteStrP(param, file.checksumSha1[0] != 0 ? STR(file.checksumSha1) : NULL);
-                pckWriteBoolP(param, file.checksumPage);
-                pckWriteStrP(param, file.name);
-                pckWriteBoolP(param, file.reference != NULL);
+                // Stop when a split file job was created
+                if (result != NULL)
+                    break;
 
-                fileTotal++;
-                fileSize += file.size;
+                if (fileTotal > 0)
+                {
+                    // Assign job to result
+                    MEM_CONTEXT_PRIOR_BEGIN()
+                    {
+                        result = protocolParallelJobNew(bundle ? VARUINT64(jobData->bundleId) : VARSTR(fileName), command);
 
-                // Remove job from the queue
-                lstRemoveIdx(queue, fileIdx);
+                        if (bundle)
+                            jobData->bundleId++;
+                    }
+                    MEM_CONTEXT_PRIOR_END();
 
-                // Break if not bundling or bundle size has been reached
-                if (!bundle || fileSize >= jobData->bundleSize)
                     break;
+                }
+
+                // Don't get next queue when copying from primary during backup from standby since the primary only has one queue
+                if (!jobData->backupStandby || clientIdx > 0)
+                    queueIdx = backupJobQueueNext(clientIdx, queueIdx, lstSize(jobData->queueList) - queueOffset);
             }
+            while (queueIdx != queueEnd);
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
 
-            if (fileTotal > 0)
+    FUNCTION_TEST_RETURN(PROTOCOL_PARALLEL_JOB, result);
+}
+
+// Create all backup paths and tablespace symlinks in a repo
+static void
+backupProcessPathCreate(const Storage *const storage, const Manifest *const manifest, const String *const backupPathExp)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE, storage);
+        FUNCTION_LOG_PARAM(MANIFEST, manifest);
+        FUNCTION_LOG_PARAM(STRING, backupPathExp);
+    FUNCTION_LOG_END();
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Create paths when available
+        if (storageFeature(storage, storageFeaturePath))
+        {
+            for (unsigned int pathIdx = 0; pathIdx < manifestPathTotal(manifest); pathIdx++)
+                storagePathCreateP(storage, strNewFmt("%s/%s", strZ(backupPathExp), strZ(manifestPath(manifest, pathIdx)->name)));
+        }
+
+        // Create tablespace symlinks when available
+        if (storageFeature(storage, storageFeatureSymLink))
+        {
+            for (unsigned int targetIdx = 0; targetIdx < manifestTargetTotal(manifest); targetIdx++)
             {
-                // Assign job to result
-                MEM_CONTEXT_PRIOR_BEGIN()
+                const ManifestTarget *const target = manifestTarget(manifest, targetIdx);
+
+                if (target->tablespaceId != 0)
                 {
-                    result = protocolParallelJobNew(bundle ? VARUINT64(jobData->bundleId) : VARSTR(fileName), command);
+                    const String *const link = storagePathP(
+                        storage, strNewFmt("%s/" MANIFEST_TARGET_PGDATA "/%s", strZ(backupPathExp), strZ(target->name)));
+                    const String *const linkDestination = strNewFmt("../../" MANIFEST_TARGET_PGTBLSPC "/%u", target->tablespaceId);
 
-                    if (bundle)
-                        jobData->bundleId++;
+                    THROW_ON_SYS_ERROR_FMT(
+                        symlink(strZ(linkDestination), strZ(link)) == -1, FileOpenError, "unable to create symlink '%s' to '%s'",
+                        strZ(link), strZ(linkDestination));
                 }
-                MEM_CONTEXT_PRIOR_END();
-
-                break;
             }
-
-            // Don't get next queue when copying from primary during backup from standby since the primary only has one queue
-            if (!jobData->backupStandby || clientIdx > 0)
-                queueIdx = backupJobQueueNext(clientIdx, queueIdx, lstSize(jobData->queueList) - queueOffset);
         }
-        while (queueIdx != queueEnd);
     }
     MEM_CONTEXT_TEMP_END();
 
-    FUNCTION_TEST_RETURN(PROTOCOL_PARALLEL_JOB, result);
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+// Sync backup paths in a repo if required. When pathRequired is true all paths must exist so it is an error if they do not.
+static void
+backupProcessPathSync(
+    const Storage *const storage, const Manifest *const manifest, const String *const backupPathExp, const bool pathRequired)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE, storage);
+        FUNCTION_LOG_PARAM(MANIFEST, manifest);
+        FUNCTION_LOG_PARAM(STRING, backupPathExp);
+        FUNCTION_LOG_PARAM(BOOL, pathRequired);
+    FUNCTION_LOG_END();
+
+    if (storageFeature(storage, storageFeaturePathSync))
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            for (unsigned int pathIdx = 0; pathIdx < manifestPathTotal(manifest); pathIdx++)
+            {
+                const String *const path = strNewFmt("%s/%s", strZ(backupPathExp), strZ(manifestPath(manifest, pathIdx)->name));
+
+                if (pathRequired || storagePathExistsP(storage, path))
+                    storagePathSyncP(storage, path);
+            }
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
 }
 
 static void
@@ -1794,8 +2910,14 @@ backupProcess(
             .cipherType = cfgOptionStrId(cfgOptRepoCipherType),
             .cipherSubPass = manifestCipherSubPass(manifest),
             .delta = cfgOptionBool(cfgOptDelta),
+            .dedup = cfgOptionTest(cfgOptRepoDedup) && cfgOptionBool(cfgOptRepoDedup),
             .bundle = cfgOptionBool(cfgOptRepoBundle),
             .bundleId = 1,
+            .repoTeeList = backupData->repoTeeList,
+            .checkpointSize = backupCheckpointSize(),
+            .splitSize = backupSplitSize(),
+            .splitList = lstNewP(sizeof(BackupJobSplit), .comparator = lstComparatorStr),
+            .bundleDictClientList = lstNewP(sizeof(unsigned int), .comparator = lstComparatorUInt),
 
             // Build expression to identify files that can be copied from the standby when standby backup is supported
             .standbyExp = regExpNew(
@@ -1805,10 +2927,36 @@ backupProcess(
                     strZ(pgXactPath(backupData->version)))),
         };
 
+        // The compress level is adapted between the bounds in each process when compress-level-min is set
+        jobData.compressLevelMin = jobData.compressLevel;
+        jobData.compressLevelMax = jobData.compressLevel;
+
+        if (cfgOptionTest(cfgOptCompressLevelMin))
+        {
+            jobData.compressLevelMin = cfgOptionInt(cfgOptCompressLevelMin);
+
+            if (cfgOptionTest(cfgOptCompressLevelMax))
+                jobData.compressLevelMax = cfgOptionInt(cfgOptCompressLevelMax);
+        }
+
         if (jobData.bundle)
         {
             jobData.bundleSize = cfgOptionUInt64(cfgOptRepoBundleSize);
             jobData.bundleLimit = cfgOptionUInt64(cfgOptRepoBundleLimit);
+
+            // Get the dictionary to compress bundled files when the compression type supports dictionaries
+            if (cfgOptionBool(cfgOptRepoBundleDict))
+            {
+                if (compressDictSupported(jobData.compressType))
+                    jobData.bundleDict = backupBundleDict(backupData, manifest, jobData.compressType, jobData.bundleLimit);
+                else
+                {
+                    LOG_WARN_FMT(
+                        "option '%s' is ignored because " CFGOPT_COMPRESS_TYPE " '%s' does not support dictionaries",
+                        cfgOptionIdxName(cfgOptRepoBundleDict, cfgOptionIdxDefault(cfgOptRepoBundleDict)),
+                        strZ(compressTypeStr(jobData.compressType)));
+                }
+            }
         }
 
         // If this is a full backup or hard-linked and paths are supported then create all paths explicitly so that empty paths will
@@ -1816,36 +2964,23 @@ backupProcess(
         // make a copy of the backup path and get a valid cluster.
         if ((backupType == backupTypeFull && !jobData.bundle) || hardLink)
         {
-            // Create paths when available
-            if (storageFeature(storageRepoWrite(), storageFeaturePath))
-            {
-                for (unsigned int pathIdx = 0; pathIdx < manifestPathTotal(manifest); pathIdx++)
-                {
-                    storagePathCreateP(
-                        storageRepoWrite(),
-                        strNewFmt("%s/%s", strZ(backupPathExp), strZ(manifestPath(manifest, pathIdx)->name)));
-                }
-            }
+            backupProcessPathCreate(storageRepoWrite(), manifest, backupPathExp);
 
-            // Create tablespace symlinks when available
-            if (storageFeature(storageRepoWrite(), storageFeatureSymLink))
+            for (unsigned int repoTeeIdx = 0; repoTeeIdx < lstSize(backupData->repoTeeList); repoTeeIdx++)
             {
-                for (unsigned int targetIdx = 0; targetIdx < manifestTargetTotal(manifest); targetIdx++)
-                {
-                    const ManifestTarget *const target = manifestTarget(manifest, targetIdx);
+                BackupRepoTee *const repoTee = lstGet(backupData->repoTeeList, repoTeeIdx);
 
-                    if (target->tablespaceId != 0)
+                if (!repoTee->failed)
+                {
+                    TRY_BEGIN()
                     {
-                        const String *const link = storagePathP(
-                            storageRepo(),
-                            strNewFmt("%s/" MANIFEST_TARGET_PGDATA "/%s", strZ(backupPathExp), strZ(target->name)));
-                        const String *const linkDestination = strNewFmt(
-                            "../../" MANIFEST_TARGET_PGTBLSPC "/%u", target->tablespaceId);
-
-                        THROW_ON_SYS_ERROR_FMT(
-                            symlink(strZ(linkDestination), strZ(link)) == -1, FileOpenError,
-                            "unable to create symlink '%s' to '%s'", strZ(link), strZ(linkDestination));
+                        backupProcessPathCreate(storageRepoIdxWrite(repoTee->repoIdx), manifest, backupPathExp);
+                    }
+                    CATCH_ANY()
+                    {
+                        backupRepoTeeFailCatch(repoTee);
                     }
+                    TRY_END();
                 }
             }
         }
@@ -1857,6 +2992,11 @@ backupProcess(
         ProtocolParallel *parallelExec = protocolParallelNew(
             cfgOptionUInt64(cfgOptProtocolTimeout) / 2, backupJobCallback, &jobData);
 
+        // When files are split the parts of a file are copied by other clients while a part is running and a file that can't be
+        // stored in parts is returned to the queue, so clients must wait for jobs to finish rather than exit
+        if (jobData.splitSize != 0)
+            protocolParallelWait(parallelExec);
+
         // First client is always on the primary
         protocolParallelClientAdd(parallelExec, protocolLocalGet(protocolStorageTypePg, backupData->pgIdxPrimary, 1));
 
@@ -1868,6 +3008,15 @@ backupProcess(
         for (unsigned int processIdx = 2; processIdx <= processMax; processIdx++)
             protocolParallelClientAdd(parallelExec, protocolLocalGet(protocolStorageTypePg, pgIdx, processIdx));
 
+        // Adapt the number of processes to the latency when process-min is set. The primary client must stay active for standby
+        // backups since it is the only client that can copy files from the primary.
+        if (cfgOptionTest(cfgOptProcessMin))
+        {
+            protocolParallelAdapt(
+                parallelExec, cfgOptionUInt(cfgOptProcessMin) + (backupStandby ? 1 : 0),
+                cfgOptionTest(cfgOptProcessLatencyTarget) ? cfgOptionUInt64(cfgOptProcessLatencyTarget) : 0);
+        }
+
         // Maintain a list of files that need to be removed from the manifest when the backup is complete
         StringList *fileRemove = strLstNew();
 
@@ -1885,6 +3034,8 @@ backupProcess(
         unsigned int currentPercentComplete = 0;
         lockWriteDataP(lockTypeBackup, .percentComplete = VARUINT(currentPercentComplete));
 
+        const uint64_t timeBegin = traceBegin();
+
         MEM_CONTEXT_TEMP_RESET_BEGIN()
         {
             do
@@ -1894,12 +3045,17 @@ backupProcess(
                 for (unsigned int jobIdx = 0; jobIdx < completed; jobIdx++)
                 {
                     ProtocolParallelJob *job = protocolParallelResult(parallelExec);
+                    const uint64_t jobTime = protocolParallelJobTime(job);
+                    const uint64_t sizeProgressPrior = sizeProgress;
 
                     backupJobResult(
                         manifest,
                         backupStandby && protocolParallelJobProcessId(job) > 1 ? backupData->hostStandby : backupData->hostPrimary,
                         protocolParallelJobProcessId(job) > 1 ? storagePgIdx(pgIdx) : backupData->storagePrimary,
-                        fileRemove, job, jobData.bundle, sizeTotal, &sizeProgress, &currentPercentComplete);
+                        fileRemove, job, backupData->repoTeeList, jobData.splitList, jobData.bundle, jobData.bundleDict != NULL,
+                        sizeTotal, &sizeProgress, &currentPercentComplete);
+
+                    protocolParallelSample(parallelExec, sizeProgress - sizeProgressPrior, jobTime);
                 }
 
                 // A keep-alive is required here for the remote holding open the backup connection
@@ -1911,7 +3067,7 @@ backupProcess(
                 // Save the manifest periodically to preserve checksums for resume
                 if (sizeProgress - manifestSaveLast >= manifestSaveSize)
                 {
-                    backupManifestSaveCopy(manifest, cipherPassBackup, false);
+                    backupManifestSaveCopy(cfgOptionGroupIdxDefault(cfgOptGrpRepo), manifest, cipherPassBackup, false);
                     manifestSaveLast = sizeProgress;
                 }
 
@@ -1922,6 +3078,8 @@ backupProcess(
         }
         MEM_CONTEXT_TEMP_END();
 
+        traceEndP("backupProcess", timeBegin);
+
 #ifdef DEBUG
         // Ensure that all processing queues are empty
         for (unsigned int queueIdx = 0; queueIdx < lstSize(jobData.queueList); queueIdx++)
@@ -1944,20 +3102,35 @@ backupProcess(
             // if hardlinking is enabled the link will need to be created.
             if (file.reference != NULL)
             {
-                // If hardlinking is enabled then create a hardlink for files that have not changed since the last backup
-                if (hardLink)
+                // If hardlinking is enabled then create a hardlink for files that have not changed since the last backup. Files in
+                // the dedup store are shared by all backups so there is nothing to link.
+                if (hardLink && !file.dedup)
                 {
                     LOG_DETAIL_FMT("hardlink %s to %s", strZ(file.name), strZ(file.reference));
 
-                    const String *const linkName = storagePathP(
-                        storageRepo(), strNewFmt("%s/%s%s", strZ(backupPathExp), strZ(file.name), compressExt));
-                    const String *const linkDestination = storagePathP(
-                        storageRepo(),
-                        strNewFmt(STORAGE_REPO_BACKUP "/%s/%s%s", strZ(file.reference), strZ(file.name), compressExt));
+                    // A split file is linked part by part
+                    StringList *const repoFileList = strLstNew();
 
-                    THROW_ON_SYS_ERROR_FMT(
-                        link(strZ(linkDestination), strZ(linkName)) == -1, FileOpenError,
-                        "unable to create hardlink '%s' to '%s'", strZ(linkName), strZ(linkDestination));
+                    if (file.splitSize != 0)
+                    {
+                        for (unsigned int partIdx = 0; partIdx < manifestSplitTotal(&file); partIdx++)
+                            strLstAdd(repoFileList, manifestSplitFile(file.name, partIdx, jobData.compressType));
+                    }
+                    else
+                        strLstAddFmt(repoFileList, "%s%s", strZ(file.name), compressExt);
+
+                    for (unsigned int repoFileIdx = 0; repoFileIdx < strLstSize(repoFileList); repoFileIdx++)
+                    {
+                        const String *const repoFile = strLstGet(repoFileList, repoFileIdx);
+                        const String *const linkName = storagePathP(
+                            storageRepo(), strNewFmt("%s/%s", strZ(backupPathExp), strZ(repoFile)));
+                        const String *const linkDestination = storagePathP(
+                            storageRepo(), strNewFmt(STORAGE_REPO_BACKUP "/%s/%s", strZ(file.reference), strZ(repoFile)));
+
+                        THROW_ON_SYS_ERROR_FMT(
+                            link(strZ(linkDestination), strZ(linkName)) == -1, FileOpenError,
+                            "unable to create hardlink '%s' to '%s'", strZ(linkName), strZ(linkDestination));
+                    }
                 }
                 // Else log the reference. With delta, it is possible that references may have been removed if a file needed to be
                 // recopied.
@@ -1966,17 +3139,26 @@ backupProcess(
             }
         }
 
-        // Sync backup paths if required
-        if (storageFeature(storageRepoWrite(), storageFeaturePathSync))
+        // Sync backup paths. If the backup is full (without bundling) or hardlinked then all paths were created.
+        const bool pathRequired = (backupType == backupTypeFull && !jobData.bundle) || hardLink;
+
+        backupProcessPathSync(storageRepoWrite(), manifest, backupPathExp, pathRequired);
+
+        for (unsigned int repoTeeIdx = 0; repoTeeIdx < lstSize(backupData->repoTeeList); repoTeeIdx++)
         {
-            for (unsigned int pathIdx = 0; pathIdx < manifestPathTotal(manifest); pathIdx++)
-            {
-                const String *const path = strNewFmt("%s/%s", strZ(backupPathExp), strZ(manifestPath(manifest, pathIdx)->name));
+            BackupRepoTee *const repoTee = lstGet(backupData->repoTeeList, repoTeeIdx);
 
-                // Always sync the path if it exists or if the backup is full (without bundling) or hardlinked. In the latter cases
-                // the directory should always exist so we want to error if it does not.
-                if ((backupType == backupTypeFull && !jobData.bundle) || hardLink || storagePathExistsP(storageRepo(), path))
-                    storagePathSyncP(storageRepoWrite(), path);
+            if (!repoTee->failed)
+            {
+                TRY_BEGIN()
+                {
+                    backupProcessPathSync(storageRepoIdxWrite(repoTee->repoIdx), manifest, backupPathExp, pathRequired);
+                }
+                CATCH_ANY()
+                {
+                    backupRepoTeeFailCatch(repoTee);
+                }
+                TRY_END();
             }
         }
     }
@@ -2015,7 +3197,7 @@ backupArchiveCheckCopy(const BackupData *const backupData, Manifest *const manif
                 strZ(pgLsnToWalSegment(backupData->timeline, lsnStop, backupData->walSegmentSize)));
 
             // Save the backup manifest before getting archive logs in case of failure
-            backupManifestSaveCopy(manifest, cipherPassBackup, false);
+            backupManifestSaveCopy(cfgOptionGroupIdxDefault(cfgOptGrpRepo), manifest, cipherPassBackup, false);
 
             // Use base path to set ownership and mode
             const ManifestPath *basePath = manifestPathFind(manifest, MANIFEST_TARGET_PGDATA_STR);
@@ -2078,13 +3260,12 @@ backupArchiveCheckCopy(const BackupData *const backupData, Manifest *const manif
                         const String *manifestName = strNewFmt(
                             MANIFEST_TARGET_PGDATA "/%s/%s", strZ(pgWalPath(manifestData(manifest)->pgVersion)), strZ(walSegment));
 
-                        storageCopyP(
-                            read,
-                            storageNewWriteP(
-                                storageRepoWrite(),
-                                strNewFmt(
-                                    STORAGE_REPO_BACKUP "/%s/%s%s", strZ(manifestData(manifest)->backupLabel), strZ(manifestName),
-                                    strZ(compressExtStr(compressTypeEnum(cfgOptionStrId(cfgOptCompressType)))))));
+                        const String *const repoFile = strNewFmt(
+                            STORAGE_REPO_BACKUP "/%s/%s%s", strZ(manifestData(manifest)->backupLabel), strZ(manifestName),
+                            strZ(compressExtStr(compressTypeEnum(cfgOptionStrId(cfgOptCompressType)))));
+
+                        storageCopyP(read, storageNewWriteP(storageRepoWrite(), repoFile));
+                        backupRepoTeeCopy(backupData->repoTeeList, repoFile);
 
                         // Add to manifest
                         ManifestFile file =
@@ -2118,45 +3299,49 @@ backupArchiveCheckCopy(const BackupData *const backupData, Manifest *const manif
 /***********************************************************************************************************************************
 Save and update all files required to complete the backup
 ***********************************************************************************************************************************/
+// Complete the backup in a repo
 static void
-backupComplete(InfoBackup *const infoBackup, Manifest *const manifest)
+backupCompleteRepo(const unsigned int repoIdx, InfoBackup *const infoBackup, Manifest *const manifest)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(UINT, repoIdx);
         FUNCTION_LOG_PARAM(INFO_BACKUP, infoBackup);
         FUNCTION_LOG_PARAM(MANIFEST, manifest);
     FUNCTION_LOG_END();
 
+    ASSERT(infoBackup != NULL);
     ASSERT(manifest != NULL);
 
     MEM_CONTEXT_TEMP_BEGIN()
     {
         const String *const backupLabel = manifestData(manifest)->backupLabel;
+        const Storage *const storageRead = storageRepoIdx(repoIdx);
+        const Storage *const storageWrite = storageRepoIdxWrite(repoIdx);
+        const CipherType cipherType = cfgOptionIdxStrId(cfgOptRepoCipherType, repoIdx);
 
-        // Validation and final save of the backup manifest.  Validate in strict mode to catch as many potential issues as possible.
+        // Final save of the backup manifest
         // -------------------------------------------------------------------------------------------------------------------------
-        manifestValidate(manifest, true);
-
-        backupManifestSaveCopy(manifest, infoPgCipherPass(infoBackupPg(infoBackup)), true);
+        backupManifestSaveCopy(repoIdx, manifest, infoPgCipherPass(infoBackupPg(infoBackup)), true);
 
         storageCopy(
             storageNewReadP(
-                storageRepo(), strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE INFO_COPY_EXT, strZ(backupLabel))),
+                storageRead, strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE INFO_COPY_EXT, strZ(backupLabel))),
             storageNewWriteP(
-                storageRepoWrite(), strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE, strZ(backupLabel))));
+                storageWrite, strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE, strZ(backupLabel))));
 
         // Copy a compressed version of the manifest to history. If the repo is encrypted then the passphrase to open the manifest
         // is required.  We can't just do a straight copy since the destination needs to be compressed and that must happen before
         // encryption in order to be efficient. Compression will always be gz for compatibility and since it is always available.
         // -------------------------------------------------------------------------------------------------------------------------
         StorageRead *manifestRead = storageNewReadP(
-                storageRepo(), strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE, strZ(backupLabel)));
+                storageRead, strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE, strZ(backupLabel)));
 
         cipherBlockFilterGroupAdd(
-            ioReadFilterGroup(storageReadIo(manifestRead)), cfgOptionStrId(cfgOptRepoCipherType), cipherModeDecrypt,
+            ioReadFilterGroup(storageReadIo(manifestRead)), cipherType, cipherModeDecrypt,
             infoPgCipherPass(infoBackupPg(infoBackup)));
 
         StorageWrite *manifestWrite = storageNewWriteP(
-                storageRepoWrite(),
+                storageWrite,
                 strNewFmt(
                     STORAGE_REPO_BACKUP "/" BACKUP_PATH_HISTORY "/%s/%s.manifest%s", strZ(strSubN(backupLabel, 0, 4)),
                     strZ(backupLabel), strZ(compressExtStr(compressTypeGz))));
@@ -2164,42 +3349,80 @@ backupComplete(InfoBackup *const infoBackup, Manifest *const manifest)
         ioFilterGroupAdd(ioWriteFilterGroup(storageWriteIo(manifestWrite)), compressFilter(compressTypeGz, 9));
 
         cipherBlockFilterGroupAdd(
-            ioWriteFilterGroup(storageWriteIo(manifestWrite)), cfgOptionStrId(cfgOptRepoCipherType), cipherModeEncrypt,
+            ioWriteFilterGroup(storageWriteIo(manifestWrite)), cipherType, cipherModeEncrypt,
             infoPgCipherPass(infoBackupPg(infoBackup)));
 
         storageCopyP(manifestRead, manifestWrite);
 
         // Sync history path if required
-        if (storageFeature(storageRepoWrite(), storageFeaturePathSync))
-            storagePathSyncP(storageRepoWrite(), STRDEF(STORAGE_REPO_BACKUP "/" BACKUP_PATH_HISTORY));
+        if (storageFeature(storageWrite, storageFeaturePathSync))
+            storagePathSyncP(storageWrite, STRDEF(STORAGE_REPO_BACKUP "/" BACKUP_PATH_HISTORY));
 
         // Create a symlink to the most recent backup if supported.  This link is purely informational for the user and is never
         // used by us since symlinks are not supported on all storage types.
         // -------------------------------------------------------------------------------------------------------------------------
-        backupLinkLatest(backupLabel, cfgOptionGroupIdxDefault(cfgOptGrpRepo));
+        backupLinkLatest(backupLabel, repoIdx);
 
         // Add manifest and save backup.info (infoBackupSaveFile() is responsible for proper syncing)
         // -------------------------------------------------------------------------------------------------------------------------
         infoBackupDataAdd(infoBackup, manifest);
 
         infoBackupSaveFile(
-            infoBackup, storageRepoWrite(), INFO_BACKUP_PATH_FILE_STR, cfgOptionStrId(cfgOptRepoCipherType),
-            cfgOptionStrNull(cfgOptRepoCipherPass));
+            infoBackup, storageWrite, INFO_BACKUP_PATH_FILE_STR, cipherType,
+            cfgOptionIdxStrNull(cfgOptRepoCipherPass, repoIdx));
 
         // Save archive.info/copy so the timestamps will be updated to prevent lifecycle settings from removing the files early
         // -------------------------------------------------------------------------------------------------------------------------
         infoArchiveSaveFile(
             infoArchiveLoadFile(
-                storageRepo(), INFO_ARCHIVE_PATH_FILE_STR, cfgOptionStrId(cfgOptRepoCipherType),
-                cfgOptionStrNull(cfgOptRepoCipherPass)),
-            storageRepoWrite(), INFO_ARCHIVE_PATH_FILE_STR, cfgOptionStrId(cfgOptRepoCipherType),
-            cfgOptionStrNull(cfgOptRepoCipherPass));
+                storageRead, INFO_ARCHIVE_PATH_FILE_STR, cipherType, cfgOptionIdxStrNull(cfgOptRepoCipherPass, repoIdx)),
+            storageWrite, INFO_ARCHIVE_PATH_FILE_STR, cipherType, cfgOptionIdxStrNull(cfgOptRepoCipherPass, repoIdx));
     }
     MEM_CONTEXT_TEMP_END();
 
     FUNCTION_LOG_RETURN_VOID();
 }
 
+static void
+backupComplete(const BackupData *const backupData, InfoBackup *const infoBackup, Manifest *const manifest)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(BACKUP_DATA, backupData);
+        FUNCTION_LOG_PARAM(INFO_BACKUP, infoBackup);
+        FUNCTION_LOG_PARAM(MANIFEST, manifest);
+    FUNCTION_LOG_END();
+
+    ASSERT(backupData != NULL);
+    ASSERT(manifest != NULL);
+
+    // Validate the backup manifest in strict mode to catch as many potential issues as possible
+    manifestValidate(manifest, true);
+
+    // Complete the backup in the repo of the backup and then in the repos the backup is also written to
+    backupCompleteRepo(cfgOptionGroupIdxDefault(cfgOptGrpRepo), infoBackup, manifest);
+
+    for (unsigned int repoTeeIdx = 0; repoTeeIdx < lstSize(backupData->repoTeeList); repoTeeIdx++)
+    {
+        BackupRepoTee *const repoTee = lstGet(backupData->repoTeeList, repoTeeIdx);
+
+        if (!repoTee->failed)
+        {
+            TRY_BEGIN()
+            {
+                backupCompleteRepo(repoTee->repoIdx, repoTee->infoBackup, manifest);
+                LOG_INFO_FMT("backup also written to %s", cfgOptionGroupName(cfgOptGrpRepo, repoTee->repoIdx));
+            }
+            CATCH_ANY()
+            {
+                backupRepoTeeFailCatch(repoTee);
+            }
+            TRY_END();
+        }
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
 /**********************************************************************************************************************************/
 void
 cmdBackup(void)
@@ -2228,8 +3451,12 @@ cmdBackup(void)
         InfoPgData infoPg = infoPgDataCurrent(infoBackupPg(infoBackup));
         const String *cipherPassBackup = infoPgCipherPass(infoBackupPg(infoBackup));
 
+        // Get repos the backup is also written to
+        List *const repoTeeList = backupRepoTeeInit(infoBackup);
+
         // Get pg storage and database objects
         BackupData *backupData = backupInit(infoBackup);
+        backupData->repoTeeList = repoTeeList;
 
         // Get the start timestamp which will later be written into the manifest to track total backup time
         time_t timestampStart = backupTime(backupData, false);
@@ -2238,9 +3465,13 @@ cmdBackup(void)
         Manifest *manifestPrior = backupBuildIncrPrior(infoBackup);
 
         // Start the backup
+        uint64_t timeBegin = traceBegin();
         BackupStartResult backupStartResult = backupStart(backupData);
+        traceEndP("backupStart", timeBegin);
 
         // Build the manifest
+        timeBegin = traceBegin();
+
         Manifest *manifest = manifestNewBuild(
             backupData->storagePrimary, infoPg.version, infoPg.catalogVersion, cfgOptionBool(cfgOptOnline),
             cfgOptionBool(cfgOptChecksumPage), cfgOptionBool(cfgOptRepoBundle), strLstNewVarLst(cfgOptionLst(cfgOptExclude)),
@@ -2255,6 +3486,23 @@ cmdBackup(void)
         if (!backupBuildIncr(infoBackup, manifest, manifestPrior, backupStartResult.walSegmentName))
             manifestCipherSubPassSet(manifest, cipherPassGen(cfgOptionStrId(cfgOptRepoCipherType)));
 
+        // Files in the prior backup are referenced so the backup can only be written to repos that contain the prior backup
+        if (manifestData(manifest)->backupLabelPrior != NULL)
+        {
+            for (unsigned int repoTeeIdx = 0; repoTeeIdx < lstSize(repoTeeList); repoTeeIdx++)
+            {
+                BackupRepoTee *const repoTee = lstGet(repoTeeList, repoTeeIdx);
+
+                if (!repoTee->failed && !infoBackupLabelExists(repoTee->infoBackup, manifestData(manifest)->backupLabelPrior))
+                {
+                    backupRepoTeeFail(
+                        repoTee, strNewFmt("prior backup %s does not exist", strZ(manifestData(manifest)->backupLabelPrior)));
+                }
+            }
+        }
+
+        traceEndP("manifestBuild", timeBegin);
+
         // Set delta if it is not already set and the manifest requires it
         if (!cfgOptionBool(cfgOptDelta) && varBool(manifestData(manifest)->backupOptionDelta))
             cfgOptionSet(cfgOptDelta, cfgSourceParam, BOOL_TRUE_VAR);
@@ -2269,7 +3517,7 @@ cmdBackup(void)
         }
 
         // Save the manifest before processing starts
-        backupManifestSaveCopy(manifest, cipherPassBackup, false);
+        backupManifestSaveCopy(cfgOptionGroupIdxDefault(cfgOptGrpRepo), manifest, cipherPassBackup, false);
 
         // Process the backup manifest
         backupProcess(backupData, manifest, backupStartResult.lsn, cipherPassBackup);
@@ -2285,7 +3533,9 @@ cmdBackup(void)
         }
 
         // Stop the backup
+        timeBegin = traceBegin();
         BackupStopResult backupStopResult = backupStop(backupData, manifest);
+        traceEndP("backupStop", timeBegin);
 
         // Complete manifest
         manifestBuildComplete(
@@ -2300,7 +3550,9 @@ cmdBackup(void)
         dbFree(backupData->dbPrimary);
 
         // Check and copy WAL segments required to make the backup consistent
+        timeBegin = traceBegin();
         backupArchiveCheckCopy(backupData, manifest, cipherPassBackup);
+        traceEndP("backupArchiveCheckCopy", timeBegin);
 
         // The primary protocol connection won't be used anymore so free it. This needs to happen after backupArchiveCheckCopy() so
         // the backup lock is held on the remote which allows conditional archiving based on the backup lock. Any further access to
@@ -2309,7 +3561,9 @@ cmdBackup(void)
 
         // Complete the backup
         LOG_INFO_FMT("new backup label = %s", strZ(manifestData(manifest)->backupLabel));
-        backupComplete(infoBackup, manifest);
+        timeBegin = traceBegin();
+        backupComplete(backupData, infoBackup, manifest);
+        traceEndP("backupComplete", timeBegin);
 
         // Backup info
         LOG_INFO_FMT(
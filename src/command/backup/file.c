@@ -4,17 +4,23 @@ Backup File
 #include "build.auto.h"
 
 #include <string.h>
+#include <unistd.h>
 
 #include "command/backup/file.h"
 #include "command/backup/pageChecksum.h"
+#include "common/compress/probe.h"
 #include "common/crypto/cipherBlock.h"
 #include "common/crypto/hash.h"
 #include "common/debug.h"
 #include "common/io/filter/group.h"
+#include "common/io/filter/rate.h"
 #include "common/io/filter/size.h"
+#include "common/io/filter/tee.h"
 #include "common/io/io.h"
 #include "common/log.h"
 #include "common/regExp.h"
+#include "common/stat.h"
+#include "common/trace.h"
 #include "common/type/convert.h"
 #include "common/type/json.h"
 #include "info/manifest.h"
@@ -35,25 +41,550 @@ segmentNumber(const String *pgFile)
     FUNCTION_TEST_RETURN(UINT, regExpMatchOne(STRDEF("\\.[0-9]+$"), pgFile) ? cvtZToUInt(strrchr(strZ(pgFile), '.') + 1) : 0);
 }
 
+// Open a pg file for read with filters to calculate the checksum, size, and page checksums. Only read as many bytes as passed in
+// pgFileSize when requested. If the file is growing it does no good to copy data past the end of the size recorded in the manifest
+// since those blocks will need to be replayed from WAL during recovery. A part of a split file is read from pgFileOffset.
+static StorageRead *
+backupFileReadNew(const BackupFile *const file, const bool compressible)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, file);
+        FUNCTION_TEST_PARAM(BOOL, compressible);
+    FUNCTION_TEST_END();
+
+    ASSERT(file != NULL);
+
+    StorageRead *const result = storageNewReadP(
+        storagePg(), file->pgFile, .ignoreMissing = file->pgFileIgnoreMissing, .compressible = compressible,
+        .offset = file->pgFileOffset, .limit = file->pgFileCopyExactSize ? VARUINT64(file->pgFileSize) : NULL);
+    IoFilterGroup *const filterGroup = ioReadFilterGroup(storageReadIo(result));
+
+    ioRateAdd(filterGroup, ioRateTypeRead);
+    ioFilterGroupAdd(filterGroup, cryptoHashNew(hashTypeSha1));
+    ioFilterGroupAdd(filterGroup, ioSizeNew());
+
+    // Add page checksum filter
+    if (file->pgFileChecksumPage)
+    {
+        ioFilterGroupAdd(
+            filterGroup,
+            pageChecksumNew(
+                segmentNumber(file->pgFile), PG_SEGMENT_PAGE_DEFAULT, (unsigned int)(file->pgFileOffset / PG_PAGE_SIZE_DEFAULT),
+                storagePathP(storagePg(), file->pgFile)));
+    }
+
+    FUNCTION_TEST_RETURN(STORAGE_READ, result);
+}
+
+// Move a temp file into the dedup store. Storage that supports paths renames the file. Object stores cannot rename files so the
+// file is copied by the server when possible and then removed. Returns false when the temp file is missing so could not be moved.
+static bool
+backupFileDedupMove(const String *const tempFile, const String *const dedupFile)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, tempFile);
+        FUNCTION_TEST_PARAM(STRING, dedupFile);
+    FUNCTION_TEST_END();
+
+    ASSERT(tempFile != NULL);
+    ASSERT(dedupFile != NULL);
+
+    bool result = true;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        if (storageFeature(storageRepoWrite(), storageFeaturePath))
+        {
+            TRY_BEGIN()
+            {
+                storageMoveP(
+                    storageRepoWrite(), storageNewReadP(storageRepoWrite(), tempFile),
+                    storageNewWriteP(storageRepoWrite(), dedupFile));
+            }
+            CATCH(FileMissingError)
+            {
+                result = false;
+            }
+            TRY_END();
+        }
+        else
+        {
+            if (!storageCopyServerP(storageRepo(), tempFile, storageRepoWrite(), dedupFile))
+            {
+                storageCopyP(storageNewReadP(storageRepo(), tempFile), storageNewWriteP(storageRepoWrite(), dedupFile));
+            }
+
+            storageRemoveP(storageRepoWrite(), tempFile);
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN(BOOL, result);
+}
+
+// Store a file in the dedup store. The checksum that names the store file is determined first so nothing is written to the repo when
+// the content is already in the store. The checksum from the prior manifest is used when the pg file is known to match it, i.e. the
+// file is being recopied because the repo file did not match, and page checksums are not required. Otherwise the pg file is read to
+// calculate the checksum. When the content is not in the store the pg file is copied into a temp file in the store while the
+// checksum is calculated again since the file may have changed. The temp file name is unique to the process so processes storing
+// the same content at the same time do not write to the same file. The temp file is removed when the content is already in the
+// store, which may be because another process stored it during the copy. Otherwise it is moved into the store.
+static void
+backupFileDedup(
+    const BackupFile *const file, BackupFileResult *const fileResult, const CompressType compressType, const int compressLevel,
+    MemContext *const resultContext)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, file);
+        FUNCTION_TEST_PARAM_P(VOID, fileResult);
+        FUNCTION_TEST_PARAM(ENUM, compressType);
+        FUNCTION_TEST_PARAM(INT, compressLevel);
+        FUNCTION_TEST_PARAM(MEM_CONTEXT, resultContext);
+    FUNCTION_TEST_END();
+
+    ASSERT(file != NULL);
+    ASSERT(fileResult != NULL);
+    ASSERT(resultContext != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        BackupCopyResult dedupResult = backupCopyResultDedup;
+        const String *checksum = NULL;
+        uint64_t copySize = 0;
+        uint64_t repoSize = 0;
+        const Pack *pageChecksumResult = NULL;
+
+        // Get the checksum from the prior manifest or by reading the pg file
+        if (fileResult->backupCopyResult == backupCopyResultReCopy && file->pgFileChecksum != NULL &&
+            file->pgFileChecksumSplitSize == 0 && !file->pgFileChecksumPage)
+        {
+            checksum = file->pgFileChecksum;
+            copySize = file->pgFileSize;
+        }
+        else
+        {
+            IoRead *const read = storageReadIo(backupFileReadNew(file, false));
+
+            // If the file is missing the database removed it so skip it
+            if (!ioReadDrain(read))
+                dedupResult = backupCopyResultSkip;
+            else
+            {
+                checksum = pckReadStrP(ioFilterGroupResultP(ioReadFilterGroup(read), CRYPTO_HASH_FILTER_TYPE));
+                copySize = pckReadU64P(ioFilterGroupResultP(ioReadFilterGroup(read), SIZE_FILTER_TYPE));
+
+                if (file->pgFileChecksumPage)
+                    pageChecksumResult = ioFilterGroupResultPackP(ioReadFilterGroup(read), PAGE_CHECKSUM_FILTER_TYPE);
+            }
+        }
+
+        // If the content is already in the store then nothing needs to be written
+        if (dedupResult != backupCopyResultSkip)
+        {
+            const StorageInfo dedupInfo = storageInfoP(
+                storageRepo(), strNewFmt(STORAGE_REPO_BACKUP "/%s", strZ(manifestDedupFile(strZ(checksum), compressType))),
+                .ignoreMissing = true);
+
+            if (dedupInfo.exists)
+                repoSize = dedupInfo.size;
+            else
+                dedupResult = backupCopyResultCopy;
+        }
+
+        // Else copy the file into the store
+        if (dedupResult == backupCopyResultCopy)
+        {
+            const bool compressible = compressType == compressTypeNone;
+            StorageRead *const read = backupFileReadNew(file, compressible);
+            IoFilterGroup *const filterGroup = ioReadFilterGroup(storageReadIo(read));
+
+            if (compressType != compressTypeNone)
+                ioFilterGroupAdd(filterGroup, compressFilter(compressType, compressLevel));
+
+            ioFilterGroupAdd(filterGroup, ioSizeNew());
+
+            // If the file is missing the database removed it so skip it
+            if (!ioReadOpen(storageReadIo(read)))
+                dedupResult = backupCopyResultSkip;
+            else
+            {
+                // Copy the file into the temp file
+                const String *const tempFile = strNewFmt(STORAGE_REPO_BACKUP "/" MANIFEST_PATH_DEDUP "/%d.tmp", getpid());
+                StorageWrite *const write = storageNewWriteP(
+                    storageRepoWrite(), tempFile, .compressible = compressible, .noAtomic = true);
+                ioRateAdd(ioWriteFilterGroup(storageWriteIo(write)), ioRateTypeWrite);
+                ioWriteOpen(storageWriteIo(write));
+
+                ioCopyP(storageReadIo(read), storageWriteIo(write));
+                ioReadClose(storageReadIo(read));
+                ioWriteClose(storageWriteIo(write));
+
+                checksum = pckReadStrP(ioFilterGroupResultP(filterGroup, CRYPTO_HASH_FILTER_TYPE));
+                copySize = pckReadU64P(ioFilterGroupResultP(filterGroup, SIZE_FILTER_TYPE));
+                repoSize = pckReadU64P(ioFilterGroupResultP(filterGroup, SIZE_FILTER_TYPE, .idx = 1));
+
+                if (file->pgFileChecksumPage)
+                    pageChecksumResult = ioFilterGroupResultPackP(filterGroup, PAGE_CHECKSUM_FILTER_TYPE);
+
+                const String *const dedupFile = strNewFmt(
+                    STORAGE_REPO_BACKUP "/%s", strZ(manifestDedupFile(strZ(checksum), compressType)));
+
+                // If the content is already in the store then remove the temp file. The file may have changed since the checksum
+                // was determined above or another process may have stored the content during the copy.
+                StorageInfo dedupInfo = storageInfoP(storageRepo(), dedupFile, .ignoreMissing = true);
+
+                if (dedupInfo.exists)
+                {
+                    storageRemoveP(storageRepoWrite(), tempFile);
+                    dedupResult = backupCopyResultDedup;
+                }
+                // Else move the temp file into the store. If the temp file is missing then the content is only in the store when it
+                // was stored by another process, otherwise the file is left to be copied as usual.
+                else if (!backupFileDedupMove(tempFile, dedupFile))
+                {
+                    dedupInfo = storageInfoP(storageRepo(), dedupFile, .ignoreMissing = true);
+                    dedupResult = dedupInfo.exists ? backupCopyResultDedup : backupCopyResultReCopy;
+                }
+
+                // The size in the store may differ from this copy when the content was compressed by another process
+                if (dedupResult == backupCopyResultDedup)
+                    repoSize = dedupInfo.size;
+            }
+        }
+
+        // Record the results if the file is in the store. Otherwise the file is copied as usual.
+        if (dedupResult != backupCopyResultReCopy)
+        {
+            MEM_CONTEXT_BEGIN(resultContext)
+            {
+                if (dedupResult != backupCopyResultCopy)
+                    fileResult->backupCopyResult = dedupResult;
+
+                if (dedupResult != backupCopyResultSkip)
+                {
+                    fileResult->dedup = true;
+                    fileResult->copySize = copySize;
+                    fileResult->copyChecksum = strDup(checksum);
+                    fileResult->repoSize = repoSize;
+
+                    if (pageChecksumResult != NULL)
+                        fileResult->pageChecksumResult = pckDup(pageChecksumResult);
+                }
+            }
+            MEM_CONTEXT_END();
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+// Adapt the compression level to the slowest stage of the copy. The level is lowered when compressing a file takes longer than
+// reading and writing it and raised when compressing takes less than half as long. The level is kept in this process between calls
+// since each call usually copies a single file.
+#define BACKUP_FILE_COMPRESS_SAMPLE_SIZE_MIN                        (1024 * 1024)
+
+static struct BackupFileLocal
+{
+    bool compressLevelSet;                                          // Has the adapted level been set?
+    int compressLevel;                                              // Adapted compression level
+} backupFileLocal;
+
+// Get the compression level for the next file. The adapted level starts from the requested level and is reset when it is not
+// within the bounds.
+static int
+backupFileCompressLevel(const int level, const int levelMin, const int levelMax)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INT, level);
+        FUNCTION_TEST_PARAM(INT, levelMin);
+        FUNCTION_TEST_PARAM(INT, levelMax);
+    FUNCTION_TEST_END();
+
+    int result = level;
+
+    if (levelMin < levelMax)
+    {
+        if (!backupFileLocal.compressLevelSet || backupFileLocal.compressLevel < levelMin ||
+            backupFileLocal.compressLevel > levelMax)
+        {
+            backupFileLocal.compressLevelSet = true;
+            backupFileLocal.compressLevel = level < levelMin ? levelMin : (level > levelMax ? levelMax : level);
+        }
+
+        result = backupFileLocal.compressLevel;
+    }
+
+    FUNCTION_TEST_RETURN(INT, result);
+}
+
+// Update the adapted level with the time (in microseconds) spent compressing a file and the total time spent copying it. Small
+// files are ignored since their time is mostly per-file overhead. Compress time is zero when the file was compressed by a remote so
+// there is nothing to compare.
+static void
+backupFileCompressLevelUpdate(
+    const int levelMin, const int levelMax, const uint64_t size, const uint64_t compressTime, const uint64_t copyTime)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INT, levelMin);
+        FUNCTION_TEST_PARAM(INT, levelMax);
+        FUNCTION_TEST_PARAM(UINT64, size);
+        FUNCTION_TEST_PARAM(UINT64, compressTime);
+        FUNCTION_TEST_PARAM(UINT64, copyTime);
+    FUNCTION_TEST_END();
+
+    if (levelMin < levelMax && size >= BACKUP_FILE_COMPRESS_SAMPLE_SIZE_MIN && compressTime > 0)
+    {
+        ASSERT(backupFileLocal.compressLevelSet);
+
+        // Time spent reading and writing (including other filters such as hashing)
+        const uint64_t ioTime = copyTime > compressTime ? copyTime - compressTime : 0;
+
+        if (compressTime > ioTime)
+        {
+            if (backupFileLocal.compressLevel > levelMin)
+                backupFileLocal.compressLevel--;
+        }
+        else if (compressTime * 2 < ioTime && backupFileLocal.compressLevel < levelMax)
+            backupFileLocal.compressLevel++;
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+// Checkpoints are only made at aligned offsets in the repo file. This satisfies the alignment required by storage for all parts of
+// a multi-part upload except the last, e.g. GCS requires chunks to be a multiple of 256KiB.
+#define BACKUP_FILE_CHECKPOINT_ALIGN                                ((uint64_t)1024 * 1024)
+
+// A checkpoint records the bytes that were durable in the repo file. To resume, the pg file is copied again from the beginning with
+// the same compression level and cipher header so the same bytes are produced. The storage skips the bytes that were durable and
+// the bytes are verified against the checksum of the durable bytes before anything more is written.
+typedef struct BackupFileCheckpoint
+{
+    uint64_t size;                                                  // Size of the repo file at the checkpoint
+    const String *checksum;                                         // SHA1 checksum of the repo file at the checkpoint
+    int compressLevel;                                              // Compression level
+    const Buffer *cipherHeader;                                     // Cipher header when encrypted
+    const Pack *state;                                              // Storage state to resume the write
+} BackupFileCheckpoint;
+
+// Load a checkpoint. Returns NULL when the checkpoint is missing.
+static BackupFileCheckpoint *
+backupFileCheckpointLoad(const String *const checkpointFile)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, checkpointFile);
+    FUNCTION_TEST_END();
+
+    ASSERT(checkpointFile != NULL);
+
+    BackupFileCheckpoint *result = NULL;
+    const Buffer *const buffer = storageGetP(storageNewReadP(storageRepo(), checkpointFile, .ignoreMissing = true));
+
+    if (buffer != NULL)
+    {
+        PackRead *const pack = pckReadNew(pckFromBuf(buffer));
+
+        result = memNew(sizeof(BackupFileCheckpoint));
+
+        *result = (BackupFileCheckpoint){.size = pckReadU64P(pack)};
+        result->checksum = pckReadStrP(pack);
+        result->compressLevel = pckReadI32P(pack);
+        result->cipherHeader = pckReadBinP(pack);
+        result->state = pckReadPackP(pack);
+    }
+
+    FUNCTION_TEST_RETURN_TYPE_P(BackupFileCheckpoint, result);
+}
+
+// Save a checkpoint
+static void
+backupFileCheckpointSave(const String *const checkpointFile, const BackupFileCheckpoint *const checkpoint)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, checkpointFile);
+        FUNCTION_TEST_PARAM_P(VOID, checkpoint);
+    FUNCTION_TEST_END();
+
+    ASSERT(checkpointFile != NULL);
+    ASSERT(checkpoint != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        PackWrite *const pack = pckWriteNewP();
+
+        pckWriteU64P(pack, checkpoint->size);
+        pckWriteStrP(pack, checkpoint->checksum);
+        pckWriteI32P(pack, checkpoint->compressLevel);
+        pckWriteBinP(pack, checkpoint->cipherHeader);
+        pckWritePackP(pack, checkpoint->state);
+        pckWriteEndP(pack);
+
+        storagePutP(storageNewWriteP(storageRepoWrite(), checkpointFile), pckToBuf(pckWriteResult(pack)));
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+// Copy the pg file to the repo file with checkpoints and close the repo file. When resuming, the bytes up to the checkpoint are
+// skipped by the storage and verified against the checksum in the checkpoint. The storage has not resumed the write until it has
+// made a new checkpoint or closed the write, e.g. an object store may reject the upload that was checkpointed. resumeError is set
+// when an error is thrown by the prefix check or by the storage before it has resumed, so the caller knows the file cannot be
+// resumed. Other errors leave the checkpoint usable.
+static void
+backupFileCopyCheckpoint(
+    IoRead *const read, StorageWrite *const write, const String *const checkpointFile, const uint64_t checkpointSize,
+    const BackupFileCheckpoint *const resume, const int compressLevel, const bool cipher, volatile bool *const resumeError)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(IO_READ, read);
+        FUNCTION_TEST_PARAM(STORAGE_WRITE, write);
+        FUNCTION_TEST_PARAM(STRING, checkpointFile);
+        FUNCTION_TEST_PARAM(UINT64, checkpointSize);
+        FUNCTION_TEST_PARAM_P(VOID, resume);
+        FUNCTION_TEST_PARAM(INT, compressLevel);
+        FUNCTION_TEST_PARAM(BOOL, cipher);
+        FUNCTION_TEST_PARAM_P(BOOL, resumeError);
+    FUNCTION_TEST_END();
+
+    ASSERT(read != NULL);
+    ASSERT(write != NULL);
+    ASSERT(checkpointFile != NULL);
+    ASSERT(checkpointSize > 0);
+    ASSERT(resumeError != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        Buffer *const buffer = bufNew(ioBufferSize());
+        Buffer *const cipherHeader = cipher ? bufNew(CIPHER_BLOCK_HEADER_SIZE) : NULL;
+        IoFilter *const hash = cryptoHashNew(hashTypeSha1);
+        uint64_t checkpointLast = resume != NULL ? resume->size : 0;
+        uint64_t size = 0;
+        bool resumed = resume == NULL;
+
+        do
+        {
+            ioRead(read, buffer);
+
+            // Write the buffer in slices that end on aligned offsets so checkpoints can be made at aligned offsets
+            size_t bufferIdx = 0;
+
+            while (bufferIdx < bufUsed(buffer))
+            {
+                const uint64_t alignRemains = BACKUP_FILE_CHECKPOINT_ALIGN - size % BACKUP_FILE_CHECKPOINT_ALIGN;
+                const size_t sliceSize =
+                    bufUsed(buffer) - bufferIdx < alignRemains ? bufUsed(buffer) - bufferIdx : (size_t)alignRemains;
+                const Buffer *const slice = BUF(bufPtrConst(buffer) + bufferIdx, sliceSize);
+
+                // Capture the cipher header so a resumed file is encrypted with the same salt
+                if (cipherHeader != NULL && bufRemains(cipherHeader) > 0)
+                    bufCatSub(cipherHeader, slice, 0, sliceSize < bufRemains(cipherHeader) ? sliceSize : bufRemains(cipherHeader));
+
+                ioFilterProcessIn(hash, slice);
+
+                *resumeError = !resumed;
+                ioWrite(storageWriteIo(write), slice);
+                *resumeError = false;
+
+                size += sliceSize;
+                bufferIdx += sliceSize;
+
+                // The bytes skipped by the storage must match the bytes stored before the checkpoint
+                if (resume != NULL && size == resume->size)
+                {
+                    const String *const checksum = cryptoHashPartial(hash);
+
+                    if (!strEq(checksum, resume->checksum))
+                    {
+                        *resumeError = true;
+
+                        THROW_FMT(
+                            ChecksumError, "checksum '%s' at checkpoint %" PRIu64 " does not match checksum '%s'", strZ(checksum),
+                            size, strZ(resume->checksum));
+                    }
+                }
+
+                // Make a checkpoint. The storage may not be able to make a checkpoint at this offset, e.g. because too little data
+                // has been written since the last part was uploaded, so try again at the next aligned offset.
+                if (size % BACKUP_FILE_CHECKPOINT_ALIGN == 0 && size > checkpointLast && size - checkpointLast >= checkpointSize)
+                {
+                    MEM_CONTEXT_TEMP_BEGIN()
+                    {
+                        *resumeError = !resumed;
+                        const Pack *const state = storageWriteCheckpoint(write);
+                        *resumeError = false;
+
+                        if (state != NULL)
+                        {
+                            backupFileCheckpointSave(
+                                checkpointFile,
+                                &(BackupFileCheckpoint){
+                                    .size = size, .checksum = cryptoHashPartial(hash), .compressLevel = compressLevel,
+                                    .cipherHeader = cipherHeader, .state = state});
+
+                            checkpointLast = size;
+                            resumed = true;
+                        }
+                    }
+                    MEM_CONTEXT_TEMP_END();
+                }
+            }
+
+            bufUsedZero(buffer);
+        }
+        while (!ioReadEof(read));
+
+        // The file cannot be resumed if it is now smaller than the checkpoint
+        if (resume != NULL && size < resume->size)
+        {
+            *resumeError = true;
+
+            THROW_FMT(
+                ChecksumError, "size %" PRIu64 " is less than checkpoint size %" PRIu64, size, resume->size);
+        }
+
+        *resumeError = !resumed;
+        ioWriteClose(storageWriteIo(write));
+        *resumeError = false;
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
 /**********************************************************************************************************************************/
 List *
 backupFile(
     const String *const repoFile, const CompressType repoFileCompressType, const int repoFileCompressLevel,
-    const bool delta, const CipherType cipherType, const String *const cipherPass, const List *const fileList)
+    const int repoFileCompressLevelMin, const int repoFileCompressLevelMax, const bool delta, const CipherType cipherType,
+    const String *const cipherPass, const bool dedup, const Buffer *const compressDict, const uint64_t checkpointSize,
+    List *const teeList, const List *const fileList)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(STRING, repoFile);                       // Repo file
         FUNCTION_LOG_PARAM(ENUM, repoFileCompressType);             // Compress type for repo file
         FUNCTION_LOG_PARAM(INT, repoFileCompressLevel);             // Compression level for repo file
+        FUNCTION_LOG_PARAM(INT, repoFileCompressLevelMin);          // Minimum compression level when adapted
+        FUNCTION_LOG_PARAM(INT, repoFileCompressLevelMax);          // Maximum compression level when adapted
         FUNCTION_LOG_PARAM(BOOL, delta);                            // Is the delta option on?
         FUNCTION_LOG_PARAM(STRING_ID, cipherType);                  // Encryption type
         FUNCTION_TEST_PARAM(STRING, cipherPass);                    // Password to access the repo file if encrypted
+        FUNCTION_LOG_PARAM(BOOL, dedup);                            // Store files in the dedup store?
+        FUNCTION_LOG_PARAM(BUFFER, compressDict);                   // Dictionary to compress files
+        FUNCTION_LOG_PARAM(UINT64, checkpointSize);                 // Bytes between checkpoints of large files
+        FUNCTION_LOG_PARAM(LIST, teeList);                          // Repos to also write the repo file to
         FUNCTION_LOG_PARAM(LIST, fileList);                         // List of files to backup
     FUNCTION_LOG_END();
 
     ASSERT(repoFile != NULL);
     ASSERT((cipherType == cipherTypeNone && cipherPass == NULL) || (cipherType != cipherTypeNone && cipherPass != NULL));
+    ASSERT(!dedup || cipherType == cipherTypeNone);
+    ASSERT(compressDict == NULL || (!dedup && repoFileCompressType != compressTypeNone));
+    ASSERT(teeList == NULL || !dedup);
+    ASSERT(checkpointSize == 0 || (teeList == NULL && !dedup && lstSize(fileList) == 1));
     ASSERT(fileList != NULL && !lstEmpty(fileList));
+    ASSERT(repoFileCompressLevelMin <= repoFileCompressLevelMax);
 
     // Backup file results
     List *result = NULL;
@@ -85,12 +616,14 @@ backupFile(
                 {
                     // Generate checksum/size for the pg file. Only read as many bytes as passed in pgFileSize. If the file has
                     // grown since the manifest was built we don't need to consider the extra bytes since they will be replayed from
-                    // WAL during recovery.
+                    // WAL during recovery. The checksum of a file that was split in the prior backup is calculated from the
+                    // checksums of the parts. A part is read from pgFileOffset and checked against the checksum of the part.
                     IoRead *read = storageReadIo(
                         storageNewReadP(
-                            storagePg(), file->pgFile, .ignoreMissing = file->pgFileIgnoreMissing,
+                            storagePg(), file->pgFile, .ignoreMissing = file->pgFileIgnoreMissing, .offset = file->pgFileOffset,
                             .limit = file->pgFileCopyExactSize ? VARUINT64(file->pgFileSize) : NULL));
-                    ioFilterGroupAdd(ioReadFilterGroup(read), cryptoHashNew(hashTypeSha1));
+                    ioRateAdd(ioReadFilterGroup(read), ioRateTypeRead);
+                    ioFilterGroupAdd(ioReadFilterGroup(read), cryptoHashNewSplit(hashTypeSha1, file->pgFileChecksumSplitSize));
                     ioFilterGroupAdd(ioReadFilterGroup(read), ioSizeNew());
 
                     // If the pg file exists check the checksum/size
@@ -190,75 +723,223 @@ backupFile(
             }
         }
 
+        // Store files in the dedup store. Files that are not stored, e.g. because the temp file was removed, are copied below.
+        if (dedup)
+        {
+            for (unsigned int fileIdx = 0; fileIdx < lstSize(fileList); fileIdx++)
+            {
+                BackupFileResult *const fileResult = lstGet(result, fileIdx);
+
+                if (fileResult->backupCopyResult == backupCopyResultCopy || fileResult->backupCopyResult == backupCopyResultReCopy)
+                {
+                    backupFileDedup(
+                        lstGet(fileList, fileIdx), fileResult, repoFileCompressType,
+                        backupFileCompressLevel(repoFileCompressLevel, repoFileCompressLevelMin, repoFileCompressLevelMax),
+                        lstMemContext(result));
+                }
+            }
+        }
+
         // Are the files compressible during the copy?
         const bool compressible = repoFileCompressType == compressTypeNone && cipherType == cipherTypeNone;
 
         // Copy files that need to be copied
-        StorageWrite *write = NULL;
+        StorageWrite *volatile write = NULL;                        // Volatile since it is aborted on error
+        StorageWrite **teeWrite = NULL;
         uint64_t bundleOffset = 0;
+        bool checkpointed = false;
 
         for (unsigned int fileIdx = 0; fileIdx < lstSize(fileList); fileIdx++)
         {
             const BackupFile *const file = lstGet(fileList, fileIdx);
             BackupFileResult *const fileResult = lstGet(result, fileIdx);
 
-            if (fileResult->backupCopyResult == backupCopyResultCopy || fileResult->backupCopyResult == backupCopyResultReCopy)
+            if ((fileResult->backupCopyResult == backupCopyResultCopy || fileResult->backupCopyResult == backupCopyResultReCopy) &&
+                !fileResult->dedup)
             {
-                // Setup pg file for read. Only read as many bytes as passed in pgFileSize.  If the file is growing it does no good
-                // to copy data past the end of the size recorded in the manifest since those blocks will need to be replayed from
-                // WAL during recovery.
-                StorageRead *read = storageNewReadP(
-                    storagePg(), file->pgFile, .ignoreMissing = file->pgFileIgnoreMissing, .compressible = compressible,
-                    .limit = file->pgFileCopyExactSize ? VARUINT64(file->pgFileSize) : NULL);
-                ioFilterGroupAdd(ioReadFilterGroup(storageReadIo(read)), cryptoHashNew(hashTypeSha1));
-                ioFilterGroupAdd(ioReadFilterGroup(storageReadIo(read)), ioSizeNew());
-
-                // Add page checksum filter
-                if (file->pgFileChecksumPage)
-                {
-                    ioFilterGroupAdd(
-                        ioReadFilterGroup(storageReadIo(read)),
-                        pageChecksumNew(
-                            segmentNumber(file->pgFile), PG_SEGMENT_PAGE_DEFAULT, storagePathP(storagePg(), file->pgFile)));
-                }
+                const uint64_t timeBegin = traceBegin();
 
-                // Add compression
-                if (repoFileCompressType != compressTypeNone)
-                {
-                    ioFilterGroupAdd(
-                        ioReadFilterGroup(storageReadIo(read)), compressFilter(repoFileCompressType, repoFileCompressLevel));
-                }
+                // A file at least as large as the checkpoint size is checkpointed so it can be resumed after a failed backup
+                const String *const checkpointFile =
+                    checkpointSize > 0 && file->pgFileSize >= checkpointSize ?
+                        strNewFmt("%s" BACKUP_FILE_CHECKPOINT_EXT, strZ(repoFile)) : NULL;
+                BackupFileCheckpoint *checkpoint = checkpointFile != NULL ? backupFileCheckpointLoad(checkpointFile) : NULL;
+                checkpointed = checkpointFile != NULL;
 
-                // If there is a cipher then add the encrypt filter
-                if (cipherType != cipherTypeNone)
-                {
-                    ioFilterGroupAdd(
-                        ioReadFilterGroup(storageReadIo(read)),
-                        cipherBlockNew(cipherModeEncrypt, cipherType, BUFSTR(cipherPass), NULL));
-                }
-
-                // Add size filter last to calculate repo size
-                ioFilterGroupAdd(ioReadFilterGroup(storageReadIo(read)), ioSizeNew());
+                // Copy the file. If resuming from a checkpoint fails, i.e. the pg file has changed so the bytes do not match the
+                // bytes already stored or the storage cannot resume the write, e.g. because it no longer has the partial upload,
+                // then remove the checkpoint and copy the file again from the beginning. Other errors, e.g. reading the pg file,
+                // are thrown and the checkpoint is kept so the file can be resumed by the next backup.
+                StorageRead *read = NULL;
+                int compressLevel = 0;
+                StringId compressFilterType = 0;
+                uint64_t copyBegin = 0;
+                bool readOpen = false;
+                volatile bool copied = false;
+                volatile bool resumeError = false;
 
-                // Open the source and destination and copy the file
-                if (ioReadOpen(storageReadIo(read)))
+                do
                 {
-                    if (write == NULL)
+                    TRY_BEGIN()
                     {
-                        // Setup the repo file for write. There is no need to write the file atomically (e.g. via a temp file on
-                        // Posix) because checksums are tested on resume after a failed backup. The path does not need to be synced
-                        // for each file because all paths are synced at the end of the backup.
-                        write = storageNewWriteP(
-                            storageRepoWrite(), repoFile, .compressible = compressible, .noAtomic = true, .noSyncPath = true);
-                        ioWriteOpen(storageWriteIo(write));
+                        MEM_CONTEXT_TEMP_BEGIN()
+                        {
+                            // Setup pg file for read
+                            read = backupFileReadNew(file, compressible);
+
+                            // Add compression. A resumed file must be compressed at the same level to produce the same bytes.
+                            compressLevel =
+                                checkpoint != NULL ?
+                                    checkpoint->compressLevel :
+                                    backupFileCompressLevel(
+                                        repoFileCompressLevel, repoFileCompressLevelMin, repoFileCompressLevelMax);
+                            compressFilterType = 0;
+
+                            if (repoFileCompressType != compressTypeNone)
+                            {
+                                // Without a dictionary probe the data so data that does not compress well is compressed at the
+                                // fastest level
+                                IoFilter *const compress =
+                                    compressDict != NULL ?
+                                        compressFilterDict(repoFileCompressType, compressLevel, compressDict) :
+                                        compressFilterProbe(repoFileCompressType, compressLevel);
+
+                                compressFilterType = ioFilterType(compress);
+                                ioFilterGroupAdd(ioReadFilterGroup(storageReadIo(read)), compress);
+                            }
+
+                            // If there is a cipher then add the encrypt filter. A resumed file must use the same salt.
+                            if (cipherType != cipherTypeNone)
+                            {
+                                ioFilterGroupAdd(
+                                    ioReadFilterGroup(storageReadIo(read)),
+                                    checkpoint != NULL ?
+                                        cipherBlockNewResume(cipherType, BUFSTR(cipherPass), NULL, checkpoint->cipherHeader) :
+                                        cipherBlockNew(cipherModeEncrypt, cipherType, BUFSTR(cipherPass), NULL));
+                            }
+
+                            // When the repo file will contain only this file calculate the MD5 checksum of the stored bytes so
+                            // verify can compare it to the checksum reported by the repo storage without reading the file
+                            if (lstSize(fileList) == 1)
+                                ioFilterGroupAdd(ioReadFilterGroup(storageReadIo(read)), cryptoHashNew(hashTypeMd5));
+
+                            // Add size filter last to calculate repo size
+                            ioFilterGroupAdd(ioReadFilterGroup(storageReadIo(read)), ioSizeNew());
+
+                            // Open the source and destination and copy the file
+                            copyBegin = statTimeBegin();
+                            readOpen = ioReadOpen(storageReadIo(read));
+
+                            if (readOpen)
+                            {
+                                if (write == NULL)
+                                {
+                                    // The write is kept across attempts so it can be aborted when an attempt fails
+                                    MEM_CONTEXT_PRIOR_BEGIN()
+                                    {
+                                        // Setup the repo file for write. There is no need to write the file atomically (e.g. via
+                                        // a temp file on Posix) because checksums are tested on resume after a failed backup. The
+                                        // path does not need to be synced for each file because all paths are synced at the end of
+                                        // the backup.
+                                        write = storageNewWriteP(
+                                            storageRepoWrite(), repoFile, .compressible = compressible, .noAtomic = true,
+                                            .noSyncPath = true, .resume = checkpoint != NULL ? checkpoint->state : NULL);
+                                        ioRateAdd(ioWriteFilterGroup(storageWriteIo(write)), ioRateTypeWrite);
+
+                                        // Tee the repo file to the other repos. A repo that can't be opened is skipped for the rest
+                                        // of the file.
+                                        if (teeList != NULL)
+                                        {
+                                            teeWrite = memNew(sizeof(StorageWrite *) * lstSize(teeList));
+
+                                            for (unsigned int teeIdx = 0; teeIdx < lstSize(teeList); teeIdx++)
+                                            {
+                                                BackupFileTee *const tee = lstGet(teeList, teeIdx);
+                                                teeWrite[teeIdx] = NULL;
+
+                                                TRY_BEGIN()
+                                                {
+                                                    StorageWrite *const teeWriteOpen = storageNewWriteP(
+                                                        storageRepoIdxWrite(tee->repoIdx), repoFile, .compressible = compressible,
+                                                        .noAtomic = true, .noSyncPath = true);
+
+                                                    ioWriteOpen(storageWriteIo(teeWriteOpen));
+                                                    ioFilterGroupAdd(
+                                                        ioWriteFilterGroup(storageWriteIo(write)),
+                                                        ioTeeNew(storageWriteIo(teeWriteOpen), true));
+
+                                                    teeWrite[teeIdx] = teeWriteOpen;
+                                                }
+                                                CATCH_ANY()
+                                                {
+                                                    MEM_CONTEXT_BEGIN(lstMemContext(teeList))
+                                                    {
+                                                        tee->error = strNewFmt(
+                                                            "[%s] %s", errorTypeName(errorType()), errorMessage());
+                                                    }
+                                                    MEM_CONTEXT_END();
+                                                }
+                                                TRY_END();
+                                            }
+                                        }
+
+                                        // An error opening a resumed write means the storage cannot resume it
+                                        resumeError = checkpoint != NULL;
+                                        ioWriteOpen(storageWriteIo(write));
+                                        resumeError = false;
+                                    }
+                                    MEM_CONTEXT_PRIOR_END();
+                                }
+
+                                // Copy data from source to destination
+                                if (checkpointFile != NULL)
+                                {
+                                    backupFileCopyCheckpoint(
+                                        storageReadIo(read), write, checkpointFile, checkpointSize, checkpoint, compressLevel,
+                                        cipherType != cipherTypeNone, &resumeError);
+                                }
+                                else
+                                    ioCopyP(storageReadIo(read), storageWriteIo(write));
+
+                                // Close the source
+                                ioReadClose(storageReadIo(read));
+                            }
+
+                            // Keep the read for the results
+                            storageReadMove(read, memContextPrior());
+                        }
+                        MEM_CONTEXT_TEMP_END();
+
+                        copied = true;
                     }
+                    CATCH_ANY()
+                    {
+                        if (checkpoint == NULL || !resumeError)
+                            RETHROW();
 
-                    // Copy data from source to destination
-                    ioCopyP(storageReadIo(read), storageWriteIo(write));
+                        LOG_DETAIL_FMT(
+                            "unable to resume '%s' from checkpoint, copying from the beginning: [%s] %s", strZ(repoFile),
+                            errorTypeName(errorType()), errorMessage());
 
-                    // Close the source
-                    ioReadClose(storageReadIo(read));
+                        // Abort the write so the storage does not keep the data written for the checkpoint, e.g. an incomplete
+                        // multi-part upload. The pg file is copied again to a new write.
+                        if (write != NULL)
+                        {
+                            storageWriteAbort(write);
+                            storageWriteFree(write);
+                            write = NULL;
+                        }
+
+                        storageRemoveP(storageRepoWrite(), checkpointFile);
+                        checkpoint = NULL;
+                        resumeError = false;
+                    }
+                    TRY_END();
+                }
+                while (!copied);
 
+                if (readOpen)
+                {
                     MEM_CONTEXT_BEGIN(lstMemContext(result))
                     {
                         // Get sizes and checksum
@@ -270,6 +951,21 @@ backupFile(
                         fileResult->repoSize = pckReadU64P(
                             ioFilterGroupResultP(ioReadFilterGroup(storageReadIo(read)), SIZE_FILTER_TYPE, .idx = 1));
 
+                        if (lstSize(fileList) == 1)
+                        {
+                            fileResult->repoChecksum = strDup(
+                                pckReadStrP(
+                                    ioFilterGroupResultP(
+                                        ioReadFilterGroup(storageReadIo(read)), CRYPTO_HASH_FILTER_TYPE, .idx = 1)));
+                        }
+
+                        // Was the file compressed at the fastest level because it did not compress well?
+                        if (compressFilterType == COMPRESS_PROBE_FILTER_TYPE)
+                        {
+                            fileResult->compressFast = pckReadBoolP(
+                                ioFilterGroupResultP(ioReadFilterGroup(storageReadIo(read)), COMPRESS_PROBE_FILTER_TYPE));
+                        }
+
                         // Get results of page checksum validation
                         if (file->pgFileChecksumPage)
                         {
@@ -279,6 +975,40 @@ backupFile(
                     }
                     MEM_CONTEXT_END();
 
+                    // Adapt the compression level unless the file was compressed at the fastest level (did not compress well)
+                    if (compressFilterType != 0 && !fileResult->compressFast)
+                    {
+                        backupFileCompressLevelUpdate(
+                            repoFileCompressLevelMin, repoFileCompressLevelMax, fileResult->copySize,
+                            ioFilterGroupResultTimeP(ioReadFilterGroup(storageReadIo(read)), compressFilterType),
+                            statTimeBegin() - copyBegin);
+                    }
+
+                    // Record a span for the file including the time spent hashing and compressing. Filter times are only available
+                    // when the pg file is local to this process.
+                    if (traceEnabled())
+                    {
+                        const IoFilterGroup *const filterGroup = ioReadFilterGroup(storageReadIo(read));
+                        KeyValue *const traceArg = kvNew();
+
+                        kvPut(traceArg, VARSTRDEF("file"), VARSTR(file->pgFile));
+                        kvPut(
+                            traceArg, VARSTRDEF("hashTime"),
+                            VARUINT64(ioFilterGroupResultTimeP(filterGroup, CRYPTO_HASH_FILTER_TYPE)));
+                        kvPut(traceArg, VARSTRDEF("repoSize"), VARUINT64(fileResult->repoSize));
+                        kvPut(traceArg, VARSTRDEF("size"), VARUINT64(fileResult->copySize));
+
+                        if (compressFilterType != 0)
+                        {
+                            kvPut(traceArg, VARSTRDEF("compressLevel"), VARINT(compressLevel));
+                            kvPut(
+                                traceArg, VARSTRDEF("compressTime"),
+                                VARUINT64(ioFilterGroupResultTimeP(filterGroup, compressFilterType)));
+                        }
+
+                        traceEndP("backupFile", timeBegin, .arg = traceArg);
+                    }
+
                     // Free the read object. This is very important if many files are being read because they can each contain a lot
                     // of buffers.
                     storageReadFree(read);
@@ -292,10 +1022,64 @@ backupFile(
             }
         }
 
-        // Close the repository file if it was opened
-        if (write != NULL)
+        // Close the repository file if it was opened. A checkpointed file was closed by backupFileCopyCheckpoint().
+        if (write != NULL && !checkpointed)
+        {
             ioWriteClose(storageWriteIo(write));
 
+            // Close the tee files. Errors from the tee filters are checked first since a failed file must not be closed normally.
+            if (teeList != NULL)
+            {
+                unsigned int teeFilterIdx = 0;
+
+                for (unsigned int teeIdx = 0; teeIdx < lstSize(teeList); teeIdx++)
+                {
+                    if (teeWrite[teeIdx] != NULL)
+                    {
+                        BackupFileTee *const tee = lstGet(teeList, teeIdx);
+                        PackRead *const teeResult = ioFilterGroupResultP(
+                            ioWriteFilterGroup(storageWriteIo(write)), TEE_FILTER_TYPE, .idx = teeFilterIdx);
+                        teeFilterIdx++;
+
+                        pckReadU64P(teeResult);
+                        const String *error = pckReadStrP(teeResult);
+
+                        if (error == NULL)
+                        {
+                            TRY_BEGIN()
+                            {
+                                ioWriteClose(storageWriteIo(teeWrite[teeIdx]));
+                            }
+                            CATCH_ANY()
+                            {
+                                error = strNewFmt("[%s] %s", errorTypeName(errorType()), errorMessage());
+                            }
+                            TRY_END();
+                        }
+
+                        if (error != NULL)
+                        {
+                            MEM_CONTEXT_BEGIN(lstMemContext(teeList))
+                            {
+                                tee->error = strDup(error);
+                            }
+                            MEM_CONTEXT_END();
+                        }
+                    }
+                }
+            }
+        }
+
+        // Remove the checkpoint since the repo file is complete. If the pg file was removed then also remove the bytes stored
+        // before the checkpoint.
+        if (checkpointed)
+        {
+            if (write == NULL)
+                storageRemoveP(storageRepoWrite(), repoFile);
+
+            storageRemoveP(storageRepoWrite(), strNewFmt("%s" BACKUP_FILE_CHECKPOINT_EXT, strZ(repoFile)));
+        }
+
         lstMove(result, memContextPrior());
     }
     MEM_CONTEXT_TEMP_END();
@@ -7,6 +7,12 @@ Backup File
 #include "common/compress/helper.h"
 #include "common/crypto/common.h"
 #include "common/type/keyValue.h"
+#include "version.h"
+
+/***********************************************************************************************************************************
+Extension of the checkpoint file stored beside a repo file that can be resumed after a failed backup
+***********************************************************************************************************************************/
+#define BACKUP_FILE_CHECKPOINT_EXT                                  "." PROJECT_BIN ".checkpoint"
 
 /***********************************************************************************************************************************
 Backup file types
@@ -18,6 +24,7 @@ typedef enum
     backupCopyResultReCopy,
     backupCopyResultSkip,
     backupCopyResultNoOp,
+    backupCopyResultDedup,
 } BackupCopyResult;
 
 /***********************************************************************************************************************************
@@ -28,9 +35,11 @@ typedef struct BackupFile
 {
     const String *pgFile;                                           // Pg file to backup
     bool pgFileIgnoreMissing;                                       // Ignore missing pg file
+    uint64_t pgFileOffset;                                          // Offset to copy from (for a part of a split file)
     uint64_t pgFileSize;                                            // Expected pg file size
     bool pgFileCopyExactSize;                                       // Copy only pg expected size
     const String *pgFileChecksum;                                   // Expected pg file checksum
+    uint64_t pgFileChecksumSplitSize;                               // Part size used to calculate pgFileChecksum (0 if not split)
     bool pgFileChecksumPage;                                        // Validate page checksums?
     const String *manifestFile;                                     // Repo file
     bool manifestFileHasReference;                                  // Reference to prior backup, if any
@@ -44,11 +53,29 @@ typedef struct BackupFileResult
     String *copyChecksum;
     uint64_t bundleOffset;                                          // Offset in bundle if any
     uint64_t repoSize;
+    String *repoChecksum;                                           // MD5 checksum of the repo file when it holds only this file
     Pack *pageChecksumResult;
+    bool dedup;                                                     // Is the file in the dedup store?
+    bool compressFast;                                              // Was the file compressed at the fastest level?
 } BackupFileResult;
 
+// Repo that repoFile is also written to (see the tee-repo option)
+typedef struct BackupFileTee
+{
+    unsigned int repoIdx;                                           // Repo index
+    String *error;                                                  // Error writing to the repo, if any
+} BackupFileTee;
+
+// When dedup is true the files are stored in the dedup store (see manifestDedupFile()) rather than repoFile when possible. When
+// compressDict is not NULL the files are compressed with the dictionary. When repoFileCompressLevelMin is less than
+// repoFileCompressLevelMax the compression level is adapted between them for each file, starting from repoFileCompressLevel. When
+// teeList is not NULL the bytes written to repoFile are also written to the same file in each repo in the list. An error writing to
+// one of these repos does not end the backup -- instead the error is set in the list and nothing more is written to the repo. When
+// checkpointSize is not zero a repo file that holds a single file at least this large is checkpointed (see
+// BACKUP_FILE_CHECKPOINT_EXT) each time checkpointSize bytes have been written so it can be resumed after a failed backup.
 List *backupFile(
-    const String *repoFile, CompressType repoFileCompressType, int repoFileCompressLevel, bool delta, CipherType cipherType,
-    const String *cipherPass, const List *fileList);
+    const String *repoFile, CompressType repoFileCompressType, int repoFileCompressLevel, int repoFileCompressLevelMin,
+    int repoFileCompressLevelMax, bool delta, CipherType cipherType, const String *cipherPass, bool dedup,
+    const Buffer *compressDict, uint64_t checkpointSize, List *teeList, const List *fileList);
 
 #endif
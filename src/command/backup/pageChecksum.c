@@ -225,11 +225,14 @@ pageChecksumResult(THIS_VOID)
 
 /**********************************************************************************************************************************/
 IoFilter *
-pageChecksumNew(const unsigned int segmentNo, const unsigned int segmentPageTotal, const String *const fileName)
+pageChecksumNew(
+    const unsigned int segmentNo, const unsigned int segmentPageTotal, const unsigned int segmentPageOffset,
+    const String *const fileName)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(UINT, segmentNo);
         FUNCTION_LOG_PARAM(UINT, segmentPageTotal);
+        FUNCTION_LOG_PARAM(UINT, segmentPageOffset);
         FUNCTION_LOG_PARAM(STRING, fileName);
     FUNCTION_LOG_END();
 
@@ -243,7 +246,7 @@ pageChecksumNew(const unsigned int segmentNo, const unsigned int segmentPageTota
         {
             .memContext = memContextCurrent(),
             .segmentPageTotal = segmentPageTotal,
-            .pageNoOffset = segmentNo * segmentPageTotal,
+            .pageNoOffset = segmentNo * segmentPageTotal + segmentPageOffset,
             .fileName = strDup(fileName),
             .pageBuffer = memNew(PG_PAGE_SIZE_DEFAULT),
             .valid = true,
@@ -260,6 +263,7 @@ pageChecksumNew(const unsigned int segmentNo, const unsigned int segmentPageTota
             pckWriteU32P(packWrite, segmentNo);
             pckWriteU32P(packWrite, segmentPageTotal);
             pckWriteStrP(packWrite, fileName);
+            pckWriteU32P(packWrite, segmentPageOffset);
             pckWriteEndP(packWrite);
 
             paramList = pckMove(pckWriteResult(packWrite), memContextPrior());
@@ -284,8 +288,9 @@ pageChecksumNewPack(const Pack *const paramList)
         const unsigned int segmentNo = pckReadU32P(paramListPack);
         const unsigned int segmentPageTotal = pckReadU32P(paramListPack);
         const String *const fileName = pckReadStrP(paramListPack);
+        const unsigned int segmentPageOffset = pckReadU32P(paramListPack);
 
-        result = ioFilterMove(pageChecksumNew(segmentNo, segmentPageTotal, fileName), memContextPrior());
+        result = ioFilterMove(pageChecksumNew(segmentNo, segmentPageTotal, segmentPageOffset, fileName), memContextPrior());
     }
     MEM_CONTEXT_TEMP_END();
 
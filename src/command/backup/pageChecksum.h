@@ -16,7 +16,9 @@ Filter type constant
 /***********************************************************************************************************************************
 Constructors
 ***********************************************************************************************************************************/
-IoFilter *pageChecksumNew(unsigned int segmentNo, unsigned int segmentPageTotal, const String *fileName);
+// The segmentPageOffset is the page in the segment where checking starts, e.g. when a part of a split file is checked
+IoFilter *pageChecksumNew(
+    unsigned int segmentNo, unsigned int segmentPageTotal, unsigned int segmentPageOffset, const String *fileName);
 IoFilter *pageChecksumNewPack(const Pack *paramList);
 
 #endif
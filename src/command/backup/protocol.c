@@ -31,9 +31,24 @@ backupFileProtocol(PackRead *const param, ProtocolServer *const server)
         const String *const repoFile = pckReadStrP(param);
         const CompressType repoFileCompressType = (CompressType)pckReadU32P(param);
         const int repoFileCompressLevel = pckReadI32P(param);
+        const int repoFileCompressLevelMin = pckReadI32P(param);
+        const int repoFileCompressLevelMax = pckReadI32P(param);
         const bool delta = pckReadBoolP(param);
         const CipherType cipherType = (CipherType)pckReadU64P(param);
         const String *const cipherPass = pckReadStrP(param);
+        const bool dedup = pckReadBoolP(param);
+        const Buffer *const compressDict = compressDictPackRead(param);
+        const uint64_t checkpointSize = pckReadU64P(param);
+
+        // Build the list of repos to tee to
+        List *teeList = lstNewP(sizeof(BackupFileTee));
+
+        pckReadArrayBeginP(param);
+
+        while (!pckReadNullP(param))
+            lstAdd(teeList, &(BackupFileTee){.repoIdx = pckReadU32P(param)});
+
+        pckReadArrayEndP(param);
 
         // Build the file list
         List *fileList = lstNewP(sizeof(BackupFile));
@@ -48,17 +63,36 @@ backupFileProtocol(PackRead *const param, ProtocolServer *const server)
             file.pgFileChecksumPage = pckReadBoolP(param);
             file.manifestFile = pckReadStrP(param);
             file.manifestFileHasReference = pckReadBoolP(param);
+            file.pgFileOffset = pckReadU64P(param);
+            file.pgFileChecksumSplitSize = pckReadU64P(param);
 
             lstAdd(fileList, &file);
         }
 
         // Backup file
         const List *const result = backupFile(
-            repoFile, repoFileCompressType, repoFileCompressLevel, delta, cipherType, cipherPass, fileList);
+            repoFile, repoFileCompressType, repoFileCompressLevel, repoFileCompressLevelMin, repoFileCompressLevelMax, delta,
+            cipherType, cipherPass, dedup, compressDict, checkpointSize, lstEmpty(teeList) ? NULL : teeList, fileList);
 
         // Return result
         PackWrite *const resultPack = protocolPackNew();
 
+        // Return errors for repos that failed to tee
+        pckWriteArrayBeginP(resultPack);
+
+        for (unsigned int teeIdx = 0; teeIdx < lstSize(teeList); teeIdx++)
+        {
+            const BackupFileTee *const tee = lstGet(teeList, teeIdx);
+
+            if (tee->error != NULL)
+            {
+                pckWriteU32P(resultPack, tee->repoIdx, .defaultWrite = true);
+                pckWriteStrP(resultPack, tee->error);
+            }
+        }
+
+        pckWriteArrayEndP(resultPack);
+
         for (unsigned int resultIdx = 0; resultIdx < lstSize(result); resultIdx++)
         {
             const BackupFileResult *const fileResult = lstGet(result, resultIdx);
@@ -70,6 +104,9 @@ backupFileProtocol(PackRead *const param, ProtocolServer *const server)
             pckWriteU64P(resultPack, fileResult->repoSize);
             pckWriteStrP(resultPack, fileResult->copyChecksum);
             pckWritePackP(resultPack, fileResult->pageChecksumResult);
+            pckWriteBoolP(resultPack, fileResult->dedup);
+            pckWriteBoolP(resultPack, fileResult->compressFast);
+            pckWriteStrP(resultPack, fileResult->repoChecksum);
         }
 
         protocolServerDataPut(server, resultPack);
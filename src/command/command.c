@@ -205,7 +205,7 @@ cmdEnd(int code, const String *errorMessage)
         MEM_CONTEXT_TEMP_BEGIN()
         {
             // Output statistics if there are any
-            const String *const statJson = statToJson();
+            const String *const statJson = statToJsonP();
 
             if (statJson != NULL)
                 LOG_DETAIL_FMT("statistics: %s", strZ(statJson));
@@ -16,6 +16,14 @@ Exit Routines
 #include "protocol/helper.h"
 #include "version.h"
 
+/***********************************************************************************************************************************
+Local variables
+***********************************************************************************************************************************/
+static struct ExitLocal
+{
+    ExitReportFunction report;                                      // Write reports when the command ends
+} exitLocal;
+
 /***********************************************************************************************************************************
 Return signal names
 ***********************************************************************************************************************************/
@@ -80,6 +88,19 @@ exitInit(void)
     FUNCTION_LOG_RETURN_VOID();
 }
 
+/**********************************************************************************************************************************/
+void
+exitReportInit(const ExitReportFunction report)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(FUNCTIONP, report);
+    FUNCTION_TEST_END();
+
+    exitLocal.report = report;
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
 /**********************************************************************************************************************************/
 // Helper to provide details for error logging
 static String *
@@ -141,6 +162,21 @@ exitSafe(int result, bool error, SignalType signalType)
     // Log command end if a command is set
     if (cfgCommand() != cfgCmdNone)
     {
+        // Write reports in case the command ended before writing them. Errors are logged as warnings so the error that ended the
+        // command is still the one reported.
+        if (exitLocal.report != NULL)
+        {
+            TRY_BEGIN()
+            {
+                exitLocal.report();
+            }
+            CATCH_ANY()
+            {
+                LOG_WARN_FMT("unable to write reports: %s", errorMessage());
+            }
+            TRY_END();
+        }
+
         String *errorMessage = NULL;
 
         // On error generate an error message
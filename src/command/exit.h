@@ -18,12 +18,21 @@ typedef enum
     signalTypeTerm = SIGTERM,
 } SignalType;
 
+/***********************************************************************************************************************************
+Function types
+***********************************************************************************************************************************/
+typedef void (*ExitReportFunction)(void);
+
 /***********************************************************************************************************************************
 Functions
 ***********************************************************************************************************************************/
 // Setup signal handlers
 void exitInit(void);
 
+// Set the function used to write reports, e.g. the stat file, when the command ends. The function is called by exitSafe() before
+// the command end is logged, so it must do nothing when the reports have already been written.
+void exitReportInit(ExitReportFunction report);
+
 // Do cleanup and return result code
 int exitSafe(int result, bool error, SignalType signalType);
 
@@ -6,6 +6,8 @@ Expire Command
 #include "command/archive/common.h"
 #include "command/backup/common.h"
 #include "command/control/common.h"
+#include "command/expire/file.h"
+#include "command/expire/protocol.h"
 #include "common/time.h"
 #include "common/type/list.h"
 #include "common/debug.h"
@@ -15,6 +17,7 @@ Expire Command
 #include "info/infoBackup.h"
 #include "info/manifest.h"
 #include "protocol/helper.h"
+#include "protocol/parallel.h"
 #include "storage/helper.h"
 
 #include <stdlib.h>
@@ -35,6 +38,167 @@ typedef struct ArchiveRange
     const String *stop;
 } ArchiveRange;
 
+/***********************************************************************************************************************************
+Expired files and paths are queued and then removed together so the removal can be distributed across processes. Each path gets a
+separate job since it may contain many files. Files are batched into jobs to reduce protocol overhead.
+***********************************************************************************************************************************/
+#define EXPIRE_REMOVE_FILE_MAX                                      100
+
+typedef struct ExpireRemoveJob
+{
+    bool recurse;                                                   // Remove paths recursively rather than files
+    StringList *nameList;                                           // Files/paths to remove
+} ExpireRemoveJob;
+
+typedef struct ExpireRemove
+{
+    unsigned int repoIdx;                                           // Repo to remove from
+    List *jobList;                                                  // Remove jobs
+    unsigned int jobIdx;                                            // Next job to send to a process
+} ExpireRemove;
+
+// Queue a file or path (recursive) to be removed
+static void
+expireRemoveAdd(ExpireRemove *const this, const String *const name, const bool recurse)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, this);
+        FUNCTION_TEST_PARAM(STRING, name);
+        FUNCTION_TEST_PARAM(BOOL, recurse);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(name != NULL);
+
+    ExpireRemoveJob *job = lstEmpty(this->jobList) ? NULL : lstGetLast(this->jobList);
+
+    // Create a new job for each path or when the prior job cannot hold another file
+    if (job == NULL || recurse || job->recurse || strLstSize(job->nameList) == EXPIRE_REMOVE_FILE_MAX)
+    {
+        MEM_CONTEXT_BEGIN(lstMemContext(this->jobList))
+        {
+            job = lstAdd(this->jobList, &(ExpireRemoveJob){.recurse = recurse, .nameList = strLstNew()});
+        }
+        MEM_CONTEXT_END();
+    }
+
+    strLstAdd(job->nameList, name);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+// Callback to fetch remove jobs for the parallel executor
+static ProtocolParallelJob *
+expireRemoveJobCallback(void *const data, const unsigned int clientIdx)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, data);
+        FUNCTION_TEST_PARAM(UINT, clientIdx);
+    FUNCTION_TEST_END();
+
+    ASSERT(data != NULL);
+
+    ProtocolParallelJob *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // No special logic based on the client, we'll just get the next job
+        (void)clientIdx;
+
+        // Get a new job if there are any left
+        ExpireRemove *const this = data;
+
+        if (this->jobIdx < lstSize(this->jobList))
+        {
+            const ExpireRemoveJob *const job = lstGet(this->jobList, this->jobIdx);
+
+            ProtocolCommand *const command = protocolCommandNew(PROTOCOL_COMMAND_EXPIRE_REMOVE);
+            PackWrite *const param = protocolCommandParam(command);
+
+            pckWriteU32P(param, this->repoIdx);
+            pckWriteBoolP(param, job->recurse);
+            pckWriteStrLstP(param, job->nameList);
+
+            MEM_CONTEXT_PRIOR_BEGIN()
+            {
+                result = protocolParallelJobNew(VARUINT(this->jobIdx), command);
+            }
+            MEM_CONTEXT_PRIOR_END();
+
+            this->jobIdx++;
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN(PROTOCOL_PARALLEL_JOB, result);
+}
+
+// Remove queued files and paths, using local processes when process-max > 1 and there is more than one job
+static void
+expireRemoveProcess(ExpireRemove *const this)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM_P(VOID, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    const unsigned int processMax = cfgOptionUInt(cfgOptProcessMax);
+
+    // Remove in the main process when there is nothing to distribute
+    if (processMax == 1 || lstSize(this->jobList) <= 1)
+    {
+        for (unsigned int jobIdx = 0; jobIdx < lstSize(this->jobList); jobIdx++)
+        {
+            const ExpireRemoveJob *const job = lstGet(this->jobList, jobIdx);
+            expireFileRemove(this->repoIdx, job->recurse, job->nameList);
+        }
+    }
+    else
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            // Create the parallel executor
+            ProtocolParallel *const parallelExec = protocolParallelNew(
+                cfgOptionUInt64(cfgOptProtocolTimeout) / 2, expireRemoveJobCallback, this);
+
+            for (unsigned int processIdx = 1; processIdx <= processMax && processIdx <= lstSize(this->jobList); processIdx++)
+                protocolParallelClientAdd(parallelExec, protocolLocalGet(protocolStorageTypeRepo, this->repoIdx, processIdx));
+
+            // Process jobs. On error stop sending jobs but wait for the jobs in progress to complete so the processes are ready for
+            // the next repo, then throw the first error.
+            int jobErrorCode = 0;
+            const String *jobErrorMessage = NULL;
+
+            do
+            {
+                const unsigned int completed = protocolParallelProcess(parallelExec);
+
+                for (unsigned int jobIdx = 0; jobIdx < completed; jobIdx++)
+                {
+                    ProtocolParallelJob *const job = protocolParallelResult(parallelExec);
+
+                    if (protocolParallelJobErrorCode(job) != 0 && jobErrorCode == 0)
+                    {
+                        jobErrorCode = protocolParallelJobErrorCode(job);
+                        jobErrorMessage = strDup(protocolParallelJobErrorMessage(job));
+                        this->jobIdx = lstSize(this->jobList);
+                    }
+
+                    protocolParallelJobFree(job);
+                }
+            }
+            while (!protocolParallelDone(parallelExec));
+
+            if (jobErrorCode != 0)
+                THROW_CODE(jobErrorCode, strZ(jobErrorMessage));
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
 /***********************************************************************************************************************************
 Given a backup label, expire a backup and all its dependents (if any).
 ***********************************************************************************************************************************/
@@ -379,6 +543,9 @@ removeExpiredArchive(InfoBackup *infoBackup, bool timeBasedFullRetention, unsign
 
     MEM_CONTEXT_TEMP_BEGIN()
     {
+        // Expired files and paths are queued here and removed at the end
+        ExpireRemove remove = {.repoIdx = repoIdx, .jobList = lstNewP(sizeof(ExpireRemoveJob))};
+
         // Get the retention options. repo-archive-retention-type always has a value as it defaults to "full"
         const BackupType archiveRetentionType = (BackupType)cfgOptionIdxStrId(cfgOptRepoRetentionArchiveType, repoIdx);
         unsigned int archiveRetention = cfgOptionIdxTest(
@@ -529,7 +696,7 @@ removeExpiredArchive(InfoBackup *infoBackup, bool timeBasedFullRetention, unsign
 
                                 // Execute the real expiration and deletion only if the dry-run option is disabled
                                 if (!cfgOptionValid(cfgOptDryRun) || !cfgOptionBool(cfgOptDryRun))
-                                    storagePathRemoveP(storageRepoIdxWrite(repoIdx), fullPath, .recurse = true);
+                                    expireRemoveAdd(&remove, fullPath, true);
                             }
 
                             // Continue to next directory
@@ -659,10 +826,9 @@ removeExpiredArchive(InfoBackup *infoBackup, bool timeBasedFullRetention, unsign
                                     // Execute the real expiration and deletion only if the dry-run mode is disabled
                                     if (!cfgOptionValid(cfgOptDryRun) || !cfgOptionBool(cfgOptDryRun))
                                     {
-                                        storagePathRemoveP(
-                                            storageRepoIdxWrite(repoIdx),
-                                            strNewFmt(STORAGE_REPO_ARCHIVE "/%s/%s", strZ(archiveId), strZ(walPath)),
-                                            .recurse = true);
+                                        expireRemoveAdd(
+                                            &remove, strNewFmt(STORAGE_REPO_ARCHIVE "/%s/%s", strZ(archiveId), strZ(walPath)),
+                                            true);
                                     }
 
                                     archiveExpire.total++;
@@ -708,11 +874,12 @@ removeExpiredArchive(InfoBackup *infoBackup, bool timeBasedFullRetention, unsign
                                             // Execute the real expiration and deletion only if the dry-run mode is disabled
                                             if (!cfgOptionValid(cfgOptDryRun) || !cfgOptionBool(cfgOptDryRun))
                                             {
-                                                storageRemoveP(
-                                                    storageRepoIdxWrite(repoIdx),
+                                                expireRemoveAdd(
+                                                    &remove,
                                                     strNewFmt(
                                                         STORAGE_REPO_ARCHIVE "/%s/%s/%s", strZ(archiveId), strZ(walPath),
-                                                        strZ(walSubPath)));
+                                                        strZ(walSubPath)),
+                                                    false);
                                             }
 
                                             // Track that this archive was removed
@@ -758,9 +925,9 @@ removeExpiredArchive(InfoBackup *infoBackup, bool timeBasedFullRetention, unsign
                                     // Execute the real expiration and deletion only if the dry-run mode is disabled
                                     if (!cfgOptionValid(cfgOptDryRun) || !cfgOptionBool(cfgOptDryRun))
                                     {
-                                        storageRemoveP(
-                                            storageRepoIdxWrite(repoIdx),
-                                            strNewFmt(STORAGE_REPO_ARCHIVE "/%s/%s", strZ(archiveId), strZ(historyFile)));
+                                        expireRemoveAdd(
+                                            &remove, strNewFmt(STORAGE_REPO_ARCHIVE "/%s/%s", strZ(archiveId), strZ(historyFile)),
+                                            false);
                                     }
 
                                     LOG_INFO_FMT(
@@ -774,6 +941,9 @@ removeExpiredArchive(InfoBackup *infoBackup, bool timeBasedFullRetention, unsign
                 }
             }
         }
+
+        // Remove expired files and paths
+        expireRemoveProcess(&remove);
     }
     MEM_CONTEXT_TEMP_END();
 
@@ -781,9 +951,9 @@ removeExpiredArchive(InfoBackup *infoBackup, bool timeBasedFullRetention, unsign
 }
 
 /***********************************************************************************************************************************
-Remove expired backups from repo
+Remove expired backups from repo. Returns true if any backups were found to remove.
 ***********************************************************************************************************************************/
-static void
+static bool
 removeExpiredBackup(InfoBackup *infoBackup, const String *adhocBackupLabel, unsigned int repoIdx)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
@@ -794,8 +964,13 @@ removeExpiredBackup(InfoBackup *infoBackup, const String *adhocBackupLabel, unsi
 
     ASSERT(infoBackup != NULL);
 
+    bool result = false;
+
     MEM_CONTEXT_TEMP_BEGIN()
     {
+        // Expired files and paths are queued here and removed at the end
+        ExpireRemove remove = {.repoIdx = repoIdx, .jobList = lstNewP(sizeof(ExpireRemoveJob))};
+
         // Get all the current backups in backup.info - these will not be expired
         StringList *currentBackupList = strLstSort(infoBackupDataLabelList(infoBackup, NULL), sortOrderDesc);
 
@@ -848,14 +1023,116 @@ removeExpiredBackup(InfoBackup *infoBackup, const String *adhocBackupLabel, unsi
                     "%s: remove expired backup %s", cfgOptionGroupName(cfgOptGrpRepo, repoIdx),
                     strZ(strLstGet(backupList, backupIdx)));
 
+                result = true;
+
                 // Execute the real expiration and deletion only if the dry-run mode is disabled
                 if (!cfgOptionValid(cfgOptDryRun) || !cfgOptionBool(cfgOptDryRun))
                 {
-                    storagePathRemoveP(
-                        storageRepoIdxWrite(repoIdx), strNewFmt(STORAGE_REPO_BACKUP "/%s", strZ(strLstGet(backupList, backupIdx))),
-                        .recurse = true);
+                    expireRemoveAdd(
+                        &remove, strNewFmt(STORAGE_REPO_BACKUP "/%s", strZ(strLstGet(backupList, backupIdx))), true);
+                }
+            }
+        }
+
+        // Remove expired files and paths
+        expireRemoveProcess(&remove);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(BOOL, result);
+}
+
+/***********************************************************************************************************************************
+Remove files from the dedup store that are no longer referenced by a backup in the repo. All backups on disk are checked, including
+resumable backups, so files are only removed after the last backup that references them has been removed. Loading the manifests is
+expensive so this is only done after backups have been removed, since otherwise no references can have been removed. Temp files left
+by failed writes are removed along with the backup that failed.
+***********************************************************************************************************************************/
+static void
+removeExpiredDedup(InfoBackup *infoBackup, unsigned int repoIdx)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(INFO_BACKUP, infoBackup);
+        FUNCTION_LOG_PARAM(UINT, repoIdx);
+    FUNCTION_LOG_END();
+
+    ASSERT(infoBackup != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Only check references when there is a dedup store
+        if (storagePathExistsP(storageRepoIdx(repoIdx), STRDEF(STORAGE_REPO_BACKUP "/" MANIFEST_PATH_DEDUP)))
+        {
+            // Expired files are queued here and removed at the end
+            ExpireRemove remove = {.repoIdx = repoIdx, .jobList = lstNewP(sizeof(ExpireRemoveJob))};
+
+            // Get all the backups on disk
+            const StringList *const backupList = storageListP(
+                storageRepoIdx(repoIdx), STORAGE_REPO_BACKUP_STR,
+                .expression = backupRegExpP(.full = true, .differential = true, .incremental = true));
+
+            // Get all files in the dedup store referenced by the backups
+            StringList *const referenceList = strLstNew();
+
+            for (unsigned int backupIdx = 0; backupIdx < strLstSize(backupList); backupIdx++)
+            {
+                const String *const manifestFileName = strNewFmt(
+                    STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE, strZ(strLstGet(backupList, backupIdx)));
+
+                // Skip backups that were aborted before the manifest was saved since they cannot reference any files
+                if (!storageExistsP(storageRepoIdx(repoIdx), manifestFileName) &&
+                    !storageExistsP(storageRepoIdx(repoIdx), strNewFmt("%s" INFO_COPY_EXT, strZ(manifestFileName))))
+                {
+                    continue;
+                }
+
+                // Load one manifest at a time so only the references are kept in memory
+                MEM_CONTEXT_TEMP_BEGIN()
+                {
+                    const Manifest *const manifest = manifestLoadFile(
+                        storageRepoIdx(repoIdx), manifestFileName, cfgOptionIdxStrId(cfgOptRepoCipherType, repoIdx),
+                        infoPgCipherPass(infoBackupPg(infoBackup)));
+
+                    for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(manifest); fileIdx++)
+                    {
+                        const ManifestFile file = manifestFile(manifest, fileIdx);
+
+                        if (file.dedup)
+                        {
+                            strLstAdd(
+                                referenceList,
+                                manifestDedupFile(file.checksumSha1, manifestData(manifest)->backupOptionCompressType));
+                        }
+                    }
+                }
+                MEM_CONTEXT_TEMP_END();
+            }
+
+            strLstSort(referenceList, sortOrderAsc);
+
+            // Remove files in the store that are not referenced, including temp files left by failed writes
+            StorageIterator *const storageItr = storageNewItrP(
+                storageRepoIdx(repoIdx), STRDEF(STORAGE_REPO_BACKUP "/" MANIFEST_PATH_DEDUP), .recurse = true,
+                .level = storageInfoLevelType);
+
+            while (storageItrMore(storageItr))
+            {
+                const StorageInfo info = storageItrNext(storageItr);
+                const String *const dedupFile = strNewFmt(MANIFEST_PATH_DEDUP "/%s", strZ(info.name));
+
+                if (info.type == storageTypeFile && !strLstExists(referenceList, dedupFile))
+                {
+                    LOG_INFO_FMT(
+                        "%s: remove expired dedup file %s", cfgOptionGroupName(cfgOptGrpRepo, repoIdx), strZ(dedupFile));
+
+                    // Execute the real expiration and deletion only if the dry-run mode is disabled
+                    if (!cfgOptionValid(cfgOptDryRun) || !cfgOptionBool(cfgOptDryRun))
+                        expireRemoveAdd(&remove, strNewFmt(STORAGE_REPO_BACKUP "/%s", strZ(dedupFile)), false);
                 }
             }
+
+            // Remove expired files
+            expireRemoveProcess(&remove);
         }
     }
     MEM_CONTEXT_TEMP_END();
@@ -878,6 +1155,9 @@ removeExpiredHistory(InfoBackup *infoBackup, unsigned int repoIdx)
 
     MEM_CONTEXT_TEMP_BEGIN()
     {
+        // Expired files and paths are queued here and removed at the end
+        ExpireRemove remove = {.repoIdx = repoIdx, .jobList = lstNewP(sizeof(ExpireRemoveJob))};
+
         if (cfgOptionIdxTest(cfgOptRepoRetentionHistory, repoIdx))
         {
             // Get current backups in backup.info - these will not be expired
@@ -908,9 +1188,8 @@ removeExpiredHistory(InfoBackup *infoBackup, unsigned int repoIdx)
                     // Execute the real expiration and deletion only if the dry-run mode is disabled
                     if (!cfgOptionValid(cfgOptDryRun) || !cfgOptionBool(cfgOptDryRun))
                     {
-                        storagePathRemoveP(
-                            storageRepoIdxWrite(repoIdx),
-                            strNewFmt(STORAGE_REPO_BACKUP "/" BACKUP_PATH_HISTORY "/%s", strZ(historyYear)), .recurse = true);
+                        expireRemoveAdd(
+                            &remove, strNewFmt(STORAGE_REPO_BACKUP "/" BACKUP_PATH_HISTORY "/%s", strZ(historyYear)), true);
                     }
                 }
                 // Else find and remove individual files
@@ -939,11 +1218,12 @@ removeExpiredHistory(InfoBackup *infoBackup, unsigned int repoIdx)
                             // Execute the real expiration and deletion only if the dry-run mode is disabled
                             if (!cfgOptionValid(cfgOptDryRun) || !cfgOptionBool(cfgOptDryRun))
                             {
-                                storageRemoveP(
-                                    storageRepoIdxWrite(repoIdx),
+                                expireRemoveAdd(
+                                    &remove,
                                     strNewFmt(
-                                        STORAGE_REPO_BACKUP "/" BACKUP_PATH_HISTORY "/%s/%s",
-                                        strZ(historyYear), strZ(historyBackupFile)));
+                                        STORAGE_REPO_BACKUP "/" BACKUP_PATH_HISTORY "/%s/%s", strZ(historyYear),
+                                        strZ(historyBackupFile)),
+                                    false);
                             }
                         }
                     }
@@ -952,6 +1232,9 @@ removeExpiredHistory(InfoBackup *infoBackup, unsigned int repoIdx)
                     break;
             }
         }
+
+        // Remove expired files and paths
+        expireRemoveProcess(&remove);
     }
     MEM_CONTEXT_TEMP_END();
 
@@ -1063,7 +1346,8 @@ cmdExpire(void)
                 }
 
                 // Remove all files on disk that are now expired
-                removeExpiredBackup(infoBackup, adhocBackupLabel, repoIdx);
+                if (removeExpiredBackup(infoBackup, adhocBackupLabel, repoIdx))
+                    removeExpiredDedup(infoBackup, repoIdx);
                 removeExpiredArchive(infoBackup, timeBasedFullRetention, repoIdx);
                 removeExpiredHistory(infoBackup, repoIdx);
             }
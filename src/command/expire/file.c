@@ -0,0 +1,34 @@
+/***********************************************************************************************************************************
+Expire File
+***********************************************************************************************************************************/
+#include "build.auto.h"
+
+#include "command/expire/file.h"
+#include "common/debug.h"
+#include "common/log.h"
+#include "storage/helper.h"
+
+/**********************************************************************************************************************************/
+void
+expireFileRemove(const unsigned int repoIdx, const bool recurse, const StringList *const nameList)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(UINT, repoIdx);                          // Repo to remove from
+        FUNCTION_LOG_PARAM(BOOL, recurse);                          // Are these paths to remove recursively?
+        FUNCTION_LOG_PARAM(STRING_LIST, nameList);                  // Files/paths to remove
+    FUNCTION_LOG_END();
+
+    ASSERT(nameList != NULL);
+
+    const Storage *const storage = storageRepoIdxWrite(repoIdx);
+
+    for (unsigned int nameIdx = 0; nameIdx < strLstSize(nameList); nameIdx++)
+    {
+        if (recurse)
+            storagePathRemoveP(storage, strLstGet(nameList, nameIdx), .recurse = true);
+        else
+            storageRemoveP(storage, strLstGet(nameList, nameIdx));
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
@@ -0,0 +1,15 @@
+/***********************************************************************************************************************************
+Expire File
+***********************************************************************************************************************************/
+#ifndef COMMAND_EXPIRE_FILE_H
+#define COMMAND_EXPIRE_FILE_H
+
+#include "common/type/stringList.h"
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+// Remove a list of expired files or paths (recursively) from the repository
+void expireFileRemove(unsigned int repoIdx, bool recurse, const StringList *nameList);
+
+#endif
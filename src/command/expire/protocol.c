@@ -0,0 +1,40 @@
+/***********************************************************************************************************************************
+Expire Protocol Handler
+***********************************************************************************************************************************/
+#include "build.auto.h"
+
+#include "command/expire/file.h"
+#include "command/expire/protocol.h"
+#include "common/debug.h"
+#include "common/log.h"
+#include "common/memContext.h"
+
+/**********************************************************************************************************************************/
+void
+expireFileRemoveProtocol(PackRead *const param, ProtocolServer *const server)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(PACK_READ, param);
+        FUNCTION_LOG_PARAM(PROTOCOL_SERVER, server);
+    FUNCTION_LOG_END();
+
+    ASSERT(param != NULL);
+    ASSERT(server != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Remove files/paths
+        const unsigned int repoIdx = pckReadU32P(param);
+        const bool recurse = pckReadBoolP(param);
+        const StringList *const nameList = pckReadStrLstP(param);
+
+        expireFileRemove(repoIdx, recurse, nameList);
+
+        // Return result
+        protocolServerDataPut(server, NULL);
+        protocolServerDataEndPut(server);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
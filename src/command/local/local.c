@@ -6,14 +6,23 @@ Local Command
 #include "command/archive/get/protocol.h"
 #include "command/archive/push/protocol.h"
 #include "command/backup/protocol.h"
+#include "command/command.h"
+#include "command/exit.h"
+#include "command/expire/protocol.h"
 #include "command/restore/protocol.h"
 #include "command/verify/protocol.h"
 #include "common/debug.h"
+#include "common/io/filter/rate.h"
+#include "common/lock.h"
 #include "common/log.h"
+#include "common/stat.h"
+#include "common/trace.h"
 #include "config/config.intern.h"
+#include "config/load.h"
 #include "config/protocol.h"
 #include "protocol/helper.h"
 #include "protocol/server.h"
+#include "storage/helper.h"
 
 /***********************************************************************************************************************************
 Command handlers
@@ -23,6 +32,7 @@ static const ProtocolServerHandler commandLocalHandlerList[] =
     PROTOCOL_SERVER_HANDLER_ARCHIVE_GET_LIST
     PROTOCOL_SERVER_HANDLER_ARCHIVE_PUSH_LIST
     PROTOCOL_SERVER_HANDLER_BACKUP_LIST
+    PROTOCOL_SERVER_HANDLER_EXPIRE_LIST
     PROTOCOL_SERVER_HANDLER_RESTORE_LIST
     PROTOCOL_SERVER_HANDLER_VERIFY_LIST
 };
@@ -33,11 +43,72 @@ cmdLocal(ProtocolServer *server)
 {
     FUNCTION_LOG_VOID(logLevelDebug);
 
+    // Initialize trace collector when a trace file is requested. Events are sent to the main process which writes the file.
+    if (cfgOptionTest(cfgOptTraceFile))
+        traceInit(cfgOptionUInt(cfgOptProcess));
+
     MEM_CONTEXT_TEMP_BEGIN()
     {
+        // Set I/O rate limits for commands that copy files. The limits are shared by all local processes on this host via a file in
+        // the lock path.
+        if (cfgOptionValid(cfgOptIoRateIops))
+        {
+            ioRateInit(
+                strNewFmt("%s/%s" IO_RATE_FILE_EXT, strZ(cfgOptionStr(cfgOptLockPath)), strZ(cfgOptionStr(cfgOptStanza))),
+                cfgOptionUInt64(cfgOptIoRateRead), cfgOptionUInt64(cfgOptIoRateWrite), cfgOptionUInt64(cfgOptIoRateIops));
+        }
+
         protocolServerProcess(server, cfgCommandJobRetry(), commandLocalHandlerList, LENGTH_OF(commandLocalHandlerList));
     }
     MEM_CONTEXT_TEMP_END();
 
     FUNCTION_LOG_RETURN_VOID();
 }
+
+/**********************************************************************************************************************************/
+int
+cmdLocalFork(const StringList *const param, IoRead *const forkRead, IoWrite *const forkWrite)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STRING_LIST, param);
+        FUNCTION_LOG_PARAM(IO_READ, forkRead);
+        FUNCTION_LOG_PARAM(IO_WRITE, forkWrite);
+    FUNCTION_LOG_END();
+
+    ASSERT(param != NULL);
+    ASSERT(forkRead != NULL);
+    ASSERT(forkWrite != NULL);
+
+    volatile int result = 0;
+    volatile bool error = false;
+
+    // Errors must be caught here since handlers outside this function belong to the main process
+    TRY_BEGIN()
+    {
+        // Storage may have open connections that belong to the main process so free it. Locks are still held by the main process so
+        // forget them rather than releasing them on exit.
+        storageHelperFree();
+        lockForget();
+
+        // Stats recorded by the main process before the fork will be reported by the main process
+        statReset();
+
+        // Initialize command with the start time and load the configuration
+        cmdInit();
+        cfgLoad(strLstSize(param), strLstPtr(param));
+
+        // Process requests from the main process the same as an executed local
+        cmdLocal(
+            protocolServerNew(
+                strNewFmt(PROTOCOL_SERVICE_LOCAL "-%s", strZ(cfgOptionDisplay(cfgOptProcess))), PROTOCOL_SERVICE_LOCAL_STR,
+                forkRead, forkWrite));
+    }
+    CATCH_FATAL()
+    {
+        error = true;
+        result = exitSafe(result, true, 0);
+    }
+    TRY_END();
+
+    FUNCTION_LOG_RETURN(INT, error ? result : exitSafe(result, false, 0));
+}
@@ -12,4 +12,9 @@ Functions
 // Local command
 void cmdLocal(ProtocolServer *server);
 
+// Run the local command in a process forked from the main process. The parameter list is the same one that would be used to execute
+// the local command, requests are read from/responses written to the main process using the read/write interfaces, and the return
+// value is the exit code of the process.
+int cmdLocalFork(const StringList *param, IoRead *read, IoWrite *write);
+
 #endif
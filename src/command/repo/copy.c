@@ -0,0 +1,472 @@
+/***********************************************************************************************************************************
+Repository Copy Command
+***********************************************************************************************************************************/
+#include "build.auto.h"
+
+#include "command/archive/common.h"
+#include "command/backup/common.h"
+#include "command/repo/copy.h"
+#include "common/compress/helper.h"
+#include "common/crypto/cipherBlock.h"
+#include "common/debug.h"
+#include "common/log.h"
+#include "common/memContext.h"
+#include "common/regExp.h"
+#include "config/config.h"
+#include "info/infoArchive.h"
+#include "info/infoBackup.h"
+#include "info/manifest.h"
+#include "protocol/helper.h"
+#include "storage/helper.h"
+
+/***********************************************************************************************************************************
+Copy totals for the summary
+***********************************************************************************************************************************/
+typedef struct RepoCopyTotal
+{
+    unsigned int backup;                                            // Backups copied
+    unsigned int archive;                                           // WAL files copied
+    unsigned int server;                                            // Files copied by the storage server
+} RepoCopyTotal;
+
+/***********************************************************************************************************************************
+Copy a file between repos. The file is copied by the storage server when the cipher passes are the same since the file can then be
+copied as it is stored. Otherwise the file is streamed through this process without decompression and is only decrypted and
+encrypted again with the target cipher pass.
+***********************************************************************************************************************************/
+static void
+repoCopyFile(
+    const unsigned int repoIdxSource, const String *const fileSource, const String *const cipherPassSource,
+    const unsigned int repoIdxTarget, const String *const fileTarget, const String *const cipherPassTarget,
+    RepoCopyTotal *const total)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(UINT, repoIdxSource);
+        FUNCTION_LOG_PARAM(STRING, fileSource);
+        FUNCTION_TEST_PARAM(STRING, cipherPassSource);
+        FUNCTION_LOG_PARAM(UINT, repoIdxTarget);
+        FUNCTION_LOG_PARAM(STRING, fileTarget);
+        FUNCTION_TEST_PARAM(STRING, cipherPassTarget);
+        FUNCTION_LOG_PARAM_P(VOID, total);
+    FUNCTION_LOG_END();
+
+    ASSERT(fileSource != NULL);
+    ASSERT(fileTarget != NULL);
+    ASSERT(total != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const bool cipherPassEq = strEq(cipherPassSource, cipherPassTarget);
+
+        if (cipherPassEq &&
+            storageCopyServerP(storageRepoIdx(repoIdxSource), fileSource, storageRepoIdxWrite(repoIdxTarget), fileTarget))
+        {
+            total->server++;
+        }
+        else
+        {
+            StorageRead *const read = storageNewReadP(storageRepoIdx(repoIdxSource), fileSource);
+            StorageWrite *const write = storageNewWriteP(storageRepoIdxWrite(repoIdxTarget), fileTarget);
+
+            if (!cipherPassEq)
+            {
+                const CipherType cipherType = cfgOptionIdxStrId(cfgOptRepoCipherType, repoIdxSource);
+
+                cipherBlockFilterGroupAdd(ioReadFilterGroup(storageReadIo(read)), cipherType, cipherModeDecrypt, cipherPassSource);
+                cipherBlockFilterGroupAdd(
+                    ioWriteFilterGroup(storageWriteIo(write)), cipherType, cipherModeEncrypt, cipherPassTarget);
+            }
+
+            storageCopyP(read, write);
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Find the target history that matches the source history. The same id is preferred but ids may differ when the stanzas were created
+or upgraded separately so any history with the same system id and version is accepted. Returns the total number of history entries
+in the target when there is no match.
+***********************************************************************************************************************************/
+static unsigned int
+repoCopyHistoryMatch(const InfoPg *const infoPgTarget, const InfoPgData *const pgDataSource)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INFO_PG, infoPgTarget);
+        FUNCTION_TEST_PARAM_P(VOID, pgDataSource);
+    FUNCTION_TEST_END();
+
+    ASSERT(infoPgTarget != NULL);
+    ASSERT(pgDataSource != NULL);
+
+    unsigned int result = infoPgDataTotal(infoPgTarget);
+
+    for (unsigned int pgIdx = 0; pgIdx < infoPgDataTotal(infoPgTarget); pgIdx++)
+    {
+        const InfoPgData pgData = infoPgData(infoPgTarget, pgIdx);
+
+        if (pgData.systemId == pgDataSource->systemId && pgData.version == pgDataSource->version)
+        {
+            if (result == infoPgDataTotal(infoPgTarget) || pgData.id == pgDataSource->id)
+                result = pgIdx;
+        }
+    }
+
+    FUNCTION_TEST_RETURN(UINT, result);
+}
+
+/***********************************************************************************************************************************
+Get the name used to find WAL in the target repo. WAL segments are stored with a checksum, which may differ between repos when the
+segment was pushed again (e.g. after a restore), so segments are matched on the timeline/segment path only. A second copy of the
+same segment in the target would cause archive-get to fail with duplicates found. Other files, e.g. history and backup history, are
+matched on the full name.
+***********************************************************************************************************************************/
+static String *
+repoCopyArchiveName(const String *const name, RegExp *const segmentExp)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, name);
+        FUNCTION_TEST_PARAM_P(VOID, segmentExp);
+    FUNCTION_TEST_END();
+
+    ASSERT(name != NULL);
+    ASSERT(segmentExp != NULL);
+
+    String *result;
+
+    if (regExpMatch(segmentExp, name))
+        result = strSubN(name, 0, (size_t)(strrchr(strZ(name), '/') - strZ(name)) + 1 + WAL_SEGMENT_NAME_SIZE);
+    else
+        result = strDup(name);
+
+    FUNCTION_TEST_RETURN(STRING, result);
+}
+
+/***********************************************************************************************************************************
+Copy WAL that is missing in the target repo
+***********************************************************************************************************************************/
+static void
+repoCopyArchive(
+    const unsigned int repoIdxSource, const InfoArchive *const infoArchiveSource, const unsigned int repoIdxTarget,
+    const InfoArchive *const infoArchiveTarget, RepoCopyTotal *const total)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(UINT, repoIdxSource);
+        FUNCTION_LOG_PARAM(INFO_ARCHIVE, infoArchiveSource);
+        FUNCTION_LOG_PARAM(UINT, repoIdxTarget);
+        FUNCTION_LOG_PARAM(INFO_ARCHIVE, infoArchiveTarget);
+        FUNCTION_LOG_PARAM_P(VOID, total);
+    FUNCTION_LOG_END();
+
+    ASSERT(infoArchiveSource != NULL);
+    ASSERT(infoArchiveTarget != NULL);
+    ASSERT(total != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const InfoPg *const infoPgSource = infoArchivePg(infoArchiveSource);
+        const InfoPg *const infoPgTarget = infoArchivePg(infoArchiveTarget);
+        RegExp *const segmentExp = regExpNew(STRDEF("^[0-F]{16}/[0-F]{24}(-|$)"));
+
+        for (unsigned int pgIdx = 0; pgIdx < infoPgDataTotal(infoPgSource); pgIdx++)
+        {
+            const InfoPgData pgData = infoPgData(infoPgSource, pgIdx);
+            const String *const archiveIdSource = infoPgArchiveId(infoPgSource, pgIdx);
+            const unsigned int pgIdxTarget = repoCopyHistoryMatch(infoPgTarget, &pgData);
+
+            if (pgIdxTarget == infoPgDataTotal(infoPgTarget))
+            {
+                LOG_WARN_FMT(
+                    "archive '%s' does not match the history of repo%u\n"
+                    "HINT: has the stanza been upgraded in repo%u?",
+                    strZ(archiveIdSource), cfgOptionGroupIdxToKey(cfgOptGrpRepo, repoIdxTarget),
+                    cfgOptionGroupIdxToKey(cfgOptGrpRepo, repoIdxTarget));
+                continue;
+            }
+
+            const String *const archiveIdTarget = infoPgArchiveId(infoPgTarget, pgIdxTarget);
+
+            // Get the files that are already in the target
+            StringList *const fileTargetList = strLstNew();
+            StorageIterator *const storageItrTarget = storageNewItrP(
+                storageRepoIdx(repoIdxTarget), strNewFmt(STORAGE_REPO_ARCHIVE "/%s", strZ(archiveIdTarget)),
+                .level = storageInfoLevelType, .recurse = true);
+
+            while (storageItrMore(storageItrTarget))
+            {
+                const StorageInfo info = storageItrNext(storageItrTarget);
+
+                if (info.type == storageTypeFile)
+                {
+                    String *const name = repoCopyArchiveName(info.name, segmentExp);
+
+                    strLstAdd(fileTargetList, name);
+                    strFree(name);
+                }
+            }
+
+            strLstSort(fileTargetList, sortOrderAsc);
+
+            // Copy the files that are missing in the target
+            StorageIterator *const storageItrSource = storageNewItrP(
+                storageRepoIdx(repoIdxSource), strNewFmt(STORAGE_REPO_ARCHIVE "/%s", strZ(archiveIdSource)),
+                .level = storageInfoLevelType, .recurse = true, .sortOrder = sortOrderAsc);
+
+            while (storageItrMore(storageItrSource))
+            {
+                const StorageInfo info = storageItrNext(storageItrSource);
+
+                if (info.type != storageTypeFile)
+                    continue;
+
+                String *const nameTarget = repoCopyArchiveName(info.name, segmentExp);
+                const bool exists = strLstExists(fileTargetList, nameTarget);
+
+                strFree(nameTarget);
+
+                if (!exists)
+                {
+                    repoCopyFile(
+                        repoIdxSource, strNewFmt(STORAGE_REPO_ARCHIVE "/%s/%s", strZ(archiveIdSource), strZ(info.name)),
+                        infoPgCipherPass(infoPgSource), repoIdxTarget,
+                        strNewFmt(STORAGE_REPO_ARCHIVE "/%s/%s", strZ(archiveIdTarget), strZ(info.name)),
+                        infoPgCipherPass(infoPgTarget), total);
+
+                    total->archive++;
+                }
+            }
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Copy a backup to the target repo. Backup files are copied as they are stored since they are encrypted with the cipher pass in the
+manifest. The manifest is rewritten with the history id of the target repo and encrypted with the target backup cipher pass.
+***********************************************************************************************************************************/
+static void
+repoCopyBackup(
+    const unsigned int repoIdxSource, const InfoBackup *const infoBackupSource, const unsigned int repoIdxTarget,
+    InfoBackup *const infoBackupTarget, const String *const backupLabel, RepoCopyTotal *const total)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(UINT, repoIdxSource);
+        FUNCTION_LOG_PARAM(INFO_BACKUP, infoBackupSource);
+        FUNCTION_LOG_PARAM(UINT, repoIdxTarget);
+        FUNCTION_LOG_PARAM(INFO_BACKUP, infoBackupTarget);
+        FUNCTION_LOG_PARAM(STRING, backupLabel);
+        FUNCTION_LOG_PARAM_P(VOID, total);
+    FUNCTION_LOG_END();
+
+    ASSERT(infoBackupSource != NULL);
+    ASSERT(infoBackupTarget != NULL);
+    ASSERT(backupLabel != NULL);
+    ASSERT(total != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const unsigned int repoKeyTarget = cfgOptionGroupIdxToKey(cfgOptGrpRepo, repoIdxTarget);
+        const CipherType cipherType = cfgOptionIdxStrId(cfgOptRepoCipherType, repoIdxTarget);
+        const String *const cipherPassTarget = infoPgCipherPass(infoBackupPg(infoBackupTarget));
+        const String *const backupPath = strNewFmt(STORAGE_REPO_BACKUP "/%s", strZ(backupLabel));
+
+        Manifest *const manifest = manifestLoadFile(
+            storageRepoIdx(repoIdxSource), strNewFmt("%s/" BACKUP_MANIFEST_FILE, strZ(backupPath)), cipherType,
+            infoPgCipherPass(infoBackupPg(infoBackupSource)));
+        const ManifestData *const manifestDataSource = manifestData(manifest);
+
+        // The backup must be from a cluster in the target history
+        const InfoPgData pgData =
+        {
+            .id = manifestDataSource->pgId,
+            .version = manifestDataSource->pgVersion,
+            .systemId = manifestDataSource->pgSystemId,
+        };
+        const InfoPg *const infoPgTarget = infoBackupPg(infoBackupTarget);
+        const unsigned int pgIdxTarget = repoCopyHistoryMatch(infoPgTarget, &pgData);
+
+        if (pgIdxTarget == infoPgDataTotal(infoPgTarget))
+        {
+            LOG_WARN_FMT(
+                "backup '%s' does not match the history of repo%u\n"
+                "HINT: has the stanza been upgraded in repo%u?",
+                strZ(backupLabel), repoKeyTarget, repoKeyTarget);
+        }
+        else
+        {
+            LOG_INFO_FMT("copy backup %s to repo%u", strZ(backupLabel), repoKeyTarget);
+
+            manifestPgIdSet(manifest, infoPgData(infoPgTarget, pgIdxTarget).id);
+
+            // Copy backup files. The manifest is saved last to mark the backup as complete.
+            StorageIterator *const storageItr = storageNewItrP(
+                storageRepoIdx(repoIdxSource), backupPath, .level = storageInfoLevelType, .recurse = true,
+                .sortOrder = sortOrderAsc);
+
+            while (storageItrMore(storageItr))
+            {
+                const StorageInfo info = storageItrNext(storageItr);
+
+                if (info.type == storageTypeFile && !strEqZ(info.name, BACKUP_MANIFEST_FILE) &&
+                    !strEqZ(info.name, BACKUP_MANIFEST_FILE INFO_COPY_EXT))
+                {
+                    const String *const file = strNewFmt("%s/%s", strZ(backupPath), strZ(info.name));
+
+                    repoCopyFile(repoIdxSource, file, NULL, repoIdxTarget, file, NULL, total);
+                }
+            }
+
+            // Copy files in the dedup store that are missing in the target
+            StringList *const dedupList = strLstNew();
+
+            for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(manifest); fileIdx++)
+            {
+                const ManifestFile file = manifestFile(manifest, fileIdx);
+
+                if (file.dedup)
+                {
+                    const String *const dedupFile = strNewFmt(
+                        STORAGE_REPO_BACKUP "/%s",
+                        strZ(manifestDedupFile(file.checksumSha1, manifestDataSource->backupOptionCompressType)));
+
+                    if (!strLstExists(dedupList, dedupFile))
+                    {
+                        strLstAdd(dedupList, dedupFile);
+
+                        if (!storageExistsP(storageRepoIdx(repoIdxTarget), dedupFile))
+                            repoCopyFile(repoIdxSource, dedupFile, NULL, repoIdxTarget, dedupFile, NULL, total);
+                    }
+                }
+            }
+
+            // Save the manifest and a compressed copy to history
+            const String *const manifestFileList[] =
+            {
+                strNewFmt("%s/" BACKUP_MANIFEST_FILE INFO_COPY_EXT, strZ(backupPath)),
+                strNewFmt("%s/" BACKUP_MANIFEST_FILE, strZ(backupPath)),
+                strNewFmt(
+                    STORAGE_REPO_BACKUP "/" BACKUP_PATH_HISTORY "/%s/%s.manifest%s", strZ(strSubN(backupLabel, 0, 4)),
+                    strZ(backupLabel), strZ(compressExtStr(compressTypeGz))),
+            };
+
+            for (unsigned int manifestIdx = 0; manifestIdx < LENGTH_OF(manifestFileList); manifestIdx++)
+            {
+                IoWrite *const write = storageWriteIo(
+                    storageNewWriteP(storageRepoIdxWrite(repoIdxTarget), manifestFileList[manifestIdx]));
+
+                if (manifestIdx == LENGTH_OF(manifestFileList) - 1)
+                    ioFilterGroupAdd(ioWriteFilterGroup(write), compressFilter(compressTypeGz, 9));
+
+                cipherBlockFilterGroupAdd(ioWriteFilterGroup(write), cipherType, cipherModeEncrypt, cipherPassTarget);
+                manifestSave(manifest, write);
+            }
+
+            // Add the backup to backup.info (infoBackupSaveFile() is responsible for proper syncing)
+            infoBackupDataAdd(infoBackupTarget, manifest);
+
+            infoBackupSaveFile(
+                infoBackupTarget, storageRepoIdxWrite(repoIdxTarget), INFO_BACKUP_PATH_FILE_STR, cipherType,
+                cfgOptionIdxStrNull(cfgOptRepoCipherPass, repoIdxTarget));
+
+            // Link latest when this is the most recent backup in the target
+            if (strEq(backupLabel, infoBackupData(infoBackupTarget, infoBackupDataTotal(infoBackupTarget) - 1).backupLabel))
+                backupLinkLatest(backupLabel, repoIdxTarget);
+
+            total->backup++;
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+void
+cmdRepoCopy(void)
+{
+    FUNCTION_LOG_VOID(logLevelDebug);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const unsigned int repoIdxSource = cfgOptionGroupIdxDefault(cfgOptGrpRepo);
+        const unsigned int repoKeyTarget = cfgOptionUInt(cfgOptRepoTarget);
+        unsigned int repoIdxTarget = 0;
+
+        // Find the repo index for the key
+        for (; repoIdxTarget < cfgOptionGroupIdxTotal(cfgOptGrpRepo); repoIdxTarget++)
+        {
+            if (cfgOptionGroupIdxToKey(cfgOptGrpRepo, repoIdxTarget) == repoKeyTarget)
+                break;
+        }
+
+        if (repoIdxTarget == cfgOptionGroupIdxTotal(cfgOptGrpRepo) || repoIdxTarget == repoIdxSource)
+        {
+            THROW_FMT(
+                OptionInvalidError, "'%u' is not valid for '" CFGOPT_REPO_TARGET "' option\n"
+                "HINT: the repo must be configured and not be the repo selected for the copy.", repoKeyTarget);
+        }
+
+        // The repos must be encrypted the same way so files can be copied as they are stored
+        const CipherType cipherType = cfgOptionIdxStrId(cfgOptRepoCipherType, repoIdxSource);
+
+        if (cfgOptionIdxStrId(cfgOptRepoCipherType, repoIdxTarget) != cipherType)
+        {
+            THROW_FMT(
+                OptionInvalidError, "'%u' is not valid for '" CFGOPT_REPO_TARGET "' option\n"
+                "HINT: the repo must have the same '%s' as the repo selected for the copy.", repoKeyTarget,
+                cfgOptionIdxName(cfgOptRepoCipherType, repoIdxTarget));
+        }
+
+        repoIsLocalVerifyIdx(repoIdxSource);
+        repoIsLocalVerifyIdx(repoIdxTarget);
+
+        // Load info files. The stanza must already exist in the target.
+        const InfoArchive *const infoArchiveSource = infoArchiveLoadFile(
+            storageRepoIdx(repoIdxSource), INFO_ARCHIVE_PATH_FILE_STR, cipherType,
+            cfgOptionIdxStrNull(cfgOptRepoCipherPass, repoIdxSource));
+        const InfoArchive *const infoArchiveTarget = infoArchiveLoadFile(
+            storageRepoIdx(repoIdxTarget), INFO_ARCHIVE_PATH_FILE_STR, cipherType,
+            cfgOptionIdxStrNull(cfgOptRepoCipherPass, repoIdxTarget));
+        const InfoBackup *const infoBackupSource = infoBackupLoadFile(
+            storageRepoIdx(repoIdxSource), INFO_BACKUP_PATH_FILE_STR, cipherType,
+            cfgOptionIdxStrNull(cfgOptRepoCipherPass, repoIdxSource));
+        InfoBackup *const infoBackupTarget = infoBackupLoadFile(
+            storageRepoIdx(repoIdxTarget), INFO_BACKUP_PATH_FILE_STR, cipherType,
+            cfgOptionIdxStrNull(cfgOptRepoCipherPass, repoIdxTarget));
+
+        // Copy WAL first so the backups are consistent as soon as they are added to the target
+        RepoCopyTotal total = {0};
+
+        repoCopyArchive(repoIdxSource, infoArchiveSource, repoIdxTarget, infoArchiveTarget, &total);
+
+        // Copy backups in order so prior backups are copied before the backups that depend on them
+        for (unsigned int backupIdx = 0; backupIdx < infoBackupDataTotal(infoBackupSource); backupIdx++)
+        {
+            const InfoBackupData backupData = infoBackupData(infoBackupSource, backupIdx);
+
+            if (infoBackupLabelExists(infoBackupTarget, backupData.backupLabel))
+                continue;
+
+            if (backupData.backupPrior != NULL && !infoBackupLabelExists(infoBackupTarget, backupData.backupPrior))
+            {
+                LOG_WARN_FMT(
+                    "backup '%s' skipped since prior backup '%s' does not exist in repo%u", strZ(backupData.backupLabel),
+                    strZ(backupData.backupPrior), repoKeyTarget);
+                continue;
+            }
+
+            repoCopyBackup(repoIdxSource, infoBackupSource, repoIdxTarget, infoBackupTarget, backupData.backupLabel, &total);
+        }
+
+        LOG_INFO_FMT(
+            "copied %u backup(s) and %u WAL file(s) to repo%u (%u file(s) copied by the storage server)", total.backup,
+            total.archive, repoKeyTarget, total.server);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
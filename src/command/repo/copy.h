@@ -0,0 +1,13 @@
+/***********************************************************************************************************************************
+Repository Copy Command
+***********************************************************************************************************************************/
+#ifndef COMMAND_REPO_COPY_H
+#define COMMAND_REPO_COPY_H
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+// Copy backups and WAL that are missing in the target repository
+void cmdRepoCopy(void);
+
+#endif
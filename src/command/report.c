@@ -0,0 +1,107 @@
+/***********************************************************************************************************************************
+Command Reports
+***********************************************************************************************************************************/
+#include "build.auto.h"
+
+#include "command/report.h"
+#include "common/debug.h"
+#include "common/log.h"
+#include "common/stat.h"
+#include "common/trace.h"
+#include "config/config.h"
+#include "protocol/helper.h"
+#include "storage/helper.h"
+
+/***********************************************************************************************************************************
+Local variables
+***********************************************************************************************************************************/
+static struct CmdReportLocal
+{
+    bool written;                                                   // Have reports been written?
+    String *traceFile;                                              // Trace file requested when the command started
+} cmdReportLocal;
+
+/**********************************************************************************************************************************/
+void
+cmdReportInit(void)
+{
+    FUNCTION_LOG_VOID(logLevelTrace);
+
+    if (cfgOptionTest(cfgOptTraceFile))
+    {
+        MEM_CONTEXT_BEGIN(memContextTop())
+        {
+            cmdReportLocal.traceFile = strDup(cfgOptionStr(cfgOptTraceFile));
+        }
+        MEM_CONTEXT_END();
+
+        traceInit(0);
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Was a stat file requested?
+***********************************************************************************************************************************/
+static bool
+cmdReportStatFile(void)
+{
+    FUNCTION_TEST_VOID();
+    FUNCTION_TEST_RETURN(BOOL, cfgOptionValid(cfgOptStatFile) && cfgOptionTest(cfgOptStatFile));
+}
+
+/***********************************************************************************************************************************
+Will stats be reported? Stats are logged at detail level when the command ends (see cmdEnd()) or written to the stat file.
+***********************************************************************************************************************************/
+static bool
+cmdReportStat(void)
+{
+    FUNCTION_TEST_VOID();
+    FUNCTION_TEST_RETURN(BOOL, logAny(logLevelDetail) || cmdReportStatFile());
+}
+
+/**********************************************************************************************************************************/
+void
+cmdReportStatCollect(void)
+{
+    FUNCTION_LOG_VOID(logLevelTrace);
+
+    if (cmdReportStat())
+        protocolStatCollect();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+void
+cmdReportWrite(void)
+{
+    FUNCTION_LOG_VOID(logLevelTrace);
+
+    // Reports are only written once, even when writing fails
+    if (!cmdReportLocal.written && cfgCommand() != cfgCmdNone && !cfgCommandHelp())
+    {
+        cmdReportLocal.written = true;
+
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            // Write stats to a file when requested
+            if (cmdReportStatFile())
+            {
+                const String *const statJson = statToJsonP(.histogram = true);
+
+                storagePutP(
+                    storageNewWriteP(storageLocalWrite(), cfgOptionStr(cfgOptStatFile)),
+                    BUFSTR(statJson != NULL ? statJson : STRDEF("{}")));
+            }
+
+            // Write trace to a file when requested
+            if (cmdReportLocal.traceFile != NULL)
+                storagePutP(storageNewWriteP(storageLocalWrite(), cmdReportLocal.traceFile), BUFSTR(traceToJson()));
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
@@ -0,0 +1,24 @@
+/***********************************************************************************************************************************
+Command Reports
+
+Write the stat and trace files requested for the command. Reports are written when the command completes and also when it
+fails, since stats from a failed command are often the most useful for finding out what went wrong.
+***********************************************************************************************************************************/
+#ifndef COMMAND_REPORT_H
+#define COMMAND_REPORT_H
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+// Initialize reports for the main process. The trace collector is started when a trace file is requested and the file name is
+// stored since the command may change, e.g. from backup to expire.
+void cmdReportInit(void);
+
+// Collect stats from locals and remotes before they are freed, but only when the stats will be logged or written to a file
+void cmdReportStatCollect(void);
+
+// Write reports that were requested for the command. Reports are only written once, so this may be called again by exitSafe() (see
+// exitReportInit()) when the command fails.
+void cmdReportWrite(void);
+
+#endif
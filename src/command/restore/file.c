@@ -4,6 +4,7 @@ Restore File
 #include "build.auto.h"
 
 #include <fcntl.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #include <utime.h>
 
@@ -12,17 +13,129 @@ Restore File
 #include "common/crypto/hash.h"
 #include "common/debug.h"
 #include "common/io/filter/group.h"
+#include "common/io/filter/rate.h"
 #include "common/io/filter/size.h"
+#include "common/io/filter/tee.h"
 #include "common/io/io.h"
 #include "common/log.h"
+#include "common/trace.h"
+#include "common/user.h"
 #include "config/config.h"
 #include "info/manifest.h"
 #include "storage/helper.h"
 
+/***********************************************************************************************************************************
+Helper to get the destination of a pg file in a fan-out path
+***********************************************************************************************************************************/
+static String *
+restoreFileFanoutPath(const String *const fanoutPath, const String *const pgFile)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, fanoutPath);
+        FUNCTION_TEST_PARAM(STRING, pgFile);
+    FUNCTION_TEST_END();
+
+    ASSERT(fanoutPath != NULL);
+    ASSERT(pgFile != NULL);
+
+    const String *const pgPath = storagePathP(storagePg(), NULL);
+    ASSERT(strBeginsWith(pgFile, pgPath) && strZ(pgFile)[strSize(pgPath)] == '/');
+
+    FUNCTION_TEST_RETURN(STRING, strNewFmt("%s%s", strZ(fanoutPath), strZ(pgFile) + strSize(pgPath)));
+}
+
+/***********************************************************************************************************************************
+Helper to create a zeroed or zero-length file
+***********************************************************************************************************************************/
+static void
+restoreFileZero(const Storage *const storage, const String *const pgFile, const RestoreFile *const file)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STORAGE, storage);
+        FUNCTION_TEST_PARAM(STRING, pgFile);
+        FUNCTION_TEST_PARAM_P(VOID, file);
+    FUNCTION_TEST_END();
+
+    ASSERT(storage != NULL);
+    ASSERT(pgFile != NULL);
+    ASSERT(file != NULL);
+
+    // Create destination file
+    StorageWrite *pgFileWrite = storageNewWriteP(
+        storage, pgFile, .modeFile = file->mode, .user = file->user, .group = file->group, .timeModified = file->timeModified,
+        .noAtomic = true, .noCreatePath = true, .noSyncPath = true);
+
+    ioWriteOpen(storageWriteIo(pgFileWrite));
+
+    // Truncate the file to specified length (note in this case the file will grow, not shrink)
+    if (file->zero)
+    {
+        THROW_ON_SYS_ERROR_FMT(
+            ftruncate(ioWriteFd(storageWriteIo(pgFileWrite)), (off_t)file->size) == -1, FileWriteError,
+            "unable to truncate '%s'", strZ(pgFile));
+    }
+
+    ioWriteClose(storageWriteIo(pgFileWrite));
+    storageWriteFree(pgFileWrite);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Helpers to get the range of the pg file restored from a part of a split file and to set the size of the file. Every part sets the
+size when the file is opened so the file has the expected size no matter which parts are restored first or preserved by delta.
+***********************************************************************************************************************************/
+static uint64_t
+restoreFileSplitOffset(const RestoreFile *const file)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, file);
+    FUNCTION_TEST_END();
+
+    ASSERT(file != NULL);
+
+    FUNCTION_TEST_RETURN(UINT64, file->splitSize * file->splitPart);
+}
+
+static uint64_t
+restoreFileSplitSize(const RestoreFile *const file)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, file);
+    FUNCTION_TEST_END();
+
+    ASSERT(file != NULL);
+    ASSERT(file->splitSize != 0);
+
+    const uint64_t offset = restoreFileSplitOffset(file);
+    ASSERT(offset < file->size);
+
+    FUNCTION_TEST_RETURN(UINT64, file->size - offset < file->splitSize ? file->size - offset : file->splitSize);
+}
+
+static void
+restoreFileSplitTruncate(StorageWrite *const write, const RestoreFile *const file)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STORAGE_WRITE, write);
+        FUNCTION_TEST_PARAM_P(VOID, file);
+    FUNCTION_TEST_END();
+
+    ASSERT(write != NULL);
+    ASSERT(file != NULL);
+
+    THROW_ON_SYS_ERROR_FMT(
+        ftruncate(ioWriteFd(storageWriteIo(write)), (off_t)file->size) == -1, FileWriteError, "unable to truncate '%s'",
+        strZ(storageWriteName(write)));
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
 /**********************************************************************************************************************************/
 List *restoreFile(
     const String *const repoFile, const unsigned int repoIdx, const CompressType repoFileCompressType, const time_t copyTimeBegin,
-    const bool delta, const bool deltaForce, const String *const cipherPass, const List *const fileList)
+    const bool delta, const bool deltaForce, const bool sparse, const String *const cipherPass, const Buffer *const compressDict,
+    const StringList *const fanoutPathList, const List *const fileList)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(STRING, repoFile);
@@ -31,14 +144,20 @@ List *restoreFile(
         FUNCTION_LOG_PARAM(TIME, copyTimeBegin);
         FUNCTION_LOG_PARAM(BOOL, delta);
         FUNCTION_LOG_PARAM(BOOL, deltaForce);
+        FUNCTION_LOG_PARAM(BOOL, sparse);
         FUNCTION_TEST_PARAM(STRING, cipherPass);
+        FUNCTION_LOG_PARAM(BUFFER, compressDict);
+        FUNCTION_LOG_PARAM(STRING_LIST, fanoutPathList);
         FUNCTION_LOG_PARAM(LIST, fileList);                         // List of files to restore
     FUNCTION_LOG_END();
 
     ASSERT(repoFile != NULL);
+    ASSERT(compressDict == NULL || repoFileCompressType != compressTypeNone);
+    ASSERT(fanoutPathList == NULL || !delta);
 
     // Restore file results
     List *result = NULL;
+    const unsigned int fanoutTotal = fanoutPathList == NULL ? 0 : strLstSize(fanoutPathList);
 
     MEM_CONTEXT_TEMP_BEGIN()
     {
@@ -50,9 +169,12 @@ List *restoreFile(
             const RestoreFile *const file = lstGet(fileList, fileIdx);
             ASSERT(file->name != NULL);
             ASSERT(file->limit == NULL || varType(file->limit) == varTypeUInt64);
+            ASSERT(file->splitSize == 0 || (!file->zero && file->limit == NULL));
 
             RestoreFileResult *const fileResult = lstAdd(
-                result, &(RestoreFileResult){.manifestFile = file->manifestFile, .result = restoreResultCopy});
+                result,
+                &(RestoreFileResult){
+                    .manifestFile = file->manifestFile, .result = restoreResultCopy, .splitPart = file->splitPart});
 
             // Perform delta if requested. Delta zero-length files to avoid overwriting the file if the timestamp is correct.
             if (delta && !file->zero)
@@ -62,8 +184,9 @@ List *restoreFile(
 
                 if (info.exists)
                 {
-                    // If force then use size/timestamp delta
-                    if (deltaForce)
+                    // If force then use size/timestamp delta. A part of a split file is always compared by checksum because another
+                    // part may already have been restored, which would make the size/timestamp match.
+                    if (deltaForce && file->splitSize == 0)
                     {
                         // Make sure that timestamp/size are equal and that timestamp is before the copy start time of the backup
                         if (info.size == file->size && info.timeModified == file->timeModified && info.timeModified < copyTimeBegin)
@@ -106,12 +229,15 @@ List *restoreFile(
                                 info = storageInfoP(storagePg(), file->name, .followLink = true);
                             }
 
-                            // Generate checksum for the file if size is not zero
+                            // Generate checksum for the file (or the part of a split file) if size is not zero
                             IoRead *read = NULL;
 
                             if (file->size != 0)
                             {
-                                read = storageReadIo(storageNewReadP(storagePgWrite(), file->name));
+                                read = storageReadIo(
+                                    storageNewReadP(
+                                        storagePgWrite(), file->name, .offset = restoreFileSplitOffset(file),
+                                        .limit = file->splitSize != 0 ? VARUINT64(restoreFileSplitSize(file)) : NULL));
                                 ioFilterGroupAdd(ioReadFilterGroup(read), cryptoHashNew(hashTypeSha1));
                                 ioReadDrain(read);
                             }
@@ -140,26 +266,17 @@ List *restoreFile(
                 }
             }
 
-            // Create zeroed and zero-length files
+            // Create zeroed and zero-length files in the data directory and fan-out paths
             if (fileResult->result == restoreResultCopy && (file->size == 0 || file->zero))
             {
-                // Create destination file
-                StorageWrite *pgFileWrite = storageNewWriteP(
-                    storagePgWrite(), file->name, .modeFile = file->mode, .user = file->user, .group = file->group,
-                    .timeModified = file->timeModified, .noAtomic = true, .noCreatePath = true, .noSyncPath = true);
-
-                ioWriteOpen(storageWriteIo(pgFileWrite));
+                restoreFileZero(storagePgWrite(), file->name, file);
 
-                // Truncate the file to specified length (note in this case the file will grow, not shrink)
-                if (file->zero)
+                for (unsigned int fanoutIdx = 0; fanoutIdx < fanoutTotal; fanoutIdx++)
                 {
-                    THROW_ON_SYS_ERROR_FMT(
-                        ftruncate(ioWriteFd(storageWriteIo(pgFileWrite)), (off_t)file->size) == -1, FileWriteError,
-                        "unable to truncate '%s'", strZ(file->name));
+                    restoreFileZero(
+                        storageLocalWrite(), restoreFileFanoutPath(strLstGet(fanoutPathList, fanoutIdx), file->name), file);
                 }
 
-                ioWriteClose(storageWriteIo(pgFileWrite));
-
                 // Report the file as zeroed or zero-length
                 fileResult->result = restoreResultZero;
             }
@@ -177,6 +294,8 @@ List *restoreFile(
             // Copy file from repository to database
             if (fileResult->result == restoreResultCopy)
             {
+                const uint64_t timeBegin = traceBegin();
+
                 // If no repo file is currently open
                 if (repoFileLimit == 0)
                 {
@@ -213,13 +332,20 @@ List *restoreFile(
                         storageRepoIdx(repoIdx), repoFile,
                         .compressible = repoFileCompressType == compressTypeNone && cipherPass == NULL, .offset = file->offset,
                         .limit = repoFileLimit != 0 ? VARUINT64(repoFileLimit) : NULL);
+                    ioRateAdd(ioReadFilterGroup(storageReadIo(repoFileRead)), ioRateTypeRead);
                     ioReadOpen(storageReadIo(repoFileRead));
                 }
 
-                // Create pg file
+                // Create pg file. When sparse is enabled blocks that are all zero are written as holes to save space and I/O. A
+                // part of a split file is written into the file at the offset of the part without truncating the parts written by
+                // other processes. Holes cannot be used for a part on delta since the file may contain data where the hole would
+                // be.
+                const bool split = file->splitSize != 0;
+
                 StorageWrite *pgFileWrite = storageNewWriteP(
                     storagePgWrite(), file->name, .modeFile = file->mode, .user = file->user, .group = file->group,
-                    .timeModified = file->timeModified, .noAtomic = true, .noCreatePath = true, .noSyncPath = true);
+                    .timeModified = file->timeModified, .noAtomic = true, .noCreatePath = true, .noSyncPath = true,
+                    .sparse = sparse && (!split || !delta), .noTruncate = split, .offset = restoreFileSplitOffset(file));
 
                 IoFilterGroup *filterGroup = ioWriteFilterGroup(storageWriteIo(pgFileWrite));
 
@@ -228,8 +354,17 @@ List *restoreFile(
                     ioFilterGroupAdd(filterGroup, cipherBlockNew(cipherModeDecrypt, cipherTypeAes256Cbc, BUFSTR(cipherPass), NULL));
 
                 // Add decompression filter
+                StringId decompressFilterType = 0;
+
                 if (repoFileCompressType != compressTypeNone)
-                    ioFilterGroupAdd(filterGroup, decompressFilter(repoFileCompressType));
+                {
+                    IoFilter *const decompress =
+                        compressDict != NULL ?
+                            decompressFilterDict(repoFileCompressType, compressDict) : decompressFilter(repoFileCompressType);
+
+                    decompressFilterType = ioFilterType(decompress);
+                    ioFilterGroupAdd(filterGroup, decompress);
+                }
 
                 // Add sha1 filter
                 ioFilterGroupAdd(filterGroup, cryptoHashNew(hashTypeSha1));
@@ -237,11 +372,48 @@ List *restoreFile(
                 // Add size filter
                 ioFilterGroupAdd(filterGroup, ioSizeNew());
 
+                // Limit the rate of writes to pg
+                ioRateAdd(filterGroup, ioRateTypeWrite);
+
+                // Write the decompressed file to the fan-out paths as it is written to pg so the repo file is only read once
+                List *const fanoutWriteList = lstNewP(sizeof(StorageWrite *));
+
+                for (unsigned int fanoutIdx = 0; fanoutIdx < fanoutTotal; fanoutIdx++)
+                {
+                    StorageWrite *const fanoutWrite = storageNewWriteP(
+                        storageLocalWrite(), restoreFileFanoutPath(strLstGet(fanoutPathList, fanoutIdx), file->name),
+                        .modeFile = file->mode, .user = file->user, .group = file->group, .timeModified = file->timeModified,
+                        .noAtomic = true, .noCreatePath = true, .noSyncPath = true, .sparse = true, .noTruncate = split,
+                        .offset = restoreFileSplitOffset(file));
+
+                    ioWriteOpen(storageWriteIo(fanoutWrite));
+
+                    if (split)
+                        restoreFileSplitTruncate(fanoutWrite, file);
+
+                    ioFilterGroupAdd(filterGroup, ioTeeNew(storageWriteIo(fanoutWrite), false));
+                    lstAdd(fanoutWriteList, &fanoutWrite);
+                }
+
                 // Copy file
                 ioWriteOpen(storageWriteIo(pgFileWrite));
+
+                if (split)
+                    restoreFileSplitTruncate(pgFileWrite, file);
+
                 ioCopyP(storageReadIo(repoFileRead), storageWriteIo(pgFileWrite), .limit = file->limit);
                 ioWriteClose(storageWriteIo(pgFileWrite));
 
+                for (unsigned int fanoutIdx = 0; fanoutIdx < lstSize(fanoutWriteList); fanoutIdx++)
+                {
+                    StorageWrite *const fanoutWrite = *(StorageWrite **)lstGet(fanoutWriteList, fanoutIdx);
+
+                    ioWriteClose(storageWriteIo(fanoutWrite));
+                    storageWriteFree(fanoutWrite);
+                }
+
+                lstFree(fanoutWriteList);
+
                 // If more than one file is being copied from a single read then decrement the limit
                 if (repoFileLimit != 0)
                     repoFileLimit -= varUInt64(file->limit);
@@ -259,6 +431,26 @@ List *restoreFile(
                         strZ(pckReadStrP(ioFilterGroupResultP(filterGroup, CRYPTO_HASH_FILTER_TYPE))), strZ(file->checksum));
                 }
 
+                // Record a span for the file including the time spent hashing and decompressing
+                if (traceEnabled())
+                {
+                    KeyValue *const traceArg = kvNew();
+
+                    kvPut(traceArg, VARSTRDEF("file"), VARSTR(file->name));
+                    kvPut(
+                        traceArg, VARSTRDEF("hashTime"), VARUINT64(ioFilterGroupResultTimeP(filterGroup, CRYPTO_HASH_FILTER_TYPE)));
+                    kvPut(traceArg, VARSTRDEF("size"), VARUINT64(pckReadU64P(ioFilterGroupResultP(filterGroup, SIZE_FILTER_TYPE))));
+
+                    if (decompressFilterType != 0)
+                    {
+                        kvPut(
+                            traceArg, VARSTRDEF("decompressTime"),
+                            VARUINT64(ioFilterGroupResultTimeP(filterGroup, decompressFilterType)));
+                    }
+
+                    traceEndP("restoreFile", timeBegin, .arg = traceArg);
+                }
+
                 // Free the pg file
                 storageWriteFree(pgFileWrite);
             }
@@ -270,3 +462,206 @@ List *restoreFile(
 
     FUNCTION_LOG_RETURN(LIST, result);
 }
+
+/**********************************************************************************************************************************/
+void
+restoreCleanOwner(
+    const String *const pgPath, const String *const user, const String *const group, const uid_t actualUserId,
+    const gid_t actualGroupId, const bool new)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, pgPath);
+        FUNCTION_TEST_PARAM(STRING, user);
+        FUNCTION_TEST_PARAM(STRING, group);
+        FUNCTION_TEST_PARAM(UINT, actualUserId);
+        FUNCTION_TEST_PARAM(UINT, actualGroupId);
+        FUNCTION_TEST_PARAM(BOOL, new);
+    FUNCTION_TEST_END();
+
+    ASSERT(pgPath != NULL);
+
+    // Get the expected user id
+    uid_t expectedUserId = userId();
+
+    if (user != NULL)
+    {
+        uid_t manifestUserId = userIdFromName(user);
+
+        if (manifestUserId != (uid_t)-1)
+            expectedUserId = manifestUserId;
+    }
+
+    // Get the expected group id
+    gid_t expectedGroupId = groupId();
+
+    if (group != NULL)
+    {
+        uid_t manifestGroupId = groupIdFromName(group);
+
+        if (manifestGroupId != (uid_t)-1)
+            expectedGroupId = manifestGroupId;
+    }
+
+    // Update ownership if not as expected
+    if (actualUserId != expectedUserId || actualGroupId != expectedGroupId)
+    {
+        // If this is a newly created file/link/path then there's no need to log updated permissions
+        if (!new)
+            LOG_DETAIL_FMT("update ownership for '%s'", strZ(pgPath));
+
+        THROW_ON_SYS_ERROR_FMT(
+            lchown(strZ(pgPath), expectedUserId, expectedGroupId) == -1, FileOwnerError, "unable to set ownership for '%s'",
+            strZ(pgPath));
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+void
+restoreCleanMode(const String *const pgPath, const mode_t manifestMode, const StorageInfo *const info)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, pgPath);
+        FUNCTION_TEST_PARAM(MODE, manifestMode);
+        FUNCTION_TEST_PARAM(INFO, info);
+    FUNCTION_TEST_END();
+
+    ASSERT(pgPath != NULL);
+    ASSERT(info != NULL);
+
+    // Update mode if not as expected
+    if (manifestMode != info->mode)
+    {
+        LOG_DETAIL_FMT("update mode for '%s' to %04o", strZ(pgPath), manifestMode);
+
+        THROW_ON_SYS_ERROR_FMT(
+            chmod(strZ(pgPath), manifestMode) == -1, FileModeError, "unable to set mode for '%s'", strZ(pgPath));
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+bool
+restoreCleanEntry(const String *const pgPath, const StorageInfo *const info, const RestoreCleanEntry *const entry)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, pgPath);
+        FUNCTION_TEST_PARAM(INFO, info);
+        FUNCTION_TEST_PARAM_P(VOID, entry);
+    FUNCTION_TEST_END();
+
+    ASSERT(pgPath != NULL);
+    ASSERT(info != NULL);
+
+    bool result = false;
+
+    switch (info->type)
+    {
+        case storageTypeFile:
+        {
+            if (entry != NULL && entry->type == storageTypeFile)
+            {
+                restoreCleanOwner(pgPath, entry->user, entry->group, info->userId, info->groupId, false);
+                restoreCleanMode(pgPath, entry->mode, info);
+            }
+            else
+            {
+                LOG_DETAIL_FMT("remove invalid file '%s'", strZ(pgPath));
+                storageRemoveP(storageLocalWrite(), pgPath, .errorOnMissing = true);
+            }
+
+            break;
+        }
+
+        case storageTypeLink:
+        {
+            if (entry != NULL && entry->type == storageTypeLink)
+            {
+                if (!strEq(entry->destination, info->linkDestination))
+                {
+                    LOG_DETAIL_FMT("remove link '%s' because destination changed", strZ(pgPath));
+                    storageRemoveP(storageLocalWrite(), pgPath, .errorOnMissing = true);
+                }
+                else
+                    restoreCleanOwner(pgPath, entry->user, entry->group, info->userId, info->groupId, false);
+            }
+            else
+            {
+                LOG_DETAIL_FMT("remove invalid link '%s'", strZ(pgPath));
+                storageRemoveP(storageLocalWrite(), pgPath, .errorOnMissing = true);
+            }
+
+            break;
+        }
+
+        case storageTypePath:
+        {
+            if (entry != NULL && entry->type == storageTypePath)
+            {
+                restoreCleanOwner(pgPath, entry->user, entry->group, info->userId, info->groupId, false);
+                restoreCleanMode(pgPath, entry->mode, info);
+
+                result = true;
+            }
+            else
+            {
+                LOG_DETAIL_FMT("remove invalid path '%s'", strZ(pgPath));
+                storagePathRemoveP(storageLocalWrite(), pgPath, .errorOnMissing = true, .recurse = true);
+            }
+
+            break;
+        }
+
+        // Special file types cannot exist in the manifest so just delete them
+        case storageTypeSpecial:
+            LOG_DETAIL_FMT("remove special file '%s'", strZ(pgPath));
+            storageRemoveP(storageLocalWrite(), pgPath, .errorOnMissing = true);
+            break;
+    }
+
+    FUNCTION_TEST_RETURN(BOOL, result);
+}
+
+/**********************************************************************************************************************************/
+void
+restoreClean(const String *const pgPath, const StringList *const fileIgnore, const List *const entryList)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STRING, pgPath);
+        FUNCTION_LOG_PARAM(STRING_LIST, fileIgnore);
+        FUNCTION_LOG_PARAM(LIST, entryList);
+    FUNCTION_LOG_END();
+
+    ASSERT(pgPath != NULL);
+    ASSERT(entryList != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        StorageIterator *const storageItr = storageNewItrP(
+            storageLocalWrite(), pgPath, .errorOnMissing = true, .sortOrder = sortOrderAsc);
+
+        MEM_CONTEXT_TEMP_RESET_BEGIN()
+        {
+            while (storageItrMore(storageItr))
+            {
+                const StorageInfo info = storageItrNext(storageItr);
+
+                // Don't include backup.manifest or recovery.conf (when preserved) in the comparison
+                if (fileIgnore != NULL && info.type == storageTypeFile && strLstExists(fileIgnore, info.name))
+                    continue;
+
+                // The contents of valid paths are cleaned by another job
+                restoreCleanEntry(strNewFmt("%s/%s", strZ(pgPath), strZ(info.name)), &info, lstFind(entryList, &info.name));
+
+                // Reset the memory context occasionally so we don't use too much memory or slow down processing
+                MEM_CONTEXT_TEMP_RESET(1000);
+            }
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
@@ -5,7 +5,9 @@ Restore File
 #define COMMAND_RESTORE_FILE_H
 
 #include "common/compress/helper.h"
+#include "common/type/stringList.h"
 #include "common/type/variant.h"
+#include "storage/info.h"
 
 /***********************************************************************************************************************************
 Restore file types
@@ -34,16 +36,51 @@ typedef struct RestoreFile
     uint64_t offset;                                                // Offset into repo file where pg file is located
     const Variant *limit;                                           // Limit for read in the repo file
     const String *manifestFile;                                     // Manifest file
+    uint64_t splitSize;                                             // Size of the parts the file is stored in (0 if not split)
+    unsigned int splitPart;                                         // Part to restore when split (checksum is of the part)
 } RestoreFile;
 
 typedef struct RestoreFileResult
 {
     const String *manifestFile;                                     // Manifest file
     RestoreResult result;                                           // Restore result (e.g. preserve, copy)
+    unsigned int splitPart;                                         // Part restored when split
 } RestoreFileResult;
 
+// When compressDict is not NULL the files were compressed with the dictionary. When fanoutPathList is not NULL the files are also
+// written to each fan-out path, relative to the pg path, while the repo file is read once (delta is not supported). A part of a
+// split file is written into the pg file at the offset of the part so the parts can be restored concurrently.
 List *restoreFile(
     const String *repoFile, unsigned int repoIdx, CompressType repoFileCompressType, time_t copyTimeBegin, bool delta,
-    bool deltaForce, const String *cipherPass, const List *fileList);
+    bool deltaForce, bool sparse, const String *cipherPass, const Buffer *compressDict, const StringList *fanoutPathList,
+    const List *fileList);
+
+// Entry expected in a path cleaned by restoreClean()
+typedef struct RestoreCleanEntry
+{
+    const String *name;                                             // Name of the file/link/path in the path
+    StorageType type;                                               // Expected type
+    mode_t mode;                                                    // Expected mode (not used for links)
+    const String *user;                                             // Expected user (current user when NULL or missing)
+    const String *group;                                            // Expected group (current group when NULL or missing)
+    const String *destination;                                      // Expected link destination
+} RestoreCleanEntry;
+
+// Update ownership of a file/link/path when it does not match the expected user/group. When the user/group is NULL or does not
+// exist on this host the current user/group is expected.
+void restoreCleanOwner(
+    const String *pgPath, const String *user, const String *group, uid_t actualUserId, gid_t actualGroupId, bool new);
+
+// Update mode of a file/path when it does not match the expected mode
+void restoreCleanMode(const String *pgPath, mode_t manifestMode, const StorageInfo *info);
+
+// Clean a file/link/path found in a path being cleaned. It is removed when the entry is NULL or of another type (or is a link with
+// another destination), else ownership/mode are updated to match the entry. Returns true when it is a valid path so the caller can
+// clean the contents of the path.
+bool restoreCleanEntry(const String *pgPath, const StorageInfo *info, const RestoreCleanEntry *entry);
+
+// Remove the files/links/paths in a path that are not in the entry list (sorted by name) and update ownership/mode of those that
+// are. Files in fileIgnore are skipped. Subpaths in the entry list are not cleaned since they are cleaned by separate jobs.
+void restoreClean(const String *pgPath, const StringList *fileIgnore, const List *entryList);
 
 #endif
@@ -33,7 +33,10 @@ restoreFileProtocol(PackRead *const param, ProtocolServer *const server)
         const time_t copyTimeBegin = pckReadTimeP(param);
         const bool delta = pckReadBoolP(param);
         const bool deltaForce = pckReadBoolP(param);
+        const bool sparse = pckReadBoolP(param);
         const String *const cipherPass = pckReadStrP(param);
+        const Buffer *const compressDict = compressDictPackRead(param);
+        const StringList *const fanoutPathList = pckReadStrLstP(param);
 
         // Build the file list
         List *fileList = lstNewP(sizeof(RestoreFile));
@@ -56,13 +59,16 @@ restoreFileProtocol(PackRead *const param, ProtocolServer *const server)
             }
 
             file.manifestFile = pckReadStrP(param);
+            file.splitSize = pckReadU64P(param);
+            file.splitPart = pckReadU32P(param);
 
             lstAdd(fileList, &file);
         }
 
         // Restore files
         const List *const result = restoreFile(
-            repoFile, repoIdx, repoFileCompressType, copyTimeBegin, delta, deltaForce, cipherPass, fileList);
+            repoFile, repoIdx, repoFileCompressType, copyTimeBegin, delta, deltaForce, sparse, cipherPass, compressDict,
+            fanoutPathList, fileList);
 
         // Return result
         PackWrite *const resultPack = protocolPackNew();
@@ -73,6 +79,7 @@ restoreFileProtocol(PackRead *const param, ProtocolServer *const server)
 
             pckWriteStrP(resultPack, fileResult->manifestFile);
             pckWriteU32P(resultPack, fileResult->result);
+            pckWriteU32P(resultPack, fileResult->splitPart);
         }
 
         protocolServerDataPut(server, resultPack);
@@ -82,3 +89,49 @@ restoreFileProtocol(PackRead *const param, ProtocolServer *const server)
 
     FUNCTION_LOG_RETURN_VOID();
 }
+
+/**********************************************************************************************************************************/
+void
+restoreCleanProtocol(PackRead *const param, ProtocolServer *const server)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(PACK_READ, param);
+        FUNCTION_LOG_PARAM(PROTOCOL_SERVER, server);
+    FUNCTION_LOG_END();
+
+    ASSERT(param != NULL);
+    ASSERT(server != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Clean path
+        const String *const pgPath = pckReadStrP(param);
+        const StringList *const fileIgnore = pckReadStrLstP(param);
+
+        // Build the entry list
+        List *const entryList = lstNewP(sizeof(RestoreCleanEntry), .comparator = lstComparatorStr);
+
+        while (!pckReadNullP(param))
+        {
+            RestoreCleanEntry entry = {.name = pckReadStrP(param)};
+            entry.type = (StorageType)pckReadU32P(param);
+            entry.mode = pckReadModeP(param);
+            entry.user = pckReadStrP(param);
+            entry.group = pckReadStrP(param);
+            entry.destination = pckReadStrP(param);
+
+            lstAdd(entryList, &entry);
+        }
+
+        lstSort(entryList, sortOrderAsc);
+
+        restoreClean(pgPath, fileIgnore, entryList);
+
+        // Return result
+        protocolServerDataPut(server, NULL);
+        protocolServerDataEndPut(server);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
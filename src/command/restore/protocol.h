@@ -12,13 +12,16 @@ Functions
 ***********************************************************************************************************************************/
 // Process protocol requests
 void restoreFileProtocol(PackRead *param, ProtocolServer *server);
+void restoreCleanProtocol(PackRead *param, ProtocolServer *server);
 
 /***********************************************************************************************************************************
 Protocol commands for ProtocolServerHandler arrays passed to protocolServerProcess()
 ***********************************************************************************************************************************/
 #define PROTOCOL_COMMAND_RESTORE_FILE                               STRID5("rs-f", 0x36e720)
+#define PROTOCOL_COMMAND_RESTORE_CLEAN                              STRID5("rs-c", 0x1ee720)
 
 #define PROTOCOL_SERVER_HANDLER_RESTORE_LIST                                                                                       \
-    {.command = PROTOCOL_COMMAND_RESTORE_FILE, .handler = restoreFileProtocol},
+    {.command = PROTOCOL_COMMAND_RESTORE_FILE, .handler = restoreFileProtocol},                                                    \
+    {.command = PROTOCOL_COMMAND_RESTORE_CLEAN, .handler = restoreCleanProtocol},
 
 #endif
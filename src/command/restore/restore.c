@@ -3,6 +3,7 @@ Restore Command
 ***********************************************************************************************************************************/
 #include "build.auto.h"
 
+#include <limits.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <time.h>
@@ -15,6 +16,7 @@ Restore Command
 #include "common/debug.h"
 #include "common/log.h"
 #include "common/regExp.h"
+#include "common/trace.h"
 #include "common/user.h"
 #include "config/config.h"
 #include "config/exec.h"
@@ -813,9 +815,9 @@ typedef struct RestoreCleanCallbackData
 // Helper to update ownership on a file/link/path
 static void
 restoreCleanOwnership(
-    const String *const pgPath, const String *manifestUserName, const String *const rootReplaceUser,
-    const String *manifestGroupName, const String *const rootReplaceGroup, const uid_t actualUserId, const gid_t actualGroupId,
-    const bool new)
+    const String *const pgPath, const String *const manifestUserName, const String *const rootReplaceUser,
+    const String *const manifestGroupName, const String *const rootReplaceGroup, const uid_t actualUserId,
+    const gid_t actualGroupId, const bool new)
 {
     FUNCTION_TEST_BEGIN();
         FUNCTION_TEST_PARAM(STRING, pgPath);
@@ -828,68 +830,9 @@ restoreCleanOwnership(
 
     ASSERT(pgPath != NULL);
 
-    // Get the expected user id
-    uid_t expectedUserId = userId();
-
-    manifestUserName = restoreManifestOwnerReplace(manifestUserName, rootReplaceUser);
-
-    if (manifestUserName != NULL)
-    {
-        uid_t manifestUserId = userIdFromName(manifestUserName);
-
-        if (manifestUserId != (uid_t)-1)
-            expectedUserId = manifestUserId;
-    }
-
-    // Get the expected group id
-    gid_t expectedGroupId = groupId();
-
-    manifestGroupName = restoreManifestOwnerReplace(manifestGroupName, rootReplaceGroup);
-
-    if (manifestGroupName != NULL)
-    {
-        uid_t manifestGroupId = groupIdFromName(manifestGroupName);
-
-        if (manifestGroupId != (uid_t)-1)
-            expectedGroupId = manifestGroupId;
-    }
-
-    // Update ownership if not as expected
-    if (actualUserId != expectedUserId || actualGroupId != expectedGroupId)
-    {
-        // If this is a newly created file/link/path then there's no need to log updated permissions
-        if (!new)
-            LOG_DETAIL_FMT("update ownership for '%s'", strZ(pgPath));
-
-        THROW_ON_SYS_ERROR_FMT(
-            lchown(strZ(pgPath), expectedUserId, expectedGroupId) == -1, FileOwnerError, "unable to set ownership for '%s'",
-            strZ(pgPath));
-    }
-
-    FUNCTION_TEST_RETURN_VOID();
-}
-
-// Helper to update mode on a file/path
-static void
-restoreCleanMode(const String *pgPath, mode_t manifestMode, const StorageInfo *info)
-{
-    FUNCTION_TEST_BEGIN();
-        FUNCTION_TEST_PARAM(STRING, pgPath);
-        FUNCTION_TEST_PARAM(MODE, manifestMode);
-        FUNCTION_TEST_PARAM(INFO, info);
-    FUNCTION_TEST_END();
-
-    ASSERT(pgPath != NULL);
-    ASSERT(info != NULL);
-
-    // Update mode if not as expected
-    if (manifestMode != info->mode)
-    {
-        LOG_DETAIL_FMT("update mode for '%s' to %04o", strZ(pgPath), manifestMode);
-
-        THROW_ON_SYS_ERROR_FMT(
-            chmod(strZ(pgPath), manifestMode) == -1, FileModeError, "unable to set mode for '%s'", strZ(pgPath));
-    }
+    restoreCleanOwner(
+        pgPath, restoreManifestOwnerReplace(manifestUserName, rootReplaceUser),
+        restoreManifestOwnerReplace(manifestGroupName, rootReplaceGroup), actualUserId, actualGroupId, new);
 
     FUNCTION_TEST_RETURN_VOID();
 }
@@ -932,93 +875,445 @@ restoreCleanBuildRecurse(StorageIterator *const storageItr, const RestoreCleanCa
             // Construct the path of this file/link/path in the PostgreSQL data directory
             const String *pgPath = strNewFmt("%s/%s", strZ(cleanData->targetPath), strZ(info.name));
 
-            switch (info.type)
+            // Find the entry expected in the manifest. Links take precedence over paths and files with the same name. Only the type
+            // found on disk needs to be checked since an entry of another type would not be valid anyway.
+            RestoreCleanEntry entry;
+            const RestoreCleanEntry *entryFound = NULL;
+            const ManifestLink *const manifestLink = manifestLinkFindDefault(cleanData->manifest, manifestName, NULL);
+
+            if (manifestLink != NULL)
             {
-                case storageTypeFile:
+                entry = (RestoreCleanEntry)
                 {
-                    if (manifestFileExists(cleanData->manifest, manifestName) &&
-                        manifestLinkFindDefault(cleanData->manifest, manifestName, NULL) == NULL)
-                    {
-                        const ManifestFile manifestFile = manifestFileFind(cleanData->manifest, manifestName);
+                    .type = storageTypeLink,
+                    .user = restoreManifestOwnerReplace(manifestLink->user, cleanData->rootReplaceUser),
+                    .group = restoreManifestOwnerReplace(manifestLink->group, cleanData->rootReplaceGroup),
+                    .destination = manifestLink->destination,
+                };
 
-                        restoreCleanOwnership(
-                            pgPath, manifestFile.user, cleanData->rootReplaceUser, manifestFile.group, cleanData->rootReplaceGroup,
-                            info.userId, info.groupId, false);
-                        restoreCleanMode(pgPath, manifestFile.mode, &info);
-                    }
-                    else
+                entryFound = &entry;
+            }
+            else if (info.type == storageTypeFile && manifestFileExists(cleanData->manifest, manifestName))
+            {
+                const ManifestFile manifestFile = manifestFileFind(cleanData->manifest, manifestName);
+
+                entry = (RestoreCleanEntry)
+                {
+                    .type = storageTypeFile,
+                    .mode = manifestFile.mode,
+                    .user = restoreManifestOwnerReplace(manifestFile.user, cleanData->rootReplaceUser),
+                    .group = restoreManifestOwnerReplace(manifestFile.group, cleanData->rootReplaceGroup),
+                };
+
+                entryFound = &entry;
+            }
+            else if (info.type == storageTypePath)
+            {
+                const ManifestPath *const manifestPath = manifestPathFindDefault(cleanData->manifest, manifestName, NULL);
+
+                if (manifestPath != NULL)
+                {
+                    entry = (RestoreCleanEntry)
                     {
-                        LOG_DETAIL_FMT("remove invalid file '%s'", strZ(pgPath));
-                        storageRemoveP(storageLocalWrite(), pgPath, .errorOnMissing = true);
-                    }
+                        .type = storageTypePath,
+                        .mode = manifestPath->mode,
+                        .user = restoreManifestOwnerReplace(manifestPath->user, cleanData->rootReplaceUser),
+                        .group = restoreManifestOwnerReplace(manifestPath->group, cleanData->rootReplaceGroup),
+                    };
 
-                    break;
+                    entryFound = &entry;
                 }
+            }
+
+            // Recurse into valid paths
+            if (restoreCleanEntry(pgPath, &info, entryFound))
+            {
+                RestoreCleanCallbackData cleanDataSub = *cleanData;
+                cleanDataSub.targetName = manifestName;
+                cleanDataSub.targetPath = pgPath;
+                cleanDataSub.basePath = false;
+
+                restoreCleanBuildRecurse(
+                    storageNewItrP(storageLocalWrite(), cleanDataSub.targetPath, .errorOnMissing = true, .sortOrder = sortOrderAsc),
+                    &cleanDataSub);
+            }
 
-                case storageTypeLink:
+            // Reset the memory context occasionally so we don't use too much memory or slow down processing
+            MEM_CONTEXT_TEMP_RESET(1000);
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+// Get the processing queue of a path/link in the manifest. Each tablespace has a queue and everything else is in the first queue.
+#define RESTORE_QUEUE_ALL                                           UINT_MAX
+
+static unsigned int
+restoreQueueIdx(const Manifest *const manifest, const String *name)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(MANIFEST, manifest);
+        FUNCTION_TEST_PARAM(STRING, name);
+    FUNCTION_TEST_END();
+
+    ASSERT(manifest != NULL);
+    ASSERT(name != NULL);
+
+    unsigned int result = 0;
+
+    // Tablespace links are named from the data directory
+    if (strBeginsWithZ(name, MANIFEST_TARGET_PGDATA "/" MANIFEST_TARGET_PGTBLSPC "/"))
+        name = strSub(name, sizeof(MANIFEST_TARGET_PGDATA));
+
+    // Queues are in the same order as the tablespace targets (see restoreProcessQueue())
+    unsigned int queueIdx = 0;
+
+    for (unsigned int targetIdx = 0; targetIdx < manifestTargetTotal(manifest); targetIdx++)
+    {
+        const ManifestTarget *const target = manifestTarget(manifest, targetIdx);
+
+        if (target->tablespaceId != 0)
+        {
+            queueIdx++;
+
+            if (strEq(name, target->name) || (strBeginsWith(name, target->name) && strZ(name)[strSize(target->name)] == '/'))
+            {
+                result = queueIdx;
+                break;
+            }
+        }
+    }
+
+    FUNCTION_TEST_RETURN(UINT, result);
+}
+
+// Create missing paths and links. When queueIdx is not RESTORE_QUEUE_ALL only the paths and links in the queue are created so files
+// in the queue can be restored while other queues are still being cleaned.
+static void
+restoreCleanBuildPath(
+    const Manifest *const manifest, const String *const rootReplaceUser, const String *const rootReplaceGroup,
+    const unsigned int queueIdx)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(MANIFEST, manifest);
+        FUNCTION_LOG_PARAM(STRING, rootReplaceUser);
+        FUNCTION_LOG_PARAM(STRING, rootReplaceGroup);
+        FUNCTION_LOG_PARAM(UINT, queueIdx);
+    FUNCTION_LOG_END();
+
+    ASSERT(manifest != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Create missing paths and path links
+        // -------------------------------------------------------------------------------------------------------------------------
+        for (unsigned int pathIdx = 0; pathIdx < manifestPathTotal(manifest); pathIdx++)
+        {
+            const ManifestPath *path = manifestPath(manifest, pathIdx);
+
+            // Skip the pg_tblspc path because it only maps to the manifest.  We should remove this in a future release but not much
+            // can be done about it for now.
+            if (strEq(path->name, MANIFEST_TARGET_PGTBLSPC_STR))
+                continue;
+
+            // Skip paths in other queues. The tablespace path in the data directory is needed by all queues for tablespace links.
+            if (queueIdx != RESTORE_QUEUE_ALL && restoreQueueIdx(manifest, path->name) != queueIdx &&
+                !strEqZ(path->name, MANIFEST_TARGET_PGDATA "/" MANIFEST_TARGET_PGTBLSPC))
+            {
+                continue;
+            }
+
+            // If this path has been mapped as a link then create a link.  The path has already been created as part of target
+            // creation (or it might have already existed).
+            const ManifestLink *link = manifestLinkFindDefault(
+                manifest,
+                strBeginsWith(path->name, MANIFEST_TARGET_PGTBLSPC_STR) ?
+                    strNewFmt(MANIFEST_TARGET_PGDATA "/%s", strZ(path->name)) : path->name,
+                NULL);
+
+            if (link != NULL)
+            {
+                const String *pgPath = storagePathP(storagePg(), manifestPathPg(link->name));
+                StorageInfo linkInfo = storageInfoP(storagePg(), pgPath, .ignoreMissing = true);
+
+                // Create the link if it is missing.  If it exists it should already have the correct ownership and destination.
+                if (!linkInfo.exists)
                 {
-                    const ManifestLink *manifestLink = manifestLinkFindDefault(cleanData->manifest, manifestName, NULL);
+                    LOG_DETAIL_FMT("create symlink '%s' to '%s'", strZ(pgPath), strZ(link->destination));
 
-                    if (manifestLink != NULL)
-                    {
-                        if (!strEq(manifestLink->destination, info.linkDestination))
-                        {
-                            LOG_DETAIL_FMT("remove link '%s' because destination changed", strZ(pgPath));
-                            storageRemoveP(storageLocalWrite(), pgPath, .errorOnMissing = true);
-                        }
-                        else
-                        {
-                            restoreCleanOwnership(
-                                pgPath, manifestLink->user, cleanData->rootReplaceUser, manifestLink->group,
-                                cleanData->rootReplaceGroup, info.userId, info.groupId, false);
-                        }
-                    }
-                    else
-                    {
-                        LOG_DETAIL_FMT("remove invalid link '%s'", strZ(pgPath));
-                        storageRemoveP(storageLocalWrite(), pgPath, .errorOnMissing = true);
-                    }
+                    THROW_ON_SYS_ERROR_FMT(
+                        symlink(strZ(link->destination), strZ(pgPath)) == -1, FileOpenError,
+                        "unable to create symlink '%s' to '%s'", strZ(pgPath), strZ(link->destination));
+                    restoreCleanOwnership(
+                        pgPath, link->user, rootReplaceUser, link->group, rootReplaceGroup, userId(), groupId(), true);
+                }
+            }
+            // Create the path normally
+            else
+            {
+                const String *pgPath = storagePathP(storagePg(), manifestPathPg(path->name));
+                StorageInfo pathInfo = storageInfoP(storagePg(), pgPath, .ignoreMissing = true);
 
-                    break;
+                // Create the path if it is missing. If it exists it should already have the correct ownership and mode.
+                if (!pathInfo.exists)
+                {
+                    LOG_DETAIL_FMT("create path '%s'", strZ(pgPath));
+
+                    storagePathCreateP(storagePgWrite(), pgPath, .mode = path->mode, .noParentCreate = true, .errorOnExists = true);
+                    restoreCleanOwnership(
+                        storagePathP(storagePg(), pgPath), path->user, rootReplaceUser, path->group, rootReplaceGroup, userId(),
+                        groupId(), true);
                 }
+            }
+        }
+
+        // Create file links.  These don't get created during path creation because they do not have a matching path entry.
+        // -------------------------------------------------------------------------------------------------------------------------
+        for (unsigned int linkIdx = 0; linkIdx < manifestLinkTotal(manifest); linkIdx++)
+        {
+            const ManifestLink *link = manifestLink(manifest, linkIdx);
+
+            // Skip links in other queues
+            if (queueIdx != RESTORE_QUEUE_ALL && restoreQueueIdx(manifest, link->name) != queueIdx)
+                continue;
+
+            const String *pgPath = storagePathP(storagePg(), manifestPathPg(link->name));
+            StorageInfo linkInfo = storageInfoP(storagePg(), pgPath, .ignoreMissing = true);
+
+            // Create the link if it is missing.  If it exists it should already have the correct ownership and destination.
+            if (!linkInfo.exists)
+            {
+                LOG_DETAIL_FMT("create symlink '%s' to '%s'", strZ(pgPath), strZ(link->destination));
+
+                THROW_ON_SYS_ERROR_FMT(
+                    symlink(strZ(link->destination), strZ(pgPath)) == -1, FileOpenError,
+                    "unable to create symlink '%s' to '%s'", strZ(pgPath), strZ(link->destination));
+                restoreCleanOwnership(
+                    pgPath, link->user, rootReplaceUser, link->group, rootReplaceGroup, userId(), groupId(), true);
+            }
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+// Job to clean a path in a target. Each path is cleaned by a separate job so paths can be cleaned in parallel.
+typedef struct RestoreCleanJob
+{
+    const String *name;                                             // Manifest name of the path
+    const String *pgPath;                                           // Path to clean
+    const StringList *fileIgnore;                                   // Files to ignore during clean
+    unsigned int queueIdx;                                          // Queue waiting for the clean (or RESTORE_QUEUE_ALL)
+    List *entryList;                                                // Files/links/paths expected in the path
+} RestoreCleanJob;
+
+// Helper to add an entry to the job cleaning the parent path of the entry
+static void
+restoreCleanJobEntryAdd(List *const jobList, const String *const name, RestoreCleanEntry entry)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(LIST, jobList);
+        FUNCTION_TEST_PARAM(STRING, name);
+    FUNCTION_TEST_END();
 
-                case storageTypePath:
+    ASSERT(jobList != NULL);
+    ASSERT(name != NULL);
+
+    const String *const path = strPath(name);
+    RestoreCleanJob *const job = lstFind(jobList, &path);
+
+    // Only entries in paths being cleaned are needed
+    if (job != NULL)
+    {
+        MEM_CONTEXT_BEGIN(lstMemContext(jobList))
+        {
+            entry.name = strBase(name);
+            lstAdd(job->entryList, &entry);
+        }
+        MEM_CONTEXT_END();
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+// Comparator to order clean jobs so paths with the most entries are cleaned first
+static int
+restoreCleanJobComparator(const void *const item1, const void *const item2)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, item1);
+        FUNCTION_TEST_PARAM_P(VOID, item2);
+    FUNCTION_TEST_END();
+
+    ASSERT(item1 != NULL);
+    ASSERT(item2 != NULL);
+
+    const RestoreCleanJob *const job1 = item1;
+    const RestoreCleanJob *const job2 = item2;
+
+    if (lstSize(job1->entryList) != lstSize(job2->entryList))
+        FUNCTION_TEST_RETURN(INT, lstSize(job1->entryList) < lstSize(job2->entryList) ? 1 : -1);
+
+    FUNCTION_TEST_RETURN(INT, strCmp(job1->name, job2->name));
+}
+
+// Build jobs to clean the paths in existing targets. Links are not followed so a path is only cleaned when it and all the paths
+// between it and the target are paths. Other paths will be removed by the job cleaning their parent path.
+static List *
+restoreCleanJobBuild(
+    const Manifest *const manifest, const RestoreCleanCallbackData *const cleanDataList, const String *const rootReplaceUser,
+    const String *const rootReplaceGroup)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(MANIFEST, manifest);
+        FUNCTION_LOG_PARAM_P(VOID, cleanDataList);
+        FUNCTION_LOG_PARAM(STRING, rootReplaceUser);
+        FUNCTION_LOG_PARAM(STRING, rootReplaceGroup);
+    FUNCTION_LOG_END();
+
+    ASSERT(manifest != NULL);
+    ASSERT(cleanDataList != NULL);
+
+    List *const result = lstNewP(sizeof(RestoreCleanJob), .comparator = lstComparatorStr);
+
+    MEM_CONTEXT_TEMP_RESET_BEGIN()
+    {
+        // Add a job for each path that is a path in a target that exists
+        for (unsigned int pathIdx = 0; pathIdx < manifestPathTotal(manifest); pathIdx++)
+        {
+            const ManifestPath *const path = manifestPath(manifest, pathIdx);
+            const RestoreCleanCallbackData *target = NULL;
+
+            // Find the target that contains the path. Targets can contain other targets (e.g. pg_wal in the data directory) so use
+            // the target with the longest name.
+            for (unsigned int targetIdx = 0; targetIdx < manifestTargetTotal(manifest); targetIdx++)
+            {
+                const RestoreCleanCallbackData *const cleanData = &cleanDataList[targetIdx];
+
+                if (cleanData->exists && cleanData->target->file == NULL &&
+                    (strEq(path->name, cleanData->targetName) ||
+                     strBeginsWith(path->name, strNewFmt("%s/", strZ(cleanData->targetName)))) &&
+                    (target == NULL || strSize(cleanData->targetName) > strSize(target->targetName)))
+                {
+                    target = cleanData;
+                }
+            }
+
+            // Skip paths not in a target being cleaned and paths mapped as links since their targets are cleaned separately
+            const bool targetPath = target != NULL && strEq(path->name, target->targetName);
+
+            if (target == NULL || (!targetPath && manifestLinkFindDefault(manifest, path->name, NULL) != NULL))
+                continue;
+
+            // Check that the path and all paths between it and the target are paths. The target has already been checked.
+            const String *pgPath = target->targetPath;
+            bool valid = true;
+
+            if (!targetPath)
+            {
+                const StringList *const subPathList = strLstNewSplitZ(
+                    strSub(path->name, strSize(target->targetName) + 1), "/");
+
+                for (unsigned int subPathIdx = 0; subPathIdx < strLstSize(subPathList); subPathIdx++)
                 {
-                    const ManifestPath *manifestPath = manifestPathFindDefault(cleanData->manifest, manifestName, NULL);
+                    pgPath = strNewFmt("%s/%s", strZ(pgPath), strZ(strLstGet(subPathList, subPathIdx)));
 
-                    if (manifestPath != NULL && manifestLinkFindDefault(cleanData->manifest, manifestName, NULL) == NULL)
-                    {
-                        // Check ownership/permissions
-                        restoreCleanOwnership(
-                            pgPath, manifestPath->user, cleanData->rootReplaceUser, manifestPath->group,
-                            cleanData->rootReplaceGroup, info.userId, info.groupId, false);
-                        restoreCleanMode(pgPath, manifestPath->mode, &info);
-
-                        // Recurse into the path
-                        RestoreCleanCallbackData cleanDataSub = *cleanData;
-                        cleanDataSub.targetName = strNewFmt("%s/%s", strZ(cleanData->targetName), strZ(info.name));
-                        cleanDataSub.targetPath = strNewFmt("%s/%s", strZ(cleanData->targetPath), strZ(info.name));
-                        cleanDataSub.basePath = false;
+                    const StorageInfo info = storageInfoP(storageLocal(), pgPath, .ignoreMissing = true);
 
-                        restoreCleanBuildRecurse(
-                            storageNewItrP(
-                                storageLocalWrite(), cleanDataSub.targetPath, .errorOnMissing = true, .sortOrder = sortOrderAsc),
-                            &cleanDataSub);
-                    }
-                    else
+                    if (!info.exists || info.type != storageTypePath)
                     {
-                        LOG_DETAIL_FMT("remove invalid path '%s'", strZ(pgPath));
-                        storagePathRemoveP(storageLocalWrite(), pgPath, .errorOnMissing = true, .recurse = true);
+                        valid = false;
+                        break;
                     }
+                }
+            }
 
-                    break;
+            if (valid)
+            {
+                // The base path and the tablespace path in it must be cleaned before tablespace links can be created so all queues
+                // wait for them
+                const bool queueAll =
+                    target->basePath &&
+                    (targetPath || strEqZ(path->name, MANIFEST_TARGET_PGDATA "/" MANIFEST_TARGET_PGTBLSPC));
+
+                MEM_CONTEXT_BEGIN(lstMemContext(result))
+                {
+                    lstAdd(
+                        result,
+                        &(RestoreCleanJob)
+                        {
+                            .name = strDup(path->name),
+                            .pgPath = strDup(pgPath),
+                            .fileIgnore = target->basePath && targetPath ? strLstDup(target->fileIgnore) : NULL,
+                            .queueIdx = queueAll ? RESTORE_QUEUE_ALL : restoreQueueIdx(manifest, path->name),
+                            .entryList = lstNewP(sizeof(RestoreCleanEntry), .comparator = lstComparatorStr),
+                        });
                 }
+                MEM_CONTEXT_END();
+            }
 
-                // Special file types cannot exist in the manifest so just delete them
-                case storageTypeSpecial:
-                    LOG_DETAIL_FMT("remove special file '%s'", strZ(pgPath));
-                    storageRemoveP(storageLocalWrite(), pgPath, .errorOnMissing = true);
-                    break;
+            // Reset the memory context occasionally so we don't use too much memory or slow down processing
+            MEM_CONTEXT_TEMP_RESET(1000);
+        }
+
+        // Add the files/links/paths expected in each path to the job that cleans it. Links take precedence over paths and files
+        // with the same name, as they do when cleaning without jobs.
+        lstSort(result, sortOrderAsc);
+
+        for (unsigned int linkIdx = 0; linkIdx < manifestLinkTotal(manifest); linkIdx++)
+        {
+            const ManifestLink *const link = manifestLink(manifest, linkIdx);
+
+            restoreCleanJobEntryAdd(
+                result, link->name,
+                (RestoreCleanEntry)
+                {
+                    .type = storageTypeLink,
+                    .user = restoreManifestOwnerReplace(link->user, rootReplaceUser),
+                    .group = restoreManifestOwnerReplace(link->group, rootReplaceGroup),
+                    .destination = link->destination,
+                });
+        }
+
+        for (unsigned int pathIdx = 0; pathIdx < manifestPathTotal(manifest); pathIdx++)
+        {
+            const ManifestPath *const path = manifestPath(manifest, pathIdx);
+
+            if (manifestLinkFindDefault(manifest, path->name, NULL) == NULL)
+            {
+                restoreCleanJobEntryAdd(
+                    result, path->name,
+                    (RestoreCleanEntry)
+                    {
+                        .type = storageTypePath,
+                        .mode = path->mode,
+                        .user = restoreManifestOwnerReplace(path->user, rootReplaceUser),
+                        .group = restoreManifestOwnerReplace(path->group, rootReplaceGroup),
+                    });
+            }
+
+            // Reset the memory context occasionally so we don't use too much memory or slow down processing
+            MEM_CONTEXT_TEMP_RESET(1000);
+        }
+
+        for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(manifest); fileIdx++)
+        {
+            const ManifestFile file = manifestFile(manifest, fileIdx);
+
+            if (manifestLinkFindDefault(manifest, file.name, NULL) == NULL)
+            {
+                restoreCleanJobEntryAdd(
+                    result, file.name,
+                    (RestoreCleanEntry)
+                    {
+                        .type = storageTypeFile,
+                        .mode = file.mode,
+                        .user = restoreManifestOwnerReplace(file.user, rootReplaceUser),
+                        .group = restoreManifestOwnerReplace(file.group, rootReplaceGroup),
+                    });
             }
 
             // Reset the memory context occasionally so we don't use too much memory or slow down processing
@@ -1027,20 +1322,34 @@ restoreCleanBuildRecurse(StorageIterator *const storageItr, const RestoreCleanCa
     }
     MEM_CONTEXT_TEMP_END();
 
-    FUNCTION_TEST_RETURN_VOID();
+    // Sort entries so they can be found by name and order jobs so the paths with the most entries are cleaned first
+    for (unsigned int jobIdx = 0; jobIdx < lstSize(result); jobIdx++)
+        lstSort(((RestoreCleanJob *)lstGet(result, jobIdx))->entryList, sortOrderAsc);
+
+    lstComparatorSet(result, restoreCleanJobComparator);
+    lstSort(result, sortOrderAsc);
+
+    FUNCTION_LOG_RETURN(LIST, result);
 }
 
-static void
-restoreCleanBuild(const Manifest *const manifest, const String *const rootReplaceUser, const String *const rootReplaceGroup)
+// Clean targets and create missing paths/links. When parallel is true the paths of existing targets are not cleaned and missing
+// paths/links are not created. Instead jobs to clean the paths are returned and restoreCleanBuildPath() must be called for each
+// queue once the jobs in the queue are complete.
+static List *
+restoreCleanBuild(
+    const Manifest *const manifest, const String *const rootReplaceUser, const String *const rootReplaceGroup, const bool parallel)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(MANIFEST, manifest);
         FUNCTION_LOG_PARAM(STRING, rootReplaceUser);
         FUNCTION_LOG_PARAM(STRING, rootReplaceGroup);
+        FUNCTION_LOG_PARAM(BOOL, parallel);
     FUNCTION_LOG_END();
 
     ASSERT(manifest != NULL);
 
+    List *result = NULL;
+
     MEM_CONTEXT_TEMP_BEGIN()
     {
         // Is this a delta restore?
@@ -1209,11 +1518,14 @@ restoreCleanBuild(const Manifest *const manifest, const String *const rootReplac
                         info.userId, info.groupId, false);
                     restoreCleanMode(cleanData->targetPath, manifestPath->mode, &info);
 
-                    // Clean the target
-                    restoreCleanBuildRecurse(
-                        storageNewItrP(
-                            storageLocalWrite(), cleanData->targetPath, .errorOnMissing = true, .sortOrder = sortOrderAsc),
-                        cleanData);
+                    // Clean the target now unless the paths will be cleaned by jobs
+                    if (!parallel)
+                    {
+                        restoreCleanBuildRecurse(
+                            storageNewItrP(
+                                storageLocalWrite(), cleanData->targetPath, .errorOnMissing = true, .sortOrder = sortOrderAsc),
+                            cleanData);
+                    }
                 }
             }
             // If the target does not exist we'll attempt to create it
@@ -1236,86 +1548,133 @@ restoreCleanBuild(const Manifest *const manifest, const String *const rootReplac
             }
         }
 
-        // Step 3: Create missing paths and path links
+        // Step 3: Create missing paths and links, or build jobs to clean the paths of existing targets in parallel
         // -------------------------------------------------------------------------------------------------------------------------
-        for (unsigned int pathIdx = 0; pathIdx < manifestPathTotal(manifest); pathIdx++)
+        if (parallel)
         {
-            const ManifestPath *path = manifestPath(manifest, pathIdx);
+            MEM_CONTEXT_PRIOR_BEGIN()
+            {
+                result = restoreCleanJobBuild(manifest, cleanDataList, rootReplaceUser, rootReplaceGroup);
+            }
+            MEM_CONTEXT_PRIOR_END();
+        }
+        else
+            restoreCleanBuildPath(manifest, rootReplaceUser, rootReplaceGroup, RESTORE_QUEUE_ALL);
+    }
+    MEM_CONTEXT_TEMP_END();
 
-            // Skip the pg_tblspc path because it only maps to the manifest.  We should remove this in a future release but not much
-            // can be done about it for now.
-            if (strEq(path->name, MANIFEST_TARGET_PGTBLSPC_STR))
-                continue;
+    FUNCTION_LOG_RETURN(LIST, result);
+}
 
-            // If this path has been mapped as a link then create a link.  The path has already been created as part of target
-            // creation (or it might have already existed).
-            const ManifestLink *link = manifestLinkFindDefault(
-                manifest,
-                strBeginsWith(path->name, MANIFEST_TARGET_PGTBLSPC_STR) ?
-                    strNewFmt(MANIFEST_TARGET_PGDATA "/%s", strZ(path->name)) : path->name,
-                NULL);
+/***********************************************************************************************************************************
+Build the path structure of the fan-out paths. Files are written to the fan-out paths by the restore jobs while they are written to
+the data directory so the repo is only read once. Returns NULL when there are no fan-out paths.
+***********************************************************************************************************************************/
+static StringList *
+restoreFanoutBuild(const Manifest *const manifest, const String *const rootReplaceUser, const String *const rootReplaceGroup)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(MANIFEST, manifest);
+        FUNCTION_LOG_PARAM(STRING, rootReplaceUser);
+        FUNCTION_LOG_PARAM(STRING, rootReplaceGroup);
+    FUNCTION_LOG_END();
 
-            if (link != NULL)
+    ASSERT(manifest != NULL);
+
+    StringList *result = NULL;
+
+    if (cfgOptionTest(cfgOptFanoutPath))
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            // Delta restores are not supported since the fan-out paths are not checked for files that can be preserved
+            if (cfgOptionBool(cfgOptDelta) || cfgOptionBool(cfgOptForce))
             {
-                const String *pgPath = storagePathP(storagePg(), manifestPathPg(link->name));
-                StorageInfo linkInfo = storageInfoP(storagePg(), pgPath, .ignoreMissing = true);
+                THROW(
+                    OptionInvalidError,
+                    "option '" CFGOPT_FANOUT_PATH "' not valid with '" CFGOPT_DELTA "' or '" CFGOPT_FORCE "' options");
+            }
 
-                // Create the link if it is missing.  If it exists it should already have the correct ownership and destination.
-                if (!linkInfo.exists)
+            // Tablespaces and links point outside the data directory so they can only be restored to one location
+            if (manifestTargetTotal(manifest) > 1)
+            {
+                THROW(
+                    OptionInvalidError,
+                    "option '" CFGOPT_FANOUT_PATH "' not valid when the backup contains tablespaces or links\n"
+                    "HINT: links can be restored as normal directories and files by omitting the '" CFGOPT_LINK_ALL "' option.");
+            }
+
+            const String *const pgPath = manifestTargetBase(manifest)->path;
+            const StringList *const fanoutOptionList = strLstNewVarLst(cfgOptionLst(cfgOptFanoutPath));
+            StringList *const fanoutPathList = strLstNew();
+
+            for (unsigned int fanoutIdx = 0; fanoutIdx < strLstSize(fanoutOptionList); fanoutIdx++)
+            {
+                const String *const fanoutPath = strLstGet(fanoutOptionList, fanoutIdx);
+
+                if (!strBeginsWithZ(fanoutPath, "/") || strEqZ(fanoutPath, "/"))
                 {
-                    LOG_DETAIL_FMT("create symlink '%s' to '%s'", strZ(pgPath), strZ(link->destination));
+                    THROW_FMT(
+                        OptionInvalidError, "'%s' is not valid for '" CFGOPT_FANOUT_PATH "' option\n"
+                        "HINT: fan-out paths must be absolute and not '/'.", strZ(fanoutPath));
+                }
 
-                    THROW_ON_SYS_ERROR_FMT(
-                        symlink(strZ(link->destination), strZ(pgPath)) == -1, FileOpenError,
-                        "unable to create symlink '%s' to '%s'", strZ(pgPath), strZ(link->destination));
-                    restoreCleanOwnership(
-                        pgPath, link->user, rootReplaceUser, link->group, rootReplaceGroup, userId(), groupId(), true);
+                if (strEq(fanoutPath, pgPath) || strBeginsWith(fanoutPath, strNewFmt("%s/", strZ(pgPath))) ||
+                    strBeginsWith(pgPath, strNewFmt("%s/", strZ(fanoutPath))) || strLstExists(fanoutPathList, fanoutPath))
+                {
+                    THROW_FMT(
+                        OptionInvalidError, "'%s' is not valid for '" CFGOPT_FANOUT_PATH "' option\n"
+                        "HINT: fan-out paths must not overlap with each other or '%s'.", strZ(fanoutPath), strZ(pgPath));
                 }
+
+                // The fan-out path must be missing or empty
+                if (!strLstEmpty(storageListP(storageLocal(), fanoutPath)))
+                {
+                    THROW_FMT(
+                        PathNotEmptyError, "unable to restore to fan-out path '%s' because it contains files", strZ(fanoutPath));
+                }
+
+                strLstAdd(fanoutPathList, fanoutPath);
             }
-            // Create the path normally
-            else
+
+            // Create the paths in each fan-out path. Paths are sorted so parents are created before their children.
+            for (unsigned int fanoutIdx = 0; fanoutIdx < strLstSize(fanoutPathList); fanoutIdx++)
             {
-                const String *pgPath = storagePathP(storagePg(), manifestPathPg(path->name));
-                StorageInfo pathInfo = storageInfoP(storagePg(), pgPath, .ignoreMissing = true);
+                const String *const fanoutPath = strLstGet(fanoutPathList, fanoutIdx);
 
-                // Create the path if it is missing. If it exists it should already have the correct ownership and mode.
-                if (!pathInfo.exists)
+                LOG_DETAIL_FMT("create fan-out path '%s'", strZ(fanoutPath));
+
+                for (unsigned int pathIdx = 0; pathIdx < manifestPathTotal(manifest); pathIdx++)
                 {
-                    LOG_DETAIL_FMT("create path '%s'", strZ(pgPath));
+                    const ManifestPath *const path = manifestPath(manifest, pathIdx);
+                    const String *const pathPg = manifestPathPg(path->name);
+                    const String *const pathFanout =
+                        pathPg == NULL ? fanoutPath : strNewFmt("%s/%s", strZ(fanoutPath), strZ(pathPg));
+
+                    storagePathCreateP(storageLocalWrite(), pathFanout, .mode = path->mode, .errorOnExists = pathPg != NULL);
+
+                    // The fan-out path may already exist so make sure the mode is as expected
+                    if (pathPg == NULL)
+                    {
+                        const StorageInfo info = storageInfoP(storageLocal(), pathFanout, .followLink = true);
+                        restoreCleanMode(pathFanout, path->mode, &info);
+                    }
 
-                    storagePathCreateP(storagePgWrite(), pgPath, .mode = path->mode, .noParentCreate = true, .errorOnExists = true);
                     restoreCleanOwnership(
-                        storagePathP(storagePg(), pgPath), path->user, rootReplaceUser, path->group, rootReplaceGroup, userId(),
-                        groupId(), true);
+                        pathFanout, path->user, rootReplaceUser, path->group, rootReplaceGroup, userId(), groupId(), true);
                 }
             }
-        }
-
-        // Step 4: Create file links.  These don't get created during path creation because they do not have a matching path entry.
-        // -------------------------------------------------------------------------------------------------------------------------
-        for (unsigned int linkIdx = 0; linkIdx < manifestLinkTotal(manifest); linkIdx++)
-        {
-            const ManifestLink *link = manifestLink(manifest, linkIdx);
 
-            const String *pgPath = storagePathP(storagePg(), manifestPathPg(link->name));
-            StorageInfo linkInfo = storageInfoP(storagePg(), pgPath, .ignoreMissing = true);
-
-            // Create the link if it is missing.  If it exists it should already have the correct ownership and destination.
-            if (!linkInfo.exists)
+            MEM_CONTEXT_PRIOR_BEGIN()
             {
-                LOG_DETAIL_FMT("create symlink '%s' to '%s'", strZ(pgPath), strZ(link->destination));
-
-                THROW_ON_SYS_ERROR_FMT(
-                    symlink(strZ(link->destination), strZ(pgPath)) == -1, FileOpenError,
-                    "unable to create symlink '%s' to '%s'", strZ(pgPath), strZ(link->destination));
-                restoreCleanOwnership(
-                    pgPath, link->user, rootReplaceUser, link->group, rootReplaceGroup, userId(), groupId(), true);
+                result = strLstDup(fanoutPathList);
             }
+            MEM_CONTEXT_PRIOR_END();
         }
+        MEM_CONTEXT_TEMP_END();
     }
-    MEM_CONTEXT_TEMP_END();
 
-    FUNCTION_LOG_RETURN_VOID();
+    FUNCTION_LOG_RETURN(STRING_LIST, result);
 }
 
 /***********************************************************************************************************************************
@@ -1898,29 +2257,99 @@ restoreRecoveryWrite(const Manifest *manifest)
             const String *recoveryFile = pgVersion >= PG_VERSION_RECOVERY_GUC ?
                 PG_FILE_POSTGRESQLAUTOCONF_STR : PG_FILE_RECOVERYCONF_STR;
 
-            if (!storageExistsP(storagePg(), recoveryFile))
+            if (!storageExistsP(storagePg(), recoveryFile))
+            {
+                LOG_WARN_FMT(
+                    "recovery type is " CFGOPTVAL_TYPE_PRESERVE_Z " but recovery file does not exist at '%s'",
+                    strZ(storagePathP(storagePg(), recoveryFile)));
+            }
+        }
+        // Else write recovery file
+        else
+        {
+            // Generate a label used to identify this restore in the recovery file
+            struct tm timePart;
+            char restoreTimestamp[20];
+            time_t timestamp = time(NULL);
+
+            strftime(restoreTimestamp, sizeof(restoreTimestamp), "%Y-%m-%d %H:%M:%S", localtime_r(&timestamp, &timePart));
+            const String *restoreLabel = STR(restoreTimestamp);
+
+            // Write recovery file based on PostgreSQL version
+            if (pgVersion >= PG_VERSION_RECOVERY_GUC)
+                restoreRecoveryWriteAutoConf(pgVersion, restoreLabel);
+            else
+                restoreRecoveryWriteConf(manifest, pgVersion, restoreLabel);
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Finish the fan-out paths after the data directory has been restored. The recovery settings written to the data directory are copied
+so all the data directories recover the same way, then the paths are synced and pg_control is renamed last just as in the data
+directory.
+***********************************************************************************************************************************/
+static void
+restoreFanoutFinish(const Manifest *const manifest, const StringList *const fanoutPathList)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(MANIFEST, manifest);
+        FUNCTION_LOG_PARAM(STRING_LIST, fanoutPathList);
+    FUNCTION_LOG_END();
+
+    ASSERT(manifest != NULL);
+    ASSERT(fanoutPathList != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const String *const recoveryFileList[] =
+        {
+            PG_FILE_RECOVERYCONF_STR, PG_FILE_POSTGRESQLAUTOCONF_STR, PG_FILE_RECOVERYSIGNAL_STR, PG_FILE_STANDBYSIGNAL_STR,
+        };
+
+        for (unsigned int fanoutIdx = 0; fanoutIdx < strLstSize(fanoutPathList); fanoutIdx++)
+        {
+            const String *const fanoutPath = strLstGet(fanoutPathList, fanoutIdx);
+
+            // Copy recovery settings
+            for (unsigned int recoveryFileIdx = 0; recoveryFileIdx < LENGTH_OF(recoveryFileList); recoveryFileIdx++)
             {
-                LOG_WARN_FMT(
-                    "recovery type is " CFGOPTVAL_TYPE_PRESERVE_Z " but recovery file does not exist at '%s'",
-                    strZ(storagePathP(storagePg(), recoveryFile)));
+                storageCopyP(
+                    storageNewReadP(storagePg(), recoveryFileList[recoveryFileIdx], .ignoreMissing = true),
+                    storageNewWriteP(
+                        storageLocalWrite(), strNewFmt("%s/%s", strZ(fanoutPath), strZ(recoveryFileList[recoveryFileIdx])),
+                        .noSyncPath = true));
             }
-        }
-        // Else write recovery file
-        else
-        {
-            // Generate a label used to identify this restore in the recovery file
-            struct tm timePart;
-            char restoreTimestamp[20];
-            time_t timestamp = time(NULL);
 
-            strftime(restoreTimestamp, sizeof(restoreTimestamp), "%Y-%m-%d %H:%M:%S", localtime_r(&timestamp, &timePart));
-            const String *restoreLabel = STR(restoreTimestamp);
+            // Sync paths except global, which is synced after pg_control is written
+            for (unsigned int pathIdx = 0; pathIdx < manifestPathTotal(manifest); pathIdx++)
+            {
+                const String *const pathPg = manifestPathPg(manifestPath(manifest, pathIdx)->name);
 
-            // Write recovery file based on PostgreSQL version
-            if (pgVersion >= PG_VERSION_RECOVERY_GUC)
-                restoreRecoveryWriteAutoConf(pgVersion, restoreLabel);
-            else
-                restoreRecoveryWriteConf(manifest, pgVersion, restoreLabel);
+                if (pathPg == NULL)
+                    storagePathSyncP(storageLocalWrite(), fanoutPath);
+                else if (!strEq(pathPg, PG_PATH_GLOBAL_STR))
+                    storagePathSyncP(storageLocalWrite(), strNewFmt("%s/%s", strZ(fanoutPath), strZ(pathPg)));
+            }
+
+            // Rename pg_control
+            const String *const pgControlFile = strNewFmt("%s/" PG_PATH_GLOBAL "/" PG_FILE_PGCONTROL, strZ(fanoutPath));
+
+            if (storageExistsP(storageLocal(), strNewFmt("%s." STORAGE_FILE_TEMP_EXT, strZ(pgControlFile))))
+            {
+                LOG_INFO_FMT("restore " PG_PATH_GLOBAL "/" PG_FILE_PGCONTROL " to fan-out path '%s'", strZ(fanoutPath));
+
+                storageMoveP(
+                    storageLocalWrite(),
+                    storageNewReadP(storageLocal(), strNewFmt("%s." STORAGE_FILE_TEMP_EXT, strZ(pgControlFile))),
+                    storageNewWriteP(storageLocalWrite(), pgControlFile, .noSyncPath = true));
+            }
+
+            // Sync global path
+            storagePathSyncP(storageLocalWrite(), strNewFmt("%s/" PG_PATH_GLOBAL, strZ(fanoutPath)));
         }
     }
     MEM_CONTEXT_TEMP_END();
@@ -2003,6 +2432,183 @@ restoreProcessQueueComparator(const void *item1, const void *item2)
     FUNCTION_TEST_RETURN(INT, -1);
 }
 
+// Helper to determine if a file is needed to start the cluster and should be restored first when restore-priority is set, i.e.
+// global, version files, relation map files, and catalog relations
+static bool
+restoreProcessQueuePriority(const String *const manifestName)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, manifestName);
+    FUNCTION_TEST_END();
+
+    ASSERT(manifestName != NULL);
+
+    bool result = strBeginsWithZ(manifestName, MANIFEST_TARGET_PGDATA "/" PG_PATH_GLOBAL "/");
+
+    if (!result)
+    {
+        const char *const name = strZ(manifestName);
+        const char *const fileName = strBaseZ(manifestName);
+
+        if (strcmp(fileName, PG_FILE_PGVERSION) == 0 || strcmp(fileName, PG_FILE_PGFILENODEMAP) == 0)
+        {
+            result = true;
+        }
+        // Else check for a catalog relation. Relations are stored in a path named for the database oid and the file name begins
+        // with the relfilenode, followed by the fork and segment (if any). Catalogs have a relfilenode below the first normal
+        // object id unless they have been rewritten, e.g. by VACUUM FULL.
+        else
+        {
+            const size_t relFileNodeSize = strspn(fileName, "0123456789");
+
+            if (fileName != name && relFileNodeSize > 0 && relFileNodeSize <= 5 &&
+                (fileName[relFileNodeSize] == '\0' || fileName[relFileNodeSize] == '_' || fileName[relFileNodeSize] == '.'))
+            {
+                // Find the beginning of the path that contains the file
+                const char *const pathEnd = fileName - 1;
+                const char *pathBegin = pathEnd;
+
+                while (pathBegin > name && pathBegin[-1] != '/')
+                    pathBegin--;
+
+                // The path must be named for the database oid
+                if (pathBegin != pathEnd && strspn(pathBegin, "0123456789") == (size_t)(pathEnd - pathBegin))
+                {
+                    unsigned int relFileNode = 0;
+
+                    for (size_t digitIdx = 0; digitIdx < relFileNodeSize; digitIdx++)
+                        relFileNode = relFileNode * 10 + (unsigned int)(fileName[digitIdx] - '0');
+
+                    result = pgDbIsSystemId(relFileNode);
+                }
+            }
+        }
+    }
+
+    FUNCTION_TEST_RETURN(BOOL, result);
+}
+
+// Comparator to order ManifestFile objects when restore-priority is set. Files needed to start the cluster are first, then zero
+// length files, then bundled files (in the order used by restoreProcessQueueComparator() so each bundle is read in as few jobs as
+// possible), then the remaining files by size (smallest first).
+static int
+restoreProcessQueuePriorityComparator(const void *item1, const void *item2)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, item1);
+        FUNCTION_TEST_PARAM_P(VOID, item2);
+    FUNCTION_TEST_END();
+
+    ASSERT(item1 != NULL);
+    ASSERT(item2 != NULL);
+
+    // Unpack files
+    ManifestFile file1 = manifestFileUnpack(restoreProcessQueueComparatorManifest, *(const ManifestFilePack **)item1);
+    ManifestFile file2 = manifestFileUnpack(restoreProcessQueueComparatorManifest, *(const ManifestFilePack **)item2);
+
+    // Files needed to start the cluster are first
+    const bool priority1 = restoreProcessQueuePriority(file1.name);
+
+    if (priority1 != restoreProcessQueuePriority(file2.name))
+        FUNCTION_TEST_RETURN(INT, priority1 ? -1 : 1);
+
+    // Zero length files are next
+    if ((file1.size == 0) != (file2.size == 0))
+        FUNCTION_TEST_RETURN(INT, file1.size == 0 ? -1 : 1);
+
+    // Bundled files are next
+    if (file1.size != 0 && (file1.bundleId != 0 || file2.bundleId != 0))
+    {
+        if (file1.bundleId != 0 && file2.bundleId != 0)
+            FUNCTION_TEST_RETURN(INT, restoreProcessQueueComparator(item1, item2) * -1);
+
+        FUNCTION_TEST_RETURN(INT, file1.bundleId != 0 ? -1 : 1);
+    }
+
+    // Order by size then name
+    if (file1.size < file2.size)
+        FUNCTION_TEST_RETURN(INT, -1);
+    else if (file1.size > file2.size)
+        FUNCTION_TEST_RETURN(INT, 1);
+
+    FUNCTION_TEST_RETURN(INT, strCmp(file1.name, file2.name));
+}
+
+// Interleave a queue sorted by restoreProcessQueuePriorityComparator() so large files are restored alongside small files rather
+// than all at the end. Within each priority class files are taken from the front (smallest first) until more bytes have been taken
+// from the front than the back, then a file is taken from the back (largest first). Bundles are taken from the front whole.
+static List *
+restoreProcessQueueInterleave(const Manifest *const manifest, const List *const queue)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(MANIFEST, manifest);
+        FUNCTION_TEST_PARAM(LIST, queue);
+    FUNCTION_TEST_END();
+
+    ASSERT(manifest != NULL);
+    ASSERT(queue != NULL);
+
+    List *const result = lstNewP(sizeof(ManifestFile *), .comparator = restoreProcessQueuePriorityComparator);
+    unsigned int classBegin = 0;
+
+    while (classBegin < lstSize(queue))
+    {
+        // Find the end of the priority class
+        const bool priority = restoreProcessQueuePriority(
+            manifestFileUnpack(manifest, *(const ManifestFilePack **)lstGet(queue, classBegin)).name);
+        unsigned int classEnd = classBegin + 1;
+
+        while (
+            classEnd < lstSize(queue) &&
+            restoreProcessQueuePriority(
+                manifestFileUnpack(manifest, *(const ManifestFilePack **)lstGet(queue, classEnd)).name) == priority)
+        {
+            classEnd++;
+        }
+
+        // Take files from the front and back of the class
+        unsigned int front = classBegin;
+        unsigned int back = classEnd;
+        uint64_t sizeFront = 0;
+        uint64_t sizeBack = 0;
+
+        while (front < back)
+        {
+            const ManifestFile fileBack = manifestFileUnpack(manifest, *(const ManifestFilePack **)lstGet(queue, back - 1));
+
+            // Take from the back when the front is ahead, unless only zero length and bundled files are left
+            if (sizeFront > sizeBack && fileBack.size != 0 && fileBack.bundleId == 0)
+            {
+                lstAdd(result, lstGet(queue, back - 1));
+                sizeBack += fileBack.size;
+                back--;
+            }
+            // Else take from the front along with the rest of the bundle (if any)
+            else
+            {
+                const ManifestFile fileFront = manifestFileUnpack(manifest, *(const ManifestFilePack **)lstGet(queue, front));
+
+                do
+                {
+                    const ManifestFile file = manifestFileUnpack(manifest, *(const ManifestFilePack **)lstGet(queue, front));
+
+                    if (file.bundleId != fileFront.bundleId || !strEq(file.reference, fileFront.reference))
+                        break;
+
+                    lstAdd(result, lstGet(queue, front));
+                    sizeFront += file.size;
+                    front++;
+                }
+                while (fileFront.bundleId != 0 && front < back);
+            }
+        }
+
+        classBegin = classEnd;
+    }
+
+    FUNCTION_TEST_RETURN(LIST, result);
+}
+
 static uint64_t
 restoreProcessQueue(Manifest *manifest, List **queueList)
 {
@@ -2033,11 +2639,15 @@ restoreProcessQueue(Manifest *manifest, List **queueList)
         }
 
         // Generate the processing queues
+        const bool priority = cfgOptionBool(cfgOptRestorePriority);
+
         MEM_CONTEXT_BEGIN(lstMemContext(*queueList))
         {
             for (unsigned int targetIdx = 0; targetIdx < strLstSize(targetList); targetIdx++)
             {
-                List *queue = lstNewP(sizeof(ManifestFile *), .comparator = restoreProcessQueueComparator);
+                List *queue = lstNewP(
+                    sizeof(ManifestFile *),
+                    .comparator = priority ? restoreProcessQueuePriorityComparator : restoreProcessQueueComparator);
                 lstAdd(*queueList, &queue);
             }
         }
@@ -2075,7 +2685,27 @@ restoreProcessQueue(Manifest *manifest, List **queueList)
         restoreProcessQueueComparatorManifest = manifest;
 
         for (unsigned int targetIdx = 0; targetIdx < strLstSize(targetList); targetIdx++)
-            lstSort(*(List **)lstGet(*queueList, targetIdx), sortOrderDesc);
+        {
+            List **const queue = lstGet(*queueList, targetIdx);
+
+            // When files needed to start the cluster are restored first the queue is sorted by priority and then interleaved
+            if (priority)
+            {
+                lstSort(*queue, sortOrderAsc);
+
+                MEM_CONTEXT_BEGIN(lstMemContext(*queueList))
+                {
+                    List *const queuePrior = *queue;
+
+                    *queue = restoreProcessQueueInterleave(manifest, queuePrior);
+                    lstFree(queuePrior);
+                }
+                MEM_CONTEXT_END();
+            }
+            // Else restore the largest files first
+            else
+                lstSort(*queue, sortOrderDesc);
+        }
 
         // Move process queues to prior context
         lstMove(*queueList, memContextPrior());
@@ -2151,6 +2781,11 @@ restoreJobResult(const Manifest *manifest, ProtocolParallelJob *job, RegExp *zer
                 const ManifestFile file = manifestFileFind(manifest, pckReadStrP(jobResult));
                 const bool zeroed = restoreFileZeroed(file.name, zeroExp);
                 const RestoreResult result = (RestoreResult)pckReadU32P(jobResult);
+                const unsigned int splitPart = pckReadU32P(jobResult);
+
+                // A split file that is not zeroed is restored by a job for each part
+                const bool split = file.splitSize != 0 && !zeroed;
+                const uint64_t size = split ? manifestSplitSize(&file, splitPart) : file.size;
 
                 String *log = strCatZ(strNew(), "restore");
 
@@ -2161,13 +2796,16 @@ restoreJobResult(const Manifest *manifest, ProtocolParallelJob *job, RegExp *zer
                 // Add filename
                 strCatFmt(log, " file %s", strZ(restoreFilePgPath(manifest, file.name)));
 
+                if (split)
+                    strCatFmt(log, " part %u/%u", splitPart + 1, manifestSplitTotal(&file));
+
                 // If preserved add details to explain why it was not copied or zeroed
                 if (result == restoreResultPreserve)
                 {
                     strCatZ(log, " - ");
 
-                    // On force we match on size and modification time
-                    if (cfgOptionBool(cfgOptForce))
+                    // On force we match on size and modification time (parts of split files are always matched on checksum)
+                    if (cfgOptionBool(cfgOptForce) && !split)
                     {
                         strCatFmt(
                             log, "exists and matches size %" PRIu64 " and modification time %" PRIu64, file.size,
@@ -2178,54 +2816,276 @@ restoreJobResult(const Manifest *manifest, ProtocolParallelJob *job, RegExp *zer
                     {
                         strCatZ(log, "exists and ");
 
-                        // No need to copy zero-length files
-                        if (file.size == 0)
-                        {
-                            strCatZ(log, "is zero size");
-                        }
-                        // The file matched the manifest checksum so did not need to be copied
-                        else
-                            strCatZ(log, "matches backup");
-                    }
-                }
+                        // No need to copy zero-length files
+                        if (file.size == 0)
+                        {
+                            strCatZ(log, "is zero size");
+                        }
+                        // The file matched the manifest checksum so did not need to be copied
+                        else
+                            strCatZ(log, "matches backup");
+                    }
+                }
+
+
+                // Add bundle info
+                strCatZ(log, " (");
+
+                if (file.bundleId != 0)
+                {
+                    ASSERT(varUInt64(protocolParallelJobKey(job)) == file.bundleId);
+
+                    strCatZ(log, "bundle ");
+
+                    if (file.reference != NULL)
+                        strCatFmt(log, "%s/", strZ(file.reference));
+
+                    strCatFmt(log, "%" PRIu64 "/%" PRIu64 ", ", file.bundleId, file.bundleOffset);
+                }
+
+                // Add size and percent complete
+                sizeRestored += size;
+                strCatFmt(log, "%s, %.2lf%%)", strZ(strSizeFormat(size)), (double)sizeRestored * 100.00 / (double)sizeTotal);
+
+                // If not zero-length add the checksum
+                if (file.size != 0 && !zeroed)
+                    strCatFmt(log, " checksum %s", split ? strZ(manifestSplitChecksum(&file, splitPart)) : file.checksumSha1);
+
+                LOG_DETAIL_PID(protocolParallelJobProcessId(job), strZ(log));
+            }
+        }
+        MEM_CONTEXT_TEMP_END();
+
+        // Free the job
+        protocolParallelJobFree(job);
+    }
+    // Else the job errored
+    else
+        THROW_CODE(protocolParallelJobErrorCode(job), strZ(protocolParallelJobErrorMessage(job)));
+
+    FUNCTION_LOG_RETURN(UINT64, sizeRestored);
+}
+
+/***********************************************************************************************************************************
+Log restore progress. The time remaining is estimated from the throughput observed since files began to be restored.
+***********************************************************************************************************************************/
+static void
+restoreProgress(const uint64_t sizeTotal, const uint64_t sizeRestored, const TimeMSec timeElapsed)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(UINT64, sizeTotal);
+        FUNCTION_LOG_PARAM(UINT64, sizeRestored);
+        FUNCTION_LOG_PARAM(TIME_MSEC, timeElapsed);
+    FUNCTION_LOG_END();
+
+    ASSERT(sizeRestored > 0 && sizeRestored < sizeTotal);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Throughput in bytes per second. Less than a millisecond is counted as a millisecond.
+        const double throughput = (double)sizeRestored * MSEC_PER_SEC / (double)(timeElapsed == 0 ? 1 : timeElapsed);
+
+        LOG_INFO_FMT(
+            "restore progress %.2lf%% (%s of %s), %s/s, eta %" PRIu64 "s", (double)sizeRestored * 100.00 / (double)sizeTotal,
+            strZ(strSizeFormat(sizeRestored)), strZ(strSizeFormat(sizeTotal)), strZ(strSizeFormat((uint64_t)throughput)),
+            (uint64_t)((double)(sizeTotal - sizeRestored) / throughput + 0.5));
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Load the dictionaries used to compress bundled files. The dictionaries are loaded before the remotes are freed and then passed to
+the local processes with the first job for each process that restores bundled files.
+***********************************************************************************************************************************/
+typedef struct RestoreBundleDict
+{
+    const String *backupLabel;                                      // Backup where the dictionary is stored (must be first member)
+    const Buffer *dict;                                             // Dictionary
+    List *clientList;                                               // Clients the dictionary has been sent to
+} RestoreBundleDict;
+
+static List *
+restoreBundleDictLoad(
+    const Manifest *const manifest, const unsigned int repoIdx, const CipherType cipherType, const String *const cipherSubPass)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(MANIFEST, manifest);
+        FUNCTION_LOG_PARAM(UINT, repoIdx);
+        FUNCTION_LOG_PARAM(STRING_ID, cipherType);
+        FUNCTION_TEST_PARAM(STRING, cipherSubPass);
+    FUNCTION_LOG_END();
+
+    ASSERT(manifest != NULL);
+
+    List *const result = lstNewP(sizeof(RestoreBundleDict), .comparator = lstComparatorStr);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(manifest); fileIdx++)
+        {
+            const ManifestFile file = manifestFile(manifest, fileIdx);
+
+            if (!file.bundleDict)
+                continue;
+
+            const String *const backupLabel = file.reference != NULL ? file.reference : manifestData(manifest)->backupLabel;
+
+            if (lstFind(result, &backupLabel) == NULL)
+            {
+                StorageRead *const read = storageNewReadP(
+                    storageRepoIdx(repoIdx), strNewFmt(STORAGE_REPO_BACKUP "/%s/" MANIFEST_FILE_BUNDLE_DICT, strZ(backupLabel)));
+                cipherBlockFilterGroupAdd(ioReadFilterGroup(storageReadIo(read)), cipherType, cipherModeDecrypt, cipherSubPass);
+
+                MEM_CONTEXT_BEGIN(lstMemContext(result))
+                {
+                    lstAdd(
+                        result,
+                        &(RestoreBundleDict){
+                            .backupLabel = strDup(backupLabel), .dict = storageGetP(read),
+                            .clientList = lstNewP(sizeof(unsigned int), .comparator = lstComparatorUInt)});
+                }
+                MEM_CONTEXT_END();
+            }
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(LIST, result);
+}
+
+/***********************************************************************************************************************************
+Find other repos that contain the backup set so files can also be read from them. A file is only read from another repo when it is
+stored there exactly as in the repo where the backup set was found, i.e. the checksum, size, and location in the repo all match, so
+the parameters of the restore jobs are the same no matter which repo the file is read from.
+***********************************************************************************************************************************/
+typedef struct RestoreRepo
+{
+    unsigned int repoIdx;                                           // Internal repo idx
+    const String *cipherSubPass;                                    // Passphrase used to decrypt files in the backup
+    const List *bundleDictList;                                     // Dictionaries used to compress bundled files
+    StringList *fileList;                                           // Files that can be read from the repo (NULL for all)
+    bool disabled;                                                  // Is the repo disabled after an error?
+    uint64_t sizeRunning;                                           // Size of files in running jobs
+    uint64_t sizeDone;                                              // Size of files in completed jobs
+    uint64_t timeDone;                                              // Time in usec of completed jobs
+} RestoreRepo;
+
+// Helper to determine if a file is stored the same way in both repos
+static bool
+restoreRepoFileEq(const ManifestFile *const file, const ManifestFile *const fileRepo)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, file);
+        FUNCTION_TEST_PARAM_P(VOID, fileRepo);
+    FUNCTION_TEST_END();
+
+    ASSERT(file != NULL);
+    ASSERT(fileRepo != NULL);
+
+    FUNCTION_TEST_RETURN(
+        BOOL,
+        file->size == fileRepo->size && strcmp(file->checksumSha1, fileRepo->checksumSha1) == 0 &&
+        strEq(file->reference, fileRepo->reference) && file->bundleId == fileRepo->bundleId &&
+        file->bundleOffset == fileRepo->bundleOffset && file->sizeRepo == fileRepo->sizeRepo && file->dedup == fileRepo->dedup &&
+        file->bundleDict == fileRepo->bundleDict && file->splitSize == fileRepo->splitSize);
+}
+
+static void
+restoreRepoShare(List *const repoList, const Manifest *const manifest)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(LIST, repoList);
+        FUNCTION_LOG_PARAM(MANIFEST, manifest);
+    FUNCTION_LOG_END();
+
+    ASSERT(repoList != NULL);
+    ASSERT(lstSize(repoList) == 1);
+    ASSERT(manifest != NULL);
+
+    const unsigned int repoIdxBackup = ((const RestoreRepo *)lstGet(repoList, 0))->repoIdx;
+    const String *const backupLabel = manifestData(manifest)->backupLabel;
+
+    for (unsigned int repoIdx = 0; repoIdx < cfgOptionGroupIdxTotal(cfgOptGrpRepo); repoIdx++)
+    {
+        if (repoIdx == repoIdxBackup)
+            continue;
+
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            TRY_BEGIN()
+            {
+                // The backup set must exist in the repo
+                const CipherType cipherType = cfgOptionIdxStrId(cfgOptRepoCipherType, repoIdx);
+                const InfoBackup *const infoBackup = infoBackupLoadFile(
+                    storageRepoIdx(repoIdx), INFO_BACKUP_PATH_FILE_STR, cipherType,
+                    cfgOptionIdxStrNull(cfgOptRepoCipherPass, repoIdx));
+
+                if (!infoBackupLabelExists(infoBackup, backupLabel))
+                    THROW_FMT(BackupSetInvalidError, "backup set %s is not valid", strZ(backupLabel));
 
+                const Manifest *const manifestRepo = manifestLoadFile(
+                    storageRepoIdx(repoIdx), strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE, strZ(backupLabel)),
+                    cipherType, infoPgCipherPass(infoBackupPg(infoBackup)));
 
-                // Add bundle info
-                strCatZ(log, " (");
+                // Find the files that are stored the same way. Files cannot match when the compression type is different since the
+                // compression type determines the file extension and how the file is decompressed.
+                StringList *const fileList = strLstNew();
 
-                if (file.bundleId != 0)
+                if (manifestData(manifestRepo)->backupOptionCompressType == manifestData(manifest)->backupOptionCompressType)
                 {
-                    ASSERT(varUInt64(protocolParallelJobKey(job)) == file.bundleId);
-
-                    strCatZ(log, "bundle ");
+                    for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(manifest); fileIdx++)
+                    {
+                        const ManifestFile file = manifestFile(manifest, fileIdx);
 
-                    if (file.reference != NULL)
-                        strCatFmt(log, "%s/", strZ(file.reference));
+                        if (manifestFileExists(manifestRepo, file.name))
+                        {
+                            const ManifestFile fileRepo = manifestFileFind(manifestRepo, file.name);
 
-                    strCatFmt(log, "%" PRIu64 "/%" PRIu64 ", ", file.bundleId, file.bundleOffset);
+                            if (restoreRepoFileEq(&file, &fileRepo))
+                                strLstAdd(fileList, file.name);
+                        }
+                    }
                 }
 
-                // Add size and percent complete
-                sizeRestored += file.size;
-                strCatFmt(log, "%s, %.2lf%%)", strZ(strSizeFormat(file.size)), (double)sizeRestored * 100.00 / (double)sizeTotal);
+                if (strLstEmpty(fileList))
+                    THROW_FMT(FormatError, "backup set %s has no files that match", strZ(backupLabel));
 
-                // If not zero-length add the checksum
-                if (file.size != 0 && !zeroed)
-                    strCatFmt(log, " checksum %s", file.checksumSha1);
+                LOG_INFO_FMT(
+                    "%s: share restore of backup set %s (%u/%u files)", cfgOptionGroupName(cfgOptGrpRepo, repoIdx),
+                    strZ(backupLabel), strLstSize(fileList), manifestFileTotal(manifest));
 
-                LOG_DETAIL_PID(protocolParallelJobProcessId(job), strZ(log));
+                // Add the repo
+                List *const bundleDictList = restoreBundleDictLoad(
+                    manifestRepo, repoIdx, cipherType, manifestCipherSubPass(manifestRepo));
+
+                MEM_CONTEXT_BEGIN(lstMemContext(repoList))
+                {
+                    lstAdd(
+                        repoList,
+                        &(RestoreRepo)
+                        {
+                            .repoIdx = repoIdx,
+                            .cipherSubPass = strDup(manifestCipherSubPass(manifestRepo)),
+                            .bundleDictList = lstMove(bundleDictList, lstMemContext(repoList)),
+                            .fileList = strLstMove(strLstSort(fileList, sortOrderAsc), lstMemContext(repoList)),
+                        });
+                }
+                MEM_CONTEXT_END();
+            }
+            CATCH_ANY()
+            {
+                LOG_DETAIL_FMT(
+                    "%s: unable to share restore: [%s] %s", cfgOptionGroupName(cfgOptGrpRepo, repoIdx), errorTypeName(errorType()),
+                    errorMessage());
             }
+            TRY_END();
         }
         MEM_CONTEXT_TEMP_END();
-
-        // Free the job
-        protocolParallelJobFree(job);
     }
-    // Else the job errored
-    else
-        THROW_CODE(protocolParallelJobErrorCode(job), strZ(protocolParallelJobErrorMessage(job)));
 
-    FUNCTION_LOG_RETURN(UINT64, sizeRestored);
+    FUNCTION_LOG_RETURN_VOID();
 }
 
 /***********************************************************************************************************************************
@@ -2233,15 +3093,31 @@ Return new restore jobs as requested
 ***********************************************************************************************************************************/
 typedef struct RestoreJobData
 {
-    unsigned int repoIdx;                                           // Internal repo idx
+    List *repoList;                                                 // Repos to read files from (first is the backup set repo)
+    List *jobRepoList;                                              // Repo of each running job (when there are multiple repos)
     Manifest *manifest;                                             // Backup manifest
     List *queueList;                                                // List of processing queues
     RegExp *zeroExp;                                                // Identify files that should be sparse zeroed
-    const String *cipherSubPass;                                    // Passphrase used to decrypt files in the backup
     const String *rootReplaceUser;                                  // User to replace invalid users when root
     const String *rootReplaceGroup;                                 // Group to replace invalid group when root
+    List *cleanList;                                                // Jobs to clean paths (NULL when cleaned before restore)
+    unsigned int cleanIdx;                                          // Next clean job
+    unsigned int *queueCleanTotal;                                  // Clean jobs each queue is waiting for
+    unsigned int *queueSplitPart;                                   // Next part of the split file at the head of each queue
+    StringList *fanoutPathList;                                     // Paths to also restore files to (NULL when none)
 } RestoreJobData;
 
+// Repo of a running job. The files in the job are kept so they can be queued again when the job fails on a repo other than the
+// backup set repo.
+typedef struct RestoreJobRepo
+{
+    const ProtocolParallelJob *job;                                 // Running job
+    unsigned int repoListIdx;                                       // Index of the repo in the repo list
+    unsigned int queueIdx;                                          // Queue the files were taken from
+    uint64_t size;                                                  // Size of the files in the job
+    List *fileList;                                                 // Files in the job (ManifestFilePack *)
+} RestoreJobRepo;
+
 // Helper to calculate the next queue to scan based on the client index
 static int
 restoreJobQueueNext(unsigned int clientIdx, int queueIdx, unsigned int queueTotal)
@@ -2264,28 +3140,204 @@ restoreJobQueueNext(unsigned int clientIdx, int queueIdx, unsigned int queueTota
     FUNCTION_TEST_RETURN(INT, queueIdx);
 }
 
-// Callback to fetch restore jobs for the parallel executor
-static ProtocolParallelJob *restoreJobCallback(void *data, unsigned int clientIdx)
+// Helper to count the clean jobs each queue is waiting for. Missing paths/links are created now for queues that are not waiting.
+static void
+restoreJobCleanInit(RestoreJobData *const jobData)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM_P(VOID, jobData);
+    FUNCTION_LOG_END();
+
+    ASSERT(jobData != NULL);
+    ASSERT(jobData->cleanList != NULL);
+
+    jobData->queueCleanTotal = memNew(sizeof(unsigned int) * lstSize(jobData->queueList));
+
+    for (unsigned int queueIdx = 0; queueIdx < lstSize(jobData->queueList); queueIdx++)
+    {
+        jobData->queueCleanTotal[queueIdx] = 0;
+
+        for (unsigned int cleanIdx = 0; cleanIdx < lstSize(jobData->cleanList); cleanIdx++)
+        {
+            const RestoreCleanJob *const cleanJob = lstGet(jobData->cleanList, cleanIdx);
+
+            if (cleanJob->queueIdx == RESTORE_QUEUE_ALL || cleanJob->queueIdx == queueIdx)
+                jobData->queueCleanTotal[queueIdx]++;
+        }
+
+        if (jobData->queueCleanTotal[queueIdx] == 0)
+            restoreCleanBuildPath(jobData->manifest, jobData->rootReplaceUser, jobData->rootReplaceGroup, queueIdx);
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+// Helper to process the result of a clean job. When a queue is no longer waiting for clean jobs the missing paths/links in the
+// queue are created so files in the queue can be restored.
+static void
+restoreJobCleanResult(RestoreJobData *const jobData, ProtocolParallelJob *const job)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM_P(VOID, jobData);
+        FUNCTION_LOG_PARAM(PROTOCOL_PARALLEL_JOB, job);
+    FUNCTION_LOG_END();
+
+    ASSERT(jobData != NULL);
+    ASSERT(job != NULL);
+
+    // The job was successful
+    if (protocolParallelJobErrorCode(job) == 0)
+    {
+        const RestoreCleanJob *const cleanJob = lstGet(jobData->cleanList, varUInt(protocolParallelJobKey(job)));
+
+        for (unsigned int queueIdx = 0; queueIdx < lstSize(jobData->queueList); queueIdx++)
+        {
+            if (cleanJob->queueIdx == RESTORE_QUEUE_ALL || cleanJob->queueIdx == queueIdx)
+            {
+                ASSERT(jobData->queueCleanTotal[queueIdx] > 0);
+                jobData->queueCleanTotal[queueIdx]--;
+
+                if (jobData->queueCleanTotal[queueIdx] == 0)
+                    restoreCleanBuildPath(jobData->manifest, jobData->rootReplaceUser, jobData->rootReplaceGroup, queueIdx);
+            }
+        }
+
+        // Free the job
+        protocolParallelJobFree(job);
+    }
+    // Else the job errored
+    else
+        THROW_CODE(protocolParallelJobErrorCode(job), strZ(protocolParallelJobErrorMessage(job)));
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+// Helper to get the next clean job
+static ProtocolParallelJob *
+restoreJobClean(RestoreJobData *const jobData)
 {
     FUNCTION_TEST_BEGIN();
-        FUNCTION_TEST_PARAM_P(VOID, data);
-        FUNCTION_TEST_PARAM(UINT, clientIdx);
+        FUNCTION_TEST_PARAM_P(VOID, jobData);
     FUNCTION_TEST_END();
 
-    ASSERT(data != NULL);
+    ASSERT(jobData != NULL);
+    ASSERT(jobData->cleanIdx < lstSize(jobData->cleanList));
 
     ProtocolParallelJob *result = NULL;
 
     MEM_CONTEXT_TEMP_BEGIN()
     {
-        // Get a new job if there are any left
-        RestoreJobData *jobData = data;
+        const RestoreCleanJob *const cleanJob = lstGet(jobData->cleanList, jobData->cleanIdx);
+        ProtocolCommand *const command = protocolCommandNew(PROTOCOL_COMMAND_RESTORE_CLEAN);
+        PackWrite *const param = protocolCommandParam(command);
+
+        pckWriteStrP(param, cleanJob->pgPath);
+        pckWriteStrLstP(param, cleanJob->fileIgnore);
+
+        for (unsigned int entryIdx = 0; entryIdx < lstSize(cleanJob->entryList); entryIdx++)
+        {
+            const RestoreCleanEntry *const entry = lstGet(cleanJob->entryList, entryIdx);
+
+            pckWriteStrP(param, entry->name);
+            pckWriteU32P(param, entry->type);
+            pckWriteModeP(param, entry->mode);
+            pckWriteStrP(param, entry->user);
+            pckWriteStrP(param, entry->group);
+            pckWriteStrP(param, entry->destination);
+        }
+
+        MEM_CONTEXT_PRIOR_BEGIN()
+        {
+            result = protocolParallelJobNew(VARUINT(jobData->cleanIdx), command);
+        }
+        MEM_CONTEXT_PRIOR_END();
+
+        jobData->cleanIdx++;
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN(PROTOCOL_PARALLEL_JOB, result);
+}
+
+// Helper to choose the repo to read a file from. The repo that is expected to finish its running jobs and the file first, based on
+// the throughput observed so far, is chosen. A repo without completed jobs is assumed to have the best throughput observed so far
+// so it will be tried.
+static unsigned int
+restoreJobRepo(const RestoreJobData *const jobData, const String *const fileName, const uint64_t size)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, jobData);
+        FUNCTION_TEST_PARAM(STRING, fileName);
+        FUNCTION_TEST_PARAM(UINT64, size);
+    FUNCTION_TEST_END();
+
+    ASSERT(jobData != NULL);
+    ASSERT(fileName != NULL);
+
+    unsigned int result = 0;
+
+    if (lstSize(jobData->repoList) > 1)
+    {
+        // Find the best throughput in bytes per usec
+        double throughputBest = 1;
+
+        for (unsigned int repoListIdx = 0; repoListIdx < lstSize(jobData->repoList); repoListIdx++)
+        {
+            const RestoreRepo *const repo = lstGet(jobData->repoList, repoListIdx);
+
+            if (repo->timeDone > 0 && (double)repo->sizeDone / (double)repo->timeDone > throughputBest)
+                throughputBest = (double)repo->sizeDone / (double)repo->timeDone;
+        }
+
+        // Choose the repo with the earliest expected finish
+        double finishBest = 0;
+
+        for (unsigned int repoListIdx = 0; repoListIdx < lstSize(jobData->repoList); repoListIdx++)
+        {
+            const RestoreRepo *const repo = lstGet(jobData->repoList, repoListIdx);
+
+            if (repo->disabled || (repo->fileList != NULL && !strLstExists(repo->fileList, fileName)))
+                continue;
+
+            const double throughput =
+                repo->timeDone > 0 && repo->sizeDone > 0 ? (double)repo->sizeDone / (double)repo->timeDone : throughputBest;
+            const double finish = (double)(repo->sizeRunning + size) / throughput;
 
+            if (repoListIdx == 0 || finish < finishBest)
+            {
+                result = repoListIdx;
+                finishBest = finish;
+            }
+        }
+    }
+
+    FUNCTION_TEST_RETURN(UINT, result);
+}
+
+// Helper to get the next restore job
+static ProtocolParallelJob *
+restoreJobFile(RestoreJobData *const jobData, const unsigned int clientIdx)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, jobData);
+        FUNCTION_TEST_PARAM(UINT, clientIdx);
+    FUNCTION_TEST_END();
+
+    ASSERT(jobData != NULL);
+
+    ProtocolParallelJob *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
         // Determine where to begin scanning the queue (we'll stop when we get back here)
         ProtocolCommand *command = protocolCommandNew(PROTOCOL_COMMAND_RESTORE_FILE);
         PackWrite *param = NULL;
         int queueIdx = (int)(clientIdx % lstSize(jobData->queueList));
         int queueEnd = queueIdx;
+        unsigned int repoListIdx = 0;
+        const RestoreRepo *repo = NULL;
+        List *const fileList = lstNewP(sizeof(ManifestFilePack *));
+        uint64_t size = 0;
 
         // Create restore job
         do
@@ -2296,18 +3348,33 @@ static ProtocolParallelJob *restoreJobCallback(void *data, unsigned int clientId
             uint64_t bundleId = 0;
             const String *reference = NULL;
 
-            while (!lstEmpty(queue))
+            // Skip the queue while it is waiting for clean jobs
+            const bool queueWait = jobData->queueCleanTotal != NULL && jobData->queueCleanTotal[queueIdx] > 0;
+
+            while (!queueWait && !lstEmpty(queue))
             {
                 const ManifestFile file = manifestFileUnpack(jobData->manifest, *(ManifestFilePack **)lstGet(queue, 0));
 
-                // Break if bundled files have already been added and 1) the bundleId has changed or 2) the reference has changed
-                if (fileAdded && (bundleId != file.bundleId || !strEq(reference, file.reference)))
+                // A split file that is not zeroed is restored by a job for each part. The parts are read from the backup set repo
+                // and the file stays at the head of the queue until all the parts have been assigned to jobs.
+                const bool split = file.splitSize != 0 && !restoreFileZeroed(file.name, jobData->zeroExp);
+                const unsigned int splitPart = split ? jobData->queueSplitPart[queueIdx] : 0;
+
+                // Break if bundled files have already been added and 1) the bundleId has changed, 2) the reference has changed, or
+                // 3) the file cannot be read from the repo
+                if (fileAdded &&
+                    (bundleId != file.bundleId || !strEq(reference, file.reference) ||
+                     (repo->fileList != NULL && !strLstExists(repo->fileList, file.name))))
+                {
                     break;
+                }
 
                 // Add common parameters before first file
                 if (param == NULL)
                 {
                     param = protocolCommandParam(command);
+                    repoListIdx = split ? 0 : restoreJobRepo(jobData, file.name, file.size);
+                    repo = lstGet(jobData->repoList, repoListIdx);
 
                     const String *const repoPath = strNewFmt(
                         STORAGE_REPO_BACKUP "/%s/",
@@ -2319,6 +3386,30 @@ static ProtocolParallelJob *restoreJobCallback(void *data, unsigned int clientId
                         bundleId = file.bundleId;
                         reference = file.reference;
                     }
+                    // Else if the file is in the dedup store
+                    else if (file.dedup)
+                    {
+                        pckWriteStrP(
+                            param,
+                            strNewFmt(
+                                STORAGE_REPO_BACKUP "/%s",
+                                strZ(
+                                    manifestDedupFile(
+                                        file.checksumSha1, manifestData(jobData->manifest)->backupOptionCompressType))));
+                        fileName = file.name;
+                    }
+                    // Else if the file is split then read the part
+                    else if (split)
+                    {
+                        pckWriteStrP(
+                            param,
+                            strNewFmt(
+                                "%s%s", strZ(repoPath),
+                                strZ(
+                                    manifestSplitFile(
+                                        file.name, splitPart, manifestData(jobData->manifest)->backupOptionCompressType))));
+                        fileName = file.name;
+                    }
                     else
                     {
                         pckWriteStrP(
@@ -2329,18 +3420,41 @@ static ProtocolParallelJob *restoreJobCallback(void *data, unsigned int clientId
                         fileName = file.name;
                     }
 
-                    pckWriteU32P(param, jobData->repoIdx);
+                    pckWriteU32P(param, repo->repoIdx);
                     pckWriteU32P(param, manifestData(jobData->manifest)->backupOptionCompressType);
                     pckWriteTimeP(param, manifestData(jobData->manifest)->backupTimestampCopyStart);
                     pckWriteBoolP(param, cfgOptionBool(cfgOptDelta));
                     pckWriteBoolP(param, cfgOptionBool(cfgOptDelta) && cfgOptionBool(cfgOptForce));
-                    pckWriteStrP(param, jobData->cipherSubPass);
+                    pckWriteBoolP(param, cfgOptionBool(cfgOptRestoreSparse));
+                    pckWriteStrP(param, repo->cipherSubPass);
+
+                    // All files in a bundle are compressed with the dictionary or none are. The dictionary is only sent with the
+                    // first job for each client. After that the client finds the dictionary by id.
+                    if (file.bundleDict)
+                    {
+                        const String *const backupLabel =
+                            file.reference != NULL ? file.reference : manifestData(jobData->manifest)->backupLabel;
+                        const RestoreBundleDict *const bundleDict = lstFind(repo->bundleDictList, &backupLabel);
+                        ASSERT(bundleDict != NULL);
+
+                        const bool send = !lstExists(bundleDict->clientList, &clientIdx);
+
+                        if (send)
+                            lstAdd(bundleDict->clientList, &clientIdx);
+
+                        compressDictPackWrite(
+                            param, manifestData(jobData->manifest)->backupOptionCompressType, bundleDict->dict, send);
+                    }
+                    else
+                        compressDictPackWrite(param, compressTypeNone, NULL, false);
+
+                    pckWriteStrLstP(param, jobData->fanoutPathList);
 
                     fileAdded = true;
                 }
 
                 pckWriteStrP(param, restoreFilePgPath(jobData->manifest, file.name));
-                pckWriteStrP(param, STR(file.checksumSha1));
+                pckWriteStrP(param, split ? manifestSplitChecksum(&file, splitPart) : STR(file.checksumSha1));
                 pckWriteU64P(param, file.size);
                 pckWriteTimeP(param, file.timestamp);
                 pckWriteModeP(param, file.mode);
@@ -2358,9 +3472,28 @@ static ProtocolParallelJob *restoreJobCallback(void *data, unsigned int clientId
                     pckWriteBoolP(param, false);
 
                 pckWriteStrP(param, file.name);
+                pckWriteU64P(param, split ? file.splitSize : 0);
+                pckWriteU32P(param, splitPart);
+
+                // Remove job from the queue unless there are parts left to assign. Parts are not queued again on error since they
+                // are read from the backup set repo.
+                if (split)
+                {
+                    size += manifestSplitSize(&file, splitPart);
+                    jobData->queueSplitPart[queueIdx]++;
 
-                // Remove job from the queue
-                lstRemoveIdx(queue, 0);
+                    if (jobData->queueSplitPart[queueIdx] == manifestSplitTotal(&file))
+                    {
+                        jobData->queueSplitPart[queueIdx] = 0;
+                        lstRemoveIdx(queue, 0);
+                    }
+                }
+                else
+                {
+                    lstAdd(fileList, lstGet(queue, 0));
+                    lstRemoveIdx(queue, 0);
+                    size += file.size;
+                }
 
                 // Break if the file is not bundled
                 if (bundleId == 0)
@@ -2376,6 +3509,23 @@ static ProtocolParallelJob *restoreJobCallback(void *data, unsigned int clientId
                 }
                 MEM_CONTEXT_PRIOR_END();
 
+                // Track the repo of the job when there are multiple repos
+                if (lstSize(jobData->repoList) > 1)
+                {
+                    ((RestoreRepo *)lstGet(jobData->repoList, repoListIdx))->sizeRunning += size;
+
+                    lstAdd(
+                        jobData->jobRepoList,
+                        &(RestoreJobRepo)
+                        {
+                            .job = result,
+                            .repoListIdx = repoListIdx,
+                            .queueIdx = (unsigned int)queueIdx,
+                            .size = size,
+                            .fileList = lstMove(fileList, lstMemContext(jobData->jobRepoList)),
+                        });
+                }
+
                 break;
             }
 
@@ -2388,6 +3538,91 @@ static ProtocolParallelJob *restoreJobCallback(void *data, unsigned int clientId
     FUNCTION_TEST_RETURN(PROTOCOL_PARALLEL_JOB, result);
 }
 
+// Helper to update the repo of a completed restore job. When the job failed on a repo other than the backup set repo the repo is
+// disabled and the files in the job are queued again so they will be read from another repo. Returns true when the files were
+// queued again, in which case the job has been freed.
+static bool
+restoreJobRepoResult(RestoreJobData *const jobData, ProtocolParallelJob *const job)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM_P(VOID, jobData);
+        FUNCTION_LOG_PARAM(PROTOCOL_PARALLEL_JOB, job);
+    FUNCTION_LOG_END();
+
+    ASSERT(jobData != NULL);
+    ASSERT(job != NULL);
+
+    bool result = false;
+
+    if (lstSize(jobData->repoList) > 1)
+    {
+        // Find the repo of the job
+        unsigned int jobRepoIdx = 0;
+
+        while (((RestoreJobRepo *)lstGet(jobData->jobRepoList, jobRepoIdx))->job != job)
+            jobRepoIdx++;
+
+        RestoreJobRepo *const jobRepo = lstGet(jobData->jobRepoList, jobRepoIdx);
+        RestoreRepo *const repo = lstGet(jobData->repoList, jobRepo->repoListIdx);
+
+        repo->sizeRunning -= jobRepo->size;
+
+        // Add the job to the throughput of the repo
+        if (protocolParallelJobErrorCode(job) == 0)
+        {
+            repo->sizeDone += jobRepo->size;
+            repo->timeDone += protocolParallelJobTime(job);
+        }
+        // Else disable the repo and queue the files again unless the job failed on the backup set repo
+        else if (jobRepo->repoListIdx != 0)
+        {
+            if (!repo->disabled)
+            {
+                LOG_WARN_FMT(
+                    "%s: [%s] %s\n"
+                    "HINT: files will no longer be read from this repo.",
+                    cfgOptionGroupName(cfgOptGrpRepo, repo->repoIdx),
+                    errorTypeName(errorTypeFromCode(protocolParallelJobErrorCode(job))),
+                    strZ(protocolParallelJobErrorMessage(job)));
+
+                repo->disabled = true;
+            }
+
+            List *const queue = *(List **)lstGet(jobData->queueList, jobRepo->queueIdx);
+
+            for (unsigned int fileIdx = lstSize(jobRepo->fileList) - 1; (int)fileIdx >= 0; fileIdx--)
+                lstInsert(queue, 0, lstGet(jobRepo->fileList, fileIdx));
+
+            protocolParallelJobFree(job);
+            result = true;
+        }
+
+        lstFree(jobRepo->fileList);
+        lstRemoveIdx(jobData->jobRepoList, jobRepoIdx);
+    }
+
+    FUNCTION_LOG_RETURN(BOOL, result);
+}
+
+// Callback to fetch restore jobs for the parallel executor
+static ProtocolParallelJob *restoreJobCallback(void *data, unsigned int clientIdx)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, data);
+        FUNCTION_TEST_PARAM(UINT, clientIdx);
+    FUNCTION_TEST_END();
+
+    ASSERT(data != NULL);
+
+    RestoreJobData *const jobData = data;
+
+    // Clean paths first since queues cannot be restored until their paths have been cleaned
+    if (jobData->cleanList != NULL && jobData->cleanIdx < lstSize(jobData->cleanList))
+        FUNCTION_TEST_RETURN(PROTOCOL_PARALLEL_JOB, restoreJobClean(jobData));
+
+    FUNCTION_TEST_RETURN(PROTOCOL_PARALLEL_JOB, restoreJobFile(jobData, clientIdx));
+}
+
 /**********************************************************************************************************************************/
 void
 cmdRestore(void)
@@ -2414,22 +3649,30 @@ cmdRestore(void)
         RestoreBackupData backupData = restoreBackupSet();
 
         // Load manifest
-        RestoreJobData jobData = {.repoIdx = backupData.repoIdx};
+        RestoreJobData jobData = {.repoList = lstNewP(sizeof(RestoreRepo)), .jobRepoList = lstNewP(sizeof(RestoreJobRepo))};
+        uint64_t timeBegin = traceBegin();
 
         jobData.manifest = manifestLoadFile(
             storageRepoIdx(backupData.repoIdx),
             strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE, strZ(backupData.backupSet)), backupData.repoCipherType,
             backupData.backupCipherPass);
 
-        // Remotes (if any) are no longer needed since the rest of the repository reads will be done by the local processes
-        protocolFree();
+        traceEndP("manifestLoad", timeBegin);
+
+        // Add the backup set repo with the cipher subpass and dictionaries used to decrypt and decompress files in the backup
+        lstAdd(
+            jobData.repoList,
+            &(RestoreRepo)
+            {
+                .repoIdx = backupData.repoIdx,
+                .cipherSubPass = manifestCipherSubPass(jobData.manifest),
+                .bundleDictList = restoreBundleDictLoad(
+                    jobData.manifest, backupData.repoIdx, backupData.repoCipherType, manifestCipherSubPass(jobData.manifest)),
+            });
 
         // Validate manifest.  Don't use strict mode because we'd rather ignore problems that won't affect a restore.
         manifestValidate(jobData.manifest, false);
 
-        // Get the cipher subpass used to decrypt files in the backup
-        jobData.cipherSubPass = manifestCipherSubPass(jobData.manifest);
-
         // Validate the manifest
         restoreManifestValidate(jobData.manifest, backupData.backupSet);
 
@@ -2450,6 +3693,14 @@ cmdRestore(void)
 
         LOG_INFO(strZ(message));
 
+        // Find other repos to share the restore when requested and the repo was not specified
+        if (cfgOptionBool(cfgOptRepoShare) && !cfgOptionTest(cfgOptRepo))
+            restoreRepoShare(jobData.repoList, jobData.manifest);
+
+        // Remotes (if any) are no longer needed since the rest of the repository reads will be done by the local processes
+        protocolStatCollect();
+        protocolFree();
+
         // Map manifest
         restoreManifestMap(jobData.manifest);
 
@@ -2463,12 +3714,29 @@ cmdRestore(void)
         String *expression = restoreSelectiveExpression(jobData.manifest);
         jobData.zeroExp = expression == NULL ? NULL : regExpNew(expression);
 
-        // Clean the data directory and build path/link structure
-        restoreCleanBuild(jobData.manifest, jobData.rootReplaceUser, jobData.rootReplaceGroup);
+        // Build the path structure of the fan-out paths
+        jobData.fanoutPathList = restoreFanoutBuild(jobData.manifest, jobData.rootReplaceUser, jobData.rootReplaceGroup);
+
+        // Clean the data directory and build path/link structure. With multiple processes the paths of existing targets are cleaned
+        // in parallel by jobs that run before the restore jobs of their queue.
+        timeBegin = traceBegin();
+        jobData.cleanList = restoreCleanBuild(
+            jobData.manifest, jobData.rootReplaceUser, jobData.rootReplaceGroup, cfgOptionUInt(cfgOptProcessMax) > 1);
+        traceEndP("restoreCleanBuild", timeBegin);
 
         // Generate processing queues
         uint64_t sizeTotal = restoreProcessQueue(jobData.manifest, &jobData.queueList);
 
+        // Build path/link structure for queues that do not wait for clean jobs
+        if (jobData.cleanList != NULL)
+            restoreJobCleanInit(&jobData);
+
+        // No split file parts have been assigned to jobs yet
+        jobData.queueSplitPart = memNew(sizeof(unsigned int) * lstSize(jobData.queueList));
+
+        for (unsigned int queueIdx = 0; queueIdx < lstSize(jobData.queueList); queueIdx++)
+            jobData.queueSplitPart[queueIdx] = 0;
+
         // Save manifest to the data directory so we can restart a delta restore even if the PG_VERSION file is missing
         manifestSave(jobData.manifest, storageWriteIo(storageNewWriteP(storagePgWrite(), BACKUP_MANIFEST_FILE_STR)));
 
@@ -2479,8 +3747,28 @@ cmdRestore(void)
         for (unsigned int processIdx = 1; processIdx <= cfgOptionUInt(cfgOptProcessMax); processIdx++)
             protocolParallelClientAdd(parallelExec, protocolLocalGet(protocolStorageTypeRepo, 0, processIdx));
 
+        // Processes wait for restore jobs while the paths of their queues are being cleaned or while files may still be queued
+        // again after a job fails on a shared repo
+        if (jobData.cleanList != NULL || lstSize(jobData.repoList) > 1)
+            protocolParallelWait(parallelExec);
+
+        // Adapt the number of processes to the latency when process-min is set
+        if (cfgOptionTest(cfgOptProcessMin))
+        {
+            protocolParallelAdapt(
+                parallelExec, cfgOptionUInt(cfgOptProcessMin),
+                cfgOptionTest(cfgOptProcessLatencyTarget) ? cfgOptionUInt64(cfgOptProcessLatencyTarget) : 0);
+        }
+
         // Process jobs
         uint64_t sizeRestored = 0;
+        timeBegin = traceBegin();
+
+        // Progress is logged at the restore-progress interval when files have been restored since the last progress message
+        const TimeMSec progressInterval = cfgOptionUInt64(cfgOptRestoreProgress);
+        const TimeMSec progressBegin = timeMSec();
+        TimeMSec progressLast = progressBegin;
+        uint64_t progressSizeLast = 0;
 
         MEM_CONTEXT_TEMP_RESET_BEGIN()
         {
@@ -2490,8 +3778,34 @@ cmdRestore(void)
 
                 for (unsigned int jobIdx = 0; jobIdx < completed; jobIdx++)
                 {
-                    sizeRestored = restoreJobResult(
-                        jobData.manifest, protocolParallelResult(parallelExec), jobData.zeroExp, sizeTotal, sizeRestored);
+                    ProtocolParallelJob *const job = protocolParallelResult(parallelExec);
+
+                    // Build path/link structure for queues that are no longer waiting for clean jobs
+                    if (protocolCommandId(protocolParallelJobCommand(job)) == PROTOCOL_COMMAND_RESTORE_CLEAN)
+                        restoreJobCleanResult(&jobData, job);
+                    // Else log the restored files unless they were queued again to be read from another repo
+                    else if (!restoreJobRepoResult(&jobData, job))
+                    {
+                        const uint64_t jobTime = protocolParallelJobTime(job);
+                        const uint64_t sizeRestoredPrior = sizeRestored;
+
+                        sizeRestored = restoreJobResult(jobData.manifest, job, jobData.zeroExp, sizeTotal, sizeRestored);
+                        protocolParallelSample(parallelExec, sizeRestored - sizeRestoredPrior, jobTime);
+                    }
+                }
+
+                // Log progress
+                if (sizeRestored != progressSizeLast && sizeRestored < sizeTotal)
+                {
+                    const TimeMSec progressTime = timeMSec();
+
+                    if (progressTime - progressLast >= progressInterval)
+                    {
+                        restoreProgress(sizeTotal, sizeRestored, progressTime - progressBegin);
+
+                        progressLast = progressTime;
+                        progressSizeLast = sizeRestored;
+                    }
                 }
 
                 // Reset the memory context occasionally so we don't use too much memory or slow down processing
@@ -2501,6 +3815,8 @@ cmdRestore(void)
         }
         MEM_CONTEXT_TEMP_END();
 
+        traceEndP("restoreProcess", timeBegin);
+
         // Write recovery settings
         restoreRecoveryWrite(jobData.manifest);
 
@@ -2570,6 +3886,10 @@ cmdRestore(void)
         LOG_DETAIL_FMT("sync path '%s'", strZ(storagePathP(storagePg(), PG_PATH_GLOBAL_STR)));
         storagePathSyncP(storagePgWrite(), PG_PATH_GLOBAL_STR);
 
+        // Finish fan-out paths
+        if (jobData.fanoutPathList != NULL)
+            restoreFanoutFinish(jobData.manifest, jobData.fanoutPathList);
+
         // Restore info
         LOG_INFO_FMT(
             "restore size = %s, file total = %u", strZ(strSizeFormat(sizeRestored)), manifestFileTotal(jobData.manifest));
@@ -3,7 +3,11 @@ Server Command
 ***********************************************************************************************************************************/
 #include "build.auto.h"
 
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/wait.h>
+#include <unistd.h>
 
 #include "command/exit.h"
 #include "command/remote/remote.h"
@@ -12,9 +16,11 @@ Server Command
 #include "common/fork.h"
 #include "common/io/socket/server.h"
 #include "common/io/tls/server.h"
+#include "common/lock.h"
 #include "config/config.h"
 #include "config/load.h"
 #include "protocol/helper.h"
+#include "storage/helper.h"
 
 /***********************************************************************************************************************************
 Local variables
@@ -26,7 +32,12 @@ static struct ServerLocal
     unsigned int argListSize;                                       // Argument list size
     const char **argList;                                           // Argument list
 
-    List *processList;                                              // List of child processes
+    List *processList;                                              // List of worker processes
+    int notifyPipe[2];                                              // Pipe used to notify the server of worker/signal activity
+    volatile unsigned int *generation;                              // Configuration generation shared with workers
+
+    const String *address;                                          // Address the socket server is listening on
+    unsigned int port;                                              // Port the socket server is listening on
 
     bool sigHup;                                                    // SIGHUP was caught
     bool sigTerm;                                                   // SIGTERM was caught
@@ -35,6 +46,13 @@ static struct ServerLocal
     IoServer *tlsServer;                                            // TLS server
 } serverLocal;
 
+// Worker process
+typedef struct ServerProcess
+{
+    pid_t pid;                                                      // Process id
+    bool idle;                                                      // Is the worker waiting for a connection?
+} ServerProcess;
+
 /***********************************************************************************************************************************
 Initialization can be redone when options change
 ***********************************************************************************************************************************/
@@ -49,22 +67,47 @@ cmdServerInit(void)
             MEM_CONTEXT_NEW_BEGIN(Server, .childQty = MEM_CONTEXT_QTY_MAX)
             {
                 serverLocal.memContext = MEM_CONTEXT_NEW();
-                serverLocal.processList = lstNewP(sizeof(pid_t));
+                serverLocal.processList = lstNewP(sizeof(ServerProcess));
             }
             MEM_CONTEXT_NEW_END();
         }
         MEM_CONTEXT_END();
+
+        THROW_ON_SYS_ERROR(pipe(serverLocal.notifyPipe) == -1, KernelError, "unable to create notify pipe");
+
+        // The generation is incremented on reload so workers know not to accept more connections with the prior configuration
+        const int fd = open("/dev/zero", O_RDWR);
+        THROW_ON_SYS_ERROR(fd == -1, KernelError, "unable to open '/dev/zero'");
+
+        void *const generation = mmap(NULL, sizeof(unsigned int), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+
+        THROW_ON_SYS_ERROR(generation == MAP_FAILED, KernelError, "unable to map generation");
+
+        serverLocal.generation = generation;
     }
 
     MEM_CONTEXT_BEGIN(serverLocal.memContext)
     {
-        // Free old servers
-        ioServerFree(serverLocal.socketServer);
+        // Free old TLS server
         ioServerFree(serverLocal.tlsServer);
 
-        // Create new servers
-        serverLocal.socketServer = sckServerNew(
-            cfgOptionStr(cfgOptTlsServerAddress), cfgOptionUInt(cfgOptTlsServerPort), cfgOptionUInt64(cfgOptProtocolTimeout));
+        // Create a new socket server if the address or port changed. Otherwise the socket is kept since workers processing a
+        // connection hold it open and a new socket could not be bound to the same address and port.
+        if (serverLocal.socketServer == NULL || !strEq(serverLocal.address, cfgOptionStr(cfgOptTlsServerAddress)) ||
+            serverLocal.port != cfgOptionUInt(cfgOptTlsServerPort))
+        {
+            ioServerFree(serverLocal.socketServer);
+            strFree((String *)serverLocal.address);
+
+            serverLocal.address = strDup(cfgOptionStr(cfgOptTlsServerAddress));
+            serverLocal.port = cfgOptionUInt(cfgOptTlsServerPort);
+            serverLocal.socketServer = sckServerNew(serverLocal.address, serverLocal.port, cfgOptionUInt64(cfgOptProtocolTimeout));
+        }
+        else
+            sckServerTimeoutSet(serverLocal.socketServer, cfgOptionUInt64(cfgOptProtocolTimeout));
+
+        // Create new TLS server
         serverLocal.tlsServer = tlsServerNew(
             cfgOptionStr(cfgOptTlsServerAddress), cfgOptionStr(cfgOptTlsServerCaFile), cfgOptionStr(cfgOptTlsServerKeyFile),
             cfgOptionStr(cfgOptTlsServerCertFile), cfgOptionUInt64(cfgOptProtocolTimeout));
@@ -72,6 +115,24 @@ cmdServerInit(void)
     MEM_CONTEXT_END();
 }
 
+/***********************************************************************************************************************************
+Notify the server that a worker has accepted a connection (pid > 0), that a worker is waiting for a connection again (pid < 0), or
+that a signal was caught (pid == 0). This ensures the server is not left waiting when a signal arrives just before it starts
+waiting. Only async-signal-safe functions may be called here.
+***********************************************************************************************************************************/
+static void
+cmdServerNotify(const pid_t pid)
+{
+    // Preserve errno since this may be called from a signal handler
+    const int errNo = errno;
+
+    // There is nothing useful to do on error since the server will be woken by the next notification
+    const ssize_t result = write(serverLocal.notifyPipe[1], &pid, sizeof(pid));
+    (void)result;
+
+    errno = errNo;
+}
+
 /***********************************************************************************************************************************
 Handlers to set flags on signals
 ***********************************************************************************************************************************/
@@ -80,6 +141,8 @@ cmdServerSigHup(const int signalType)
 {
     (void)signalType;
     serverLocal.sigHup = true;
+
+    cmdServerNotify(0);
 }
 
 static void
@@ -87,10 +150,12 @@ cmdServerSigTerm(const int signalType)
 {
     (void)signalType;
     serverLocal.sigTerm = true;
+
+    cmdServerNotify(0);
 }
 
 /***********************************************************************************************************************************
-Handler to reap child processes
+Handler to reap worker processes
 ***********************************************************************************************************************************/
 static void
 cmdServerSigChild(const int signalType, siginfo_t *signalInfo, void *context)
@@ -98,14 +163,192 @@ cmdServerSigChild(const int signalType, siginfo_t *signalInfo, void *context)
     (void)signalType;
     (void)context;
 
-    ASSERT(signalInfo->si_code == CLD_EXITED);
+    // Idle workers are terminated by signal when the configuration is reloaded
+    ASSERT(signalInfo->si_code == CLD_EXITED || signalInfo->si_code == CLD_KILLED);
 
     // Find the process and remove it
     for (unsigned int processIdx = 0; processIdx < lstSize(serverLocal.processList); processIdx++)
     {
-        if (*(int *)lstGet(serverLocal.processList, processIdx) == signalInfo->si_pid)
+        if (((ServerProcess *)lstGet(serverLocal.processList, processIdx))->pid == signalInfo->si_pid)
             lstRemoveIdx(serverLocal.processList, processIdx);
     }
+
+    cmdServerNotify(0);
+}
+
+/***********************************************************************************************************************************
+Get the number of idle workers
+***********************************************************************************************************************************/
+static unsigned int
+cmdServerIdleTotal(void)
+{
+    FUNCTION_TEST_VOID();
+
+    unsigned int result = 0;
+
+    for (unsigned int processIdx = 0; processIdx < lstSize(serverLocal.processList); processIdx++)
+    {
+        if (((ServerProcess *)lstGet(serverLocal.processList, processIdx))->idle)
+            result++;
+    }
+
+    FUNCTION_TEST_RETURN(UINT, result);
+}
+
+/***********************************************************************************************************************************
+Wait for a connection in a worker and return the socket session
+***********************************************************************************************************************************/
+static IoSession *
+cmdServerWorkerAccept(void)
+{
+    FUNCTION_LOG_VOID(logLevelDebug);
+
+    IoSession *result = NULL;
+
+    // The worker has no state to clean up before a connection is accepted so it can be terminated by any signal
+    sigaction(SIGHUP, &(struct sigaction){.sa_handler = SIG_DFL}, NULL);
+    sigaction(SIGTERM, &(struct sigaction){.sa_handler = SIG_DFL}, NULL);
+
+    // Disable logging and close log file
+    logClose();
+
+    // Wait for a connection
+    do
+    {
+        result = ioServerAccept(serverLocal.socketServer, NULL);
+    }
+    while (result == NULL);
+
+    // Set standard signal handlers. SIGHUP is sent to all workers on reload and is ignored while processing a connection.
+    exitInit();
+    signal(SIGHUP, SIG_IGN);
+
+    // Notify the server that this worker is no longer idle
+    cmdServerNotify(getpid());
+
+    FUNCTION_LOG_RETURN(IO_SESSION, result);
+}
+
+/***********************************************************************************************************************************
+Start a worker that waits for a connection. Workers are started before connections arrive so a large number of clients connecting at
+the same time do not need to wait for the server to fork a process for each connection. The socket session is returned in the worker
+and NULL is returned in the server.
+***********************************************************************************************************************************/
+static IoSession *
+cmdServerWorkerStart(void)
+{
+    FUNCTION_LOG_VOID(logLevelDebug);
+
+    IoSession *result = NULL;
+    const pid_t pid = forkSafe();
+
+    if (pid == 0)
+    {
+        // Reset SIGCHLD to default
+        sigaction(SIGCHLD, &(struct sigaction){.sa_handler = SIG_DFL}, NULL);
+
+        // Wait for a connection
+        result = cmdServerWorkerAccept();
+    }
+    // Add worker to list
+    else
+        lstAdd(serverLocal.processList, &(ServerProcess){.pid = pid, .idle = true});
+
+    FUNCTION_LOG_RETURN(IO_SESSION, result);
+}
+
+/***********************************************************************************************************************************
+Process connections in a worker. After a connection is complete the worker restores the server configuration and waits for another
+connection so the cost of starting a process is shared by multiple connections. The worker exits when it has processed the number
+of connections allowed by tls-server-worker-reuse, when the configuration has been reloaded, or when the server has exited. Returns
+the number of connections processed.
+***********************************************************************************************************************************/
+static unsigned int
+cmdServerWorker(IoSession *socketSession)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(IO_SESSION, socketSession);
+    FUNCTION_LOG_END();
+
+    ASSERT(socketSession != NULL);
+
+    unsigned int result = 0;
+
+    // Get limits before the client configuration is loaded
+    const unsigned int generation = *serverLocal.generation;
+    const unsigned int connectionMax = cfgOptionUInt(cfgOptTlsServerWorkerReuse);
+    const pid_t serverPid = getppid();
+
+    do
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            ioSessionMove(socketSession, memContextCurrent());
+
+            // Start standard remote processing if a server is returned
+            ProtocolServer *const server = protocolServer(serverLocal.tlsServer, socketSession);
+
+            if (server != NULL)
+                cmdRemote(server);
+        }
+        MEM_CONTEXT_TEMP_END();
+
+        socketSession = NULL;
+        result++;
+
+        if (result < connectionMax)
+        {
+            // Release state created for the client configuration
+            lockRelease(false);
+            protocolFree();
+            storageHelperFree();
+
+            // Restore the server configuration
+            cfgLoad(serverLocal.argListSize, serverLocal.argList);
+
+            // Allow SIGHUP to terminate the worker before the server is notified that it is idle. A SIGHUP that arrived earlier was
+            // ignored, but in that case the generation has changed and the worker exits instead of waiting for a connection.
+            sigaction(SIGHUP, &(struct sigaction){.sa_handler = SIG_DFL}, NULL);
+            cmdServerNotify(-getpid());
+
+            if (generation == *serverLocal.generation && getppid() == serverPid)
+                socketSession = cmdServerWorkerAccept();
+        }
+    }
+    while (socketSession != NULL);
+
+    FUNCTION_LOG_RETURN(UINT, result);
+}
+
+/***********************************************************************************************************************************
+Wait until a worker accepts a connection or a signal is caught
+***********************************************************************************************************************************/
+static void
+cmdServerWait(void)
+{
+    FUNCTION_LOG_VOID(logLevelTrace);
+
+    pid_t pid;
+    const ssize_t size = read(serverLocal.notifyPipe[0], &pid, sizeof(pid));
+
+    // Signals may interrupt the read without a notification
+    if (size == -1)
+        THROW_ON_SYS_ERROR(errno != EINTR, KernelError, "unable to read notify pipe");
+    // Else update the idle status of the worker (pid is zero when the notification was sent by a signal handler)
+    else
+    {
+        CHECK(AssertError, size == sizeof(pid), "invalid notification size");
+
+        for (unsigned int processIdx = 0; processIdx < lstSize(serverLocal.processList); processIdx++)
+        {
+            ServerProcess *const process = lstGet(serverLocal.processList, processIdx);
+
+            if (process->pid == pid || process->pid == -pid)
+                process->idle = pid < 0;
+        }
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
 }
 
 /**********************************************************************************************************************************/
@@ -136,49 +379,40 @@ cmdServer(const unsigned int argListSize, const char *argList[])
         // Accept connections indefinitely. The only way to exit this loop is for the process to receive a signal.
         do
         {
-            // Accept a new connection
-            IoSession *const socketSession = ioServerAccept(serverLocal.socketServer, NULL);
+            // Start workers until there are enough idle workers to accept new connections
+            IoSession *socketSession = NULL;
 
+            while (socketSession == NULL && cmdServerIdleTotal() < cfgOptionUInt(cfgOptTlsServerWorker))
+                socketSession = cmdServerWorkerStart();
+
+            // If this is a worker that has accepted a connection
             if (socketSession != NULL)
             {
-                // Fork off the child process
-                pid_t pid = forkSafe();
-
-                if (pid == 0)
-                {
-                    // Reset SIGCHLD to default
-                    sigaction(SIGCHLD, &(struct sigaction){.sa_handler = SIG_DFL}, NULL);
-
-                    // Set standard signal handlers
-                    exitInit();
-
-                    // Close the server socket so we don't hold the port open if the parent exits first
-                    ioServerFree(serverLocal.socketServer);
-
-                    // Disable logging and close log file
-                    logClose();
-
-                    // Start standard remote processing if a server is returned
-                    ProtocolServer *server = protocolServer(serverLocal.tlsServer, socketSession);
-
-                    if (server != NULL)
-                        cmdRemote(server);
-
-                    break;
-                }
-                // Add process to list
-                else
-                    lstAdd(serverLocal.processList, &pid);
-
-                // Free the socket since the child is now using it
-                ioSessionFree(socketSession);
+                cmdServerWorker(socketSession);
+                break;
             }
 
+            // Wait for a worker to accept a connection
+            cmdServerWait();
+
             // Reload configuration
             if (serverLocal.sigHup)
             {
                 LOG_DETAIL("configuration reload begin");
 
+                // Workers that finish a connection after this will exit rather than wait for another connection
+                (*serverLocal.generation)++;
+
+                // Terminate idle workers since they are using the prior configuration. Workers processing a connection ignore
+                // SIGHUP, but a worker that has just finished a connection may already be idle even though the notification has not
+                // been read yet.
+                for (unsigned int processIdx = 0; processIdx < lstSize(serverLocal.processList); processIdx++)
+                    kill(((const ServerProcess *)lstGet(serverLocal.processList, processIdx))->pid, SIGHUP);
+
+                // Wait for idle workers to exit so they are not counted as idle when new workers are started
+                while (cmdServerIdleTotal() > 0)
+                    cmdServerWait();
+
                 // Reload configuration
                 cfgLoad(serverLocal.argListSize, serverLocal.argList);
 
@@ -195,17 +429,20 @@ cmdServer(const unsigned int argListSize, const char *argList[])
     }
     MEM_CONTEXT_TEMP_END();
 
-    // Terminate any remaining children on SIGTERM. Disable the callback so it does not fire in the middle of the loop.
+    // Terminate any remaining workers on SIGTERM. Disable the callback so it does not fire in the middle of the loop.
     if (serverLocal.sigTerm)
     {
         sigaction(SIGCHLD, &(struct sigaction){.sa_flags = SA_NOCLDSTOP | SA_NOCLDWAIT}, NULL);
 
         for (unsigned int processIdx = 0; processIdx < lstSize(serverLocal.processList); processIdx++)
         {
-            pid_t pid = *(int *)lstGet(serverLocal.processList, processIdx);
+            const ServerProcess *const process = lstGet(serverLocal.processList, processIdx);
+
+            // Only warn for workers that are processing a connection
+            if (!process->idle)
+                LOG_WARN_FMT("terminate child process %d", process->pid);
 
-            LOG_WARN_FMT("terminate child process %d", pid);
-            kill(pid, SIGTERM);
+            kill(process->pid, SIGTERM);
         }
     }
 
@@ -18,7 +18,7 @@ Verify File
 VerifyResult
 verifyFile(
     const String *const filePathName, const uint64_t offset, const Variant *const limit, const CompressType compressType,
-    const String *const fileChecksum, const uint64_t fileSize, const String *const cipherPass)
+    const String *const fileChecksum, const uint64_t fileSize, const String *const cipherPass, const Buffer *const compressDict)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(STRING, filePathName);                   // Fully qualified file name
@@ -28,11 +28,13 @@ verifyFile(
         FUNCTION_LOG_PARAM(STRING, fileChecksum);                   // Checksum for the file
         FUNCTION_LOG_PARAM(UINT64, fileSize);                       // Size of file
         FUNCTION_TEST_PARAM(STRING, cipherPass);                    // Password to access the repo file if encrypted
+        FUNCTION_LOG_PARAM(BUFFER, compressDict);                   // Dictionary used to compress the file
     FUNCTION_LOG_END();
 
     ASSERT(filePathName != NULL);
     ASSERT(fileChecksum != NULL);
     ASSERT(limit == NULL || varType(limit) == varTypeUInt64);
+    ASSERT(compressDict == NULL || compressType != compressTypeNone);
 
     // Is the file valid?
     VerifyResult result = verifyOk;
@@ -50,7 +52,11 @@ verifyFile(
 
         // Add decompression filter
         if (compressType != compressTypeNone)
-            ioFilterGroupAdd(filterGroup, decompressFilter(compressType));
+        {
+            ioFilterGroupAdd(
+                filterGroup,
+                compressDict != NULL ? decompressFilterDict(compressType, compressDict) : decompressFilter(compressType));
+        }
 
         // Add sha1 filter
         ioFilterGroupAdd(filterGroup, cryptoHashNew(hashTypeSha1));
@@ -80,3 +86,73 @@ verifyFile(
 
     FUNCTION_LOG_RETURN_STRUCT(result);
 }
+
+/***********************************************************************************************************************************
+Check the info reported by the repo storage for a file
+***********************************************************************************************************************************/
+static VerifyResult
+verifyFileRepoInfo(
+    const StorageInfo *const info, const bool bundle, const uint64_t offset, const uint64_t sizeRepo,
+    const String *const checksumRepo)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STORAGE_INFO, info);
+        FUNCTION_TEST_PARAM(BOOL, bundle);
+        FUNCTION_TEST_PARAM(UINT64, offset);
+        FUNCTION_TEST_PARAM(UINT64, sizeRepo);
+        FUNCTION_TEST_PARAM(STRING, checksumRepo);
+    FUNCTION_TEST_END();
+
+    ASSERT(info != NULL);
+    ASSERT(bundle || offset == 0);
+
+    VerifyResult result = verifyOk;
+
+    if (!info->exists)
+    {
+        result = verifyFileMissing;
+    }
+    // Bundled files must fit in the bundle, else the file must be exactly the expected size
+    else if (bundle ? offset + sizeRepo > info->size : sizeRepo != info->size)
+    {
+        result = verifySizeInvalid;
+    }
+    // Compare the checksum when the storage reports one for a repo file that holds only this file
+    else if (
+        checksumRepo != NULL && info->checksum != NULL && info->size == sizeRepo && !strEq(checksumRepo, info->checksum))
+    {
+        result = verifyChecksumMismatch;
+    }
+
+    FUNCTION_TEST_RETURN(ENUM, result);
+}
+
+/**********************************************************************************************************************************/
+VerifyResult
+verifyFileRepo(
+    const String *const filePathName, const bool bundle, const uint64_t offset, const uint64_t sizeRepo,
+    const String *const checksumRepo)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STRING, filePathName);                   // Fully qualified file name
+        FUNCTION_LOG_PARAM(BOOL, bundle);                           // Is the file in a bundle?
+        FUNCTION_LOG_PARAM(UINT64, offset);                         // Offset of the file in the bundle
+        FUNCTION_LOG_PARAM(UINT64, sizeRepo);                       // Size of the file in the repo
+        FUNCTION_LOG_PARAM(STRING, checksumRepo);                   // MD5 checksum of the file in the repo
+    FUNCTION_LOG_END();
+
+    ASSERT(filePathName != NULL);
+
+    VerifyResult result;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const StorageInfo info = storageInfoP(
+            storageRepo(), filePathName, .ignoreMissing = true, .checksum = checksumRepo != NULL);
+
+        result = verifyFileRepoInfo(&info, bundle, offset, sizeRepo, checksumRepo);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_STRUCT(result);
+}
@@ -25,6 +25,12 @@ Functions
 // Verify a file in the pgBackRest repository
 VerifyResult verifyFile(
     const String *filePathName, uint64_t offset, const Variant *limit, CompressType compressType, const String *fileChecksum,
-    uint64_t fileSize, const String *cipherPass);
+    uint64_t fileSize, const String *cipherPass, const Buffer *compressDict);
+
+// Verify a file in the pgBackRest repository using only the info reported by the repo storage, i.e. without reading the file. The
+// file (or the range in the bundle when bundled) must be sizeRepo bytes. The MD5 checksum of the stored bytes is compared when it
+// was recorded at backup and the repo storage reports it.
+VerifyResult verifyFileRepo(
+    const String *filePathName, bool bundle, uint64_t offset, uint64_t sizeRepo, const String *checksumRepo);
 
 #endif
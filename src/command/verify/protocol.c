@@ -42,8 +42,20 @@ verifyFileProtocol(PackRead *const param, ProtocolServer *const server)
         const String *const fileChecksum = pckReadStrP(param);
         const uint64_t fileSize = pckReadU64P(param);
         const String *const cipherPass = pckReadStrP(param);
+        const Buffer *const compressDict = compressDictPackRead(param);
+        VerifyResult result;
 
-        const VerifyResult result = verifyFile(filePathName, offset, limit, compressType, fileChecksum, fileSize, cipherPass);
+        // Check the file with the repo storage info only
+        if (pckReadBoolP(param))
+        {
+            const uint64_t sizeRepo = pckReadU64P(param);
+            const String *const checksumRepo = pckReadStrP(param);
+
+            result = verifyFileRepo(filePathName, limit != NULL, offset, sizeRepo, checksumRepo);
+        }
+        // Else read the file
+        else
+            result = verifyFile(filePathName, offset, limit, compressType, fileChecksum, fileSize, cipherPass, compressDict);
 
         // Return result
         protocolServerDataPut(server, pckWriteU32P(protocolPackNew(), result));
@@ -7,6 +7,7 @@ Verify contents of the repository.
 
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "command/archive/common.h"
@@ -20,7 +21,9 @@ Verify contents of the repository.
 #include "common/io/fdWrite.h"
 #include "common/io/io.h"
 #include "common/log.h"
+#include "common/type/json.h"
 #include "config/config.h"
+#include "info/info.h"
 #include "info/infoArchive.h"
 #include "info/infoBackup.h"
 #include "info/manifest.h"
@@ -36,6 +39,17 @@ Constants
 #define VERIFY_STATUS_OK                                            "ok"
 #define VERIFY_STATUS_ERROR                                         "error"
 
+// State recorded by incremental verify
+#define VERIFY_STATE_FILE                                           "verify.state"
+#define VERIFY_STATE_PATH_FILE                                      STORAGE_REPO_BACKUP "/" VERIFY_STATE_FILE
+
+#define VERIFY_STATE_SECTION_ARCHIVE                                "archive"
+#define VERIFY_STATE_SECTION_BACKUP                                 "backup"
+
+#define VERIFY_STATE_KEY_CHECKSUM                                   "checksum"
+#define VERIFY_STATE_KEY_STOP                                       "stop"
+#define VERIFY_STATE_KEY_TIME                                       "time"
+
 /***********************************************************************************************************************************
 Data Types and Structures
 ***********************************************************************************************************************************/
@@ -107,6 +121,7 @@ typedef struct VerifyBackupResult
     String *archiveStart;                                           // First WAL segment in the backup
     String *archiveStop;                                            // Last WAL segment in the backup
     List *invalidFileList;                                          // List of invalid files found in the backup
+    String *manifestChecksum;                                       // Checksum of the manifest used to verify the backup
 } VerifyBackupResult;
 
 // Job data stucture for processing and results collection
@@ -119,6 +134,7 @@ typedef struct VerifyJobData
     StringList *backupList;                                         // List of backups to verify
     Manifest *manifest;                                             // Manifest contents with list of files to verify
     unsigned int manifestFileIdx;                                   // Index of the file within the manifest file list to process
+    unsigned int manifestFilePart;                                  // Part of the split file to process
     String *currentBackup;                                          // In progress backup, if any
     const InfoPg *pgHistory;                                        // Database history list
     bool backupProcessing;                                          // Are we processing WAL or are we processing backups
@@ -128,8 +144,41 @@ typedef struct VerifyJobData
     unsigned int jobErrorTotal;                                     // Total errors that occurred during the job execution
     List *archiveIdResultList;                                      // Archive results
     List *backupResultList;                                         // Backup results
+    List *bundleDictList;                                           // Dictionaries used to compress bundled files
+    bool fast;                                                      // Verify backup files with repo storage info only?
+    time_t timeBegin;                                               // When did verification begin?
+    List *stateBackupList;                                          // Backups verified by prior runs (NULL if not incremental)
+    List *stateWalList;                                             // WAL ranges verified by prior runs (NULL if not incremental)
 } VerifyJobData;
 
+// Dictionary used to compress bundled files in a backup
+typedef struct VerifyBundleDict
+{
+    const String *backupLabel;                                      // Backup where the dictionary is stored (must be first member)
+    const Buffer *dict;                                             // Dictionary (NULL if missing)
+    List *clientList;                                               // Clients the dictionary has been sent to
+} VerifyBundleDict;
+
+// Backup verified by a prior incremental run
+typedef struct VerifyStateBackup
+{
+    const String *backupLabel;                                      // Backup label (must be first member)
+    const String *checksum;                                         // Checksum of the manifest when the backup was verified
+    time_t time;                                                    // When were the files stored in the backup verified?
+    bool sample;                                                    // Selected to be verified again?
+    bool skip;                                                      // Skip verification of files stored in the backup?
+} VerifyStateBackup;
+
+// WAL range verified by a prior incremental run
+typedef struct VerifyStateWal
+{
+    const String *archiveId;                                        // Archive id of the range
+    const String *start;                                            // First WAL segment in the range
+    const String *stop;                                             // Last WAL segment in the range
+    time_t time;                                                    // When was the WAL in the range verified?
+    bool skip;                                                      // Skip verification of WAL in the range?
+} VerifyStateWal;
+
 /***********************************************************************************************************************************
 Helper function to add a file to an invalid file list
 ***********************************************************************************************************************************/
@@ -189,6 +238,447 @@ verifyFileLoad(const String *pathFileName, const String *cipherPass)
     FUNCTION_TEST_RETURN(STORAGE_READ, result);
 }
 
+/***********************************************************************************************************************************
+Write the dictionary used to compress bundled files in a backup to a job param. Dictionaries are cached since they are shared by all
+bundled files in the backup and in backups that reference it. A dictionary is only sent with the first job for each client, after
+that the client finds the dictionary by id. When the dictionary is missing NULL is written so the files fail verification.
+***********************************************************************************************************************************/
+static void
+verifyBundleDictPackWrite(
+    PackWrite *const param, VerifyJobData *const jobData, const String *const backupLabel, const unsigned int clientIdx)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(PACK_WRITE, param);
+        FUNCTION_TEST_PARAM_P(VOID, jobData);
+        FUNCTION_TEST_PARAM(STRING, backupLabel);
+        FUNCTION_TEST_PARAM(UINT, clientIdx);
+    FUNCTION_TEST_END();
+
+    ASSERT(param != NULL);
+    ASSERT(jobData != NULL);
+    ASSERT(backupLabel != NULL);
+
+    VerifyBundleDict *bundleDict = lstFind(jobData->bundleDictList, &backupLabel);
+
+    if (bundleDict == NULL)
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            StorageRead *const read = storageNewReadP(
+                storageRepo(), strNewFmt(STORAGE_REPO_BACKUP "/%s/" MANIFEST_FILE_BUNDLE_DICT, strZ(backupLabel)),
+                .ignoreMissing = true);
+            cipherBlockFilterGroupAdd(
+                ioReadFilterGroup(storageReadIo(read)), cfgOptionStrId(cfgOptRepoCipherType), cipherModeDecrypt,
+                jobData->backupCipherPass);
+
+            Buffer *const dict = storageGetP(read);
+
+            MEM_CONTEXT_BEGIN(lstMemContext(jobData->bundleDictList))
+            {
+                bundleDict = lstAdd(
+                    jobData->bundleDictList,
+                    &(VerifyBundleDict){
+                        .backupLabel = strDup(backupLabel), .dict = bufMove(dict, memContextCurrent()),
+                        .clientList = lstNewP(sizeof(unsigned int), .comparator = lstComparatorUInt)});
+            }
+            MEM_CONTEXT_END();
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    const bool send = !lstExists(bundleDict->clientList, &clientIdx);
+
+    if (send)
+        lstAdd(bundleDict->clientList, &clientIdx);
+
+    compressDictPackWrite(param, manifestData(jobData->manifest)->backupOptionCompressType, bundleDict->dict, send);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Comparators used to select the objects verified the longest time ago
+***********************************************************************************************************************************/
+static int
+verifyStateBackupTimeComparator(const void *const item1, const void *const item2)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, item1);
+        FUNCTION_TEST_PARAM_P(VOID, item2);
+    FUNCTION_TEST_END();
+
+    ASSERT(item1 != NULL);
+    ASSERT(item2 != NULL);
+
+    const VerifyStateBackup *const stateBackup1 = item1;
+    const VerifyStateBackup *const stateBackup2 = item2;
+
+    if (stateBackup1->time != stateBackup2->time)
+        FUNCTION_TEST_RETURN(INT, stateBackup1->time < stateBackup2->time ? -1 : 1);
+
+    FUNCTION_TEST_RETURN(INT, strCmp(stateBackup1->backupLabel, stateBackup2->backupLabel));
+}
+
+static int
+verifyStateWalTimeComparator(const void *const item1, const void *const item2)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, item1);
+        FUNCTION_TEST_PARAM_P(VOID, item2);
+    FUNCTION_TEST_END();
+
+    ASSERT(item1 != NULL);
+    ASSERT(item2 != NULL);
+
+    const VerifyStateWal *const stateWal1 = item1;
+    const VerifyStateWal *const stateWal2 = item2;
+
+    if (stateWal1->time != stateWal2->time)
+        FUNCTION_TEST_RETURN(INT, stateWal1->time < stateWal2->time ? -1 : 1);
+
+    FUNCTION_TEST_RETURN(INT, strCmp(stateWal1->start, stateWal2->start));
+}
+
+/***********************************************************************************************************************************
+Load the state recorded by prior incremental runs
+
+The state is only used to skip objects that were verified before so when it is missing or cannot be loaded all objects are verified.
+The objects verified the longest time ago are selected by the sample percentage to be verified again so over time all objects are
+verified again.
+***********************************************************************************************************************************/
+static void
+verifyStateLoadCallback(void *const data, const String *const section, const String *const key, const String *const value)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, data);
+        FUNCTION_TEST_PARAM(STRING, section);
+        FUNCTION_TEST_PARAM(STRING, key);
+        FUNCTION_TEST_PARAM(STRING, value);
+    FUNCTION_TEST_END();
+
+    ASSERT(data != NULL);
+    ASSERT(section != NULL);
+    ASSERT(key != NULL);
+    ASSERT(value != NULL);
+
+    VerifyJobData *const jobData = data;
+    JsonRead *const json = jsonReadNew(value);
+    jsonReadObjectBegin(json);
+
+    // WAL range keys are archiveId/start
+    if (strEqZ(section, VERIFY_STATE_SECTION_ARCHIVE))
+    {
+        const StringList *const keyList = strLstNewSplitZ(key, "/");
+
+        if (strLstSize(keyList) != 2)
+            THROW_FMT(FormatError, "invalid verify state key '%s'", strZ(key));
+
+        MEM_CONTEXT_BEGIN(lstMemContext(jobData->stateWalList))
+        {
+            VerifyStateWal stateWal = {.archiveId = strDup(strLstGet(keyList, 0)), .start = strDup(strLstGet(keyList, 1))};
+
+            stateWal.stop = jsonReadStr(jsonReadKeyRequireZ(json, VERIFY_STATE_KEY_STOP));
+            stateWal.time = (time_t)jsonReadInt64(jsonReadKeyRequireZ(json, VERIFY_STATE_KEY_TIME));
+
+            lstAdd(jobData->stateWalList, &stateWal);
+        }
+        MEM_CONTEXT_END();
+    }
+    // Backup keys are the backup label
+    else if (strEqZ(section, VERIFY_STATE_SECTION_BACKUP))
+    {
+        MEM_CONTEXT_BEGIN(lstMemContext(jobData->stateBackupList))
+        {
+            VerifyStateBackup stateBackup = {.backupLabel = strDup(key)};
+
+            stateBackup.checksum = jsonReadStr(jsonReadKeyRequireZ(json, VERIFY_STATE_KEY_CHECKSUM));
+            stateBackup.time = (time_t)jsonReadInt64(jsonReadKeyRequireZ(json, VERIFY_STATE_KEY_TIME));
+
+            lstAdd(jobData->stateBackupList, &stateBackup);
+        }
+        MEM_CONTEXT_END();
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+static void
+verifyStateLoad(VerifyJobData *const jobData, const unsigned int sample)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM_P(VOID, jobData);
+        FUNCTION_LOG_PARAM(UINT, sample);
+    FUNCTION_LOG_END();
+
+    ASSERT(jobData != NULL);
+    ASSERT(sample <= 100);
+
+    MEM_CONTEXT_BEGIN(jobData->memContext)
+    {
+        jobData->stateBackupList = lstNewP(sizeof(VerifyStateBackup), .comparator = lstComparatorStr);
+        jobData->stateWalList = lstNewP(sizeof(VerifyStateWal), .comparator = verifyStateWalTimeComparator);
+    }
+    MEM_CONTEXT_END();
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        TRY_BEGIN()
+        {
+            IoRead *const read = storageReadIo(storageNewReadP(storageRepo(), STRDEF(VERIFY_STATE_PATH_FILE)));
+            cipherBlockFilterGroupAdd(
+                ioReadFilterGroup(read), cfgOptionStrId(cfgOptRepoCipherType), cipherModeDecrypt, jobData->manifestCipherPass);
+
+            infoNewLoad(read, verifyStateLoadCallback, jobData);
+        }
+        // No state is recorded before the first incremental run
+        CATCH(FileMissingError)
+        {
+        }
+        CATCH_ANY()
+        {
+            LOG_DETAIL_FMT("unable to load " VERIFY_STATE_FILE ", all objects will be verified: %s", errorMessage());
+
+            lstClear(jobData->stateBackupList);
+            lstClear(jobData->stateWalList);
+        }
+        TRY_END();
+
+        // Select the backups verified the longest time ago to be verified again. Backups are sorted by label afterward so they can
+        // be found when the backup is processed.
+        const unsigned int sampleBackupTotal = (lstSize(jobData->stateBackupList) * sample + 99) / 100;
+
+        lstSort(lstComparatorSet(jobData->stateBackupList, verifyStateBackupTimeComparator), sortOrderAsc);
+
+        for (unsigned int stateIdx = 0; stateIdx < sampleBackupTotal; stateIdx++)
+            ((VerifyStateBackup *)lstGet(jobData->stateBackupList, stateIdx))->sample = true;
+
+        lstSort(lstComparatorSet(jobData->stateBackupList, lstComparatorStr), sortOrderAsc);
+
+        // Skip the WAL ranges except those verified the longest time ago
+        const unsigned int sampleWalTotal = (lstSize(jobData->stateWalList) * sample + 99) / 100;
+
+        lstSort(jobData->stateWalList, sortOrderAsc);
+
+        for (unsigned int stateIdx = sampleWalTotal; stateIdx < lstSize(jobData->stateWalList); stateIdx++)
+            ((VerifyStateWal *)lstGet(jobData->stateWalList, stateIdx))->skip = true;
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Is the file stored in a backup that was verified by a prior incremental run?
+***********************************************************************************************************************************/
+static bool
+verifyStateBackupSkip(const VerifyJobData *const jobData, const String *const backupLabel)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, jobData);
+        FUNCTION_TEST_PARAM(STRING, backupLabel);
+    FUNCTION_TEST_END();
+
+    ASSERT(jobData != NULL);
+    ASSERT(backupLabel != NULL);
+
+    bool result = false;
+
+    if (jobData->stateBackupList != NULL)
+    {
+        const VerifyStateBackup *const stateBackup = lstFind(jobData->stateBackupList, &backupLabel);
+        result = stateBackup != NULL && stateBackup->skip;
+    }
+
+    FUNCTION_TEST_RETURN(BOOL, result);
+}
+
+/***********************************************************************************************************************************
+Is the WAL segment in a range that was verified by a prior incremental run?
+***********************************************************************************************************************************/
+static bool
+verifyStateWalSkip(const VerifyJobData *const jobData, const String *const archiveId, const String *const walSegment)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, jobData);
+        FUNCTION_TEST_PARAM(STRING, archiveId);
+        FUNCTION_TEST_PARAM(STRING, walSegment);
+    FUNCTION_TEST_END();
+
+    ASSERT(jobData != NULL);
+    ASSERT(archiveId != NULL);
+    ASSERT(walSegment != NULL);
+
+    bool result = false;
+
+    if (jobData->stateWalList != NULL)
+    {
+        for (unsigned int stateIdx = 0; stateIdx < lstSize(jobData->stateWalList); stateIdx++)
+        {
+            const VerifyStateWal *const stateWal = lstGet(jobData->stateWalList, stateIdx);
+
+            if (stateWal->skip && strEq(stateWal->archiveId, archiveId) && strCmp(stateWal->start, walSegment) <= 0 &&
+                strCmp(stateWal->stop, walSegment) >= 0)
+            {
+                result = true;
+                break;
+            }
+        }
+    }
+
+    FUNCTION_TEST_RETURN(BOOL, result);
+}
+
+/***********************************************************************************************************************************
+Save the state for the next incremental run
+
+Only backups and WAL ranges that are entirely valid are recorded so anything else is verified again by the next run. The time
+recorded for an object is the time of the oldest verification of its contents, so objects skipped by this run keep the time recorded
+before.
+***********************************************************************************************************************************/
+typedef struct VerifyStateSaveData
+{
+    List *stateBackupList;                                          // Backups to record
+    List *stateWalList;                                             // WAL ranges to record
+} VerifyStateSaveData;
+
+static void
+verifyStateSaveCallback(void *const data, const String *const sectionNext, InfoSave *const infoSaveData)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, data);
+        FUNCTION_TEST_PARAM(STRING, sectionNext);
+        FUNCTION_TEST_PARAM(INFO_SAVE, infoSaveData);
+    FUNCTION_TEST_END();
+
+    ASSERT(data != NULL);
+    ASSERT(infoSaveData != NULL);
+
+    const VerifyStateSaveData *const saveData = data;
+
+    if (infoSaveSection(infoSaveData, VERIFY_STATE_SECTION_ARCHIVE, sectionNext))
+    {
+        for (unsigned int stateIdx = 0; stateIdx < lstSize(saveData->stateWalList); stateIdx++)
+        {
+            const VerifyStateWal *const stateWal = lstGet(saveData->stateWalList, stateIdx);
+            JsonWrite *const json = jsonWriteObjectBegin(jsonWriteNewP());
+
+            jsonWriteStr(jsonWriteKeyZ(json, VERIFY_STATE_KEY_STOP), stateWal->stop);
+            jsonWriteInt64(jsonWriteKeyZ(json, VERIFY_STATE_KEY_TIME), stateWal->time);
+
+            infoSaveValue(
+                infoSaveData, VERIFY_STATE_SECTION_ARCHIVE,
+                zNewFmt("%s/%s", strZ(stateWal->archiveId), strZ(stateWal->start)), jsonWriteResult(jsonWriteObjectEnd(json)));
+        }
+    }
+
+    if (infoSaveSection(infoSaveData, VERIFY_STATE_SECTION_BACKUP, sectionNext))
+    {
+        for (unsigned int stateIdx = 0; stateIdx < lstSize(saveData->stateBackupList); stateIdx++)
+        {
+            const VerifyStateBackup *const stateBackup = lstGet(saveData->stateBackupList, stateIdx);
+            JsonWrite *const json = jsonWriteObjectBegin(jsonWriteNewP());
+
+            jsonWriteStr(jsonWriteKeyZ(json, VERIFY_STATE_KEY_CHECKSUM), stateBackup->checksum);
+            jsonWriteInt64(jsonWriteKeyZ(json, VERIFY_STATE_KEY_TIME), stateBackup->time);
+
+            infoSaveValue(
+                infoSaveData, VERIFY_STATE_SECTION_BACKUP, strZ(stateBackup->backupLabel),
+                jsonWriteResult(jsonWriteObjectEnd(json)));
+        }
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+static void
+verifyStateSave(const VerifyJobData *const jobData)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM_P(VOID, jobData);
+    FUNCTION_LOG_END();
+
+    ASSERT(jobData != NULL);
+    ASSERT(jobData->stateBackupList != NULL);
+    ASSERT(jobData->stateWalList != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        VerifyStateSaveData saveData =
+        {
+            .stateBackupList = lstNewP(sizeof(VerifyStateBackup)),
+            .stateWalList = lstNewP(sizeof(VerifyStateWal)),
+        };
+
+        // Record backups where all files are valid
+        for (unsigned int backupIdx = 0; backupIdx < lstSize(jobData->backupResultList); backupIdx++)
+        {
+            const VerifyBackupResult *const backupResult = lstGet(jobData->backupResultList, backupIdx);
+
+            if (backupResult->status == backupValid && backupResult->manifestChecksum != NULL &&
+                backupResult->totalFileValid == backupResult->totalFileManifest)
+            {
+                const VerifyStateBackup *const stateBackup = lstFind(jobData->stateBackupList, &backupResult->backupLabel);
+
+                lstAdd(
+                    saveData.stateBackupList,
+                    &(VerifyStateBackup)
+                    {
+                        .backupLabel = backupResult->backupLabel,
+                        .checksum = backupResult->manifestChecksum,
+                        .time = stateBackup != NULL && stateBackup->skip ? stateBackup->time : jobData->timeBegin,
+                    });
+            }
+        }
+
+        // Record WAL ranges where all WAL is valid
+        for (unsigned int archiveIdx = 0; archiveIdx < lstSize(jobData->archiveIdResultList); archiveIdx++)
+        {
+            const VerifyArchiveResult *const archiveIdResult = lstGet(jobData->archiveIdResultList, archiveIdx);
+
+            for (unsigned int walIdx = 0; walIdx < lstSize(archiveIdResult->walRangeList); walIdx++)
+            {
+                const VerifyWalRange *const walRange = lstGet(archiveIdResult->walRangeList, walIdx);
+
+                if (lstEmpty(walRange->invalidFileList))
+                {
+                    VerifyStateWal stateWalNew =
+                    {
+                        .archiveId = archiveIdResult->archiveId,
+                        .start = walRange->start,
+                        .stop = walRange->stop,
+                        .time = jobData->timeBegin,
+                    };
+
+                    // Keep the oldest time of the skipped ranges that overlap this range
+                    for (unsigned int stateIdx = 0; stateIdx < lstSize(jobData->stateWalList); stateIdx++)
+                    {
+                        const VerifyStateWal *const stateWal = lstGet(jobData->stateWalList, stateIdx);
+
+                        if (stateWal->skip && stateWal->time < stateWalNew.time &&
+                            strEq(stateWal->archiveId, stateWalNew.archiveId) && strCmp(stateWal->start, stateWalNew.stop) <= 0 &&
+                            strCmp(stateWal->stop, stateWalNew.start) >= 0)
+                        {
+                            stateWalNew.time = stateWal->time;
+                        }
+                    }
+
+                    lstAdd(saveData.stateWalList, &stateWalNew);
+                }
+            }
+        }
+
+        // Save the state
+        IoWrite *const write = storageWriteIo(storageNewWriteP(storageRepoWrite(), STRDEF(VERIFY_STATE_PATH_FILE)));
+        cipherBlockFilterGroupAdd(
+            ioWriteFilterGroup(write), cfgOptionStrId(cfgOptRepoCipherType), cipherModeEncrypt, jobData->manifestCipherPass);
+
+        infoSave(infoNew(NULL), write, verifyStateSaveCallback, &saveData);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
 /***********************************************************************************************************************************
 Get status of info files in the repository
 ***********************************************************************************************************************************/
@@ -361,7 +851,7 @@ Get the manifest file
 static Manifest *
 verifyManifestFile(
     VerifyBackupResult *backupResult, const String *cipherPass, bool currentBackup, const InfoPg *pgHistory,
-    unsigned int *jobErrorTotal)
+    unsigned int *jobErrorTotal, String **const checksum)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_TEST_PARAM_P(VERIFY_BACKUP_RESULT, backupResult);  // The result set for the backup being processed
@@ -369,12 +859,14 @@ verifyManifestFile(
         FUNCTION_LOG_PARAM(BOOL, currentBackup);                    // Is this possibly a backup currently in progress?
         FUNCTION_TEST_PARAM(INFO_PG, pgHistory);                    // Database history
         FUNCTION_TEST_PARAM_P(UINT, jobErrorTotal);                 // Pointer to the overall job error total
+        FUNCTION_TEST_PARAM_P(VOID, checksum);                      // Checksum of the usable manifest file (optional)
     FUNCTION_LOG_END();
 
     Manifest *result = NULL;
 
     MEM_CONTEXT_TEMP_BEGIN()
     {
+        const String *resultChecksum = NULL;
         String *fileName = strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE, strZ(backupResult->backupLabel));
 
         // Get the main manifest file
@@ -384,6 +876,7 @@ verifyManifestFile(
         if (verifyManifestInfo.errorCode == 0)
         {
             result = verifyManifestInfo.manifest;
+            resultChecksum = verifyManifestInfo.checksum;
 
             // The current in-progress backup is only notional until the main file is checked because the backup may have
             // completed by the time the main manifest is checked here. So having a main manifest file means this backup is not
@@ -421,6 +914,7 @@ verifyManifestFile(
                     LOG_DETAIL_FMT("%s/backup.manifest is missing or unusable, using copy", strZ(backupResult->backupLabel));
 
                     result = verifyManifestInfoCopy.manifest;
+                    resultChecksum = verifyManifestInfoCopy.checksum;
                 }
                 else if (verifyManifestInfo.errorCode == errorTypeCode(&FileMissingError) &&
                     verifyManifestInfoCopy.errorCode == errorTypeCode(&FileMissingError))
@@ -469,7 +963,18 @@ verifyManifestFile(
                 result = NULL;
             }
             else
+            {
                 manifestMove(result, memContextPrior());
+
+                if (checksum != NULL)
+                {
+                    MEM_CONTEXT_PRIOR_BEGIN()
+                    {
+                        *checksum = strDup(resultChecksum);
+                    }
+                    MEM_CONTEXT_PRIOR_END();
+                }
+            }
         }
 
         // If the result is NULL and the backup status has not yet been set, then the backup is unusable (invalid)
@@ -749,31 +1254,40 @@ verifyArchive(VerifyJobData *const jobData)
                     // If there are WAL files, then verify them
                     if (!strLstEmpty(jobData->walFileList))
                     {
-                        // Get the fully qualified file name and checksum
                         const String *fileName = strLstGet(jobData->walFileList, 0);
-                        const String *filePathName = strNewFmt(
-                            STORAGE_REPO_ARCHIVE "/%s/%s/%s", strZ(archiveResult->archiveId), strZ(walPath), strZ(fileName));
-                        String *checksum = strSubN(fileName, WAL_SEGMENT_NAME_SIZE + 1, HASH_TYPE_SHA1_SIZE_HEX);
 
-                        // Set up the job
-                        ProtocolCommand *command = protocolCommandNew(PROTOCOL_COMMAND_VERIFY_FILE);
-                        PackWrite *const param = protocolCommandParam(command);
+                        // If the WAL is in a range verified by a prior incremental run then it is valid
+                        if (verifyStateWalSkip(jobData, archiveResult->archiveId, strSubN(fileName, 0, WAL_SEGMENT_NAME_SIZE)))
+                        {
+                            archiveResult->totalValidWal++;
+                        }
+                        // Else set up the job
+                        else
+                        {
+                            // Get the fully qualified file name and checksum
+                            const String *filePathName = strNewFmt(
+                                STORAGE_REPO_ARCHIVE "/%s/%s/%s", strZ(archiveResult->archiveId), strZ(walPath), strZ(fileName));
+                            String *checksum = strSubN(fileName, WAL_SEGMENT_NAME_SIZE + 1, HASH_TYPE_SHA1_SIZE_HEX);
+
+                            ProtocolCommand *command = protocolCommandNew(PROTOCOL_COMMAND_VERIFY_FILE);
+                            PackWrite *const param = protocolCommandParam(command);
 
-                        pckWriteStrP(param, filePathName);
-                        pckWriteBoolP(param, false);
-                        pckWriteU32P(param, compressTypeFromName(filePathName));
-                        pckWriteStrP(param, checksum);
-                        pckWriteU64P(param, archiveResult->pgWalInfo.size);
-                        pckWriteStrP(param, jobData->walCipherPass);
+                            pckWriteStrP(param, filePathName);
+                            pckWriteBoolP(param, false);
+                            pckWriteU32P(param, compressTypeFromName(filePathName));
+                            pckWriteStrP(param, checksum);
+                            pckWriteU64P(param, archiveResult->pgWalInfo.size);
+                            pckWriteStrP(param, jobData->walCipherPass);
 
-                        // Assign job to result, prepending the archiveId to the key for consistency with backup processing
-                        const String *const jobKey = strNewFmt("%s/%s", strZ(archiveResult->archiveId), strZ(filePathName));
+                            // Assign job to result, prepending the archiveId to the key for consistency with backup processing
+                            const String *const jobKey = strNewFmt("%s/%s", strZ(archiveResult->archiveId), strZ(filePathName));
 
-                        MEM_CONTEXT_PRIOR_BEGIN()
-                        {
-                            result = protocolParallelJobNew(VARSTR(jobKey), command);
+                            MEM_CONTEXT_PRIOR_BEGIN()
+                            {
+                                result = protocolParallelJobNew(VARSTR(jobKey), command);
+                            }
+                            MEM_CONTEXT_PRIOR_END();
                         }
-                        MEM_CONTEXT_PRIOR_END();
 
                         // Remove the file to process from the list
                         strLstRemoveIdx(jobData->walFileList, 0);
@@ -822,10 +1336,11 @@ verifyArchive(VerifyJobData *const jobData)
 Verify the job data backups
 ***********************************************************************************************************************************/
 static ProtocolParallelJob *
-verifyBackup(VerifyJobData *const jobData)
+verifyBackup(VerifyJobData *const jobData, const unsigned int clientIdx)
 {
     FUNCTION_TEST_BEGIN();
         FUNCTION_TEST_PARAM_P(VOID, jobData);
+        FUNCTION_TEST_PARAM(UINT, clientIdx);
     FUNCTION_TEST_END();
 
     ProtocolParallelJob *result = NULL;
@@ -864,8 +1379,10 @@ verifyBackup(VerifyJobData *const jobData)
                 bool inProgressBackup = strEq(jobData->currentBackup, backupResult->backupLabel);
 
                 // Get a usable backup manifest file
+                String *manifestChecksum = NULL;
                 Manifest *manifest = verifyManifestFile(
-                    backupResult, jobData->manifestCipherPass, inProgressBackup, jobData->pgHistory, &jobData->jobErrorTotal);
+                    backupResult, jobData->manifestCipherPass, inProgressBackup, jobData->pgHistory, &jobData->jobErrorTotal,
+                    &manifestChecksum);
 
                 // If a usable backup.manifest file is not found
                 if (manifest == NULL)
@@ -888,6 +1405,7 @@ verifyBackup(VerifyJobData *const jobData)
                         // Get the cipher subpass used to decrypt files in the backup and initialize the file list index
                         jobData->backupCipherPass = strDup(manifestCipherSubPass(jobData->manifest));
                         jobData->manifestFileIdx = 0;
+                        jobData->manifestFilePart = 0;
                     }
                     MEM_CONTEXT_END();
 
@@ -901,8 +1419,19 @@ verifyBackup(VerifyJobData *const jobData)
                         backupResult->pgVersion = manData->pgVersion;
                         backupResult->archiveStart = strDup(manData->archiveStart);
                         backupResult->archiveStop = strDup(manData->archiveStop);
+                        backupResult->manifestChecksum = strDup(manifestChecksum);
                     }
                     MEM_CONTEXT_END();
+
+                    // Skip the files stored in the backup when it was verified by a prior incremental run and the manifest has not
+                    // changed since, unless the backup was selected to be verified again
+                    if (jobData->stateBackupList != NULL)
+                    {
+                        VerifyStateBackup *const stateBackup = lstFind(jobData->stateBackupList, &backupResult->backupLabel);
+
+                        if (stateBackup != NULL && !stateBackup->sample && strEq(stateBackup->checksum, manifestChecksum))
+                            stateBackup->skip = true;
+                    }
                 }
             }
 
@@ -915,6 +1444,20 @@ verifyBackup(VerifyJobData *const jobData)
                 {
                     const ManifestFile fileData = manifestFile(jobData->manifest, jobData->manifestFileIdx);
 
+                    // Each part of a split file is verified as a backup file since the parts are stored in separate repo files
+                    const bool split = fileData.splitSize != 0;
+                    const unsigned int filePart = jobData->manifestFilePart;
+
+                    if (split && filePart == 0)
+                        backupResult->totalFileManifest += manifestSplitTotal(&fileData) - 1;
+
+                    // Name of the file (or part) relative to the backup path
+                    const CompressType compressType = manifestData(jobData->manifest)->backupOptionCompressType;
+                    const String *const fileRepoName =
+                        split ?
+                            manifestSplitFile(fileData.name, filePart, compressType) :
+                            strNewFmt("%s%s", strZ(fileData.name), strZ(compressExtStr(compressType)));
+
                     // Track the files verified in order to determine when the processing of the backup is complete
                     backupResult->totalFileVerify++;
 
@@ -948,9 +1491,7 @@ verifyBackup(VerifyJobData *const jobData)
                                 // Else skip verification
                                 else
                                 {
-                                    String *priorFile = strNewFmt(
-                                        "%s/%s%s", strZ(fileData.reference), strZ(fileData.name),
-                                        strZ(compressExtStr((manifestData(jobData->manifest))->backupOptionCompressType)));
+                                    String *priorFile = strNewFmt("%s/%s", strZ(fileData.reference), strZ(fileRepoName));
 
                                     unsigned int backupPriorInvalidIdx = lstFindIdx(backupResultPrior->invalidFileList, &priorFile);
 
@@ -977,6 +1518,13 @@ verifyBackup(VerifyJobData *const jobData)
                         else
                             fileBackupLabel = backupResult->backupLabel;
 
+                        // If the file is stored in a backup verified by a prior incremental run then it is valid
+                        if (fileBackupLabel != NULL && verifyStateBackupSkip(jobData, fileBackupLabel))
+                        {
+                            backupResult->totalFileValid++;
+                            fileBackupLabel = NULL;
+                        }
+
                         // If backup label is not null then send it off for processing
                         if (fileBackupLabel != NULL)
                         {
@@ -985,8 +1533,7 @@ verifyBackup(VerifyJobData *const jobData)
                             PackWrite *const param = protocolCommandParam(command);
 
                             const String *const filePathName = strNewFmt(
-                                    STORAGE_REPO_BACKUP "/%s/%s%s", strZ(fileBackupLabel), strZ(fileData.name),
-                                    strZ(compressExtStr((manifestData(jobData->manifest))->backupOptionCompressType)));
+                                STORAGE_REPO_BACKUP "/%s/%s", strZ(fileBackupLabel), strZ(fileRepoName));
 
                             if (fileData.bundleId != 0)
                             {
@@ -999,6 +1546,28 @@ verifyBackup(VerifyJobData *const jobData)
                                 pckWriteU64P(param, fileData.bundleOffset);
                                 pckWriteU64P(param, fileData.sizeRepo);
                             }
+                            // Else if the file is in the dedup store. The backup file name is still used to report results.
+                            else if (fileData.dedup)
+                            {
+                                pckWriteStrP(
+                                    param,
+                                    strNewFmt(
+                                        STORAGE_REPO_BACKUP "/%s",
+                                        strZ(
+                                            manifestDedupFile(
+                                                fileData.checksumSha1,
+                                                manifestData(jobData->manifest)->backupOptionCompressType))));
+                                pckWriteBoolP(param, false);
+                            }
+                            // Else if the part of a split file is checked with the repo storage info. The repo size of each part is
+                            // not stored so the part is checked like a bundled file of zero size, i.e. only that it exists.
+                            else if (split && jobData->fast)
+                            {
+                                pckWriteStrP(param, filePathName);
+                                pckWriteBoolP(param, true);
+                                pckWriteU64P(param, 0);
+                                pckWriteU64P(param, 0);
+                            }
                             else
                             {
                                 pckWriteStrP(param, filePathName);
@@ -1006,11 +1575,36 @@ verifyBackup(VerifyJobData *const jobData)
                             }
 
                             pckWriteU32P(param, manifestData(jobData->manifest)->backupOptionCompressType);
-                            // If the checksum is not present in the manifest, it will be calculated by manifest load
-                            pckWriteStrP(param, STR(fileData.checksumSha1));
-                            pckWriteU64P(param, fileData.size);
+
+                            // If the checksum is not present in the manifest, it will be calculated by manifest load. A part of a
+                            // split file is checked against the checksum and size of the part.
+                            if (split)
+                            {
+                                pckWriteStrP(param, manifestSplitChecksum(&fileData, filePart));
+                                pckWriteU64P(param, manifestSplitSize(&fileData, filePart));
+                            }
+                            else
+                            {
+                                pckWriteStrP(param, STR(fileData.checksumSha1));
+                                pckWriteU64P(param, fileData.size);
+                            }
+
                             pckWriteStrP(param, jobData->backupCipherPass);
 
+                            if (fileData.bundleDict && !jobData->fast)
+                                verifyBundleDictPackWrite(param, jobData, fileBackupLabel, clientIdx);
+                            else
+                                compressDictPackWrite(param, compressTypeNone, NULL, false);
+
+                            // For fast verify the file is checked against the repo storage info instead of being read
+                            pckWriteBoolP(param, jobData->fast);
+
+                            if (jobData->fast)
+                            {
+                                pckWriteU64P(param, split ? 0 : fileData.sizeRepo);
+                                pckWriteStrP(param, fileData.checksumRepo[0] != 0 ? STR(fileData.checksumRepo) : NULL);
+                            }
+
                             // Assign job to result (prepend backup label being processed to the key since some files are in a prior
                             // backup)
                             const String *const jobKey = strNewFmt("%s/%s", strZ(backupResult->backupLabel), strZ(filePathName));
@@ -1026,12 +1620,18 @@ verifyBackup(VerifyJobData *const jobData)
                     else
                         backupResult->totalFileValid++;
 
-                    // Increment the index to point to the next file
-                    jobData->manifestFileIdx++;
+                    // Increment the index to point to the next part or file
+                    if (split && filePart + 1 < manifestSplitTotal(&fileData))
+                        jobData->manifestFilePart++;
+                    else
+                    {
+                        jobData->manifestFilePart = 0;
+                        jobData->manifestFileIdx++;
+                    }
 
                     // If this was the last file to process for this backup, then free the manifest and remove this backup from the
                     // processing list
-                    if (jobData->manifestFileIdx == backupResult->totalFileManifest)
+                    if (jobData->manifestFileIdx == manifestFileTotal(jobData->manifest))
                     {
                         manifestFree(jobData->manifest);
                         jobData->manifest = NULL;
@@ -1042,7 +1642,7 @@ verifyBackup(VerifyJobData *const jobData)
                     if (result != NULL)
                         break;
                 }
-                while (jobData->manifestFileIdx < backupResult->totalFileManifest);
+                while (jobData->manifest != NULL);
             }
             else
             {
@@ -1078,7 +1678,7 @@ verifyJobCallback(void *data, unsigned int clientIdx)
 {
     FUNCTION_TEST_BEGIN();
         FUNCTION_TEST_PARAM_P(VOID, data);                          // Pointer to the job data
-        (void)clientIdx;                                            // Client index (not used for this process)
+        FUNCTION_TEST_PARAM(UINT, clientIdx);                       // Client index
     FUNCTION_TEST_END();
 
     ASSERT(data != NULL);
@@ -1099,7 +1699,7 @@ verifyJobCallback(void *data, unsigned int clientIdx)
     {
         // Only begin backup verification if the last archive result was processed
         if (result == NULL)
-            result = verifyBackup(jobData);
+            result = verifyBackup(jobData, clientIdx);
     }
 
     FUNCTION_TEST_RETURN(PROTOCOL_PARALLEL_JOB, result);
@@ -1524,6 +2124,9 @@ verifyProcess(const bool verboseText)
                 .walCipherPass = infoPgCipherPass(infoArchivePg(archiveInfo)),
                 .archiveIdResultList = lstNewP(sizeof(VerifyArchiveResult), .comparator = archiveIdComparator),
                 .backupResultList = lstNewP(sizeof(VerifyBackupResult), .comparator = lstComparatorStr),
+                .bundleDictList = lstNewP(sizeof(VerifyBundleDict), .comparator = lstComparatorStr),
+                .fast = cfgOptionStrId(cfgOptType) == CFGOPTVAL_TYPE_FAST,
+                .timeBegin = time(NULL),
             };
 
             // Get a list of backups in the repo sorted ascending
@@ -1556,6 +2159,10 @@ verifyProcess(const bool verboseText)
                 jobData.currentBackup = verifySetBackupCheckArchive(
                     jobData.backupList, backupInfo, jobData.archiveIdList, jobData.pgHistory, &jobData.jobErrorTotal);
 
+                // Load the objects verified by prior incremental runs so they can be skipped
+                if (cfgOptionBool(cfgOptIncremental))
+                    verifyStateLoad(&jobData, cfgOptionUInt(cfgOptSample));
+
                 // Create the parallel executor
                 ProtocolParallel *parallelExec = protocolParallelNew(
                     cfgOptionUInt64(cfgOptProtocolTimeout) / 2, verifyJobCallback, &jobData);
@@ -1686,6 +2293,11 @@ verifyProcess(const bool verboseText)
                 }
                 MEM_CONTEXT_TEMP_END();
 
+                // Record the objects verified for the next incremental run. Fast verify does not read backup files so nothing is
+                // recorded.
+                if (jobData.stateBackupList != NULL && !jobData.fast)
+                    verifyStateSave(&jobData);
+
                 // ??? Need to do the final reconciliation - checking backup required WAL against, valid WAL
 
                 // Report results
@@ -15,6 +15,7 @@ Compression Helper
 #include "common/compress/lz4/common.h"
 #include "common/compress/lz4/compress.h"
 #include "common/compress/lz4/decompress.h"
+#include "common/compress/probe.h"
 #include "common/compress/zst/common.h"
 #include "common/compress/zst/compress.h"
 #include "common/compress/zst/decompress.h"
@@ -42,7 +43,12 @@ static const struct CompressHelperLocal
     IoFilter *(*compressNew)(int);                                  // Function to create new compression filter
     StringId decompressType;                                        // Type of the decompression filter
     IoFilter *(*decompressNew)(void);                               // Function to create new decompression filter
+    IoFilter *(*compressDictNew)(int, const Buffer *);              // Function to create new compression filter with dictionary
+    IoFilter *(*decompressDictNew)(const Buffer *);                 // Function to create new decompression filter with dictionary
+    Buffer *(*dictTrain)(const Buffer *, const size_t *, unsigned int, size_t); // Function to train a dictionary
+    unsigned int (*dictId)(const Buffer *);                         // Function to get the id of a dictionary
     int levelDefault;                                               // Default compression level
+    int levelFast;                                                  // Fastest compression level
 } compressHelperLocal[] =
 {
     {
@@ -59,6 +65,7 @@ static const struct CompressHelperLocal
         .decompressType = BZ2_DECOMPRESS_FILTER_TYPE,
         .decompressNew = bz2DecompressNew,
         .levelDefault = 9,
+        .levelFast = 1,
     },
     {
         .typeId = STRID5("gz", 0x3470),
@@ -69,6 +76,7 @@ static const struct CompressHelperLocal
         .decompressType = GZ_DECOMPRESS_FILTER_TYPE,
         .decompressNew = gzDecompressNew,
         .levelDefault = 6,
+        .levelFast = 0,
     },
     {
         .typeId = STRID6("lz4", 0x2068c1),
@@ -80,6 +88,7 @@ static const struct CompressHelperLocal
         .decompressType = LZ4_DECOMPRESS_FILTER_TYPE,
         .decompressNew = lz4DecompressNew,
         .levelDefault = 1,
+        .levelFast = 1,
 #endif
     },
     {
@@ -91,7 +100,12 @@ static const struct CompressHelperLocal
         .compressNew = zstCompressNew,
         .decompressType = ZST_DECOMPRESS_FILTER_TYPE,
         .decompressNew = zstDecompressNew,
+        .compressDictNew = zstCompressDictNew,
+        .decompressDictNew = zstDecompressDictNew,
+        .dictTrain = zstDictTrain,
+        .dictId = zstDictId,
         .levelDefault = 3,
+        .levelFast = 1,
 #endif
     },
     {
@@ -101,6 +115,22 @@ static const struct CompressHelperLocal
     },
 };
 
+/***********************************************************************************************************************************
+Dictionaries sent to or received from other processes
+***********************************************************************************************************************************/
+typedef struct CompressDict
+{
+    unsigned int id;                                                // Dictionary id (must be first member)
+    const Buffer *dict;                                             // Dictionary
+    bool filterSent;                                                // Has the dictionary been sent with a filter param?
+} CompressDict;
+
+static struct CompressHelperDictLocal
+{
+    MemContext *memContext;                                         // Mem context for dictionaries
+    List *dictList;                                                 // Dictionaries
+} compressHelperDictLocal;
+
 /**********************************************************************************************************************************/
 CompressType
 compressTypeEnum(const StringId type)
@@ -190,6 +220,20 @@ compressLevelDefault(CompressType type)
     FUNCTION_TEST_RETURN(INT, compressHelperLocal[type].levelDefault);
 }
 
+/**********************************************************************************************************************************/
+int
+compressLevelFast(const CompressType type)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(ENUM, type);
+    FUNCTION_TEST_END();
+
+    ASSERT(type < LENGTH_OF(compressHelperLocal));
+    compressTypePresent(type);
+
+    FUNCTION_TEST_RETURN(INT, compressHelperLocal[type].levelFast);
+}
+
 /**********************************************************************************************************************************/
 IoFilter *
 compressFilter(CompressType type, int level)
@@ -206,6 +250,191 @@ compressFilter(CompressType type, int level)
     FUNCTION_TEST_RETURN(IO_FILTER, compressHelperLocal[type].compressNew(level));
 }
 
+/**********************************************************************************************************************************/
+IoFilter *
+compressFilterProbe(const CompressType type, const int level)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(ENUM, type);
+        FUNCTION_TEST_PARAM(INT, level);
+    FUNCTION_TEST_END();
+
+    ASSERT(type < LENGTH_OF(compressHelperLocal));
+    ASSERT(type != compressTypeNone);
+    compressTypePresent(type);
+
+    FUNCTION_TEST_RETURN(IO_FILTER, compressProbeNew(type, level));
+}
+
+/**********************************************************************************************************************************/
+bool
+compressDictSupported(const CompressType type)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(ENUM, type);
+    FUNCTION_TEST_END();
+
+    ASSERT(type < LENGTH_OF(compressHelperLocal));
+
+    FUNCTION_TEST_RETURN(BOOL, compressHelperLocal[type].dictTrain != NULL);
+}
+
+/**********************************************************************************************************************************/
+Buffer *
+compressDictTrain(
+    const CompressType type, const Buffer *const sample, const size_t *const sampleSizeList, const unsigned int sampleTotal,
+    const size_t dictSize)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(ENUM, type);
+        FUNCTION_LOG_PARAM(BUFFER, sample);
+        FUNCTION_LOG_PARAM_P(VOID, sampleSizeList);
+        FUNCTION_LOG_PARAM(UINT, sampleTotal);
+        FUNCTION_LOG_PARAM(SIZE, dictSize);
+    FUNCTION_LOG_END();
+
+    ASSERT(compressDictSupported(type));
+
+    FUNCTION_LOG_RETURN(BUFFER, compressHelperLocal[type].dictTrain(sample, sampleSizeList, sampleTotal, dictSize));
+}
+
+/***********************************************************************************************************************************
+Find a dictionary by id. When a dictionary is passed it is stored if it has not been stored already.
+***********************************************************************************************************************************/
+static CompressDict *
+compressDictFind(const unsigned int id, const Buffer *const dict)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(UINT, id);
+        FUNCTION_TEST_PARAM(BUFFER, dict);
+    FUNCTION_TEST_END();
+
+    if (compressHelperDictLocal.memContext == NULL)
+    {
+        MEM_CONTEXT_BEGIN(memContextTop())
+        {
+            MEM_CONTEXT_NEW_BEGIN(CompressHelperDict, .childQty = MEM_CONTEXT_QTY_MAX)
+            {
+                compressHelperDictLocal.memContext = MEM_CONTEXT_NEW();
+                compressHelperDictLocal.dictList = lstNewP(sizeof(CompressDict), .comparator = lstComparatorUInt);
+            }
+            MEM_CONTEXT_NEW_END();
+        }
+        MEM_CONTEXT_END();
+    }
+
+    CompressDict *result = lstFind(compressHelperDictLocal.dictList, &id);
+
+    if (result == NULL && dict != NULL)
+    {
+        MEM_CONTEXT_BEGIN(lstMemContext(compressHelperDictLocal.dictList))
+        {
+            result = lstAdd(compressHelperDictLocal.dictList, &(CompressDict){.id = id, .dict = bufDup(dict)});
+        }
+        MEM_CONTEXT_END();
+    }
+
+    FUNCTION_TEST_RETURN_TYPE_P(CompressDict, result);
+}
+
+/**********************************************************************************************************************************/
+void
+compressDictPackWrite(PackWrite *const pack, const CompressType type, const Buffer *const dict, const bool send)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(PACK_WRITE, pack);
+        FUNCTION_TEST_PARAM(ENUM, type);
+        FUNCTION_TEST_PARAM(BUFFER, dict);
+        FUNCTION_TEST_PARAM(BOOL, send);
+    FUNCTION_TEST_END();
+
+    ASSERT(pack != NULL);
+    ASSERT(dict == NULL || compressDictSupported(type));
+
+    pckWriteBoolP(pack, dict != NULL);
+
+    if (dict != NULL)
+    {
+        // A dictionary without an id cannot be found by the receiver so it must always be sent
+        const unsigned int id = compressHelperLocal[type].dictId(dict);
+
+        pckWriteU32P(pack, id);
+        pckWriteBinP(pack, send || id == 0 ? dict : NULL);
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+void
+compressDictFilterPackWrite(PackWrite *const pack, const CompressType type, const Buffer *const dict)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(PACK_WRITE, pack);
+        FUNCTION_TEST_PARAM(ENUM, type);
+        FUNCTION_TEST_PARAM(BUFFER, dict);
+    FUNCTION_TEST_END();
+
+    ASSERT(pack != NULL);
+    ASSERT(dict != NULL);
+    ASSERT(compressDictSupported(type));
+
+    CompressDict *const compressDict = compressDictFind(compressHelperLocal[type].dictId(dict), dict);
+
+    compressDictPackWrite(pack, type, dict, !compressDict->filterSent);
+    compressDict->filterSent = true;
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+const Buffer *
+compressDictPackRead(PackRead *const pack)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(PACK_READ, pack);
+    FUNCTION_TEST_END();
+
+    ASSERT(pack != NULL);
+
+    const Buffer *result = NULL;
+
+    if (pckReadBoolP(pack))
+    {
+        const unsigned int id = pckReadU32P(pack);
+        result = pckReadBinP(pack);
+
+        // Store the dictionary when it has an id so it can be found when only the id is sent
+        if (id != 0)
+        {
+            const CompressDict *const compressDict = compressDictFind(id, result);
+
+            if (compressDict == NULL)
+                THROW_FMT(AssertError, "dictionary %u has not been sent", id);
+
+            result = compressDict->dict;
+        }
+    }
+
+    FUNCTION_TEST_RETURN_CONST(BUFFER, result);
+}
+
+/**********************************************************************************************************************************/
+IoFilter *
+compressFilterDict(const CompressType type, const int level, const Buffer *const dict)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(ENUM, type);
+        FUNCTION_TEST_PARAM(INT, level);
+        FUNCTION_TEST_PARAM(BUFFER, dict);
+    FUNCTION_TEST_END();
+
+    ASSERT(dict != NULL);
+    ASSERT(compressDictSupported(type));
+
+    FUNCTION_TEST_RETURN(IO_FILTER, compressHelperLocal[type].compressDictNew(level, dict));
+}
+
 /**********************************************************************************************************************************/
 IoFilter *
 compressFilterPack(const StringId filterType, const Pack *const filterParam)
@@ -221,21 +450,36 @@ compressFilterPack(const StringId filterType, const Pack *const filterParam)
 
     MEM_CONTEXT_TEMP_BEGIN()
     {
-        for (CompressType compressIdx = compressTypeNone + 1; compressIdx < LENGTH_OF(compressHelperLocal); compressIdx++)
+        // The probe filter wraps one of the compression filters
+        if (filterType == COMPRESS_PROBE_FILTER_TYPE)
+            result = ioFilterMove(compressProbeNewPack(filterParam), memContextPrior());
+        else
         {
-            const struct CompressHelperLocal *compress = &compressHelperLocal[compressIdx];
-
-            if (filterType == compress->compressType)
+            for (CompressType compressIdx = compressTypeNone + 1; compressIdx < LENGTH_OF(compressHelperLocal); compressIdx++)
             {
-                ASSERT(filterParam != NULL);
-
-                result = ioFilterMove(compress->compressNew(pckReadI32P(pckReadNew(filterParam))), memContextPrior());
-                break;
-            }
-            else if (filterType == compress->decompressType)
-            {
-                result = ioFilterMove(compress->decompressNew(), memContextPrior());
-                break;
+                const struct CompressHelperLocal *compress = &compressHelperLocal[compressIdx];
+
+                if (filterType == compress->compressType)
+                {
+                    ASSERT(filterParam != NULL);
+
+                    PackRead *const paramRead = pckReadNew(filterParam);
+                    const int level = pckReadI32P(paramRead);
+                    const Buffer *const dict = compressDictPackRead(paramRead);
+
+                    result = ioFilterMove(
+                        dict != NULL ? compress->compressDictNew(level, dict) : compress->compressNew(level), memContextPrior());
+                    break;
+                }
+                else if (filterType == compress->decompressType)
+                {
+                    // A param list is only present when there is a dictionary
+                    result = ioFilterMove(
+                        filterParam != NULL ?
+                            compress->decompressDictNew(compressDictPackRead(pckReadNew(filterParam))) : compress->decompressNew(),
+                        memContextPrior());
+                    break;
+                }
             }
         }
     }
@@ -259,6 +503,21 @@ decompressFilter(CompressType type)
     FUNCTION_TEST_RETURN(IO_FILTER, compressHelperLocal[type].decompressNew());
 }
 
+/**********************************************************************************************************************************/
+IoFilter *
+decompressFilterDict(const CompressType type, const Buffer *const dict)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(ENUM, type);
+        FUNCTION_TEST_PARAM(BUFFER, dict);
+    FUNCTION_TEST_END();
+
+    ASSERT(dict != NULL);
+    ASSERT(compressDictSupported(type));
+
+    FUNCTION_TEST_RETURN(IO_FILTER, compressHelperLocal[type].decompressDictNew(dict));
+}
+
 /**********************************************************************************************************************************/
 const String *
 compressExtStr(CompressType type)
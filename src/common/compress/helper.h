@@ -55,6 +55,35 @@ CompressType compressTypeFromName(const String *name);
 // Compression filter for the specified type.  Error when compress type is none or invalid.
 IoFilter *compressFilter(CompressType type, int level);
 
+// Compression filter that probes the start of the data and uses the fastest level when the data does not compress well (see
+// compress/probe.h). The filter result is true when the fastest level was used.
+IoFilter *compressFilterProbe(CompressType type, int level);
+
+// Compression filter that uses a dictionary trained by compressDictTrain(). The compress type must support dictionaries.
+IoFilter *compressFilterDict(CompressType type, int level, const Buffer *dict);
+
+// Does the compression type support dictionaries?
+bool compressDictSupported(CompressType type);
+
+// Train a dictionary from samples that are concatenated in the sample buffer. Returns NULL when a dictionary cannot be trained,
+// e.g. because there are too few samples. The compress type must support dictionaries.
+Buffer *compressDictTrain(
+    CompressType type, const Buffer *sample, const size_t *sampleSizeList, unsigned int sampleTotal, size_t dictSize);
+
+// Dictionaries can be large so they are only sent once to another process and after that are referred to by the id stored in the
+// dictionary. The receiving process keeps the dictionaries it receives until it exits.
+
+// Write a dictionary to a pack. When send is false only the id is written so the dictionary must have been sent to the receiving
+// process already. NULL may be passed when there is no dictionary.
+void compressDictPackWrite(PackWrite *pack, CompressType type, const Buffer *dict, bool send);
+
+// Write a dictionary to a filter param. A process sends filters to at most one remote for each storage so the dictionary is only
+// sent with the first filter param written by the process.
+void compressDictFilterPackWrite(PackWrite *pack, CompressType type, const Buffer *dict);
+
+// Read a dictionary written by compressDictPackWrite() or compressDictFilterPackWrite()
+const Buffer *compressDictPackRead(PackRead *pack);
+
 // Compression/decompression filter based on string type and a parameter list.  This is useful when a filter must be created on a
 // remote system since the filter type and parameters can be passed through a protocol.
 IoFilter *compressFilterPack(StringId filterType, const Pack *filterParam);
@@ -62,6 +91,9 @@ IoFilter *compressFilterPack(StringId filterType, const Pack *filterParam);
 // Decompression filter for the specified type.  Error when compress type is none or invalid.
 IoFilter *decompressFilter(CompressType type);
 
+// Decompression filter for data compressed with a dictionary
+IoFilter *decompressFilterDict(CompressType type, const Buffer *dict);
+
 // Get extension for the current compression type
 const String *compressExtStr(CompressType type);
 
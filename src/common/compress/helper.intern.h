@@ -12,4 +12,7 @@ Functions
 // Default compression level for a compression type, used while loading the configuration
 int compressLevelDefault(CompressType type);
 
+// Fastest compression level for a compression type
+int compressLevelFast(CompressType type);
+
 #endif
@@ -0,0 +1,258 @@
+/***********************************************************************************************************************************
+Compress Probe Filter
+***********************************************************************************************************************************/
+#include "build.auto.h"
+
+#include <zlib.h>
+
+#include "common/compress/gz/common.h"
+#include "common/compress/helper.intern.h"
+#include "common/compress/probe.h"
+#include "common/debug.h"
+#include "common/io/filter/filter.h"
+#include "common/log.h"
+#include "common/type/object.h"
+#include "common/type/pack.h"
+
+/***********************************************************************************************************************************
+Probe constants
+***********************************************************************************************************************************/
+// Size of the sample taken from the first input. Smaller samples are not probed since the estimate is not reliable and compressing
+// small inputs at the configured level is cheap anyway.
+#define COMPRESS_PROBE_SAMPLE_SIZE                                  (64 * 1024)
+#define COMPRESS_PROBE_SAMPLE_SIZE_MIN                              (4 * 1024)
+
+// Data is compressed at the fastest level when the compressed sample is at least this percentage of the sample size
+#define COMPRESS_PROBE_RATIO                                        90
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct CompressProbe
+{
+    CompressType type;                                              // Compression type
+    int level;                                                      // Compression level when the data is compressible
+    IoFilter *filter;                                               // Compression filter (created when the probe is done)
+    bool fast;                                                      // Was the data compressed at the fastest level?
+} CompressProbe;
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+static String *
+compressProbeToLog(const CompressProbe *const this)
+{
+    return strNewFmt(
+        "{type: %s, level: %d, fast: %s}", strZ(compressTypeStr(this->type)), this->level, cvtBoolToConstZ(this->fast));
+}
+
+#define FUNCTION_LOG_COMPRESS_PROBE_TYPE                                                                                           \
+    CompressProbe *
+#define FUNCTION_LOG_COMPRESS_PROBE_FORMAT(value, buffer, bufferSize)                                                              \
+    FUNCTION_LOG_STRING_OBJECT_FORMAT(value, compressProbeToLog, buffer, bufferSize)
+
+/***********************************************************************************************************************************
+Does a sample from the start of the input compress poorly? Deflate at the fastest level is used to estimate compressibility for all
+compression types since it is always available and cheap.
+***********************************************************************************************************************************/
+static bool
+compressProbeIncompressible(const Buffer *const input)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BUFFER, input);
+    FUNCTION_TEST_END();
+
+    ASSERT(input != NULL);
+
+    bool result = false;
+    const size_t sampleSize = bufUsed(input) < COMPRESS_PROBE_SAMPLE_SIZE ? bufUsed(input) : COMPRESS_PROBE_SAMPLE_SIZE;
+
+    if (sampleSize >= COMPRESS_PROBE_SAMPLE_SIZE_MIN)
+    {
+        uLongf compressSize = compressBound(sampleSize);
+        Buffer *const compressed = bufNew(compressSize);
+
+        gzError(compress2(bufPtr(compressed), &compressSize, bufPtrConst(input), sampleSize, Z_BEST_SPEED));
+        result = compressSize * 100 >= sampleSize * COMPRESS_PROBE_RATIO;
+
+        bufFree(compressed);
+    }
+
+    FUNCTION_TEST_RETURN(BOOL, result);
+}
+
+/***********************************************************************************************************************************
+Compress data
+***********************************************************************************************************************************/
+static void
+compressProbeProcess(THIS_VOID, const Buffer *const input, Buffer *const output)
+{
+    THIS(CompressProbe);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(COMPRESS_PROBE, this);
+        FUNCTION_LOG_PARAM(BUFFER, input);
+        FUNCTION_LOG_PARAM(BUFFER, output);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(output != NULL);
+
+    // Probe the first input to choose the compression level. When there is no input (i.e. flush without data) there is nothing to
+    // probe so the configured level is used.
+    if (this->filter == NULL)
+    {
+        int level = this->level;
+
+        if (input != NULL && level > compressLevelFast(this->type) && compressProbeIncompressible(input))
+        {
+            level = compressLevelFast(this->type);
+            this->fast = true;
+        }
+
+        MEM_CONTEXT_OBJ_BEGIN(this)
+        {
+            this->filter = compressFilter(this->type, level);
+        }
+        MEM_CONTEXT_OBJ_END();
+    }
+
+    ioFilterProcessInOut(this->filter, input, output);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Is compress done?
+***********************************************************************************************************************************/
+static bool
+compressProbeDone(const THIS_VOID)
+{
+    THIS(const CompressProbe);
+
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(COMPRESS_PROBE, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(BOOL, this->filter != NULL && ioFilterDone(this->filter));
+}
+
+/***********************************************************************************************************************************
+Is the same input required on the next process call?
+***********************************************************************************************************************************/
+static bool
+compressProbeInputSame(const THIS_VOID)
+{
+    THIS(const CompressProbe);
+
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(COMPRESS_PROBE, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(BOOL, this->filter != NULL && ioFilterInputSame(this->filter));
+}
+
+/***********************************************************************************************************************************
+Return filter result
+***********************************************************************************************************************************/
+static Pack *
+compressProbeResult(THIS_VOID)
+{
+    THIS(CompressProbe);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(COMPRESS_PROBE, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    Pack *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        PackWrite *const packWrite = pckWriteNewP();
+
+        pckWriteBoolP(packWrite, this->fast);
+        pckWriteEndP(packWrite);
+
+        result = pckMove(pckWriteResult(packWrite), memContextPrior());
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(PACK, result);
+}
+
+/**********************************************************************************************************************************/
+IoFilter *
+compressProbeNew(const CompressType type, const int level)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(ENUM, type);
+        FUNCTION_LOG_PARAM(INT, level);
+    FUNCTION_LOG_END();
+
+    ASSERT(type != compressTypeNone);
+
+    IoFilter *this = NULL;
+
+    OBJ_NEW_BEGIN(CompressProbe, .childQty = MEM_CONTEXT_QTY_MAX, .allocQty = MEM_CONTEXT_QTY_MAX)
+    {
+        CompressProbe *const driver = OBJ_NEW_ALLOC();
+
+        *driver = (CompressProbe)
+        {
+            .type = type,
+            .level = level,
+        };
+
+        // Create param list
+        Pack *paramList = NULL;
+
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            PackWrite *const packWrite = pckWriteNewP();
+
+            pckWriteU32P(packWrite, type);
+            pckWriteI32P(packWrite, level);
+            pckWriteEndP(packWrite);
+
+            paramList = pckMove(pckWriteResult(packWrite), memContextPrior());
+        }
+        MEM_CONTEXT_TEMP_END();
+
+        this = ioFilterNewP(
+            COMPRESS_PROBE_FILTER_TYPE, driver, paramList, .done = compressProbeDone, .inOut = compressProbeProcess,
+            .inputSame = compressProbeInputSame, .result = compressProbeResult);
+    }
+    OBJ_NEW_END();
+
+    FUNCTION_LOG_RETURN(IO_FILTER, this);
+}
+
+IoFilter *
+compressProbeNewPack(const Pack *const paramList)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(PACK, paramList);
+    FUNCTION_TEST_END();
+
+    ASSERT(paramList != NULL);
+
+    IoFilter *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        PackRead *const paramListPack = pckReadNew(paramList);
+        const CompressType type = (CompressType)pckReadU32P(paramListPack);
+        const int level = pckReadI32P(paramListPack);
+
+        result = ioFilterMove(compressProbeNew(type, level), memContextPrior());
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN(IO_FILTER, result);
+}
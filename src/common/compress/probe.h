@@ -0,0 +1,28 @@
+/***********************************************************************************************************************************
+Compress Probe Filter
+
+Probe the start of the data to decide how hard it should be compressed. Data that is already compressed (e.g. TOAST values
+compressed with pglz/lz4 or compressed large objects) gains little from compression, so compressing it at the configured level
+mostly wastes CPU. A sample from the first input is compressed at the fastest deflate level and if the sample does not shrink enough
+the data is compressed at the fastest level of the compression type instead. The output is a valid stream for the compression type
+either way so decompression does not need to know the result of the probe.
+
+The filter result is true when the data was compressed at the fastest level.
+***********************************************************************************************************************************/
+#ifndef COMMON_COMPRESS_PROBE_H
+#define COMMON_COMPRESS_PROBE_H
+
+#include "common/compress/helper.h"
+
+/***********************************************************************************************************************************
+Filter type constant
+***********************************************************************************************************************************/
+#define COMPRESS_PROBE_FILTER_TYPE                                  STRID5("probe-cmp", 0x1068f6513e500)
+
+/***********************************************************************************************************************************
+Constructors
+***********************************************************************************************************************************/
+IoFilter *compressProbeNew(CompressType type, int level);
+IoFilter *compressProbeNewPack(const Pack *paramList);
+
+#endif
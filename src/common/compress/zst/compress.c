@@ -5,8 +5,10 @@ ZST Compress
 
 #ifdef HAVE_LIBZST
 
+#include <zdict.h>
 #include <zstd.h>
 
+#include "common/compress/helper.h"
 #include "common/compress/zst/common.h"
 #include "common/compress/zst/compress.h"
 #include "common/debug.h"
@@ -164,10 +166,11 @@ zstCompressInputSame(const THIS_VOID)
 
 /**********************************************************************************************************************************/
 IoFilter *
-zstCompressNew(int level)
+zstCompressDictNew(const int level, const Buffer *const dict)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(INT, level);
+        FUNCTION_LOG_PARAM(BUFFER, dict);
     FUNCTION_LOG_END();
 
     ASSERT(level >= 0);
@@ -190,6 +193,16 @@ zstCompressNew(int level)
         // Initialize context
         zstError(ZSTD_initCStream(driver->context, driver->level));
 
+        // Load the dictionary. This must be done after the context is initialized since initialization clears the dictionary.
+        if (dict != NULL)
+        {
+#if ZSTD_VERSION_NUMBER >= 10400
+            zstError(ZSTD_CCtx_loadDictionary(driver->context, bufPtrConst(dict), bufUsed(dict)));
+#else
+            THROW(FormatError, "zst dictionary requires libzstd >= 1.4.0");
+#endif
+        }
+
         // Create param list
         Pack *paramList = NULL;
 
@@ -198,6 +211,9 @@ zstCompressNew(int level)
             PackWrite *const packWrite = pckWriteNewP();
 
             pckWriteI32P(packWrite, level);
+
+            if (dict != NULL)
+                compressDictFilterPackWrite(packWrite, compressTypeZst, dict);
             pckWriteEndP(packWrite);
 
             paramList = pckMove(pckWriteResult(packWrite), memContextPrior());
@@ -214,4 +230,58 @@ zstCompressNew(int level)
     FUNCTION_LOG_RETURN(IO_FILTER, this);
 }
 
+IoFilter *
+zstCompressNew(const int level)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(INT, level);
+    FUNCTION_LOG_END();
+
+    FUNCTION_LOG_RETURN(IO_FILTER, zstCompressDictNew(level, NULL));
+}
+
+/**********************************************************************************************************************************/
+unsigned int
+zstDictId(const Buffer *const dict)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BUFFER, dict);
+    FUNCTION_TEST_END();
+
+    ASSERT(dict != NULL);
+
+    FUNCTION_TEST_RETURN(UINT, ZDICT_getDictID(bufPtrConst(dict), bufUsed(dict)));
+}
+
+/**********************************************************************************************************************************/
+Buffer *
+zstDictTrain(const Buffer *const sample, const size_t *const sampleSizeList, const unsigned int sampleTotal, const size_t dictSize)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(BUFFER, sample);
+        FUNCTION_LOG_PARAM_P(VOID, sampleSizeList);
+        FUNCTION_LOG_PARAM(UINT, sampleTotal);
+        FUNCTION_LOG_PARAM(SIZE, dictSize);
+    FUNCTION_LOG_END();
+
+    ASSERT(sample != NULL);
+    ASSERT(sampleSizeList != NULL || sampleTotal == 0);
+    ASSERT(dictSize > 0);
+
+    Buffer *result = bufNew(dictSize);
+
+    // Training fails when there is not enough sample data to build a useful dictionary so return NULL rather than error
+    const size_t resultSize = ZDICT_trainFromBuffer(bufPtr(result), dictSize, bufPtrConst(sample), sampleSizeList, sampleTotal);
+
+    if (ZDICT_isError(resultSize))
+    {
+        bufFree(result);
+        result = NULL;
+    }
+    else
+        bufUsedSet(result, resultSize);
+
+    FUNCTION_LOG_RETURN(BUFFER, result);
+}
+
 #endif // HAVE_LIBZST
@@ -20,6 +20,20 @@ Constructors
 ***********************************************************************************************************************************/
 IoFilter *zstCompressNew(int level);
 
+// Compress using a dictionary created by zstDictTrain(). The same dictionary must be used to decompress.
+IoFilter *zstCompressDictNew(int level, const Buffer *dict);
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+// Get the id stored in a dictionary created by zstDictTrain(). The id is derived from the content of the dictionary. Returns 0 when
+// the dictionary does not have an id.
+unsigned int zstDictId(const Buffer *dict);
+
+// Train a dictionary from samples that are concatenated in the sample buffer. Returns NULL when a dictionary cannot be trained,
+// e.g. because there are too few samples.
+Buffer *zstDictTrain(const Buffer *sample, const size_t *sampleSizeList, unsigned int sampleTotal, size_t dictSize);
+
 #endif
 
 #endif // HAVE_LIBZST
@@ -7,12 +7,14 @@ ZST Decompress
 
 #include <zstd.h>
 
+#include "common/compress/helper.h"
 #include "common/compress/zst/common.h"
 #include "common/compress/zst/decompress.h"
 #include "common/debug.h"
 #include "common/io/filter/filter.h"
 #include "common/log.h"
 #include "common/type/object.h"
+#include "common/type/pack.h"
 
 /***********************************************************************************************************************************
 Object type
@@ -156,9 +158,11 @@ zstDecompressInputSame(const THIS_VOID)
 
 /**********************************************************************************************************************************/
 IoFilter *
-zstDecompressNew(void)
+zstDecompressDictNew(const Buffer *const dict)
 {
-    FUNCTION_LOG_VOID(logLevelTrace);
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(BUFFER, dict);
+    FUNCTION_LOG_END();
 
     IoFilter *this = NULL;
 
@@ -177,9 +181,32 @@ zstDecompressNew(void)
         // Initialize context
         zstError(ZSTD_initDStream(driver->context));
 
+        // Load the dictionary and create param list so the dictionary is available when the filter is created remotely
+        Pack *paramList = NULL;
+
+        if (dict != NULL)
+        {
+#if ZSTD_VERSION_NUMBER >= 10400
+            zstError(ZSTD_DCtx_loadDictionary(driver->context, bufPtrConst(dict), bufUsed(dict)));
+#else
+            THROW(FormatError, "zst dictionary requires libzstd >= 1.4.0");
+#endif
+
+            MEM_CONTEXT_TEMP_BEGIN()
+            {
+                PackWrite *const packWrite = pckWriteNewP();
+
+                compressDictFilterPackWrite(packWrite, compressTypeZst, dict);
+                pckWriteEndP(packWrite);
+
+                paramList = pckMove(pckWriteResult(packWrite), memContextPrior());
+            }
+            MEM_CONTEXT_TEMP_END();
+        }
+
         // Create filter interface
         this = ioFilterNewP(
-            ZST_DECOMPRESS_FILTER_TYPE, driver, NULL, .done = zstDecompressDone, .inOut = zstDecompressProcess,
+            ZST_DECOMPRESS_FILTER_TYPE, driver, paramList, .done = zstDecompressDone, .inOut = zstDecompressProcess,
             .inputSame = zstDecompressInputSame);
     }
     OBJ_NEW_END();
@@ -187,4 +214,11 @@ zstDecompressNew(void)
     FUNCTION_LOG_RETURN(IO_FILTER, this);
 }
 
+IoFilter *
+zstDecompressNew(void)
+{
+    FUNCTION_LOG_VOID(logLevelTrace);
+    FUNCTION_LOG_RETURN(IO_FILTER, zstDecompressDictNew(NULL));
+}
+
 #endif // HAVE_LIBZST
@@ -20,6 +20,9 @@ Constructors
 ***********************************************************************************************************************************/
 IoFilter *zstDecompressNew(void);
 
+// Decompress data that was compressed with a dictionary
+IoFilter *zstDecompressDictNew(const Buffer *dict);
+
 #endif
 
 #endif // HAVE_LIBZST
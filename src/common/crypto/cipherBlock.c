@@ -23,8 +23,7 @@ Header constants and sizes
 #define CIPHER_BLOCK_MAGIC                                          "Salted__"
 #define CIPHER_BLOCK_MAGIC_SIZE                                     (sizeof(CIPHER_BLOCK_MAGIC) - 1)
 
-// Total length of cipher header
-#define CIPHER_BLOCK_HEADER_SIZE                                    (CIPHER_BLOCK_MAGIC_SIZE + PKCS5_SALT_LEN)
+// The total length of the cipher header (CIPHER_BLOCK_HEADER_SIZE) is the magic size plus PKCS5_SALT_LEN
 
 /***********************************************************************************************************************************
 Object type
@@ -33,6 +32,7 @@ typedef struct CipherBlock
 {
     CipherMode mode;                                                // Mode encrypt/decrypt
     bool saltDone;                                                  // Has the salt been read/generated?
+    const unsigned char *saltResume;                                // Salt to use on encrypt instead of generating a salt
     bool processDone;                                               // Has any data been processed?
     size_t passSize;                                                // Size of passphrase in bytes
     unsigned char *pass;                                            // Passphrase used to generate encryption key
@@ -137,8 +137,12 @@ cipherBlockProcessBlock(CipherBlock *this, const unsigned char *source, size_t s
             destination += CIPHER_BLOCK_MAGIC_SIZE;
             destinationSize += CIPHER_BLOCK_MAGIC_SIZE;
 
-            // Add salt to the destination buffer
-            cryptoRandomBytes(destination, PKCS5_SALT_LEN);
+            // Add salt to the destination buffer. The salt is only provided when resuming an encrypt.
+            if (this->saltResume != NULL)
+                memcpy(destination, this->saltResume, PKCS5_SALT_LEN);
+            else
+                cryptoRandomBytes(destination, PKCS5_SALT_LEN);
+
             salt = destination;
             destination += PKCS5_SALT_LEN;
             destinationSize += PKCS5_SALT_LEN;
@@ -381,18 +385,22 @@ cipherBlockInputSame(const THIS_VOID)
 }
 
 /**********************************************************************************************************************************/
-IoFilter *
-cipherBlockNew(CipherMode mode, CipherType cipherType, const Buffer *pass, const String *digestName)
+static IoFilter *
+cipherBlockNewInternal(
+    const CipherMode mode, const CipherType cipherType, const Buffer *const pass, const String *const digestName,
+    const Buffer *const header)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(STRING_ID, mode);
         FUNCTION_LOG_PARAM(STRING_ID, cipherType);
         FUNCTION_TEST_PARAM(BUFFER, pass);                          // Use FUNCTION_TEST so passphrase is not logged
         FUNCTION_LOG_PARAM(STRING, digestName);
+        FUNCTION_LOG_PARAM(BUFFER, header);
     FUNCTION_LOG_END();
 
     ASSERT(pass != NULL);
     ASSERT(!bufEmpty(pass));
+    ASSERT(header == NULL || mode == cipherModeEncrypt);
 
     // Init crypto subsystem
     cryptoInit();
@@ -437,6 +445,20 @@ cipherBlockNew(CipherMode mode, CipherType cipherType, const Buffer *pass, const
         driver->pass = memNew(driver->passSize);
         memcpy(driver->pass, bufPtrConst(pass), driver->passSize);
 
+        // Store the salt from the header when resuming an encrypt
+        if (header != NULL)
+        {
+            if (bufUsed(header) != CIPHER_BLOCK_HEADER_SIZE ||
+                memcmp(bufPtrConst(header), CIPHER_BLOCK_MAGIC, CIPHER_BLOCK_MAGIC_SIZE) != 0)
+            {
+                THROW(CryptoError, "cipher header invalid");
+            }
+
+            unsigned char *const saltResume = memNew(PKCS5_SALT_LEN);
+            memcpy(saltResume, bufPtrConst(header) + CIPHER_BLOCK_MAGIC_SIZE, PKCS5_SALT_LEN);
+            driver->saltResume = saltResume;
+        }
+
         // Create param list
         Pack *paramList = NULL;
 
@@ -448,6 +470,7 @@ cipherBlockNew(CipherMode mode, CipherType cipherType, const Buffer *pass, const
             pckWriteU64P(packWrite, cipherType);
             pckWriteBinP(packWrite, pass);
             pckWriteStrP(packWrite, digestName);
+            pckWriteBinP(packWrite, header);
             pckWriteEndP(packWrite);
 
             paramList = pckMove(pckWriteResult(packWrite), memContextPrior());
@@ -464,6 +487,35 @@ cipherBlockNew(CipherMode mode, CipherType cipherType, const Buffer *pass, const
     FUNCTION_LOG_RETURN(IO_FILTER, this);
 }
 
+IoFilter *
+cipherBlockNew(const CipherMode mode, const CipherType cipherType, const Buffer *const pass, const String *const digestName)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STRING_ID, mode);
+        FUNCTION_LOG_PARAM(STRING_ID, cipherType);
+        FUNCTION_TEST_PARAM(BUFFER, pass);                          // Use FUNCTION_TEST so passphrase is not logged
+        FUNCTION_LOG_PARAM(STRING, digestName);
+    FUNCTION_LOG_END();
+
+    FUNCTION_LOG_RETURN(IO_FILTER, cipherBlockNewInternal(mode, cipherType, pass, digestName, NULL));
+}
+
+IoFilter *
+cipherBlockNewResume(
+    const CipherType cipherType, const Buffer *const pass, const String *const digestName, const Buffer *const header)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STRING_ID, cipherType);
+        FUNCTION_TEST_PARAM(BUFFER, pass);                          // Use FUNCTION_TEST so passphrase is not logged
+        FUNCTION_LOG_PARAM(STRING, digestName);
+        FUNCTION_LOG_PARAM(BUFFER, header);
+    FUNCTION_LOG_END();
+
+    ASSERT(header != NULL);
+
+    FUNCTION_LOG_RETURN(IO_FILTER, cipherBlockNewInternal(cipherModeEncrypt, cipherType, pass, digestName, header));
+}
+
 IoFilter *
 cipherBlockNewPack(const Pack *const paramList)
 {
@@ -476,8 +528,9 @@ cipherBlockNewPack(const Pack *const paramList)
         const CipherType cipherType = (CipherType)pckReadU64P(paramListPack);
         const Buffer *const pass = pckReadBinP(paramListPack);
         const String *const digestName = pckReadStrP(paramListPack);
+        const Buffer *const header = pckReadBinP(paramListPack);
 
-        result = ioFilterMove(cipherBlockNew(cipherMode, cipherType, pass, digestName), memContextPrior());
+        result = ioFilterMove(cipherBlockNewInternal(cipherMode, cipherType, pass, digestName, header), memContextPrior());
     }
     MEM_CONTEXT_TEMP_END();
 
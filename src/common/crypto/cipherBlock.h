@@ -12,10 +12,19 @@ Filter type constant
 ***********************************************************************************************************************************/
 #define CIPHER_BLOCK_FILTER_TYPE                                   STRID5("cipher-blk", 0x16c16e45441230)
 
+/***********************************************************************************************************************************
+Size of the header (magic and salt) at the beginning of encrypted data
+***********************************************************************************************************************************/
+#define CIPHER_BLOCK_HEADER_SIZE                                    16
+
 /***********************************************************************************************************************************
 Constructors
 ***********************************************************************************************************************************/
 IoFilter *cipherBlockNew(CipherMode mode, CipherType cipherType, const Buffer *pass, const String *digestName);
+
+// Encrypt with the salt in the header of data that was encrypted earlier with the same passphrase, so the same data is encrypted to
+// the same bytes. This allows an encrypt that was interrupted to be continued without decrypting the bytes already written.
+IoFilter *cipherBlockNewResume(CipherType cipherType, const Buffer *pass, const String *digestName, const Buffer *header);
 IoFilter *cipherBlockNewPack(const Pack *paramList);
 
 /***********************************************************************************************************************************
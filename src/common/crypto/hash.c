@@ -13,6 +13,7 @@ Cryptographic Hash
 #include "common/debug.h"
 #include "common/io/filter/filter.h"
 #include "common/log.h"
+#include "common/type/convert.h"
 #include "common/type/object.h"
 #include "common/type/pack.h"
 #include "common/crypto/common.h"
@@ -37,6 +38,9 @@ typedef struct CryptoHash
     EVP_MD_CTX *hashContext;                                        // Message hash context
     MD5_CTX *md5Context;                                            // MD5 context (used to bypass FIPS restrictions)
     Buffer *hash;                                                   // Hash in binary form
+    uint64_t splitSize;                                             // Size of the parts hashed separately (0 when not split)
+    uint64_t splitPos;                                              // Position in the current part
+    EVP_MD_CTX *splitContext;                                       // Hash context for the hashes of the parts
 } CryptoHash;
 
 /***********************************************************************************************************************************
@@ -63,6 +67,34 @@ cryptoHashFreeResource(THIS_VOID)
 
     EVP_MD_CTX_destroy(this->hashContext);
 
+    if (this->splitContext != NULL)
+        EVP_MD_CTX_destroy(this->splitContext);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Add the hash of the current part to the hash of the parts and start the next part
+***********************************************************************************************************************************/
+static void
+cryptoHashSplitPart(CryptoHash *const this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(CRYPTO_HASH, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->splitContext != NULL);
+
+    unsigned char partHash[EVP_MAX_MD_SIZE];
+    unsigned int partHashSize = 0;
+
+    cryptoError(!EVP_DigestFinal_ex(this->hashContext, partHash, &partHashSize), "unable to finalize message hash");
+    cryptoError(!EVP_DigestUpdate(this->splitContext, partHash, partHashSize), "unable to process message hash");
+    cryptoError(!EVP_DigestInit_ex(this->hashContext, this->hashType, NULL), "unable to initialize hash context");
+
+    this->splitPos = 0;
+
     FUNCTION_LOG_RETURN_VOID();
 }
 
@@ -83,8 +115,30 @@ cryptoHashProcess(THIS_VOID, const Buffer *message)
     ASSERT(this->hash == NULL);
     ASSERT(message != NULL);
 
-    // Standard OpenSSL implementation
-    if (this->hashContext != NULL)
+    // Hash each part separately when split
+    if (this->splitSize != 0)
+    {
+        size_t messagePos = 0;
+
+        while (messagePos < bufUsed(message))
+        {
+            size_t partSize = bufUsed(message) - messagePos;
+
+            if (partSize > this->splitSize - this->splitPos)
+                partSize = (size_t)(this->splitSize - this->splitPos);
+
+            cryptoError(
+                !EVP_DigestUpdate(this->hashContext, bufPtrConst(message) + messagePos, partSize), "unable to process message hash");
+
+            messagePos += partSize;
+            this->splitPos += partSize;
+
+            if (this->splitPos == this->splitSize)
+                cryptoHashSplitPart(this);
+        }
+    }
+    // Else standard OpenSSL implementation
+    else if (this->hashContext != NULL)
     {
         cryptoError(!EVP_DigestUpdate(this->hashContext, bufPtrConst(message), bufUsed(message)), "unable to process message hash");
     }
@@ -111,8 +165,17 @@ cryptoHash(CryptoHash *this)
     {
         MEM_CONTEXT_OBJ_BEGIN(this)
         {
-            // Standard OpenSSL implementation
-            if (this->hashContext != NULL)
+            // Hash of the part hashes when split. The last part is added unless it is empty.
+            if (this->splitSize != 0)
+            {
+                if (this->splitPos != 0)
+                    cryptoHashSplitPart(this);
+
+                this->hash = bufNew((size_t)EVP_MD_size(this->hashType));
+                cryptoError(!EVP_DigestFinal_ex(this->splitContext, bufPtr(this->hash), NULL), "unable to finalize message hash");
+            }
+            // Else standard OpenSSL implementation
+            else if (this->hashContext != NULL)
             {
                 this->hash = bufNew((size_t)EVP_MD_size(this->hashType));
                 cryptoError(!EVP_DigestFinal_ex(this->hashContext, bufPtr(this->hash), NULL), "unable to finalize message hash");
@@ -170,7 +233,19 @@ cryptoHashNew(const HashType type)
         FUNCTION_LOG_PARAM(STRING_ID, type);
     FUNCTION_LOG_END();
 
+    FUNCTION_LOG_RETURN(IO_FILTER, cryptoHashNewSplit(type, 0));
+}
+
+IoFilter *
+cryptoHashNewSplit(const HashType type, const uint64_t splitSize)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STRING_ID, type);
+        FUNCTION_LOG_PARAM(UINT64, splitSize);
+    FUNCTION_LOG_END();
+
     ASSERT(type != 0);
+    ASSERT(splitSize == 0 || type != hashTypeMd5);
 
     // Init crypto subsystem
     cryptoInit();
@@ -210,6 +285,16 @@ cryptoHashNew(const HashType type)
 
             // Initialize context
             cryptoError(!EVP_DigestInit_ex(driver->hashContext, driver->hashType, NULL), "unable to initialize hash context");
+
+            // Create context for the hashes of the parts when split
+            if (splitSize != 0)
+            {
+                driver->splitSize = splitSize;
+
+                cryptoError((driver->splitContext = EVP_MD_CTX_create()) == NULL, "unable to create hash context");
+                cryptoError(
+                    !EVP_DigestInit_ex(driver->splitContext, driver->hashType, NULL), "unable to initialize hash context");
+            }
         }
 
         // Create param list
@@ -220,6 +305,7 @@ cryptoHashNew(const HashType type)
             PackWrite *const packWrite = pckWriteNewP();
 
             pckWriteStrIdP(packWrite, type);
+            pckWriteU64P(packWrite, splitSize);
             pckWriteEndP(packWrite);
 
             paramList = pckMove(pckWriteResult(packWrite), memContextPrior());
@@ -245,7 +331,10 @@ cryptoHashNewPack(const Pack *const paramList)
 
     MEM_CONTEXT_TEMP_BEGIN()
     {
-        result = ioFilterMove(cryptoHashNew(pckReadStrIdP(pckReadNew(paramList))), memContextPrior());
+        PackRead *const paramListPack = pckReadNew(paramList);
+        const HashType type = pckReadStrIdP(paramListPack);
+
+        result = ioFilterMove(cryptoHashNewSplit(type, pckReadU64P(paramListPack)), memContextPrior());
     }
     MEM_CONTEXT_TEMP_END();
 
@@ -286,6 +375,106 @@ cryptoHashOne(const HashType type, const Buffer *message)
     FUNCTION_LOG_RETURN(BUFFER, result);
 }
 
+/**********************************************************************************************************************************/
+String *
+cryptoHashPartial(IoFilter *const filter)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(IO_FILTER, filter);
+    FUNCTION_LOG_END();
+
+    ASSERT(filter != NULL);
+    ASSERT(ioFilterType(filter) == CRYPTO_HASH_FILTER_TYPE);
+
+    const CryptoHash *const this = ioFilterDriver(filter);
+    ASSERT(this->hash == NULL);
+    ASSERT(this->splitSize == 0);
+
+    String *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        Buffer *hash = NULL;
+
+        // Finalize a copy of the context so the filter can continue to process data
+        if (this->hashContext != NULL)
+        {
+            hash = bufNew((size_t)EVP_MD_size(this->hashType));
+
+            EVP_MD_CTX *const hashContext = EVP_MD_CTX_create();
+            cryptoError(hashContext == NULL, "unable to create hash context");
+
+            TRY_BEGIN()
+            {
+                cryptoError(!EVP_MD_CTX_copy_ex(hashContext, this->hashContext), "unable to copy hash context");
+                cryptoError(!EVP_DigestFinal_ex(hashContext, bufPtr(hash), NULL), "unable to finalize message hash");
+            }
+            FINALLY()
+            {
+                EVP_MD_CTX_destroy(hashContext);
+            }
+            TRY_END();
+        }
+        // Else local MD5 implementation
+        else
+        {
+            hash = bufNew(HASH_TYPE_M5_SIZE);
+
+            MD5_CTX md5Context = *this->md5Context;
+            MD5_Final(bufPtr(hash), &md5Context);
+        }
+
+        bufUsedSet(hash, bufSize(hash));
+
+        MEM_CONTEXT_PRIOR_BEGIN()
+        {
+            result = bufHex(hash);
+        }
+        MEM_CONTEXT_PRIOR_END();
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(STRING, result);
+}
+
+/**********************************************************************************************************************************/
+String *
+cryptoHashSplitCombine(const HashType type, const String *const partHashList)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STRING_ID, type);
+        FUNCTION_LOG_PARAM(STRING, partHashList);
+    FUNCTION_LOG_END();
+
+    ASSERT(type != 0 && type != hashTypeMd5);
+    ASSERT(partHashList != NULL);
+    ASSERT(strSize(partHashList) % 2 == 0);
+
+    String *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Convert the part hashes to binary
+        Buffer *const partHash = bufNew(strSize(partHashList) / 2);
+
+        for (size_t partHashIdx = 0; partHashIdx < bufSize(partHash); partHashIdx++)
+            bufPtr(partHash)[partHashIdx] = (uint8_t)cvtZSubNToUIntBase(strZ(partHashList), partHashIdx * 2, 2, 16);
+
+        bufUsedSet(partHash, bufSize(partHash));
+
+        const Buffer *const hash = cryptoHashOne(type, partHash);
+
+        MEM_CONTEXT_PRIOR_BEGIN()
+        {
+            result = bufHex(hash);
+        }
+        MEM_CONTEXT_PRIOR_END();
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(STRING, result);
+}
+
 /**********************************************************************************************************************************/
 Buffer *
 cryptoHmacOne(const HashType type, const Buffer *const key, const Buffer *const message)
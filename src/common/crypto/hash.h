@@ -43,12 +43,24 @@ Constructors
 IoFilter *cryptoHashNew(HashType type);
 IoFilter *cryptoHashNewPack(const Pack *paramList);
 
+// The data is hashed in parts of splitSize bytes (the last part may be smaller) and the result is the hash of the binary part
+// hashes. This is the hash of a file that is backed up in parts, which can be calculated without reading the parts in order.
+IoFilter *cryptoHashNewSplit(HashType type, uint64_t splitSize);
+
 /***********************************************************************************************************************************
 Helper functions
 ***********************************************************************************************************************************/
 // Get hash for one buffer
 Buffer *cryptoHashOne(HashType type, const Buffer *message);
 
+// Get the hash of the data processed so far by a hash filter. The filter can continue to process data, e.g. when the hash of a
+// prefix of the data is needed.
+String *cryptoHashPartial(IoFilter *filter);
+
+// Get the hash of a file backed up in parts from the part hashes, which are concatenated in hex form. This is the same hash that
+// the split hash filter produces for the file.
+String *cryptoHashSplitCombine(HashType type, const String *partHashList);
+
 // Get hmac for one message/key
 Buffer *cryptoHmacOne(HashType type, const Buffer *key, const Buffer *message);
 
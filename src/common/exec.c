@@ -18,6 +18,7 @@ Execute Process
 #include "common/io/fdWrite.h"
 #include "common/io/io.h"
 #include "common/io/read.h"
+#include "common/io/ring.h"
 #include "common/io/write.h"
 #include "common/wait.h"
 
@@ -29,6 +30,8 @@ struct Exec
     ExecPub pub;                                                    // Publicly accessible variables
     String *command;                                                // Command to execute
     StringList *param;                                              // List of parameters to pass to command
+    ExecForkFunction fork;                                          // Function to call in child process instead of command
+    size_t ringSize;                                                // Size of shared memory rings used by forked process
     const String *name;                                             // Name to display in log/error messages
     TimeMSec timeout;                                               // Timeout for any i/o operation (read, write, etc.)
 
@@ -38,8 +41,11 @@ struct Exec
     int fdWrite;                                                    // Write file descriptor
     int fdError;                                                    // Error file descriptor
 
-    IoRead *ioReadFd;                                               // File descriptor read interface
-    IoWrite *ioWriteFd;                                             // File descriptor write interface
+    IoRing *ringRead;                                               // Shared memory ring read by the parent process
+    IoRing *ringWrite;                                              // Shared memory ring written by the parent process
+
+    IoRead *ioReadFd;                                               // File descriptor (or ring) read interface
+    IoWrite *ioWriteFd;                                             // File descriptor (or ring) write interface
 };
 
 /***********************************************************************************************************************************
@@ -79,6 +85,13 @@ execFreeResource(THIS_VOID)
 
     ASSERT(this != NULL);
 
+    // Free rings first so the child sees eof when the rings are being used instead of the pipes
+    if (this->ringRead != NULL)
+    {
+        ioRingFree(this->ringRead);
+        ioRingFree(this->ringWrite);
+    }
+
     // Close file descriptors
     close(this->fdRead);
     close(this->fdWrite);
@@ -112,18 +125,23 @@ execFreeResource(THIS_VOID)
 
 /**********************************************************************************************************************************/
 Exec *
-execNew(const String *command, const StringList *param, const String *name, TimeMSec timeout)
+execNew(
+    const String *const command, const StringList *const paramList, const String *const name, const TimeMSec timeout,
+    const ExecNewParam param)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug)
         FUNCTION_LOG_PARAM(STRING, command);
-        FUNCTION_LOG_PARAM(STRING_LIST, param);
+        FUNCTION_LOG_PARAM(STRING_LIST, paramList);
         FUNCTION_LOG_PARAM(STRING, name);
         FUNCTION_LOG_PARAM(TIME_MSEC, timeout);
+        FUNCTION_LOG_PARAM(FUNCTIONP, param.fork);
+        FUNCTION_LOG_PARAM(SIZE, param.ringSize);
     FUNCTION_LOG_END();
 
     ASSERT(command != NULL);
     ASSERT(name != NULL);
     ASSERT(timeout > 0);
+    ASSERT(param.ringSize == 0 || param.fork != NULL);
 
     Exec *this = NULL;
 
@@ -136,9 +154,11 @@ execNew(const String *command, const StringList *param, const String *name, Time
             .command = strDup(command),
             .name = strDup(name),
             .timeout = timeout,
+            .fork = param.fork,
+            .ringSize = param.ringSize,
 
             // Parameter list is optional but if not specified we need to build one with the command
-            .param = param == NULL ? strLstNew() : strLstDup(param),
+            .param = paramList == NULL ? strLstNew() : strLstDup(paramList),
         };
 
         // The first parameter must be the command
@@ -294,7 +314,7 @@ execFdRead(const THIS_VOID)
 
     ASSERT(this != NULL);
 
-    FUNCTION_TEST_RETURN(INT, this->fdRead);
+    FUNCTION_TEST_RETURN(INT, this->ringSize > 0 ? ioReadFd(this->ioReadFd) : this->fdRead);
 }
 
 /**********************************************************************************************************************************/
@@ -317,6 +337,17 @@ execOpen(Exec *this)
     THROW_ON_SYS_ERROR(pipe(pipeWrite) == -1, KernelError, "unable to create write pipe");
     THROW_ON_SYS_ERROR(pipe(pipeError) == -1, KernelError, "unable to create error pipe");
 
+    // Create shared memory rings to use instead of the read/write pipes in a forked process
+    if (this->ringSize > 0)
+    {
+        MEM_CONTEXT_OBJ_BEGIN(this)
+        {
+            this->ringRead = ioRingNew(this->ringSize);
+            this->ringWrite = ioRingNew(this->ringSize);
+        }
+        MEM_CONTEXT_OBJ_END();
+    }
+
     // Fork the subprocess
     this->processId = forkSafe();
 
@@ -335,6 +366,36 @@ execOpen(Exec *this)
         // Assign stderr to the input side of the error pipe
         PIPE_DUP2(pipeError, 1, STDERR_FILENO);
 
+        // Call the function rather than executing the command when requested. Exit immediately when the function returns so exit
+        // paths that might free parent resources are not executed.
+        if (this->fork != NULL)
+        {
+            IoRead *forkRead;
+            IoWrite *forkWrite;
+
+            MEM_CONTEXT_OBJ_BEGIN(this)
+            {
+                // Communicate using the rings when they exist
+                if (this->ringSize > 0)
+                {
+                    forkRead = ioRingReadNew(strNewFmt("%s ring read", strZ(this->name)), this->ringWrite, this->timeout);
+                    forkWrite = ioRingWriteNew(strNewFmt("%s ring write", strZ(this->name)), this->ringRead, this->timeout);
+                }
+                // Else communicate using stdin/stdout
+                else
+                {
+                    forkRead = ioFdReadNew(strNewFmt("%s read", strZ(this->name)), STDIN_FILENO, this->timeout);
+                    forkWrite = ioFdWriteNew(strNewFmt("%s write", strZ(this->name)), STDOUT_FILENO, this->timeout);
+                }
+
+                ioReadOpen(forkRead);
+                ioWriteOpen(forkWrite);
+            }
+            MEM_CONTEXT_OBJ_END();
+
+            exit(this->fork(this->param, forkRead, forkWrite));
+        }
+
         // Execute the binary.  This statement will not return if it is successful
         execvp(strZ(this->command), (char ** const)strLstPtr(this->param));
 
@@ -356,9 +417,19 @@ execOpen(Exec *this)
 
     MEM_CONTEXT_OBJ_BEGIN(this)
     {
-        // Assign file descriptors to io interfaces
-        this->ioReadFd = ioFdReadNew(strNewFmt("%s read", strZ(this->name)), this->fdRead, this->timeout);
-        this->ioWriteFd = ioFdWriteNewOpen(strNewFmt("%s write", strZ(this->name)), this->fdWrite, this->timeout);
+        // Assign rings to io interfaces when they exist
+        if (this->ringSize > 0)
+        {
+            this->ioReadFd = ioRingReadNew(strNewFmt("%s ring read", strZ(this->name)), this->ringRead, this->timeout);
+            this->ioWriteFd = ioRingWriteNew(strNewFmt("%s ring write", strZ(this->name)), this->ringWrite, this->timeout);
+            ioWriteOpen(this->ioWriteFd);
+        }
+        // Else assign file descriptors to io interfaces
+        else
+        {
+            this->ioReadFd = ioFdReadNew(strNewFmt("%s read", strZ(this->name)), this->fdRead, this->timeout);
+            this->ioWriteFd = ioFdWriteNewOpen(strNewFmt("%s write", strZ(this->name)), this->fdWrite, this->timeout);
+        }
 
         // Create wrapper interfaces that check process state
         this->pub.ioReadExec = ioReadNewP(this, .block = true, .read = execRead, .eof = execEof, .fd = execFdRead);
@@ -22,7 +22,23 @@ typedef struct Exec Exec;
 /***********************************************************************************************************************************
 Constructors
 ***********************************************************************************************************************************/
-Exec *execNew(const String *command, const StringList *param, const String *name, TimeMSec timeout);
+// Function called in the child process instead of executing the command. The parameter list is the same one that would be passed to
+// the command (including the command as the first parameter) and the return value is used as the exit code of the child process.
+// The read/write interfaces communicate with the parent process. Errors must not be thrown from this function since they would be
+// caught by handlers that belong to the parent process.
+typedef int (*ExecForkFunction)(const StringList *param, IoRead *read, IoWrite *write);
+
+typedef struct ExecNewParam
+{
+    VAR_PARAM_HEADER;
+    ExecForkFunction fork;                                          // Call function in child process rather than executing command
+    size_t ringSize;                                                // Communicate with forked process using shared memory rings
+} ExecNewParam;
+
+#define execNewP(command, paramList, name, timeout, ...)                                                                           \
+    execNew(command, paramList, name, timeout, (ExecNewParam){VAR_PARAM_INIT, __VA_ARGS__})
+
+Exec *execNew(const String *command, const StringList *paramList, const String *name, TimeMSec timeout, ExecNewParam param);
 
 /***********************************************************************************************************************************
 Getters/Setters
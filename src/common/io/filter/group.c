@@ -11,6 +11,7 @@ IO Filter Group
 #include "common/io/filter/group.h"
 #include "common/io/io.h"
 #include "common/log.h"
+#include "common/stat.h"
 #include "common/type/list.h"
 
 /***********************************************************************************************************************************
@@ -24,6 +25,7 @@ typedef struct IoFilterData
     Buffer *inputLocal;                                             // Non-null if a locally created buffer that can be cleared
     IoFilter *filter;                                               // Filter to apply
     Buffer *output;                                                 // Output buffer for filter
+    uint64_t time;                                                  // Time spent processing in microseconds
 } IoFilterData;
 
 // Macros for logging
@@ -39,6 +41,7 @@ typedef struct IoFilterResult
 {
     StringId type;                                                  // Filter type
     Pack *result;                                                   // Filter result
+    uint64_t time;                                                  // Time spent processing in microseconds
 } IoFilterResult;
 
 /***********************************************************************************************************************************
@@ -145,6 +148,30 @@ ioFilterGroupGet(const IoFilterGroup *this, unsigned int filterIdx)
     FUNCTION_TEST_RETURN(IO_FILTER_DATA, (IoFilterData *)lstGet(this->pub.filterList, filterIdx));
 }
 
+/**********************************************************************************************************************************/
+bool
+ioFilterGroupOutput(const IoFilterGroup *const this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(IO_FILTER_GROUP, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    bool result = false;
+
+    for (unsigned int filterIdx = 0; filterIdx < ioFilterGroupSize(this); filterIdx++)
+    {
+        if (ioFilterOutput(ioFilterGroupGet(this, filterIdx)->filter))
+        {
+            result = true;
+            break;
+        }
+    }
+
+    FUNCTION_TEST_RETURN(BOOL, result);
+}
+
 /**********************************************************************************************************************************/
 IoFilterGroup *
 ioFilterGroupClear(IoFilterGroup *this)
@@ -295,9 +322,12 @@ ioFilterGroupProcess(IoFilterGroup *this, const Buffer *input, Buffer *output)
             if (!ioFilterDone(filterData->filter))
             {
                 // If the filter produces output
+                const uint64_t timeBegin = statTimeBegin();
+
                 if (ioFilterOutput(filterData->filter))
                 {
                     ioFilterProcessInOut(filterData->filter, *filterData->input, filterData->output);
+                    filterData->time += statTimeBegin() - timeBegin;
 
                     // If inputSame is set then the output buffer for this filter is full and it will need to be re-processed with
                     // the same input once the output buffer is cleared
@@ -316,7 +346,10 @@ ioFilterGroupProcess(IoFilterGroup *this, const Buffer *input, Buffer *output)
                 }
                 // Else the filter does not produce output
                 else
+                {
                     ioFilterProcessIn(filterData->filter, *filterData->input);
+                    filterData->time += statTimeBegin() - timeBegin;
+                }
             }
 
             // If the filter is done and has no more output then null the output buffer.  Downstream filters have a pointer to this
@@ -364,16 +397,21 @@ ioFilterGroupClose(IoFilterGroup *this)
     ASSERT(this != NULL);
     ASSERT(this->pub.opened && !this->pub.closed);
 
-    // Gather results from the filters
+    // Gather results and processing time from the filters
     for (unsigned int filterIdx = 0; filterIdx < ioFilterGroupSize(this); filterIdx++)
     {
-        IoFilter *const filter = ioFilterGroupGet(this, filterIdx)->filter;
+        const IoFilterData *const filterData = ioFilterGroupGet(this, filterIdx);
+        IoFilter *const filter = filterData->filter;
 
         MEM_CONTEXT_BEGIN(lstMemContext(this->filterResult))
         {
-            lstAdd(this->filterResult, &(IoFilterResult){.type = ioFilterType(filter), .result = ioFilterResult(filter)});
+            lstAdd(
+                this->filterResult,
+                &(IoFilterResult){.type = ioFilterType(filter), .result = ioFilterResult(filter), .time = filterData->time});
         }
         MEM_CONTEXT_END();
+
+        statLatency(statKeyStrId(IO_FILTER_STAT_LATENCY, ioFilterType(filter)), filterData->time);
     }
 
     // Filter group is open
@@ -419,20 +457,22 @@ ioFilterGroupParamAll(const IoFilterGroup *this)
     FUNCTION_LOG_RETURN(PACK, result);
 }
 
-/**********************************************************************************************************************************/
-const Pack *
-ioFilterGroupResultPack(const IoFilterGroup *const this, const StringId filterType, const IoFilterGroupResultParam param)
+/***********************************************************************************************************************************
+Find a filter result
+***********************************************************************************************************************************/
+static const IoFilterResult *
+ioFilterGroupResultFind(const IoFilterGroup *const this, const StringId filterType, const unsigned int idx)
 {
-    FUNCTION_LOG_BEGIN(logLevelDebug);
-        FUNCTION_LOG_PARAM(IO_FILTER_GROUP, this);
-        FUNCTION_LOG_PARAM(STRING_ID, filterType);
-        FUNCTION_LOG_PARAM(UINT, param.idx);
-    FUNCTION_LOG_END();
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(IO_FILTER_GROUP, this);
+        FUNCTION_TEST_PARAM(STRING_ID, filterType);
+        FUNCTION_TEST_PARAM(UINT, idx);
+    FUNCTION_TEST_END();
 
     ASSERT(this->pub.opened);
     ASSERT(filterType != 0);
 
-    const Pack *result = NULL;
+    const IoFilterResult *result = NULL;
 
     // Search for the result
     unsigned int foundIdx = 0;
@@ -445,9 +485,9 @@ ioFilterGroupResultPack(const IoFilterGroup *const this, const StringId filterTy
         if (filterResult->type == filterType)
         {
             // If the index matches return the result
-            if (foundIdx == param.idx)
+            if (foundIdx == idx)
             {
-                result = filterResult->result;
+                result = filterResult;
                 break;
             }
 
@@ -456,7 +496,37 @@ ioFilterGroupResultPack(const IoFilterGroup *const this, const StringId filterTy
         }
     }
 
-    FUNCTION_LOG_RETURN_CONST(PACK, result);
+    FUNCTION_TEST_RETURN_TYPE_CONST_P(IoFilterResult, result);
+}
+
+/**********************************************************************************************************************************/
+const Pack *
+ioFilterGroupResultPack(const IoFilterGroup *const this, const StringId filterType, const IoFilterGroupResultParam param)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(IO_FILTER_GROUP, this);
+        FUNCTION_LOG_PARAM(STRING_ID, filterType);
+        FUNCTION_LOG_PARAM(UINT, param.idx);
+    FUNCTION_LOG_END();
+
+    const IoFilterResult *const filterResult = ioFilterGroupResultFind(this, filterType, param.idx);
+
+    FUNCTION_LOG_RETURN_CONST(PACK, filterResult == NULL ? NULL : filterResult->result);
+}
+
+/**********************************************************************************************************************************/
+uint64_t
+ioFilterGroupResultTime(const IoFilterGroup *const this, const StringId filterType, const IoFilterGroupResultParam param)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(IO_FILTER_GROUP, this);
+        FUNCTION_LOG_PARAM(STRING_ID, filterType);
+        FUNCTION_LOG_PARAM(UINT, param.idx);
+    FUNCTION_LOG_END();
+
+    const IoFilterResult *const filterResult = ioFilterGroupResultFind(this, filterType, param.idx);
+
+    FUNCTION_LOG_RETURN(UINT64, filterResult == NULL ? 0 : filterResult->time);
 }
 
 /**********************************************************************************************************************************/
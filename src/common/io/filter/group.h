@@ -21,6 +21,11 @@ typedef struct IoFilterGroup IoFilterGroup;
 #include "common/type/pack.h"
 #include "common/type/stringId.h"
 
+/***********************************************************************************************************************************
+Statistics constants
+***********************************************************************************************************************************/
+#define IO_FILTER_STAT_LATENCY                                      "filter.latency"    // Time per file (filter type is appended)
+
 /***********************************************************************************************************************************
 Constructors
 ***********************************************************************************************************************************/
@@ -78,6 +83,13 @@ PackRead *ioFilterGroupResult(const IoFilterGroup *this, StringId filterType, Io
 
 const Pack *ioFilterGroupResultPack(const IoFilterGroup *this, StringId filterType, IoFilterGroupResultParam param);
 
+// Get time in microseconds spent processing in a filter. Time is only available for filters that were processed by this process, so
+// time will be zero for filters that were processed remotely.
+#define ioFilterGroupResultTimeP(this, filterType, ...)                                                                            \
+    ioFilterGroupResultTime(this, filterType, (IoFilterGroupResultParam){VAR_PARAM_INIT, __VA_ARGS__})
+
+uint64_t ioFilterGroupResultTime(const IoFilterGroup *this, StringId filterType, IoFilterGroupResultParam param);
+
 // Get/set all filter results
 Pack *ioFilterGroupResultAll(const IoFilterGroup *this);
 void ioFilterGroupResultAllSet(IoFilterGroup *this, const Pack *filterResult);
@@ -95,6 +107,9 @@ Functions
 // Add a filter
 IoFilterGroup *ioFilterGroupAdd(IoFilterGroup *this, IoFilter *filter);
 
+// Do any filters in the group produce output? When none do the data passes through the group unchanged.
+bool ioFilterGroupOutput(const IoFilterGroup *this);
+
 // Insert a filter before an index
 IoFilterGroup *ioFilterGroupInsert(IoFilterGroup *this, unsigned int listIdx, IoFilter *filter);
 
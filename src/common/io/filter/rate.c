@@ -0,0 +1,408 @@
+/***********************************************************************************************************************************
+IO Rate Filter
+***********************************************************************************************************************************/
+#include "build.auto.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "common/debug.h"
+#include "common/io/filter/filter.h"
+#include "common/io/filter/rate.h"
+#include "common/log.h"
+#include "common/time.h"
+#include "common/type/object.h"
+#include "common/type/pack.h"
+#include "storage/posix/storage.h"
+
+/***********************************************************************************************************************************
+Constants
+***********************************************************************************************************************************/
+#define USEC_PER_SEC                                                ((uint64_t)1000000)
+#define USEC_PER_MSEC                                               ((uint64_t)1000)
+
+// Boot times that differ by less than this many seconds are considered to be the same boot since the system time may be adjusted
+#define IO_RATE_BOOT_TOLERANCE                                      60
+
+/***********************************************************************************************************************************
+Buckets shared between processes. Each bucket is stored as the time when the tokens taken so far will have been replenished, which
+allows tokens to be taken with a single compare and swap. The time is taken from the monotonic clock so it is not affected by
+changes to the system time. Buckets left over from earlier processes are simply full since their times are in the past. Buckets left
+over from before a reboot are reset when the file is mapped since the monotonic clock restarts at boot and their times may be far in
+the future.
+***********************************************************************************************************************************/
+typedef struct IoRateShared
+{
+    uint64_t bootTime;                                              // System time in seconds when the monotonic clock started
+    uint64_t byteTime[ioRateTypeWrite + 1];                         // Byte buckets for each type
+    uint64_t opTime;                                                // I/O operation bucket
+} IoRateShared;
+
+/***********************************************************************************************************************************
+Local data
+***********************************************************************************************************************************/
+static struct
+{
+    MemContext *memContext;                                         // Mem context to store data in this struct
+    String *file;                                                   // File set by ioRateInit()
+    uint64_t byteRate[ioRateTypeWrite + 1];                         // Byte rates set by ioRateInit()
+    uint64_t opRate;                                                // I/O operation rate set by ioRateInit()
+
+    String *sharedFile;                                             // File that is currently mapped
+    IoRateShared *shared;                                           // Buckets mapped from the file
+} ioRateLocal;
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct IoRate
+{
+    IoRateShared *shared;                                           // Shared buckets
+    IoRateType type;                                                // Rate type
+    uint64_t byteRate;                                              // Bytes per second
+    uint64_t opRate;                                                // I/O operations per second
+    uint64_t waitTotal;                                             // Total time waited in milliseconds
+} IoRate;
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+#define FUNCTION_LOG_IO_RATE_TYPE                                                                                                  \
+    IoRate *
+#define FUNCTION_LOG_IO_RATE_FORMAT(value, buffer, bufferSize)                                                                     \
+    objToLog(value, "IoRate", buffer, bufferSize)
+
+/***********************************************************************************************************************************
+Get the system time in seconds when the monotonic clock started, i.e. the boot time on most systems
+***********************************************************************************************************************************/
+static uint64_t
+ioRateBootTime(void)
+{
+    FUNCTION_TEST_VOID();
+
+    struct timespec timeReal;
+    struct timespec timeMonotonic;
+
+    clock_gettime(CLOCK_REALTIME, &timeReal);
+    clock_gettime(CLOCK_MONOTONIC, &timeMonotonic);
+
+    FUNCTION_TEST_RETURN(UINT64, (uint64_t)(timeReal.tv_sec - timeMonotonic.tv_sec));
+}
+
+/***********************************************************************************************************************************
+Map the shared buckets from the file, creating it if needed. The mapping is kept for the life of the process and reused by all the
+filters created for the same file.
+***********************************************************************************************************************************/
+static IoRateShared *
+ioRateShared(const String *const file)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, file);
+    FUNCTION_TEST_END();
+
+    ASSERT(file != NULL);
+
+    if (!strEq(file, ioRateLocal.sharedFile))
+    {
+        // Open the file, creating it if it does not exist
+        int fd = open(strZ(file), O_RDWR | O_CREAT, STORAGE_MODE_FILE_DEFAULT);
+
+        // If the path does not exist then create it and try again
+        if (fd == -1 && errno == ENOENT)
+        {
+            storagePathCreateP(storagePosixNewP(FSLASH_STR, .write = true), strPath(file));
+            fd = open(strZ(file), O_RDWR | O_CREAT, STORAGE_MODE_FILE_DEFAULT);
+        }
+
+        THROW_ON_SYS_ERROR_FMT(fd == -1, FileOpenError, "unable to open rate file '%s'", strZ(file));
+
+        void *shared = MAP_FAILED;
+
+        TRY_BEGIN()
+        {
+            // Extend the file to the size of the buckets. This does not change the buckets if the file already exists.
+            THROW_ON_SYS_ERROR_FMT(
+                ftruncate(fd, sizeof(IoRateShared)) == -1, FileWriteError, "unable to size rate file '%s'", strZ(file));
+
+            shared = mmap(NULL, sizeof(IoRateShared), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            THROW_ON_SYS_ERROR_FMT(shared == MAP_FAILED, KernelError, "unable to map rate file '%s'", strZ(file));
+        }
+        FINALLY()
+        {
+            close(fd);
+        }
+        TRY_END();
+
+        // Reset the buckets if they were left over from before a reboot. Only the process that updates the boot time resets the
+        // buckets so tokens taken by processes that mapped the file after the reset are not lost.
+        IoRateShared *const rateShared = shared;
+        const uint64_t bootTime = ioRateBootTime();
+        uint64_t bootTimeOld = __atomic_load_n(&rateShared->bootTime, __ATOMIC_SEQ_CST);
+
+        if ((bootTimeOld > bootTime ? bootTimeOld - bootTime : bootTime - bootTimeOld) > IO_RATE_BOOT_TOLERANCE &&
+            __atomic_compare_exchange_n(&rateShared->bootTime, &bootTimeOld, bootTime, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+        {
+            for (unsigned int typeIdx = 0; typeIdx <= ioRateTypeWrite; typeIdx++)
+                __atomic_store_n(&rateShared->byteTime[typeIdx], 0, __ATOMIC_SEQ_CST);
+
+            __atomic_store_n(&rateShared->opTime, 0, __ATOMIC_SEQ_CST);
+        }
+
+        // A prior mapping is not unmapped since filters may still reference it. Only one file is used per process in practice.
+        if (ioRateLocal.memContext == NULL)
+        {
+            MEM_CONTEXT_BEGIN(memContextTop())
+            {
+                MEM_CONTEXT_NEW_BEGIN(IoRateLocalData, .childQty = MEM_CONTEXT_QTY_MAX)
+                {
+                    ioRateLocal.memContext = MEM_CONTEXT_NEW();
+                }
+                MEM_CONTEXT_NEW_END();
+            }
+            MEM_CONTEXT_END();
+        }
+
+        MEM_CONTEXT_BEGIN(ioRateLocal.memContext)
+        {
+            strFree(ioRateLocal.sharedFile);
+            ioRateLocal.sharedFile = strDup(file);
+            ioRateLocal.shared = rateShared;
+        }
+        MEM_CONTEXT_END();
+    }
+
+    FUNCTION_TEST_RETURN_P(VOID, ioRateLocal.shared);
+}
+
+/***********************************************************************************************************************************
+Take tokens from a bucket and return how long to wait (in microseconds) until the tokens are available
+***********************************************************************************************************************************/
+static uint64_t
+ioRateTake(uint64_t *const bucketTime, const uint64_t timeNow, const uint64_t tokens, const uint64_t rate)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(UINT64, bucketTime);
+        FUNCTION_TEST_PARAM(UINT64, timeNow);
+        FUNCTION_TEST_PARAM(UINT64, tokens);
+        FUNCTION_TEST_PARAM(UINT64, rate);
+    FUNCTION_TEST_END();
+
+    ASSERT(bucketTime != NULL);
+    ASSERT(rate > 0);
+
+    const uint64_t timeFull = timeNow > USEC_PER_SEC ? timeNow - USEC_PER_SEC : 0;
+    const uint64_t timeTokens = tokens * USEC_PER_SEC / rate;
+    uint64_t timeOld = __atomic_load_n(bucketTime, __ATOMIC_SEQ_CST);
+    uint64_t timeNew;
+
+    // The bucket holds at most one second of tokens so the time is never earlier than one second ago. Tokens owed are not limited
+    // since they may have been taken by other processes that are waiting for them. Another process may have taken tokens since the
+    // time was loaded, in which case the compare and swap fails and loads the new time so the loop can try again.
+    do
+    {
+        timeNew = (timeOld > timeFull ? timeOld : timeFull) + timeTokens;
+    }
+    while (!__atomic_compare_exchange_n(bucketTime, &timeOld, timeNew, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST));
+
+    FUNCTION_TEST_RETURN(UINT64, timeNew > timeNow ? timeNew - timeNow : 0);
+}
+
+/***********************************************************************************************************************************
+Wait until the input is allowed by the limits
+***********************************************************************************************************************************/
+static void
+ioRateProcess(THIS_VOID, const Buffer *const input)
+{
+    THIS(IoRate);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(IO_RATE, this);
+        FUNCTION_LOG_PARAM(BUFFER, input);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(input != NULL);
+
+    struct timespec currentTime;
+    clock_gettime(CLOCK_MONOTONIC, &currentTime);
+
+    const uint64_t timeNow = (uint64_t)currentTime.tv_sec * USEC_PER_SEC + (uint64_t)currentTime.tv_nsec / 1000;
+    uint64_t timeWait = 0;
+
+    if (this->byteRate != 0)
+        timeWait = ioRateTake(&this->shared->byteTime[this->type], timeNow, bufUsed(input), this->byteRate);
+
+    if (this->opRate != 0)
+    {
+        const uint64_t timeWaitOp = ioRateTake(&this->shared->opTime, timeNow, 1, this->opRate);
+
+        if (timeWaitOp > timeWait)
+            timeWait = timeWaitOp;
+    }
+
+    // Waits shorter than the sleep resolution are skipped but the tokens are still taken so later waits will be longer
+    sleepMSec(timeWait / USEC_PER_MSEC);
+    this->waitTotal += timeWait / USEC_PER_MSEC;
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Return the total time waited
+***********************************************************************************************************************************/
+static Pack *
+ioRateResult(THIS_VOID)
+{
+    THIS(IoRate);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(IO_RATE, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    Pack *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        PackWrite *const packWrite = pckWriteNewP();
+
+        pckWriteU64P(packWrite, this->waitTotal);
+        pckWriteEndP(packWrite);
+
+        result = pckMove(pckWriteResult(packWrite), memContextPrior());
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(PACK, result);
+}
+
+/**********************************************************************************************************************************/
+IoFilter *
+ioRateNew(const String *const file, const IoRateType type, const uint64_t byteRate, const uint64_t opRate)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STRING, file);
+        FUNCTION_LOG_PARAM(ENUM, type);
+        FUNCTION_LOG_PARAM(UINT64, byteRate);
+        FUNCTION_LOG_PARAM(UINT64, opRate);
+    FUNCTION_LOG_END();
+
+    ASSERT(file != NULL);
+    ASSERT(type <= ioRateTypeWrite);
+
+    IoFilter *this = NULL;
+
+    OBJ_NEW_BEGIN(IoRate, .childQty = MEM_CONTEXT_QTY_MAX, .allocQty = MEM_CONTEXT_QTY_MAX)
+    {
+        IoRate *const driver = OBJ_NEW_ALLOC();
+
+        *driver = (IoRate)
+        {
+            .shared = ioRateShared(file),
+            .type = type,
+            .byteRate = byteRate,
+            .opRate = opRate,
+        };
+
+        // Create param list
+        Pack *paramList = NULL;
+
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            PackWrite *const packWrite = pckWriteNewP();
+
+            pckWriteStrP(packWrite, file);
+            pckWriteU32P(packWrite, type);
+            pckWriteU64P(packWrite, byteRate);
+            pckWriteU64P(packWrite, opRate);
+            pckWriteEndP(packWrite);
+
+            paramList = pckMove(pckWriteResult(packWrite), memContextPrior());
+        }
+        MEM_CONTEXT_TEMP_END();
+
+        this = ioFilterNewP(IO_RATE_FILTER_TYPE, driver, paramList, .in = ioRateProcess, .result = ioRateResult);
+    }
+    OBJ_NEW_END();
+
+    FUNCTION_LOG_RETURN(IO_FILTER, this);
+}
+
+IoFilter *
+ioRateNewPack(const Pack *const paramList)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(PACK, paramList);
+    FUNCTION_TEST_END();
+
+    IoFilter *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        PackRead *const paramListPack = pckReadNew(paramList);
+        const String *const file = pckReadStrP(paramListPack);
+        const IoRateType type = (IoRateType)pckReadU32P(paramListPack);
+        const uint64_t byteRate = pckReadU64P(paramListPack);
+        const uint64_t opRate = pckReadU64P(paramListPack);
+
+        result = ioFilterMove(ioRateNew(file, type, byteRate, opRate), memContextPrior());
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN(IO_FILTER, result);
+}
+
+/**********************************************************************************************************************************/
+void
+ioRateInit(const String *const file, const uint64_t readRate, const uint64_t writeRate, const uint64_t opRate)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STRING, file);
+        FUNCTION_LOG_PARAM(UINT64, readRate);
+        FUNCTION_LOG_PARAM(UINT64, writeRate);
+        FUNCTION_LOG_PARAM(UINT64, opRate);
+    FUNCTION_LOG_END();
+
+    ASSERT(file != NULL);
+
+    // Only set limits when at least one rate is limited so filters are not added otherwise
+    if (readRate != 0 || writeRate != 0 || opRate != 0)
+    {
+        // Map the file now so errors are reported before any files are copied
+        ioRateShared(file);
+
+        MEM_CONTEXT_BEGIN(ioRateLocal.memContext)
+        {
+            strFree(ioRateLocal.file);
+            ioRateLocal.file = strDup(file);
+            ioRateLocal.byteRate[ioRateTypeRead] = readRate;
+            ioRateLocal.byteRate[ioRateTypeWrite] = writeRate;
+            ioRateLocal.opRate = opRate;
+        }
+        MEM_CONTEXT_END();
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+void
+ioRateAdd(IoFilterGroup *const filterGroup, const IoRateType type)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(IO_FILTER_GROUP, filterGroup);
+        FUNCTION_LOG_PARAM(ENUM, type);
+    FUNCTION_LOG_END();
+
+    ASSERT(filterGroup != NULL);
+    ASSERT(type <= ioRateTypeWrite);
+
+    if (ioRateLocal.file != NULL && (ioRateLocal.byteRate[type] != 0 || ioRateLocal.opRate != 0))
+        ioFilterGroupAdd(filterGroup, ioRateNew(ioRateLocal.file, type, ioRateLocal.byteRate[type], ioRateLocal.opRate));
+
+    FUNCTION_LOG_RETURN_VOID();
+}
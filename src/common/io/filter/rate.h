@@ -0,0 +1,52 @@
+/***********************************************************************************************************************************
+IO Rate Filter
+
+Limit the rate of bytes and I/O operations (i.e. buffers) that pass through the filter using token buckets. The buckets are stored
+in a file that is mapped into memory so limits are shared by all processes on the same host that use the same file, e.g. all the
+local processes of a backup. Each bucket holds up to one second of tokens so short bursts are allowed after the bucket has been
+idle.
+
+The filter result is the total time, in milliseconds, spent waiting for the limits. When the filter is passed to a remote it will
+use the file at the same path on the remote host.
+***********************************************************************************************************************************/
+#ifndef COMMON_IO_FILTER_RATE_H
+#define COMMON_IO_FILTER_RATE_H
+
+#include "common/io/filter/group.h"
+
+/***********************************************************************************************************************************
+Filter type constant
+***********************************************************************************************************************************/
+#define IO_RATE_FILTER_TYPE                                         STRID5("rate", 0x2d0320)
+
+/***********************************************************************************************************************************
+Extension for the file where buckets are stored
+***********************************************************************************************************************************/
+#define IO_RATE_FILE_EXT                                            ".rate"
+
+/***********************************************************************************************************************************
+Rate types. Bytes read and written are limited separately but share the I/O operation limit.
+***********************************************************************************************************************************/
+typedef enum
+{
+    ioRateTypeRead,                                                 // Limit bytes read
+    ioRateTypeWrite,                                                // Limit bytes written
+} IoRateType;
+
+/***********************************************************************************************************************************
+Constructors
+***********************************************************************************************************************************/
+// A rate of zero means there is no limit
+IoFilter *ioRateNew(const String *file, IoRateType type, uint64_t byteRate, uint64_t opRate);
+IoFilter *ioRateNewPack(const Pack *paramList);
+
+/***********************************************************************************************************************************
+Helper functions
+***********************************************************************************************************************************/
+// Set limits for the filters added by ioRateAdd() in this process. Nothing is set when all rates are zero.
+void ioRateInit(const String *file, uint64_t readRate, uint64_t writeRate, uint64_t opRate);
+
+// Add a rate filter to the filter group when ioRateInit() has set limits for the type
+void ioRateAdd(IoFilterGroup *filterGroup, IoRateType type);
+
+#endif
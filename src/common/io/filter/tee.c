@@ -0,0 +1,147 @@
+/***********************************************************************************************************************************
+IO Tee Filter
+***********************************************************************************************************************************/
+#include "build.auto.h"
+
+#include "common/debug.h"
+#include "common/io/filter/filter.h"
+#include "common/io/filter/tee.h"
+#include "common/log.h"
+#include "common/type/convert.h"
+#include "common/type/object.h"
+#include "common/type/pack.h"
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct IoTee
+{
+    IoWrite *write;                                                 // Write to copy the input to
+    bool errorCatch;                                                // Store errors rather than throwing them?
+    uint64_t size;                                                  // Total size of all input written
+    String *error;                                                  // Error when writing, if any
+} IoTee;
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+static String *
+ioTeeToLog(const IoTee *const this)
+{
+    return strNewFmt("{errorCatch: %s, size: %" PRIu64 "}", cvtBoolToConstZ(this->errorCatch), this->size);
+}
+
+#define FUNCTION_LOG_IO_TEE_TYPE                                                                                                   \
+    IoTee *
+#define FUNCTION_LOG_IO_TEE_FORMAT(value, buffer, bufferSize)                                                                      \
+    FUNCTION_LOG_STRING_OBJECT_FORMAT(value, ioTeeToLog, buffer, bufferSize)
+
+/***********************************************************************************************************************************
+Write the input
+***********************************************************************************************************************************/
+static void
+ioTeeProcess(THIS_VOID, const Buffer *const input)
+{
+    THIS(IoTee);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(IO_TEE, this);
+        FUNCTION_LOG_PARAM(BUFFER, input);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(input != NULL);
+
+    // Stop writing after an error
+    if (this->error == NULL)
+    {
+        if (this->errorCatch)
+        {
+            TRY_BEGIN()
+            {
+                ioWrite(this->write, input);
+                this->size += bufUsed(input);
+            }
+            CATCH_ANY()
+            {
+                MEM_CONTEXT_OBJ_BEGIN(this)
+                {
+                    this->error = strNewFmt("[%s] %s", errorTypeName(errorType()), errorMessage());
+                }
+                MEM_CONTEXT_OBJ_END();
+            }
+            TRY_END();
+        }
+        else
+        {
+            ioWrite(this->write, input);
+            this->size += bufUsed(input);
+        }
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Return filter result
+***********************************************************************************************************************************/
+static Pack *
+ioTeeResult(THIS_VOID)
+{
+    THIS(IoTee);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(IO_TEE, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    Pack *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        PackWrite *const packWrite = pckWriteNewP();
+
+        pckWriteU64P(packWrite, this->size);
+
+        if (this->errorCatch)
+            pckWriteStrP(packWrite, this->error);
+
+        pckWriteEndP(packWrite);
+
+        result = pckMove(pckWriteResult(packWrite), memContextPrior());
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(PACK, result);
+}
+
+/**********************************************************************************************************************************/
+IoFilter *
+ioTeeNew(IoWrite *const write, const bool errorCatch)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(IO_WRITE, write);
+        FUNCTION_LOG_PARAM(BOOL, errorCatch);
+    FUNCTION_LOG_END();
+
+    ASSERT(write != NULL);
+
+    IoFilter *this = NULL;
+
+    OBJ_NEW_BEGIN(IoTee, .childQty = MEM_CONTEXT_QTY_MAX, .allocQty = MEM_CONTEXT_QTY_MAX)
+    {
+        IoTee *const driver = OBJ_NEW_ALLOC();
+
+        *driver = (IoTee)
+        {
+            .write = write,
+            .errorCatch = errorCatch,
+        };
+
+        this = ioFilterNewP(TEE_FILTER_TYPE, driver, NULL, .in = ioTeeProcess, .result = ioTeeResult);
+    }
+    OBJ_NEW_END();
+
+    FUNCTION_LOG_RETURN(IO_FILTER, this);
+}
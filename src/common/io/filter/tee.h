@@ -0,0 +1,28 @@
+/***********************************************************************************************************************************
+IO Tee Filter
+
+Write all bytes that pass through the filter to another IoWrite, e.g. to write the same data to several destinations while it is
+only read and processed once. The IoWrite must be opened before the first byte passes through the filter and closed by the caller
+after the filter is done. The filter result is the number of bytes written.
+
+When errorCatch is true an error writing to the IoWrite does not end the read/write that the filter belongs to. Instead the error is
+stored, nothing more is written, and the error is added to the filter result as a string after the size (NULL when there was no
+error). This allows a copy to continue when one of the destinations fails.
+***********************************************************************************************************************************/
+#ifndef COMMON_IO_FILTER_TEE_H
+#define COMMON_IO_FILTER_TEE_H
+
+#include "common/io/filter/filter.h"
+#include "common/io/write.h"
+
+/***********************************************************************************************************************************
+Filter type constant
+***********************************************************************************************************************************/
+#define TEE_FILTER_TYPE                                             STRID5("tee", 0x14b40)
+
+/***********************************************************************************************************************************
+Constructors
+***********************************************************************************************************************************/
+IoFilter *ioTeeNew(IoWrite *write, bool errorCatch);
+
+#endif
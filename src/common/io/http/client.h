@@ -32,6 +32,11 @@ Statistics constants
     STRING_DECLARE(HTTP_STAT_CLIENT_STR);
 #define HTTP_STAT_CLOSE                                             "http.close"        // Closes forced by server
     STRING_DECLARE(HTTP_STAT_CLOSE_STR);
+#define HTTP_STAT_CONTENT_READ                                      "http.content.read" // Content bytes read
+    STRING_DECLARE(HTTP_STAT_CONTENT_READ_STR);
+#define HTTP_STAT_CONTENT_WRITE                                     "http.content.write" // Content bytes written
+    STRING_DECLARE(HTTP_STAT_CONTENT_WRITE_STR);
+#define HTTP_STAT_LATENCY                                           "http.latency"      // Latency prefix (verb is appended)
 #define HTTP_STAT_REQUEST                                           "http.request"      // Requests (i.e. calls to httpRequestNew())
     STRING_DECLARE(HTTP_STAT_REQUEST_STR);
 #define HTTP_STAT_RETRY                                             "http.retry"        // Request retries
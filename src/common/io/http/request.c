@@ -49,6 +49,8 @@ struct HttpRequest
     HttpRequestPub pub;                                             // Publicly accessible variables
     HttpClient *client;                                             // HTTP client
     const Buffer *content;                                          // HTTP content
+    const String *statKey;                                          // Stat for request latency
+    uint64_t timeBegin;                                             // Time the request was started
 
     HttpSession *session;                                           // Session for async requests
 };
@@ -122,7 +124,10 @@ httpRequestProcess(HttpRequest *this, bool waitForResponse, bool contentCache)
 
                         // Write out content if any
                         if (this->content != NULL)
+                        {
                             ioWrite(httpSessionIoWrite(session), this->content);
+                            statAdd(HTTP_STAT_CONTENT_WRITE_STR, bufUsed(this->content));
+                        }
 
                         // Flush all writes
                         ioWriteFlush(httpSessionIoWrite(session));
@@ -207,6 +212,8 @@ httpRequestNew(HttpClient *client, const String *verb, const String *path, HttpR
             },
             .client = client,
             .content = param.content == NULL ? NULL : bufDup(param.content),
+            .statKey = strLower(strNewFmt(HTTP_STAT_LATENCY ".%s", strZ(verb))),
+            .timeBegin = statTimeBegin(),
         };
     }
     OBJ_NEW_END();
@@ -229,7 +236,13 @@ httpRequestResponse(HttpRequest *this, bool contentCache)
 
     ASSERT(this != NULL);
 
-    FUNCTION_LOG_RETURN(HTTP_RESPONSE, httpRequestProcess(this, true, contentCache));
+    HttpResponse *const result = httpRequestProcess(this, true, contentCache);
+
+    // Latency is measured from when the request was started until the response is received. Content (if any) has not been read
+    // unless it is cached.
+    statTimeEnd(this->statKey, this->timeBegin);
+
+    FUNCTION_LOG_RETURN(HTTP_RESPONSE, result);
 }
 
 /**********************************************************************************************************************************/
@@ -112,6 +112,8 @@ httpResponseRead(THIS_VOID, Buffer *buffer, bool block)
 
     if (!this->contentEof)
     {
+        const size_t bufferUsed = bufUsed(buffer);
+
         MEM_CONTEXT_TEMP_BEGIN()
         {
             // If close was requested and no content specified then the server may send content up until the eof
@@ -183,6 +185,8 @@ httpResponseRead(THIS_VOID, Buffer *buffer, bool block)
                 httpResponseDone(this);
         }
         MEM_CONTEXT_TEMP_END();
+
+        statAdd(HTTP_STAT_CONTENT_READ_STR, bufUsed(buffer) - bufferUsed);
     }
 
     FUNCTION_LOG_RETURN(SIZE, (size_t)actualBytes);
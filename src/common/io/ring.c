@@ -0,0 +1,508 @@
+/***********************************************************************************************************************************
+Shared Memory Ring
+***********************************************************************************************************************************/
+#include "build.auto.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "common/debug.h"
+#include "common/io/fd.h"
+#include "common/io/read.h"
+#include "common/io/ring.h"
+#include "common/io/write.h"
+#include "common/log.h"
+#include "common/type/object.h"
+
+/***********************************************************************************************************************************
+Shared ring header. The head is only written by the writer and the tail is only written by the reader. They are kept on separate
+cache lines so the reader and writer do not contend for the same line.
+***********************************************************************************************************************************/
+#define IO_RING_CACHE_LINE                                          64
+
+typedef struct IoRingShared
+{
+    uint64_t head;                                                  // Total bytes written to the ring
+    unsigned char headPad[IO_RING_CACHE_LINE - sizeof(uint64_t)];
+    uint64_t tail;                                                  // Total bytes read from the ring
+    unsigned char tailPad[IO_RING_CACHE_LINE - sizeof(uint64_t)];
+} IoRingShared;
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+struct IoRing
+{
+    IoRingShared *shared;                                           // Shared header followed by the ring data
+    unsigned char *data;                                            // Ring data
+    size_t size;                                                    // Size of the ring data
+    int fdData[2];                                                  // Pipe used to wake the reader when data is available
+    int fdSpace[2];                                                 // Pipe used to wake the writer when space is available
+};
+
+typedef struct IoRingRead
+{
+    const String *name;                                             // Ring name for error messages
+    IoRing *ring;                                                   // Ring to read from
+    TimeMSec timeout;                                               // Timeout for read operation
+    bool eof;                                                       // Has the end of the stream been reached?
+} IoRingRead;
+
+typedef struct IoRingWrite
+{
+    const String *name;                                             // Ring name for error messages
+    IoRing *ring;                                                   // Ring to write to
+    TimeMSec timeout;                                               // Timeout for write operation
+} IoRingWrite;
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+#define FUNCTION_LOG_IO_RING_READ_TYPE                                                                                             \
+    IoRingRead *
+#define FUNCTION_LOG_IO_RING_READ_FORMAT(value, buffer, bufferSize)                                                                \
+    objToLog(value, "IoRingRead", buffer, bufferSize)
+
+#define FUNCTION_LOG_IO_RING_WRITE_TYPE                                                                                            \
+    IoRingWrite *
+#define FUNCTION_LOG_IO_RING_WRITE_FORMAT(value, buffer, bufferSize)                                                               \
+    objToLog(value, "IoRingWrite", buffer, bufferSize)
+
+/***********************************************************************************************************************************
+Load/store ring positions. Sequentially consistent ordering is required since each side stores its own position and then loads the
+position of the other side to decide whether a wakeup is needed.
+***********************************************************************************************************************************/
+#define IO_RING_LOAD(position)                                                                                                     \
+    __atomic_load_n(&(position), __ATOMIC_SEQ_CST)
+
+#define IO_RING_STORE(position, value)                                                                                             \
+    __atomic_store_n(&(position), value, __ATOMIC_SEQ_CST)
+
+/***********************************************************************************************************************************
+Close a file descriptor if it is open
+***********************************************************************************************************************************/
+static void
+ioRingFdClose(int *const fd)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(INT, fd);
+    FUNCTION_TEST_END();
+
+    ASSERT(fd != NULL);
+
+    if (*fd != -1)
+    {
+        close(*fd);
+        *fd = -1;
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Unmap shared memory and close file descriptors
+***********************************************************************************************************************************/
+static void
+ioRingFreeResource(THIS_VOID)
+{
+    THIS(IoRing);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(IO_RING, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    munmap(this->shared, sizeof(IoRingShared) + this->size);
+
+    ioRingFdClose(&this->fdData[0]);
+    ioRingFdClose(&this->fdData[1]);
+    ioRingFdClose(&this->fdSpace[0]);
+    ioRingFdClose(&this->fdSpace[1]);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Create a non-blocking wakeup pipe
+***********************************************************************************************************************************/
+static void
+ioRingPipe(int *const fd)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(INT, fd);
+    FUNCTION_TEST_END();
+
+    ASSERT(fd != NULL);
+
+    THROW_ON_SYS_ERROR(pipe(fd) == -1, KernelError, "unable to create ring pipe");
+    THROW_ON_SYS_ERROR(fcntl(fd[0], F_SETFL, O_NONBLOCK) == -1, KernelError, "unable to set O_NONBLOCK");
+    THROW_ON_SYS_ERROR(fcntl(fd[1], F_SETFL, O_NONBLOCK) == -1, KernelError, "unable to set O_NONBLOCK");
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+IoRing *
+ioRingNew(const size_t size)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(SIZE, size);
+    FUNCTION_LOG_END();
+
+    ASSERT(size > 0);
+
+    IoRing *this = NULL;
+
+    OBJ_NEW_BEGIN(IoRing, .callbackQty = 1)
+    {
+        this = OBJ_NEW_ALLOC();
+
+        *this = (IoRing)
+        {
+            .size = size,
+            .fdData = {-1, -1},
+            .fdSpace = {-1, -1},
+        };
+
+        // Map memory that will be shared with child processes after fork. Anonymous mappings are not part of POSIX so map /dev/zero
+        // when they are not available, which is equivalent for shared mappings.
+#ifdef MAP_ANON
+        void *const shared = mmap(NULL, sizeof(IoRingShared) + size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANON, -1, 0);
+#else
+        const int fd = open("/dev/zero", O_RDWR);
+        THROW_ON_SYS_ERROR(fd == -1, KernelError, "unable to open '/dev/zero'");
+
+        void *const shared = mmap(NULL, sizeof(IoRingShared) + size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+#endif
+        THROW_ON_SYS_ERROR(shared == MAP_FAILED, KernelError, "unable to map ring memory");
+
+        this->shared = shared;
+        this->data = (unsigned char *)shared + sizeof(IoRingShared);
+
+        memContextCallbackSet(objMemContext(this), ioRingFreeResource, this);
+
+        // Create wakeup pipes
+        ioRingPipe(this->fdData);
+        ioRingPipe(this->fdSpace);
+    }
+    OBJ_NEW_END();
+
+    FUNCTION_LOG_RETURN(IO_RING, this);
+}
+
+/***********************************************************************************************************************************
+Drain wakeups from a pipe. Returns false if the other side has closed the pipe.
+***********************************************************************************************************************************/
+static bool
+ioRingDrain(const int fd, const String *const name)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INT, fd);
+        FUNCTION_TEST_PARAM(STRING, name);
+    FUNCTION_TEST_END();
+
+    unsigned char buffer[64];
+    ssize_t actualBytes;
+
+    while ((actualBytes = read(fd, buffer, sizeof(buffer))) > 0);
+
+    THROW_ON_SYS_ERROR_FMT(actualBytes == -1 && errno != EAGAIN, FileReadError, "unable to drain %s", strZ(name));
+
+    FUNCTION_TEST_RETURN(BOOL, actualBytes != 0);
+}
+
+/***********************************************************************************************************************************
+Wake the other side. A full pipe already has wakeups pending so it is not an error.
+***********************************************************************************************************************************/
+static void
+ioRingWake(const int fd, const String *const name)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INT, fd);
+        FUNCTION_TEST_PARAM(STRING, name);
+    FUNCTION_TEST_END();
+
+    THROW_ON_SYS_ERROR_FMT(write(fd, "", 1) == -1 && errno != EAGAIN, FileWriteError, "unable to wake %s", strZ(name));
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Read data from the ring
+***********************************************************************************************************************************/
+static size_t
+ioRingRead(THIS_VOID, Buffer *const buffer, const bool block)
+{
+    THIS(IoRingRead);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(IO_RING_READ, this);
+        FUNCTION_LOG_PARAM(BUFFER, buffer);
+        FUNCTION_LOG_PARAM(BOOL, block);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(buffer != NULL);
+    ASSERT(!bufFull(buffer));
+
+    IoRing *const ring = this->ring;
+    size_t result = 0;
+    bool drained = false;
+
+    // Read until the buffer is full or eof. When not blocking return once some data has been read and the ring is empty.
+    while (!this->eof && !bufFull(buffer))
+    {
+        const uint64_t tail = ring->shared->tail;
+        const uint64_t head = IO_RING_LOAD(ring->shared->head);
+
+        if (head != tail)
+        {
+            // Copy data from the ring, which may wrap around the end of the ring data
+            const size_t size = head - tail < bufRemains(buffer) ? (size_t)(head - tail) : bufRemains(buffer);
+            const size_t offset = (size_t)(tail % ring->size);
+            const size_t sizeFirst = size < ring->size - offset ? size : ring->size - offset;
+
+            memcpy(bufRemainsPtr(buffer), ring->data + offset, sizeFirst);
+            memcpy((unsigned char *)bufRemainsPtr(buffer) + sizeFirst, ring->data, size - sizeFirst);
+            bufUsedInc(buffer, size);
+            result += size;
+
+            // Release the space and wake the writer if the ring was full since it may be waiting
+            IO_RING_STORE(ring->shared->tail, tail + size);
+
+            if (IO_RING_LOAD(ring->shared->head) - tail >= ring->size)
+                ioRingWake(ring->fdSpace[1], this->name);
+
+            drained = false;
+        }
+        // Else drain wakeups and check the ring again. Draining before the check means a wakeup sent for data that arrives after
+        // the drain cannot be lost, and data that arrived before the drain is read by the next loop. This also ensures a stale
+        // wakeup does not make the fd appear ready to callers that wait on it, e.g. select(). If the buffer fills before the ring
+        // is empty then the caller must read again before waiting on the fd, the same as for data buffered by IoRead.
+        else if (!drained)
+        {
+            // If the writer has closed then eof once all data has been read
+            if (!ioRingDrain(ring->fdData[0], this->name))
+                this->eof = IO_RING_LOAD(ring->shared->head) == tail;
+
+            drained = true;
+        }
+        // Else the ring was empty after the drain so return the data read when not blocking
+        else if (!block && result > 0)
+            break;
+        // Else wait for the writer
+        else
+        {
+            if (!fdReadyRead(ring->fdData[0], this->timeout))
+            {
+                THROW_FMT(
+                    FileReadError, "timeout after %" PRIu64 "ms waiting for read from '%s'", this->timeout, strZ(this->name));
+            }
+
+            drained = false;
+        }
+    }
+
+    FUNCTION_LOG_RETURN(SIZE, result);
+}
+
+/***********************************************************************************************************************************
+Have all bytes been read from the ring?
+***********************************************************************************************************************************/
+static bool
+ioRingReadEof(THIS_VOID)
+{
+    THIS(IoRingRead);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(IO_RING_READ, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_LOG_RETURN(BOOL, this->eof);
+}
+
+/***********************************************************************************************************************************
+Get file descriptor that is readable when the writer sends a wakeup
+***********************************************************************************************************************************/
+static int
+ioRingReadFd(const THIS_VOID)
+{
+    THIS(const IoRingRead);
+
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(IO_RING_READ, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(INT, this->ring->fdData[0]);
+}
+
+/**********************************************************************************************************************************/
+IoRead *
+ioRingReadNew(const String *const name, IoRing *const ring, const TimeMSec timeout)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STRING, name);
+        FUNCTION_LOG_PARAM(IO_RING, ring);
+        FUNCTION_LOG_PARAM(TIME_MSEC, timeout);
+    FUNCTION_LOG_END();
+
+    ASSERT(name != NULL);
+    ASSERT(ring != NULL);
+    ASSERT(ring->fdData[0] != -1 && ring->fdSpace[1] != -1);
+
+    IoRead *this = NULL;
+
+    // Close the writer side so eof is detected when the writer closes or exits
+    ioRingFdClose(&ring->fdData[1]);
+    ioRingFdClose(&ring->fdSpace[0]);
+
+    OBJ_NEW_BEGIN(IoRingRead, .childQty = MEM_CONTEXT_QTY_MAX)
+    {
+        IoRingRead *const driver = OBJ_NEW_ALLOC();
+
+        *driver = (IoRingRead)
+        {
+            .name = strDup(name),
+            .ring = ring,
+            .timeout = timeout,
+        };
+
+        this = ioReadNewP(driver, .block = true, .eof = ioRingReadEof, .fd = ioRingReadFd, .read = ioRingRead);
+    }
+    OBJ_NEW_END();
+
+    FUNCTION_LOG_RETURN(IO_READ, this);
+}
+
+/***********************************************************************************************************************************
+Write data to the ring
+***********************************************************************************************************************************/
+static void
+ioRingWrite(THIS_VOID, const Buffer *const buffer)
+{
+    THIS(IoRingWrite);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(IO_RING_WRITE, this);
+        FUNCTION_LOG_PARAM(BUFFER, buffer);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(buffer != NULL);
+
+    IoRing *const ring = this->ring;
+    size_t written = 0;
+    bool drained = false;
+
+    while (written < bufUsed(buffer))
+    {
+        const uint64_t head = ring->shared->head;
+        const uint64_t tail = IO_RING_LOAD(ring->shared->tail);
+
+        if (head - tail < ring->size)
+        {
+            // Copy data to the ring, which may wrap around the end of the ring data
+            const size_t space = ring->size - (size_t)(head - tail);
+            const size_t size = space < bufUsed(buffer) - written ? space : bufUsed(buffer) - written;
+            const size_t offset = (size_t)(head % ring->size);
+            const size_t sizeFirst = size < ring->size - offset ? size : ring->size - offset;
+
+            memcpy(ring->data + offset, bufPtrConst(buffer) + written, sizeFirst);
+            memcpy(ring->data, bufPtrConst(buffer) + written + sizeFirst, size - sizeFirst);
+            written += size;
+
+            // Publish the data and wake the reader if the ring was empty since it may be waiting
+            IO_RING_STORE(ring->shared->head, head + size);
+
+            if (IO_RING_LOAD(ring->shared->tail) == head)
+                ioRingWake(ring->fdData[1], this->name);
+        }
+        // Else drain wakeups and check the ring again so a wakeup sent after the check above cannot be lost
+        else if (!drained)
+        {
+            if (!ioRingDrain(ring->fdSpace[0], this->name))
+                THROW_FMT(FileWriteError, "unable to write to %s: reader closed", strZ(this->name));
+
+            drained = true;
+        }
+        // Else wait for the reader
+        else
+        {
+            if (!fdReadyRead(ring->fdSpace[0], this->timeout))
+            {
+                THROW_FMT(
+                    FileWriteError, "timeout after %" PRIu64 "ms waiting for write to '%s'", this->timeout, strZ(this->name));
+            }
+
+            drained = false;
+        }
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Close the writer so the reader will see eof
+***********************************************************************************************************************************/
+static void
+ioRingWriteClose(THIS_VOID)
+{
+    THIS(IoRingWrite);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(IO_RING_WRITE, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    ioRingFdClose(&this->ring->fdData[1]);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+IoWrite *
+ioRingWriteNew(const String *const name, IoRing *const ring, const TimeMSec timeout)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STRING, name);
+        FUNCTION_LOG_PARAM(IO_RING, ring);
+        FUNCTION_LOG_PARAM(TIME_MSEC, timeout);
+    FUNCTION_LOG_END();
+
+    ASSERT(name != NULL);
+    ASSERT(ring != NULL);
+    ASSERT(ring->fdData[1] != -1 && ring->fdSpace[0] != -1);
+
+    IoWrite *this = NULL;
+
+    // Close the reader side so the writer is not woken by its own descriptors
+    ioRingFdClose(&ring->fdData[0]);
+    ioRingFdClose(&ring->fdSpace[1]);
+
+    OBJ_NEW_BEGIN(IoRingWrite, .childQty = MEM_CONTEXT_QTY_MAX)
+    {
+        IoRingWrite *const driver = OBJ_NEW_ALLOC();
+
+        *driver = (IoRingWrite)
+        {
+            .name = strDup(name),
+            .ring = ring,
+            .timeout = timeout,
+        };
+
+        this = ioWriteNewP(driver, .close = ioRingWriteClose, .write = ioRingWrite);
+    }
+    OBJ_NEW_END();
+
+    FUNCTION_LOG_RETURN(IO_WRITE, this);
+}
@@ -0,0 +1,52 @@
+/***********************************************************************************************************************************
+Shared Memory Ring
+
+Single producer/single consumer ring buffer in memory shared between a process and a child forked from it. Data is copied directly
+into and out of the shared memory so no system calls are required while there is data to read or space to write. Pipes are used only
+to wake a reader waiting for data or a writer waiting for space and to detect when the other side has closed or exited.
+
+The ring must be created before the fork. Afterward each process creates either the read or the write interface for the ring, which
+closes the descriptors that belong to the other side.
+***********************************************************************************************************************************/
+#ifndef COMMON_IO_RING_H
+#define COMMON_IO_RING_H
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct IoRing IoRing;
+
+#include "common/io/read.h"
+#include "common/io/write.h"
+#include "common/time.h"
+#include "common/type/object.h"
+
+/***********************************************************************************************************************************
+Constructors
+***********************************************************************************************************************************/
+IoRing *ioRingNew(size_t size);
+
+// Read from the ring using the IoRead interface
+IoRead *ioRingReadNew(const String *name, IoRing *ring, TimeMSec timeout);
+
+// Write to the ring using the IoWrite interface
+IoWrite *ioRingWriteNew(const String *name, IoRing *ring, TimeMSec timeout);
+
+/***********************************************************************************************************************************
+Destructor
+***********************************************************************************************************************************/
+FN_INLINE_ALWAYS void
+ioRingFree(IoRing *const this)
+{
+    objFree(this);
+}
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+#define FUNCTION_LOG_IO_RING_TYPE                                                                                                  \
+    IoRing *
+#define FUNCTION_LOG_IO_RING_FORMAT(value, buffer, bufferSize)                                                                     \
+    objToLog(value, "IoRing", buffer, bufferSize)
+
+#endif
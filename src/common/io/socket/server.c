@@ -208,3 +208,20 @@ sckServerNew(const String *const address, const unsigned int port, const TimeMSe
 
     FUNCTION_LOG_RETURN(IO_SERVER, this);
 }
+
+/**********************************************************************************************************************************/
+void
+sckServerTimeoutSet(IoServer *const server, const TimeMSec timeout)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(IO_SERVER, server);
+        FUNCTION_LOG_PARAM(TIME_MSEC, timeout);
+    FUNCTION_LOG_END();
+
+    ASSERT(server != NULL);
+    ASSERT(((const IoServerPub *)server)->interface == &sckServerInterface);
+
+    ((SocketServer *)((const IoServerPub *)server)->driver)->timeout = timeout;
+
+    FUNCTION_LOG_RETURN_VOID();
+}
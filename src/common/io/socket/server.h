@@ -26,4 +26,10 @@ Constructors
 ***********************************************************************************************************************************/
 IoServer *sckServerNew(const String *address, unsigned int port, TimeMSec timeout);
 
+/***********************************************************************************************************************************
+Getters/Setters
+***********************************************************************************************************************************/
+// Set timeout for sessions accepted after this call. This allows the timeout to be changed without closing the listening socket.
+void sckServerTimeoutSet(IoServer *server, TimeMSec timeout);
+
 #endif
@@ -21,6 +21,8 @@ TLS Client
 Statistics constants
 ***********************************************************************************************************************************/
 STRING_EXTERN(TLS_STAT_CLIENT_STR,                                  TLS_STAT_CLIENT);
+STRING_EXTERN(TLS_STAT_HANDSHAKE_STR,                               TLS_STAT_HANDSHAKE);
+STRING_EXTERN(TLS_STAT_RESUME_STR,                                  TLS_STAT_RESUME);
 STRING_EXTERN(TLS_STAT_RETRY_STR,                                   TLS_STAT_RETRY);
 STRING_EXTERN(TLS_STAT_SESSION_STR,                                 TLS_STAT_SESSION);
 
@@ -36,6 +38,7 @@ typedef struct TlsClient
     IoClient *ioClient;                                             // Underlying client (usually a SocketClient)
 
     SSL_CTX *context;                                               // TLS context
+    SSL_SESSION *session;                                           // Last session issued by the server (for resumption)
 } TlsClient;
 
 /***********************************************************************************************************************************
@@ -70,6 +73,7 @@ tlsClientFreeResource(THIS_VOID)
 
     ASSERT(this != NULL);
 
+    SSL_SESSION_free(this->session);
     SSL_CTX_free(this->context);
 
     FUNCTION_LOG_RETURN_VOID();
@@ -229,6 +233,30 @@ tlsClientAuth(const TlsClient *const this, SSL *const tlsSession)
     FUNCTION_LOG_RETURN(BOOL, result);
 }
 
+/***********************************************************************************************************************************
+Store the session issued by the server so the next connection can resume it and skip the full handshake
+***********************************************************************************************************************************/
+static int
+tlsClientSessionNew(SSL *const tlsSession, SSL_SESSION *const session)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM_P(VOID, tlsSession);
+        FUNCTION_LOG_PARAM_P(VOID, session);
+    FUNCTION_LOG_END();
+
+    ASSERT(tlsSession != NULL);
+    ASSERT(session != NULL);
+
+    TlsClient *const this = SSL_CTX_get_app_data(SSL_get_SSL_CTX(tlsSession));
+    ASSERT(this != NULL);
+
+    // Replace the prior session (if any). Returning 1 means the reference to the new session is retained.
+    SSL_SESSION_free(this->session);
+    this->session = session;
+
+    FUNCTION_LOG_RETURN(INT, 1);
+}
+
 /***********************************************************************************************************************************
 Open TLS session on a socket
 ***********************************************************************************************************************************/
@@ -260,6 +288,10 @@ tlsClientOpen(THIS_VOID)
             tlsSession = SSL_new(this->context);
             cryptoError(tlsSession == NULL, "unable to create TLS session");
 
+            // Attempt to resume the last session issued by the server
+            if (this->session != NULL)
+                cryptoError(SSL_set_session(tlsSession, this->session) != 1, "unable to set TLS session");
+
             // Set server host name used for validation
             cryptoError(SSL_set_tlsext_host_name(tlsSession, strZ(this->host)) != 1, "unable to set TLS host name");
 
@@ -280,8 +312,11 @@ tlsClientOpen(THIS_VOID)
                 }
                 TRY_END();
 
-                // Open session
+                // Open session and record the handshake latency
+                const uint64_t timeBegin = statTimeBegin();
+
                 result = tlsSessionNew(tlsSession, ioSession, this->timeoutSession);
+                statTimeEnd(TLS_STAT_HANDSHAKE_STR, timeBegin);
             }
             CATCH_ANY()
             {
@@ -306,6 +341,10 @@ tlsClientOpen(THIS_VOID)
         ASSERT(result != NULL);
         ioSessionAuthenticatedSet(result, tlsClientAuth(this, tlsSession));
 
+        // Was the session resumed?
+        if (SSL_session_reused(tlsSession))
+            statInc(TLS_STAT_RESUME_STR);
+
         // Move session
         ioSessionMove(result, memContextPrior());
     }
@@ -385,6 +424,12 @@ tlsClientNew(
         // Enable safe compatibility options
         SSL_CTX_set_options(driver->context, SSL_OP_ALL);
 
+        // Cache the last session issued by the server in the client so it can be resumed by the next connection. The internal
+        // store is not used since only one session per client is required.
+        SSL_CTX_set_app_data(driver->context, driver);
+        SSL_CTX_set_session_cache_mode(driver->context, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        SSL_CTX_sess_set_new_cb(driver->context, tlsClientSessionNew);
+
         // Set location of CA certificates if the server certificate will be verified
         if (driver->verifyPeer)
         {
@@ -22,6 +22,10 @@ Statistics constants
 ***********************************************************************************************************************************/
 #define TLS_STAT_CLIENT                                             "tls.client"        // Clients created
     STRING_DECLARE(TLS_STAT_CLIENT_STR);
+#define TLS_STAT_HANDSHAKE                                          "tls.handshake"     // Handshake latency
+    STRING_DECLARE(TLS_STAT_HANDSHAKE_STR);
+#define TLS_STAT_RESUME                                             "tls.resume"        // Sessions resumed
+    STRING_DECLARE(TLS_STAT_RESUME_STR);
 #define TLS_STAT_RETRY                                              "tls.retry"         // Connection retries
     STRING_DECLARE(TLS_STAT_RETRY_STR);
 #define TLS_STAT_SESSION                                            "tls.session"       // Sessions created
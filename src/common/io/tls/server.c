@@ -4,6 +4,7 @@ TLS Server
 #include "build.auto.h"
 
 #include <netinet/in.h>
+#include <string.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <unistd.h>
@@ -19,6 +20,7 @@ TLS Server
 #include "common/io/tls/session.h"
 #include "common/stat.h"
 #include "common/type/object.h"
+#include "version.h"
 
 /***********************************************************************************************************************************
 Statistics constants
@@ -310,21 +312,26 @@ tlsServerNew(
 
         // Set options
         SSL_CTX_set_options(driver->context,
-            // Disable SSL and TLS v1/v1.1
-            SSL_OP_NO_TLSv1 | SSL_OP_NO_TLSv1_1 |
-            // Let server set cipher order
-            SSL_OP_CIPHER_SERVER_PREFERENCE |
 #ifdef SSL_OP_NO_RENEGOTIATION
 	        // Disable renegotiation, available since 1.1.0h. This affects only TLSv1.2 and older protocol versions as TLSv1.3 has
             // no support for renegotiation.
 	        SSL_OP_NO_RENEGOTIATION |
 #endif
-        	// Disable session tickets
-	        SSL_OP_NO_TICKET);
+            // Disable SSL and TLS v1/v1.1
+            SSL_OP_NO_TLSv1 | SSL_OP_NO_TLSv1_1 |
+            // Let server set cipher order
+            SSL_OP_CIPHER_SERVER_PREFERENCE);
 
-        // Disable session caching
+        // Disable session caching. Sessions are resumed using session tickets instead, which do not require server state. The
+        // ticket keys are generated with the context so they are shared by all processes forked after the server is created.
         SSL_CTX_set_session_cache_mode(driver->context, SSL_SESS_CACHE_OFF);
 
+        // Set the session id context, which is required to resume sessions when client certificates are verified
+        cryptoError(
+            SSL_CTX_set_session_id_context(
+                driver->context, (const unsigned char *)PROJECT_NAME, (unsigned int)strlen(PROJECT_NAME)) != 1,
+            "unable to set session id context");
+
         // Setup ephemeral DH and ECDH keys
         tlsServerDh(driver->context);
         tlsServerEcdh(driver->context);
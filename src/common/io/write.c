@@ -21,7 +21,7 @@ struct IoWrite
     Buffer *output;                                                 // Output buffer
 
 #ifdef DEBUG
-    bool filterGroupSet;                                            // Were filters set?
+    bool filterOutput;                                              // Were filters that produce output set?
     bool opened;                                                    // Has the io been opened?
     bool closed;                                                    // Has the io been closed?
 #endif
@@ -76,9 +76,10 @@ ioWriteOpen(IoWrite *this)
     if (this->interface.open != NULL)
         this->interface.open(this->driver);
 
-    // Track whether filters were added to prevent flush() from being called later since flush() won't work with most filters
+    // Track whether filters that produce output were added to prevent flush() from being called later since flush() won't work
+    // with these filters. Filters that only inspect the data (e.g. hash or size) do not hold data so flush() works with them.
 #ifdef DEBUG
-    this->filterGroupSet = ioFilterGroupSize(this->pub.filterGroup) > 0;
+    this->filterOutput = ioFilterGroupOutput(this->pub.filterGroup);
 #endif
 
     // Open the filter group
@@ -205,7 +206,7 @@ ioWriteFlush(IoWrite *this)
 
     ASSERT(this != NULL);
     ASSERT(this->opened && !this->closed);
-    ASSERT(!this->filterGroupSet);
+    ASSERT(!this->filterOutput);
 
     if (!bufEmpty(this->output))
     {
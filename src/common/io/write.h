@@ -67,7 +67,7 @@ void ioWriteStr(IoWrite *this, const String *string);
 // Write linefeed-terminated string
 void ioWriteStrLine(IoWrite *this, const String *string);
 
-// Flush any data in the output buffer. This does not end writing and will not work if filters are present.
+// Flush any data in the output buffer. This does not end writing and will not work if filters that produce output are present.
 void ioWriteFlush(IoWrite *this);
 
 // Close the IO and write any additional data that has not been written yet
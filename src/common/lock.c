@@ -522,3 +522,29 @@ lockRelease(bool failOnNoLock)
 
     FUNCTION_LOG_RETURN(BOOL, result);
 }
+
+/**********************************************************************************************************************************/
+void
+lockForget(void)
+{
+    FUNCTION_LOG_VOID(logLevelDebug);
+
+    if (lockLocal.held != lockTypeNone)
+    {
+        // Close lock files
+        LockType lockMin = lockLocal.held == lockTypeAll ? lockTypeArchive : lockLocal.held;
+        LockType lockMax = lockLocal.held == lockTypeAll ? (lockTypeAll - 1) : lockLocal.held;
+
+        for (LockType lockIdx = lockMin; lockIdx <= lockMax; lockIdx++)
+        {
+            if (lockLocal.file[lockIdx].fd != LOCK_ON_EXEC_ID)
+                close(lockLocal.file[lockIdx].fd);
+        }
+
+        // Free the lock context and reset lock data
+        memContextFree(lockLocal.memContext);
+        lockLocal = (struct LockLocal){.held = lockTypeNone};
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
@@ -43,6 +43,10 @@ bool lockAcquire(
 // Release a lock
 bool lockRelease(bool failOnNoLock);
 
+// Forget locks inherited from the parent process after a fork. The lock files are closed in this process but not unlocked or
+// removed since the locks are still held by the parent process.
+void lockForget(void);
+
 // Build lock file name
 String *lockFileName(const String *stanza, LockType lockType);
 
@@ -3,12 +3,32 @@ Statistics Collector
 ***********************************************************************************************************************************/
 #include "build.auto.h"
 
+#include <string.h>
+#include <time.h>
+
 #include "common/debug.h"
 #include "common/memContext.h"
 #include "common/stat.h"
 #include "common/type/json.h"
 #include "common/type/list.h"
 
+/***********************************************************************************************************************************
+Histogram buckets. Values less than the sub-bucket total have their own bucket. Larger values are split into sub-buckets per power
+of two so the relative error of a bucket is at most 1 / STAT_BUCKET_SUB.
+***********************************************************************************************************************************/
+#define STAT_BUCKET_SUB_BITS                                        3
+#define STAT_BUCKET_SUB                                             (1 << STAT_BUCKET_SUB_BITS)
+#define STAT_BUCKET_TOTAL                                           ((64 - STAT_BUCKET_SUB_BITS + 1) * STAT_BUCKET_SUB)
+
+typedef struct StatHistogram
+{
+    uint64_t count;                                                 // Total samples
+    uint64_t sum;                                                   // Sum of samples
+    uint64_t min;                                                   // Smallest sample
+    uint64_t max;                                                   // Largest sample
+    uint64_t bucket[STAT_BUCKET_TOTAL];                             // Samples per bucket
+} StatHistogram;
+
 /***********************************************************************************************************************************
 Cumulative statistics
 ***********************************************************************************************************************************/
@@ -16,8 +36,19 @@ typedef struct Stat
 {
     const String *key;
     uint64_t total;
+    StatHistogram *histogram;                                       // Latency histogram (NULL if there are no samples)
 } Stat;
 
+/***********************************************************************************************************************************
+Key built from a prefix and a StringId
+***********************************************************************************************************************************/
+typedef struct StatKey
+{
+    const char *prefix;                                             // Key prefix
+    StringId id;                                                    // Id appended to the prefix
+    const String *key;                                              // Key
+} StatKey;
+
 /***********************************************************************************************************************************
 Local data
 ***********************************************************************************************************************************/
@@ -25,6 +56,7 @@ static struct
 {
     MemContext *memContext;                                         // Mem context to store data in this struct
     List *stat;                                                     // Cumulative stats
+    List *key;                                                      // Keys built from a prefix and a StringId
 } statLocalData;
 
 /**********************************************************************************************************************************/
@@ -41,6 +73,7 @@ statInit(void)
         {
             statLocalData.memContext = MEM_CONTEXT_NEW();
             statLocalData.stat = lstNewP(sizeof(Stat), .sortOrder = sortOrderAsc, .comparator = lstComparatorStr);
+            statLocalData.key = lstNewP(sizeof(StatKey));
         }
         MEM_CONTEXT_NEW_END();
     }
@@ -85,6 +118,51 @@ statGetOrCreate(const String *key)
     FUNCTION_TEST_RETURN_TYPE_P(Stat, stat);
 }
 
+/**********************************************************************************************************************************/
+const String *
+statKeyStrId(const char *const prefix, const StringId id)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRINGZ, prefix);
+        FUNCTION_TEST_PARAM(STRING_ID, id);
+    FUNCTION_TEST_END();
+
+    ASSERT(prefix != NULL);
+
+    const String *result = NULL;
+
+    // Build the key without caching when stats are not being collected
+    if (statLocalData.memContext == NULL)
+        result = strNewFmt("%s.%s", prefix, strZ(strIdToStr(id)));
+    else
+    {
+        // Search for the key. There are only a few keys so a linear search is faster than building the key.
+        for (unsigned int keyIdx = 0; keyIdx < lstSize(statLocalData.key); keyIdx++)
+        {
+            const StatKey *const statKey = lstGet(statLocalData.key, keyIdx);
+
+            if (statKey->id == id && strcmp(statKey->prefix, prefix) == 0)
+            {
+                result = statKey->key;
+                break;
+            }
+        }
+
+        // Add the key if it was not found
+        if (result == NULL)
+        {
+            MEM_CONTEXT_BEGIN(lstMemContext(statLocalData.key))
+            {
+                result = strNewFmt("%s.%s", prefix, strZ(strIdToStr(id)));
+                lstAdd(statLocalData.key, &(StatKey){.prefix = prefix, .id = id, .key = result});
+            }
+            MEM_CONTEXT_END();
+        }
+    }
+
+    FUNCTION_TEST_RETURN_CONST(STRING, result);
+}
+
 /**********************************************************************************************************************************/
 void
 statInc(const String *key)
@@ -102,13 +180,286 @@ statInc(const String *key)
 }
 
 /**********************************************************************************************************************************/
-String *
-statToJson(void)
+void
+statAdd(const String *const key, const uint64_t value)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, key);
+        FUNCTION_TEST_PARAM(UINT64, value);
+    FUNCTION_TEST_END();
+
+    ASSERT(key != NULL);
+
+    // Stats may be added by code shared with binaries that do not collect stats
+    if (statLocalData.memContext != NULL)
+        statGetOrCreate(key)->total += value;
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Get the histogram bucket for a value and the lowest value in a bucket
+***********************************************************************************************************************************/
+static unsigned int
+statBucketIdx(const uint64_t value)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(UINT64, value);
+    FUNCTION_TEST_END();
+
+    unsigned int result = (unsigned int)value;
+
+    if (value >= STAT_BUCKET_SUB)
+    {
+        // Find the most significant bit
+        unsigned int bit = STAT_BUCKET_SUB_BITS;
+
+        while (bit < 63 && value >> (bit + 1) != 0)
+            bit++;
+
+        // The bits following the most significant bit select the sub-bucket
+        result =
+            (bit - STAT_BUCKET_SUB_BITS + 1) * STAT_BUCKET_SUB +
+            (unsigned int)((value >> (bit - STAT_BUCKET_SUB_BITS)) & (STAT_BUCKET_SUB - 1));
+    }
+
+    FUNCTION_TEST_RETURN(UINT, result);
+}
+
+static uint64_t
+statBucketMin(const unsigned int bucketIdx)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(UINT, bucketIdx);
+    FUNCTION_TEST_END();
+
+    ASSERT(bucketIdx < STAT_BUCKET_TOTAL);
+
+    uint64_t result = bucketIdx;
+
+    if (bucketIdx >= STAT_BUCKET_SUB)
+    {
+        result =
+            (uint64_t)(STAT_BUCKET_SUB + bucketIdx % STAT_BUCKET_SUB) << (bucketIdx / STAT_BUCKET_SUB - 1);
+    }
+
+    FUNCTION_TEST_RETURN(UINT64, result);
+}
+
+/***********************************************************************************************************************************
+Get the histogram for a stat. If it doesn't already exist it will be created.
+***********************************************************************************************************************************/
+static StatHistogram *
+statHistogramGetOrCreate(const String *const key)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, key);
+    FUNCTION_TEST_END();
+
+    ASSERT(key != NULL);
+
+    Stat *const stat = statGetOrCreate(key);
+
+    if (stat->histogram == NULL)
+    {
+        MEM_CONTEXT_BEGIN(lstMemContext(statLocalData.stat))
+        {
+            stat->histogram = memNew(sizeof(StatHistogram));
+            *stat->histogram = (StatHistogram){.min = UINT64_MAX};
+        }
+        MEM_CONTEXT_END();
+    }
+
+    FUNCTION_TEST_RETURN_TYPE_P(StatHistogram, stat->histogram);
+}
+
+/**********************************************************************************************************************************/
+void
+statLatency(const String *const key, const uint64_t usec)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, key);
+        FUNCTION_TEST_PARAM(UINT64, usec);
+    FUNCTION_TEST_END();
+
+    ASSERT(key != NULL);
+
+    // Stats may be added by code shared with binaries that do not collect stats
+    if (statLocalData.memContext != NULL)
+    {
+        StatHistogram *const histogram = statHistogramGetOrCreate(key);
+
+        histogram->count++;
+        histogram->sum += usec;
+        histogram->bucket[statBucketIdx(usec)]++;
+
+        if (usec < histogram->min)
+            histogram->min = usec;
+
+        if (usec > histogram->max)
+            histogram->max = usec;
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+uint64_t
+statTimeBegin(void)
+{
+    FUNCTION_TEST_VOID();
+
+    struct timespec currentTime;
+    clock_gettime(CLOCK_MONOTONIC, &currentTime);
+
+    FUNCTION_TEST_RETURN(UINT64, (uint64_t)currentTime.tv_sec * 1000000 + (uint64_t)currentTime.tv_nsec / 1000);
+}
+
+/**********************************************************************************************************************************/
+void
+statTimeEnd(const String *const key, const uint64_t timeBegin)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, key);
+        FUNCTION_TEST_PARAM(UINT64, timeBegin);
+    FUNCTION_TEST_END();
+
+    statLatency(key, statTimeBegin() - timeBegin);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+void
+statMerge(const String *const json)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, json);
+    FUNCTION_TEST_END();
+
+    ASSERT(statLocalData.memContext != NULL);
+
+    if (json != NULL)
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            // Read stats into a KeyValue so the keys can be iterated since they are not known in advance
+            const KeyValue *const statKv = varKv(jsonToVar(json));
+            const VariantList *const keyList = kvKeyList(statKv);
+
+            for (unsigned int keyIdx = 0; keyIdx < varLstSize(keyList); keyIdx++)
+            {
+                const String *const key = varStr(varLstGet(keyList, keyIdx));
+                const KeyValue *const valueKv = varKv(kvGet(statKv, varLstGet(keyList, keyIdx)));
+
+                // Merge histogram
+                const Variant *const bucketList = kvGet(valueKv, VARSTRDEF("bucket"));
+
+                if (bucketList != NULL)
+                {
+                    StatHistogram *const histogram = statHistogramGetOrCreate(key);
+
+                    for (unsigned int bucketIdx = 0; bucketIdx < varLstSize(varVarLst(bucketList)); bucketIdx++)
+                    {
+                        const VariantList *const bucket = varVarLst(varLstGet(varVarLst(bucketList), bucketIdx));
+
+                        histogram->bucket[statBucketIdx(varUInt64Force(varLstGet(bucket, 0)))] +=
+                            varUInt64Force(varLstGet(bucket, 1));
+                    }
+
+                    histogram->count += varUInt64Force(kvGet(valueKv, VARSTRDEF("count")));
+
+                    const uint64_t max = varUInt64Force(kvGet(valueKv, VARSTRDEF("max")));
+                    const uint64_t min = varUInt64Force(kvGet(valueKv, VARSTRDEF("min")));
+
+                    if (max > histogram->max)
+                        histogram->max = max;
+
+                    if (min < histogram->min)
+                        histogram->min = min;
+
+                    histogram->sum += varUInt64Force(kvGet(valueKv, VARSTRDEF("sum")));
+                }
+
+                // Merge total
+                const Variant *const total = kvGet(valueKv, VARSTRDEF("total"));
+
+                if (total != NULL)
+                    statAdd(key, varUInt64Force(total));
+            }
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+void
+statReset(void)
 {
     FUNCTION_TEST_VOID();
 
     ASSERT(statLocalData.memContext != NULL);
 
+    MEM_CONTEXT_BEGIN(statLocalData.memContext)
+    {
+        lstFree(statLocalData.stat);
+        statLocalData.stat = lstNewP(sizeof(Stat), .sortOrder = sortOrderAsc, .comparator = lstComparatorStr);
+    }
+    MEM_CONTEXT_END();
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Estimate a percentile from the histogram. The highest value in the bucket containing the percentile is returned, limited by the
+actual min and max.
+***********************************************************************************************************************************/
+static uint64_t
+statHistogramPercentile(const StatHistogram *const histogram, const unsigned int percentile)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, histogram);
+        FUNCTION_TEST_PARAM(UINT, percentile);
+    FUNCTION_TEST_END();
+
+    ASSERT(histogram != NULL);
+    ASSERT(histogram->count > 0);
+    ASSERT(percentile > 0 && percentile <= 100);
+
+    // Number of samples at or below the percentile, rounded up
+    const uint64_t rank = (histogram->count * percentile + 99) / 100;
+    uint64_t total = 0;
+    unsigned int bucketIdx = 0;
+
+    for (; bucketIdx < STAT_BUCKET_TOTAL - 1; bucketIdx++)
+    {
+        total += histogram->bucket[bucketIdx];
+
+        if (total >= rank)
+            break;
+    }
+
+    // The upper bound of the bucket is never less than the min since the min is in the same or an earlier bucket
+    uint64_t result = bucketIdx < STAT_BUCKET_TOTAL - 1 ? statBucketMin(bucketIdx + 1) - 1 : UINT64_MAX;
+
+    if (result > histogram->max)
+        result = histogram->max;
+
+    FUNCTION_TEST_RETURN(UINT64, result);
+}
+
+/**********************************************************************************************************************************/
+String *
+statToJson(const StatToJsonParam param)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BOOL, param.histogram);
+    FUNCTION_TEST_END();
+
+    ASSERT(statLocalData.memContext != NULL);
+
     String *result = NULL;
 
     if (!lstEmpty(statLocalData.stat))
@@ -122,9 +473,43 @@ statToJson(void)
             for (unsigned int statIdx = 0; statIdx < lstSize(statLocalData.stat); statIdx++)
             {
                 const Stat *const stat = lstGet(statLocalData.stat, statIdx);
+                const StatHistogram *const histogram = stat->histogram;
 
                 jsonWriteObjectBegin(jsonWriteKey(json, stat->key));
-                jsonWriteUInt64(jsonWriteKeyZ(json, "total"), stat->total);
+
+                if (histogram != NULL)
+                {
+                    // Output non-empty buckets as [min value, count] pairs
+                    if (param.histogram)
+                    {
+                        jsonWriteArrayBegin(jsonWriteKeyZ(json, "bucket"));
+
+                        for (unsigned int bucketIdx = 0; bucketIdx < STAT_BUCKET_TOTAL; bucketIdx++)
+                        {
+                            if (histogram->bucket[bucketIdx] != 0)
+                            {
+                                jsonWriteArrayBegin(json);
+                                jsonWriteUInt64(json, statBucketMin(bucketIdx));
+                                jsonWriteUInt64(json, histogram->bucket[bucketIdx]);
+                                jsonWriteArrayEnd(json);
+                            }
+                        }
+
+                        jsonWriteArrayEnd(json);
+                    }
+
+                    jsonWriteUInt64(jsonWriteKeyZ(json, "count"), histogram->count);
+                    jsonWriteUInt64(jsonWriteKeyZ(json, "max"), histogram->max);
+                    jsonWriteUInt64(jsonWriteKeyZ(json, "min"), histogram->min);
+                    jsonWriteUInt64(jsonWriteKeyZ(json, "p50"), statHistogramPercentile(histogram, 50));
+                    jsonWriteUInt64(jsonWriteKeyZ(json, "p90"), statHistogramPercentile(histogram, 90));
+                    jsonWriteUInt64(jsonWriteKeyZ(json, "p99"), statHistogramPercentile(histogram, 99));
+                    jsonWriteUInt64(jsonWriteKeyZ(json, "sum"), histogram->sum);
+                }
+
+                if (histogram == NULL || stat->total != 0)
+                    jsonWriteUInt64(jsonWriteKeyZ(json, "total"), stat->total);
+
                 jsonWriteObjectEnd(json);
             }
 
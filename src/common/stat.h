@@ -3,7 +3,12 @@ Statistics Collector
 
 Collect simple statistics that can be output to a KeyValue for processing and logging. Each stat has a String that identifies it
 uniquely and will also be used in the output. Individual stats do not need to be created in advance since they will be created as
-needed at runtime. However, statInit() must be called before any other stat*() functions.
+needed at runtime. However, statInit() must be called before any other stat*() functions, except that statAdd(), statTimeEnd(), and
+statLatency() do nothing before statInit() so they can be used in code shared with binaries that do not collect stats.
+
+A stat may be a counter (statInc() and statAdd()), a latency histogram (statTimeEnd() and statLatency()), or both. Latency samples
+are recorded in microseconds into log-linear buckets, i.e. each power of two is split into eight sub-buckets, so percentiles can be
+estimated with a relative error of at most 12.5% at a fixed cost per sample.
 
 NOTE: Statistics are held in a sorted list so there is some cost involved in each lookup. In general, statistics should be used for
 relatively important or high-latency operations where measurements are critical. For instance, using statistics to count the
@@ -12,7 +17,11 @@ iterations of a loop would likely be a bad idea.
 #ifndef COMMON_STAT_H
 #define COMMON_STAT_H
 
+#include <stdint.h>
+
+#include "common/type/param.h"
 #include "common/type/string.h"
+#include "common/type/stringId.h"
 
 /***********************************************************************************************************************************
 Functions
@@ -20,10 +29,41 @@ Functions
 // Initialize the stats collector
 void statInit(void);
 
+// Get a key composed of a prefix and a StringId, e.g. protocol.latency.backupFile. Keys are cached so they are built only once per
+// process, which is useful for stats recorded once per command or file. The prefix must be a constant.
+const String *statKeyStrId(const char *prefix, StringId id);
+
 // Increment stat by one
 void statInc(const String *key);
 
+// Add to stat, e.g. bytes transferred
+void statAdd(const String *key, uint64_t value);
+
+// Get the current time in microseconds to pass to statTimeEnd(). This time is only useful for measuring intervals.
+uint64_t statTimeBegin(void);
+
+// Add the time elapsed since statTimeBegin() to the stat latency histogram
+void statTimeEnd(const String *key, uint64_t timeBegin);
+
+// Add a sample in microseconds to the stat latency histogram
+void statLatency(const String *key, uint64_t usec);
+
+// Merge stats output by statToJsonP(.histogram = true) in another process
+void statMerge(const String *json);
+
+// Reset all stats, e.g. after they have been sent to another process for merging
+void statReset(void);
+
 // Output stats to JSON
-String *statToJson(void);
+typedef struct StatToJsonParam
+{
+    VAR_PARAM_HEADER;
+    bool histogram;                                                 // Output histogram buckets?
+} StatToJsonParam;
+
+#define statToJsonP(...)                                                                                                           \
+    statToJson((StatToJsonParam){VAR_PARAM_INIT, __VA_ARGS__})
+
+String *statToJson(StatToJsonParam param);
 
 #endif
@@ -0,0 +1,169 @@
+/***********************************************************************************************************************************
+Trace Collector
+***********************************************************************************************************************************/
+#include "build.auto.h"
+
+#include "common/debug.h"
+#include "common/memContext.h"
+#include "common/stat.h"
+#include "common/trace.h"
+#include "common/type/json.h"
+
+/***********************************************************************************************************************************
+Local data
+***********************************************************************************************************************************/
+static struct
+{
+    MemContext *memContext;                                         // Mem context to store data in this struct
+    unsigned int processId;                                         // Process id to output with events
+    String *event;                                                  // Events separated by commas and linefeeds
+} traceLocalData;
+
+/**********************************************************************************************************************************/
+void
+traceInit(const unsigned int processId)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(UINT, processId);
+    FUNCTION_TEST_END();
+
+    // Discard events that were recorded before the process was forked
+    if (traceLocalData.memContext != NULL)
+        memContextFree(traceLocalData.memContext);
+
+    MEM_CONTEXT_BEGIN(memContextTop())
+    {
+        MEM_CONTEXT_NEW_BEGIN(TraceLocalData, .childQty = MEM_CONTEXT_QTY_MAX)
+        {
+            traceLocalData.memContext = MEM_CONTEXT_NEW();
+            traceLocalData.processId = processId;
+            traceLocalData.event = strNew();
+        }
+        MEM_CONTEXT_NEW_END();
+    }
+    MEM_CONTEXT_END();
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+bool
+traceEnabled(void)
+{
+    FUNCTION_TEST_VOID();
+    FUNCTION_TEST_RETURN(BOOL, traceLocalData.memContext != NULL);
+}
+
+/**********************************************************************************************************************************/
+uint64_t
+traceBegin(void)
+{
+    FUNCTION_TEST_VOID();
+    FUNCTION_TEST_RETURN(UINT64, traceEnabled() ? statTimeBegin() : 0);
+}
+
+/***********************************************************************************************************************************
+Add a separator when there are already events
+***********************************************************************************************************************************/
+static void
+traceEventSeparator(void)
+{
+    FUNCTION_TEST_VOID();
+
+    if (!strEmpty(traceLocalData.event))
+        strCatZ(traceLocalData.event, ",\n");
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+void
+traceEnd(const char *const name, const uint64_t timeBegin, const TraceEndParam param)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRINGZ, name);
+        FUNCTION_TEST_PARAM(UINT64, timeBegin);
+        FUNCTION_TEST_PARAM(KEY_VALUE, param.arg);
+    FUNCTION_TEST_END();
+
+    ASSERT(name != NULL);
+
+    if (traceEnabled())
+    {
+        const uint64_t timeEnd = statTimeBegin();
+
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            // Output a complete event, i.e. an event that includes the duration. Keys must be output in sorted order.
+            JsonWrite *const json = jsonWriteObjectBegin(jsonWriteNewP());
+
+            if (param.arg != NULL)
+                jsonWriteVar(jsonWriteKeyZ(json, "args"), varNewKv(kvDup(param.arg)));
+
+            jsonWriteUInt64(jsonWriteKeyZ(json, "dur"), timeEnd - timeBegin);
+            jsonWriteZ(jsonWriteKeyZ(json, "name"), name);
+            jsonWriteZ(jsonWriteKeyZ(json, "ph"), "X");
+            jsonWriteUInt(jsonWriteKeyZ(json, "pid"), traceLocalData.processId);
+            jsonWriteUInt(jsonWriteKeyZ(json, "tid"), 0);
+            jsonWriteUInt64(jsonWriteKeyZ(json, "ts"), timeBegin);
+            jsonWriteObjectEnd(json);
+
+            traceEventSeparator();
+            strCat(traceLocalData.event, jsonWriteResult(json));
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+const String *
+traceEvent(void)
+{
+    FUNCTION_TEST_VOID();
+    FUNCTION_TEST_RETURN_CONST(STRING, traceEnabled() && !strEmpty(traceLocalData.event) ? traceLocalData.event : NULL);
+}
+
+/**********************************************************************************************************************************/
+void
+traceMerge(const String *const event)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, event);
+    FUNCTION_TEST_END();
+
+    if (event != NULL)
+    {
+        ASSERT(traceEnabled());
+
+        traceEventSeparator();
+        strCat(traceLocalData.event, event);
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+void
+traceReset(void)
+{
+    FUNCTION_TEST_VOID();
+
+    if (traceEnabled())
+        strTrunc(traceLocalData.event);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+String *
+traceToJson(void)
+{
+    FUNCTION_TEST_VOID();
+
+    ASSERT(traceEnabled());
+
+    FUNCTION_TEST_RETURN(
+        STRING, strEmpty(traceLocalData.event) ? strNewZ("[]\n") : strNewFmt("[\n%s\n]\n", strZ(traceLocalData.event)));
+}
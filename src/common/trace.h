@@ -0,0 +1,57 @@
+/***********************************************************************************************************************************
+Trace Collector
+
+Record spans of work, e.g. the phases of a backup and the files processed by each job, so they can be viewed on a timeline to find
+stragglers and stalls. Spans are output as Chrome trace events, which can be loaded by chrome://tracing or Perfetto, with one event
+per line so the output can also be processed line by line.
+
+Spans are only recorded after traceInit() so the only cost when tracing is disabled is checking traceEnabled(). Times are taken from
+the monotonic clock (see statTimeBegin()) so spans recorded in different processes on the same host line up on the timeline.
+***********************************************************************************************************************************/
+#ifndef COMMON_TRACE_H
+#define COMMON_TRACE_H
+
+#include <stdint.h>
+
+#include "common/type/keyValue.h"
+#include "common/type/param.h"
+#include "common/type/string.h"
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+// Initialize the trace collector. The process id identifies the process that recorded the spans in the output. Any spans already
+// recorded, e.g. by the parent of a forked process, are discarded.
+void traceInit(unsigned int processId);
+
+// Is tracing enabled? This can be used to skip building span arguments when tracing is disabled.
+bool traceEnabled(void);
+
+// Get the current time to pass to traceEnd()
+uint64_t traceBegin(void);
+
+// Record a span that started at timeBegin and ends now. Does nothing when tracing is disabled.
+typedef struct TraceEndParam
+{
+    VAR_PARAM_HEADER;
+    const KeyValue *arg;                                            // Arguments to display with the span
+} TraceEndParam;
+
+#define traceEndP(name, timeBegin, ...)                                                                                            \
+    traceEnd(name, timeBegin, (TraceEndParam){VAR_PARAM_INIT, __VA_ARGS__})
+
+void traceEnd(const char *name, uint64_t timeBegin, TraceEndParam param);
+
+// Get events recorded (or merged) since the last reset. Returns NULL when there are no events.
+const String *traceEvent(void);
+
+// Merge events returned by traceEvent() in another process
+void traceMerge(const String *event);
+
+// Discard all events, e.g. after they have been sent to another process for merging
+void traceReset(void);
+
+// Output all events as a Chrome trace
+String *traceToJson(void);
+
+#endif
@@ -107,6 +107,24 @@ lstComparatorZ(const void *item1, const void *item2)
     FUNCTION_TEST_RETURN(INT, strcmp(*(char **)item1, *(char **)item2));
 }
 
+/**********************************************************************************************************************************/
+int
+lstComparatorUInt(const void *item1, const void *item2)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, item1);
+        FUNCTION_TEST_PARAM_P(VOID, item2);
+    FUNCTION_TEST_END();
+
+    ASSERT(item1 != NULL);
+    ASSERT(item2 != NULL);
+
+    const unsigned int value1 = *(const unsigned int *)item1;
+    const unsigned int value2 = *(const unsigned int *)item2;
+
+    FUNCTION_TEST_RETURN(INT, value1 < value2 ? -1 : value1 > value2);
+}
+
 /***********************************************************************************************************************************
 General function for a descending comparator that simply switches the parameters on the main comparator (which should be asc)
 ***********************************************************************************************************************************/
@@ -49,6 +49,9 @@ int lstComparatorStr(const void *item1, const void *item2);
 // General purpose list comparator for zero-terminated strings or structs with a zero-terminated string as the first member
 int lstComparatorZ(const void *item1, const void *item2);
 
+// General purpose list comparator for unsigned ints or structs with an unsigned int as the first member
+int lstComparatorUInt(const void *item1, const void *item2);
+
 /***********************************************************************************************************************************
 Constructors
 ***********************************************************************************************************************************/
@@ -17,6 +17,7 @@ Command constants
 #define CFGCMD_EXPIRE                                               "expire"
 #define CFGCMD_HELP                                                 "help"
 #define CFGCMD_INFO                                                 "info"
+#define CFGCMD_REPO_COPY                                            "repo-copy"
 #define CFGCMD_REPO_CREATE                                          "repo-create"
 #define CFGCMD_REPO_GET                                             "repo-get"
 #define CFGCMD_REPO_LS                                              "repo-ls"
@@ -33,7 +34,7 @@ Command constants
 #define CFGCMD_VERIFY                                               "verify"
 #define CFGCMD_VERSION                                              "version"
 
-#define CFG_COMMAND_TOTAL                                           23
+#define CFG_COMMAND_TOTAL                                           24
 
 /***********************************************************************************************************************************
 Option group constants
@@ -62,6 +63,8 @@ Option constants
 #define CFGOPT_CMD_SSH                                              "cmd-ssh"
 #define CFGOPT_COMPRESS                                             "compress"
 #define CFGOPT_COMPRESS_LEVEL                                       "compress-level"
+#define CFGOPT_COMPRESS_LEVEL_MAX                                   "compress-level-max"
+#define CFGOPT_COMPRESS_LEVEL_MIN                                   "compress-level-min"
 #define CFGOPT_COMPRESS_LEVEL_NETWORK                               "compress-level-network"
 #define CFGOPT_COMPRESS_TYPE                                        "compress-type"
 #define CFGOPT_CONFIG                                               "config"
@@ -75,9 +78,14 @@ Option constants
 #define CFGOPT_EXCLUDE                                              "exclude"
 #define CFGOPT_EXEC_ID                                              "exec-id"
 #define CFGOPT_EXPIRE_AUTO                                          "expire-auto"
+#define CFGOPT_FANOUT_PATH                                          "fanout-path"
 #define CFGOPT_FILTER                                               "filter"
 #define CFGOPT_FORCE                                                "force"
 #define CFGOPT_IGNORE_MISSING                                       "ignore-missing"
+#define CFGOPT_INCREMENTAL                                          "incremental"
+#define CFGOPT_IO_RATE_IOPS                                         "io-rate-iops"
+#define CFGOPT_IO_RATE_READ                                         "io-rate-read"
+#define CFGOPT_IO_RATE_WRITE                                        "io-rate-write"
 #define CFGOPT_IO_TIMEOUT                                           "io-timeout"
 #define CFGOPT_JOB_RETRY                                            "job-retry"
 #define CFGOPT_JOB_RETRY_INTERVAL                                   "job-retry-interval"
@@ -96,21 +104,33 @@ Option constants
 #define CFGOPT_OUTPUT                                               "output"
 #define CFGOPT_PG                                                   "pg"
 #define CFGOPT_PROCESS                                              "process"
+#define CFGOPT_PROCESS_FORK                                         "process-fork"
+#define CFGOPT_PROCESS_LATENCY_TARGET                               "process-latency-target"
 #define CFGOPT_PROCESS_MAX                                          "process-max"
+#define CFGOPT_PROCESS_MIN                                          "process-min"
 #define CFGOPT_PROTOCOL_TIMEOUT                                     "protocol-timeout"
 #define CFGOPT_RAW                                                  "raw"
 #define CFGOPT_RECOVERY_OPTION                                      "recovery-option"
 #define CFGOPT_RECURSE                                              "recurse"
 #define CFGOPT_REMOTE_TYPE                                          "remote-type"
 #define CFGOPT_REPO                                                 "repo"
+#define CFGOPT_REPO_SHARE                                           "repo-share"
+#define CFGOPT_REPO_TARGET                                          "repo-target"
+#define CFGOPT_RESTORE_PRIORITY                                     "restore-priority"
+#define CFGOPT_RESTORE_PROGRESS                                     "restore-progress"
+#define CFGOPT_RESTORE_SPARSE                                       "restore-sparse"
 #define CFGOPT_RESUME                                               "resume"
+#define CFGOPT_RESUME_CHECKPOINT                                    "resume-checkpoint"
+#define CFGOPT_SAMPLE                                               "sample"
 #define CFGOPT_SCK_BLOCK                                            "sck-block"
 #define CFGOPT_SCK_KEEP_ALIVE                                       "sck-keep-alive"
 #define CFGOPT_SET                                                  "set"
 #define CFGOPT_SORT                                                 "sort"
+#define CFGOPT_SPLIT_SIZE                                           "split-size"
 #define CFGOPT_SPOOL_PATH                                           "spool-path"
 #define CFGOPT_STANZA                                               "stanza"
 #define CFGOPT_START_FAST                                           "start-fast"
+#define CFGOPT_STAT_FILE                                            "stat-file"
 #define CFGOPT_STOP_AUTO                                            "stop-auto"
 #define CFGOPT_TABLESPACE_MAP                                       "tablespace-map"
 #define CFGOPT_TABLESPACE_MAP_ALL                                   "tablespace-map-all"
@@ -121,16 +141,20 @@ Option constants
 #define CFGOPT_TCP_KEEP_ALIVE_COUNT                                 "tcp-keep-alive-count"
 #define CFGOPT_TCP_KEEP_ALIVE_IDLE                                  "tcp-keep-alive-idle"
 #define CFGOPT_TCP_KEEP_ALIVE_INTERVAL                              "tcp-keep-alive-interval"
+#define CFGOPT_TEE_REPO                                             "tee-repo"
 #define CFGOPT_TLS_SERVER_ADDRESS                                   "tls-server-address"
 #define CFGOPT_TLS_SERVER_AUTH                                      "tls-server-auth"
 #define CFGOPT_TLS_SERVER_CA_FILE                                   "tls-server-ca-file"
 #define CFGOPT_TLS_SERVER_CERT_FILE                                 "tls-server-cert-file"
 #define CFGOPT_TLS_SERVER_KEY_FILE                                  "tls-server-key-file"
 #define CFGOPT_TLS_SERVER_PORT                                      "tls-server-port"
+#define CFGOPT_TLS_SERVER_WORKER                                    "tls-server-worker"
+#define CFGOPT_TLS_SERVER_WORKER_REUSE                              "tls-server-worker-reuse"
+#define CFGOPT_TRACE_FILE                                           "trace-file"
 #define CFGOPT_TYPE                                                 "type"
 #define CFGOPT_VERBOSE                                              "verbose"
 
-#define CFG_OPTION_TOTAL                                            157
+#define CFG_OPTION_TOTAL                                            182
 
 /***********************************************************************************************************************************
 Option value constants
@@ -293,6 +317,8 @@ Option value constants
 #define CFGOPTVAL_TYPE_DEFAULT_Z                                    "default"
 #define CFGOPTVAL_TYPE_DIFF                                         STRID5("diff", 0x319240)
 #define CFGOPTVAL_TYPE_DIFF_Z                                       "diff"
+#define CFGOPTVAL_TYPE_FAST                                         STRID5("fast", 0xa4c260)
+#define CFGOPTVAL_TYPE_FAST_Z                                       "fast"
 #define CFGOPTVAL_TYPE_FULL                                         STRID5("full", 0x632a60)
 #define CFGOPTVAL_TYPE_FULL_Z                                       "full"
 #define CFGOPTVAL_TYPE_IMMEDIATE                                    STRID5("immediate", 0x5a05242b5a90)
@@ -327,6 +353,7 @@ typedef enum
     cfgCmdExpire,
     cfgCmdHelp,
     cfgCmdInfo,
+    cfgCmdRepoCopy,
     cfgCmdRepoCreate,
     cfgCmdRepoGet,
     cfgCmdRepoLs,
@@ -378,6 +405,8 @@ typedef enum
     cfgOptCmdSsh,
     cfgOptCompress,
     cfgOptCompressLevel,
+    cfgOptCompressLevelMax,
+    cfgOptCompressLevelMin,
     cfgOptCompressLevelNetwork,
     cfgOptCompressType,
     cfgOptConfig,
@@ -391,9 +420,14 @@ typedef enum
     cfgOptExclude,
     cfgOptExecId,
     cfgOptExpireAuto,
+    cfgOptFanoutPath,
     cfgOptFilter,
     cfgOptForce,
     cfgOptIgnoreMissing,
+    cfgOptIncremental,
+    cfgOptIoRateIops,
+    cfgOptIoRateRead,
+    cfgOptIoRateWrite,
     cfgOptIoTimeout,
     cfgOptJobRetry,
     cfgOptJobRetryInterval,
@@ -430,7 +464,10 @@ typedef enum
     cfgOptPgSocketPath,
     cfgOptPgUser,
     cfgOptProcess,
+    cfgOptProcessFork,
+    cfgOptProcessLatencyTarget,
     cfgOptProcessMax,
+    cfgOptProcessMin,
     cfgOptProtocolTimeout,
     cfgOptRaw,
     cfgOptRecoveryOption,
@@ -444,10 +481,12 @@ typedef enum
     cfgOptRepoAzureKeyType,
     cfgOptRepoAzureUriStyle,
     cfgOptRepoBundle,
+    cfgOptRepoBundleDict,
     cfgOptRepoBundleLimit,
     cfgOptRepoBundleSize,
     cfgOptRepoCipherPass,
     cfgOptRepoCipherType,
+    cfgOptRepoDedup,
     cfgOptRepoGcsBucket,
     cfgOptRepoGcsEndpoint,
     cfgOptRepoGcsKey,
@@ -483,21 +522,30 @@ typedef enum
     cfgOptRepoS3Role,
     cfgOptRepoS3Token,
     cfgOptRepoS3UriStyle,
+    cfgOptRepoShare,
     cfgOptRepoStorageCaFile,
     cfgOptRepoStorageCaPath,
     cfgOptRepoStorageHost,
     cfgOptRepoStoragePort,
     cfgOptRepoStorageUploadChunkSize,
     cfgOptRepoStorageVerifyTls,
+    cfgOptRepoTarget,
     cfgOptRepoType,
+    cfgOptRestorePriority,
+    cfgOptRestoreProgress,
+    cfgOptRestoreSparse,
     cfgOptResume,
+    cfgOptResumeCheckpoint,
+    cfgOptSample,
     cfgOptSckBlock,
     cfgOptSckKeepAlive,
     cfgOptSet,
     cfgOptSort,
+    cfgOptSplitSize,
     cfgOptSpoolPath,
     cfgOptStanza,
     cfgOptStartFast,
+    cfgOptStatFile,
     cfgOptStopAuto,
     cfgOptTablespaceMap,
     cfgOptTablespaceMapAll,
@@ -508,12 +556,16 @@ typedef enum
     cfgOptTcpKeepAliveCount,
     cfgOptTcpKeepAliveIdle,
     cfgOptTcpKeepAliveInterval,
+    cfgOptTeeRepo,
     cfgOptTlsServerAddress,
     cfgOptTlsServerAuth,
     cfgOptTlsServerCaFile,
     cfgOptTlsServerCertFile,
     cfgOptTlsServerKeyFile,
     cfgOptTlsServerPort,
+    cfgOptTlsServerWorker,
+    cfgOptTlsServerWorkerReuse,
+    cfgOptTraceFile,
     cfgOptType,
     cfgOptVerbose,
 } ConfigOption;
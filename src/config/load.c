@@ -20,6 +20,7 @@ Configuration Load
 #include "config/load.h"
 #include "config/parse.h"
 #include "info/infoBackup.h"
+#include "postgres/interface.h"
 #include "storage/cifs/storage.h"
 #include "storage/posix/storage.h"
 #include "storage/helper.h"
@@ -153,6 +154,16 @@ cfgLoadUpdateOption(void)
         }
     }
 
+    // Process min must not be greater than process max
+    if (cfgOptionTest(cfgOptProcessMin) && cfgOptionUInt(cfgOptProcessMin) > cfgOptionUInt(cfgOptProcessMax))
+    {
+        THROW_FMT(
+            OptionInvalidValueError,
+            "'%s' is not valid for '" CFGOPT_PROCESS_MIN "' option\nHINT '" CFGOPT_PROCESS_MIN "' option must not be greater than"
+                " '" CFGOPT_PROCESS_MAX "' option (%s).",
+            strZ(cfgOptionDisplay(cfgOptProcessMin)), strZ(cfgOptionDisplay(cfgOptProcessMax)));
+    }
+
     // Make sure that repo and pg host settings are not both set - cannot both be remote
     if (cfgOptionValid(cfgOptPgHost) && cfgOptionValid(cfgOptRepoHost))
     {
@@ -365,6 +376,32 @@ cfgLoadUpdateOption(void)
             VARINT64(compressLevelDefault(compressTypeEnum(cfgOptionStrId(cfgOptCompressType)))));
     }
 
+    // Compress level min must not be greater than compress level max, or compress level when max is not set
+    if (cfgOptionValid(cfgOptCompressLevelMin) && cfgOptionTest(cfgOptCompressLevelMin))
+    {
+        const ConfigOption optionMax = cfgOptionTest(cfgOptCompressLevelMax) ? cfgOptCompressLevelMax : cfgOptCompressLevel;
+
+        if (cfgOptionInt(cfgOptCompressLevelMin) > cfgOptionInt(optionMax))
+        {
+            THROW_FMT(
+                OptionInvalidValueError,
+                "'%s' is not valid for '" CFGOPT_COMPRESS_LEVEL_MIN "' option\nHINT '" CFGOPT_COMPRESS_LEVEL_MIN "' option must not"
+                    " be greater than '%s' option (%s).",
+                strZ(cfgOptionDisplay(cfgOptCompressLevelMin)), cfgOptionName(optionMax), strZ(cfgOptionDisplay(optionMax)));
+        }
+    }
+
+    // Split size must be zero (disabled) or at least one page since parts are a multiple of the page size
+    if (cfgOptionValid(cfgOptSplitSize) && cfgOptionUInt64(cfgOptSplitSize) != 0 &&
+        cfgOptionUInt64(cfgOptSplitSize) < PG_PAGE_SIZE_DEFAULT)
+    {
+        THROW_FMT(
+            OptionInvalidValueError,
+            "'%s' is not valid for '" CFGOPT_SPLIT_SIZE "' option\nHINT '" CFGOPT_SPLIT_SIZE "' option must be 0 or at least the"
+                " page size (%u).",
+            strZ(cfgOptionDisplay(cfgOptSplitSize)), PG_PAGE_SIZE_DEFAULT);
+    }
+
     FUNCTION_LOG_RETURN_VOID();
 }
 
@@ -105,6 +105,11 @@ typedef enum
     manifestFilePackFlagUserNull,
     manifestFilePackFlagGroup,
     manifestFilePackFlagGroupNull,
+    manifestFilePackFlagDedup,
+    manifestFilePackFlagBundleDict,
+    manifestFilePackFlagCompressFast,
+    manifestFilePackFlagChecksumRepo,
+    manifestFilePackFlagSplit,
 } ManifestFilePackFlag;
 
 // Pack file into a compact format to save memory
@@ -140,6 +145,21 @@ manifestFilePack(const Manifest *const manifest, const ManifestFile *const file)
     if (file->bundleId != 0)
         flag |= 1 << manifestFilePackFlagBundle;
 
+    if (file->dedup)
+        flag |= 1 << manifestFilePackFlagDedup;
+
+    if (file->bundleDict)
+        flag |= 1 << manifestFilePackFlagBundleDict;
+
+    if (file->compressFast)
+        flag |= 1 << manifestFilePackFlagCompressFast;
+
+    if (file->checksumRepo[0] != 0)
+        flag |= 1 << manifestFilePackFlagChecksumRepo;
+
+    if (file->splitSize != 0)
+        flag |= 1 << manifestFilePackFlagSplit;
+
     if (file->mode != manifest->fileModeDefault)
         flag |= 1 << manifestFilePackFlagMode;
 
@@ -170,6 +190,13 @@ manifestFilePack(const Manifest *const manifest, const ManifestFile *const file)
     strcpy((char *)buffer + bufferPos, file->checksumSha1);
     bufferPos += HASH_TYPE_SHA1_SIZE_HEX + 1;
 
+    // Repo checksum
+    if (flag & (1 << manifestFilePackFlagChecksumRepo))
+    {
+        strcpy((char *)buffer + bufferPos, file->checksumRepo);
+        bufferPos += HASH_TYPE_MD5_SIZE_HEX + 1;
+    }
+
     // Reference
     if (file->reference != NULL)
         cvtUInt64ToVarInt128((uintptr_t)file->reference, buffer, &bufferPos, sizeof(buffer));
@@ -195,12 +222,24 @@ manifestFilePack(const Manifest *const manifest, const ManifestFile *const file)
         cvtUInt64ToVarInt128(file->bundleOffset, buffer, &bufferPos, sizeof(buffer));
     }
 
+    // Split size
+    if (flag & (1 << manifestFilePackFlagSplit))
+    {
+        ASSERT(file->splitChecksum != NULL);
+        cvtUInt64ToVarInt128(file->splitSize, buffer, &bufferPos, sizeof(buffer));
+    }
+
     // Allocate memory for the file pack
     const size_t nameSize = strSize(file->name) + 1;
+    size_t resultSize = sizeof(StringPub) + nameSize + bufferPos;
 
-    uint8_t *const result = memNew(
-        sizeof(StringPub) + nameSize + bufferPos + (file->checksumPageErrorList != NULL ?
-            ALIGN_OFFSET(StringPub, nameSize + bufferPos) + sizeof(StringPub) + strSize(file->checksumPageErrorList) + 1 : 0));
+    if (file->checksumPageErrorList != NULL)
+        resultSize += ALIGN_OFFSET(StringPub, resultSize) + sizeof(StringPub) + strSize(file->checksumPageErrorList) + 1;
+
+    if (file->splitSize != 0)
+        resultSize += ALIGN_OFFSET(StringPub, resultSize) + sizeof(StringPub) + strSize(file->splitChecksum) + 1;
+
+    uint8_t *const result = memNew(resultSize);
 
     // Create string object for the file name
     *(StringPub *)result = (StringPub){.size = (unsigned int)strSize(file->name), .buffer = (char *)result + sizeof(StringPub)};
@@ -211,17 +250,31 @@ manifestFilePack(const Manifest *const manifest, const ManifestFile *const file)
 
     // Copy pack data
     memcpy(result + resultPos, buffer, bufferPos);
+    resultPos += bufferPos;
 
     // Create string object for the checksum error list
     if (file->checksumPageErrorList != NULL)
     {
-        resultPos += bufferPos + ALIGN_OFFSET(StringPub, nameSize + bufferPos);
+        resultPos += ALIGN_OFFSET(StringPub, resultPos);
 
         *(StringPub *)(result + resultPos) = (StringPub)
             {.size = (unsigned int)strSize(file->checksumPageErrorList), .buffer = (char *)result + resultPos + sizeof(StringPub)};
         resultPos += sizeof(StringPub);
 
         memcpy(result + resultPos, (uint8_t *)strZ(file->checksumPageErrorList), strSize(file->checksumPageErrorList) + 1);
+        resultPos += strSize(file->checksumPageErrorList) + 1;
+    }
+
+    // Create string object for the split checksums
+    if (file->splitSize != 0)
+    {
+        resultPos += ALIGN_OFFSET(StringPub, resultPos);
+
+        *(StringPub *)(result + resultPos) = (StringPub)
+            {.size = (unsigned int)strSize(file->splitChecksum), .buffer = (char *)result + resultPos + sizeof(StringPub)};
+        resultPos += sizeof(StringPub);
+
+        memcpy(result + resultPos, (uint8_t *)strZ(file->splitChecksum), strSize(file->splitChecksum) + 1);
     }
 
     FUNCTION_TEST_RETURN_TYPE_P(ManifestFilePack, (ManifestFilePack *)result);
@@ -262,6 +315,13 @@ manifestFileUnpack(const Manifest *const manifest, const ManifestFilePack *const
     memcpy(result.checksumSha1, (const uint8_t *)filePack + bufferPos, HASH_TYPE_SHA1_SIZE_HEX + 1);
     bufferPos += HASH_TYPE_SHA1_SIZE_HEX + 1;
 
+    // Repo checksum
+    if (flag & (1 << manifestFilePackFlagChecksumRepo))
+    {
+        memcpy(result.checksumRepo, (const uint8_t *)filePack + bufferPos, HASH_TYPE_MD5_SIZE_HEX + 1);
+        bufferPos += HASH_TYPE_MD5_SIZE_HEX + 1;
+    }
+
     // Reference
     if (flag & (1 << manifestFilePackFlagReference))
         result.reference = (const String *)(uintptr_t)cvtUInt64FromVarInt128((const uint8_t *)filePack, &bufferPos);
@@ -293,11 +353,32 @@ manifestFileUnpack(const Manifest *const manifest, const ManifestFilePack *const
         result.bundleOffset = cvtUInt64FromVarInt128((const uint8_t *)filePack, &bufferPos);
     }
 
+    // Split size
+    if (flag & (1 << manifestFilePackFlagSplit))
+        result.splitSize = cvtUInt64FromVarInt128((const uint8_t *)filePack, &bufferPos);
+
+    // Bundle dictionary
+    result.bundleDict = flag & (1 << manifestFilePackFlagBundleDict) ? true : false;
+
+    // Dedup
+    result.dedup = flag & (1 << manifestFilePackFlagDedup) ? true : false;
+
+    // Compressed at the fastest level
+    result.compressFast = flag & (1 << manifestFilePackFlagCompressFast) ? true : false;
+
     // Checksum page error
     result.checksumPageError = flag & (1 << manifestFilePackFlagChecksumPageError) ? true : false;
 
     if (flag & (1 << manifestFilePackFlagChecksumPageErrorList))
-        result.checksumPageErrorList = (const String *)((const uint8_t *)filePack + bufferPos + ALIGN_OFFSET(StringPub, bufferPos));
+    {
+        bufferPos += ALIGN_OFFSET(StringPub, bufferPos);
+        result.checksumPageErrorList = (const String *)((const uint8_t *)filePack + bufferPos);
+        bufferPos += sizeof(StringPub) + strSize(result.checksumPageErrorList) + 1;
+    }
+
+    // Split checksums
+    if (flag & (1 << manifestFilePackFlagSplit))
+        result.splitChecksum = (const String *)((const uint8_t *)filePack + bufferPos + ALIGN_OFFSET(StringPub, bufferPos));
 
     FUNCTION_TEST_RETURN_TYPE(ManifestFile, result);
 }
@@ -1490,7 +1571,8 @@ manifestBuildIncr(Manifest *this, const Manifest *manifestPrior, BackupType type
                         this, file.name, file.size, filePrior.sizeRepo, filePrior.checksumSha1,
                         VARSTR(filePrior.reference != NULL ? filePrior.reference : manifestPrior->pub.data.backupLabel),
                         filePrior.checksumPage, filePrior.checksumPageError, filePrior.checksumPageErrorList,
-                        filePrior.bundleId, filePrior.bundleOffset);
+                        filePrior.bundleId, filePrior.bundleOffset, filePrior.bundleDict, filePrior.dedup,
+                        filePrior.compressFast, filePrior.checksumRepo, filePrior.splitSize, filePrior.splitChecksum);
                 }
             }
         }
@@ -1626,6 +1708,7 @@ manifestBuildComplete(
 #define MANIFEST_KEY_BACKUP_ARCHIVE_START                           "backup-archive-start"
 #define MANIFEST_KEY_BACKUP_ARCHIVE_STOP                            "backup-archive-stop"
 #define MANIFEST_KEY_BACKUP_BUNDLE                                  "backup-bundle"
+#define MANIFEST_KEY_BACKUP_BUNDLE_DICT                             "backup-bundle-dict"
 #define MANIFEST_KEY_BACKUP_LABEL                                   "backup-label"
 #define MANIFEST_KEY_BACKUP_LSN_START                               "backup-lsn-start"
 #define MANIFEST_KEY_BACKUP_LSN_STOP                                "backup-lsn-stop"
@@ -1639,11 +1722,15 @@ manifestBuildComplete(
 #define MANIFEST_KEY_CHECKSUM                                       STRID5("checksum", 0x6d66b195030)
 #define MANIFEST_KEY_CHECKSUM_PAGE                                  "checksum-page"
 #define MANIFEST_KEY_CHECKSUM_PAGE_ERROR                            "checksum-page-error"
+#define MANIFEST_KEY_CHECKSUM_REPO                                  "checksum-repo"
 #define MANIFEST_KEY_DB_CATALOG_VERSION                             "db-catalog-version"
 #define MANIFEST_KEY_DB_ID                                          "db-id"
 #define MANIFEST_KEY_DB_LAST_SYSTEM_ID                              "db-last-system-id"
 #define MANIFEST_KEY_DB_SYSTEM_ID                                   "db-system-id"
 #define MANIFEST_KEY_DB_VERSION                                     "db-version"
+#define MANIFEST_KEY_COMPRESS_FAST                                  "compress-fast"
+#define MANIFEST_KEY_DEDUP                                          "dedup"
+#define MANIFEST_KEY_DICT                                           "dict"
 #define MANIFEST_KEY_DESTINATION                                    STRID5("destination", 0x39e9a05c9a4ca40)
 #define MANIFEST_KEY_FILE                                           STRID5("file", 0x2b1260)
 #define MANIFEST_KEY_GROUP                                          "group"
@@ -1652,6 +1739,8 @@ manifestBuildComplete(
 #define MANIFEST_KEY_REFERENCE                                      STRID5("reference", 0x51b8b2298b20)
 #define MANIFEST_KEY_SIZE                                           STRID5("size", 0x2e9330)
 #define MANIFEST_KEY_SIZE_REPO                                      STRID5("repo-size", 0x5d267b7c0b20)
+#define MANIFEST_KEY_SPLIT_CHECKSUM                                 "split-checksum"
+#define MANIFEST_KEY_SPLIT_SIZE                                     "split-size"
 #define MANIFEST_KEY_TABLESPACE_ID                                  "tablespace-id"
 #define MANIFEST_KEY_TABLESPACE_NAME                                "tablespace-name"
 #define MANIFEST_KEY_TIMESTAMP                                      STRID5("timestamp", 0x10686932b5340)
@@ -1788,6 +1877,22 @@ manifestLoadCallback(void *callbackData, const String *const section, const Stri
                 file.checksumPageErrorList = jsonFromVar(jsonReadVar(json));
         }
 
+        // Repo checksum
+        if (jsonReadKeyExpectZ(json, MANIFEST_KEY_CHECKSUM_REPO))
+            memcpy(file.checksumRepo, strZ(jsonReadStr(json)), HASH_TYPE_MD5_SIZE_HEX + 1);
+
+        // Compressed at the fastest level
+        if (jsonReadKeyExpectZ(json, MANIFEST_KEY_COMPRESS_FAST))
+            file.compressFast = jsonReadBool(json);
+
+        // Dedup
+        if (jsonReadKeyExpectZ(json, MANIFEST_KEY_DEDUP))
+            file.dedup = jsonReadBool(json);
+
+        // Bundle dictionary
+        if (jsonReadKeyExpectZ(json, MANIFEST_KEY_DICT))
+            file.bundleDict = jsonReadBool(json);
+
         // Group
         if (jsonReadKeyExpectZ(json, MANIFEST_KEY_GROUP))
             file.group = manifestOwnerGet(jsonReadVar(json));
@@ -1827,6 +1932,17 @@ manifestLoadCallback(void *callbackData, const String *const section, const Stri
         if (file.size == 0)
             memcpy(file.checksumSha1, HASH_TYPE_SHA1_ZERO, HASH_TYPE_SHA1_SIZE_HEX + 1);
 
+        // Split info
+        if (jsonReadKeyExpectZ(json, MANIFEST_KEY_SPLIT_CHECKSUM))
+        {
+            file.splitChecksum = jsonReadStr(json);
+
+            if (!jsonReadKeyExpectZ(json, MANIFEST_KEY_SPLIT_SIZE))
+                THROW_FMT(FormatError, "missing split size for file '%s'", strZ(key));
+
+            file.splitSize = jsonReadUInt64(json);
+        }
+
         // Timestamp is required so error if it is not present
         if (jsonReadKeyExpectStrId(json, MANIFEST_KEY_TIMESTAMP))
             file.timestamp = (time_t)jsonReadInt64(json);
@@ -2016,6 +2132,8 @@ manifestLoadCallback(void *callbackData, const String *const section, const Stri
                 manifest->pub.data.archiveStop = varStr(jsonToVar(value));
             else if (strEqZ(key, MANIFEST_KEY_BACKUP_BUNDLE))
                 manifest->pub.data.bundle = varBool(jsonToVar(value));
+            else if (strEqZ(key, MANIFEST_KEY_BACKUP_BUNDLE_DICT))
+                manifest->pub.data.bundleDict = varBool(jsonToVar(value));
             else if (strEqZ(key, MANIFEST_KEY_BACKUP_LABEL))
                 manifest->pub.data.backupLabel = varStr(jsonToVar(value));
             else if (strEqZ(key, MANIFEST_KEY_BACKUP_LSN_START))
@@ -2247,6 +2365,13 @@ manifestSaveCallback(void *const callbackData, const String *const sectionNext,
                 infoSaveData, MANIFEST_SECTION_BACKUP, MANIFEST_KEY_BACKUP_BUNDLE, jsonFromVar(VARBOOL(manifest->pub.data.bundle)));
         }
 
+        if (manifest->pub.data.bundleDict)
+        {
+            infoSaveValue(
+                infoSaveData, MANIFEST_SECTION_BACKUP, MANIFEST_KEY_BACKUP_BUNDLE_DICT,
+                jsonFromVar(VARBOOL(manifest->pub.data.bundleDict)));
+        }
+
         infoSaveValue(
             infoSaveData, MANIFEST_SECTION_BACKUP, MANIFEST_KEY_BACKUP_LABEL, jsonFromVar(VARSTR(manifest->pub.data.backupLabel)));
 
@@ -2478,6 +2603,18 @@ manifestSaveCallback(void *const callbackData, const String *const sectionNext,
                         jsonWriteJson(jsonWriteKeyZ(json, MANIFEST_KEY_CHECKSUM_PAGE_ERROR), file.checksumPageErrorList);
                 }
 
+                if (file.checksumRepo[0] != 0)
+                    jsonWriteZ(jsonWriteKeyZ(json, MANIFEST_KEY_CHECKSUM_REPO), file.checksumRepo);
+
+                if (file.compressFast)
+                    jsonWriteBool(jsonWriteKeyZ(json, MANIFEST_KEY_COMPRESS_FAST), true);
+
+                if (file.dedup)
+                    jsonWriteBool(jsonWriteKeyZ(json, MANIFEST_KEY_DEDUP), true);
+
+                if (file.bundleDict)
+                    jsonWriteBool(jsonWriteKeyZ(json, MANIFEST_KEY_DICT), true);
+
                 if (!varEq(manifestOwnerVar(file.group), saveData->groupDefault))
                     jsonWriteVar(jsonWriteKeyZ(json, MANIFEST_KEY_GROUP), manifestOwnerVar(file.group));
 
@@ -2491,6 +2628,13 @@ manifestSaveCallback(void *const callbackData, const String *const sectionNext,
                     jsonWriteUInt64(jsonWriteKeyStrId(json, MANIFEST_KEY_SIZE_REPO), file.sizeRepo);
 
                 jsonWriteUInt64(jsonWriteKeyStrId(json, MANIFEST_KEY_SIZE), file.size);
+
+                if (file.splitSize != 0)
+                {
+                    jsonWriteStr(jsonWriteKeyZ(json, MANIFEST_KEY_SPLIT_CHECKSUM), file.splitChecksum);
+                    jsonWriteUInt64(jsonWriteKeyZ(json, MANIFEST_KEY_SPLIT_SIZE), file.splitSize);
+                }
+
                 jsonWriteUInt64(jsonWriteKeyStrId(json, MANIFEST_KEY_TIMESTAMP), (uint64_t)file.timestamp);
 
                 if (!varEq(manifestOwnerVar(file.user), saveData->userDefault))
@@ -2654,6 +2798,21 @@ manifestValidate(Manifest *this, bool strict)
             // All files must have a checksum
             if (file.checksumSha1[0] == '\0')
                 strCatFmt(error, "\nmissing checksum for file '%s'", strZ(file.name));
+            // The checksum of a split file is calculated from the checksums of the parts, which are what restore, verify, and delta
+            // backup check the parts against, so there must be a checksum for each part and they must produce the checksum
+            else if (file.splitSize != 0)
+            {
+                if (strSize(file.splitChecksum) != manifestSplitTotal(&file) * HASH_TYPE_SHA1_SIZE_HEX)
+                {
+                    strCatFmt(
+                        error, "\ninvalid split checksum for file '%s' with %u part(s)", strZ(file.name), manifestSplitTotal(&file));
+                }
+                else if (!strEqZ(cryptoHashSplitCombine(hashTypeSha1, file.splitChecksum), file.checksumSha1))
+                {
+                    strCatFmt(
+                        error, "\nsplit checksum does not match checksum '%s' for file '%s'", file.checksumSha1, strZ(file.name));
+                }
+            }
 
             // These are strict checks to be performed only after a backup and before the final manifest save
             if (strict)
@@ -2756,7 +2915,9 @@ void
 manifestFileUpdate(
     Manifest *const this, const String *const name, const uint64_t size, const uint64_t sizeRepo, const char *const checksumSha1,
     const Variant *const reference, const bool checksumPage, const bool checksumPageError,
-    const String *const checksumPageErrorList, const uint64_t bundleId, const uint64_t bundleOffset)
+    const String *const checksumPageErrorList, const uint64_t bundleId, const uint64_t bundleOffset, const bool bundleDict,
+    const bool dedup, const bool compressFast, const char *const checksumRepo, const uint64_t splitSize,
+    const String *const splitChecksum)
 {
     FUNCTION_TEST_BEGIN();
         FUNCTION_TEST_PARAM(MANIFEST, this);
@@ -2770,10 +2931,20 @@ manifestFileUpdate(
         FUNCTION_TEST_PARAM(STRING, checksumPageErrorList);
         FUNCTION_TEST_PARAM(UINT64, bundleId);
         FUNCTION_TEST_PARAM(UINT64, bundleOffset);
+        FUNCTION_TEST_PARAM(BOOL, bundleDict);
+        FUNCTION_TEST_PARAM(BOOL, dedup);
+        FUNCTION_TEST_PARAM(BOOL, compressFast);
+        FUNCTION_TEST_PARAM(STRINGZ, checksumRepo);
+        FUNCTION_TEST_PARAM(UINT64, splitSize);
+        FUNCTION_TEST_PARAM(STRING, splitChecksum);
     FUNCTION_TEST_END();
 
     ASSERT(this != NULL);
     ASSERT(name != NULL);
+    ASSERT(checksumRepo == NULL || checksumRepo[0] == 0 || strlen(checksumRepo) == HASH_TYPE_MD5_SIZE_HEX);
+    ASSERT((splitSize == 0 && splitChecksum == NULL) || (splitSize != 0 && splitChecksum != NULL && bundleId == 0 && !dedup));
+    ASSERT(!dedup || bundleId == 0);
+    ASSERT(!bundleDict || bundleId != 0);
     ASSERT(
         (!checksumPage && !checksumPageError && checksumPageErrorList == NULL) ||
         (checksumPage && !checksumPageError && checksumPageErrorList == NULL) || (checksumPage && checksumPageError));
@@ -2809,6 +2980,20 @@ manifestFileUpdate(
     // Update bundle info
     file.bundleId = bundleId;
     file.bundleOffset = bundleOffset;
+    file.bundleDict = bundleDict;
+
+    // Update dedup
+    file.dedup = dedup;
+
+    // Update compressed at the fastest level
+    file.compressFast = compressFast;
+
+    // Update repo checksum. The checksum is cleared when not set since the repo file has been replaced.
+    strcpy(file.checksumRepo, checksumRepo != NULL ? checksumRepo : "");
+
+    // Update split info
+    file.splitSize = splitSize;
+    file.splitChecksum = splitChecksum;
 
     manifestFilePackUpdate(this, filePack, &file);
 
@@ -3058,6 +3243,39 @@ manifestBackupLabelSet(Manifest *this, const String *backupLabel)
     FUNCTION_TEST_RETURN_VOID();
 }
 
+/**********************************************************************************************************************************/
+void
+manifestBundleDictSet(Manifest *const this, const bool bundleDict)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(MANIFEST, this);
+        FUNCTION_TEST_PARAM(BOOL, bundleDict);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(!bundleDict || this->pub.data.bundle);
+
+    this->pub.data.bundleDict = bundleDict;
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+void
+manifestPgIdSet(Manifest *const this, const unsigned int pgId)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(MANIFEST, this);
+        FUNCTION_TEST_PARAM(UINT, pgId);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    this->pub.data.pgId = pgId;
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
 /**********************************************************************************************************************************/
 typedef struct ManifestLoadFileData
 {
@@ -3141,3 +3359,53 @@ manifestLoadFile(const Storage *storage, const String *fileName, CipherType ciph
 
     FUNCTION_LOG_RETURN(MANIFEST, data.manifest);
 }
+
+/**********************************************************************************************************************************/
+String *
+manifestDedupFile(const char *const checksumSha1, const CompressType compressType)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRINGZ, checksumSha1);
+        FUNCTION_TEST_PARAM(ENUM, compressType);
+    FUNCTION_TEST_END();
+
+    ASSERT(checksumSha1 != NULL);
+    ASSERT(strlen(checksumSha1) == HASH_TYPE_SHA1_SIZE_HEX);
+
+    FUNCTION_TEST_RETURN(
+        STRING,
+        strNewFmt(MANIFEST_PATH_DEDUP "/%.2s/%s%s", checksumSha1, checksumSha1, strZ(compressExtStr(compressType))));
+}
+
+/**********************************************************************************************************************************/
+String *
+manifestSplitFile(const String *const name, const unsigned int partIdx, const CompressType compressType)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, name);
+        FUNCTION_TEST_PARAM(UINT, partIdx);
+        FUNCTION_TEST_PARAM(ENUM, compressType);
+    FUNCTION_TEST_END();
+
+    ASSERT(name != NULL);
+
+    FUNCTION_TEST_RETURN(
+        STRING, strNewFmt("%s." PROJECT_BIN ".part.%u%s", strZ(name), partIdx, strZ(compressExtStr(compressType))));
+}
+
+/**********************************************************************************************************************************/
+String *
+manifestSplitChecksum(const ManifestFile *const file, const unsigned int partIdx)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(MANIFEST_FILE, file);
+        FUNCTION_TEST_PARAM(UINT, partIdx);
+    FUNCTION_TEST_END();
+
+    ASSERT(file != NULL);
+    ASSERT(file->splitChecksum != NULL);
+    ASSERT(partIdx < manifestSplitTotal(file));
+
+    FUNCTION_TEST_RETURN(
+        STRING, strSubN(file->splitChecksum, partIdx * HASH_TYPE_SHA1_SIZE_HEX, HASH_TYPE_SHA1_SIZE_HEX));
+}
@@ -19,6 +19,8 @@ Constants
 
 #define MANIFEST_PATH_BUNDLE                                        "bundle"
     STRING_DECLARE(MANIFEST_PATH_BUNDLE_STR);
+#define MANIFEST_PATH_DEDUP                                         "dedup"
+#define MANIFEST_FILE_BUNDLE_DICT                                   MANIFEST_PATH_BUNDLE "/dict"
 
 #define MANIFEST_TARGET_PGDATA                                      "pg_data"
     STRING_DECLARE(MANIFEST_TARGET_PGDATA_STR);
@@ -54,6 +56,7 @@ typedef struct ManifestData
     time_t backupTimestampStop;                                     // When did the backup stop?
     BackupType backupType;                                          // Type of backup: full, diff, incr
     bool bundle;                                                    // Does the backup bundle files?
+    bool bundleDict;                                                // Is there a dictionary to compress bundled files?
 
     // ??? Note that these fields are redundant and verbose since storing the start/stop lsn as a uint64 would be sufficient.
     // However, we currently lack the functions to transform these values back and forth so this will do for now.
@@ -101,8 +104,12 @@ typedef struct ManifestFile
     const String *name;                                             // File name (must be first member in struct)
     bool checksumPage:1;                                            // Does this file have page checksums?
     bool checksumPageError:1;                                       // Is there an error in the page checksum?
+    bool dedup:1;                                                   // Is the file in the dedup store?
+    bool bundleDict:1;                                              // Is the file compressed with the bundle dictionary?
+    bool compressFast:1;                                            // Compressed at the fastest level (did not compress well)?
     mode_t mode;                                                    // File mode
-    char checksumSha1[HASH_TYPE_SHA1_SIZE_HEX + 1];                 // SHA1 checksum
+    char checksumSha1[HASH_TYPE_SHA1_SIZE_HEX + 1];                 // SHA1 checksum (SHA1 of the part checksums when split)
+    char checksumRepo[HASH_TYPE_MD5_SIZE_HEX + 1];                  // MD5 checksum of the repo file (empty if not recorded)
     const String *checksumPageErrorList;                            // List of page checksum errors if there are any
     const String *user;                                             // User name
     const String *group;                                            // Group name
@@ -111,6 +118,8 @@ typedef struct ManifestFile
     uint64_t bundleOffset;                                          // Bundle offset
     uint64_t size;                                                  // Original size
     uint64_t sizeRepo;                                              // Size in repo
+    uint64_t splitSize;                                             // Size of the parts the file is stored in (0 if not split)
+    const String *splitChecksum;                                    // SHA1 checksums of the parts concatenated (when split)
     time_t timestamp;                                               // Original timestamp
 } ManifestFile;
 
@@ -204,6 +213,12 @@ manifestData(const Manifest *const this)
 // Set backup label
 void manifestBackupLabelSet(Manifest *this, const String *backupLabel);
 
+// Set when a dictionary is stored in the backup (see MANIFEST_FILE_BUNDLE_DICT) to compress bundled files
+void manifestBundleDictSet(Manifest *this, bool bundleDict);
+
+// Set PostgreSQL id, e.g. when the backup is copied to a repo where the history has different ids
+void manifestPgIdSet(Manifest *this, unsigned int pgId);
+
 /***********************************************************************************************************************************
 Build functions
 ***********************************************************************************************************************************/
@@ -327,7 +342,8 @@ manifestFileTotal(const Manifest *const this)
 // Update a file with new data
 void manifestFileUpdate(
     Manifest *this, const String *name, uint64_t size, uint64_t sizeRepo, const char *checksumSha1, const Variant *reference,
-    bool checksumPage, bool checksumPageError, const String *checksumPageErrorList, uint64_t bundleId, uint64_t bundleOffset);
+    bool checksumPage, bool checksumPageError, const String *checksumPageErrorList, uint64_t bundleId, uint64_t bundleOffset,
+    bool bundleDict, bool dedup, bool compressFast, const char *checksumRepo, uint64_t splitSize, const String *splitChecksum);
 
 /***********************************************************************************************************************************
 Link functions and getters/setters
@@ -442,6 +458,34 @@ Helper functions
 // Load backup manifest
 Manifest *manifestLoadFile(const Storage *storage, const String *fileName, CipherType cipherType, const String *cipherPass);
 
+// Name of a file in the dedup store relative to the stanza backup path. Files are stored by the checksum of the original file and
+// the compression extension since backups with different compression types cannot share files.
+String *manifestDedupFile(const char *checksumSha1, CompressType compressType);
+
+// Number of parts a split file is stored in (see ManifestFile.splitSize)
+FN_INLINE_ALWAYS unsigned int
+manifestSplitTotal(const ManifestFile *const file)
+{
+    ASSERT_INLINE(file->splitSize != 0);
+    return (unsigned int)((file->size + file->splitSize - 1) / file->splitSize);
+}
+
+// Size of a part of a split file
+FN_INLINE_ALWAYS uint64_t
+manifestSplitSize(const ManifestFile *const file, const unsigned int partIdx)
+{
+    ASSERT_INLINE(partIdx < manifestSplitTotal(file));
+    const uint64_t offset = file->splitSize * partIdx;
+    return file->size - offset < file->splitSize ? file->size - offset : file->splitSize;
+}
+
+// Name of a part of a split file relative to the backup path. Each part holds splitSize bytes of the file (the last part may hold
+// less) and is compressed and encrypted on its own.
+String *manifestSplitFile(const String *name, unsigned int partIdx, CompressType compressType);
+
+// SHA1 checksum of a part of a split file
+String *manifestSplitChecksum(const ManifestFile *file, unsigned int partIdx);
+
 /***********************************************************************************************************************************
 Macros for function logging
 ***********************************************************************************************************************************/
@@ -21,6 +21,8 @@ Main
 #include "command/info/info.h"
 #include "command/local/local.h"
 #include "command/remote/remote.h"
+#include "command/report.h"
+#include "command/repo/copy.h"
 #include "command/repo/create.h"
 #include "command/repo/get.h"
 #include "command/repo/ls.h"
@@ -73,6 +75,9 @@ main(int argListSize, const char *argList[])
 
     storageHelperInit(storageHelperList);
 
+    // Set function to run locals in a forked process
+    protocolLocalForkInit(cmdLocalFork);
+
 #ifdef WITH_BACKTRACE
     stackTraceInit(argList[0]);
 #endif
@@ -88,8 +93,9 @@ main(int argListSize, const char *argList[])
     // Initialize statistics collector
     statInit();
 
-    // Initialize exit handler
+    // Initialize exit handler and write reports on exit if the command did not write them
     exitInit();
+    exitReportInit(cmdReportWrite);
 
     // Process commands
     volatile int result = 0;
@@ -132,6 +138,9 @@ main(int argListSize, const char *argList[])
         }
         else
         {
+            // Initialize reports, e.g. start the trace collector when a trace file is requested
+            cmdReportInit();
+
             switch (cfgCommand())
             {
                 // Annotate command
@@ -174,6 +183,7 @@ main(int argListSize, const char *argList[])
                     if (cfgOptionBool(cfgOptExpireAuto))
                     {
                         // Switch to expire command
+                        cmdReportStatCollect();
                         cmdEnd(0, NULL);
                         cfgCommandSet(cfgCmdExpire, cfgCmdRoleMain);
                         cfgLoadLogFile();
@@ -213,6 +223,12 @@ main(int argListSize, const char *argList[])
                     cmdInfo();
                     break;
 
+                // Repository copy command
+                // -----------------------------------------------------------------------------------------------------------------
+                case cfgCmdRepoCopy:
+                    cmdRepoCopy();
+                    break;
+
                 // Repository create command
                 // -----------------------------------------------------------------------------------------------------------------
                 case cfgCmdRepoCreate:
@@ -304,6 +320,12 @@ main(int argListSize, const char *argList[])
                     fflush(stdout);
                     break;
             }
+
+            // Collect stats from locals and remotes before they are freed so the stats reported at command end are complete
+            cmdReportStatCollect();
+
+            // Write stat and trace files when requested
+            cmdReportWrite();
         }
     }
     CATCH_FATAL()
@@ -5,6 +5,8 @@ Protocol Client
 
 #include "common/debug.h"
 #include "common/log.h"
+#include "common/stat.h"
+#include "common/trace.h"
 #include "common/time.h"
 #include "common/type/json.h"
 #include "common/type/keyValue.h"
@@ -44,6 +46,8 @@ struct ProtocolClient
     const String *name;                                             // Name displayed in logging
     const String *errorPrefix;                                      // Prefix used when throwing error
     TimeMSec keepAliveTime;                                         // Last time data was put to the server
+    StringId command;                                               // Command in progress
+    uint64_t commandTimeBegin;                                      // Time the command in progress was put
 };
 
 /***********************************************************************************************************************************
@@ -318,6 +322,9 @@ protocolClientDataEndGet(ProtocolClient *const this)
 
         // Switch state to idle after successful data end get
         this->state = protocolClientStateIdle;
+
+        // Record the command latency
+        statTimeEnd(statKeyStrId(PROTOCOL_STAT_LATENCY, this->command), this->commandTimeBegin);
     }
     MEM_CONTEXT_TEMP_END();
 
@@ -344,6 +351,9 @@ protocolClientCommandPut(ProtocolClient *const this, ProtocolCommand *const comm
     this->state = protocolClientStateDataPut;
 
     // Put command
+    this->command = protocolCommandId(command);
+    this->commandTimeBegin = statTimeBegin();
+
     protocolCommandPut(command, this->write);
 
     // Switch state to data-get/data-put after successful command put
@@ -402,6 +412,28 @@ protocolClientNoOp(ProtocolClient *this)
     FUNCTION_LOG_RETURN_VOID();
 }
 
+/**********************************************************************************************************************************/
+void
+protocolClientStat(ProtocolClient *const this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(PROTOCOL_CLIENT, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        PackRead *const statPack = protocolClientExecute(this, protocolCommandNew(PROTOCOL_COMMAND_STAT), true);
+
+        statMerge(pckReadStrP(statPack));
+        traceMerge(pckReadStrP(statPack));
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
 /**********************************************************************************************************************************/
 String *
 protocolClientToLog(const ProtocolClient *this)
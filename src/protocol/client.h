@@ -42,6 +42,12 @@ Constants
 #define PROTOCOL_COMMAND_CONFIG                                     STRID5("config", 0xe9339e30)
 #define PROTOCOL_COMMAND_EXIT                                       STRID5("exit", 0xa27050)
 #define PROTOCOL_COMMAND_NOOP                                       STRID5("noop", 0x83dee0)
+#define PROTOCOL_COMMAND_STAT                                       STRID5("stat", 0xa06930)
+
+/***********************************************************************************************************************************
+Statistics constants
+***********************************************************************************************************************************/
+#define PROTOCOL_STAT_LATENCY                                       "protocol.latency"  // Latency prefix (command is appended)
 
 /***********************************************************************************************************************************
 This size should be safe for most pack data without wasting a lot of space. If binary data is being transferred then this size can
@@ -99,6 +105,9 @@ protocolClientNoExit(ProtocolClient *const this)
 // Send noop to test connection or keep it alive
 void protocolClientNoOp(ProtocolClient *this);
 
+// Get stats and trace events from the server and merge them into the stats and trace events for this process
+void protocolClientStat(ProtocolClient *this);
+
 // Get data put by the server
 PackRead *protocolClientDataGet(ProtocolClient *this);
 void protocolClientDataEndGet(ProtocolClient *this);
@@ -14,7 +14,7 @@ Object type
 ***********************************************************************************************************************************/
 struct ProtocolCommand
 {
-    StringId command;
+    ProtocolCommandPub pub;                                         // Publicly accessible variables
     PackWrite *pack;
 };
 
@@ -36,7 +36,10 @@ protocolCommandNew(const StringId command)
 
         *this = (ProtocolCommand)
         {
-            .command = command,
+            .pub =
+            {
+                .command = command,
+            },
         };
     }
     OBJ_NEW_END();
@@ -60,7 +63,7 @@ protocolCommandPut(ProtocolCommand *const this, IoWrite *const write)
         // Write the command and flush to be sure the command gets sent immediately
         PackWrite *commandPack = pckWriteNewIo(write);
         pckWriteU32P(commandPack, protocolMessageTypeCommand, .defaultWrite = true);
-        pckWriteStrIdP(commandPack, this->command);
+        pckWriteStrIdP(commandPack, protocolCommandId(this));
 
         // Only write params if there were any
         if (this->pack != NULL)
@@ -105,5 +108,5 @@ protocolCommandParam(ProtocolCommand *this)
 String *
 protocolCommandToLog(const ProtocolCommand *this)
 {
-    return strNewFmt("{command: %s}", strZ(strIdToStr(this->command)));
+    return strNewFmt("{command: %s}", strZ(strIdToStr(protocolCommandId(this))));
 }
@@ -17,6 +17,21 @@ Constructors
 ***********************************************************************************************************************************/
 ProtocolCommand *protocolCommandNew(const StringId command);
 
+/***********************************************************************************************************************************
+Getters/Setters
+***********************************************************************************************************************************/
+typedef struct ProtocolCommandPub
+{
+    StringId command;                                               // Command id
+} ProtocolCommandPub;
+
+// Command id
+FN_INLINE_ALWAYS StringId
+protocolCommandId(const ProtocolCommand *const this)
+{
+    return THIS_PUB(ProtocolCommand)->command;
+}
+
 /***********************************************************************************************************************************
 Functions
 ***********************************************************************************************************************************/
@@ -9,6 +9,7 @@ Protocol Helper
 #include "common/debug.h"
 #include "common/exec.h"
 #include "common/io/client.h"
+#include "common/io/io.h"
 #include "common/io/socket/client.h"
 #include "common/io/socket/server.h"
 #include "common/io/tls/client.h"
@@ -40,9 +41,10 @@ typedef struct ProtocolHelperClient
     ProtocolClient *client;                                         // Protocol client
 } ProtocolHelperClient;
 
-static struct
+static struct ProtocolHelperLocal
 {
     MemContext *memContext;                                         // Mem context for protocol helper
+    ExecForkFunction localFork;                                     // Function to run locals in a forked process
 
     unsigned int clientRemoteSize;                                  // Remote clients
     ProtocolHelperClient *clientRemote;
@@ -130,6 +132,69 @@ pgIsLocalVerify(void)
     FUNCTION_TEST_RETURN_VOID();
 }
 
+/**********************************************************************************************************************************/
+void
+protocolLocalForkInit(const ExecForkFunction function)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(FUNCTIONP, function);
+    FUNCTION_TEST_END();
+
+    protocolHelper.localFork = function;
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Forget clients inherited from the parent process after a fork. The clients cannot be freed normally since that would send exit
+commands to servers and wait on processes that belong to the parent, so clear the callbacks before freeing.
+***********************************************************************************************************************************/
+static void
+protocolHelperClientForget(ProtocolHelperClient *const helperList, const unsigned int helperListSize)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, helperList);
+        FUNCTION_TEST_PARAM(UINT, helperListSize);
+    FUNCTION_TEST_END();
+
+    for (unsigned int helperIdx = 0; helperIdx < helperListSize; helperIdx++)
+    {
+        if (helperList[helperIdx].client != NULL)
+            memContextCallbackClear(objMemContext(helperList[helperIdx].client));
+
+        if (helperList[helperIdx].exec != NULL)
+            memContextCallbackClear(objMemContext(helperList[helperIdx].exec));
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Run a local in a process forked from the main process
+***********************************************************************************************************************************/
+static int
+protocolLocalFork(const StringList *const param, IoRead *const forkRead, IoWrite *const forkWrite)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STRING_LIST, param);
+        FUNCTION_LOG_PARAM(IO_READ, forkRead);
+        FUNCTION_LOG_PARAM(IO_WRITE, forkWrite);
+    FUNCTION_LOG_END();
+
+    ASSERT(protocolHelper.localFork != NULL);
+
+    ASSERT(protocolHelper.memContext != NULL);
+
+    // Forget clients inherited from the main process. The helper mem context cannot be freed since the fork happened inside it, but
+    // the memory is released when the local exits.
+    protocolHelperClientForget(protocolHelper.clientRemote, protocolHelper.clientRemoteSize);
+    protocolHelperClientForget(protocolHelper.clientLocal, protocolHelper.clientLocalSize);
+
+    protocolHelper = (struct ProtocolHelperLocal){.localFork = protocolHelper.localFork};
+
+    FUNCTION_LOG_RETURN(INT, protocolHelper.localFork(param, forkRead, forkWrite));
+}
+
 /***********************************************************************************************************************************
 Get the command line required for local protocol execution
 ***********************************************************************************************************************************/
@@ -205,7 +270,13 @@ protocolLocalExec(
 
         MEM_CONTEXT_PRIOR_BEGIN()
         {
-            helper->exec = execNew(cfgExe(), param, name, cfgOptionUInt64(cfgOptProtocolTimeout));
+            // Fork the local without executing a new process when requested. A forked local communicates with the main process
+            // using shared memory rings rather than pipes.
+            const bool fork = cfgOptionBool(cfgOptProcessFork);
+
+            helper->exec = execNewP(
+                cfgExe(), param, name, cfgOptionUInt64(cfgOptProtocolTimeout), .fork = fork ? protocolLocalFork : NULL,
+                .ringSize = fork ? ioBufferSize() : 0);
         }
         MEM_CONTEXT_PRIOR_END();
 
@@ -694,7 +765,7 @@ protocolRemoteExec(
 
                 MEM_CONTEXT_PRIOR_BEGIN()
                 {
-                    helper->exec = execNew(cfgOptionStr(cfgOptCmdSsh), param, name, cfgOptionUInt64(cfgOptProtocolTimeout));
+                    helper->exec = execNewP(cfgOptionStr(cfgOptCmdSsh), param, name, cfgOptionUInt64(cfgOptProtocolTimeout));
                 }
                 MEM_CONTEXT_PRIOR_END();
 
@@ -890,6 +961,30 @@ protocolKeepAlive(void)
     FUNCTION_LOG_RETURN_VOID();
 }
 
+/**********************************************************************************************************************************/
+void
+protocolStatCollect(void)
+{
+    FUNCTION_LOG_VOID(logLevelTrace);
+
+    if (protocolHelper.memContext != NULL)
+    {
+        for (unsigned int clientIdx = 0; clientIdx < protocolHelper.clientRemoteSize; clientIdx++)
+        {
+            if (protocolHelper.clientRemote[clientIdx].client != NULL)
+                protocolClientStat(protocolHelper.clientRemote[clientIdx].client);
+        }
+
+        for (unsigned int clientIdx = 0; clientIdx < protocolHelper.clientLocalSize; clientIdx++)
+        {
+            if (protocolHelper.clientLocal[clientIdx].client != NULL)
+                protocolClientStat(protocolHelper.clientLocal[clientIdx].client);
+        }
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
 /**********************************************************************************************************************************/
 void
 protocolFree(void)
@@ -15,6 +15,7 @@ typedef enum
     protocolStorageTypeRepo = STRID5("repo", 0x7c0b20),
 } ProtocolStorageType;
 
+#include "common/exec.h"
 #include "common/io/server.h"
 #include "protocol/server.h"
 
@@ -48,6 +49,13 @@ Functions
 // Send keepalives to all remotes
 void protocolKeepAlive(void);
 
+// Get stats and trace events from all locals and remotes and merge them into the stats and trace events for this process
+void protocolStatCollect(void);
+
+// Set the function used to run a local in a process forked from the main process when process-fork is enabled. The function is
+// called in the forked process after clients inherited from the main process have been forgotten.
+void protocolLocalForkInit(ExecForkFunction function);
+
 // Local protocol client
 ProtocolClient *protocolLocalGet(ProtocolStorageType protocolStorageType, unsigned int hostId, unsigned int protocolId);
 
@@ -15,6 +15,11 @@ Protocol Parallel Executor
 #include "protocol/helper.h"
 #include "protocol/parallel.h"
 
+/***********************************************************************************************************************************
+Jobs smaller than this are not sampled since their time is mostly overhead that does not depend on the number of active clients
+***********************************************************************************************************************************/
+#define PROTOCOL_PARALLEL_SAMPLE_SIZE_MIN                           (1024 * 1024)
+
 /***********************************************************************************************************************************
 Object type
 ***********************************************************************************************************************************/
@@ -28,6 +33,17 @@ struct ProtocolParallel
     List *jobList;                                                  // List of jobs to be processed
 
     ProtocolParallelJob **clientJobList;                            // Jobs being processing by each client
+    unsigned int clientActive;                                      // Clients that may be given new jobs
+
+    unsigned int clientMin;                                         // Min active clients when adapting (0 when not adapting)
+    uint64_t latencyTarget;                                         // Target usec per MiB (0 for twice the lowest latency)
+    uint64_t latencyMin;                                            // Lowest usec per MiB observed
+    unsigned int sampleTotal;                                       // Samples since the last adjustment
+    uint64_t sampleSize;                                            // Size of samples since the last adjustment
+    uint64_t sampleTime;                                            // Time of samples since the last adjustment
+
+    bool wait;                                                      // Wait for jobs instead of freeing clients while jobs run?
+    unsigned int clientWait;                                        // Clients waiting for jobs
 
     ProtocolParallelJobState state;                                 // Overall state of job processing
 };
@@ -87,6 +103,113 @@ protocolParallelClientAdd(ProtocolParallel *this, ProtocolClient *client)
     FUNCTION_LOG_RETURN_VOID();
 }
 
+/**********************************************************************************************************************************/
+void
+protocolParallelAdapt(ProtocolParallel *const this, const unsigned int clientMin, const TimeMSec latencyTarget)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(PROTOCOL_PARALLEL, this);
+        FUNCTION_LOG_PARAM(UINT, clientMin);
+        FUNCTION_LOG_PARAM(TIME_MSEC, latencyTarget);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->state == protocolParallelJobStatePending);
+    ASSERT(clientMin > 0);
+
+    this->clientMin = clientMin;
+    this->latencyTarget = latencyTarget * 1000;
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+void
+protocolParallelWait(ProtocolParallel *const this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(PROTOCOL_PARALLEL, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->state == protocolParallelJobStatePending);
+
+    this->wait = true;
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+unsigned int
+protocolParallelClientActive(const ProtocolParallel *const this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(PROTOCOL_PARALLEL, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(UINT, this->clientActive);
+}
+
+/**********************************************************************************************************************************/
+void
+protocolParallelSample(ProtocolParallel *const this, const uint64_t size, const uint64_t time)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(PROTOCOL_PARALLEL, this);
+        FUNCTION_LOG_PARAM(UINT64, size);
+        FUNCTION_LOG_PARAM(UINT64, time);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->state != protocolParallelJobStatePending);
+
+    if (this->clientMin > 0 && size >= PROTOCOL_PARALLEL_SAMPLE_SIZE_MIN)
+    {
+        this->sampleTotal++;
+        this->sampleSize += size;
+        this->sampleTime += time;
+
+        // Adjust when there has been (on average) one sample per active client since the last adjustment so the latency reflects
+        // the current number of active clients
+        if (this->sampleTotal >= this->clientActive)
+        {
+            const uint64_t latency = this->sampleTime * 1024 * 1024 / this->sampleSize;
+
+            if (this->latencyMin == 0 || latency < this->latencyMin)
+                this->latencyMin = latency;
+
+            const uint64_t latencyTarget = this->latencyTarget != 0 ? this->latencyTarget : this->latencyMin * 2;
+            const unsigned int clientActivePrior = this->clientActive;
+
+            // Park a client when the latency is over the target. Activate a client when the latency is comfortably under the target
+            // so the number of active clients does not flip back and forth around the target.
+            if (latency > latencyTarget)
+            {
+                if (this->clientActive > this->clientMin)
+                    this->clientActive--;
+            }
+            else if (latency < latencyTarget / 4 * 3 && this->clientActive < lstSize(this->clientList))
+                this->clientActive++;
+
+            if (this->clientActive != clientActivePrior)
+            {
+                LOG_DETAIL_FMT(
+                    "%s process total to %u (latency %" PRIu64 "ms/MiB, target %" PRIu64 "ms/MiB)",
+                    this->clientActive > clientActivePrior ? "increase" : "decrease", this->clientActive, latency / 1000,
+                    latencyTarget / 1000);
+            }
+
+            this->sampleTotal = 0;
+            this->sampleSize = 0;
+            this->sampleTime = 0;
+        }
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
 /**********************************************************************************************************************************/
 unsigned int
 protocolParallelProcess(ProtocolParallel *this)
@@ -111,6 +234,10 @@ protocolParallelProcess(ProtocolParallel *this)
             }
             MEM_CONTEXT_OBJ_END();
 
+            // Start with the min clients when adapting, else all clients are active
+            ASSERT(this->clientMin <= lstSize(this->clientList));
+            this->clientActive = this->clientMin > 0 ? this->clientMin : lstSize(this->clientList);
+
             this->state = protocolParallelJobStateRunning;
         }
 
@@ -186,8 +313,10 @@ protocolParallelProcess(ProtocolParallel *this)
             }
         }
 
-        // Find new jobs to be run
-        for (unsigned int clientIdx = 0; clientIdx < lstSize(this->clientList); clientIdx++)
+        // Find new jobs to be run on active clients
+        this->clientWait = 0;
+
+        for (unsigned int clientIdx = 0; clientIdx < this->clientActive; clientIdx++)
         {
             // If nothing is running for this client
             if (this->clientJobList[clientIdx] == NULL)
@@ -216,6 +345,9 @@ protocolParallelProcess(ProtocolParallel *this)
                     protocolParallelJobStateSet(job, protocolParallelJobStateRunning);
                     this->clientJobList[clientIdx] = job;
                 }
+                // Else wait when there are jobs that have not been collected since their results may make new jobs available
+                else if (this->wait && !lstEmpty(this->jobList))
+                    this->clientWait++;
                 // Else no more jobs for this client so free it
                 else
                     protocolLocalFree(clientIdx + 1);
@@ -267,9 +399,15 @@ protocolParallelDone(ProtocolParallel *this)
     ASSERT(this != NULL);
     ASSERT(this->state != protocolParallelJobStatePending);
 
-    // If there are no jobs left then we are done
-    if (this->state != protocolParallelJobStateDone && lstEmpty(this->jobList))
+    // If there are no jobs left and no clients waiting for jobs then we are done
+    if (this->state != protocolParallelJobStateDone && lstEmpty(this->jobList) && this->clientWait == 0)
+    {
+        // Free parked clients since they were not freed when active clients ran out of jobs
+        for (unsigned int clientIdx = this->clientActive; clientIdx < lstSize(this->clientList); clientIdx++)
+            protocolLocalFree(clientIdx + 1);
+
         this->state = protocolParallelJobStateDone;
+    }
 
     FUNCTION_LOG_RETURN(BOOL, this->state == protocolParallelJobStateDone);
 }
@@ -279,6 +417,6 @@ String *
 protocolParallelToLog(const ProtocolParallel *this)
 {
     return strNewFmt(
-        "{state: %s, clientTotal: %u, jobTotal: %u}", strZ(strIdToStr(this->state)), lstSize(this->clientList),
-        lstSize(this->jobList));
+        "{state: %s, clientTotal: %u, clientActive: %u, jobTotal: %u}", strZ(strIdToStr(this->state)), lstSize(this->clientList),
+        this->clientActive, lstSize(this->jobList));
 }
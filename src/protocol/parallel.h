@@ -36,12 +36,31 @@ bool protocolParallelDone(ProtocolParallel *this);
 // Completed job result
 ProtocolParallelJob *protocolParallelResult(ProtocolParallel *this);
 
+// Number of clients that may be given new jobs. The remaining clients are parked, i.e. they are not given new jobs but are not
+// freed so they can be activated again.
+unsigned int protocolParallelClientActive(const ProtocolParallel *this);
+
 /***********************************************************************************************************************************
 Functions
 ***********************************************************************************************************************************/
 // Add client
 void protocolParallelClientAdd(ProtocolParallel *this, ProtocolClient *client);
 
+// Adapt the number of active clients between clientMin and the number of clients added to hold the target latency, i.e. the time
+// in msec for a client to process one MiB of data. When latencyTarget is zero the target is twice the lowest latency observed so
+// far. Processing starts with clientMin active clients. Since clients are parked from the end of the list, the callback must be
+// able to give any job to the first clientMin clients.
+void protocolParallelAdapt(ProtocolParallel *this, unsigned int clientMin, TimeMSec latencyTarget);
+
+// Wait for new jobs rather than freeing a client when the callback has no job for it while other jobs are running or have results
+// that have not been collected. This allows the callback to hold back jobs that depend on the results of other jobs. The callback
+// is called again for waiting clients on the next process.
+void protocolParallelWait(ProtocolParallel *this);
+
+// Add a sample from a completed job, i.e. the size of the data processed and the job time (see protocolParallelJobTime()). Samples
+// are only used when adapting the number of active clients.
+void protocolParallelSample(ProtocolParallel *this, uint64_t size, uint64_t time);
+
 // Process jobs
 unsigned int protocolParallelProcess(ProtocolParallel *this);
 
@@ -5,6 +5,7 @@ Protocol Parallel Job
 
 #include "common/debug.h"
 #include "common/log.h"
+#include "common/stat.h"
 #include "protocol/command.h"
 #include "protocol/parallelJob.h"
 
@@ -14,6 +15,7 @@ Object type
 struct ProtocolParallelJob
 {
     ProtocolParallelJobPub pub;                                     // Publicly accessible variables
+    uint64_t timeBegin;                                             // Time when the job started running
 };
 
 /**********************************************************************************************************************************/
@@ -117,9 +119,15 @@ protocolParallelJobStateSet(ProtocolParallelJob *this, ProtocolParallelJobState
     ASSERT(this != NULL);
 
     if (this->pub.state == protocolParallelJobStatePending && state == protocolParallelJobStateRunning)
+    {
         this->pub.state = protocolParallelJobStateRunning;
+        this->timeBegin = statTimeBegin();
+    }
     else if (this->pub.state == protocolParallelJobStateRunning && state == protocolParallelJobStateDone)
+    {
         this->pub.state = protocolParallelJobStateDone;
+        this->pub.time = statTimeBegin() - this->timeBegin;
+    }
     else
     {
         THROW_FMT(
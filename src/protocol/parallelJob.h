@@ -43,6 +43,7 @@ typedef struct ProtocolParallelJobPub
     int code;                                                       // Non-zero result indicates an error
     String *message;                                                // Message if there was a error
     PackRead *result;                                               // Result if job was successful
+    uint64_t time;                                                  // Time in usec from running to done
 } ProtocolParallelJobPub;
 
 // Job command
@@ -101,6 +102,13 @@ protocolParallelJobState(const ProtocolParallelJob *const this)
 
 void protocolParallelJobStateSet(ProtocolParallelJob *this, ProtocolParallelJobState state);
 
+// Job time, i.e. usec elapsed between running and done states
+FN_INLINE_ALWAYS uint64_t
+protocolParallelJobTime(const ProtocolParallelJob *const this)
+{
+    return THIS_PUB(ProtocolParallelJob)->time;
+}
+
 /***********************************************************************************************************************************
 Functions
 ***********************************************************************************************************************************/
@@ -7,6 +7,8 @@ Protocol Server
 
 #include "common/debug.h"
 #include "common/log.h"
+#include "common/stat.h"
+#include "common/trace.h"
 #include "common/time.h"
 #include "common/type/json.h"
 #include "common/type/keyValue.h"
@@ -272,6 +274,25 @@ protocolServerProcess(
                             protocolServerDataEndPut(this);
                             break;
 
+                        // Send stats and trace events (including those collected from processes started by this process) and reset
+                        // them so they are not sent again
+                        case PROTOCOL_COMMAND_STAT:
+                        {
+                            protocolStatCollect();
+
+                            PackWrite *const statPack = protocolPackNew();
+
+                            pckWriteStrP(statPack, statToJsonP(.histogram = true));
+                            pckWriteStrP(statPack, traceEvent());
+
+                            protocolServerDataPut(this, statPack);
+                            protocolServerDataEndPut(this);
+
+                            statReset();
+                            traceReset();
+                            break;
+                        }
+
                         default:
                             THROW_FMT(
                                 ProtocolError, "invalid command '%s' (0x%" PRIx64 ")", strZ(strIdToStr(command.id)), command.id);
@@ -16,16 +16,27 @@ Azure Storage
 #include "common/regExp.h"
 #include "common/type/object.h"
 #include "common/type/xml.h"
+#include "common/wait.h"
 #include "storage/azure/read.h"
 #include "storage/azure/storage.intern.h"
 #include "storage/azure/write.h"
 
+/***********************************************************************************************************************************
+Defaults
+***********************************************************************************************************************************/
+#define STORAGE_AZURE_DELETE_ASYNC_MAX                              16
+
 /***********************************************************************************************************************************
 Azure http headers
 ***********************************************************************************************************************************/
+STRING_STATIC(AZURE_HEADER_COPY_SOURCE_STR,                         "x-ms-copy-source");
+STRING_STATIC(AZURE_HEADER_COPY_STATUS_STR,                         "x-ms-copy-status");
 STRING_STATIC(AZURE_HEADER_VERSION_STR,                             "x-ms-version");
 STRING_STATIC(AZURE_HEADER_VERSION_VALUE_STR,                       "2019-02-02");
 
+STRING_STATIC(AZURE_HEADER_VALUE_COPY_PENDING_STR,                  "pending");
+STRING_STATIC(AZURE_HEADER_VALUE_COPY_SUCCESS_STR,                  "success");
+
 /***********************************************************************************************************************************
 Azure query tokens
 ***********************************************************************************************************************************/
@@ -66,7 +77,9 @@ struct StorageAzure
     const Buffer *sharedKey;                                        // Shared key
     const HttpQuery *sasKey;                                        // SAS key
     const String *host;                                             // Host name
+    unsigned int port;                                              // Host port
     size_t blockSize;                                               // Block size for multi-block upload
+    unsigned int deleteAsyncMax;                                    // Maximum delete requests in progress at once
     const String *pathPrefix;                                       // Account/container prefix
 
     uint64_t fileId;                                                // Id to used to make file block identifiers unique
@@ -300,34 +313,43 @@ storageAzureRequest(StorageAzure *this, const String *verb, StorageAzureRequestP
 /***********************************************************************************************************************************
 General function for listing files to be used by other list routines
 ***********************************************************************************************************************************/
-static void
-storageAzureListInternal(
-    StorageAzure *this, const String *path, StorageInfoLevel level, const String *expression, bool recurse,
-    StorageListCallback callback, void *callbackData)
+// Build the base prefix by stripping off the initial /
+static const String *
+storageAzureListBasePrefix(const String *const path)
 {
-    FUNCTION_LOG_BEGIN(logLevelDebug);
-        FUNCTION_LOG_PARAM(STORAGE_AZURE, this);
-        FUNCTION_LOG_PARAM(STRING, path);
-        FUNCTION_LOG_PARAM(ENUM, level);
-        FUNCTION_LOG_PARAM(STRING, expression);
-        FUNCTION_LOG_PARAM(BOOL, recurse);
-        FUNCTION_LOG_PARAM(FUNCTIONP, callback);
-        FUNCTION_LOG_PARAM_P(VOID, callbackData);
-    FUNCTION_LOG_END();
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, path);
+    FUNCTION_TEST_END();
 
-    ASSERT(this != NULL);
     ASSERT(path != NULL);
 
-    MEM_CONTEXT_TEMP_BEGIN()
-    {
-        // Build the base prefix by stripping off the initial /
-        const String *basePrefix;
+    const String *result;
 
-        if (strSize(path) == 1)
-            basePrefix = EMPTY_STR;
-        else
-            basePrefix = strNewFmt("%s/", strZ(strSub(path, 1)));
+    if (strSize(path) == 1)
+        result = EMPTY_STR;
+    else
+        result = strNewFmt("%s/", strZ(strSub(path, 1)));
+
+    FUNCTION_TEST_RETURN_CONST(STRING, result);
+}
 
+// Build the query used to list a path. This is separate from storageAzureListInternal() so storageAzureListMulti() can send the
+// first request for each path before any responses are processed.
+static HttpQuery *
+storageAzureListQuery(const String *const basePrefix, const String *const expression, const bool recurse)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, basePrefix);
+        FUNCTION_TEST_PARAM(STRING, expression);
+        FUNCTION_TEST_PARAM(BOOL, recurse);
+    FUNCTION_TEST_END();
+
+    ASSERT(basePrefix != NULL);
+
+    HttpQuery *const result = httpQueryNewP();
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
         // Get the expression prefix when possible to limit initial results
         const String *expressionPrefix = regExpPrefix(expression);
 
@@ -344,26 +366,51 @@ storageAzureListInternal(
                 queryPrefix = strNewFmt("%s%s", strZ(basePrefix), strZ(expressionPrefix));
         }
 
-        // Create query
-        HttpQuery *query = httpQueryNewP();
-
         // Add the delimiter to not recurse
         if (!recurse)
-            httpQueryAdd(query, AZURE_QUERY_DELIMITER_STR, FSLASH_STR);
+            httpQueryAdd(result, AZURE_QUERY_DELIMITER_STR, FSLASH_STR);
 
         // Add resource type
-        httpQueryAdd(query, AZURE_QUERY_RESTYPE_STR, AZURE_QUERY_VALUE_CONTAINER_STR);
+        httpQueryAdd(result, AZURE_QUERY_RESTYPE_STR, AZURE_QUERY_VALUE_CONTAINER_STR);
 
         // Add list comp
-        httpQueryAdd(query, AZURE_QUERY_COMP_STR, AZURE_QUERY_VALUE_LIST_STR);
+        httpQueryAdd(result, AZURE_QUERY_COMP_STR, AZURE_QUERY_VALUE_LIST_STR);
 
         // Don't specify empty prefix because it is the default
         if (!strEmpty(queryPrefix))
-            httpQueryAdd(query, AZURE_QUERY_PREFIX_STR, queryPrefix);
+            httpQueryAdd(result, AZURE_QUERY_PREFIX_STR, queryPrefix);
+    }
+    MEM_CONTEXT_TEMP_END();
 
-        // Loop as long as a continuation marker returned
-        HttpRequest *request = NULL;
+    FUNCTION_TEST_RETURN(HTTP_QUERY, result);
+}
 
+static void
+storageAzureListInternal(
+    StorageAzure *this, const String *path, StorageInfoLevel level, const String *expression, bool recurse, HttpRequest *request,
+    StorageListCallback callback, void *callbackData)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE_AZURE, this);
+        FUNCTION_LOG_PARAM(STRING, path);
+        FUNCTION_LOG_PARAM(ENUM, level);
+        FUNCTION_LOG_PARAM(STRING, expression);
+        FUNCTION_LOG_PARAM(BOOL, recurse);
+        FUNCTION_LOG_PARAM(HTTP_REQUEST, request);
+        FUNCTION_LOG_PARAM(FUNCTIONP, callback);
+        FUNCTION_LOG_PARAM_P(VOID, callbackData);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(path != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Build the base prefix and query
+        const String *const basePrefix = storageAzureListBasePrefix(path);
+        HttpQuery *const query = storageAzureListQuery(basePrefix, expression, recurse);
+
+        // Loop as long as a continuation marker returned. The first request may have already been sent by the caller.
         do
         {
             // Use an inner mem context here because we could potentially be retrieving millions of files so it is a good idea to
@@ -471,6 +518,75 @@ storageAzureListInternal(
     FUNCTION_LOG_RETURN_VOID();
 }
 
+/**********************************************************************************************************************************/
+static bool
+storageAzureCopy(
+    THIS_VOID, const void *const sourceDriver, const String *const source, const String *const destination,
+    const StorageInterfaceCopyParam param)
+{
+    THIS(StorageAzure);
+
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE_AZURE, this);
+        FUNCTION_LOG_PARAM_P(VOID, sourceDriver);
+        FUNCTION_LOG_PARAM(STRING, source);
+        FUNCTION_LOG_PARAM(STRING, destination);
+        (void)param;                                                // No parameters are used
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(sourceDriver != NULL);
+    ASSERT(source != NULL);
+    ASSERT(destination != NULL);
+
+    const StorageAzure *const sourceAzure = sourceDriver;
+
+    // The shared key authorizes reads of any blob in the account so the source is readable when it is in the same account. A SAS
+    // key may be limited to a container so it cannot be used to read the source.
+    const bool result =
+        this->sharedKey != NULL && sourceAzure->sharedKey != NULL && bufEq(this->sharedKey, sourceAzure->sharedKey) &&
+        strEq(this->account, sourceAzure->account) && strEq(this->host, sourceAzure->host) && this->port == sourceAzure->port;
+
+    if (result)
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            // Start the copy with the URL of the source blob
+            String *const url = strCatFmt(strNew(), "https://%s", strZ(this->host));
+
+            if (this->port != 443)
+                strCatFmt(url, ":%u", this->port);
+
+            strCat(url, httpUriEncode(strNewFmt("%s%s", strZ(sourceAzure->pathPrefix), strZ(source)), true));
+
+            HttpResponse *response = storageAzureRequestP(
+                this, HTTP_VERB_PUT_STR, .path = destination,
+                .header = httpHeaderAdd(httpHeaderNew(NULL), AZURE_HEADER_COPY_SOURCE_STR, url));
+            const String *status = httpHeaderGet(httpResponseHeader(response), AZURE_HEADER_COPY_STATUS_STR);
+
+            // Copies in the same account usually complete before the response but otherwise the destination must be polled until
+            // the copy is done
+            Wait *const wait = waitNew(httpClientTimeout(this->httpClient));
+
+            while (strEq(status, AZURE_HEADER_VALUE_COPY_PENDING_STR) && waitMore(wait))
+            {
+                response = storageAzureRequestP(this, HTTP_VERB_HEAD_STR, .path = destination);
+                status = httpHeaderGet(httpResponseHeader(response), AZURE_HEADER_COPY_STATUS_STR);
+            }
+
+            if (!strEq(status, AZURE_HEADER_VALUE_COPY_SUCCESS_STR))
+            {
+                THROW_FMT(
+                    FileWriteError, "unable to copy '%s' to '%s': copy status is '%s'", strZ(source), strZ(destination),
+                    strZ(status == NULL ? NULL_STR : status));
+            }
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    FUNCTION_LOG_RETURN(BOOL, result);
+}
+
 /**********************************************************************************************************************************/
 static StorageInfo
 storageAzureInfo(THIS_VOID, const String *file, StorageInfoLevel level, StorageInterfaceInfoParam param)
@@ -481,7 +597,7 @@ storageAzureInfo(THIS_VOID, const String *file, StorageInfoLevel level, StorageI
         FUNCTION_LOG_PARAM(STORAGE_AZURE, this);
         FUNCTION_LOG_PARAM(STRING, file);
         FUNCTION_LOG_PARAM(ENUM, level);
-        (void)param;                                                // No parameters are used
+        FUNCTION_LOG_PARAM(BOOL, param.checksum);
     FUNCTION_LOG_END();
 
     ASSERT(this != NULL);
@@ -500,6 +616,15 @@ storageAzureInfo(THIS_VOID, const String *file, StorageInfoLevel level, StorageI
         result.timeModified = httpDateToTime(httpHeaderGet(httpResponseHeader(httpResponse), HTTP_HEADER_LAST_MODIFIED_STR));
     }
 
+    // Get the checksum. Content-MD5 is only stored for blobs that were uploaded in a single request.
+    if (param.checksum && result.exists)
+    {
+        const String *const contentMd5 = httpHeaderGet(httpResponseHeader(httpResponse), HTTP_HEADER_CONTENT_MD5_STR);
+
+        if (contentMd5 != NULL)
+            result.checksum = bufHex(bufNewDecode(encodeBase64, contentMd5));
+    }
+
     httpResponseFree(httpResponse);
 
     FUNCTION_LOG_RETURN(STORAGE_INFO, result);
@@ -539,11 +664,66 @@ storageAzureList(THIS_VOID, const String *const path, const StorageInfoLevel lev
 
     StorageList *const result = storageLstNew(level);
 
-    storageAzureListInternal(this, path, level, param.expression, false, storageAzureListCallback, result);
+    storageAzureListInternal(this, path, level, param.expression, false, NULL, storageAzureListCallback, result);
 
     FUNCTION_LOG_RETURN(STORAGE_LIST, result);
 }
 
+static List *
+storageAzureListMulti(
+    THIS_VOID, const StringList *const pathList, const StorageInfoLevel level, const StorageInterfaceListParam param)
+{
+    THIS(StorageAzure);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_AZURE, this);
+        FUNCTION_LOG_PARAM(STRING_LIST, pathList);
+        FUNCTION_LOG_PARAM(ENUM, level);
+        FUNCTION_LOG_PARAM(STRING, param.expression);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(pathList != NULL);
+
+    List *const result = lstNewP(sizeof(StorageList *));
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Send the first request for each path before waiting on any responses so the requests are processed concurrently
+        List *const requestList = lstNewP(sizeof(HttpRequest *));
+
+        for (unsigned int pathIdx = 0; pathIdx < strLstSize(pathList); pathIdx++)
+        {
+            const String *const basePrefix = storageAzureListBasePrefix(strLstGet(pathList, pathIdx));
+            HttpRequest *const request = storageAzureRequestAsyncP(
+                this, HTTP_VERB_GET_STR, .query = storageAzureListQuery(basePrefix, param.expression, false));
+
+            lstAdd(requestList, &request);
+        }
+
+        // Get the responses (and any remaining requests) in the same order as the paths
+        for (unsigned int pathIdx = 0; pathIdx < strLstSize(pathList); pathIdx++)
+        {
+            StorageList *list;
+
+            MEM_CONTEXT_OBJ_BEGIN(result)
+            {
+                list = storageLstNew(level);
+            }
+            MEM_CONTEXT_OBJ_END();
+
+            storageAzureListInternal(
+                this, strLstGet(pathList, pathIdx), level, param.expression, false, *(HttpRequest **)lstGet(requestList, pathIdx),
+                storageAzureListCallback, list);
+
+            lstAdd(result, &list);
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(LIST, result);
+}
+
 /**********************************************************************************************************************************/
 static StorageRead *
 storageAzureNewRead(THIS_VOID, const String *file, bool ignoreMissing, StorageInterfaceNewReadParam param)
@@ -583,7 +763,7 @@ storageAzureNewWrite(THIS_VOID, const String *file, StorageInterfaceNewWritePara
     ASSERT(param.group == NULL);
     ASSERT(param.timeModified == 0);
 
-    FUNCTION_LOG_RETURN(STORAGE_WRITE, storageWriteAzureNew(this, file, this->fileId++, this->blockSize));
+    FUNCTION_LOG_RETURN(STORAGE_WRITE, storageWriteAzureNew(this, file, this->fileId++, this->blockSize, param.resume));
 }
 
 /**********************************************************************************************************************************/
@@ -591,7 +771,7 @@ typedef struct StorageAzurePathRemoveData
 {
     StorageAzure *this;                                             // Storage object
     MemContext *memContext;                                         // Mem context to create requests in
-    HttpRequest *request;                                           // Async remove request
+    List *requestList;                                              // Async remove requests in progress
     const String *path;                                             // Root path of remove
 } StorageAzurePathRemoveData;
 
@@ -608,21 +788,25 @@ storageAzurePathRemoveCallback(void *const callbackData, const StorageInfo *cons
 
     StorageAzurePathRemoveData *const data = callbackData;
 
-    // Get response from prior async request
-    if (data->request != NULL)
-    {
-        httpResponseFree(storageAzureResponseP(data->request, .allowMissing = true));
-        httpRequestFree(data->request);
-        data->request = NULL;
-    }
-
     // Only delete files since paths don't really exist
     if (info->type == storageTypeFile)
     {
+        // Get the response from the oldest async request when the maximum number of requests are in progress
+        if (lstSize(data->requestList) == data->this->deleteAsyncMax)
+        {
+            HttpRequest *const request = *(HttpRequest **)lstGet(data->requestList, 0);
+
+            httpResponseFree(storageAzureResponseP(request, .allowMissing = true));
+            httpRequestFree(request);
+            lstRemoveIdx(data->requestList, 0);
+        }
+
         MEM_CONTEXT_BEGIN(data->memContext)
         {
-            data->request = storageAzureRequestAsyncP(
+            HttpRequest *const request = storageAzureRequestAsyncP(
                 data->this, HTTP_VERB_DELETE_STR, strNewFmt("%s/%s", strZ(data->path), strZ(info->name)));
+
+            lstAdd(data->requestList, &request);
         }
         MEM_CONTEXT_END();
     }
@@ -651,14 +835,15 @@ storageAzurePathRemove(THIS_VOID, const String *path, bool recurse, StorageInter
         {
             .this = this,
             .memContext = memContextCurrent(),
+            .requestList = lstNewP(sizeof(HttpRequest *)),
             .path = strEq(path, FSLASH_STR) ? EMPTY_STR : path,
         };
 
-        storageAzureListInternal(this, path, storageInfoLevelType, NULL, true, storageAzurePathRemoveCallback, &data);
+        storageAzureListInternal(this, path, storageInfoLevelType, NULL, true, NULL, storageAzurePathRemoveCallback, &data);
 
-        // Check response on last async request
-        if (data.request != NULL)
-            storageAzureResponseP(data.request, .allowMissing = true);
+        // Check responses on async requests still in progress
+        for (unsigned int requestIdx = 0; requestIdx < lstSize(data.requestList); requestIdx++)
+            storageAzureResponseP(*(HttpRequest **)lstGet(data.requestList, requestIdx), .allowMissing = true);
     }
     MEM_CONTEXT_TEMP_END();
 
@@ -689,8 +874,10 @@ storageAzureRemove(THIS_VOID, const String *file, StorageInterfaceRemoveParam pa
 /**********************************************************************************************************************************/
 static const StorageInterface storageInterfaceAzure =
 {
+    .copy = storageAzureCopy,
     .info = storageAzureInfo,
     .list = storageAzureList,
+    .listMulti = storageAzureListMulti,
     .newRead = storageAzureNewRead,
     .newWrite = storageAzureNewWrite,
     .pathRemove = storageAzurePathRemove,
@@ -741,7 +928,9 @@ storageAzureNew(
             .container = strDup(container),
             .account = strDup(account),
             .blockSize = blockSize,
+            .deleteAsyncMax = STORAGE_AZURE_DELETE_ASYNC_MAX,
             .host = uriStyle == storageAzureUriStyleHost ? strNewFmt("%s.%s", strZ(account), strZ(endpoint)) : strDup(endpoint),
+            .port = port,
             .pathPrefix = uriStyle == storageAzureUriStyleHost ?
                 strNewFmt("/%s", strZ(container)) : strNewFmt("/%s/%s", strZ(account), strZ(container)),
         };
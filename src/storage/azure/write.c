@@ -45,6 +45,8 @@ typedef struct StorageWriteAzure
     size_t blockSize;                                               // Size of blocks for multi-block upload
     Buffer *blockBuffer;                                            // Block buffer (stores data until blockSize is reached)
     StringList *blockIdList;                                        // List of uploaded block ids
+    uint64_t size;                                                  // Bytes written to the block buffer or uploaded
+    uint64_t skip;                                                  // Bytes left to skip because they have already been uploaded
 } StorageWriteAzure;
 
 /***********************************************************************************************************************************
@@ -174,14 +176,22 @@ storageWriteAzure(THIS_VOID, const Buffer *buffer)
 
     size_t bytesTotal = 0;
 
+    // Skip data that has already been uploaded when resuming
+    if (this->skip > 0)
+    {
+        bytesTotal = this->skip < bufUsed(buffer) ? (size_t)this->skip : bufUsed(buffer);
+        this->skip -= bytesTotal;
+    }
+
     // Continue until the write buffer has been exhausted
-    do
+    while (bytesTotal != bufUsed(buffer))
     {
         // Copy as many bytes as possible into the block buffer
         size_t bytesNext = bufRemains(this->blockBuffer) > bufUsed(buffer) - bytesTotal ?
             bufUsed(buffer) - bytesTotal : bufRemains(this->blockBuffer);
         bufCatSub(this->blockBuffer, buffer, bytesTotal, bytesNext);
         bytesTotal += bytesNext;
+        this->size += bytesNext;
 
         // If the block buffer is full then write it
         if (bufRemains(this->blockBuffer) == 0)
@@ -190,11 +200,54 @@ storageWriteAzure(THIS_VOID, const Buffer *buffer)
             bufUsedZero(this->blockBuffer);
         }
     }
-    while (bytesTotal != bufUsed(buffer));
 
     FUNCTION_LOG_RETURN_VOID();
 }
 
+/***********************************************************************************************************************************
+Upload the block buffer and return the block list so the file can be resumed
+***********************************************************************************************************************************/
+static Pack *
+storageWriteAzureCheckpoint(THIS_VOID)
+{
+    THIS(StorageWriteAzure);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_WRITE_AZURE, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->blockBuffer != NULL);
+    ASSERT(this->skip == 0);
+
+    Pack *result = NULL;
+
+    // Blocks may be any size so upload what is in the block buffer
+    if (!bufEmpty(this->blockBuffer))
+    {
+        storageWriteAzureBlockAsync(this);
+        bufUsedZero(this->blockBuffer);
+    }
+
+    // Wait for the last block to be uploaded
+    storageWriteAzureBlock(this);
+
+    // The file id and block list are required to resume the upload
+    if (this->blockIdList != NULL)
+    {
+        PackWrite *const pack = pckWriteNewP();
+
+        pckWriteU64P(pack, this->fileId);
+        pckWriteStrLstP(pack, this->blockIdList);
+        pckWriteU64P(pack, this->size);
+        pckWriteEndP(pack);
+
+        result = pckWriteResult(pack);
+    }
+
+    FUNCTION_LOG_RETURN(PACK, result);
+}
+
 /***********************************************************************************************************************************
 Close the file
 ***********************************************************************************************************************************/
@@ -260,13 +313,15 @@ storageWriteAzureClose(THIS_VOID)
 
 /**********************************************************************************************************************************/
 StorageWrite *
-storageWriteAzureNew(StorageAzure *storage, const String *name, uint64_t fileId, size_t blockSize)
+storageWriteAzureNew(
+    StorageAzure *const storage, const String *const name, const uint64_t fileId, const size_t blockSize, const Pack *const resume)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(STORAGE_AZURE, storage);
         FUNCTION_LOG_PARAM(STRING, name);
         FUNCTION_LOG_PARAM(UINT64, fileId);
         FUNCTION_LOG_PARAM(UINT64, blockSize);
+        FUNCTION_LOG_PARAM(PACK, resume);
     FUNCTION_LOG_END();
 
     ASSERT(storage != NULL);
@@ -299,9 +354,25 @@ storageWriteAzureNew(StorageAzure *storage, const String *name, uint64_t fileId,
                     .open = storageWriteAzureOpen,
                     .write = storageWriteAzure,
                 },
+
+                // No abort is required since uncommitted blocks are discarded by Azure when a block list is committed for the file
+                // or after a week
+                .checkpoint = storageWriteAzureCheckpoint,
             },
         };
 
+        // Continue the multi-block upload from the checkpoint. The file id of the prior upload is used so new block ids have the
+        // same format as the block ids already uploaded.
+        if (resume != NULL)
+        {
+            PackRead *const read = pckReadNew(resume);
+
+            driver->fileId = pckReadU64P(read);
+            driver->blockIdList = pckReadStrLstP(read);
+            driver->size = pckReadU64P(read);
+            driver->skip = driver->size;
+        }
+
         this = storageWriteNew(driver, &driver->interface);
     }
     OBJ_NEW_END();
@@ -10,6 +10,7 @@ Azure Storage File Write
 /***********************************************************************************************************************************
 Constructors
 ***********************************************************************************************************************************/
-StorageWrite *storageWriteAzureNew(StorageAzure *storage, const String *name, uint64_t fileId, size_t blockSize);
+StorageWrite *storageWriteAzureNew(
+    StorageAzure *storage, const String *name, uint64_t fileId, size_t blockSize, const Pack *resume);
 
 #endif
@@ -26,6 +26,13 @@ GCS Storage
 #include "storage/gcs/write.h"
 #include "storage/posix/storage.h"
 
+/***********************************************************************************************************************************
+Defaults
+***********************************************************************************************************************************/
+#define STORAGE_GCS_DELETE_ASYNC_MAX                                16
+#define STORAGE_GCS_LIST_RANGE_MAX                                  8
+#define STORAGE_GCS_LIST_RANGE_NAME_MIN                             100
+
 /***********************************************************************************************************************************
 HTTP headers
 ***********************************************************************************************************************************/
@@ -42,6 +49,8 @@ STRING_EXTERN(GCS_QUERY_MEDIA_STR,                                  GCS_QUERY_ME
 STRING_EXTERN(GCS_QUERY_NAME_STR,                                   GCS_QUERY_NAME);
 STRING_STATIC(GCS_QUERY_PAGE_TOKEN_STR,                             "pageToken");
 STRING_STATIC(GCS_QUERY_PREFIX_STR,                                 "prefix");
+STRING_STATIC(GCS_QUERY_REWRITE_TOKEN_STR,                          "rewriteToken");
+STRING_STATIC(GCS_QUERY_START_OFFSET_STR,                           "startOffset");
 STRING_EXTERN(GCS_QUERY_UPLOAD_ID_STR,                              GCS_QUERY_UPLOAD_ID);
 
 /***********************************************************************************************************************************
@@ -49,6 +58,8 @@ JSON tokens
 ***********************************************************************************************************************************/
 VARIANT_STRDEF_STATIC(GCS_JSON_ACCESS_TOKEN_VAR,                    "access_token");
 VARIANT_STRDEF_STATIC(GCS_JSON_CLIENT_EMAIL_VAR,                    "client_email");
+#define GCS_JSON_DONE                                               "done"
+    VARIANT_STRDEF_STATIC(GCS_JSON_DONE_VAR,                        GCS_JSON_DONE);
 VARIANT_STRDEF_STATIC(GCS_JSON_ERROR_VAR,                           "error");
 VARIANT_STRDEF_STATIC(GCS_JSON_ERROR_DESCRIPTION_VAR,               "error_description");
 VARIANT_STRDEF_STATIC(GCS_JSON_EXPIRES_IN_VAR,                      "expires_in");
@@ -61,6 +72,8 @@ VARIANT_STRDEF_EXTERN(GCS_JSON_NAME_VAR,                            GCS_JSON_NAM
 #define GCS_JSON_PREFIXES                                           "prefixes"
     VARIANT_STRDEF_STATIC(GCS_JSON_PREFIXES_VAR,                    GCS_JSON_PREFIXES);
 VARIANT_STRDEF_STATIC(GCS_JSON_PRIVATE_KEY_VAR,                     "private_key");
+#define GCS_JSON_REWRITE_TOKEN                                      "rewriteToken"
+    VARIANT_STRDEF_STATIC(GCS_JSON_REWRITE_TOKEN_VAR,               GCS_JSON_REWRITE_TOKEN);
 VARIANT_STRDEF_EXTERN(GCS_JSON_SIZE_VAR,                            GCS_JSON_SIZE);
 VARIANT_STRDEF_STATIC(GCS_JSON_TOKEN_TYPE_VAR,                      "token_type");
 VARIANT_STRDEF_STATIC(GCS_JSON_TOKEN_URI_VAR,                       "token_uri");
@@ -88,6 +101,7 @@ struct StorageGcs
     const String *bucket;                                           // Bucket to store data in
     const String *endpoint;                                         // Endpoint
     size_t chunkSize;                                               // Block size for resumable upload
+    unsigned int deleteAsyncMax;                                    // Maximum delete requests in progress at once
 
     StorageGcsKeyType keyType;                                      // Auth key type
     const String *credential;                                       // Credential (client email)
@@ -379,7 +393,9 @@ storageGcsRequestAsync(StorageGcs *this, const String *verb, StorageGcsRequestAs
         FUNCTION_LOG_PARAM(BOOL, param.noBucket);
         FUNCTION_LOG_PARAM(BOOL, param.upload);
         FUNCTION_LOG_PARAM(BOOL, param.noAuth);
+        FUNCTION_LOG_PARAM(STRING, param.bucket);
         FUNCTION_LOG_PARAM(STRING, param.object);
+        FUNCTION_LOG_PARAM(STRING, param.rewriteTo);
         FUNCTION_LOG_PARAM(HTTP_HEADER, param.header);
         FUNCTION_LOG_PARAM(HTTP_QUERY, param.query);
         FUNCTION_LOG_PARAM(BUFFER, param.content);
@@ -387,7 +403,8 @@ storageGcsRequestAsync(StorageGcs *this, const String *verb, StorageGcsRequestAs
 
     ASSERT(this != NULL);
     ASSERT(verb != NULL);
-    ASSERT(!param.noBucket || param.object == NULL);
+    ASSERT(!param.noBucket || (param.bucket == NULL && param.object == NULL));
+    ASSERT(param.rewriteTo == NULL || param.object != NULL);
 
     HttpRequest *result = NULL;
 
@@ -397,11 +414,14 @@ storageGcsRequestAsync(StorageGcs *this, const String *verb, StorageGcsRequestAs
         String *path = strCatFmt(strNew(), "%s/storage/v1/b", param.upload ? "/upload" : "");
 
         if (!param.noBucket)
-            strCatFmt(path, "/%s/o", strZ(this->bucket));
+            strCatFmt(path, "/%s/o", strZ(param.bucket != NULL ? param.bucket : this->bucket));
 
         if (param.object != NULL)
             strCatFmt(path, "/%s", strZ(httpUriEncode(strSub(param.object, 1), false)));
 
+        if (param.rewriteTo != NULL)
+            strCatFmt(path, "/rewriteTo/b/%s/o/%s", strZ(this->bucket), strZ(httpUriEncode(strSub(param.rewriteTo, 1), false)));
+
         // Create header list and add content length
         HttpHeader *requestHeader = param.header == NULL ?
             httpHeaderNew(this->headerRedactList) : httpHeaderDup(param.header, this->headerRedactList);
@@ -476,7 +496,9 @@ storageGcsRequest(StorageGcs *const this, const String *const verb, const Storag
         FUNCTION_LOG_PARAM(BOOL, param.noBucket);
         FUNCTION_LOG_PARAM(BOOL, param.upload);
         FUNCTION_LOG_PARAM(BOOL, param.noAuth);
+        FUNCTION_LOG_PARAM(STRING, param.bucket);
         FUNCTION_LOG_PARAM(STRING, param.object);
+        FUNCTION_LOG_PARAM(STRING, param.rewriteTo);
         FUNCTION_LOG_PARAM(HTTP_HEADER, param.header);
         FUNCTION_LOG_PARAM(HTTP_QUERY, param.query);
         FUNCTION_LOG_PARAM(BUFFER, param.content);
@@ -486,8 +508,9 @@ storageGcsRequest(StorageGcs *const this, const String *const verb, const Storag
     FUNCTION_LOG_END();
 
     HttpRequest *const request = storageGcsRequestAsyncP(
-        this, verb, .noBucket = param.noBucket, .upload = param.upload, .noAuth = param.noAuth, .object = param.object,
-        .header = param.header, .query = param.query, .content = param.content);
+        this, verb, .noBucket = param.noBucket, .upload = param.upload, .noAuth = param.noAuth, .bucket = param.bucket,
+        .object = param.object, .rewriteTo = param.rewriteTo, .header = param.header, .query = param.query,
+        .content = param.content);
     HttpResponse *const result = storageGcsResponseP(
         request, .allowMissing = param.allowMissing, .allowIncomplete = param.allowIncomplete, .contentIo = param.contentIo);
 
@@ -529,34 +552,45 @@ storageGcsInfoFile(StorageInfo *info, const KeyValue *file)
     FUNCTION_TEST_RETURN_VOID();
 }
 
-static void
-storageGcsListInternal(
-    StorageGcs *this, const String *path, StorageInfoLevel level, const String *expression, bool recurse,
-    StorageListCallback callback, void *callbackData)
+// Build the base prefix by stripping off the initial /
+static const String *
+storageGcsListBasePrefix(const String *const path)
 {
-    FUNCTION_LOG_BEGIN(logLevelDebug);
-        FUNCTION_LOG_PARAM(STORAGE_GCS, this);
-        FUNCTION_LOG_PARAM(STRING, path);
-        FUNCTION_LOG_PARAM(ENUM, level);
-        FUNCTION_LOG_PARAM(STRING, expression);
-        FUNCTION_LOG_PARAM(BOOL, recurse);
-        FUNCTION_LOG_PARAM(FUNCTIONP, callback);
-        FUNCTION_LOG_PARAM_P(VOID, callbackData);
-    FUNCTION_LOG_END();
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, path);
+    FUNCTION_TEST_END();
 
-    ASSERT(this != NULL);
     ASSERT(path != NULL);
 
-    MEM_CONTEXT_TEMP_BEGIN()
-    {
-        // Build the base prefix by stripping off the initial /
-        const String *basePrefix;
+    const String *result;
 
-        if (strSize(path) == 1)
-            basePrefix = EMPTY_STR;
-        else
-            basePrefix = strNewFmt("%s/", strZ(strSub(path, 1)));
+    if (strSize(path) == 1)
+        result = EMPTY_STR;
+    else
+        result = strNewFmt("%s/", strZ(strSub(path, 1)));
+
+    FUNCTION_TEST_RETURN_CONST(STRING, result);
+}
 
+// Build the query used to list a path. This is separate from storageGcsListInternal() so storageGcsListMulti() can send the first
+// request for each path before any responses are processed.
+static HttpQuery *
+storageGcsListQuery(
+    const String *const basePrefix, const StorageInfoLevel level, const String *const expression, const bool recurse)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, basePrefix);
+        FUNCTION_TEST_PARAM(ENUM, level);
+        FUNCTION_TEST_PARAM(STRING, expression);
+        FUNCTION_TEST_PARAM(BOOL, recurse);
+    FUNCTION_TEST_END();
+
+    ASSERT(basePrefix != NULL);
+
+    HttpQuery *const result = httpQueryNewP();
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
         // Get the expression prefix when possible to limit initial results
         const String *expressionPrefix = regExpPrefix(expression);
 
@@ -573,132 +607,357 @@ storageGcsListInternal(
                 queryPrefix = strNewFmt("%s%s", strZ(basePrefix), strZ(expressionPrefix));
         }
 
-        // Create query
-        HttpQuery *query = httpQueryNewP();
-
         // Add the delimiter to not recurse
         if (!recurse)
-            httpQueryAdd(query, GCS_QUERY_DELIMITER_STR, FSLASH_STR);
+            httpQueryAdd(result, GCS_QUERY_DELIMITER_STR, FSLASH_STR);
 
         // Don't specify empty prefix because it is the default
         if (!strEmpty(queryPrefix))
-            httpQueryAdd(query, GCS_QUERY_PREFIX_STR, queryPrefix);
+            httpQueryAdd(result, GCS_QUERY_PREFIX_STR, queryPrefix);
 
         // Add fields to limit the amount of data returned
-        httpQueryAdd(query, GCS_QUERY_FIELDS_STR, level >= storageInfoLevelBasic ? GCS_FIELD_LIST_MAX_STR : GCS_FIELD_LIST_MIN_STR);
+        httpQueryAdd(
+            result, GCS_QUERY_FIELDS_STR, level >= storageInfoLevelBasic ? GCS_FIELD_LIST_MAX_STR : GCS_FIELD_LIST_MIN_STR);
+    }
+    MEM_CONTEXT_TEMP_END();
 
-        // Loop as long as a continuation marker returned
-        HttpRequest *request = NULL;
+    FUNCTION_TEST_RETURN(HTTP_QUERY, result);
+}
 
-        do
+// Range of names to list. When the first page of a list is truncated the rest of the list is split into ranges that are listed
+// concurrently.
+typedef struct StorageGcsListRange
+{
+    const String *startAfter;                                       // List names after this name (NULL to start at the beginning)
+    const String *stopAfter;                                        // Stop listing after this name (NULL to list to the end)
+    HttpRequest *request;                                           // Request that has already been sent for the range
+} StorageGcsListRange;
+
+// Build the query used to list a range. GCS includes the start offset in the results so names equal to startAfter must be skipped.
+static HttpQuery *
+storageGcsListRangeQuery(
+    const String *const basePrefix, const StorageInfoLevel level, const String *const expression, const bool recurse,
+    const String *const startAfter)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, basePrefix);
+        FUNCTION_TEST_PARAM(ENUM, level);
+        FUNCTION_TEST_PARAM(STRING, expression);
+        FUNCTION_TEST_PARAM(BOOL, recurse);
+        FUNCTION_TEST_PARAM(STRING, startAfter);
+    FUNCTION_TEST_END();
+
+    HttpQuery *const result = storageGcsListQuery(basePrefix, level, expression, recurse);
+
+    if (startAfter != NULL)
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
         {
-            // Use an inner mem context here because we could potentially be retrieving millions of files so it is a good idea to
-            // free memory at regular intervals
-            MEM_CONTEXT_TEMP_BEGIN()
-            {
-                HttpResponse *response = NULL;
+            httpQueryAdd(result, GCS_QUERY_START_OFFSET_STR, strNewFmt("%s%s", strZ(basePrefix), strZ(startAfter)));
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
 
-                // If there is an outstanding async request then wait for the response
-                if (request != NULL)
-                {
-                    response = storageGcsResponseP(request);
+    FUNCTION_TEST_RETURN(HTTP_QUERY, result);
+}
 
-                    httpRequestFree(request);
-                    request = NULL;
-                }
-                // Else get the response immediately from a sync request
-                else
-                    response = storageGcsRequestP(this, HTTP_VERB_GET_STR, .query = query);
+// Is the name (relative to the base prefix) in the range?
+static bool
+storageGcsListRangeMember(const StorageGcsListRange *const range, const String *const name)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, range);
+        FUNCTION_TEST_PARAM(STRING, name);
+    FUNCTION_TEST_END();
+
+    FUNCTION_TEST_RETURN(
+        BOOL,
+        (range->startAfter == NULL || strCmp(name, range->startAfter) > 0) &&
+        (range->stopAfter == NULL || strCmp(name, range->stopAfter) <= 0));
+}
+
+static void
+storageGcsListInternal(
+    StorageGcs *this, const String *path, StorageInfoLevel level, const String *expression, bool recurse, HttpRequest *request,
+    StorageListCallback callback, void *callbackData)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE_GCS, this);
+        FUNCTION_LOG_PARAM(STRING, path);
+        FUNCTION_LOG_PARAM(ENUM, level);
+        FUNCTION_LOG_PARAM(STRING, expression);
+        FUNCTION_LOG_PARAM(BOOL, recurse);
+        FUNCTION_LOG_PARAM(HTTP_REQUEST, request);
+        FUNCTION_LOG_PARAM(FUNCTIONP, callback);
+        FUNCTION_LOG_PARAM_P(VOID, callbackData);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(path != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Build the base prefix
+        const String *const basePrefix = storageGcsListBasePrefix(path);
+
+        // Start with a single range for the entire list. The first request may have already been sent by the caller.
+        List *const rangeList = lstNewP(sizeof(StorageGcsListRange));
+        lstAdd(rangeList, &(StorageGcsListRange){.request = request});
 
-                KeyValue *content = varKv(jsonToVar(strNewBuf(httpResponseContent(response))));
+        for (unsigned int rangeIdx = 0; rangeIdx < lstSize(rangeList); rangeIdx++)
+        {
+            StorageGcsListRange range = *(StorageGcsListRange *)lstGet(rangeList, rangeIdx);
+            HttpQuery *const query = storageGcsListRangeQuery(basePrefix, level, expression, recurse, range.startAfter);
 
-                // If next page token exists then send an async request to get more data
-                const String *nextPageToken = varStr(kvGet(content, GCS_JSON_NEXT_PAGE_TOKEN_VAR));
+            request = range.request;
 
-                if (nextPageToken != NULL)
+            // Loop as long as a continuation marker returned
+            do
+            {
+                // Use an inner mem context here because we could potentially be retrieving millions of files so it is a good idea
+                // to free memory at regular intervals
+                MEM_CONTEXT_TEMP_BEGIN()
                 {
-                    httpQueryPut(query, GCS_QUERY_PAGE_TOKEN_STR, nextPageToken);
+                    HttpResponse *response = NULL;
 
-                    // Store request in the outer temp context
-                    MEM_CONTEXT_PRIOR_BEGIN()
+                    // If there is an outstanding async request then wait for the response
+                    if (request != NULL)
                     {
-                        request = storageGcsRequestAsyncP(this, HTTP_VERB_GET_STR, .query = query);
+                        response = storageGcsResponseP(request);
+
+                        httpRequestFree(request);
+                        request = NULL;
                     }
-                    MEM_CONTEXT_PRIOR_END();
-                }
+                    // Else get the response immediately from a sync request
+                    else
+                        response = storageGcsRequestP(this, HTTP_VERB_GET_STR, .query = query);
 
-                // Get prefix list
-                const VariantList *prefixList = varVarLst(kvGet(content, GCS_JSON_PREFIXES_VAR));
+                    KeyValue *content = varKv(jsonToVar(strNewBuf(httpResponseContent(response))));
+                    const VariantList *prefixList = varVarLst(kvGet(content, GCS_JSON_PREFIXES_VAR));
+                    const VariantList *fileList = varVarLst(kvGet(content, GCS_JSON_ITEMS_VAR));
 
-                if (prefixList != NULL)
-                {
-                    for (unsigned int prefixIdx = 0; prefixIdx < varLstSize(prefixList); prefixIdx++)
+                    // If next page token exists then send an async request to get more data
+                    const String *nextPageToken = varStr(kvGet(content, GCS_JSON_NEXT_PAGE_TOKEN_VAR));
+
+                    if (nextPageToken != NULL)
                     {
-                        // Get path name
-                        StorageInfo info =
+                        // Get the first and last names in the page. Names are compared with the final / on paths, which is the
+                        // same order used by GCS.
+                        const String *first = NULL;
+                        const String *last = NULL;
+                        const unsigned int prefixTotal = prefixList == NULL ? 0 : varLstSize(prefixList);
+                        const unsigned int fileTotal = fileList == NULL ? 0 : varLstSize(fileList);
+
+                        if (prefixTotal > 0)
                         {
-                            .level = level,
-                            .name = varStr(varLstGet(prefixList, prefixIdx)),
-                            .exists = true,
-                        };
-
-                        // Strip off base prefix and final /
-                        info.name = strSubN(info.name, strSize(basePrefix), strSize(info.name) - strSize(basePrefix) - 1);
-
-                        // Add type info if requested
-                        if (level >= storageInfoLevelType)
-                            info.type = storageTypePath;
+                            first = varStr(varLstGet(prefixList, 0));
+                            last = varStr(varLstGet(prefixList, prefixTotal - 1));
+                        }
 
-                        // Callback with info
-                        callback(callbackData, &info);
-                    }
-                }
+                        if (fileTotal > 0)
+                        {
+                            const String *const fileFirst = varStr(kvGet(varKv(varLstGet(fileList, 0)), GCS_JSON_NAME_VAR));
+                            const String *const fileLast = varStr(
+                                kvGet(varKv(varLstGet(fileList, fileTotal - 1)), GCS_JSON_NAME_VAR));
+                            CHECK(FormatError, fileFirst != NULL && fileLast != NULL, "file name missing");
 
-                // Get file list
-                const VariantList *fileList = varVarLst(kvGet(content, GCS_JSON_ITEMS_VAR));
+                            if (first == NULL || strCmp(fileFirst, first) < 0)
+                                first = fileFirst;
 
-                if (fileList != NULL)
-                {
-                    for (unsigned int fileIdx = 0; fileIdx < varLstSize(fileList); fileIdx++)
-                    {
-                        const KeyValue *file = varKv(varLstGet(fileList, fileIdx));
-                        CHECK(FormatError, file != NULL, "file missing");
+                            if (last == NULL || strCmp(fileLast, last) > 0)
+                                last = fileLast;
+                        }
 
-                        // Get file name
-                        StorageInfo info =
+                        if (last != NULL)
                         {
-                            .level = level,
-                            .name = varStr(kvGet(file, GCS_JSON_NAME_VAR)),
-                            .exists = true,
-                        };
+                            first = strSub(first, strSize(basePrefix));
+                            last = strSub(last, strSize(basePrefix));
+                        }
 
-                        CHECK(FormatError, info.name != NULL, "file name missing");
+                        // If this is a large first page then split the rest of the list into ranges and send a request for each
+                        // range. The current range continues up to the first boundary. Small pages are not split since the list
+                        // is likely to be short.
+                        if (rangeIdx == 0 && lstSize(rangeList) == 1 && prefixTotal + fileTotal >= STORAGE_GCS_LIST_RANGE_NAME_MIN)
+                        {
+                            const StringList *const boundaryList = storageListSplit(first, last, STORAGE_GCS_LIST_RANGE_MAX);
+
+                            MEM_CONTEXT_OBJ_BEGIN(rangeList)
+                            {
+                                for (unsigned int boundaryIdx = 0; boundaryIdx < strLstSize(boundaryList); boundaryIdx++)
+                                {
+                                    StorageGcsListRange rangeNext =
+                                    {
+                                        .startAfter = strDup(strLstGet(boundaryList, boundaryIdx)),
+                                        .stopAfter =
+                                            boundaryIdx + 1 < strLstSize(boundaryList) ?
+                                                strDup(strLstGet(boundaryList, boundaryIdx + 1)) : NULL,
+                                    };
+
+                                    rangeNext.request = storageGcsRequestAsyncP(
+                                        this, HTTP_VERB_GET_STR,
+                                        .query = storageGcsListRangeQuery(
+                                            basePrefix, level, expression, recurse, rangeNext.startAfter));
+
+                                    lstAdd(rangeList, &rangeNext);
+                                }
+
+                                if (!strLstEmpty(boundaryList))
+                                    range.stopAfter = strDup(strLstGet(boundaryList, 0));
+                            }
+                            MEM_CONTEXT_OBJ_END();
+                        }
 
-                        // Strip off the base prefix when present
-                        if (!strEmpty(basePrefix))
-                            info.name = strSub(info.name, strSize(basePrefix));
+                        // Get more data unless the range is complete
+                        if (range.stopAfter == NULL || last == NULL || strCmp(last, range.stopAfter) < 0)
+                        {
+                            httpQueryPut(query, GCS_QUERY_PAGE_TOKEN_STR, nextPageToken);
+
+                            // Store request in the outer temp context
+                            MEM_CONTEXT_PRIOR_BEGIN()
+                            {
+                                request = storageGcsRequestAsyncP(this, HTTP_VERB_GET_STR, .query = query);
+                            }
+                            MEM_CONTEXT_PRIOR_END();
+                        }
+                    }
 
-                        // Add basic level info if requested
-                        if (level >= storageInfoLevelBasic)
+                    // Get prefix list
+                    if (prefixList != NULL)
+                    {
+                        for (unsigned int prefixIdx = 0; prefixIdx < varLstSize(prefixList); prefixIdx++)
                         {
-                            info.type = storageTypeFile;
-                            storageGcsInfoFile(&info, file);
+                            // Get path name
+                            StorageInfo info =
+                            {
+                                .level = level,
+                                .name = varStr(varLstGet(prefixList, prefixIdx)),
+                                .exists = true,
+                            };
+
+                            // Skip names that are not in the range
+                            if (!storageGcsListRangeMember(&range, strSub(info.name, strSize(basePrefix))))
+                                continue;
+
+                            // Strip off base prefix and final /
+                            info.name = strSubN(info.name, strSize(basePrefix), strSize(info.name) - strSize(basePrefix) - 1);
+
+                            // Add type info if requested
+                            if (level >= storageInfoLevelType)
+                                info.type = storageTypePath;
+
+                            // Callback with info
+                            callback(callbackData, &info);
                         }
+                    }
 
-                        // Callback with info
-                        callback(callbackData, &info);
+                    // Get file list
+                    if (fileList != NULL)
+                    {
+                        for (unsigned int fileIdx = 0; fileIdx < varLstSize(fileList); fileIdx++)
+                        {
+                            const KeyValue *file = varKv(varLstGet(fileList, fileIdx));
+                            CHECK(FormatError, file != NULL, "file missing");
+
+                            // Get file name
+                            StorageInfo info =
+                            {
+                                .level = level,
+                                .name = varStr(kvGet(file, GCS_JSON_NAME_VAR)),
+                                .exists = true,
+                            };
+
+                            CHECK(FormatError, info.name != NULL, "file name missing");
+
+                            // Strip off the base prefix when present
+                            if (!strEmpty(basePrefix))
+                                info.name = strSub(info.name, strSize(basePrefix));
+
+                            // Skip names that are not in the range
+                            if (!storageGcsListRangeMember(&range, info.name))
+                                continue;
+
+                            // Add basic level info if requested
+                            if (level >= storageInfoLevelBasic)
+                            {
+                                info.type = storageTypeFile;
+                                storageGcsInfoFile(&info, file);
+                            }
+
+                            // Callback with info
+                            callback(callbackData, &info);
+                        }
                     }
                 }
+                MEM_CONTEXT_TEMP_END();
             }
-            MEM_CONTEXT_TEMP_END();
+            while (request != NULL);
         }
-        while (request != NULL);
     }
     MEM_CONTEXT_TEMP_END();
 
     FUNCTION_LOG_RETURN_VOID();
 }
 
+/**********************************************************************************************************************************/
+static bool
+storageGcsCopy(
+    THIS_VOID, const void *const sourceDriver, const String *const source, const String *const destination,
+    const StorageInterfaceCopyParam param)
+{
+    THIS(StorageGcs);
+
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE_GCS, this);
+        FUNCTION_LOG_PARAM_P(VOID, sourceDriver);
+        FUNCTION_LOG_PARAM(STRING, source);
+        FUNCTION_LOG_PARAM(STRING, destination);
+        (void)param;                                                // No parameters are used
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(sourceDriver != NULL);
+    ASSERT(source != NULL);
+    ASSERT(destination != NULL);
+
+    const StorageGcs *const sourceGcs = sourceDriver;
+
+    // The request is authorized with the credentials of this storage so the source must be readable with the same credentials.
+    // Automatic authentication uses the credentials of the instance so it is the same for all storages.
+    const bool result =
+        strEq(this->endpoint, sourceGcs->endpoint) && this->keyType == sourceGcs->keyType &&
+        strEq(this->credential, sourceGcs->credential) &&
+        (this->keyType != storageGcsKeyTypeToken || strEq(this->token, sourceGcs->token));
+
+    // Rewrite the object until done. Large objects or objects copied between locations or storage classes may require multiple
+    // requests, which are continued with the rewrite token from the prior request.
+    if (result)
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            HttpQuery *const query = httpQueryAdd(
+                httpQueryNewP(), GCS_QUERY_FIELDS_STR, STRDEF(GCS_JSON_DONE "," GCS_JSON_REWRITE_TOKEN));
+            bool done;
+
+            do
+            {
+                HttpResponse *const response = storageGcsRequestP(
+                    this, HTTP_VERB_POST_STR, .bucket = sourceGcs->bucket, .object = source, .rewriteTo = destination,
+                    .query = query);
+                const KeyValue *const content = varKv(jsonToVar(strNewBuf(httpResponseContent(response))));
+
+                done = varBool(kvGet(content, GCS_JSON_DONE_VAR));
+
+                if (!done)
+                    httpQueryPut(query, GCS_QUERY_REWRITE_TOKEN_STR, varStr(kvGet(content, GCS_JSON_REWRITE_TOKEN_VAR)));
+            }
+            while (!done);
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    FUNCTION_LOG_RETURN(BOOL, result);
+}
+
 /**********************************************************************************************************************************/
 static StorageInfo
 storageGcsInfo(THIS_VOID, const String *const file, const StorageInfoLevel level, const StorageInterfaceInfoParam param)
@@ -709,7 +968,7 @@ storageGcsInfo(THIS_VOID, const String *const file, const StorageInfoLevel level
         FUNCTION_LOG_PARAM(STORAGE_GCS, this);
         FUNCTION_LOG_PARAM(STRING, file);
         FUNCTION_LOG_PARAM(ENUM, level);
-        (void)param;                                                // No parameters are used
+        FUNCTION_LOG_PARAM(BOOL, param.checksum);
     FUNCTION_LOG_END();
 
     ASSERT(this != NULL);
@@ -719,21 +978,48 @@ storageGcsInfo(THIS_VOID, const String *const file, const StorageInfoLevel level
 
     MEM_CONTEXT_TEMP_BEGIN()
     {
+        // Build the field list
+        String *const fieldList = strNew();
+
+        if (level >= storageInfoLevelBasic)
+            strCatZ(fieldList, GCS_JSON_SIZE "," GCS_JSON_UPDATED);
+
+        if (param.checksum)
+            strCatFmt(fieldList, "%s" GCS_JSON_MD5_HASH, strEmpty(fieldList) ? "" : ",");
+
         // Attempt to get file info
         HttpResponse *const httpResponse = storageGcsRequestP(
             this, HTTP_VERB_GET_STR, .object = file, .allowMissing = true,
-            .query = httpQueryAdd(
-                httpQueryNewP(), GCS_QUERY_FIELDS_STR,
-                level >= storageInfoLevelBasic ? STRDEF(GCS_JSON_SIZE "," GCS_JSON_UPDATED) : EMPTY_STR));
+            .query = httpQueryAdd(httpQueryNewP(), GCS_QUERY_FIELDS_STR, fieldList));
 
         // Does the file exist?
         result.exists = httpResponseCodeOk(httpResponse);
 
-        // Add basic level info if requested and the file exists
-        if (result.level >= storageInfoLevelBasic && result.exists)
+        if (result.exists && !strEmpty(fieldList))
         {
-            result.type = storageTypeFile;
-            storageGcsInfoFile(&result, varKv(jsonToVar(strNewBuf(httpResponseContent(httpResponse)))));
+            const KeyValue *const content = varKv(jsonToVar(strNewBuf(httpResponseContent(httpResponse))));
+
+            // Add basic level info if requested
+            if (result.level >= storageInfoLevelBasic)
+            {
+                result.type = storageTypeFile;
+                storageGcsInfoFile(&result, content);
+            }
+
+            // Add checksum if requested. The MD5 hash is not available for composite objects.
+            if (param.checksum)
+            {
+                const String *const md5Hash = varStr(kvGet(content, GCS_JSON_MD5_HASH_VAR));
+
+                if (md5Hash != NULL)
+                {
+                    MEM_CONTEXT_PRIOR_BEGIN()
+                    {
+                        result.checksum = bufHex(bufNewDecode(encodeBase64, md5Hash));
+                    }
+                    MEM_CONTEXT_PRIOR_END();
+                }
+            }
         }
 
         httpResponseFree(httpResponse);
@@ -777,11 +1063,66 @@ storageGcsList(THIS_VOID, const String *const path, const StorageInfoLevel level
 
     StorageList *const result = storageLstNew(level);
 
-    storageGcsListInternal(this, path, level, param.expression, false, storageGcsListCallback, result);
+    storageGcsListInternal(this, path, level, param.expression, false, NULL, storageGcsListCallback, result);
 
     FUNCTION_LOG_RETURN(STORAGE_LIST, result);
 }
 
+static List *
+storageGcsListMulti(
+    THIS_VOID, const StringList *const pathList, const StorageInfoLevel level, const StorageInterfaceListParam param)
+{
+    THIS(StorageGcs);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_GCS, this);
+        FUNCTION_LOG_PARAM(STRING_LIST, pathList);
+        FUNCTION_LOG_PARAM(ENUM, level);
+        FUNCTION_LOG_PARAM(STRING, param.expression);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(pathList != NULL);
+
+    List *const result = lstNewP(sizeof(StorageList *));
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Send the first request for each path before waiting on any responses so the requests are processed concurrently
+        List *const requestList = lstNewP(sizeof(HttpRequest *));
+
+        for (unsigned int pathIdx = 0; pathIdx < strLstSize(pathList); pathIdx++)
+        {
+            const String *const basePrefix = storageGcsListBasePrefix(strLstGet(pathList, pathIdx));
+            HttpRequest *const request = storageGcsRequestAsyncP(
+                this, HTTP_VERB_GET_STR, .query = storageGcsListQuery(basePrefix, level, param.expression, false));
+
+            lstAdd(requestList, &request);
+        }
+
+        // Get the responses (and any remaining requests) in the same order as the paths
+        for (unsigned int pathIdx = 0; pathIdx < strLstSize(pathList); pathIdx++)
+        {
+            StorageList *list;
+
+            MEM_CONTEXT_OBJ_BEGIN(result)
+            {
+                list = storageLstNew(level);
+            }
+            MEM_CONTEXT_OBJ_END();
+
+            storageGcsListInternal(
+                this, strLstGet(pathList, pathIdx), level, param.expression, false, *(HttpRequest **)lstGet(requestList, pathIdx),
+                storageGcsListCallback, list);
+
+            lstAdd(result, &list);
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(LIST, result);
+}
+
 /**********************************************************************************************************************************/
 static StorageRead *
 storageGcsNewRead(THIS_VOID, const String *file, bool ignoreMissing, StorageInterfaceNewReadParam param)
@@ -821,7 +1162,7 @@ storageGcsNewWrite(THIS_VOID, const String *file, StorageInterfaceNewWriteParam
     ASSERT(param.group == NULL);
     ASSERT(param.timeModified == 0);
 
-    FUNCTION_LOG_RETURN(STORAGE_WRITE, storageWriteGcsNew(this, file, this->chunkSize));
+    FUNCTION_LOG_RETURN(STORAGE_WRITE, storageWriteGcsNew(this, file, this->chunkSize, param.resume));
 }
 
 /**********************************************************************************************************************************/
@@ -829,7 +1170,7 @@ typedef struct StorageGcsPathRemoveData
 {
     StorageGcs *this;                                               // Storage Object
     MemContext *memContext;                                         // Mem context to create requests in
-    HttpRequest *request;                                           // Async remove request
+    List *requestList;                                              // Async remove requests in progress
     const String *path;                                             // Root path of remove
 } StorageGcsPathRemoveData;
 
@@ -846,21 +1187,25 @@ storageGcsPathRemoveCallback(void *const callbackData, const StorageInfo *const
 
     StorageGcsPathRemoveData *const data = callbackData;
 
-    // Get response from prior async request
-    if (data->request != NULL)
-    {
-        httpResponseFree(storageGcsResponseP(data->request, .allowMissing = true));
-        httpRequestFree(data->request);
-        data->request = NULL;
-    }
-
     // Only delete files since paths don't really exist
     if (info->type == storageTypeFile)
     {
+        // Get the response from the oldest async request when the maximum number of requests are in progress
+        if (lstSize(data->requestList) == data->this->deleteAsyncMax)
+        {
+            HttpRequest *const request = *(HttpRequest **)lstGet(data->requestList, 0);
+
+            httpResponseFree(storageGcsResponseP(request, .allowMissing = true));
+            httpRequestFree(request);
+            lstRemoveIdx(data->requestList, 0);
+        }
+
         MEM_CONTEXT_BEGIN(data->memContext)
         {
-            data->request = storageGcsRequestAsyncP(
+            HttpRequest *const request = storageGcsRequestAsyncP(
                 data->this, HTTP_VERB_DELETE_STR, .object = strNewFmt("%s/%s", strZ(data->path), strZ(info->name)));
+
+            lstAdd(data->requestList, &request);
         }
         MEM_CONTEXT_END();
     }
@@ -889,14 +1234,15 @@ storageGcsPathRemove(THIS_VOID, const String *path, bool recurse, StorageInterfa
         {
             .this = this,
             .memContext = memContextCurrent(),
+            .requestList = lstNewP(sizeof(HttpRequest *)),
             .path = strEq(path, FSLASH_STR) ? EMPTY_STR : path,
         };
 
-        storageGcsListInternal(this, path, storageInfoLevelType, NULL, true, storageGcsPathRemoveCallback, &data);
+        storageGcsListInternal(this, path, storageInfoLevelType, NULL, true, NULL, storageGcsPathRemoveCallback, &data);
 
-        // Check response on last async request
-        if (data.request != NULL)
-            storageGcsResponseP(data.request, .allowMissing = true);
+        // Check responses on async requests still in progress
+        for (unsigned int requestIdx = 0; requestIdx < lstSize(data.requestList); requestIdx++)
+            storageGcsResponseP(*(HttpRequest **)lstGet(data.requestList, requestIdx), .allowMissing = true);
     }
     MEM_CONTEXT_TEMP_END();
 
@@ -927,8 +1273,10 @@ storageGcsRemove(THIS_VOID, const String *const file, const StorageInterfaceRemo
 /**********************************************************************************************************************************/
 static const StorageInterface storageInterfaceGcs =
 {
+    .copy = storageGcsCopy,
     .info = storageGcsInfo,
     .list = storageGcsList,
+    .listMulti = storageGcsListMulti,
     .newRead = storageGcsNewRead,
     .newWrite = storageGcsNewWrite,
     .pathRemove = storageGcsPathRemove,
@@ -974,6 +1322,7 @@ storageGcsNew(
             .bucket = strDup(bucket),
             .keyType = keyType,
             .chunkSize = chunkSize,
+            .deleteAsyncMax = STORAGE_GCS_DELETE_ASYNC_MAX,
         };
 
         // Handle auth key types
@@ -50,7 +50,9 @@ typedef struct StorageGcsRequestAsyncParam
     bool noBucket;                                                  // Exclude bucket from the URI?
     bool upload;                                                    // Is an object upload?
     bool noAuth;                                                    // Exclude authentication header?
+    const String *bucket;                                           // Bucket to include in URI instead of the storage bucket
     const String *object;                                           // Object to include in URI
+    const String *rewriteTo;                                        // Object in the storage bucket to rewrite the object to
     const HttpHeader *header;                                       // Request headers
     const HttpQuery *query;                                         // Query parameters
     const Buffer *content;                                          // Request content
@@ -81,7 +83,9 @@ typedef struct StorageGcsRequestParam
     bool noBucket;                                                  // Exclude bucket from the URI?
     bool upload;                                                    // Is an object upload?
     bool noAuth;                                                    // Exclude authentication header?
+    const String *bucket;                                           // Bucket to include in URI instead of the storage bucket
     const String *object;                                           // Object to include in URI
+    const String *rewriteTo;                                        // Object in the storage bucket to rewrite the object to
     const HttpHeader *header;                                       // Request headers
     const HttpQuery *query;                                         // Query parameters
     const Buffer *content;                                          // Request content
@@ -20,6 +20,16 @@ STRING_STATIC(GCS_QUERY_UPLOAD_TYPE_STR,                            "uploadType"
 STRING_STATIC(GCS_QUERY_RESUMABLE_STR,                              "resumable");
 STRING_STATIC(GCS_QUERY_FIELDS_VALUE_STR,                           GCS_JSON_MD5_HASH "," GCS_JSON_SIZE);
 
+/***********************************************************************************************************************************
+All chunks except the last must be a multiple of this size
+***********************************************************************************************************************************/
+#define STORAGE_GCS_CHUNK_ALIGN                                     ((size_t)256 * 1024)
+
+/***********************************************************************************************************************************
+Response code returned when a resumable upload is cancelled
+***********************************************************************************************************************************/
+#define STORAGE_GCS_RESPONSE_CODE_CANCELLED                         499
+
 /***********************************************************************************************************************************
 Object type
 ***********************************************************************************************************************************/
@@ -33,6 +43,7 @@ typedef struct StorageWriteGcs
     Buffer *chunkBuffer;                                            // Block buffer (stores data until chunkSize is reached)
     const String *uploadId;                                         // Id for resumable upload
     uint64_t uploadTotal;                                           // Total bytes uploaded
+    uint64_t skip;                                                  // Bytes left to skip because they have already been uploaded
     IoFilter *md5hash;                                              // MD5 hash of file
 } StorageWriteGcs;
 
@@ -161,6 +172,7 @@ storageWriteGcsBlockAsync(StorageWriteGcs *this, bool done)
     ASSERT(this->chunkBuffer != NULL);
     ASSERT(bufSize(this->chunkBuffer) > 0);
     ASSERT(!done || this->uploadId != NULL);
+    ASSERT(done || !bufEmpty(this->chunkBuffer));
 
     MEM_CONTEXT_TEMP_BEGIN()
     {
@@ -186,16 +198,20 @@ storageWriteGcsBlockAsync(StorageWriteGcs *this, bool done)
         }
 
         // Add data to md5 hash
-        ioFilterProcessIn(this->md5hash, this->chunkBuffer);
+        if (!bufEmpty(this->chunkBuffer))
+            ioFilterProcessIn(this->md5hash, this->chunkBuffer);
 
         // Upload the chunk. If this is the last chunk then add the total bytes in the file to the range rather than the * added to
-        // prior chunks. This indicates that the resumable upload is complete.
+        // prior chunks. This indicates that the resumable upload is complete. The last chunk is empty when all data was uploaded by
+        // a checkpoint, in which case only the total is sent.
         HttpHeader *header = httpHeaderAdd(
             httpHeaderNew(NULL), HTTP_HEADER_CONTENT_RANGE_STR,
-            strNewFmt(
-                HTTP_HEADER_CONTENT_RANGE_BYTES " %" PRIu64 "-%" PRIu64 "/%s", this->uploadTotal,
-                this->uploadTotal + bufUsed(this->chunkBuffer) - 1,
-                done ? zNewFmt("%" PRIu64, this->uploadTotal + bufUsed(this->chunkBuffer)) : "*"));
+            bufEmpty(this->chunkBuffer) ?
+                strNewFmt(HTTP_HEADER_CONTENT_RANGE_BYTES " */%" PRIu64, this->uploadTotal) :
+                strNewFmt(
+                    HTTP_HEADER_CONTENT_RANGE_BYTES " %" PRIu64 "-%" PRIu64 "/%s", this->uploadTotal,
+                    this->uploadTotal + bufUsed(this->chunkBuffer) - 1,
+                    done ? zNewFmt("%" PRIu64, this->uploadTotal + bufUsed(this->chunkBuffer)) : "*"));
 
         httpQueryAdd(query, GCS_QUERY_UPLOAD_ID_STR, this->uploadId);
 
@@ -237,8 +253,18 @@ storageWriteGcs(THIS_VOID, const Buffer *buffer)
 
     size_t bytesTotal = 0;
 
+    // Skip data that has already been uploaded when resuming. The data must still be added to the md5 hash since the hash covers
+    // the entire file.
+    if (this->skip > 0)
+    {
+        bytesTotal = this->skip < bufUsed(buffer) ? (size_t)this->skip : bufUsed(buffer);
+        this->skip -= bytesTotal;
+
+        ioFilterProcessIn(this->md5hash, BUF(bufPtrConst(buffer), bytesTotal));
+    }
+
     // Continue until the write buffer has been exhausted
-    do
+    while (bytesTotal != bufUsed(buffer))
     {
         // If the chunk buffer is full then write it. We can't write it at the end of this loop because this might be the end of the
         // input and we'd have no way to signal the end of the resumable upload when closing the file if there is no more data.
@@ -254,8 +280,102 @@ storageWriteGcs(THIS_VOID, const Buffer *buffer)
         bufCatSub(this->chunkBuffer, buffer, bytesTotal, bytesNext);
         bytesTotal += bytesNext;
     }
-    while (bytesTotal != bufUsed(buffer));
 
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Upload the chunk buffer and return the resumable upload state so the file can be resumed
+***********************************************************************************************************************************/
+static Pack *
+storageWriteGcsCheckpoint(THIS_VOID)
+{
+    THIS(StorageWriteGcs);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_WRITE_GCS, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->chunkBuffer != NULL);
+    ASSERT(this->skip == 0);
+
+    Pack *result = NULL;
+
+    // All chunks except the last must be aligned so the chunk buffer can only be uploaded when it is full (the chunk size is
+    // aligned) or aligned. Otherwise no checkpoint can be made until more data has been written.
+    if (bufRemains(this->chunkBuffer) == 0 || bufUsed(this->chunkBuffer) % STORAGE_GCS_CHUNK_ALIGN == 0)
+    {
+        if (!bufEmpty(this->chunkBuffer))
+        {
+            storageWriteGcsBlockAsync(this, false);
+            bufUsedZero(this->chunkBuffer);
+        }
+
+        // Wait for the last chunk to be uploaded
+        storageWriteGcsBlock(this, false);
+
+        // The upload id and total are required to resume the upload. If a chunk was uploaded after the checkpoint it will be sent
+        // again on resume but that is harmless since the data is the same and GCS ignores bytes that have already been persisted.
+        if (this->uploadId != NULL)
+        {
+            PackWrite *const pack = pckWriteNewP();
+
+            pckWriteStrP(pack, this->uploadId);
+            pckWriteU64P(pack, this->uploadTotal);
+            pckWriteEndP(pack);
+
+            result = pckWriteResult(pack);
+        }
+    }
+
+    FUNCTION_LOG_RETURN(PACK, result);
+}
+
+/***********************************************************************************************************************************
+Cancel the resumable upload so the chunks already uploaded are not kept
+***********************************************************************************************************************************/
+static void
+storageWriteGcsAbort(THIS_VOID)
+{
+    THIS(StorageWriteGcs);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_WRITE_GCS, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    // Discard the outstanding chunk request, if any, since the chunk will be removed with the upload
+    httpRequestFree(this->request);
+    this->request = NULL;
+
+    // The upload may already be missing, e.g. when it has expired and that is why the write failed
+    if (this->uploadId != NULL)
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            HttpQuery *const query = httpQueryNewP();
+            httpQueryAdd(query, GCS_QUERY_NAME_STR, strSub(this->interface.name, 1));
+            httpQueryAdd(query, GCS_QUERY_UPLOAD_TYPE_STR, GCS_QUERY_RESUMABLE_STR);
+            httpQueryAdd(query, GCS_QUERY_UPLOAD_ID_STR, this->uploadId);
+
+            HttpRequest *const request = storageGcsRequestAsyncP(
+                this->storage, HTTP_VERB_DELETE_STR, .upload = true, .noAuth = true, .query = query);
+            HttpResponse *const response = httpRequestResponse(request, true);
+
+            if (httpResponseCode(response) != STORAGE_GCS_RESPONSE_CODE_CANCELLED &&
+                httpResponseCode(response) != HTTP_RESPONSE_CODE_NOT_FOUND)
+            {
+                httpRequestError(request, response);
+            }
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    // The file cannot be closed after it has been aborted
+    bufFree(this->chunkBuffer);
+    this->chunkBuffer = NULL;
 
     FUNCTION_LOG_RETURN_VOID();
 }
@@ -282,8 +402,6 @@ storageWriteGcsClose(THIS_VOID)
             // If a resumable upload was started then finish that way
             if (this->uploadId != NULL)
             {
-                ASSERT(!bufEmpty(this->chunkBuffer));
-
                 // Write what is left in the chunk buffer
                 storageWriteGcsBlockAsync(this, true);
                 storageWriteGcsBlock(this, true);
@@ -320,12 +438,14 @@ storageWriteGcsClose(THIS_VOID)
 
 /**********************************************************************************************************************************/
 StorageWrite *
-storageWriteGcsNew(StorageGcs *storage, const String *name, size_t chunkSize)
+storageWriteGcsNew(
+    StorageGcs *const storage, const String *const name, const size_t chunkSize, const Pack *const resume)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(STORAGE_GCS, storage);
         FUNCTION_LOG_PARAM(STRING, name);
         FUNCTION_LOG_PARAM(UINT64, chunkSize);
+        FUNCTION_LOG_PARAM(PACK, resume);
     FUNCTION_LOG_END();
 
     ASSERT(storage != NULL);
@@ -357,9 +477,22 @@ storageWriteGcsNew(StorageGcs *storage, const String *name, size_t chunkSize)
                     .open = storageWriteGcsOpen,
                     .write = storageWriteGcs,
                 },
+
+                .checkpoint = storageWriteGcsCheckpoint,
+                .abort = storageWriteGcsAbort,
             },
         };
 
+        // Continue the resumable upload from the checkpoint
+        if (resume != NULL)
+        {
+            PackRead *const read = pckReadNew(resume);
+
+            driver->uploadId = pckReadStrP(read);
+            driver->uploadTotal = pckReadU64P(read);
+            driver->skip = driver->uploadTotal;
+        }
+
         this = storageWriteNew(driver, &driver->interface);
     }
     OBJ_NEW_END();
@@ -66,6 +66,9 @@ typedef struct StorageInfo
     const String *user;                                             // Name of user that owns the file
     const String *group;                                            // Name of group that owns the file
     const String *linkDestination;                                  // Destination if this is a link
+
+    // Set when the checksum is requested and the storage can provide it without reading the file (NULL otherwise)
+    const String *checksum;                                         // MD5 checksum of the stored bytes
 } StorageInfo;
 
 /***********************************************************************************************************************************
@@ -11,6 +11,11 @@ Storage Iterator
 #include "storage/list.h"
 #include "storage/storage.h"
 
+/***********************************************************************************************************************************
+Maximum number of paths to list at once when the driver can list multiple paths concurrently
+***********************************************************************************************************************************/
+#define STORAGE_ITERATOR_LIST_MULTI_MAX                             8
+
 /***********************************************************************************************************************************
 Object type
 ***********************************************************************************************************************************/
@@ -28,6 +33,8 @@ struct StorageIterator
     bool returnedNext;                                              // Next info was returned
     StorageInfo infoNext;                                           // Info to be returned by next
     String *nameNext;                                               // Name for next info
+
+    List *prefetchList;                                             // Path lists retrieved before they were needed
 };
 
 // Path info list
@@ -39,6 +46,119 @@ typedef struct StorageIteratorInfo
     bool pathContentSkip;                                           // Skip reading path content
 } StorageIteratorInfo;
 
+// Path list retrieved before it was needed
+typedef struct StorageIteratorPrefetch
+{
+    String *pathSub;                                                // Subpath
+    StorageList *list;                                              // Storage info list (NULL if the path is missing)
+} StorageIteratorPrefetch;
+
+/***********************************************************************************************************************************
+Get the list for a path
+
+When the driver can list multiple paths concurrently then the paths that follow this path in the current list are listed at the same
+time and stored until they are needed. This greatly reduces the impact of request latency on object stores.
+***********************************************************************************************************************************/
+static StorageList *
+storageItrPathList(StorageIterator *const this, const String *const pathSub)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_ITERATOR, this);
+        FUNCTION_LOG_PARAM(STRING, pathSub);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    StorageList *result = NULL;
+
+    // List the path directly when it is the root path or the driver cannot list multiple paths
+    if (pathSub == NULL || this->prefetchList == NULL)
+    {
+        result = storageInterfaceListP(
+            this->driver, pathSub == NULL ? this->path : strNewFmt("%s/%s", strZ(this->path), strZ(pathSub)), this->level,
+            .expression = this->expression);
+    }
+    else
+    {
+        unsigned int prefetchIdx = lstFindIdx(this->prefetchList, &pathSub);
+
+        // If the path has not been listed then list it along with the paths that follow it in the current list
+        if (prefetchIdx == LIST_NOT_FOUND)
+        {
+            MEM_CONTEXT_TEMP_BEGIN()
+            {
+                // Copy the path first since it may be stored in the current list, which is about to be read
+                StringList *const pathSubList = strLstNew();
+                strLstAdd(pathSubList, pathSub);
+
+                // The path being listed is always from the list at the top of the stack
+                StorageIteratorInfo *const listInfo = *(StorageIteratorInfo **)lstGetLast(this->stack);
+
+                for (unsigned int listIdx = listInfo->listIdx + 1;
+                     listIdx < storageLstSize(listInfo->list) && strLstSize(pathSubList) < STORAGE_ITERATOR_LIST_MULTI_MAX;
+                     listIdx++)
+                {
+                    const StorageInfo info = storageLstGet(listInfo->list, listIdx);
+
+                    if (info.type == storageTypePath)
+                    {
+                        if (listInfo->pathSub == NULL)
+                            strLstAdd(pathSubList, info.name);
+                        else
+                            strLstAddFmt(pathSubList, "%s/%s", strZ(listInfo->pathSub), strZ(info.name));
+                    }
+                }
+
+                // Get the current info again since the list reuses the name buffer and the caller may still be using it
+                storageLstGet(listInfo->list, listInfo->listIdx);
+
+                // List all paths
+                StringList *const pathList = strLstNew();
+
+                for (unsigned int pathSubIdx = 0; pathSubIdx < strLstSize(pathSubList); pathSubIdx++)
+                    strLstAddFmt(pathList, "%s/%s", strZ(this->path), strZ(strLstGet(pathSubList, pathSubIdx)));
+
+                const List *const listList = storageInterfaceListMultiP(
+                    this->driver, pathList, this->level, .expression = this->expression);
+
+                ASSERT(lstSize(listList) == strLstSize(pathSubList));
+
+                // Store lists until they are needed
+                MEM_CONTEXT_OBJ_BEGIN(this->prefetchList)
+                {
+                    for (unsigned int pathSubIdx = 0; pathSubIdx < strLstSize(pathSubList); pathSubIdx++)
+                    {
+                        StorageIteratorPrefetch prefetch =
+                        {
+                            .pathSub = strDup(strLstGet(pathSubList, pathSubIdx)),
+                            .list = *(StorageList **)lstGet(listList, pathSubIdx),
+                        };
+
+                        if (prefetch.list != NULL)
+                            storageLstMove(prefetch.list, objMemContext(this->prefetchList));
+
+                        lstAdd(this->prefetchList, &prefetch);
+                    }
+                }
+                MEM_CONTEXT_OBJ_END();
+
+                // The requested path is the first of the lists just added
+                prefetchIdx = lstSize(this->prefetchList) - strLstSize(pathSubList);
+            }
+            MEM_CONTEXT_TEMP_END();
+        }
+
+        // Remove the list from the prefetch list and return it
+        StorageIteratorPrefetch *const prefetch = lstGet(this->prefetchList, prefetchIdx);
+        result = prefetch->list == NULL ? NULL : storageLstMove(prefetch->list, memContextCurrent());
+
+        strFree(prefetch->pathSub);
+        lstRemoveIdx(this->prefetchList, prefetchIdx);
+    }
+
+    FUNCTION_LOG_RETURN(STORAGE_LIST, result);
+}
+
 /***********************************************************************************************************************************
 Check a path and add it to the stack if it exists and has content
 ***********************************************************************************************************************************/
@@ -63,9 +183,7 @@ storageItrPathAdd(StorageIterator *const this, const String *const pathSub)
     MEM_CONTEXT_TEMP_BEGIN()
     {
         // Get path content
-        StorageList *const list = storageInterfaceListP(
-            this->driver, pathSub == NULL ? this->path : strNewFmt("%s/%s", strZ(this->path), strZ(pathSub)), this->level,
-            .expression = this->expression);
+        StorageList *const list = storageItrPathList(this, pathSub);
 
         // If path exists
         if (list != NULL)
@@ -144,6 +262,9 @@ storageItrNew(
                 .stack = lstNewP(sizeof(StorageIteratorInfo *)),
                 .nameNext = strNew(),
                 .returnedNext = true,
+                .prefetchList =
+                    STORAGE_COMMON_INTERFACE(driver).listMulti == NULL ?
+                        NULL : lstNewP(sizeof(StorageIteratorPrefetch), .comparator = lstComparatorStr),
             };
 
             // Compile regular expression
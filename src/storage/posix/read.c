@@ -3,7 +3,10 @@ Posix Storage Read
 ***********************************************************************************************************************************/
 #include "build.auto.h"
 
+#include <errno.h>
 #include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include "common/debug.h"
@@ -14,6 +17,14 @@ Posix Storage Read
 #include "storage/posix/storage.intern.h"
 #include "storage/read.intern.h"
 
+/***********************************************************************************************************************************
+SEEK_DATA/SEEK_HOLE are not defined on Linux when only POSIX features are enabled
+***********************************************************************************************************************************/
+#if !defined(SEEK_DATA) && defined(__linux__)
+    #define SEEK_DATA                                               3
+    #define SEEK_HOLE                                               4
+#endif
+
 /***********************************************************************************************************************************
 Object types
 ***********************************************************************************************************************************/
@@ -26,6 +37,10 @@ typedef struct StorageReadPosix
     uint64_t current;                                               // Current bytes read from file
     uint64_t limit;                                                 // Limit bytes to be read from file (UINT64_MAX for no limit)
     bool eof;
+
+    bool sparse;                                                    // Does the file have holes?
+    bool regionHole;                                                // Is the current region a hole?
+    uint64_t regionEnd;                                             // End of the current region
 } StorageReadPosix;
 
 /***********************************************************************************************************************************
@@ -98,11 +113,75 @@ storageReadPosixOpen(THIS_VOID)
                 lseek(this->fd, (off_t)this->interface.offset, SEEK_SET) == -1, FileOpenError, STORAGE_ERROR_READ_SEEK,
                 this->interface.offset, strZ(this->interface.name));
         }
+
+        // Holes are only searched for when fewer blocks are allocated than the size of the file requires, so files without holes
+        // do not pay for the extra seeks
+        struct stat statFile;
+
+        THROW_ON_SYS_ERROR_FMT(
+            fstat(this->fd, &statFile) == -1, FileOpenError, STORAGE_ERROR_INFO, strZ(this->interface.name));
+
+        this->sparse = (uint64_t)statFile.st_blocks * 512 < (uint64_t)statFile.st_size;
     }
 
     FUNCTION_LOG_RETURN(BOOL, this->fd != -1);
 }
 
+/***********************************************************************************************************************************
+Find the region (data or hole) that contains the position and where it ends
+***********************************************************************************************************************************/
+static void
+storageReadPosixRegion(StorageReadPosix *const this, const uint64_t position)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_READ_POSIX, this);
+        FUNCTION_LOG_PARAM(UINT64, position);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL && this->fd != -1);
+
+    const off_t data = lseek(this->fd, (off_t)position, SEEK_DATA);
+
+    // ENXIO means there is no data at or after the position
+    THROW_ON_SYS_ERROR_FMT(
+        data == -1 && errno != ENXIO, FileReadError, STORAGE_ERROR_READ_SEEK, position, strZ(this->interface.name));
+
+    if (data == -1)
+    {
+        // The rest of the file is a hole unless the position is at the end of the file, in which case read() will report EOF
+        struct stat statFile;
+
+        THROW_ON_SYS_ERROR_FMT(
+            fstat(this->fd, &statFile) == -1, FileReadError, STORAGE_ERROR_INFO, strZ(this->interface.name));
+
+        this->regionHole = position < (uint64_t)statFile.st_size;
+        this->regionEnd = this->regionHole ? (uint64_t)statFile.st_size : UINT64_MAX;
+    }
+    // Else the position is in a hole that ends where the data starts
+    else if ((uint64_t)data > position)
+    {
+        this->regionHole = true;
+        this->regionEnd = (uint64_t)data;
+    }
+    // Else the position is in data that ends at the next hole (the end of the file counts as a hole)
+    else
+    {
+        const off_t hole = lseek(this->fd, (off_t)position, SEEK_HOLE);
+
+        THROW_ON_SYS_ERROR_FMT(hole == -1, FileReadError, STORAGE_ERROR_READ_SEEK, position, strZ(this->interface.name));
+
+        this->regionHole = false;
+        this->regionEnd = (uint64_t)hole;
+    }
+
+    // Seeking for data and holes moves the file position so restore it
+    THROW_ON_SYS_ERROR_FMT(
+        lseek(this->fd, (off_t)position, SEEK_SET) == -1, FileReadError, STORAGE_ERROR_READ_SEEK, position,
+        strZ(this->interface.name));
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
 /***********************************************************************************************************************************
 Read from a file
 ***********************************************************************************************************************************/
@@ -131,8 +210,35 @@ storageReadPosix(THIS_VOID, Buffer *buffer, bool block)
         if (this->current + expectedBytes > this->limit)
             expectedBytes = (size_t)(this->limit - this->current);
 
-        // Read from file
-        actualBytes = read(this->fd, bufRemainsPtr(buffer), expectedBytes);
+        // When the file has holes do not read past the end of the current region
+        bool hole = false;
+
+        if (this->sparse)
+        {
+            const uint64_t position = this->interface.offset + this->current;
+
+            if (position >= this->regionEnd)
+                storageReadPosixRegion(this, position);
+
+            if (position + expectedBytes > this->regionEnd)
+                expectedBytes = (size_t)(this->regionEnd - position);
+
+            hole = this->regionHole;
+        }
+
+        // Zero holes rather than reading them from the file. The file position must still be moved past the hole.
+        if (hole)
+        {
+            memset(bufRemainsPtr(buffer), 0, expectedBytes);
+            actualBytes = (ssize_t)expectedBytes;
+
+            THROW_ON_SYS_ERROR_FMT(
+                lseek(this->fd, (off_t)expectedBytes, SEEK_CUR) == -1, FileReadError, STORAGE_ERROR_READ_SEEK,
+                this->interface.offset + this->current + expectedBytes, strZ(this->interface.name));
+        }
+        // Else read from file
+        else
+            actualBytes = read(this->fd, bufRemainsPtr(buffer), expectedBytes);
 
         // Error occurred during read
         if (actualBytes == -1)
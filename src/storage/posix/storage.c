@@ -15,11 +15,17 @@ Posix Storage
 #include "common/debug.h"
 #include "common/log.h"
 #include "common/regExp.h"
+#include "common/stat.h"
 #include "common/user.h"
 #include "storage/posix/read.h"
 #include "storage/posix/storage.intern.h"
 #include "storage/posix/write.h"
 
+/***********************************************************************************************************************************
+Statistics constants
+***********************************************************************************************************************************/
+STRING_EXTERN(STORAGE_POSIX_STAT_SYNC_STR,                          STORAGE_POSIX_STAT_SYNC);
+
 /***********************************************************************************************************************************
 Define PATH_MAX if it is not defined
 ***********************************************************************************************************************************/
@@ -35,6 +41,53 @@ struct StoragePosix
     STORAGE_COMMON_MEMBER;
 };
 
+/**********************************************************************************************************************************/
+// Convert the results of stat() to StorageInfo at the requested level. User/group names and link destination are not set here
+// since the caller may be able to get them more efficiently.
+static void
+storagePosixInfoStat(StorageInfo *const info, const struct stat *const statFile)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(STORAGE_INFO, info);
+        FUNCTION_TEST_PARAM_P(VOID, statFile);
+    FUNCTION_TEST_END();
+
+    ASSERT(info != NULL);
+    ASSERT(statFile != NULL);
+
+    info->exists = true;
+
+    // Add type info (no need set file type since it is the default)
+    if (info->level >= storageInfoLevelType && !S_ISREG(statFile->st_mode))
+    {
+        if (S_ISDIR(statFile->st_mode))
+            info->type = storageTypePath;
+        else if (S_ISLNK(statFile->st_mode))
+            info->type = storageTypeLink;
+        else
+            info->type = storageTypeSpecial;
+    }
+
+    // Add basic level info
+    if (info->level >= storageInfoLevelBasic)
+    {
+        info->timeModified = statFile->st_mtime;
+
+        if (info->type == storageTypeFile)
+            info->size = (uint64_t)statFile->st_size;
+    }
+
+    // Add detail level info
+    if (info->level >= storageInfoLevelDetail)
+    {
+        info->groupId = statFile->st_gid;
+        info->userId = statFile->st_uid;
+        info->mode = statFile->st_mode & (S_IRWXU | S_IRWXG | S_IRWXO);
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
 /**********************************************************************************************************************************/
 static StorageInfo
 storagePosixInfo(THIS_VOID, const String *file, StorageInfoLevel level, StorageInterfaceInfoParam param)
@@ -64,36 +117,13 @@ storagePosixInfo(THIS_VOID, const String *file, StorageInfoLevel level, StorageI
     // On success the file exists
     else
     {
-        result.exists = true;
-
-        // Add type info (no need set file type since it is the default)
-        if (result.level >= storageInfoLevelType && !S_ISREG(statFile.st_mode))
-        {
-            if (S_ISDIR(statFile.st_mode))
-                result.type = storageTypePath;
-            else if (S_ISLNK(statFile.st_mode))
-                result.type = storageTypeLink;
-            else
-                result.type = storageTypeSpecial;
-        }
-
-        // Add basic level info
-        if (result.level >= storageInfoLevelBasic)
-        {
-            result.timeModified = statFile.st_mtime;
-
-            if (result.type == storageTypeFile)
-                result.size = (uint64_t)statFile.st_size;
-        }
+        storagePosixInfoStat(&result, &statFile);
 
         // Add detail level info
         if (result.level >= storageInfoLevelDetail)
         {
-            result.groupId = statFile.st_gid;
             result.group = groupNameFromId(result.groupId);
-            result.userId = statFile.st_uid;
             result.user = userNameFromId(result.userId);
-            result.mode = statFile.st_mode & (S_IRWXU | S_IRWXG | S_IRWXO);
 
             if (result.type == storageTypeLink)
             {
@@ -113,32 +143,100 @@ storagePosixInfo(THIS_VOID, const String *file, StorageInfoLevel level, StorageI
 }
 
 /**********************************************************************************************************************************/
+// Owner names looked up while building a list. Entries in a path nearly always share the same owner so caching the last names found
+// avoids calling getpwuid()/getgrgid() for every entry, which can be expensive depending on how name services are configured.
+typedef struct StoragePosixListOwner
+{
+    MemContext *memContext;                                         // Mem context for cached names
+    bool userSet;                                                   // Has a user been cached?
+    uid_t userId;                                                   // Cached user id
+    const String *user;                                             // Cached user name
+    bool groupSet;                                                  // Has a group been cached?
+    gid_t groupId;                                                  // Cached group id
+    const String *group;                                            // Cached group name
+} StoragePosixListOwner;
+
 // Helper function to get info for a file if it exists. This logic can't live directly in storagePosixList() because there is a race
 // condition where a file might exist while listing the directory but it is gone before stat() can be called. In order to get
 // complete test coverage this function must be split out.
+//
+// The entry is stat'd relative to the open directory so the kernel does not need to resolve the full path for every entry.
 static void
 storagePosixListEntry(
-    StoragePosix *const this, StorageList *const list, const String *const path, const char *const name,
-    const StorageInfoLevel level)
+    StorageList *const list, const String *const path, const int pathFd, const char *const name, const StorageInfoLevel level,
+    StoragePosixListOwner *const owner)
 {
     FUNCTION_TEST_BEGIN();
-        FUNCTION_TEST_PARAM(STORAGE_POSIX, this);
         FUNCTION_TEST_PARAM(STORAGE_LIST, list);
         FUNCTION_TEST_PARAM(STRING, path);
+        FUNCTION_TEST_PARAM(INT, pathFd);
         FUNCTION_TEST_PARAM(STRINGZ, name);
         FUNCTION_TEST_PARAM(ENUM, level);
+        FUNCTION_TEST_PARAM_P(VOID, owner);
     FUNCTION_TEST_END();
 
-    ASSERT(this != NULL);
     ASSERT(list != NULL);
     ASSERT(path != NULL);
     ASSERT(name != NULL);
+    ASSERT(owner != NULL);
 
-    StorageInfo info = storageInterfaceInfoP(this, strNewFmt("%s/%s", strZ(path), name), level);
+    struct stat statFile;
 
-    if (info.exists)
+    if (fstatat(pathFd, name, &statFile, AT_SYMLINK_NOFOLLOW) == -1)
     {
-        info.name = STR(name);
+        if (errno != ENOENT)                                                                                        // {vm_covered}
+            THROW_SYS_ERROR_FMT(FileOpenError, STORAGE_ERROR_INFO, zNewFmt("%s/%s", strZ(path), name));             // {vm_covered}
+    }
+    else
+    {
+        StorageInfo info = {.name = STR(name), .level = level};
+
+        storagePosixInfoStat(&info, &statFile);
+
+        if (info.level >= storageInfoLevelDetail)
+        {
+            // Lookup user/group names when they are not already cached
+            if (!owner->userSet || owner->userId != info.userId)
+            {
+                MEM_CONTEXT_BEGIN(owner->memContext)
+                {
+                    owner->user = userNameFromId(info.userId);
+                }
+                MEM_CONTEXT_END();
+
+                owner->userId = info.userId;
+                owner->userSet = true;
+            }
+
+            if (!owner->groupSet || owner->groupId != info.groupId)
+            {
+                MEM_CONTEXT_BEGIN(owner->memContext)
+                {
+                    owner->group = groupNameFromId(info.groupId);
+                }
+                MEM_CONTEXT_END();
+
+                owner->groupId = info.groupId;
+                owner->groupSet = true;
+            }
+
+            info.user = owner->user;
+            info.group = owner->group;
+
+            // Get link destination
+            if (info.type == storageTypeLink)
+            {
+                char linkDestination[PATH_MAX];
+                ssize_t linkDestinationSize = 0;
+
+                THROW_ON_SYS_ERROR_FMT(
+                    (linkDestinationSize = readlinkat(pathFd, name, linkDestination, sizeof(linkDestination) - 1)) == -1,
+                    FileReadError, "unable to get destination for link '%s/%s'", strZ(path), name);
+
+                info.linkDestination = strNewZN(linkDestination, (size_t)linkDestinationSize);
+            }
+        }
+
         storageLstAdd(list, &info);
     }
 
@@ -178,6 +276,10 @@ storagePosixList(THIS_VOID, const String *const path, const StorageInfoLevel lev
 
         TRY_BEGIN()
         {
+            // Directory fd used to stat entries relative to the path
+            const int pathFd = dirfd(dir);
+            StoragePosixListOwner owner = {.memContext = objMemContext(result)};
+
             MEM_CONTEXT_TEMP_RESET_BEGIN()
             {
                 // Read the directory entries
@@ -203,7 +305,7 @@ storagePosixList(THIS_VOID, const String *const path, const StorageInfoLevel lev
                         }
                         // Else more info is required which requires a call to stat()
                         else
-                            storagePosixListEntry(this, result, path, dirEntry->d_name, level);
+                            storagePosixListEntry(result, path, pathFd, dirEntry->d_name, level, &owner);
                     }
 
                     // Get next entry
@@ -336,6 +438,9 @@ storagePosixNewWrite(THIS_VOID, const String *file, StorageInterfaceNewWritePara
         FUNCTION_LOG_PARAM(BOOL, param.syncFile);
         FUNCTION_LOG_PARAM(BOOL, param.syncPath);
         FUNCTION_LOG_PARAM(BOOL, param.atomic);
+        FUNCTION_LOG_PARAM(BOOL, param.sparse);
+        FUNCTION_LOG_PARAM(BOOL, param.noTruncate);
+        FUNCTION_LOG_PARAM(UINT64, param.offset);
     FUNCTION_LOG_END();
 
     ASSERT(this != NULL);
@@ -345,7 +450,8 @@ storagePosixNewWrite(THIS_VOID, const String *file, StorageInterfaceNewWritePara
         STORAGE_WRITE,
         storageWritePosixNew(
             this, file, param.modeFile, param.modePath, param.user, param.group, param.timeModified, param.createPath,
-            param.syncFile, this->interface.pathSync != NULL ? param.syncPath : false, param.atomic));
+            param.syncFile, this->interface.pathSync != NULL ? param.syncPath : false, param.atomic, param.sparse, param.resume,
+            param.noTruncate, param.offset));
 }
 
 /**********************************************************************************************************************************/
@@ -487,6 +593,8 @@ storagePosixPathSync(THIS_VOID, const String *path, StorageInterfacePathSyncPara
     else
     {
         // Attempt to sync the directory
+        const uint64_t timeBegin = statTimeBegin();
+
         if (fsync(fd) == -1)
         {
             int errNo = errno;
@@ -497,6 +605,8 @@ storagePosixPathSync(THIS_VOID, const String *path, StorageInterfacePathSyncPara
             THROW_SYS_ERROR_CODE_FMT(errNo, PathSyncError, STORAGE_ERROR_PATH_SYNC, strZ(path));
         }
 
+        statTimeEnd(STORAGE_POSIX_STAT_SYNC_STR, timeBegin);
+
         THROW_ON_SYS_ERROR_FMT(close(fd) == -1, PathCloseError, STORAGE_ERROR_PATH_SYNC_CLOSE, strZ(path));
     }
 
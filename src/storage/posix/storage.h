@@ -16,6 +16,12 @@ Storage type
 ***********************************************************************************************************************************/
 #define STORAGE_POSIX_TYPE                                          STRID5("posix", 0x184cdf00)
 
+/***********************************************************************************************************************************
+Statistics constants
+***********************************************************************************************************************************/
+#define STORAGE_POSIX_STAT_SYNC                                     "posix.sync"        // File/path sync latency
+    STRING_DECLARE(STORAGE_POSIX_STAT_SYNC_STR);
+
 /***********************************************************************************************************************************
 Constructors
 ***********************************************************************************************************************************/
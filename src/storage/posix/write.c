@@ -5,12 +5,15 @@ Posix Storage File write
 
 #include <fcntl.h>
 #include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #include <utime.h>
 
 #include "common/debug.h"
 #include "common/io/write.h"
 #include "common/log.h"
+#include "common/stat.h"
 #include "common/type/object.h"
 #include "common/user.h"
 #include "storage/posix/storage.intern.h"
@@ -28,6 +31,15 @@ typedef struct StorageWritePosix
     const String *nameTmp;
     const String *path;
     int fd;                                                         // File descriptor
+
+    uint64_t size;                                                  // Size written including holes (when sparse)
+    bool holeEnd;                                                   // Does the file end with a hole (when sparse)?
+
+    bool resume;                                                    // Resume a partial file?
+    uint64_t skip;                                                  // Bytes left to skip because they are already in the file
+
+    bool noTruncate;                                                // Write into the file at the offset without truncating?
+    uint64_t offset;                                                // Where to start writing in the file
 } StorageWritePosix;
 
 /***********************************************************************************************************************************
@@ -46,6 +58,18 @@ Since open is called more than once use constants to make sure these parameters
 #define FILE_OPEN_FLAGS                                             (O_CREAT | O_TRUNC | O_WRONLY)
 #define FILE_OPEN_PURPOSE                                           "write"
 
+// A resumed file must already exist and must not be truncated until the size has been checked
+#define FILE_OPEN_FLAGS_RESUME                                      (O_WRONLY)
+
+// A file written at an offset may be written concurrently by other processes so it must not be truncated
+#define FILE_OPEN_FLAGS_NO_TRUNCATE                                 (O_CREAT | O_WRONLY)
+
+/***********************************************************************************************************************************
+Size of the blocks that are checked for zeros when the file is sparse. Blocks are aligned to the start of the file so they match
+file system blocks.
+***********************************************************************************************************************************/
+#define STORAGE_POSIX_SPARSE_BLOCK_SIZE                             ((size_t)4096)
+
 /***********************************************************************************************************************************
 Close file descriptor
 ***********************************************************************************************************************************/
@@ -80,23 +104,27 @@ storageWritePosixOpen(THIS_VOID)
     ASSERT(this != NULL);
     ASSERT(this->fd == -1);
 
-    // Open the file
-    this->fd = open(strZ(this->nameTmp), FILE_OPEN_FLAGS, this->interface.modeFile);
+    // Open the file. A resumed file must already exist.
+    const int flags = this->resume ? FILE_OPEN_FLAGS_RESUME : this->noTruncate ? FILE_OPEN_FLAGS_NO_TRUNCATE : FILE_OPEN_FLAGS;
+
+    this->fd = open(strZ(this->nameTmp), flags, this->interface.modeFile);
 
     // Attempt to create the path if it is missing
-    if (this->fd == -1 && errno == ENOENT && this->interface.createPath)                                            // {vm_covered}
+    if (this->fd == -1 && errno == ENOENT && this->interface.createPath && !this->resume)                           // {vm_covered}
     {
          // Create the path
         storageInterfacePathCreateP(this->storage, this->path, false, false, this->interface.modePath);
 
         // Open file again
-        this->fd = open(strZ(this->nameTmp), FILE_OPEN_FLAGS, this->interface.modeFile);
+        this->fd = open(strZ(this->nameTmp), flags, this->interface.modeFile);
     }
 
     // Handle errors
     if (this->fd == -1)
     {
-        if (errno == ENOENT)                                                                                        // {vm_covered}
+        if (errno == ENOENT && this->resume)
+            THROW_FMT(FileMissingError, "unable to resume missing file '%s'", strZ(this->nameTmp));
+        else if (errno == ENOENT)                                                                                   // {vm_covered}
             THROW_FMT(FileMissingError, STORAGE_ERROR_WRITE_MISSING, strZ(this->interface.name));
         else
             THROW_SYS_ERROR_FMT(FileOpenError, STORAGE_ERROR_WRITE_OPEN, strZ(this->interface.name));               // {vm_covered}
@@ -105,6 +133,39 @@ storageWritePosixOpen(THIS_VOID)
     // Set free callback to ensure the file descriptor is freed
     memContextCallbackSet(objMemContext(this), storageWritePosixFreeResource, this);
 
+    // Resume a partial file
+    if (this->resume)
+    {
+        // The file must contain at least the data that was durable at the checkpoint
+        struct stat statFile;
+
+        THROW_ON_SYS_ERROR_FMT(
+            fstat(this->fd, &statFile) == -1, FileOpenError, STORAGE_ERROR_WRITE_OPEN, strZ(this->interface.name));
+
+        if ((uint64_t)statFile.st_size < this->skip)
+        {
+            THROW_FMT(
+                FileWriteError, "unable to resume '%s' at %" PRIu64 " bytes since the file has only %" PRIu64 " bytes",
+                strZ(this->nameTmp), this->skip, (uint64_t)statFile.st_size);
+        }
+
+        // Discard anything written after the checkpoint and continue writing at the checkpoint
+        THROW_ON_SYS_ERROR_FMT(
+            ftruncate(this->fd, (off_t)this->skip) == -1, FileWriteError, "unable to truncate '%s'", strZ(this->nameTmp));
+        THROW_ON_SYS_ERROR_FMT(
+            lseek(this->fd, (off_t)this->skip, SEEK_SET) == -1, FileWriteError, "unable to seek in '%s'", strZ(this->nameTmp));
+
+        this->size = this->skip;
+    }
+    // Else continue writing at the offset
+    else if (this->offset != 0)
+    {
+        THROW_ON_SYS_ERROR_FMT(
+            lseek(this->fd, (off_t)this->offset, SEEK_SET) == -1, FileWriteError, "unable to seek in '%s'", strZ(this->nameTmp));
+
+        this->size = this->offset;
+    }
+
     // Update user/group owner
     if (this->interface.user != NULL || this->interface.group != NULL)
     {
@@ -129,6 +190,21 @@ storageWritePosixOpen(THIS_VOID)
 /***********************************************************************************************************************************
 Write to the file
 ***********************************************************************************************************************************/
+static void
+storageWritePosixData(StorageWritePosix *const this, const unsigned char *const data, const size_t size)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STORAGE_WRITE_POSIX, this);
+        FUNCTION_TEST_PARAM_P(UCHARDATA, data);
+        FUNCTION_TEST_PARAM(SIZE, size);
+    FUNCTION_TEST_END();
+
+    if (write(this->fd, data, size) != (ssize_t)size)
+        THROW_SYS_ERROR_FMT(FileWriteError, "unable to write '%s'", strZ(this->nameTmp));
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
 static void
 storageWritePosix(THIS_VOID, const Buffer *buffer)
 {
@@ -143,13 +219,132 @@ storageWritePosix(THIS_VOID, const Buffer *buffer)
     ASSERT(buffer != NULL);
     ASSERT(this->fd != -1);
 
+    const unsigned char *data = bufPtrConst(buffer);
+    size_t size = bufUsed(buffer);
+
+    // Skip data that is already in the file when resuming
+    if (this->skip > 0)
+    {
+        const size_t skip = this->skip < size ? (size_t)this->skip : size;
+
+        data += skip;
+        size -= skip;
+        this->skip -= skip;
+    }
+
     // Write the data
-    if (write(this->fd, bufPtrConst(buffer), bufUsed(buffer)) != (ssize_t)bufUsed(buffer))
-        THROW_SYS_ERROR_FMT(FileWriteError, "unable to write '%s'", strZ(this->nameTmp));
+    if (!this->interface.sparse)
+        storageWritePosixData(this, data, size);
+    // Else skip over complete blocks that are all zero so they become holes. Data between the holes is written with as few writes
+    // as possible.
+    else
+    {
+        size_t dataBegin = 0;
+        size_t dataIdx = 0;
+
+        while (dataIdx < size)
+        {
+            const uint64_t position = this->size + dataIdx;
+            size_t blockSize = STORAGE_POSIX_SPARSE_BLOCK_SIZE - (size_t)(position % STORAGE_POSIX_SPARSE_BLOCK_SIZE);
+
+            if (blockSize > size - dataIdx)
+                blockSize = size - dataIdx;
+
+            // A block is zero when the first byte is zero and every byte is equal to the byte before it
+            if (blockSize == STORAGE_POSIX_SPARSE_BLOCK_SIZE && data[dataIdx] == 0 &&
+                memcmp(data + dataIdx, data + dataIdx + 1, blockSize - 1) == 0)
+            {
+                if (dataIdx > dataBegin)
+                    storageWritePosixData(this, data + dataBegin, dataIdx - dataBegin);
+
+                THROW_ON_SYS_ERROR_FMT(
+                    lseek(this->fd, (off_t)blockSize, SEEK_CUR) == -1, FileWriteError, "unable to seek in '%s'",
+                    strZ(this->nameTmp));
+
+                dataBegin = dataIdx + blockSize;
+                this->holeEnd = true;
+            }
+            else
+                this->holeEnd = false;
+
+            dataIdx += blockSize;
+        }
+
+        if (dataIdx > dataBegin)
+            storageWritePosixData(this, data + dataBegin, dataIdx - dataBegin);
+    }
+
+    this->size += size;
 
     FUNCTION_LOG_RETURN_VOID();
 }
 
+/***********************************************************************************************************************************
+Set the size of a file that ends with a hole and sync the file
+***********************************************************************************************************************************/
+static void
+storageWritePosixSync(StorageWritePosix *const this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STORAGE_WRITE_POSIX, this);
+    FUNCTION_TEST_END();
+
+    // A hole at the end of the file is not part of the file until the size is set
+    if (this->holeEnd)
+    {
+        // When the file is not truncated another process may have written past the hole so the file is extended by writing the
+        // last zero byte of the hole rather than by setting the size
+        if (this->noTruncate)
+        {
+            THROW_ON_SYS_ERROR_FMT(
+                pwrite(this->fd, "", 1, (off_t)this->size - 1) != 1, FileWriteError, "unable to write '%s'",
+                strZ(this->nameTmp));
+        }
+        else
+        {
+            THROW_ON_SYS_ERROR_FMT(
+                ftruncate(this->fd, (off_t)this->size) == -1, FileWriteError, "unable to truncate '%s'", strZ(this->nameTmp));
+        }
+    }
+
+    // Sync the file
+    if (this->interface.syncFile)
+    {
+        const uint64_t timeBegin = statTimeBegin();
+
+        THROW_ON_SYS_ERROR_FMT(fsync(this->fd) == -1, FileSyncError, STORAGE_ERROR_WRITE_SYNC, strZ(this->nameTmp));
+        statTimeEnd(STORAGE_POSIX_STAT_SYNC_STR, timeBegin);
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Make the data written so far durable and return the size so the file can be resumed
+***********************************************************************************************************************************/
+static Pack *
+storageWritePosixCheckpoint(THIS_VOID)
+{
+    THIS(StorageWritePosix);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_WRITE_POSIX, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->fd != -1);
+    ASSERT(this->skip == 0);
+
+    storageWritePosixSync(this);
+
+    PackWrite *const result = pckWriteNewP();
+
+    pckWriteU64P(result, this->size);
+    pckWriteEndP(result);
+
+    FUNCTION_LOG_RETURN(PACK, pckWriteResult(result));
+}
+
 /***********************************************************************************************************************************
 Close the file
 ***********************************************************************************************************************************/
@@ -167,9 +362,8 @@ storageWritePosixClose(THIS_VOID)
     // Close if the file has not already been closed
     if (this->fd != -1)
     {
-        // Sync the file
-        if (this->interface.syncFile)
-            THROW_ON_SYS_ERROR_FMT(fsync(this->fd) == -1, FileSyncError, STORAGE_ERROR_WRITE_SYNC, strZ(this->nameTmp));
+        // Set the size and sync the file
+        storageWritePosixSync(this);
 
         // Close the file
         memContextCallbackClear(objMemContext(this));
@@ -222,7 +416,8 @@ storageWritePosixFd(const THIS_VOID)
 StorageWrite *
 storageWritePosixNew(
     StoragePosix *storage, const String *name, mode_t modeFile, mode_t modePath, const String *user, const String *group,
-    time_t timeModified, bool createPath, bool syncFile, bool syncPath, bool atomic)
+    time_t timeModified, bool createPath, bool syncFile, bool syncPath, bool atomic, bool sparse, const Pack *const resume,
+    const bool noTruncate, const uint64_t offset)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(STORAGE_POSIX, storage);
@@ -236,12 +431,18 @@ storageWritePosixNew(
         FUNCTION_LOG_PARAM(BOOL, syncFile);
         FUNCTION_LOG_PARAM(BOOL, syncPath);
         FUNCTION_LOG_PARAM(BOOL, atomic);
+        FUNCTION_LOG_PARAM(BOOL, sparse);
+        FUNCTION_LOG_PARAM(PACK, resume);
+        FUNCTION_LOG_PARAM(BOOL, noTruncate);
+        FUNCTION_LOG_PARAM(UINT64, offset);
     FUNCTION_LOG_END();
 
     ASSERT(storage != NULL);
     ASSERT(name != NULL);
     ASSERT(modeFile != 0);
     ASSERT(modePath != 0);
+    ASSERT(offset == 0 || noTruncate);
+    ASSERT(!noTruncate || (!atomic && resume == NULL));
 
     StorageWrite *this = NULL;
 
@@ -254,6 +455,8 @@ storageWritePosixNew(
             .storage = storage,
             .path = strPath(name),
             .fd = -1,
+            .noTruncate = noTruncate,
+            .offset = offset,
 
             .interface = (StorageWriteInterface)
             {
@@ -266,6 +469,7 @@ storageWritePosixNew(
                 .modePath = modePath,
                 .syncFile = syncFile,
                 .syncPath = syncPath,
+                .sparse = sparse,
                 .user = strDup(user),
                 .timeModified = timeModified,
 
@@ -276,9 +480,20 @@ storageWritePosixNew(
                     .open = storageWritePosixOpen,
                     .write = storageWritePosix,
                 },
+
+                .checkpoint = storageWritePosixCheckpoint,
             },
         };
 
+        // Get the size that was durable at the checkpoint
+        if (resume != NULL)
+        {
+            PackRead *const read = pckReadNew(resume);
+
+            driver->resume = true;
+            driver->skip = pckReadU64P(read);
+        }
+
         // Create temp file name
         driver->nameTmp = atomic ? strNewFmt("%s." STORAGE_FILE_TEMP_EXT, strZ(name)) : driver->interface.name;
 
@@ -8,6 +8,7 @@ Remote Storage Protocol Handler
 #include "common/crypto/cipherBlock.h"
 #include "common/crypto/hash.h"
 #include "common/debug.h"
+#include "common/io/filter/rate.h"
 #include "common/io/filter/sink.h"
 #include "common/io/filter/size.h"
 #include "common/io/io.h"
@@ -72,6 +73,10 @@ storageRemoteFilterGroup(IoFilterGroup *const filterGroup, const Pack *const fil
                         ioFilterGroupAdd(filterGroup, pageChecksumNewPack(filterParam));
                         break;
 
+                    case IO_RATE_FILTER_TYPE:
+                        ioFilterGroupAdd(filterGroup, ioRateNewPack(filterParam));
+                        break;
+
                     case SINK_FILTER_TYPE:
                         ioFilterGroupAdd(filterGroup, ioSinkNew());
                         break;
@@ -261,15 +266,20 @@ storageRemoteInfoProtocol(PackRead *const param, ProtocolServer *const server)
         const String *file = pckReadStrP(param);
         StorageInfoLevel level = (StorageInfoLevel)pckReadU32P(param);
         bool followLink = pckReadBoolP(param);
+        const bool checksum = pckReadBoolP(param);
 
-        StorageInfo info = storageInterfaceInfoP(storageRemoteProtocolLocal.driver, file, level, .followLink = followLink);
+        StorageInfo info = storageInterfaceInfoP(
+            storageRemoteProtocolLocal.driver, file, level, .followLink = followLink, .checksum = checksum);
 
         // Write file info to protocol
         PackWrite *write = protocolPackNew();
         pckWriteBoolP(write, info.exists, .defaultWrite = true);
 
         if (info.exists)
+        {
             storageRemoteInfoProtocolPut(&(StorageRemoteInfoProtocolWriteData){0}, write, &info);
+            pckWriteStrP(write, info.checksum);
+        }
 
         protocolServerDataPut(server, write);
         protocolServerDataEndPut(server);
@@ -125,6 +125,7 @@ storageRemoteInfo(THIS_VOID, const String *file, StorageInfoLevel level, Storage
         FUNCTION_LOG_PARAM(STRING, file);
         FUNCTION_LOG_PARAM(ENUM, level);
         FUNCTION_LOG_PARAM(BOOL, param.followLink);
+        FUNCTION_LOG_PARAM(BOOL, param.checksum);
     FUNCTION_LOG_END();
 
     ASSERT(this != NULL);
@@ -139,6 +140,7 @@ storageRemoteInfo(THIS_VOID, const String *file, StorageInfoLevel level, Storage
         pckWriteStrP(commandParam, file);
         pckWriteU32P(commandParam, level);
         pckWriteBoolP(commandParam, param.followLink);
+        pckWriteBoolP(commandParam, param.checksum);
 
         // Put command
         protocolClientCommandPut(this->client, command, false);
@@ -156,6 +158,7 @@ storageRemoteInfo(THIS_VOID, const String *file, StorageInfoLevel level, Storage
             MEM_CONTEXT_PRIOR_BEGIN()
             {
                 storageRemoteInfoGet(&parseData, read, &result);
+                result.checksum = pckReadStrP(read);
             }
             MEM_CONTEXT_PRIOR_END();
         }
@@ -281,6 +284,8 @@ storageRemoteNewWrite(
 
     ASSERT(this != NULL);
     ASSERT(file != NULL);
+    ASSERT(param.resume == NULL);
+    ASSERT(!param.noTruncate);
 
     FUNCTION_LOG_RETURN(
         STORAGE_WRITE,
@@ -23,15 +23,20 @@ S3 Storage
 /***********************************************************************************************************************************
 Defaults
 ***********************************************************************************************************************************/
+#define STORAGE_S3_COPY_SIZE_MAX                                    ((uint64_t)5 * 1024 * 1024 * 1024)
 #define STORAGE_S3_DELETE_MAX                                       1000
+#define STORAGE_S3_LIST_RANGE_MAX                                   8
+#define STORAGE_S3_LIST_RANGE_NAME_MIN                              100
 
 /***********************************************************************************************************************************
 S3 HTTP headers
 ***********************************************************************************************************************************/
 STRING_STATIC(S3_HEADER_CONTENT_SHA256_STR,                         "x-amz-content-sha256");
+STRING_STATIC(S3_HEADER_COPY_SOURCE_STR,                            "x-amz-copy-source");
 STRING_STATIC(S3_HEADER_DATE_STR,                                   "x-amz-date");
 STRING_STATIC(S3_HEADER_TOKEN_STR,                                  "x-amz-security-token");
 STRING_STATIC(S3_HEADER_SRVSDENC_STR,                               "x-amz-server-side-encryption");
+STRING_STATIC(S3_HEADER_SRVSDENC_AES256_STR,                        "AES256");
 STRING_STATIC(S3_HEADER_SRVSDENC_KMS_STR,                           "aws:kms");
 STRING_STATIC(S3_HEADER_SRVSDENC_KMSKEYID_STR,                      "x-amz-server-side-encryption-aws-kms-key-id");
 
@@ -43,6 +48,7 @@ STRING_STATIC(S3_QUERY_DELETE_STR,                                  "delete");
 STRING_STATIC(S3_QUERY_DELIMITER_STR,                               "delimiter");
 STRING_STATIC(S3_QUERY_LIST_TYPE_STR,                               "list-type");
 STRING_STATIC(S3_QUERY_PREFIX_STR,                                  "prefix");
+STRING_STATIC(S3_QUERY_START_AFTER_STR,                             "start-after");
 
 STRING_STATIC(S3_QUERY_VALUE_LIST_TYPE_2_STR,                       "2");
 
@@ -53,6 +59,7 @@ STRING_STATIC(S3_XML_TAG_COMMON_PREFIXES_STR,                       "CommonPrefi
 STRING_STATIC(S3_XML_TAG_CONTENTS_STR,                              "Contents");
 STRING_STATIC(S3_XML_TAG_DELETE_STR,                                "Delete");
 STRING_STATIC(S3_XML_TAG_ERROR_STR,                                 "Error");
+STRING_STATIC(S3_XML_TAG_COPY_ETAG_STR,                             "ETag");
 STRING_STATIC(S3_XML_TAG_IS_TRUNCATED_STR,                          "IsTruncated");
 STRING_STATIC(S3_XML_TAG_KEY_STR,                                   "Key");
 STRING_STATIC(S3_XML_TAG_LAST_MODIFIED_STR,                         "LastModified");
@@ -97,6 +104,7 @@ struct StorageS3
     size_t partSize;                                                // Part size for multi-part upload
     unsigned int deleteMax;                                         // Maximum objects that can be deleted in one request
     StorageS3UriStyle uriStyle;                                     // Path or host style URIs
+    const String *endPoint;                                         // Endpoint
     const String *bucketEndpoint;                                   // Set to {bucket}.{endpoint}
 
     // For retrieving temporary security credentials
@@ -605,34 +613,43 @@ storageS3Request(StorageS3 *this, const String *verb, const String *path, Storag
 /***********************************************************************************************************************************
 General function for listing files to be used by other list routines
 ***********************************************************************************************************************************/
-static void
-storageS3ListInternal(
-    StorageS3 *this, const String *path, StorageInfoLevel level, const String *expression, bool recurse,
-    StorageListCallback callback, void *callbackData)
+// Build the base prefix by stripping off the initial /
+static const String *
+storageS3ListBasePrefix(const String *const path)
 {
-    FUNCTION_LOG_BEGIN(logLevelDebug);
-        FUNCTION_LOG_PARAM(STORAGE_S3, this);
-        FUNCTION_LOG_PARAM(STRING, path);
-        FUNCTION_LOG_PARAM(ENUM, level);
-        FUNCTION_LOG_PARAM(STRING, expression);
-        FUNCTION_LOG_PARAM(BOOL, recurse);
-        FUNCTION_LOG_PARAM(FUNCTIONP, callback);
-        FUNCTION_LOG_PARAM_P(VOID, callbackData);
-    FUNCTION_LOG_END();
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, path);
+    FUNCTION_TEST_END();
 
-    ASSERT(this != NULL);
     ASSERT(path != NULL);
 
-    MEM_CONTEXT_TEMP_BEGIN()
-    {
-        // Build the base prefix by stripping off the initial /
-        const String *basePrefix;
+    const String *result;
 
-        if (strSize(path) == 1)
-            basePrefix = EMPTY_STR;
-        else
-            basePrefix = strNewFmt("%s/", strZ(strSub(path, 1)));
+    if (strSize(path) == 1)
+        result = EMPTY_STR;
+    else
+        result = strNewFmt("%s/", strZ(strSub(path, 1)));
+
+    FUNCTION_TEST_RETURN_CONST(STRING, result);
+}
+
+// Build the query used to list a path. This is separate from storageS3ListInternal() so storageS3ListMulti() can send the first
+// request for each path before any responses are processed.
+static HttpQuery *
+storageS3ListQuery(const String *const basePrefix, const String *const expression, const bool recurse)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, basePrefix);
+        FUNCTION_TEST_PARAM(STRING, expression);
+        FUNCTION_TEST_PARAM(BOOL, recurse);
+    FUNCTION_TEST_END();
+
+    ASSERT(basePrefix != NULL);
+
+    HttpQuery *const result = httpQueryNewP();
 
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
         // Get the expression prefix when possible to limit initial results
         const String *expressionPrefix = regExpPrefix(expression);
 
@@ -649,122 +666,251 @@ storageS3ListInternal(
                 queryPrefix = strNewFmt("%s%s", strZ(basePrefix), strZ(expressionPrefix));
         }
 
-        // Create query
-        HttpQuery *query = httpQueryNewP();
-
         // Add the delimiter to not recurse
         if (!recurse)
-            httpQueryAdd(query, S3_QUERY_DELIMITER_STR, FSLASH_STR);
+            httpQueryAdd(result, S3_QUERY_DELIMITER_STR, FSLASH_STR);
 
         // Use list type 2
-        httpQueryAdd(query, S3_QUERY_LIST_TYPE_STR, S3_QUERY_VALUE_LIST_TYPE_2_STR);
+        httpQueryAdd(result, S3_QUERY_LIST_TYPE_STR, S3_QUERY_VALUE_LIST_TYPE_2_STR);
 
         // Don't specify empty prefix because it is the default
         if (!strEmpty(queryPrefix))
-            httpQueryAdd(query, S3_QUERY_PREFIX_STR, queryPrefix);
+            httpQueryAdd(result, S3_QUERY_PREFIX_STR, queryPrefix);
+    }
+    MEM_CONTEXT_TEMP_END();
 
-        // Loop as long as a continuation token returned
-        HttpRequest *request = NULL;
+    FUNCTION_TEST_RETURN(HTTP_QUERY, result);
+}
 
-        do
-        {
-            // Use an inner mem context here because we could potentially be retrieving millions of files so it is a good idea to
-            // free memory at regular intervals
-            MEM_CONTEXT_TEMP_BEGIN()
-            {
-                HttpResponse *response = NULL;
+// Range of names to list. When the first page of a list is truncated the rest of the list is split into ranges that are listed
+// concurrently.
+typedef struct StorageS3ListRange
+{
+    const String *startAfter;                                       // List names after this name (NULL to start at the beginning)
+    const String *stopAfter;                                        // Stop listing after this name (NULL to list to the end)
+    HttpRequest *request;                                           // Request that has already been sent for the range
+} StorageS3ListRange;
 
-                // If there is an outstanding async request then wait for the response
-                if (request != NULL)
-                {
-                    response = storageS3ResponseP(request);
+static void
+storageS3ListInternal(
+    StorageS3 *this, const String *path, StorageInfoLevel level, const String *expression, bool recurse, HttpRequest *request,
+    StorageListCallback callback, void *callbackData)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE_S3, this);
+        FUNCTION_LOG_PARAM(STRING, path);
+        FUNCTION_LOG_PARAM(ENUM, level);
+        FUNCTION_LOG_PARAM(STRING, expression);
+        FUNCTION_LOG_PARAM(BOOL, recurse);
+        FUNCTION_LOG_PARAM(HTTP_REQUEST, request);
+        FUNCTION_LOG_PARAM(FUNCTIONP, callback);
+        FUNCTION_LOG_PARAM_P(VOID, callbackData);
+    FUNCTION_LOG_END();
 
-                    httpRequestFree(request);
-                    request = NULL;
-                }
-                // Else get the response immediately from a sync request
-                else
-                    response = storageS3RequestP(this, HTTP_VERB_GET_STR, FSLASH_STR, .query = query);
+    ASSERT(this != NULL);
+    ASSERT(path != NULL);
 
-                XmlNode *xmlRoot = xmlDocumentRoot(xmlDocumentNewBuf(httpResponseContent(response)));
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Build the base prefix
+        const String *const basePrefix = storageS3ListBasePrefix(path);
 
-                // If list is truncated then send an async request to get more data
-                if (strEq(xmlNodeContent(xmlNodeChild(xmlRoot, S3_XML_TAG_IS_TRUNCATED_STR, true)), TRUE_STR))
-                {
-                    const String *const nextContinuationToken = xmlNodeContent(
-                        xmlNodeChild(xmlRoot, S3_XML_TAG_NEXT_CONTINUATION_TOKEN_STR, true));
-                    CHECK(FormatError, !strEmpty(nextContinuationToken), S3_XML_TAG_NEXT_CONTINUATION_TOKEN " may not be empty");
+        // Start with a single range for the entire list. The first request may have already been sent by the caller.
+        List *const rangeList = lstNewP(sizeof(StorageS3ListRange));
+        lstAdd(rangeList, &(StorageS3ListRange){.request = request});
 
-                    httpQueryPut(query, S3_QUERY_CONTINUATION_TOKEN_STR, nextContinuationToken);
+        for (unsigned int rangeIdx = 0; rangeIdx < lstSize(rangeList); rangeIdx++)
+        {
+            StorageS3ListRange range = *(StorageS3ListRange *)lstGet(rangeList, rangeIdx);
+            HttpQuery *const query = storageS3ListQuery(basePrefix, expression, recurse);
 
-                    // Store request in the outer temp context
-                    MEM_CONTEXT_PRIOR_BEGIN()
-                    {
-                        request = storageS3RequestAsyncP(this, HTTP_VERB_GET_STR, FSLASH_STR, .query = query);
-                    }
-                    MEM_CONTEXT_PRIOR_END();
-                }
+            if (range.startAfter != NULL)
+                httpQueryAdd(query, S3_QUERY_START_AFTER_STR, strNewFmt("%s%s", strZ(basePrefix), strZ(range.startAfter)));
 
-                // Get prefix list
-                XmlNodeList *subPathList = xmlNodeChildList(xmlRoot, S3_XML_TAG_COMMON_PREFIXES_STR);
+            request = range.request;
 
-                for (unsigned int subPathIdx = 0; subPathIdx < xmlNodeLstSize(subPathList); subPathIdx++)
+            // Loop as long as a continuation token returned
+            do
+            {
+                // Use an inner mem context here because we could potentially be retrieving millions of files so it is a good idea
+                // to free memory at regular intervals
+                MEM_CONTEXT_TEMP_BEGIN()
                 {
-                    const XmlNode *subPathNode = xmlNodeLstGet(subPathList, subPathIdx);
+                    HttpResponse *response = NULL;
 
-                    // Get path name
-                    StorageInfo info =
+                    // If there is an outstanding async request then wait for the response
+                    if (request != NULL)
                     {
-                        .level = level,
-                        .name = xmlNodeContent(xmlNodeChild(subPathNode, S3_XML_TAG_PREFIX_STR, true)),
-                        .exists = true,
-                    };
+                        response = storageS3ResponseP(request);
 
-                    // Strip off base prefix and final /
-                    info.name = strSubN(info.name, strSize(basePrefix), strSize(info.name) - strSize(basePrefix) - 1);
+                        httpRequestFree(request);
+                        request = NULL;
+                    }
+                    // Else get the response immediately from a sync request
+                    else
+                        response = storageS3RequestP(this, HTTP_VERB_GET_STR, FSLASH_STR, .query = query);
 
-                    // Add type info if requested
-                    if (level >= storageInfoLevelType)
-                        info.type = storageTypePath;
+                    XmlNode *xmlRoot = xmlDocumentRoot(xmlDocumentNewBuf(httpResponseContent(response)));
+                    XmlNodeList *subPathList = xmlNodeChildList(xmlRoot, S3_XML_TAG_COMMON_PREFIXES_STR);
+                    XmlNodeList *fileList = xmlNodeChildList(xmlRoot, S3_XML_TAG_CONTENTS_STR);
 
-                    // Callback with info
-                    callback(callbackData, &info);
-                }
+                    // If list is truncated then send an async request to get more data
+                    if (strEq(xmlNodeContent(xmlNodeChild(xmlRoot, S3_XML_TAG_IS_TRUNCATED_STR, true)), TRUE_STR))
+                    {
+                        const String *const nextContinuationToken = xmlNodeContent(
+                            xmlNodeChild(xmlRoot, S3_XML_TAG_NEXT_CONTINUATION_TOKEN_STR, true));
+                        CHECK(
+                            FormatError, !strEmpty(nextContinuationToken), S3_XML_TAG_NEXT_CONTINUATION_TOKEN " may not be empty");
+
+                        // Get the first and last names in the page. Names are compared with the final / on paths, which is the
+                        // same order used by S3.
+                        const String *first = NULL;
+                        const String *last = NULL;
+
+                        if (xmlNodeLstSize(subPathList) > 0)
+                        {
+                            first = xmlNodeContent(xmlNodeChild(xmlNodeLstGet(subPathList, 0), S3_XML_TAG_PREFIX_STR, true));
+                            last = xmlNodeContent(
+                                xmlNodeChild(
+                                    xmlNodeLstGet(subPathList, xmlNodeLstSize(subPathList) - 1), S3_XML_TAG_PREFIX_STR, true));
+                        }
+
+                        if (xmlNodeLstSize(fileList) > 0)
+                        {
+                            const String *const fileFirst = xmlNodeContent(
+                                xmlNodeChild(xmlNodeLstGet(fileList, 0), S3_XML_TAG_KEY_STR, true));
+                            const String *const fileLast = xmlNodeContent(
+                                xmlNodeChild(xmlNodeLstGet(fileList, xmlNodeLstSize(fileList) - 1), S3_XML_TAG_KEY_STR, true));
+
+                            if (first == NULL || strCmp(fileFirst, first) < 0)
+                                first = fileFirst;
+
+                            if (last == NULL || strCmp(fileLast, last) > 0)
+                                last = fileLast;
+                        }
+
+                        if (last != NULL)
+                        {
+                            first = strSub(first, strSize(basePrefix));
+                            last = strSub(last, strSize(basePrefix));
+                        }
+
+                        // If this is a large first page then split the rest of the list into ranges and send a request for each
+                        // range. The current range continues up to the first boundary. Small pages are not split since the list
+                        // is likely to be short.
+                        if (rangeIdx == 0 && lstSize(rangeList) == 1 &&
+                            xmlNodeLstSize(subPathList) + xmlNodeLstSize(fileList) >= STORAGE_S3_LIST_RANGE_NAME_MIN)
+                        {
+                            const StringList *const boundaryList = storageListSplit(first, last, STORAGE_S3_LIST_RANGE_MAX);
+
+                            MEM_CONTEXT_OBJ_BEGIN(rangeList)
+                            {
+                                for (unsigned int boundaryIdx = 0; boundaryIdx < strLstSize(boundaryList); boundaryIdx++)
+                                {
+                                    StorageS3ListRange rangeNext =
+                                    {
+                                        .startAfter = strDup(strLstGet(boundaryList, boundaryIdx)),
+                                        .stopAfter =
+                                            boundaryIdx + 1 < strLstSize(boundaryList) ?
+                                                strDup(strLstGet(boundaryList, boundaryIdx + 1)) : NULL,
+                                    };
+
+                                    HttpQuery *const queryNext = storageS3ListQuery(basePrefix, expression, recurse);
+                                    httpQueryAdd(
+                                        queryNext, S3_QUERY_START_AFTER_STR,
+                                        strNewFmt("%s%s", strZ(basePrefix), strZ(rangeNext.startAfter)));
+
+                                    rangeNext.request = storageS3RequestAsyncP(
+                                        this, HTTP_VERB_GET_STR, FSLASH_STR, .query = queryNext);
+
+                                    lstAdd(rangeList, &rangeNext);
+                                }
+
+                                if (!strLstEmpty(boundaryList))
+                                    range.stopAfter = strDup(strLstGet(boundaryList, 0));
+                            }
+                            MEM_CONTEXT_OBJ_END();
+                        }
+
+                        // Get more data unless the range is complete
+                        if (range.stopAfter == NULL || last == NULL || strCmp(last, range.stopAfter) < 0)
+                        {
+                            httpQueryPut(query, S3_QUERY_CONTINUATION_TOKEN_STR, nextContinuationToken);
+
+                            // Store request in the outer temp context
+                            MEM_CONTEXT_PRIOR_BEGIN()
+                            {
+                                request = storageS3RequestAsyncP(this, HTTP_VERB_GET_STR, FSLASH_STR, .query = query);
+                            }
+                            MEM_CONTEXT_PRIOR_END();
+                        }
+                    }
 
-                // Get file list
-                XmlNodeList *fileList = xmlNodeChildList(xmlRoot, S3_XML_TAG_CONTENTS_STR);
+                    // Get prefix list
+                    for (unsigned int subPathIdx = 0; subPathIdx < xmlNodeLstSize(subPathList); subPathIdx++)
+                    {
+                        const XmlNode *subPathNode = xmlNodeLstGet(subPathList, subPathIdx);
 
-                for (unsigned int fileIdx = 0; fileIdx < xmlNodeLstSize(fileList); fileIdx++)
-                {
-                    const XmlNode *fileNode = xmlNodeLstGet(fileList, fileIdx);
+                        // Get path name
+                        StorageInfo info =
+                        {
+                            .level = level,
+                            .name = xmlNodeContent(xmlNodeChild(subPathNode, S3_XML_TAG_PREFIX_STR, true)),
+                            .exists = true,
+                        };
 
-                    // Get file name
-                    StorageInfo info =
-                    {
-                        .level = level,
-                        .name = xmlNodeContent(xmlNodeChild(fileNode, S3_XML_TAG_KEY_STR, true)),
-                        .exists = true,
-                    };
+                        // Skip names that belong to the next range
+                        if (range.stopAfter != NULL && strCmp(strSub(info.name, strSize(basePrefix)), range.stopAfter) > 0)
+                            continue;
 
-                    // Strip off the base prefix when present
-                    if (!strEmpty(basePrefix))
-                        info.name = strSub(info.name, strSize(basePrefix));
+                        // Strip off base prefix and final /
+                        info.name = strSubN(info.name, strSize(basePrefix), strSize(info.name) - strSize(basePrefix) - 1);
 
-                    // Add basic info if requested (no need to add type info since file is default type)
-                    if (level >= storageInfoLevelBasic)
-                    {
-                        info.size = cvtZToUInt64(strZ(xmlNodeContent(xmlNodeChild(fileNode, S3_XML_TAG_SIZE_STR, true))));
-                        info.timeModified = storageS3CvtTime(
-                            xmlNodeContent(xmlNodeChild(fileNode, S3_XML_TAG_LAST_MODIFIED_STR, true)));
+                        // Add type info if requested
+                        if (level >= storageInfoLevelType)
+                            info.type = storageTypePath;
+
+                        // Callback with info
+                        callback(callbackData, &info);
                     }
 
-                    // Callback with info
-                    callback(callbackData, &info);
+                    // Get file list
+                    for (unsigned int fileIdx = 0; fileIdx < xmlNodeLstSize(fileList); fileIdx++)
+                    {
+                        const XmlNode *fileNode = xmlNodeLstGet(fileList, fileIdx);
+
+                        // Get file name
+                        StorageInfo info =
+                        {
+                            .level = level,
+                            .name = xmlNodeContent(xmlNodeChild(fileNode, S3_XML_TAG_KEY_STR, true)),
+                            .exists = true,
+                        };
+
+                        // Strip off the base prefix when present
+                        if (!strEmpty(basePrefix))
+                            info.name = strSub(info.name, strSize(basePrefix));
+
+                        // Skip names that belong to the next range
+                        if (range.stopAfter != NULL && strCmp(info.name, range.stopAfter) > 0)
+                            continue;
+
+                        // Add basic info if requested (no need to add type info since file is default type)
+                        if (level >= storageInfoLevelBasic)
+                        {
+                            info.size = cvtZToUInt64(strZ(xmlNodeContent(xmlNodeChild(fileNode, S3_XML_TAG_SIZE_STR, true))));
+                            info.timeModified = storageS3CvtTime(
+                                xmlNodeContent(xmlNodeChild(fileNode, S3_XML_TAG_LAST_MODIFIED_STR, true)));
+                        }
+
+                        // Callback with info
+                        callback(callbackData, &info);
+                    }
                 }
+                MEM_CONTEXT_TEMP_END();
             }
-            MEM_CONTEXT_TEMP_END();
+            while (request != NULL);
         }
-        while (request != NULL);
     }
     MEM_CONTEXT_TEMP_END();
 
@@ -781,7 +927,7 @@ storageS3Info(THIS_VOID, const String *const file, const StorageInfoLevel level,
         FUNCTION_LOG_PARAM(STORAGE_S3, this);
         FUNCTION_LOG_PARAM(STRING, file);
         FUNCTION_LOG_PARAM(ENUM, level);
-        (void)param;                                                // No parameters are used
+        FUNCTION_LOG_PARAM(BOOL, param.checksum);
     FUNCTION_LOG_END();
 
     ASSERT(this != NULL);
@@ -807,11 +953,95 @@ storageS3Info(THIS_VOID, const String *const file, const StorageInfoLevel level,
         result.timeModified = httpDateToTime(lastModified);
     }
 
+    // Get the checksum from the quoted etag. The etag is only the MD5 of the content when the object was uploaded in a single part
+    // (multipart etags have a part count suffix) and was not encrypted or was encrypted with S3 managed keys (AES256). The
+    // encryption reported for the object is checked rather than the kms option since a bucket may encrypt with KMS by default.
+    const String *const serverSideEncryption =
+        result.exists ? httpHeaderGet(httpResponseHeader(httpResponse), S3_HEADER_SRVSDENC_STR) : NULL;
+
+    if (param.checksum && result.exists &&
+        (serverSideEncryption == NULL || strEq(serverSideEncryption, S3_HEADER_SRVSDENC_AES256_STR)))
+    {
+        const String *const eTag = httpHeaderGet(httpResponseHeader(httpResponse), HTTP_HEADER_ETAG_STR);
+
+        if (eTag != NULL && strSize(eTag) == HASH_TYPE_MD5_SIZE_HEX + 2)
+            result.checksum = strLower(strSubN(eTag, 1, HASH_TYPE_MD5_SIZE_HEX));
+    }
+
     httpResponseFree(httpResponse);
 
     FUNCTION_LOG_RETURN(STORAGE_INFO, result);
 }
 
+/**********************************************************************************************************************************/
+static bool
+storageS3Copy(
+    THIS_VOID, const void *const sourceDriver, const String *const source, const String *const destination,
+    const StorageInterfaceCopyParam param)
+{
+    THIS(StorageS3);
+
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE_S3, this);
+        FUNCTION_LOG_PARAM_P(VOID, sourceDriver);
+        FUNCTION_LOG_PARAM(STRING, source);
+        FUNCTION_LOG_PARAM(STRING, destination);
+        (void)param;                                                // No parameters are used
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(sourceDriver != NULL);
+    ASSERT(source != NULL);
+    ASSERT(destination != NULL);
+
+    const StorageS3 *const sourceS3 = sourceDriver;
+
+    // The request is signed with the credentials of this storage so the source must be readable with the same credentials.
+    // Temporary credentials are compared by role since the keys are renewed independently by each storage.
+    bool result =
+        strEq(this->endPoint, sourceS3->endPoint) && strEq(this->region, sourceS3->region) &&
+        this->keyType == sourceS3->keyType &&
+        (this->keyType == storageS3KeyTypeShared ?
+            strEq(this->accessKey, sourceS3->accessKey) :
+            strEq(this->credRole, sourceS3->credRole) && strEq(this->webIdToken, sourceS3->webIdToken));
+
+    if (result)
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            // CopyObject cannot copy an object larger than 5GiB so larger objects are left to the caller. The size is checked with
+            // the source driver since the source may be in another bucket.
+            const StorageInfo info = storageS3Info(
+                (void *)sourceS3, source, storageInfoLevelBasic, (StorageInterfaceInfoParam){VAR_PARAM_INIT});
+
+            if (info.size > STORAGE_S3_COPY_SIZE_MAX)
+            {
+                result = false;
+            }
+            // Else copy the object with CopyObject
+            else
+            {
+                HttpHeader *const header = httpHeaderAdd(
+                    httpHeaderNew(NULL), S3_HEADER_COPY_SOURCE_STR,
+                    httpUriEncode(strNewFmt("/%s%s", strZ(sourceS3->bucket), strZ(source)), true));
+                HttpRequest *const request = storageS3RequestAsyncP(
+                    this, HTTP_VERB_PUT_STR, destination, .header = header, .sseKms = true);
+                HttpResponse *const response = storageS3ResponseP(request);
+
+                // Error if there is no etag in the result. This indicates that the request did not succeed despite the success
+                // code.
+                const XmlNode *const copyResult = xmlDocumentRoot(xmlDocumentNewBuf(httpResponseContent(response)));
+
+                if (xmlNodeChild(copyResult, S3_XML_TAG_COPY_ETAG_STR, false) == NULL)
+                    httpRequestError(request, response);
+            }
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    FUNCTION_LOG_RETURN(BOOL, result);
+}
+
 /**********************************************************************************************************************************/
 static void
 storageS3ListCallback(void *const callbackData, const StorageInfo *const info)
@@ -846,11 +1076,66 @@ storageS3List(THIS_VOID, const String *const path, const StorageInfoLevel level,
 
     StorageList *const result = storageLstNew(level);
 
-    storageS3ListInternal(this, path, level, param.expression, false, storageS3ListCallback, result);
+    storageS3ListInternal(this, path, level, param.expression, false, NULL, storageS3ListCallback, result);
 
     FUNCTION_LOG_RETURN(STORAGE_LIST, result);
 }
 
+static List *
+storageS3ListMulti(
+    THIS_VOID, const StringList *const pathList, const StorageInfoLevel level, const StorageInterfaceListParam param)
+{
+    THIS(StorageS3);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_S3, this);
+        FUNCTION_LOG_PARAM(STRING_LIST, pathList);
+        FUNCTION_LOG_PARAM(ENUM, level);
+        FUNCTION_LOG_PARAM(STRING, param.expression);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(pathList != NULL);
+
+    List *const result = lstNewP(sizeof(StorageList *));
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Send the first request for each path before waiting on any responses so the requests are processed concurrently
+        List *const requestList = lstNewP(sizeof(HttpRequest *));
+
+        for (unsigned int pathIdx = 0; pathIdx < strLstSize(pathList); pathIdx++)
+        {
+            const String *const basePrefix = storageS3ListBasePrefix(strLstGet(pathList, pathIdx));
+            HttpRequest *const request = storageS3RequestAsyncP(
+                this, HTTP_VERB_GET_STR, FSLASH_STR, .query = storageS3ListQuery(basePrefix, param.expression, false));
+
+            lstAdd(requestList, &request);
+        }
+
+        // Get the responses (and any remaining requests) in the same order as the paths
+        for (unsigned int pathIdx = 0; pathIdx < strLstSize(pathList); pathIdx++)
+        {
+            StorageList *list;
+
+            MEM_CONTEXT_OBJ_BEGIN(result)
+            {
+                list = storageLstNew(level);
+            }
+            MEM_CONTEXT_OBJ_END();
+
+            storageS3ListInternal(
+                this, strLstGet(pathList, pathIdx), level, param.expression, false, *(HttpRequest **)lstGet(requestList, pathIdx),
+                storageS3ListCallback, list);
+
+            lstAdd(result, &list);
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(LIST, result);
+}
+
 /**********************************************************************************************************************************/
 static StorageRead *
 storageS3NewRead(THIS_VOID, const String *file, bool ignoreMissing, StorageInterfaceNewReadParam param)
@@ -890,7 +1175,7 @@ storageS3NewWrite(THIS_VOID, const String *file, StorageInterfaceNewWriteParam p
     ASSERT(param.group == NULL);
     ASSERT(param.timeModified == 0);
 
-    FUNCTION_LOG_RETURN(STORAGE_WRITE, storageWriteS3New(this, file, this->partSize));
+    FUNCTION_LOG_RETURN(STORAGE_WRITE, storageWriteS3New(this, file, this->partSize, param.resume));
 }
 
 /**********************************************************************************************************************************/
@@ -1040,7 +1325,7 @@ storageS3PathRemove(THIS_VOID, const String *path, bool recurse, StorageInterfac
             .path = strEq(path, FSLASH_STR) ? EMPTY_STR : strNewFmt("%s/", strZ(strSub(path, 1))),
         };
 
-        storageS3ListInternal(this, path, storageInfoLevelType, NULL, true, storageS3PathRemoveCallback, &data);
+        storageS3ListInternal(this, path, storageInfoLevelType, NULL, true, NULL, storageS3PathRemoveCallback, &data);
 
         // Call if there is more to be removed
         if (data.xml != NULL)
@@ -1078,8 +1363,10 @@ storageS3Remove(THIS_VOID, const String *const file, const StorageInterfaceRemov
 /**********************************************************************************************************************************/
 static const StorageInterface storageInterfaceS3 =
 {
+    .copy = storageS3Copy,
     .info = storageS3Info,
     .list = storageS3List,
+    .listMulti = storageS3ListMulti,
     .newRead = storageS3NewRead,
     .newWrite = storageS3NewWrite,
     .pathRemove = storageS3PathRemove,
@@ -1140,6 +1427,7 @@ storageS3New(
             .partSize = partSize,
             .deleteMax = STORAGE_S3_DELETE_MAX,
             .uriStyle = uriStyle,
+            .endPoint = strDup(endPoint),
             .bucketEndpoint = uriStyle == storageS3UriStyleHost ?
                 strNewFmt("%s.%s", strZ(bucket), strZ(endPoint)) : strDup(endPoint),
 
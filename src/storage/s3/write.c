@@ -26,6 +26,11 @@ STRING_STATIC(S3_XML_TAG_COMPLETE_MULTIPART_UPLOAD_STR,             "CompleteMul
 STRING_STATIC(S3_XML_TAG_PART_STR,                                  "Part");
 STRING_STATIC(S3_XML_TAG_PART_NUMBER_STR,                           "PartNumber");
 
+/***********************************************************************************************************************************
+Minimum size of all parts except the last
+***********************************************************************************************************************************/
+#define STORAGE_S3_PART_SIZE_MIN                                    ((size_t)5 * 1024 * 1024)
+
 /***********************************************************************************************************************************
 Object type
 ***********************************************************************************************************************************/
@@ -39,6 +44,8 @@ typedef struct StorageWriteS3
     Buffer *partBuffer;
     const String *uploadId;
     StringList *uploadPartList;
+    uint64_t size;                                                  // Bytes written to the part buffer or uploaded
+    uint64_t skip;                                                  // Bytes left to skip because they have already been uploaded
 } StorageWriteS3;
 
 /***********************************************************************************************************************************
@@ -174,14 +181,22 @@ storageWriteS3(THIS_VOID, const Buffer *buffer)
 
     size_t bytesTotal = 0;
 
+    // Skip data that has already been uploaded when resuming
+    if (this->skip > 0)
+    {
+        bytesTotal = this->skip < bufUsed(buffer) ? (size_t)this->skip : bufUsed(buffer);
+        this->skip -= bytesTotal;
+    }
+
     // Continue until the write buffer has been exhausted
-    do
+    while (bytesTotal != bufUsed(buffer))
     {
         // Copy as many bytes as possible into the part buffer
         size_t bytesNext = bufRemains(this->partBuffer) > bufUsed(buffer) - bytesTotal ?
             bufUsed(buffer) - bytesTotal : bufRemains(this->partBuffer);
         bufCatSub(this->partBuffer, buffer, bytesTotal, bytesNext);
         bytesTotal += bytesNext;
+        this->size += bytesNext;
 
         // If the part buffer is full then write it
         if (bufRemains(this->partBuffer) == 0)
@@ -190,7 +205,91 @@ storageWriteS3(THIS_VOID, const Buffer *buffer)
             bufUsedZero(this->partBuffer);
         }
     }
-    while (bytesTotal != bufUsed(buffer));
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Upload the part buffer and return the multi-part upload state so the file can be resumed
+***********************************************************************************************************************************/
+static Pack *
+storageWriteS3Checkpoint(THIS_VOID)
+{
+    THIS(StorageWriteS3);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_WRITE_S3, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->partBuffer != NULL);
+    ASSERT(this->skip == 0);
+
+    Pack *result = NULL;
+
+    // All parts except the last must be at least the minimum part size so the part buffer can only be uploaded when it is large
+    // enough. Otherwise no checkpoint can be made until more data has been written.
+    if (bufEmpty(this->partBuffer) || bufUsed(this->partBuffer) >= STORAGE_S3_PART_SIZE_MIN)
+    {
+        if (!bufEmpty(this->partBuffer))
+        {
+            storageWriteS3PartAsync(this);
+            bufUsedZero(this->partBuffer);
+        }
+
+        // Wait for the last part to be uploaded
+        storageWriteS3Part(this);
+
+        // The upload id and part list are required to resume the upload
+        if (this->uploadId != NULL)
+        {
+            PackWrite *const pack = pckWriteNewP();
+
+            pckWriteStrP(pack, this->uploadId);
+            pckWriteStrLstP(pack, this->uploadPartList);
+            pckWriteU64P(pack, this->size);
+            pckWriteEndP(pack);
+
+            result = pckWriteResult(pack);
+        }
+    }
+
+    FUNCTION_LOG_RETURN(PACK, result);
+}
+
+/***********************************************************************************************************************************
+Abort the multi-part upload so the parts already uploaded are not kept
+***********************************************************************************************************************************/
+static void
+storageWriteS3Abort(THIS_VOID)
+{
+    THIS(StorageWriteS3);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_WRITE_S3, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    // Discard the outstanding part request, if any, since the part will be removed with the upload
+    httpRequestFree(this->request);
+    this->request = NULL;
+
+    // The upload may already be missing, e.g. when it was removed by a lifecycle rule and that is why the write failed
+    if (this->uploadId != NULL)
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            storageS3RequestP(
+                this->storage, HTTP_VERB_DELETE_STR, this->interface.name,
+                .query = httpQueryAdd(httpQueryNewP(), S3_QUERY_UPLOAD_ID_STR, this->uploadId), .allowMissing = true);
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    // The file cannot be closed after it has been aborted
+    bufFree(this->partBuffer);
+    this->partBuffer = NULL;
 
     FUNCTION_LOG_RETURN_VOID();
 }
@@ -266,11 +365,14 @@ storageWriteS3Close(THIS_VOID)
 
 /**********************************************************************************************************************************/
 StorageWrite *
-storageWriteS3New(StorageS3 *storage, const String *name, size_t partSize)
+storageWriteS3New(
+    StorageS3 *const storage, const String *const name, const size_t partSize, const Pack *const resume)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(STORAGE_S3, storage);
         FUNCTION_LOG_PARAM(STRING, name);
+        FUNCTION_LOG_PARAM(SIZE, partSize);
+        FUNCTION_LOG_PARAM(PACK, resume);
     FUNCTION_LOG_END();
 
     ASSERT(storage != NULL);
@@ -302,9 +404,23 @@ storageWriteS3New(StorageS3 *storage, const String *name, size_t partSize)
                     .open = storageWriteS3Open,
                     .write = storageWriteS3,
                 },
+
+                .checkpoint = storageWriteS3Checkpoint,
+                .abort = storageWriteS3Abort,
             },
         };
 
+        // Continue the multi-part upload from the checkpoint
+        if (resume != NULL)
+        {
+            PackRead *const read = pckReadNew(resume);
+
+            driver->uploadId = pckReadStrP(read);
+            driver->uploadPartList = pckReadStrLstP(read);
+            driver->size = pckReadU64P(read);
+            driver->skip = driver->size;
+        }
+
         this = storageWriteNew(driver, &driver->interface);
     }
     OBJ_NEW_END();
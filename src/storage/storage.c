@@ -92,6 +92,54 @@ storageNew(
     FUNCTION_LOG_RETURN(STORAGE, this);
 }
 
+/**********************************************************************************************************************************/
+// Characters used to build range boundaries in sort order. These are the characters that commonly appear in repository file names.
+#define STORAGE_LIST_SPLIT_CHAR                                     "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"
+
+StringList *
+storageListSplit(const String *const first, const String *const last, const unsigned int max)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, first);
+        FUNCTION_TEST_PARAM(STRING, last);
+        FUNCTION_TEST_PARAM(UINT, max);
+    FUNCTION_TEST_END();
+
+    ASSERT(first != NULL);
+    ASSERT(last != NULL);
+    ASSERT(max > 0);
+
+    StringList *const result = strLstNew();
+
+    // Find the first character where the first and last names differ. The names that follow last most likely differ from it at the
+    // same position, so the boundaries are built by incrementing the character at that position.
+    size_t diffIdx = 0;
+
+    while (diffIdx < strSize(first) && diffIdx < strSize(last) && strZ(first)[diffIdx] == strZ(last)[diffIdx])
+        diffIdx++;
+
+    if (diffIdx < strSize(last))
+    {
+        // Find the characters that sort after the character in last
+        const char *charList = STORAGE_LIST_SPLIT_CHAR;
+
+        while (*charList != '\0' && *charList <= strZ(last)[diffIdx])
+            charList++;
+
+        // Spread the boundaries evenly over the remaining characters
+        const unsigned int charTotal = (unsigned int)strlen(charList);
+        const unsigned int boundaryTotal = charTotal < max ? charTotal : max;
+
+        for (unsigned int boundaryIdx = 0; boundaryIdx < boundaryTotal; boundaryIdx++)
+        {
+            strLstAddFmt(
+                result, "%.*s%c", (int)diffIdx, strZ(last), charList[(size_t)boundaryIdx * charTotal / boundaryTotal]);
+        }
+    }
+
+    FUNCTION_TEST_RETURN(STRING_LIST, result);
+}
+
 /**********************************************************************************************************************************/
 bool
 storageCopy(StorageRead *source, StorageWrite *destination)
@@ -130,6 +178,42 @@ storageCopy(StorageRead *source, StorageWrite *destination)
     FUNCTION_LOG_RETURN(BOOL, result);
 }
 
+/**********************************************************************************************************************************/
+bool
+storageCopyServer(
+    const Storage *const source, const String *const fileSourceExp, const Storage *const destination,
+    const String *const fileDestinationExp)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE, source);
+        FUNCTION_LOG_PARAM(STRING, fileSourceExp);
+        FUNCTION_LOG_PARAM(STORAGE, destination);
+        FUNCTION_LOG_PARAM(STRING, fileDestinationExp);
+    FUNCTION_LOG_END();
+
+    ASSERT(source != NULL);
+    ASSERT(fileSourceExp != NULL);
+    ASSERT(destination != NULL);
+    ASSERT(destination->write);
+    ASSERT(fileDestinationExp != NULL);
+
+    bool result = false;
+
+    // The copy can only be done by the server when both storages are the same type
+    if (destination->pub.interface.copy != NULL && storageType(source) == storageType(destination))
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            result = storageInterfaceCopyP(
+                storageDriver(destination), storageDriver(source), storagePathP(source, fileSourceExp),
+                storagePathP(destination, fileDestinationExp));
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    FUNCTION_LOG_RETURN(BOOL, result);
+}
+
 /**********************************************************************************************************************************/
 bool
 storageExists(const Storage *this, const String *pathExp, StorageExistsParam param)
@@ -234,6 +318,7 @@ storageInfo(const Storage *this, const String *fileExp, StorageInfoParam param)
         FUNCTION_LOG_PARAM(BOOL, param.ignoreMissing);
         FUNCTION_LOG_PARAM(BOOL, param.followLink);
         FUNCTION_LOG_PARAM(BOOL, param.noPathEnforce);
+        FUNCTION_LOG_PARAM(BOOL, param.checksum);
     FUNCTION_LOG_END();
 
     ASSERT(this != NULL);
@@ -258,7 +343,10 @@ storageInfo(const Storage *this, const String *fileExp, StorageInfoParam param)
         }
         // Else call the driver
         else
-            result = storageInterfaceInfoP(storageDriver(this), file, param.level, .followLink = param.followLink);
+        {
+            result = storageInterfaceInfoP(
+                storageDriver(this), file, param.level, .followLink = param.followLink, .checksum = param.checksum);
+        }
 
         // Error if the file missing and not ignoring
         if (!result.exists && !param.ignoreMissing)
@@ -270,6 +358,7 @@ storageInfo(const Storage *this, const String *fileExp, StorageInfoParam param)
             result.linkDestination = strDup(result.linkDestination);
             result.user = strDup(result.user);
             result.group = strDup(result.group);
+            result.checksum = strDup(result.checksum);
         }
         MEM_CONTEXT_PRIOR_END();
     }
@@ -443,10 +532,16 @@ storageNewWrite(const Storage *this, const String *fileExp, StorageNewWriteParam
         FUNCTION_LOG_PARAM(BOOL, param.noSyncPath);
         FUNCTION_LOG_PARAM(BOOL, param.noAtomic);
         FUNCTION_LOG_PARAM(BOOL, param.compressible);
+        FUNCTION_LOG_PARAM(BOOL, param.sparse);
+        FUNCTION_LOG_PARAM(PACK, param.resume);
+        FUNCTION_LOG_PARAM(BOOL, param.noTruncate);
+        FUNCTION_LOG_PARAM(UINT64, param.offset);
     FUNCTION_LOG_END();
 
     ASSERT(this != NULL);
     ASSERT(this->write);
+    ASSERT(param.offset == 0 || param.noTruncate);
+    ASSERT(!param.noTruncate || (param.noAtomic && param.resume == NULL));
 
     StorageWrite *result = NULL;
 
@@ -457,7 +552,8 @@ storageNewWrite(const Storage *this, const String *fileExp, StorageNewWriteParam
                 storageDriver(this), storagePathP(this, fileExp), .modeFile = param.modeFile != 0 ? param.modeFile : this->modeFile,
                 .modePath = param.modePath != 0 ? param.modePath : this->modePath, .user = param.user, .group = param.group,
                 .timeModified = param.timeModified, .createPath = !param.noCreatePath, .syncFile = !param.noSyncFile,
-                .syncPath = !param.noSyncPath, .atomic = !param.noAtomic, .compressible = param.compressible),
+                .syncPath = !param.noSyncPath, .atomic = !param.noAtomic, .compressible = param.compressible,
+                .sparse = param.sparse, .resume = param.resume, .noTruncate = param.noTruncate, .offset = param.offset),
             memContextPrior());
     }
     MEM_CONTEXT_TEMP_END();
@@ -56,6 +56,15 @@ Functions
 
 bool storageCopy(StorageRead *source, StorageWrite *destination);
 
+// Copy a file from another storage on the server, e.g. with an object store server-side copy, so the data does not pass through
+// this process. Returns false when the storage types differ or the driver cannot copy between the storages, in which case the
+// caller must copy the file with storageCopyP().
+#define storageCopyServerP(source, fileSourceExp, destination, fileDestinationExp)                                                 \
+    storageCopyServer(source, fileSourceExp, destination, fileDestinationExp)
+
+bool storageCopyServer(
+    const Storage *source, const String *fileSourceExp, const Storage *destination, const String *fileDestinationExp);
+
 // Does a file exist? This function is only for files, not paths.
 typedef struct StorageExistsParam
 {
@@ -88,6 +97,7 @@ typedef struct StorageInfoParam
     bool ignoreMissing;
     bool followLink;
     bool noPathEnforce;
+    bool checksum;                                                  // Get the MD5 checksum of the file if the storage provides it?
 } StorageInfoParam;
 
 #define storageInfoP(this, fileExp, ...)                                                                                           \
@@ -160,11 +170,15 @@ typedef struct StorageNewWriteParam
     bool noSyncPath;
     bool noAtomic;
     bool compressible;
+    bool sparse;                                                    // Write all-zero blocks as holes (when supported by storage)?
     mode_t modeFile;
     mode_t modePath;
     time_t timeModified;
     const String *user;
     const String *group;
+    const Pack *resume;                                             // Resume from a state returned by storageWriteCheckpoint()
+    bool noTruncate;                                                // Write into an existing file without truncating it?
+    uint64_t offset;                                                // Where to start writing in the file (requires noTruncate)
 } StorageNewWriteParam;
 
 #define storageNewWriteP(this, pathExp, ...)                                                                                       \
@@ -3,9 +3,9 @@ Storage Interface Internal
 
 Storage drivers are implemented using this interface.
 
-The interface has required and optional functions. Currently the optional functions are only implemented by the Posix driver which
+The interface has required and optional functions. Currently the optional functions are mostly implemented by the Posix driver which
 can store either a repository or a PostgreSQL cluster. Drivers that are intended to store repositories only need to implement the
-required functions.
+required functions, though object store drivers implement listMulti() to reduce the impact of request latency.
 
 The behavior of required functions is further modified by storage features defined by the StorageFeature enum. Details are included
 in the description of each function.
@@ -14,6 +14,7 @@ in the description of each function.
 #define STORAGE_STORAGE_INTERN_H
 
 #include "common/type/param.h"
+#include "common/type/stringList.h"
 #include "storage/info.h"
 #include "storage/list.h"
 #include "storage/read.h"
@@ -78,6 +79,10 @@ typedef struct StorageInterfaceInfoParam
 
     // Should symlinks be followed?  Only required on storage that supports symlinks.
     bool followLink;
+
+    // Should the MD5 checksum of the file be returned? Only required on storage that stores a checksum with the file, e.g. object
+    // stores, and only when the checksum is known to be the MD5 of the file content.
+    bool checksum;
 } StorageInterfaceInfoParam;
 
 typedef StorageInfo StorageInterfaceInfo(
@@ -141,6 +146,20 @@ typedef struct StorageInterfaceNewWriteParam
 
     // Is the file compressible?  This is used when the file must be moved across a network and temporary compression is helpful.
     bool compressible;
+
+    // Write blocks that are all zero as holes. This is only a hint and storage that does not support holes may ignore it.
+    bool sparse;
+
+    // Resume a partial write from state returned by the checkpoint() write interface function. The caller must write the file again
+    // from the beginning and the driver will skip the bytes that were durable at the checkpoint, which allows the caller to verify
+    // that the same bytes are being written. Only passed to drivers that implement checkpoint().
+    const Pack *resume;
+
+    // Write into the file at the offset without truncating the file so separate parts of the file can be written concurrently. The
+    // file is created when missing and extended as needed but never made smaller, so the caller must set the final size if the file
+    // might already be larger. The write must not be atomic. Only supported by posix storage.
+    bool noTruncate;
+    uint64_t offset;
 } StorageInterfaceNewWriteParam;
 
 typedef StorageWrite *StorageInterfaceNewWrite(void *thisVoid, const String *file, StorageInterfaceNewWriteParam param);
@@ -204,6 +223,39 @@ typedef void StorageInterfaceRemove(void *thisVoid, const String *file, StorageI
 /***********************************************************************************************************************************
 Optional interface functions
 ***********************************************************************************************************************************/
+// Get info for all files/links/paths in multiple paths
+//
+// Drivers that require one or more high latency requests to list a path (e.g. object stores) can implement this function to list
+// the paths concurrently. The result is a List of StorageList pointers in the same order as pathList. A StorageList pointer may be
+// NULL if the path does not exist, in the same way as storageInterfaceListP(). See storageInterfaceListP() for usage of the level
+// and param parameters.
+typedef List *StorageInterfaceListMulti(
+    void *thisVoid, const StringList *pathList, StorageInfoLevel level, StorageInterfaceListParam param);
+
+#define storageInterfaceListMultiP(thisVoid, pathList, level, ...)                                                                 \
+    STORAGE_COMMON_INTERFACE(thisVoid).listMulti(                                                                                  \
+        thisVoid, pathList, level, (StorageInterfaceListParam){VAR_PARAM_INIT, __VA_ARGS__})
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Copy a file from another storage of the same type without the data passing through this process, e.g. an object store
+// server-side copy
+//
+// The source driver is always the same type as this driver. Return false when the copy cannot be done by the server, e.g. the
+// source storage is in a different account or uses different credentials, and the caller will copy the file another way. Errors
+// should be thrown only when the copy was attempted and failed.
+typedef struct StorageInterfaceCopyParam
+{
+    VAR_PARAM_HEADER;
+} StorageInterfaceCopyParam;
+
+typedef bool StorageInterfaceCopy(
+    void *thisVoid, const void *sourceDriver, const String *source, const String *destination, StorageInterfaceCopyParam param);
+
+#define storageInterfaceCopyP(thisVoid, sourceDriver, source, destination, ...)                                                    \
+    STORAGE_COMMON_INTERFACE(thisVoid).copy(                                                                                       \
+        thisVoid, sourceDriver, source, destination, (StorageInterfaceCopyParam){VAR_PARAM_INIT, __VA_ARGS__})
+
+// ---------------------------------------------------------------------------------------------------------------------------------
 // Move a path/file atomically
 typedef struct StorageInterfaceMoveParam
 {
@@ -275,6 +327,8 @@ typedef struct StorageInterface
     StorageInterfaceRemove *remove;
 
     // Optional functions
+    StorageInterfaceCopy *copy;
+    StorageInterfaceListMulti *listMulti;
     StorageInterfaceMove *move;
     StorageInterfacePathCreate *pathCreate;
     StorageInterfacePathSync *pathSync;
@@ -287,6 +341,16 @@ Storage *storageNew(
     StringId type, const String *path, mode_t modeFile, mode_t modePath, bool write,
     StoragePathExpressionCallback pathExpressionFunction, void *driver, StorageInterface interface);
 
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+// Get names that split the remainder of a list into ranges that can be listed concurrently. Drivers that can start a list after a
+// name (e.g. S3 start-after) use this when the first page of a list is truncated. The first and last names in the first page are
+// used to guess how the remaining names are distributed. Each returned name sorts after last and the list is in ascending order.
+// The ranges are (last, name 1], (name 1, name 2], ..., (name n, end) so every name is listed exactly once no matter how good the
+// guess was. An empty list is returned when no boundaries can be found.
+StringList *storageListSplit(const String *first, const String *last, unsigned int max);
+
 /***********************************************************************************************************************************
 Common members to include in every storage driver and macros to extract the common elements
 ***********************************************************************************************************************************/
@@ -56,6 +56,43 @@ storageWriteNew(void *driver, const StorageWriteInterface *interface)
     FUNCTION_LOG_RETURN(STORAGE_WRITE, this);
 }
 
+/**********************************************************************************************************************************/
+void
+storageWriteAbort(StorageWrite *const this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_WRITE, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    if (this->pub.interface->abort != NULL)
+        this->pub.interface->abort(this->driver);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+Pack *
+storageWriteCheckpoint(StorageWrite *const this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_WRITE, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    Pack *result = NULL;
+
+    if (this->pub.interface->checkpoint != NULL)
+    {
+        ioWriteFlush(storageWriteIo(this));
+        result = this->pub.interface->checkpoint(this->driver);
+    }
+
+    FUNCTION_LOG_RETURN(PACK, result);
+}
+
 /**********************************************************************************************************************************/
 String *
 storageWriteToLog(const StorageWrite *this)
@@ -19,6 +19,15 @@ typedef struct StorageWrite StorageWrite;
 /***********************************************************************************************************************************
 Functions
 ***********************************************************************************************************************************/
+// Discard the data written so far without completing the file, e.g. abort an incomplete multi-part upload so the storage does not
+// keep the parts. The write must be freed afterward since it cannot be used again.
+void storageWriteAbort(StorageWrite *this);
+
+// Flush data written so far and make it durable without completing the file. Returns state that can be passed as the resume
+// parameter to storageNewWriteP() to continue the file after a failure, or NULL when the storage does not support checkpoints or a
+// checkpoint cannot be made at the current position.
+Pack *storageWriteCheckpoint(StorageWrite *this);
+
 // Move to a new parent mem context
 FN_INLINE_ALWAYS StorageWrite *
 storageWriteMove(StorageWrite *const this, MemContext *const parentNew)
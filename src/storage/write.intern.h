@@ -5,6 +5,7 @@ Storage Write Interface Internal
 #define STORAGE_WRITE_INTERN_H
 
 #include "common/io/write.h"
+#include "common/type/pack.h"
 #include "version.h"
 
 /***********************************************************************************************************************************
@@ -29,10 +30,19 @@ typedef struct StorageWriteInterface
     mode_t modePath;
     bool syncFile;
     bool syncPath;
+    bool sparse;                                                    // Write all-zero blocks as holes?
     time_t timeModified;                                            // Time file was last modified
     const String *user;                                             // User that owns the file
 
     IoWriteInterface ioInterface;
+
+    // Make all data written so far durable without completing the file and return state that can be passed as the resume parameter
+    // to newWrite() to continue the file later. Return NULL when no checkpoint can be made at the current position. Optional.
+    Pack *(*checkpoint)(void *driver);
+
+    // Discard the data written so far without completing the file. Optional when the storage does not keep data for a file that is
+    // never closed.
+    void (*abort)(void *driver);
 } StorageWriteInterface;
 
 StorageWrite *storageWriteNew(void *driver, const StorageWriteInterface *interface);
@@ -0,0 +1,65 @@
+/***********************************************************************************************************************************
+Harness for Backup Testing
+***********************************************************************************************************************************/
+#include "build.auto.h"
+
+#include "common/harnessBackup.h"
+#include "common/harnessDebug.h"
+
+/***********************************************************************************************************************************
+Include shimmed C modules
+***********************************************************************************************************************************/
+{[SHIM_MODULE]}
+
+/***********************************************************************************************************************************
+Shim install state
+***********************************************************************************************************************************/
+static struct
+{
+    bool dedupMoveShim;                                             // Is the dedup move shim installed?
+    const char *dedupContent;                                       // Content to store or NULL to leave the store file missing
+} hrnBackupStatic;
+
+/***********************************************************************************************************************************
+Shim backupFileDedupMove() to remove the temp file as detailed in the hrnBackupDedupMoveShimInstall() documentation.
+***********************************************************************************************************************************/
+static bool
+backupFileDedupMove(const String *const tempFile, const String *const dedupFile)
+{
+    if (hrnBackupStatic.dedupMoveShim)
+    {
+        storageRemoveP(storageRepoWrite(), tempFile, .errorOnMissing = true);
+
+        if (hrnBackupStatic.dedupContent != NULL)
+            storagePutP(storageNewWriteP(storageRepoWrite(), dedupFile), BUFSTRZ(hrnBackupStatic.dedupContent));
+
+        hrnBackupDedupMoveShimUninstall();
+    }
+
+    return backupFileDedupMove_SHIMMED(tempFile, dedupFile);
+}
+
+/**********************************************************************************************************************************/
+void
+hrnBackupDedupMoveShimInstall(const char *const content)
+{
+    FUNCTION_HARNESS_BEGIN();
+        FUNCTION_HARNESS_PARAM(STRINGZ, content);
+    FUNCTION_HARNESS_END();
+
+    hrnBackupStatic.dedupMoveShim = true;
+    hrnBackupStatic.dedupContent = content;
+
+    FUNCTION_HARNESS_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+void
+hrnBackupDedupMoveShimUninstall(void)
+{
+    FUNCTION_HARNESS_VOID();
+
+    hrnBackupStatic.dedupMoveShim = false;
+
+    FUNCTION_HARNESS_RETURN_VOID();
+}
@@ -0,0 +1,13 @@
+/***********************************************************************************************************************************
+Harness for Backup Testing
+***********************************************************************************************************************************/
+#include "common/type/string.h"
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+// Install/uninstall the shim that removes the temp file just before it is moved into the dedup store by backupFile(). This allows
+// testing a temp file that is missing when it is moved. When content is not NULL the dedup store file is written with the content
+// to simulate another process storing the same content. The shim is uninstalled after the temp file has been removed.
+void hrnBackupDedupMoveShimInstall(const char *content);
+void hrnBackupDedupMoveShimUninstall(void);
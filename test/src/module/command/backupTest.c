@@ -3,12 +3,14 @@ Test Backup Command
 ***********************************************************************************************************************************/
 #include "command/stanza/create.h"
 #include "command/stanza/upgrade.h"
+#include "common/crypto/cipherBlock.h"
 #include "common/crypto/hash.h"
 #include "common/io/bufferWrite.h"
 #include "postgres/interface/static.vendor.h"
 #include "storage/helper.h"
 #include "storage/posix/storage.h"
 
+#include "common/harnessBackup.h"
 #include "common/harnessConfig.h"
 #include "common/harnessPostgres.h"
 #include "common/harnessPq.h"
@@ -64,6 +66,8 @@ testBackupValidateList(
                 // -----------------------------------------------------------------------------------------------------------------
                 List *const fileList = lstNewP(sizeof(ManifestFilePack **));
                 bool bundle = strBeginsWithZ(info.name, "bundle/");
+                bool split = false;
+                unsigned int splitPartIdx = 0;
 
                 if (bundle)
                 {
@@ -87,6 +91,16 @@ testBackupValidateList(
                             info.name, 0, strSize(info.name) - strSize(compressExtStr(manifestData->backupOptionCompressType)));
                     }
 
+                    // Get the manifest name and part of a split file
+                    const char *const splitPart = strstr(strZ(manifestName), "." PROJECT_BIN ".part.");
+
+                    if (splitPart != NULL)
+                    {
+                        split = true;
+                        splitPartIdx = cvtZToUInt(splitPart + sizeof("." PROJECT_BIN ".part.") - 1);
+                        manifestName = strSubN(manifestName, 0, (size_t)(splitPart - strZ(manifestName)));
+                    }
+
                     ManifestFilePack **const filePack = manifestFilePackFindInternal(manifest, manifestName);
                     lstAdd(fileList, &filePack);
                 }
@@ -98,6 +112,10 @@ testBackupValidateList(
                     ManifestFilePack **const filePack = *(ManifestFilePack ***)lstGet(fileList, fileIdx);
                     ManifestFile file = manifestFileUnpack(manifest, *filePack);
 
+                    // A part of a split file is checked against the checksum and size of the part
+                    const char *const checksumExpected = split ? strZ(manifestSplitChecksum(&file, splitPartIdx)) : file.checksumSha1;
+                    const uint64_t sizeExpected = split ? manifestSplitSize(&file, splitPartIdx) : file.size;
+
                     if (bundle)
                         strCatFmt(result, "%s/%s {file", strZ(info.name), strZ(file.name));
                     else
@@ -123,23 +141,42 @@ testBackupValidateList(
 
                     strCatFmt(result, ", s=%" PRIu64, size);
 
-                    if (!strEqZ(checksum, file.checksumSha1))
+                    if (!strEqZ(checksum, checksumExpected))
                         THROW_FMT(AssertError, "'%s' checksum does match manifest", strZ(file.name));
 
                     // Test size and repo-size. If compressed then set the repo-size to size so it will not be in test output. Even
                     // the same compression algorithm can give slightly different results based on the version so repo-size is not
                     // deterministic for compression.
                     // -------------------------------------------------------------------------------------------------------------
-                    if (size != file.size)
+                    if (size != sizeExpected)
                         THROW_FMT(AssertError, "'%s' size does match manifest", strZ(file.name));
 
-                    // Repo size can only be compared to file size when not bundled
-                    if (!bundle)
+                    // Repo size can only be compared to file size when not bundled or split
+                    if (!bundle && !split)
                     {
                         if (info.size != file.sizeRepo)
                             THROW_FMT(AssertError, "'%s' repo size does match manifest", strZ(file.name));
                     }
 
+                    // Test repo checksum and remove it since it is not deterministic for compression
+                    if (file.checksumRepo[0] != 0)
+                    {
+                        read = storageNewReadP(
+                            storage, strNewFmt("%s/%s", strZ(path), strZ(info.name)), .offset = file.bundleOffset,
+                            .limit = VARUINT64(file.sizeRepo));
+                        ioFilterGroupAdd(ioReadFilterGroup(storageReadIo(read)), cryptoHashNew(hashTypeMd5));
+                        storageGetP(read);
+
+                        if (!strEqZ(
+                                pckReadStrP(ioFilterGroupResultP(ioReadFilterGroup(storageReadIo(read)), CRYPTO_HASH_FILTER_TYPE)),
+                                file.checksumRepo))
+                        {
+                            THROW_FMT(AssertError, "'%s' repo checksum does match manifest", strZ(file.name));
+                        }
+
+                        file.checksumRepo[0] = '\0';
+                    }
+
                     if (manifestData->backupOptionCompressType != compressTypeNone)
                         file.sizeRepo = file.size;
 
@@ -752,7 +789,7 @@ testRun(void)
         IoWrite *write = ioBufferWriteNew(bufferOut);
         ioFilterGroupAdd(
             ioWriteFilterGroup(write),
-            pageChecksumNewPack(ioFilterParamList(pageChecksumNew(0, PG_SEGMENT_PAGE_DEFAULT, STRDEF(BOGUS_STR)))));
+            pageChecksumNewPack(ioFilterParamList(pageChecksumNew(0, PG_SEGMENT_PAGE_DEFAULT, 0, STRDEF(BOGUS_STR)))));
         ioWriteOpen(write);
         ioWrite(write, buffer);
         TEST_ERROR(ioWrite(write, buffer), AssertError, "should not be possible to see two misaligned pages in a row");
@@ -782,7 +819,7 @@ testRun(void)
 
         write = ioBufferWriteNew(bufferOut);
         ioFilterGroupAdd(
-            ioWriteFilterGroup(write), pageChecksumNew(0, PG_SEGMENT_PAGE_DEFAULT, storagePathP(storageTest, STRDEF("relation"))));
+            ioWriteFilterGroup(write), pageChecksumNew(0, PG_SEGMENT_PAGE_DEFAULT, 0, storagePathP(storageTest, STRDEF("relation"))));
         ioWriteOpen(write);
         ioWrite(write, buffer);
         ioWriteClose(write);
@@ -799,6 +836,54 @@ testRun(void)
         TEST_RESULT_UINT(segmentNumber(STRDEF("999.123")), 123, "Segment number");
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("backupFileCompressLevel() and backupFileCompressLevelUpdate()"))
+    {
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("level is not adapted when the bounds are equal");
+
+        TEST_RESULT_INT(backupFileCompressLevel(6, 6, 6), 6, "level");
+        TEST_RESULT_VOID(backupFileCompressLevelUpdate(6, 6, 1024 * 1024, 100, 10), "update");
+        TEST_RESULT_BOOL(backupFileLocal.compressLevelSet, false, "level not set");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("level starts from the requested level within the bounds");
+
+        TEST_RESULT_INT(backupFileCompressLevel(6, 1, 3), 3, "level clamped to max");
+        TEST_RESULT_INT(backupFileCompressLevel(6, 1, 9), 3, "level kept when bounds change");
+        TEST_RESULT_INT(backupFileCompressLevel(1, 4, 9), 4, "level clamped to min");
+        TEST_RESULT_INT(backupFileCompressLevel(6, 1, 9), 4, "level kept");
+        TEST_RESULT_INT(backupFileCompressLevel(6, 1, 3), 3, "level reset when above max");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("level is lowered when compression is slower than io");
+
+        TEST_RESULT_VOID(backupFileCompressLevelUpdate(1, 3, 1024 * 1024 - 1, 100, 110), "small file ignored");
+        TEST_RESULT_INT(backupFileCompressLevel(6, 1, 3), 3, "level unchanged");
+        TEST_RESULT_VOID(backupFileCompressLevelUpdate(1, 3, 1024 * 1024, 0, 110), "remote compress ignored");
+        TEST_RESULT_INT(backupFileCompressLevel(6, 1, 3), 3, "level unchanged");
+        TEST_RESULT_VOID(backupFileCompressLevelUpdate(1, 3, 1024 * 1024, 100, 110), "compress bound");
+        TEST_RESULT_INT(backupFileCompressLevel(6, 1, 3), 2, "level lowered");
+        TEST_RESULT_VOID(backupFileCompressLevelUpdate(1, 3, 1024 * 1024, 100, 90), "compress bound");
+        TEST_RESULT_INT(backupFileCompressLevel(6, 1, 3), 1, "level lowered");
+        TEST_RESULT_VOID(backupFileCompressLevelUpdate(1, 3, 1024 * 1024, 100, 110), "compress bound");
+        TEST_RESULT_INT(backupFileCompressLevel(6, 1, 3), 1, "level at min");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("level is raised when io is much slower than compression");
+
+        TEST_RESULT_VOID(backupFileCompressLevelUpdate(1, 3, 1024 * 1024, 100, 250), "balanced");
+        TEST_RESULT_INT(backupFileCompressLevel(6, 1, 3), 1, "level unchanged");
+        TEST_RESULT_VOID(backupFileCompressLevelUpdate(1, 3, 1024 * 1024, 100, 350), "io bound");
+        TEST_RESULT_INT(backupFileCompressLevel(6, 1, 3), 2, "level raised");
+        TEST_RESULT_VOID(backupFileCompressLevelUpdate(1, 3, 1024 * 1024, 100, 350), "io bound");
+        TEST_RESULT_INT(backupFileCompressLevel(6, 1, 3), 3, "level raised");
+        TEST_RESULT_VOID(backupFileCompressLevelUpdate(1, 3, 1024 * 1024, 100, 350), "io bound");
+        TEST_RESULT_INT(backupFileCompressLevel(6, 1, 3), 3, "level at max");
+
+        backupFileLocal = (struct BackupFileLocal){0};
+    }
+
     // *****************************************************************************************************************************
     if (testBegin("backupFile()"))
     {
@@ -842,7 +927,8 @@ testRun(void)
 
         TEST_ASSIGN(
             result,
-            *(BackupFileResult *)lstGet(backupFile(repoFile, compressTypeNone, 1, false, cipherTypeNone, NULL, fileList), 0),
+            *(BackupFileResult *)lstGet(
+                backupFile(repoFile, compressTypeNone, 1, 1, 1, false, cipherTypeNone, NULL, false, NULL, 0, NULL, fileList), 0),
             "pg file missing, ignoreMissing=true, no delta");
         TEST_RESULT_UINT(result.copySize + result.repoSize, 0, "copy/repo size 0");
         TEST_RESULT_UINT(result.backupCopyResult, backupCopyResultSkip, "skip file");
@@ -867,8 +953,8 @@ testRun(void)
         lstAdd(fileList, &file);
 
         TEST_ERROR(
-            backupFile(repoFile, compressTypeNone, 1, false, cipherTypeNone, NULL, fileList), FileMissingError,
-            "unable to open missing file '" TEST_PATH "/pg/missing' for read");
+            backupFile(repoFile, compressTypeNone, 1, 1, 1, false, cipherTypeNone, NULL, false, NULL, 0, NULL, fileList),
+            FileMissingError, "unable to open missing file '" TEST_PATH "/pg/missing' for read");
 
         // Create a pg file to backup
         HRN_STORAGE_PUT_Z(storagePgWrite(), strZ(pgFile), "atestfile");
@@ -903,12 +989,14 @@ testRun(void)
 
         TEST_ASSIGN(
             result,
-            *(BackupFileResult *)lstGet(backupFile(repoFile, compressTypeNone, 1, false, cipherTypeNone, NULL, fileList), 0),
+            *(BackupFileResult *)lstGet(
+                backupFile(repoFile, compressTypeNone, 1, 1, 1, false, cipherTypeNone, NULL, false, NULL, 0, NULL, fileList), 0),
             "file checksummed with pageChecksum enabled");
         TEST_RESULT_UINT(result.copySize, 9, "copy=pgFile size");
         TEST_RESULT_UINT(result.repoSize, 9, "repo=pgFile size");
         TEST_RESULT_UINT(result.backupCopyResult, backupCopyResultCopy, "copy file");
         TEST_RESULT_STR_Z(result.copyChecksum, "9bc8ab2dda60ef4beed07d1e19ce0676d5edde67", "copy checksum matches");
+        TEST_RESULT_STR_Z(result.repoChecksum, "4c7c9ab025b5a395f8711dcba8636dc8", "repo checksum matches");
         TEST_RESULT_STR_Z(hrnPackToStr(result.pageChecksumResult), "2:bool:false, 3:bool:false", "pageChecksumResult");
         TEST_STORAGE_EXISTS(storageRepoWrite(), strZ(backupPathFile), .remove = true, .comment = "check exists in repo, remove");
 
@@ -933,7 +1021,8 @@ testRun(void)
 
         TEST_ASSIGN(
             result,
-            *(BackupFileResult *)lstGet(backupFile(repoFile, compressTypeNone, 1, false, cipherTypeNone, NULL, fileList), 0),
+            *(BackupFileResult *)lstGet(
+                backupFile(repoFile, compressTypeNone, 1, 1, 1, false, cipherTypeNone, NULL, false, NULL, 0, NULL, fileList), 0),
             "backup file");
         TEST_RESULT_UINT(result.copySize, 12, "copy size");
         TEST_RESULT_UINT(result.repoSize, 12, "repo size");
@@ -964,7 +1053,8 @@ testRun(void)
         // File exists in repo and db, pg checksum match, delta set, ignoreMissing false, hasReference - NOOP
         TEST_ASSIGN(
             result,
-            *(BackupFileResult *)lstGet(backupFile(repoFile, compressTypeNone, 1, true, cipherTypeNone, NULL, fileList), 0),
+            *(BackupFileResult *)lstGet(
+                backupFile(repoFile, compressTypeNone, 1, 1, 1, true, cipherTypeNone, NULL, false, NULL, 0, NULL, fileList), 0),
             "file in db and repo, checksum equal, no ignoreMissing, no pageChecksum, delta, hasReference");
         TEST_RESULT_UINT(result.copySize, 9, "copy size set");
         TEST_RESULT_UINT(result.repoSize, 0, "repo size not set since already exists in repo");
@@ -995,7 +1085,8 @@ testRun(void)
         // File exists in repo and db, pg checksum mismatch, delta set, ignoreMissing false, hasReference - COPY
         TEST_ASSIGN(
             result,
-            *(BackupFileResult *)lstGet(backupFile(repoFile, compressTypeNone, 1, true, cipherTypeNone, NULL, fileList), 0),
+            *(BackupFileResult *)lstGet(
+                backupFile(repoFile, compressTypeNone, 1, 1, 1, true, cipherTypeNone, NULL, false, NULL, 0, NULL, fileList), 0),
             "file in db and repo, pg checksum not equal, no ignoreMissing, no pageChecksum, delta, hasReference");
         TEST_RESULT_UINT(result.copySize, 9, "copy 9 bytes");
         TEST_RESULT_UINT(result.repoSize, 9, "repo=copy size");
@@ -1026,7 +1117,8 @@ testRun(void)
         // File exists in repo and pg, pg checksum same, pg size passed is different, delta set, ignoreMissing false, hasReference
         TEST_ASSIGN(
             result,
-            *(BackupFileResult *)lstGet(backupFile(repoFile, compressTypeNone, 1, true, cipherTypeNone, NULL, fileList), 0),
+            *(BackupFileResult *)lstGet(
+                backupFile(repoFile, compressTypeNone, 1, 1, 1, true, cipherTypeNone, NULL, false, NULL, 0, NULL, fileList), 0),
             "db & repo file, pg checksum same, pg size different, no ignoreMissing, no pageChecksum, delta, hasReference");
         TEST_RESULT_UINT(result.copySize, 12, "copy=pgFile size");
         TEST_RESULT_UINT(result.repoSize, 12, "repo=pgFile size");
@@ -1060,7 +1152,8 @@ testRun(void)
             storageRepo(), STORAGE_REPO_BACKUP "/20190718-155825F", "testfile\n", .comment = "resumed file is missing in repo");
         TEST_ASSIGN(
             result,
-            *(BackupFileResult *)lstGet(backupFile(repoFile, compressTypeNone, 1, true, cipherTypeNone, NULL, fileList), 0),
+            *(BackupFileResult *)lstGet(
+                backupFile(repoFile, compressTypeNone, 1, 1, 1, true, cipherTypeNone, NULL, false, NULL, 0, NULL, fileList), 0),
             "backup 9 bytes of pgfile to file to resume in repo");
         TEST_RESULT_UINT(result.copySize, 9, "copy 9 bytes");
         TEST_RESULT_UINT(result.repoSize, 9, "repo=copy size");
@@ -1100,7 +1193,8 @@ testRun(void)
         // Delta set, ignoreMissing false, no hasReference
         TEST_ASSIGN(
             result,
-            *(BackupFileResult *)lstGet(backupFile(repoFile, compressTypeNone, 1, true, cipherTypeNone, NULL, fileList), 0),
+            *(BackupFileResult *)lstGet(
+                backupFile(repoFile, compressTypeNone, 1, 1, 1, true, cipherTypeNone, NULL, false, NULL, 0, NULL, fileList), 0),
             "db & repo file, pgFileMatch, repo checksum no match, no ignoreMissing, no pageChecksum, delta, no hasReference");
         TEST_RESULT_UINT(result.copySize, 9, "copy 9 bytes");
         TEST_RESULT_UINT(result.repoSize, 9, "repo=copy size");
@@ -1130,7 +1224,8 @@ testRun(void)
 
         TEST_ASSIGN(
             result,
-            *(BackupFileResult *)lstGet(backupFile(repoFile, compressTypeNone, 1, true, cipherTypeNone, NULL, fileList), 0),
+            *(BackupFileResult *)lstGet(
+                backupFile(repoFile, compressTypeNone, 1, 1, 1, true, cipherTypeNone, NULL, false, NULL, 0, NULL, fileList), 0),
             "file in repo only, checksum in repo equal, ignoreMissing=true, no pageChecksum, delta, no hasReference");
         TEST_RESULT_UINT(result.copySize + result.repoSize, 0, "copy=repo=0 size");
         TEST_RESULT_UINT(result.backupCopyResult, backupCopyResultSkip, "skip file");
@@ -1142,6 +1237,9 @@ testRun(void)
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("compression set, all other boolean parameters false - COPY");
 
+        // Enable tracing to check that a span is recorded for each file copied
+        traceInit(1);
+
         fileList = lstNewP(sizeof(BackupFile));
 
         file = (BackupFile)
@@ -1162,7 +1260,8 @@ testRun(void)
 
         TEST_ASSIGN(
             result,
-            *(BackupFileResult *)lstGet(backupFile(repoFile, compressTypeGz, 3, false, cipherTypeNone, NULL, fileList), 0),
+            *(BackupFileResult *)lstGet(
+                backupFile(repoFile, compressTypeGz, 3, 3, 3, false, cipherTypeNone, NULL, false, NULL, 0, NULL, fileList), 0),
             "pg file exists, no checksum, no ignoreMissing, compression, no pageChecksum, no delta, no hasReference");
         TEST_RESULT_UINT(result.copySize, 9, "copy=pgFile size");
         TEST_RESULT_UINT(result.repoSize, 29, "repo compress size");
@@ -1172,6 +1271,15 @@ testRun(void)
         TEST_STORAGE_EXISTS(
             storageRepo(), zNewFmt(STORAGE_REPO_BACKUP "/%s/%s.gz", strZ(backupLabel), strZ(pgFile)),
             .comment = "copy file to repo compress success");
+        TEST_RESULT_BOOL(
+            strBeginsWithZ(traceEvent(), "{\"args\":{\"compressLevel\":3,\"compressTime\":"), true,
+            "trace span with compress level and time");
+        TEST_RESULT_BOOL(
+            strstr(strZ(traceEvent()), "\"repoSize\":29,\"size\":9},\"dur\":") != NULL, true, "trace span with sizes");
+        TEST_RESULT_BOOL(
+            strstr(strZ(traceEvent()), "\"name\":\"backupFile\",\"ph\":\"X\",\"pid\":1,") != NULL, true, "trace span name");
+
+        traceReset();
 
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("pg and repo file exist & match, prior checksum, compression - COPY CHECKSUM");
@@ -1194,7 +1302,8 @@ testRun(void)
 
         TEST_ASSIGN(
             result,
-            *(BackupFileResult *)lstGet(backupFile(repoFile, compressTypeGz, 3, false, cipherTypeNone, NULL, fileList), 0),
+            *(BackupFileResult *)lstGet(
+                backupFile(repoFile, compressTypeGz, 3, 3, 3, false, cipherTypeNone, NULL, false, NULL, 0, NULL, fileList), 0),
             "pg file & repo exists, match, checksum, no ignoreMissing, compression, no pageChecksum, no delta, no hasReference");
         TEST_RESULT_UINT(result.copySize, 9, "copy=pgFile size");
         TEST_RESULT_UINT(result.repoSize, 0, "repo size not calculated");
@@ -1204,6 +1313,48 @@ testRun(void)
             storageRepo(), zNewFmt(STORAGE_REPO_BACKUP "/%s/%s.gz", strZ(backupLabel), strZ(pgFile)),
             .comment = "compressed file exists");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("incompressible file is compressed at the fastest level");
+
+        Buffer *const random = bufNew(16384);
+        uint32_t seed = 1;
+
+        for (size_t byteIdx = 0; byteIdx < bufSize(random); byteIdx++)
+        {
+            seed = seed * 1103515245 + 12345;
+            *(bufPtr(random) + byteIdx) = (unsigned char)(seed >> 24);
+        }
+
+        bufUsedSet(random, bufSize(random));
+        HRN_STORAGE_PUT(storagePgWrite(), "random", random);
+
+        fileList = lstNewP(sizeof(BackupFile));
+
+        file = (BackupFile)
+        {
+            .pgFile = STRDEF("random"),
+            .pgFileSize = 16384,
+            .pgFileCopyExactSize = true,
+            .manifestFile = STRDEF("random"),
+        };
+
+        lstAdd(fileList, &file);
+
+        TEST_ASSIGN(
+            result,
+            *(BackupFileResult *)lstGet(
+                backupFile(
+                    strNewFmt(STORAGE_REPO_BACKUP "/%s/random.gz", strZ(backupLabel)), compressTypeGz, 3, 3, 3, false,
+                    cipherTypeNone, NULL, false, NULL, 0, NULL, fileList),
+                0),
+            "backup incompressible file");
+        TEST_RESULT_UINT(result.backupCopyResult, backupCopyResultCopy, "copy file");
+        TEST_RESULT_BOOL(result.compressFast, true, "compressed at fastest level");
+        TEST_RESULT_BOOL(result.repoSize > result.copySize, true, "repo size larger than copy size");
+        TEST_STORAGE_EXISTS(storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/random.gz", strZ(backupLabel)), .remove = true);
+
+        traceReset();
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("create a zero sized file - checksum will be set but in backupManifestUpdate it will not be copied");
 
@@ -1231,11 +1382,15 @@ testRun(void)
         // No prior checksum, no compression, no pageChecksum, no delta, no hasReference
         TEST_ASSIGN(
             result,
-            *(BackupFileResult *)lstGet(backupFile(repoFile, compressTypeNone, 1, false, cipherTypeNone, NULL, fileList), 0),
+            *(BackupFileResult *)lstGet(
+                backupFile(repoFile, compressTypeNone, 1, 1, 1, false, cipherTypeNone, NULL, false, NULL, 0, NULL, fileList), 0),
             "zero-sized pg file exists, no repo file, no ignoreMissing, no pageChecksum, no delta, no hasReference");
         TEST_RESULT_UINT(result.copySize + result.repoSize, 0, "copy=repo=pgFile size 0");
         TEST_RESULT_UINT(result.backupCopyResult, backupCopyResultCopy, "copy file");
         TEST_RESULT_PTR_NE(result.copyChecksum, NULL, "checksum set");
+        TEST_RESULT_BOOL(
+            strBeginsWithZ(traceEvent(), "{\"args\":{\"file\":\"zerofile\",\"hashTime\":"), true,
+            "trace span without compress time");
         TEST_RESULT_PTR(result.pageChecksumResult, NULL, "page checksum result is NULL");
         TEST_STORAGE_LIST(
             storageRepo(), STORAGE_REPO_BACKUP "/20190718-155825F",
@@ -1244,6 +1399,474 @@ testRun(void)
             "zerofile\n",
             .comment = "copy zero file to repo success");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("store file in dedup store");
+
+        HRN_STORAGE_PUT_Z(storagePgWrite(), "dedup1", "atestfile");
+
+        fileList = lstNewP(sizeof(BackupFile));
+
+        file = (BackupFile)
+        {
+            .pgFile = STRDEF("dedup1"),
+            .pgFileIgnoreMissing = true,
+            .pgFileSize = 9,
+            .pgFileCopyExactSize = true,
+            .manifestFile = STRDEF("dedup1"),
+        };
+
+        lstAdd(fileList, &file);
+
+        repoFile = strNewFmt(STORAGE_REPO_BACKUP "/%s/%s", strZ(backupLabel), strZ(file.manifestFile));
+
+        TEST_ASSIGN(
+            result,
+            *(BackupFileResult *)lstGet(
+                backupFile(repoFile, compressTypeNone, 1, 1, 1, false, cipherTypeNone, NULL, true, NULL, 0, NULL, fileList), 0),
+            "store file");
+        TEST_RESULT_UINT(result.backupCopyResult, backupCopyResultCopy, "copy file");
+        TEST_RESULT_BOOL(result.dedup, true, "dedup");
+        TEST_RESULT_UINT(result.copySize, 9, "copy size");
+        TEST_RESULT_UINT(result.repoSize, 9, "repo size");
+        TEST_RESULT_STR_Z(result.copyChecksum, "9bc8ab2dda60ef4beed07d1e19ce0676d5edde67", "checksum");
+        TEST_STORAGE_GET(
+            storageRepo(), STORAGE_REPO_BACKUP "/dedup/9b/9bc8ab2dda60ef4beed07d1e19ce0676d5edde67", "atestfile",
+            .comment = "file in dedup store");
+        TEST_RESULT_BOOL(storageExistsP(storageRepo(), repoFile), false, "backup file not written");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("file already in dedup store");
+
+        // Make the store path read-only so any attempt to write a temp file will error
+        HRN_STORAGE_MODE(storageRepoWrite(), STORAGE_REPO_BACKUP "/dedup", .mode = 0555);
+
+        TEST_ASSIGN(
+            result,
+            *(BackupFileResult *)lstGet(
+                backupFile(repoFile, compressTypeNone, 1, 1, 1, false, cipherTypeNone, NULL, true, NULL, 0, NULL, fileList), 0),
+            "dedup file");
+        TEST_RESULT_UINT(result.backupCopyResult, backupCopyResultDedup, "dedup file");
+        TEST_RESULT_BOOL(result.dedup, true, "dedup");
+        TEST_RESULT_UINT(result.copySize, 9, "copy size");
+        TEST_RESULT_UINT(result.repoSize, 9, "repo size");
+        TEST_RESULT_STR_Z(result.copyChecksum, "9bc8ab2dda60ef4beed07d1e19ce0676d5edde67", "checksum");
+        TEST_RESULT_BOOL(storageExistsP(storageRepo(), repoFile), false, "backup file not written");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("file already in dedup store by prior checksum");
+
+        // The pg file is not read since the checksum from the prior manifest is used
+        HRN_STORAGE_PUT_Z(storagePgWrite(), "dedup1", "notread");
+
+        ((BackupFile *)lstGet(fileList, 0))->pgFileChecksum = STRDEF("9bc8ab2dda60ef4beed07d1e19ce0676d5edde67");
+
+        TEST_ASSIGN(
+            result,
+            *(BackupFileResult *)lstGet(
+                backupFile(repoFile, compressTypeNone, 1, 1, 1, false, cipherTypeNone, NULL, true, NULL, 0, NULL, fileList), 0),
+            "dedup file");
+        TEST_RESULT_UINT(result.backupCopyResult, backupCopyResultDedup, "dedup file");
+        TEST_RESULT_BOOL(result.dedup, true, "dedup");
+        TEST_RESULT_UINT(result.copySize, 9, "copy size");
+        TEST_RESULT_UINT(result.repoSize, 9, "repo size");
+        TEST_RESULT_STR_Z(result.copyChecksum, "9bc8ab2dda60ef4beed07d1e19ce0676d5edde67", "checksum");
+        TEST_RESULT_BOOL(storageExistsP(storageRepo(), repoFile), false, "backup file not written");
+
+        ((BackupFile *)lstGet(fileList, 0))->pgFileChecksum = NULL;
+
+        HRN_STORAGE_MODE(storageRepoWrite(), STORAGE_REPO_BACKUP "/dedup");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("store compressed file with page checksums in dedup store");
+
+        HRN_STORAGE_PUT_Z(storagePgWrite(), "dedup1", "atestfile2");
+
+        ((BackupFile *)lstGet(fileList, 0))->pgFileSize = 10;
+        ((BackupFile *)lstGet(fileList, 0))->pgFileChecksumPage = true;
+
+        TEST_ASSIGN(
+            result,
+            *(BackupFileResult *)lstGet(
+                backupFile(repoFile, compressTypeGz, 3, 3, 3, false, cipherTypeNone, NULL, true, NULL, 0, NULL, fileList), 0),
+            "store file");
+        TEST_RESULT_UINT(result.backupCopyResult, backupCopyResultCopy, "copy file");
+        TEST_RESULT_BOOL(result.dedup, true, "dedup");
+        TEST_RESULT_STR_Z(result.copyChecksum, "6394ac1fa1c7cf99ecb7df585dd4fa680ddeab15", "checksum");
+        TEST_RESULT_PTR_NE(result.pageChecksumResult, NULL, "page checksum result");
+        TEST_STORAGE_GET(
+            storageRepo(), STORAGE_REPO_BACKUP "/dedup/63/6394ac1fa1c7cf99ecb7df585dd4fa680ddeab15", "atestfile2",
+            .compressType = compressTypeGz, .comment = "file in dedup store");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("content stored by another process while storing in dedup store");
+
+        HRN_STORAGE_PUT_Z(storagePgWrite(), "dedup1", "original");
+
+        ((BackupFile *)lstGet(fileList, 0))->pgFileSize = 8;
+        ((BackupFile *)lstGet(fileList, 0))->pgFileChecksumPage = false;
+
+        hrnBackupDedupMoveShimInstall("original");
+
+        TEST_ASSIGN(
+            result,
+            *(BackupFileResult *)lstGet(
+                backupFile(repoFile, compressTypeNone, 1, 1, 1, false, cipherTypeNone, NULL, true, NULL, 0, NULL, fileList), 0),
+            "dedup file");
+        TEST_RESULT_UINT(result.backupCopyResult, backupCopyResultDedup, "dedup file");
+        TEST_RESULT_BOOL(result.dedup, true, "dedup");
+        TEST_RESULT_UINT(result.repoSize, 8, "repo size");
+        TEST_STORAGE_LIST(
+            storageRepoWrite(), STORAGE_REPO_BACKUP "/dedup/d7", "d73ef92426f2b11dfc4aed4d4bfc41c49ee1087c\n",
+            .comment = "only store file in dedup store");
+        TEST_RESULT_BOOL(storageExistsP(storageRepo(), repoFile), false, "backup file not written");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("temp file missing when moved into dedup store");
+
+        HRN_STORAGE_PUT_Z(storagePgWrite(), "dedup1", "changed");
+
+        ((BackupFile *)lstGet(fileList, 0))->pgFileSize = 7;
+
+        hrnBackupDedupMoveShimInstall(NULL);
+
+        TEST_ASSIGN(
+            result,
+            *(BackupFileResult *)lstGet(
+                backupFile(repoFile, compressTypeNone, 1, 1, 1, false, cipherTypeNone, NULL, true, NULL, 0, NULL, fileList), 0),
+            "copy file");
+        TEST_RESULT_UINT(result.backupCopyResult, backupCopyResultCopy, "copy file");
+        TEST_RESULT_BOOL(result.dedup, false, "not dedup");
+        TEST_RESULT_STR_Z(result.copyChecksum, "37c6c57bedf4305ef41249c1794760b5cb8fad17", "checksum");
+        TEST_STORAGE_GET(storageRepoWrite(), strZ(repoFile), "changed", .remove = true, .comment = "backup file written");
+        TEST_RESULT_BOOL(
+            storageExistsP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/dedup/37/37c6c57bedf4305ef41249c1794760b5cb8fad17")), false,
+            "not in dedup store");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("store file in dedup store without rename");
+
+        HRN_STORAGE_PUT_Z(storagePgWrite(), "dedup1", "norename");
+
+        ((BackupFile *)lstGet(fileList, 0))->pgFileSize = 8;
+
+        // Disable storageFeaturePath so the temp file is copied like it would be on an object store
+        ((Storage *)storageRepoWrite())->pub.interface.feature ^= 1 << storageFeaturePath;
+
+        TEST_ASSIGN(
+            result,
+            *(BackupFileResult *)lstGet(
+                backupFile(repoFile, compressTypeNone, 1, 1, 1, false, cipherTypeNone, NULL, true, NULL, 0, NULL, fileList), 0),
+            "store file");
+
+        ((Storage *)storageRepoWrite())->pub.interface.feature |= 1 << storageFeaturePath;
+
+        TEST_RESULT_UINT(result.backupCopyResult, backupCopyResultCopy, "copy file");
+        TEST_RESULT_BOOL(result.dedup, true, "dedup");
+        TEST_STORAGE_GET(
+            storageRepo(), STORAGE_REPO_BACKUP "/dedup/8a/8a43fe40904e8c177a8e820b02b54aff7b6f297c", "norename",
+            .comment = "file in dedup store");
+        TEST_RESULT_BOOL(
+            storageExistsP(storageRepo(), strNewFmt(STORAGE_REPO_BACKUP "/dedup/%d.tmp", getpid())), false, "temp file removed");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("file missing before storing in dedup store");
+
+        HRN_STORAGE_REMOVE(storagePgWrite(), "dedup1");
+
+        TEST_ASSIGN(
+            result,
+            *(BackupFileResult *)lstGet(
+                backupFile(repoFile, compressTypeNone, 1, 1, 1, false, cipherTypeNone, NULL, true, NULL, 0, NULL, fileList), 0),
+            "skip file");
+        TEST_RESULT_UINT(result.backupCopyResult, backupCopyResultSkip, "skip file");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("tee file to other repos");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgKeyRawZ(argList, cfgOptRepoPath, 2, TEST_PATH "/repo2");
+        hrnCfgArgKeyRawZ(argList, cfgOptRepoPath, 3, TEST_PATH "/repo3");
+        hrnCfgArgKeyRawZ(argList, cfgOptRepoPath, 4, TEST_PATH "/repo4");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        hrnCfgArgKeyRawZ(argList, cfgOptRepoRetentionFull, 2, "1");
+        hrnCfgArgKeyRawZ(argList, cfgOptRepoRetentionFull, 3, "1");
+        hrnCfgArgKeyRawZ(argList, cfgOptRepoRetentionFull, 4, "1");
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        HRN_STORAGE_PUT_Z(storagePgWrite(), "tee1", "atestfile");
+        HRN_STORAGE_PUT_Z(storagePgWrite(), "tee2", "btestfile");
+
+        // The repo3 stanza path is a file so the repo file can't be opened. Writes to repo4 fail because it is full.
+        HRN_STORAGE_PUT_EMPTY(storageTest, "repo3/backup/test1");
+        HRN_SYSTEM("mkdir -p " TEST_PATH "/repo4/backup/test1/20190718-155825F");
+        HRN_SYSTEM("ln -s /dev/full " TEST_PATH "/repo4/backup/test1/20190718-155825F/bundle");
+
+        fileList = lstNewP(sizeof(BackupFile));
+        lstAdd(fileList, &(BackupFile){.pgFile = STRDEF("tee1"), .pgFileSize = 9, .manifestFile = STRDEF("pg_data/tee1")});
+        lstAdd(fileList, &(BackupFile){.pgFile = STRDEF("tee2"), .pgFileSize = 9, .manifestFile = STRDEF("pg_data/tee2")});
+
+        List *teeList = lstNewP(sizeof(BackupFileTee));
+        lstAdd(teeList, &(BackupFileTee){.repoIdx = 1});
+        lstAdd(teeList, &(BackupFileTee){.repoIdx = 2});
+        lstAdd(teeList, &(BackupFileTee){.repoIdx = 3});
+
+        repoFile = STRDEF(STORAGE_REPO_BACKUP "/20190718-155825F/bundle");
+
+        // Small buffers so the write to repo4 fails while copying
+        const size_t bufferSize = ioBufferSize();
+        ioBufferSizeSet(4);
+
+        TEST_RESULT_UINT(
+            lstSize(
+                backupFile(repoFile, compressTypeNone, 1, 1, 1, false, cipherTypeNone, NULL, false, NULL, 0, teeList, fileList)),
+            2,
+            "tee bundle");
+        TEST_STORAGE_GET(storageRepo(), strZ(repoFile), "atestfilebtestfile", .comment = "repo1 bundle");
+        TEST_STORAGE_GET(storageRepoIdx(1), strZ(repoFile), "atestfilebtestfile", .comment = "repo2 bundle");
+        TEST_RESULT_PTR(((BackupFileTee *)lstGet(teeList, 0))->error, NULL, "repo2 no error");
+        TEST_RESULT_STR_Z(
+            ((BackupFileTee *)lstGet(teeList, 1))->error,
+            "[FileOpenError] unable to open file '" TEST_PATH "/repo3/backup/test1/20190718-155825F/bundle' for write: [20]"
+                " Not a directory",
+            "repo3 error");
+        TEST_RESULT_STR_Z(
+            ((BackupFileTee *)lstGet(teeList, 2))->error,
+            "[FileWriteError] unable to write '" TEST_PATH "/repo4/backup/test1/20190718-155825F/bundle': [28] No space"
+                " left on device",
+            "repo4 error");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("tee file to repo that fails on close");
+
+        ioBufferSizeSet(bufferSize);
+
+        teeList = lstNewP(sizeof(BackupFileTee));
+        lstAdd(teeList, &(BackupFileTee){.repoIdx = 3});
+
+        TEST_RESULT_UINT(
+            lstSize(
+                backupFile(repoFile, compressTypeNone, 1, 1, 1, false, cipherTypeNone, NULL, false, NULL, 0, teeList, fileList)),
+            2,
+            "tee bundle");
+        TEST_RESULT_STR_Z(
+            ((BackupFileTee *)lstGet(teeList, 0))->error,
+            "[FileWriteError] unable to write '" TEST_PATH "/repo4/backup/test1/20190718-155825F/bundle': [28] No space"
+                " left on device",
+            "repo4 error");
+
+        HRN_SYSTEM("rm -rf " TEST_PATH "/repo2 " TEST_PATH "/repo3 " TEST_PATH "/repo4");
+        HRN_STORAGE_REMOVE(storageRepoWrite(), strZ(repoFile));
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("copy large file with checkpoints");
+
+        // Data that is large enough for several checkpoints and does not end on an aligned offset
+        Buffer *const checkpointData = bufNew(5 * 512 * 1024);
+
+        for (size_t dataIdx = 0; dataIdx < bufSize(checkpointData); dataIdx++)
+            bufPtr(checkpointData)[dataIdx] = (unsigned char)(dataIdx % 251);
+
+        bufUsedSet(checkpointData, bufSize(checkpointData));
+
+        HRN_STORAGE_PUT(storagePgWrite(), "large", checkpointData);
+
+        fileList = lstNewP(sizeof(BackupFile));
+        lstAdd(
+            fileList,
+            &(BackupFile){
+                .pgFile = STRDEF("large"), .pgFileIgnoreMissing = true, .pgFileSize = bufUsed(checkpointData),
+                .manifestFile = STRDEF("pg_data/large")});
+
+        repoFile = STRDEF(STORAGE_REPO_BACKUP "/20190718-155825F/pg_data/large");
+        const String *const checkpointFile = strNewFmt("%s" BACKUP_FILE_CHECKPOINT_EXT, strZ(repoFile));
+
+        TEST_ASSIGN(
+            result,
+            *(BackupFileResult *)lstGet(
+                backupFile(
+                    repoFile, compressTypeNone, 1, 1, 1, false, cipherTypeNone, NULL, false, NULL, 1024 * 1024, NULL, fileList),
+                0),
+            "copy");
+        TEST_RESULT_UINT(result.backupCopyResult, backupCopyResultCopy, "copy file");
+        TEST_RESULT_UINT(result.repoSize, bufUsed(checkpointData), "repo size");
+        TEST_RESULT_BOOL(bufEq(storageGetP(storageNewReadP(storageRepo(), repoFile)), checkpointData), true, "check repo file");
+        TEST_RESULT_BOOL(storageExistsP(storageRepo(), checkpointFile), false, "checkpoint removed");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("resume large file from checkpoint");
+
+        // The bytes before the checkpoint are not in the pg file so the test can show that they are not written again
+        Buffer *checkpointRepo = bufNew(bufUsed(checkpointData));
+        memset(bufPtr(checkpointRepo), 0, 1024 * 1024);
+        bufUsedSet(checkpointRepo, 1024 * 1024);
+
+        HRN_STORAGE_PUT(storageRepoWrite(), strZ(repoFile), checkpointRepo);
+
+        PackWrite *checkpointPack = pckWriteNewP();
+        pckWriteU64P(checkpointPack, 1024 * 1024);
+        pckWriteStrP(checkpointPack, bufHex(cryptoHashOne(hashTypeSha1, BUF(bufPtrConst(checkpointData), 1024 * 1024))));
+        pckWriteI32P(checkpointPack, 1);
+        pckWriteBinP(checkpointPack, NULL);
+
+        PackWrite *checkpointState = pckWriteNewP();
+        pckWriteU64P(checkpointState, 1024 * 1024);
+        pckWriteEndP(checkpointState);
+
+        pckWritePackP(checkpointPack, pckWriteResult(checkpointState));
+        pckWriteEndP(checkpointPack);
+
+        const Buffer *checkpointBuffer = pckToBuf(pckWriteResult(checkpointPack));
+        HRN_STORAGE_PUT(storageRepoWrite(), strZ(checkpointFile), checkpointBuffer);
+
+        TEST_ASSIGN(
+            result,
+            *(BackupFileResult *)lstGet(
+                backupFile(
+                    repoFile, compressTypeNone, 1, 1, 1, false, cipherTypeNone, NULL, false, NULL, 1024 * 1024, NULL, fileList),
+                0),
+            "resume");
+        TEST_RESULT_UINT(result.repoSize, bufUsed(checkpointData), "repo size");
+
+        bufCat(checkpointRepo, BUF(bufPtrConst(checkpointData) + 1024 * 1024, bufUsed(checkpointData) - 1024 * 1024));
+        TEST_RESULT_BOOL(bufEq(storageGetP(storageNewReadP(storageRepo(), repoFile)), checkpointRepo), true, "check repo file");
+        TEST_RESULT_BOOL(storageExistsP(storageRepo(), checkpointFile), false, "checkpoint removed");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("copy from the beginning when the checkpoint does not match");
+
+        HRN_STORAGE_PUT(storageRepoWrite(), strZ(repoFile), BUF(bufPtrConst(checkpointRepo), 1024 * 1024));
+        HRN_STORAGE_PUT(storageRepoWrite(), strZ(checkpointFile), checkpointBuffer);
+        HRN_STORAGE_PUT(storagePgWrite(), "large", BUF(bufPtrConst(checkpointRepo), 1024 * 1024 + 1));
+
+        TEST_ASSIGN(
+            result,
+            *(BackupFileResult *)lstGet(
+                backupFile(
+                    repoFile, compressTypeNone, 1, 1, 1, false, cipherTypeNone, NULL, false, NULL, 1024 * 1024, NULL, fileList),
+                0),
+            "copy");
+        TEST_RESULT_UINT(result.repoSize, 1024 * 1024 + 1, "repo size");
+        TEST_RESULT_BOOL(
+            bufEq(storageGetP(storageNewReadP(storageRepo(), repoFile)), BUF(bufPtrConst(checkpointRepo), 1024 * 1024 + 1)), true,
+            "check repo file");
+        TEST_RESULT_BOOL(storageExistsP(storageRepo(), checkpointFile), false, "checkpoint removed");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("copy from the beginning when the pg file is smaller than the checkpoint");
+
+        HRN_STORAGE_PUT(storageRepoWrite(), strZ(repoFile), BUF(bufPtrConst(checkpointData), 1024 * 1024));
+        HRN_STORAGE_PUT(storageRepoWrite(), strZ(checkpointFile), checkpointBuffer);
+        HRN_STORAGE_PUT(storagePgWrite(), "large", BUF(bufPtrConst(checkpointData), 1024));
+
+        TEST_ASSIGN(
+            result,
+            *(BackupFileResult *)lstGet(
+                backupFile(
+                    repoFile, compressTypeNone, 1, 1, 1, false, cipherTypeNone, NULL, false, NULL, 1024 * 1024, NULL, fileList),
+                0),
+            "copy");
+        TEST_RESULT_UINT(result.repoSize, 1024, "repo size");
+        TEST_RESULT_BOOL(storageExistsP(storageRepo(), checkpointFile), false, "checkpoint removed");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("copy from the beginning when the storage cannot resume");
+
+        HRN_STORAGE_REMOVE(storageRepoWrite(), strZ(repoFile));
+        HRN_STORAGE_PUT(storageRepoWrite(), strZ(checkpointFile), checkpointBuffer);
+        HRN_STORAGE_PUT(storagePgWrite(), "large", checkpointData);
+
+        TEST_ASSIGN(
+            result,
+            *(BackupFileResult *)lstGet(
+                backupFile(
+                    repoFile, compressTypeNone, 1, 1, 1, false, cipherTypeNone, NULL, false, NULL, 1024 * 1024, NULL, fileList),
+                0),
+            "copy");
+        TEST_RESULT_UINT(result.repoSize, bufUsed(checkpointData), "repo size");
+        TEST_RESULT_BOOL(bufEq(storageGetP(storageNewReadP(storageRepo(), repoFile)), checkpointData), true, "check repo file");
+        TEST_RESULT_BOOL(storageExistsP(storageRepo(), checkpointFile), false, "checkpoint removed");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("keep the checkpoint when the error is not caused by resuming");
+
+        HRN_STORAGE_PUT(storageRepoWrite(), strZ(repoFile), BUF(bufPtrConst(checkpointData), 1024 * 1024));
+        HRN_STORAGE_PUT(storageRepoWrite(), strZ(checkpointFile), checkpointBuffer);
+        HRN_STORAGE_MODE(storagePgWrite(), "large", .mode = 0200);
+
+        TEST_ERROR_FMT(
+            backupFile(repoFile, compressTypeNone, 1, 1, 1, false, cipherTypeNone, NULL, false, NULL, 1024 * 1024, NULL, fileList),
+            FileOpenError, "unable to open file '" TEST_PATH "/pg/large' for read: [13] Permission denied");
+        TEST_RESULT_BOOL(storageExistsP(storageRepo(), checkpointFile), true, "checkpoint kept");
+
+        HRN_STORAGE_MODE(storagePgWrite(), "large");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("remove repo file and checkpoint when the pg file is missing");
+
+        HRN_STORAGE_PUT(storageRepoWrite(), strZ(repoFile), BUF(bufPtrConst(checkpointData), 1024 * 1024));
+        HRN_STORAGE_PUT(storageRepoWrite(), strZ(checkpointFile), checkpointBuffer);
+        HRN_STORAGE_REMOVE(storagePgWrite(), "large");
+
+        TEST_ASSIGN(
+            result,
+            *(BackupFileResult *)lstGet(
+                backupFile(
+                    repoFile, compressTypeNone, 1, 1, 1, false, cipherTypeNone, NULL, false, NULL, 1024 * 1024, NULL, fileList),
+                0),
+            "skip");
+        TEST_RESULT_UINT(result.backupCopyResult, backupCopyResultSkip, "skip file");
+        TEST_RESULT_BOOL(storageExistsP(storageRepo(), repoFile), false, "repo file removed");
+        TEST_RESULT_BOOL(storageExistsP(storageRepo(), checkpointFile), false, "checkpoint removed");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("resume encrypted large file from checkpoint");
+
+        HRN_STORAGE_PUT(storagePgWrite(), "large", checkpointData);
+
+        // Encrypt the data with a known salt to get the bytes that the resumed copy must produce
+        const Buffer *const checkpointHeader = BUFSTRDEF("Salted__12345678");
+        StorageRead *checkpointRead = storageNewReadP(storagePg(), STRDEF("large"));
+        ioFilterGroupAdd(
+            ioReadFilterGroup(storageReadIo(checkpointRead)),
+            cipherBlockNewResume(cipherTypeAes256Cbc, BUFSTRDEF(TEST_CIPHER_PASS), NULL, checkpointHeader));
+        const Buffer *const checkpointCipher = storageGetP(checkpointRead);
+
+        checkpointRepo = bufNew(bufUsed(checkpointCipher));
+        memset(bufPtr(checkpointRepo), 0, 1024 * 1024);
+        bufUsedSet(checkpointRepo, 1024 * 1024);
+
+        HRN_STORAGE_PUT(storageRepoWrite(), strZ(repoFile), checkpointRepo);
+
+        checkpointPack = pckWriteNewP();
+        pckWriteU64P(checkpointPack, 1024 * 1024);
+        pckWriteStrP(checkpointPack, bufHex(cryptoHashOne(hashTypeSha1, BUF(bufPtrConst(checkpointCipher), 1024 * 1024))));
+        pckWriteI32P(checkpointPack, 1);
+        pckWriteBinP(checkpointPack, checkpointHeader);
+        pckWritePackP(checkpointPack, pckWriteResult(checkpointState));
+        pckWriteEndP(checkpointPack);
+
+        HRN_STORAGE_PUT(storageRepoWrite(), strZ(checkpointFile), pckToBuf(pckWriteResult(checkpointPack)));
+
+        TEST_ASSIGN(
+            result,
+            *(BackupFileResult *)lstGet(
+                backupFile(
+                    repoFile, compressTypeNone, 1, 1, 1, false, cipherTypeAes256Cbc, STRDEF(TEST_CIPHER_PASS), false, NULL,
+                    1024 * 1024, NULL, fileList),
+                0),
+            "resume");
+        TEST_RESULT_UINT(result.repoSize, bufUsed(checkpointCipher), "repo size");
+
+        bufCat(checkpointRepo, BUF(bufPtrConst(checkpointCipher) + 1024 * 1024, bufUsed(checkpointCipher) - 1024 * 1024));
+        TEST_RESULT_BOOL(bufEq(storageGetP(storageNewReadP(storageRepo(), repoFile)), checkpointRepo), true, "check repo file");
+        TEST_RESULT_BOOL(storageExistsP(storageRepo(), checkpointFile), false, "checkpoint removed");
+
+        HRN_STORAGE_REMOVE(storagePgWrite(), "large");
+        HRN_STORAGE_REMOVE(storageRepoWrite(), strZ(repoFile));
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("copy file to encrypted repo");
 
@@ -1283,7 +1906,10 @@ testRun(void)
         TEST_ASSIGN(
             result,
             *(BackupFileResult *)lstGet(
-                backupFile(repoFile, compressTypeNone, 1, false, cipherTypeAes256Cbc, STRDEF(TEST_CIPHER_PASS), fileList), 0),
+                backupFile(
+                    repoFile, compressTypeNone, 1, 1, 1, false, cipherTypeAes256Cbc, STRDEF(TEST_CIPHER_PASS), false, NULL,
+                        0, NULL, fileList),
+                0),
             "pg file exists, no repo file, no ignoreMissing, no pageChecksum, no delta, no hasReference");
         TEST_RESULT_UINT(result.copySize, 9, "copy size set");
         TEST_RESULT_UINT(result.repoSize, 32, "repo size set");
@@ -1317,7 +1943,10 @@ testRun(void)
         TEST_ASSIGN(
             result,
             *(BackupFileResult *)lstGet(
-                backupFile(repoFile, compressTypeNone, 1, true, cipherTypeAes256Cbc, STRDEF(TEST_CIPHER_PASS), fileList), 0),
+                backupFile(
+                    repoFile, compressTypeNone, 1, 1, 1, true, cipherTypeAes256Cbc, STRDEF(TEST_CIPHER_PASS), false, NULL,
+                        0, NULL, fileList),
+                0),
             "pg and repo file exists, pgFileMatch false, no ignoreMissing, no pageChecksum, delta, no hasReference");
         TEST_RESULT_UINT(result.copySize, 8, "copy size set");
         TEST_RESULT_UINT(result.repoSize, 32, "repo size set");
@@ -1350,7 +1979,10 @@ testRun(void)
         TEST_ASSIGN(
             result,
             *(BackupFileResult *)lstGet(
-                backupFile(repoFile, compressTypeNone, 0, false, cipherTypeAes256Cbc, STRDEF(TEST_CIPHER_PASS), fileList), 0),
+                backupFile(
+                    repoFile, compressTypeNone, 0, 0, 0, false, cipherTypeAes256Cbc, STRDEF(TEST_CIPHER_PASS), false, NULL,
+                        0, NULL, fileList),
+                0),
             "pg and repo file exists, checksum mismatch, no ignoreMissing, no pageChecksum, no delta, no hasReference");
         TEST_RESULT_UINT(result.copySize, 9, "copy size set");
         TEST_RESULT_UINT(result.repoSize, 32, "repo size set");
@@ -1383,7 +2015,10 @@ testRun(void)
         TEST_ASSIGN(
             result,
             *(BackupFileResult *)lstGet(
-                backupFile(repoFile, compressTypeNone, 0, false, cipherTypeAes256Cbc, STRDEF(TEST_CIPHER_PASS), fileList), 0),
+                backupFile(
+                    repoFile, compressTypeNone, 0, 0, 0, false, cipherTypeAes256Cbc, STRDEF(TEST_CIPHER_PASS), false, NULL,
+                        0, NULL, fileList),
+                0),
             "backup file");
 
         TEST_RESULT_UINT(result.copySize, 9, "copy size set");
@@ -1866,6 +2501,86 @@ testRun(void)
         TEST_STORAGE_LIST_EMPTY(storageRepo(), STORAGE_REPO_BACKUP, .comment = "check backup path removed");
 
         manifestResume->pub.data.backupOptionCompressType = compressTypeNone;
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("clean resumed files with checkpoints");
+
+        harnessLogLevelSet(logLevelDetail);
+
+        Manifest *manifestClean = NULL;
+        Manifest *manifestCleanResume = NULL;
+
+        OBJ_NEW_BEGIN(Manifest, .childQty = MEM_CONTEXT_QTY_MAX)
+        {
+            manifestClean = manifestNewInternal();
+        }
+        OBJ_NEW_END();
+
+        OBJ_NEW_BEGIN(Manifest, .childQty = MEM_CONTEXT_QTY_MAX)
+        {
+            manifestCleanResume = manifestNewInternal();
+        }
+        OBJ_NEW_END();
+
+        manifestPathAdd(manifestClean, &(ManifestPath){.name = MANIFEST_TARGET_PGDATA_STR});
+        manifestFileAdd(manifestClean, &(ManifestFile){.name = STRDEF("pg_data/changed"), .size = 8, .timestamp = 1});
+        manifestFileAdd(manifestClean, &(ManifestFile){.name = STRDEF("pg_data/done"), .size = 8, .timestamp = 1});
+        manifestFileAdd(manifestClean, &(ManifestFile){.name = STRDEF("pg_data/large"), .size = 8, .timestamp = 1});
+        manifestFileAdd(manifestClean, &(ManifestFile){.name = STRDEF("pg_data/no-checkpoint"), .size = 8, .timestamp = 1});
+        manifestFileAdd(manifestClean, &(ManifestFile){.name = STRDEF("pg_data/small"), .size = 2, .timestamp = 1});
+
+        manifestFileAdd(manifestCleanResume, &(ManifestFile){.name = STRDEF("pg_data/changed"), .size = 9, .timestamp = 1});
+        manifestFileAdd(
+            manifestCleanResume,
+            &(ManifestFile){
+                .name = STRDEF("pg_data/done"), .checksumSha1 = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa", .size = 8,
+                .timestamp = 1});
+        manifestFileAdd(manifestCleanResume, &(ManifestFile){.name = STRDEF("pg_data/large"), .size = 8, .timestamp = 1});
+        manifestFileAdd(manifestCleanResume, &(ManifestFile){.name = STRDEF("pg_data/no-checkpoint"), .size = 8, .timestamp = 1});
+        manifestFileAdd(manifestCleanResume, &(ManifestFile){.name = STRDEF("pg_data/small"), .size = 2, .timestamp = 1});
+
+        HRN_STORAGE_PUT_Z(storageRepoWrite(), STORAGE_REPO_BACKUP "/20191003-105320F/pg_data/changed", "CHANGED");
+        HRN_STORAGE_PUT_EMPTY(
+            storageRepoWrite(), STORAGE_REPO_BACKUP "/20191003-105320F/pg_data/changed" BACKUP_FILE_CHECKPOINT_EXT);
+        HRN_STORAGE_PUT_Z(storageRepoWrite(), STORAGE_REPO_BACKUP "/20191003-105320F/pg_data/done", "DONE");
+        HRN_STORAGE_PUT_EMPTY(storageRepoWrite(), STORAGE_REPO_BACKUP "/20191003-105320F/pg_data/done" BACKUP_FILE_CHECKPOINT_EXT);
+        HRN_STORAGE_PUT_Z(storageRepoWrite(), STORAGE_REPO_BACKUP "/20191003-105320F/pg_data/large", "LARGE");
+        HRN_STORAGE_PUT_EMPTY(
+            storageRepoWrite(), STORAGE_REPO_BACKUP "/20191003-105320F/pg_data/large" BACKUP_FILE_CHECKPOINT_EXT);
+        HRN_STORAGE_PUT_Z(storageRepoWrite(), STORAGE_REPO_BACKUP "/20191003-105320F/pg_data/no-checkpoint", "NO-CHECKPOINT");
+        HRN_STORAGE_PUT_Z(storageRepoWrite(), STORAGE_REPO_BACKUP "/20191003-105320F/pg_data/small", "SMALL");
+
+        TEST_RESULT_VOID(
+            backupResumeClean(
+                storageNewItrP(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/20191003-105320F"), .sortOrder = sortOrderAsc),
+                manifestClean, manifestCleanResume, compressTypeNone, false, 4, STRDEF(STORAGE_REPO_BACKUP "/20191003-105320F"),
+                NULL),
+            "clean");
+
+        TEST_RESULT_LOG(
+            "P00 DETAIL: remove file '" TEST_PATH "/repo/backup/test1/20191003-105320F/pg_data/changed' from resumed backup"
+                " (mismatched size)\n"
+            "P00 DETAIL: remove file '" TEST_PATH "/repo/backup/test1/20191003-105320F/pg_data/changed.pgbackrest.checkpoint'"
+                " from resumed backup (mismatched size)\n"
+            "P00 DETAIL: remove file '" TEST_PATH "/repo/backup/test1/20191003-105320F/pg_data/done.pgbackrest.checkpoint' from"
+                " resumed backup (checkpoint of completed file)\n"
+            "P00 DETAIL: remove file '" TEST_PATH "/repo/backup/test1/20191003-105320F/pg_data/no-checkpoint' from resumed backup"
+                " (no checksum in resumed manifest)\n"
+            "P00 DETAIL: remove file '" TEST_PATH "/repo/backup/test1/20191003-105320F/pg_data/small' from resumed backup"
+                " (no checksum in resumed manifest)");
+
+        TEST_STORAGE_LIST(
+            storageRepoWrite(), STORAGE_REPO_BACKUP "/20191003-105320F",
+            "pg_data/\n"
+            "pg_data/done\n"
+            "pg_data/large\n"
+            "pg_data/large.pgbackrest.checkpoint\n",
+            .remove = true, .comment = "check files that can be resumed");
+        TEST_RESULT_Z(
+            manifestFileFind(manifestClean, STRDEF("pg_data/done")).checksumSha1, "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+            "completed file resumed");
+
+        harnessLogLevelReset();
     }
 
     // *****************************************************************************************************************************
@@ -1883,16 +2598,33 @@ testRun(void)
         unsigned int currentPercentComplete = 0;
 
         TEST_ERROR(
-            backupJobResult((Manifest *)1, NULL, storageTest, strLstNew(), job, false, 0, NULL, &currentPercentComplete),
+            backupJobResult(
+                (Manifest *)1, NULL, storageTest, strLstNew(), job, NULL, NULL, false, false, 0, NULL, &currentPercentComplete),
             AssertError, "error message");
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("report host/100% progress on noop result");
+        TEST_TITLE("report host/100% progress on noop result and tee error");
+
+        StringList *argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgKeyRawZ(argList, cfgOptRepoPath, 2, TEST_PATH "/repo2");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        hrnCfgArgKeyRawZ(argList, cfgOptRepoRetentionFull, 2, "1");
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        List *const repoTeeList = lstNewP(sizeof(BackupRepoTee));
+        lstAdd(repoTeeList, &(BackupRepoTee){.repoIdx = 1});
 
         // Create job that skips file
         job = protocolParallelJobNew(VARSTRDEF("pg_data/test"), protocolCommandNew(strIdFromZ("x")));
 
         PackWrite *const resultPack = protocolPackNew();
+        pckWriteArrayBeginP(resultPack);
+        pckWriteU32P(resultPack, 1, .defaultWrite = true);
+        pckWriteStrP(resultPack, STRDEF("[FileWriteError] error"));
+        pckWriteArrayEndP(resultPack);
         pckWriteStrP(resultPack, STRDEF("pg_data/test"));
         pckWriteU32P(resultPack, backupCopyResultNoOp);
         pckWriteU64P(resultPack, 0);
@@ -1920,11 +2652,17 @@ testRun(void)
             lockAcquire(TEST_PATH_STR, cfgOptionStr(cfgOptStanza), cfgOptionStr(cfgOptExecId), lockTypeBackup, 0, true),
             "acquire backup lock");
         TEST_RESULT_VOID(
-            backupJobResult(manifest, STRDEF("host"), storageTest, strLstNew(), job, false, 0, &sizeProgress,
-            &currentPercentComplete), "log noop result");
+            backupJobResult(
+                manifest, STRDEF("host"), storageTest, strLstNew(), job, repoTeeList, lstNewP(sizeof(BackupJobSplit)), false,
+                false, 0, &sizeProgress, &currentPercentComplete),
+            "log noop result");
         TEST_RESULT_VOID(lockRelease(true), "release backup lock");
+        TEST_RESULT_BOOL(((BackupRepoTee *)lstGet(repoTeeList, 0))->failed, true, "repo2 failed");
 
-        TEST_RESULT_LOG("P00 DETAIL: match file from prior backup host:" TEST_PATH "/test (0B, 100.00%)");
+        TEST_RESULT_LOG(
+            "P00   WARN: repo2: [FileWriteError] error\n"
+            "            HINT: the backup will not be written to this repo.\n"
+            "P00 DETAIL: match file from prior backup host:" TEST_PATH "/test (0B, 100.00%)");
     }
 
     // Offline tests should only be used to test offline functionality and errors easily tested in offline mode
@@ -2154,6 +2892,161 @@ testRun(void)
             strLstSize(storageListP(storageRepoIdx(1), strNewFmt(STORAGE_PATH_BACKUP "/test1"))), backupCount + 1,
             "new backup repo2");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("tee-repo errors");
+
+        harnessLogLevelSet(logLevelWarn);
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgKeyRawZ(argList, cfgOptRepoPath, 1, TEST_PATH "/repo");
+        hrnCfgArgKeyRawZ(argList, cfgOptRepoRetentionFull, 1, "1");
+        hrnCfgArgKeyRawZ(argList, cfgOptRepoPath, 2, TEST_PATH "/repo2");
+        hrnCfgArgKeyRawZ(argList, cfgOptRepoRetentionFull, 2, "1");
+        hrnCfgArgKeyRawStrId(argList, cfgOptRepoCipherType, 2, cipherTypeAes256Cbc);
+        hrnCfgArgKeyRawZ(argList, cfgOptRepoPath, 3, TEST_PATH "/repo3");
+        hrnCfgArgKeyRawZ(argList, cfgOptRepoRetentionFull, 3, "1");
+        hrnCfgArgKeyRawZ(argList, cfgOptRepoPath, 4, TEST_PATH "/repo4");
+        hrnCfgArgKeyRawZ(argList, cfgOptRepoRetentionFull, 4, "1");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
+        hrnCfgArgRawBool(argList, cfgOptOnline, false);
+        hrnCfgArgRawBool(argList, cfgOptCompress, false);
+
+        StringList *argListTee = strLstDup(argList);
+        hrnCfgArgRawZ(argListTee, cfgOptTeeRepo, "5");
+        HRN_CFG_LOAD(cfgCmdBackup, argListTee);
+
+        TEST_ERROR(
+            testCmdBackup(), OptionInvalidError,
+            "'5' is not valid for 'tee-repo' option\n"
+            "HINT: repos must be configured, listed once, and not be the repo selected for the backup.");
+
+        argListTee = strLstDup(argList);
+        hrnCfgArgRawZ(argListTee, cfgOptTeeRepo, "3");
+        hrnCfgArgRawZ(argListTee, cfgOptTeeRepo, "3");
+        HRN_CFG_LOAD(cfgCmdBackup, argListTee);
+
+        TEST_ERROR(
+            testCmdBackup(), OptionInvalidError,
+            "'3' is not valid for 'tee-repo' option\n"
+            "HINT: repos must be configured, listed once, and not be the repo selected for the backup.");
+
+        argListTee = strLstDup(argList);
+        hrnCfgArgRawZ(argListTee, cfgOptTeeRepo, "2");
+        HRN_CFG_LOAD(cfgCmdBackup, argListTee);
+
+        TEST_ERROR(
+            testCmdBackup(), OptionInvalidError,
+            "'2' is not valid for 'tee-repo' option\n"
+            "HINT: the repo must have the same 'repo2-cipher-type' as the repo selected for the backup.");
+
+        argListTee = strLstDup(argList);
+        hrnCfgArgRawZ(argListTee, cfgOptTeeRepo, "3");
+        hrnCfgArgKeyRawBool(argListTee, cfgOptRepoHardlink, 1, true);
+        HRN_CFG_LOAD(cfgCmdBackup, argListTee);
+
+        TEST_ERROR(
+            testCmdBackup(), OptionInvalidError, "option 'tee-repo' not valid with 'repo1-hardlink' or 'repo1-dedup' options");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("full backup teed to repo3 with repo4 missing stanza");
+
+        // Create stanza on repo3. The repo2 cipher pass is removed from the environment so repo2 is not configured with the default
+        // repo path.
+        hrnCfgEnvKeyRemoveRaw(cfgOptRepoCipherPass, 2);
+
+        StringList *argListStanza = strLstNew();
+        hrnCfgArgRawZ(argListStanza, cfgOptStanza, "test1");
+        hrnCfgArgKeyRawZ(argListStanza, cfgOptRepoPath, 3, TEST_PATH "/repo3");
+        hrnCfgArgRawZ(argListStanza, cfgOptPgPath, TEST_PATH "/pg1");
+        hrnCfgArgRawBool(argListStanza, cfgOptOnline, false);
+        HRN_CFG_LOAD(cfgCmdStanzaCreate, argListStanza);
+
+        cmdStanzaCreate();
+        hrnCfgEnvKeyRawZ(cfgOptRepoCipherPass, 2, TEST_CIPHER_PASS);
+
+        argListTee = strLstDup(argList);
+        hrnCfgArgRawZ(argListTee, cfgOptTeeRepo, "3");
+        hrnCfgArgRawZ(argListTee, cfgOptTeeRepo, "4");
+        hrnCfgArgRawStrId(argListTee, cfgOptType, backupTypeFull);
+        HRN_CFG_LOAD(cfgCmdBackup, argListTee);
+
+        TEST_RESULT_VOID(testCmdBackup(), "backup");
+        TEST_RESULT_LOG(
+            "P00   WARN: repo4: [FileMissingError] unable to load info file '" TEST_PATH "/repo4/backup/test1/backup.info' or '"
+                TEST_PATH "/repo4/backup/test1/backup.info.copy':\n"
+            "            FileMissingError: unable to open missing file '" TEST_PATH "/repo4/backup/test1/backup.info' for read\n"
+            "            FileMissingError: unable to open missing file '" TEST_PATH "/repo4/backup/test1/backup.info.copy' for"
+                " read\n"
+            "            HINT: backup.info cannot be opened and is required to perform a backup.\n"
+            "            HINT: has a stanza-create been performed?\n"
+            "            HINT: the backup will not be written to this repo.");
+
+        InfoBackup *infoBackupRepo1 = infoBackupLoadFile(storageRepoIdx(0), INFO_BACKUP_PATH_FILE_STR, cipherTypeNone, NULL);
+        InfoBackup *infoBackupRepo3 = infoBackupLoadFile(storageRepoIdx(2), INFO_BACKUP_PATH_FILE_STR, cipherTypeNone, NULL);
+        const String *const backupLabelFull = infoBackupData(infoBackupRepo1, infoBackupDataTotal(infoBackupRepo1) - 1).backupLabel;
+
+        TEST_RESULT_UINT(infoBackupDataTotal(infoBackupRepo3), 1, "repo3 backup");
+        TEST_RESULT_STR(infoBackupData(infoBackupRepo3, 0).backupLabel, backupLabelFull, "repo3 backup label");
+        TEST_STORAGE_GET(
+            storageRepoIdx(2), strZ(strNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/PG_VERSION", strZ(backupLabelFull))), "VER",
+            .comment = "repo3 file");
+        TEST_STORAGE_EXISTS(
+            storageRepoIdx(2), strZ(strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE, strZ(backupLabelFull))),
+            .comment = "repo3 manifest");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("incr backup teed to repo3 with repo4 missing prior backup");
+
+        // Create stanza on repo4
+        hrnCfgEnvKeyRemoveRaw(cfgOptRepoCipherPass, 2);
+
+        argListStanza = strLstNew();
+        hrnCfgArgRawZ(argListStanza, cfgOptStanza, "test1");
+        hrnCfgArgKeyRawZ(argListStanza, cfgOptRepoPath, 4, TEST_PATH "/repo4");
+        hrnCfgArgRawZ(argListStanza, cfgOptPgPath, TEST_PATH "/pg1");
+        hrnCfgArgRawBool(argListStanza, cfgOptOnline, false);
+        HRN_CFG_LOAD(cfgCmdStanzaCreate, argListStanza);
+
+        cmdStanzaCreate();
+        hrnCfgEnvKeyRawZ(cfgOptRepoCipherPass, 2, TEST_CIPHER_PASS);
+
+        argListTee = strLstDup(argList);
+        hrnCfgArgRawZ(argListTee, cfgOptTeeRepo, "3");
+        hrnCfgArgRawZ(argListTee, cfgOptTeeRepo, "4");
+        hrnCfgArgRawStrId(argListTee, cfgOptType, backupTypeIncr);
+        hrnCfgArgRawBool(argListTee, cfgOptDelta, true);
+        HRN_CFG_LOAD(cfgCmdBackup, argListTee);
+
+        harnessLogLevelSet(logLevelInfo);
+
+        TEST_RESULT_UINT(
+            lstSize(backupRepoTeeInit(infoBackupLoadFile(storageRepo(), INFO_BACKUP_PATH_FILE_STR, cipherTypeNone, NULL))), 2,
+            "tee repos");
+        TEST_RESULT_BOOL(cfgOptionBool(cfgOptResume), false, "resume disabled");
+        TEST_RESULT_LOG("P00   INFO: resume is disabled since option 'tee-repo' is set");
+
+        harnessLogLevelSet(logLevelWarn);
+
+        HRN_STORAGE_PUT_Z(storagePgWrite(), PG_FILE_PGVERSION, "VR3");
+
+        // Number labels from this test only so the expected log does not depend on timing in prior tests
+        hrnLogReplaceClear();
+        hrnLogReplaceAdd("[0-9]{8}-[0-9]{6}F", NULL, "FULL", true);
+
+        TEST_RESULT_VOID(testCmdBackup(), "backup");
+        TEST_RESULT_LOG(
+            "P00   WARN: repo4: prior backup [FULL-1] does not exist\n"
+            "            HINT: the backup will not be written to this repo.");
+
+        infoBackupRepo3 = infoBackupLoadFile(storageRepoIdx(2), INFO_BACKUP_PATH_FILE_STR, cipherTypeNone, NULL);
+
+        TEST_RESULT_UINT(infoBackupDataTotal(infoBackupRepo3), 2, "repo3 backups");
+        TEST_RESULT_STR(infoBackupData(infoBackupRepo3, 1).backupPrior, backupLabelFull, "repo3 incr prior");
+        TEST_RESULT_UINT(
+            infoBackupDataTotal(infoBackupLoadFile(storageRepoIdx(3), INFO_BACKUP_PATH_FILE_STR, cipherTypeNone, NULL)), 0,
+            "repo4 no backups");
+
         // Cleanup
         hrnCfgEnvKeyRemoveRaw(cfgOptRepoCipherPass, 2);
         harnessLogLevelReset();
@@ -2310,6 +3203,7 @@ testRun(void)
             hrnCfgArgRawStrId(argList, cfgOptType, backupTypeFull);
             hrnCfgArgRawBool(argList, cfgOptStopAuto, true);
             hrnCfgArgRawBool(argList, cfgOptArchiveCopy, true);
+            hrnCfgArgRawZ(argList, cfgOptCompressLevelMin, "1");
             HRN_CFG_LOAD(cfgCmdBackup, argList);
 
             // Create a backup manifest that looks like a halted backup manifest
@@ -2492,6 +3386,8 @@ testRun(void)
             hrnCfgArgRawBool(argList, cfgOptCompress, false);
             hrnCfgArgRawBool(argList, cfgOptStopAuto, true);
             hrnCfgArgRawBool(argList, cfgOptRepoHardlink, true);
+            hrnCfgArgRawZ(argList, cfgOptCompressLevelMin, "1");
+            hrnCfgArgRawZ(argList, cfgOptCompressLevelMax, "9");
             HRN_CFG_LOAD(cfgCmdBackup, argList);
 
             // Load the previous manifest and null out the checksum-page option to be sure it gets set to false in this backup
@@ -2661,6 +3557,8 @@ testRun(void)
             hrnCfgArgRawBool(argList, cfgOptBackupStandby, true);
             hrnCfgArgRawBool(argList, cfgOptStartFast, true);
             hrnCfgArgRawBool(argList, cfgOptArchiveCopy, true);
+            hrnCfgArgRawZ(argList, cfgOptProcessMin, "1");
+            hrnCfgArgRawZ(argList, cfgOptProcessLatencyTarget, "0.05");
             HRN_CFG_LOAD(cfgCmdBackup, argList);
 
             // Add pg_control to standby
@@ -2821,6 +3719,7 @@ testRun(void)
             hrnCfgArgRawBool(argList, cfgOptRepoHardlink, true);
             hrnCfgArgRawZ(argList, cfgOptManifestSaveThreshold, "1");
             hrnCfgArgRawBool(argList, cfgOptArchiveCopy, true);
+            hrnCfgArgRawZ(argList, cfgOptSplitSize, "16K");
             HRN_CFG_LOAD(cfgCmdBackup, argList);
 
             // Move pg1-path and put a link in its place. This tests that backup works when pg1-path is a symlink yet should be
@@ -2862,7 +3761,6 @@ testRun(void)
             bufUsedSet(relation, bufSize(relation));
 
             HRN_STORAGE_PUT(storagePgWrite(), PG_PATH_BASE "/1/3", relation, .timeModified = backupTimeStart);
-            const char *rel1_3Sha1 = strZ(bufHex(cryptoHashOne(hashTypeSha1, relation)));
 
             // File with bad page checksum
             relation = bufNew(PG_PAGE_SIZE_DEFAULT * 3);
@@ -2875,7 +3773,6 @@ testRun(void)
             bufUsedSet(relation, bufSize(relation));
 
             HRN_STORAGE_PUT(storagePgWrite(), PG_PATH_BASE "/1/4", relation, .timeModified = backupTimeStart);
-            const char *rel1_4Sha1 = strZ(bufHex(cryptoHashOne(hashTypeSha1, relation)));
 
             // Add a tablespace
             HRN_STORAGE_PATH_CREATE(storagePgWrite(), PG_PATH_PGTBLSPC);
@@ -2906,9 +3803,14 @@ testRun(void)
                 "P00   INFO: execute non-exclusive pg_start_backup(): backup begins after the next regular checkpoint completes\n"
                 "P00   INFO: backup start archive = 0000000105DB5DE000000000, lsn = 5db5de0/0\n"
                 "P00   INFO: check archive for segment 0000000105DB5DE000000000\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/3 (40KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/3 part 1/3 (16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/3 part 2/3 (16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/3 part 3/3 (8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/3 (3 parts, 40KB, [PCT]) checksum [SHA1]\n"
                 "P00   WARN: invalid page checksums found in file " TEST_PATH "/pg1/base/1/3 at pages 0, 2-4\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/4 (24KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/4 part 1/2 (16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/4 part 2/2 (8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/4 (2 parts, 24KB, [PCT]) checksum [SHA1]\n"
                 "P00   WARN: invalid page checksum found in file " TEST_PATH "/pg1/base/1/4 at page 1\n"
                 "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/2 (8.5KB, [PCT]) checksum [SHA1]\n"
                 "P00   WARN: page misalignment in file " TEST_PATH "/pg1/base/1/2: file size 8704 is not divisible by page size"
@@ -2939,8 +3841,11 @@ testRun(void)
                     "pg_data/base/1 {path}\n"
                     "pg_data/base/1/1.gz {file, s=8192}\n"
                     "pg_data/base/1/2.gz {file, s=8704}\n"
-                    "pg_data/base/1/3.gz {file, s=40960}\n"
-                    "pg_data/base/1/4.gz {file, s=24576}\n"
+                    "pg_data/base/1/3.pgbackrest.part.0.gz {file, s=16384}\n"
+                    "pg_data/base/1/3.pgbackrest.part.1.gz {file, s=16384}\n"
+                    "pg_data/base/1/3.pgbackrest.part.2.gz {file, s=8192}\n"
+                    "pg_data/base/1/4.pgbackrest.part.0.gz {file, s=16384}\n"
+                    "pg_data/base/1/4.pgbackrest.part.1.gz {file, s=8192}\n"
                     "pg_data/global {path}\n"
                     "pg_data/global/pg_control.gz {file, s=8192}\n"
                     "pg_data/pg_tblspc {path}\n"
@@ -2969,10 +3874,14 @@ testRun(void)
                     "pg_data/base/1/1={\"checksum\":\"0631457264ff7f8d5fb1edc2c0211992a67c73e6\",\"checksum-page\":true"
                         ",\"size\":8192,\"timestamp\":1572200000}\n"
                     "pg_data/base/1/2={\"checksum\":\"%s\",\"checksum-page\":false,\"size\":8704,\"timestamp\":1572200000}\n"
-                    "pg_data/base/1/3={\"checksum\":\"%s\",\"checksum-page\":false,\"checksum-page-error\":[0,[2,4]]"
-                        ",\"size\":40960,\"timestamp\":1572200000}\n"
-                    "pg_data/base/1/4={\"checksum\":\"%s\",\"checksum-page\":false,\"checksum-page-error\":[1],\"size\":24576"
-                        ",\"timestamp\":1572200000}\n"
+                    "pg_data/base/1/3={\"checksum\":\"006f5c1f4792c06cd8241dfbffa0153d055ae7fa\",\"checksum-page\":false"
+                        ",\"checksum-page-error\":[0,[2,4]],\"size\":40960"
+                        ",\"split-checksum\":\"c254322f64178ac7f1a0a9907f3eafa7924c4155d43b81fa88701dbff307d6b6ec1a6a4d7926ce"
+                        "fae3eb1434dff987d27056ae0749046f32f280160b\",\"split-size\":16384,\"timestamp\":1572200000}\n"
+                    "pg_data/base/1/4={\"checksum\":\"f94c3cf042d1ef6590f79648afe0b88b208b543d\",\"checksum-page\":false"
+                        ",\"checksum-page-error\":[1],\"size\":24576"
+                        ",\"split-checksum\":\"fb9c24a309869db98ecd84adff78ce7a67537f93d74182af562cc9f6b4a58004622b0d2fd88141e6\""
+                        ",\"split-size\":16384,\"timestamp\":1572200000}\n"
                     "pg_data/global/pg_control={\"size\":8192,\"timestamp\":1572200000}\n"
                     "pg_data/pg_wal/0000000105DB5DE000000000={\"size\":1048576,\"timestamp\":1572200002}\n"
                     "pg_data/pg_wal/0000000105DB5DE000000001={\"size\":1048576,\"timestamp\":1572200002}\n"
@@ -2997,13 +3906,11 @@ testRun(void)
                     "pg_tblspc/32768={}\n"
                     "pg_tblspc/32768/PG_11_201809051={}\n"
                     "pg_tblspc/32768/PG_11_201809051/1={}\n",
-                    rel1_2Sha1, rel1_3Sha1, rel1_4Sha1),
+                    rel1_2Sha1),
                 "compare file list");
 
-            // Remove test files
+            // Remove test files. The split files are checked by the next delta backup.
             HRN_STORAGE_REMOVE(storagePgWrite(), "base/1/2", .errorOnMissing = true);
-            HRN_STORAGE_REMOVE(storagePgWrite(), "base/1/3", .errorOnMissing = true);
-            HRN_STORAGE_REMOVE(storagePgWrite(), "base/1/4", .errorOnMissing = true);
         }
 
         // -------------------------------------------------------------------------------------------------------------------------
@@ -3060,8 +3967,18 @@ testRun(void)
             hrnCfgArgRawStrId(argList, cfgOptType, backupTypeIncr);
             hrnCfgArgRawBool(argList, cfgOptDelta, true);
             hrnCfgArgRawBool(argList, cfgOptRepoHardlink, true);
+            hrnCfgArgRawZ(argList, cfgOptSplitSize, "16K");
             HRN_CFG_LOAD(cfgCmdBackup, argList);
 
+            // Change the second part of a split file without changing the size or timestamp. The parts that did not change are
+            // copied again since the file cannot reference the prior backup for only some parts. The other split file matches.
+            Buffer *relation = storageGetP(storageNewReadP(storagePg(), STRDEF(PG_PATH_BASE "/1/3")));
+            (bufPtr(relation) + (PG_PAGE_SIZE_DEFAULT * 0x03))[PG_PAGE_SIZE_DEFAULT - 1] = 0xFE;
+
+            HRN_STORAGE_PUT(
+                storagePgWrite(), PG_PATH_BASE "/1/3", relation,
+                .timeModified = storageInfoP(storagePg(), STRDEF(PG_PATH_BASE "/1/3")).timeModified);
+
             // Run backup.  Make sure that the timeline selected converts to hexdecimal that can't be interpreted as decimal.
             testBackupPqScriptP(PG_VERSION_11, backupTimeStart, .timeline = 0x2C, .walTotal = 2);
             TEST_RESULT_VOID(testCmdBackup(), "backup");
@@ -3073,12 +3990,24 @@ testRun(void)
                 "P00   INFO: check archive for segment 0000002C05DB8EB000000000\n"
                 "P00   WARN: a timeline switch has occurred since the 20191027-181320F backup, enabling delta checksum\n"
                 "            HINT: this is normal after restoring from backup or promoting a standby.\n"
+                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/base/1/3 part 1/3 (16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/3 part 2/3 (16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/base/1/3 part 3/3 (8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: file " TEST_PATH "/pg1/base/1/3 changed in 1/3 parts, copy matched parts\n"
+                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/base/1/4 part 1/2 (16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/3 part 1/3 (16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/3 part 3/3 (8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/3 (3 parts, 40KB, [PCT]) checksum [SHA1]\n"
+                "P00   WARN: invalid page checksums found in file " TEST_PATH "/pg1/base/1/3 at pages 0, 2-4\n"
+                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/base/1/4 part 2/2 (8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/base/1/4 (2 parts, 24KB, [PCT]) checksum [SHA1]\n"
                 "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (8KB, [PCT]) checksum [SHA1]\n"
                 "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/base/1/1 (8KB, [PCT]) checksum [SHA1]\n"
                 "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/postgresql.conf (11B, [PCT]) checksum [SHA1]\n"
                 "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/PG_VERSION (2B, [PCT]) checksum [SHA1]\n"
                 "P00 DETAIL: hardlink pg_data/PG_VERSION to 20191027-181320F\n"
                 "P00 DETAIL: hardlink pg_data/base/1/1 to 20191027-181320F\n"
+                "P00 DETAIL: hardlink pg_data/base/1/4 to 20191027-181320F\n"
                 "P00 DETAIL: hardlink pg_data/postgresql.conf to 20191027-181320F\n"
                 "P00 DETAIL: hardlink pg_tblspc/32768/PG_11_201809051/1/5 to 20191027-181320F\n"
                 "P00   INFO: execute non-exclusive pg_stop_backup() and wait for all WAL segments to archive\n"
@@ -3087,7 +4016,7 @@ testRun(void)
                 "P00 DETAIL: wrote 'tablespace_map' file returned from pg_stop_backup()\n"
                 "P00   INFO: check archive for segment(s) 0000002C05DB8EB000000000:0000002C05DB8EB000000001\n"
                 "P00   INFO: new backup label = 20191027-181320F_20191030-014640I\n"
-                "P00   INFO: incr backup size = [SIZE], file total = 7");
+                "P00   INFO: incr backup size = [SIZE], file total = 9");
 
             TEST_RESULT_STR_Z(
                 testBackupValidate(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest")),
@@ -3098,6 +4027,11 @@ testRun(void)
                 "pg_data/base {path}\n"
                 "pg_data/base/1 {path}\n"
                 "pg_data/base/1/1.gz {file, s=8192}\n"
+                "pg_data/base/1/3.pgbackrest.part.0.gz {file, s=16384}\n"
+                "pg_data/base/1/3.pgbackrest.part.1.gz {file, s=16384}\n"
+                "pg_data/base/1/3.pgbackrest.part.2.gz {file, s=8192}\n"
+                "pg_data/base/1/4.pgbackrest.part.0.gz {file, s=16384}\n"
+                "pg_data/base/1/4.pgbackrest.part.1.gz {file, s=8192}\n"
                 "pg_data/global {path}\n"
                 "pg_data/global/pg_control.gz {file, s=8192}\n"
                 "pg_data/pg_tblspc {path}\n"
@@ -3123,6 +4057,14 @@ testRun(void)
                     ",\"timestamp\":1572400002}\n"
                 "pg_data/base/1/1={\"checksum\":\"0631457264ff7f8d5fb1edc2c0211992a67c73e6\",\"checksum-page\":true"
                     ",\"reference\":\"20191027-181320F\",\"size\":8192,\"timestamp\":1572200000}\n"
+                "pg_data/base/1/3={\"checksum\":\"772bbffce19be75b2e939d2ed538da315e317fc3\",\"checksum-page\":false"
+                    ",\"checksum-page-error\":[0,[2,4]],\"size\":40960"
+                    ",\"split-checksum\":\"c254322f64178ac7f1a0a9907f3eafa7924c41554dc5602bb54774aa24a340ca80fe2eed3a56afdd"
+                    "e3eb1434dff987d27056ae0749046f32f280160b\",\"split-size\":16384,\"timestamp\":1572200000}\n"
+                "pg_data/base/1/4={\"checksum\":\"f94c3cf042d1ef6590f79648afe0b88b208b543d\",\"checksum-page\":false"
+                    ",\"checksum-page-error\":[1],\"reference\":\"20191027-181320F\",\"size\":24576"
+                    ",\"split-checksum\":\"fb9c24a309869db98ecd84adff78ce7a67537f93d74182af562cc9f6b4a58004622b0d2fd88141e6\""
+                    ",\"split-size\":16384,\"timestamp\":1572200000}\n"
                 "pg_data/global/pg_control={\"size\":8192,\"timestamp\":1572400000}\n"
                 "pg_data/postgresql.conf={\"checksum\":\"e3db315c260e79211b7b52587123b7aa060f30ab\""
                     ",\"reference\":\"20191027-181320F\",\"size\":11,\"timestamp\":1570000000}\n"
@@ -3146,6 +4088,10 @@ testRun(void)
                 "pg_tblspc/32768/PG_11_201809051={}\n"
                 "pg_tblspc/32768/PG_11_201809051/1={}\n",
                 "compare file list");
+
+            // Remove test files
+            HRN_STORAGE_REMOVE(storagePgWrite(), "base/1/3", .errorOnMissing = true);
+            HRN_STORAGE_REMOVE(storagePgWrite(), "base/1/4", .errorOnMissing = true);
         }
 
         // -------------------------------------------------------------------------------------------------------------------------
@@ -3165,6 +4111,7 @@ testRun(void)
             hrnCfgArgRawBool(argList, cfgOptArchiveCopy, true);
             hrnCfgArgRawZ(argList, cfgOptBufferSize, "16K");
             hrnCfgArgRawBool(argList, cfgOptRepoBundle, true);
+            hrnCfgArgRawBool(argList, cfgOptRepoBundleDict, true);
             hrnCfgArgRawBool(argList, cfgOptResume, false);
             hrnCfgArgRawZ(argList, cfgOptAnnotation, "extra key=this is an annotation");
             hrnCfgArgRawZ(argList, cfgOptAnnotation, "source=this is another annotation");
@@ -3200,6 +4147,7 @@ testRun(void)
                 "P00   INFO: execute non-exclusive pg_start_backup(): backup begins after the next regular checkpoint completes\n"
                 "P00   INFO: backup start archive = 0000000105DB8EB000000000, lsn = 5db8eb0/0\n"
                 "P00   INFO: check archive for segment 0000000105DB8EB000000000\n"
+                "P00   WARN: option 'repo1-bundle-dict' is ignored because compress-type 'gz' does not support dictionaries\n"
                 "P00 DETAIL: store zero-length file " TEST_PATH "/pg1/pg_tblspc/32768/PG_11_201809051/1/5\n"
                 "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/2 (24KB, [PCT]) checksum [SHA1]\n"
                 "P01 DETAIL: backup file " TEST_PATH "/pg1/stuff.conf (bundle 1/0, 12B, [PCT]) checksum [SHA1]\n"
@@ -3288,6 +4236,178 @@ testRun(void)
                 "pg_tblspc/32768/PG_11_201809051/1={}\n",
                 "compare file list");
         }
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("online 11 full backup with dedup");
+
+        backupTimeStart = BACKUP_EPOCH + 2500000;
+
+        {
+            // Load options
+            StringList *argList = strLstNew();
+            hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+            hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
+            hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
+            hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeFull);
+            hrnCfgArgRawBool(argList, cfgOptRepoDedup, true);
+            HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+            // Run backup
+            testBackupPqScriptP(PG_VERSION_11, backupTimeStart, .walCompressType = compressTypeGz, .walTotal = 2);
+            TEST_RESULT_VOID(testCmdBackup(), "backup");
+
+            TEST_RESULT_LOG(
+                "P00   INFO: execute non-exclusive pg_start_backup(): backup begins after the next regular checkpoint completes\n"
+                "P00   INFO: backup start archive = 0000000105DBA72000000000, lsn = 5dba720/0\n"
+                "P00   INFO: check archive for segment 0000000105DBA72000000000\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/2 (24KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/base/1/1 (8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/bigish.dat (8.0KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/stuff.conf (12B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/postgresql.auto.conf (12B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/postgresql.conf (11B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (2B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/pg_tblspc/32768/PG_11_201809051/1/5 (0B, [PCT])\n"
+                "P00   INFO: execute non-exclusive pg_stop_backup() and wait for all WAL segments to archive\n"
+                "P00   INFO: backup stop archive = 0000000105DBA72000000001, lsn = 5dba720/180000\n"
+                "P00 DETAIL: wrote 'backup_label' file returned from pg_stop_backup()\n"
+                "P00 DETAIL: wrote 'tablespace_map' file returned from pg_stop_backup()\n"
+                "P00   INFO: check archive for segment(s) 0000000105DBA72000000000:0000000105DBA72000000001\n"
+                "P00   INFO: new backup label = 20191031-053320F\n"
+                "P00   INFO: full backup size = [SIZE], file total = 11");
+
+            TEST_STORAGE_LIST(
+                storageRepo(), STORAGE_REPO_BACKUP "/" MANIFEST_PATH_DEDUP,
+                "06/\n"
+                "06/0631457264ff7f8d5fb1edc2c0211992a67c73e6.gz\n"
+                "17/\n"
+                "17/17ba0791499db908433b80f37c5fbc89b870084b.gz\n"
+                "3e/\n"
+                "3e/3e5175386be683d2f231f3fa3eab892a799082f7.gz\n"
+                "55/\n"
+                "55/55a9d0d18b77789c7722abe72aa905e2dc85bb5d.gz\n"
+                "e3/\n"
+                "e3/e3db315c260e79211b7b52587123b7aa060f30ab.gz\n"
+                "e8/\n"
+                "e8/e873a5cb5a67e48761e7b619c531311404facdce.gz\n"
+                "eb/\n"
+                "eb/ebdd38b69cd5b9f2d00d273c981e16960fbbb4f7.gz\n"
+                "ff/\n"
+                "ff/ff501b58aba84750b03a450db0f631a94d4b8c3a.gz\n",
+                .comment = "dedup store");
+        }
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("online 11 incr backup with dedup and hardlinks");
+
+        backupTimeStart = BACKUP_EPOCH + 2600000;
+
+        {
+            // Load options
+            StringList *argList = strLstNew();
+            hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+            hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
+            hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
+            hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeIncr);
+            hrnCfgArgRawBool(argList, cfgOptRepoDedup, true);
+            hrnCfgArgRawBool(argList, cfgOptRepoHardlink, true);
+            HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+            // Change the timestamp but not the content so the file is found in the dedup store
+            HRN_STORAGE_TIME(storagePgWrite(), "stuff.conf", backupTimeStart);
+
+            // Run backup
+            testBackupPqScriptP(PG_VERSION_11, backupTimeStart, .walCompressType = compressTypeGz, .walTotal = 2);
+            TEST_RESULT_VOID(testCmdBackup(), "backup");
+
+            TEST_RESULT_LOG(
+                "P00   INFO: last backup label = 20191031-053320F, version = " PROJECT_VERSION "\n"
+                "P00   INFO: execute non-exclusive pg_start_backup(): backup begins after the next regular checkpoint completes\n"
+                "P00   INFO: backup start archive = 0000000105DBBF8000000000, lsn = 5dbbf80/0\n"
+                "P00   INFO: check archive for segment 0000000105DBBF8000000000\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: dedup file " TEST_PATH "/pg1/stuff.conf (12B, [PCT]) checksum [SHA1]\n"
+                "P00 DETAIL: reference pg_data/PG_VERSION to 20191031-053320F\n"
+                "P00 DETAIL: reference pg_data/base/1/1 to 20191031-053320F\n"
+                "P00 DETAIL: reference pg_data/base/1/2 to 20191031-053320F\n"
+                "P00 DETAIL: reference pg_data/bigish.dat to 20191031-053320F\n"
+                "P00 DETAIL: reference pg_data/postgresql.auto.conf to 20191031-053320F\n"
+                "P00 DETAIL: reference pg_data/postgresql.conf to 20191031-053320F\n"
+                "P00 DETAIL: hardlink pg_tblspc/32768/PG_11_201809051/1/5 to 20191031-053320F\n"
+                "P00   INFO: execute non-exclusive pg_stop_backup() and wait for all WAL segments to archive\n"
+                "P00   INFO: backup stop archive = 0000000105DBBF8000000001, lsn = 5dbbf80/180000\n"
+                "P00 DETAIL: wrote 'backup_label' file returned from pg_stop_backup()\n"
+                "P00 DETAIL: wrote 'tablespace_map' file returned from pg_stop_backup()\n"
+                "P00   INFO: check archive for segment(s) 0000000105DBBF8000000000:0000000105DBBF8000000001\n"
+                "P00   INFO: new backup label = 20191031-053320F_20191101-092000I\n"
+                "P00   INFO: incr backup size = [SIZE], file total = 11");
+
+            TEST_RESULT_STR_Z(
+                testBackupValidate(storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest")),
+                ". {link, d=20191031-053320F_20191101-092000I}\n"
+                "pg_data {path}\n"
+                "pg_data/backup_label.gz {file, s=17}\n"
+                "pg_data/base {path}\n"
+                "pg_data/base/1 {path}\n"
+                "pg_data/global {path}\n"
+                "pg_data/pg_tblspc {path}\n"
+                "pg_data/pg_tblspc/32768 {link, d=../../pg_tblspc/32768}\n"
+                "pg_data/pg_wal {path}\n"
+                "pg_data/tablespace_map.gz {file, s=19}\n"
+                "pg_tblspc {path}\n"
+                "pg_tblspc/32768 {path}\n"
+                "pg_tblspc/32768/PG_11_201809051 {path}\n"
+                "pg_tblspc/32768/PG_11_201809051/1 {path}\n"
+                "pg_tblspc/32768/PG_11_201809051/1/5.gz {file, s=0}\n"
+                "--------\n"
+                "[backup:target]\n"
+                "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n"
+                "pg_tblspc/32768={\"path\":\"../../pg1-tblspc/32768\",\"tablespace-id\":\"32768\""
+                    ",\"tablespace-name\":\"tblspc32768\",\"type\":\"link\"}\n"
+                "\n"
+                "[target:file]\n"
+                "pg_data/PG_VERSION={\"checksum\":\"17ba0791499db908433b80f37c5fbc89b870084b\",\"dedup\":true"
+                    ",\"reference\":\"20191031-053320F\",\"repo-size\":22,\"size\":2,\"timestamp\":1572200000}\n"
+                "pg_data/backup_label={\"checksum\":\"8e6f41ac87a7514be96260d65bacbffb11be77dc\",\"size\":17"
+                    ",\"timestamp\":1572600002}\n"
+                "pg_data/base/1/1={\"checksum\":\"0631457264ff7f8d5fb1edc2c0211992a67c73e6\",\"checksum-page\":true"
+                    ",\"dedup\":true,\"reference\":\"20191031-053320F\",\"repo-size\":43,\"size\":8192,\"timestamp\":1572200000}\n"
+                "pg_data/base/1/2={\"checksum\":\"ebdd38b69cd5b9f2d00d273c981e16960fbbb4f7\",\"checksum-page\":true"
+                    ",\"dedup\":true,\"reference\":\"20191031-053320F\",\"repo-size\":59,\"size\":24576,\"timestamp\":1572400000}\n"
+                "pg_data/bigish.dat={\"checksum\":\"3e5175386be683d2f231f3fa3eab892a799082f7\",\"dedup\":true"
+                    ",\"reference\":\"20191031-053320F\",\"repo-size\":43,\"size\":8191,\"timestamp\":1500000001}\n"
+                "pg_data/global/pg_control={\"checksum\":\"d703ecb657eb55c9ea2dff7d77d0295de819285f\",\"dedup\":true"
+                    ",\"repo-size\":99,\"size\":8192,\"timestamp\":1572600000}\n"
+                "pg_data/postgresql.auto.conf={\"checksum\":\"e873a5cb5a67e48761e7b619c531311404facdce\",\"dedup\":true"
+                    ",\"reference\":\"20191031-053320F\",\"repo-size\":32,\"size\":12,\"timestamp\":1500000000}\n"
+                "pg_data/postgresql.conf={\"checksum\":\"e3db315c260e79211b7b52587123b7aa060f30ab\",\"dedup\":true"
+                    ",\"reference\":\"20191031-053320F\",\"repo-size\":31,\"size\":11,\"timestamp\":1570000000}\n"
+                "pg_data/stuff.conf={\"checksum\":\"55a9d0d18b77789c7722abe72aa905e2dc85bb5d\",\"dedup\":true,\"repo-size\":32"
+                    ",\"size\":12,\"timestamp\":1572600000}\n"
+                "pg_data/tablespace_map={\"checksum\":\"87fe624d7976c2144e10afcb7a9a49b071f35e9c\",\"size\":19"
+                    ",\"timestamp\":1572600002}\n"
+                "pg_tblspc/32768/PG_11_201809051/1/5={\"checksum-page\":true,\"reference\":\"20191031-053320F\",\"size\":0"
+                    ",\"timestamp\":1572200000}\n"
+                "\n"
+                "[target:link]\n"
+                "pg_data/pg_tblspc/32768={\"destination\":\"../../pg1-tblspc/32768\"}\n"
+                "\n"
+                "[target:path]\n"
+                "pg_data={}\n"
+                "pg_data/base={}\n"
+                "pg_data/base/1={}\n"
+                "pg_data/global={}\n"
+                "pg_data/pg_tblspc={}\n"
+                "pg_data/pg_wal={}\n"
+                "pg_tblspc={}\n"
+                "pg_tblspc/32768={}\n"
+                "pg_tblspc/32768/PG_11_201809051={}\n"
+                "pg_tblspc/32768/PG_11_201809051/1={}\n",
+                "compare file list");
+        }
     }
 
     FUNCTION_HARNESS_RETURN_VOID();
@@ -10,6 +10,15 @@ Test Exit Routines
 #include "common/harnessError.h"
 #include "common/harnessFork.h"
 
+/***********************************************************************************************************************************
+Report function that fails
+***********************************************************************************************************************************/
+static void
+testReportError(void)
+{
+    THROW(FileOpenError, "unable to open report");
+}
+
 /***********************************************************************************************************************************
 Test Run
 ***********************************************************************************************************************************/
@@ -78,6 +87,27 @@ testRun(void)
         }
         TRY_END();
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("report error does not replace the command error");
+
+        exitReportInit(testReportError);
+
+        TRY_BEGIN()
+        {
+            THROW(RuntimeError, "test error message");
+        }
+        CATCH_FATAL()
+        {
+            TEST_RESULT_INT(exitSafe(0, true, signalTypeNone), errorTypeCode(&RuntimeError), "exit with error");
+            TEST_RESULT_LOG(
+                "P00  ERROR: [122]: test error message\n"
+                "P00   WARN: unable to write reports: unable to open report\n"
+                "P00   INFO: archive-push command end: aborted with exception [122]");
+        }
+        TRY_END();
+
+        exitReportInit(NULL);
+
         // -------------------------------------------------------------------------------------------------------------------------
         argList = strLstNew();
         strLstAddZ(argList, "--" CFGOPT_STANZA "=test");
@@ -9,6 +9,7 @@ Test Expire Command
 
 #include "common/harnessConfig.h"
 #include "common/harnessInfo.h"
+#include "common/harnessProtocol.h"
 #include "common/harnessStorage.h"
 
 /***********************************************************************************************************************************
@@ -70,6 +71,10 @@ testRun(void)
 {
     FUNCTION_HARNESS_VOID();
 
+    // Install local command handler shim
+    static const ProtocolServerHandler testLocalHandlerList[] = {PROTOCOL_SERVER_HANDLER_EXPIRE_LIST};
+    hrnProtocolLocalShimInstall(testLocalHandlerList, LENGTH_OF(testLocalHandlerList));
+
     StringList *argListBase = strLstNew();
     hrnCfgArgRawZ(argListBase, cfgOptStanza, "db");
     hrnCfgArgRawZ(argListBase, cfgOptRepoPath, TEST_PATH "/repo");
@@ -406,7 +411,7 @@ testRun(void)
             storageRepoWrite(), STORAGE_REPO_BACKUP "/20181118-152100F_20181119-152152D.save", BOGUS_STR,
             .comment = "directory look-alike file must not be removed");
 
-        TEST_RESULT_VOID(removeExpiredBackup(infoBackup, NULL, 0), "remove backups not in backup.info current");
+        TEST_RESULT_BOOL(removeExpiredBackup(infoBackup, NULL, 0), true, "remove backups not in backup.info current");
 
         TEST_RESULT_LOG(
             "P00   INFO: repo1: remove expired backup 20181119-152100F_20181119-152152D\n"
@@ -439,7 +444,7 @@ testRun(void)
 
         TEST_ASSIGN(infoBackup, infoBackupNewLoad(ioBufferReadNew(backupInfoContent)), "get backup.info");
 
-        TEST_RESULT_VOID(removeExpiredBackup(infoBackup, NULL, 0), "remove backups - backup.info current empty");
+        TEST_RESULT_BOOL(removeExpiredBackup(infoBackup, NULL, 0), true, "remove backups - backup.info current empty");
 
         TEST_RESULT_LOG("P00   INFO: repo1: remove expired backup 20181119-152138F");
         TEST_STORAGE_LIST(
@@ -449,6 +454,141 @@ testRun(void)
             "backup.info\n");
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("removeExpiredDedup()"))
+    {
+        //--------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("no dedup store");
+
+        StringList *argList = strLstDup(argListBase);
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        HRN_CFG_LOAD(cfgCmdExpire, argList);
+
+        const Buffer *backupInfoContent = harnessInfoChecksumZ
+        (
+            "[db]\n"
+            "db-catalog-version=201909212\n"
+            "db-control-version=1201\n"
+            "db-id=1\n"
+            "db-system-id=6626363367545678089\n"
+            "db-version=\"12\"\n"
+            "\n"
+            "[db:history]\n"
+            "1={\"db-catalog-version\":201909212,\"db-control-version\":1201,\"db-system-id\":6626363367545678089,"
+                "\"db-version\":\"12\"}"
+        );
+
+        InfoBackup *infoBackup = NULL;
+        TEST_ASSIGN(infoBackup, infoBackupNewLoad(ioBufferReadNew(backupInfoContent)), "get backup.info");
+
+        TEST_RESULT_VOID(removeExpiredDedup(infoBackup, 0), "nothing to remove");
+
+        //--------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("remove unreferenced files - dry run");
+
+        #define TEST_MANIFEST_DEDUP_HEADER                                                                                         \
+            "[backup]\n"                                                                                                           \
+            "backup-label=null\n"                                                                                                  \
+            "backup-timestamp-copy-start=0\n"                                                                                      \
+            "backup-timestamp-start=0\n"                                                                                           \
+            "backup-timestamp-stop=0\n"                                                                                            \
+            "backup-type=\"full\"\n"                                                                                               \
+            "\n"                                                                                                                   \
+            "[backup:db]\n"                                                                                                        \
+            "db-catalog-version=201909212\n"                                                                                       \
+            "db-control-version=1201\n"                                                                                            \
+            "db-id=1\n"                                                                                                            \
+            "db-system-id=6626363367545678089\n"                                                                                   \
+            "db-version=\"12\"\n"                                                                                                  \
+            "\n"                                                                                                                   \
+            "[backup:option]\n"                                                                                                    \
+            "option-archive-check=false\n"                                                                                         \
+            "option-archive-copy=false\n"                                                                                          \
+            "option-compress=false\n"                                                                                              \
+            "option-compress-type=\"none\"\n"                                                                                      \
+            "option-hardlink=false\n"                                                                                              \
+            "option-online=false\n"                                                                                                \
+            "\n"                                                                                                                   \
+            "[backup:target]\n"                                                                                                    \
+            "pg_data={\"path\":\"" TEST_PATH "/pg\",\"type\":\"path\"}\n"                                                         \
+            "\n"                                                                                                                   \
+            "[target:file]\n"
+
+        #define TEST_MANIFEST_DEDUP_FOOTER                                                                                         \
+            "\n"                                                                                                                   \
+            "[target:file:default]\n"                                                                                              \
+            "group=\"postgres\"\n"                                                                                                 \
+            "mode=\"0600\"\n"                                                                                                      \
+            "user=\"postgres\"\n"                                                                                                  \
+            "\n"                                                                                                                   \
+            "[target:path]\n"                                                                                                      \
+            "pg_data={}\n"                                                                                                         \
+            "\n"                                                                                                                   \
+            "[target:path:default]\n"                                                                                              \
+            "group=\"postgres\"\n"                                                                                                 \
+            "mode=\"0700\"\n"                                                                                                      \
+            "user=\"postgres\"\n"
+
+        // Backup referencing a file in the dedup store
+        HRN_INFO_PUT(
+            storageRepoWrite(), STORAGE_REPO_BACKUP "/20181119-152138F/" BACKUP_MANIFEST_FILE,
+            TEST_MANIFEST_DEDUP_HEADER
+            "pg_data/PG_VERSION={\"checksum\":\"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\",\"dedup\":true,\"size\":3"
+                ",\"timestamp\":1565282100}\n"
+            "pg_data/postgresql.conf={\"checksum\":\"dddddddddddddddddddddddddddddddddddddddd\",\"size\":3"
+                ",\"timestamp\":1565282100}\n"
+            TEST_MANIFEST_DEDUP_FOOTER);
+
+        // Resumable backup referencing a file in the dedup store
+        HRN_INFO_PUT(
+            storageRepoWrite(), STORAGE_REPO_BACKUP "/20181119-152138F_20181119-152155I/" BACKUP_MANIFEST_FILE INFO_COPY_EXT,
+            TEST_MANIFEST_DEDUP_HEADER
+            "pg_data/PG_VERSION={\"checksum\":\"bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb\",\"dedup\":true,\"size\":3"
+                ",\"timestamp\":1565282100}\n"
+            TEST_MANIFEST_DEDUP_FOOTER);
+
+        // Backup aborted before the manifest was saved
+        HRN_STORAGE_PATH_CREATE(storageRepoWrite(), STORAGE_REPO_BACKUP "/20181119-152138F_20181119-152152I");
+
+        // Files in the dedup store
+        HRN_STORAGE_PUT_Z(storageRepoWrite(), STORAGE_REPO_BACKUP "/dedup/aa/aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa", "AAA");
+        HRN_STORAGE_PUT_Z(storageRepoWrite(), STORAGE_REPO_BACKUP "/dedup/bb/bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb", "BBB");
+        HRN_STORAGE_PUT_Z(storageRepoWrite(), STORAGE_REPO_BACKUP "/dedup/cc/cccccccccccccccccccccccccccccccccccccccc", "CCC");
+        HRN_STORAGE_PUT_Z(storageRepoWrite(), STORAGE_REPO_BACKUP "/dedup/12345.tmp", "CC");
+
+        argList = strLstDup(argListBase);
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        hrnCfgArgRawBool(argList, cfgOptDryRun, true);
+        HRN_CFG_LOAD(cfgCmdExpire, argList);
+
+        TEST_RESULT_VOID(removeExpiredDedup(infoBackup, 0), "dry run");
+
+        TEST_RESULT_LOG(
+            "P00   INFO: [DRY-RUN] repo1: remove expired dedup file dedup/12345.tmp\n"
+            "P00   INFO: [DRY-RUN] repo1: remove expired dedup file dedup/cc/cccccccccccccccccccccccccccccccccccccccc");
+
+        //--------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("remove unreferenced files");
+
+        argList = strLstDup(argListBase);
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        HRN_CFG_LOAD(cfgCmdExpire, argList);
+
+        TEST_RESULT_VOID(removeExpiredDedup(infoBackup, 0), "remove");
+
+        TEST_RESULT_LOG(
+            "P00   INFO: repo1: remove expired dedup file dedup/12345.tmp\n"
+            "P00   INFO: repo1: remove expired dedup file dedup/cc/cccccccccccccccccccccccccccccccccccccccc");
+
+        TEST_STORAGE_LIST(
+            storageRepo(), STORAGE_REPO_BACKUP "/dedup",
+            "aa/\n"
+            "aa/aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\n"
+            "bb/\n"
+            "bb/bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb\n"
+            "cc/\n");
+    }
+
     // *****************************************************************************************************************************
     if (testBegin("removeExpiredArchive() & cmdExpire()"))
     {
@@ -2083,8 +2223,8 @@ testRun(void)
 
         const String *adhocBackupLabel = STRDEF("20181119-152850F_20181119-152252D");
         TEST_RESULT_UINT(expireAdhocBackup(infoBackup, adhocBackupLabel, 0), 1, "adhoc expire last dependent backup");
-        TEST_RESULT_VOID(
-            removeExpiredBackup(infoBackup, adhocBackupLabel, 0), "code coverage: removeExpireBackup with no manifests");
+        TEST_RESULT_BOOL(
+            removeExpiredBackup(infoBackup, adhocBackupLabel, 0), true, "code coverage: removeExpireBackup with no manifests");
         TEST_RESULT_LOG(
             "P00   WARN: [DRY-RUN] repo1: expiring latest backup 20181119-152850F_20181119-152252D - the ability to perform"
                 " point-in-time-recovery (PITR) may be affected\n"
@@ -2521,5 +2661,71 @@ testRun(void)
         harnessLogLevelReset();
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("expireRemoveAdd() and expireRemoveProcess()"))
+    {
+        //--------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("batch files and add a job for each path");
+
+        StringList *argList = strLstDup(argListAvoidWarn);
+        hrnCfgArgRawZ(argList, cfgOptProcessMax, "2");
+        HRN_CFG_LOAD(cfgCmdExpire, argList);
+
+        ExpireRemove remove = {.repoIdx = 0, .jobList = lstNewP(sizeof(ExpireRemoveJob))};
+
+        for (unsigned int fileIdx = 0; fileIdx <= EXPIRE_REMOVE_FILE_MAX; fileIdx++)
+        {
+            const String *const file = strNewFmt(STORAGE_REPO_ARCHIVE "/9.4-1/0000000100000000/%08X", fileIdx);
+
+            HRN_STORAGE_PUT_EMPTY(storageRepoWrite(), strZ(file));
+            expireRemoveAdd(&remove, file, false);
+        }
+
+        HRN_STORAGE_PUT_EMPTY(storageRepoWrite(), STORAGE_REPO_BACKUP "/20181119-152138F/" BACKUP_MANIFEST_FILE);
+        expireRemoveAdd(&remove, STRDEF(STORAGE_REPO_BACKUP "/20181119-152138F"), true);
+
+        TEST_RESULT_UINT(lstSize(remove.jobList), 3, "job total");
+        TEST_RESULT_UINT(
+            strLstSize(((ExpireRemoveJob *)lstGet(remove.jobList, 0))->nameList), EXPIRE_REMOVE_FILE_MAX, "first job is full");
+        TEST_RESULT_UINT(strLstSize(((ExpireRemoveJob *)lstGet(remove.jobList, 1))->nameList), 1, "second job has one file");
+
+        //--------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("remove in parallel");
+
+        TEST_RESULT_VOID(expireRemoveProcess(&remove), "remove");
+        TEST_STORAGE_LIST_EMPTY(storageRepo(), STORAGE_REPO_ARCHIVE "/9.4-1/0000000100000000");
+        TEST_STORAGE_LIST_EMPTY(storageRepo(), STORAGE_REPO_BACKUP);
+
+        //--------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("single job is removed without locals");
+
+        HRN_STORAGE_PUT_EMPTY(storageRepoWrite(), STORAGE_REPO_BACKUP "/20181119-152138F/" BACKUP_MANIFEST_FILE);
+
+        remove = (ExpireRemove){.repoIdx = 0, .jobList = lstNewP(sizeof(ExpireRemoveJob))};
+        expireRemoveAdd(&remove, STRDEF(STORAGE_REPO_BACKUP "/20181119-152138F"), true);
+
+        TEST_RESULT_VOID(expireRemoveProcess(&remove), "remove");
+        TEST_STORAGE_LIST_EMPTY(storageRepo(), STORAGE_REPO_BACKUP);
+
+        //--------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("error on remove in parallel");
+
+        argList = strLstDup(argListAvoidWarn);
+        hrnCfgArgRawZ(argList, cfgOptProcessMax, "3");
+        HRN_CFG_LOAD(cfgCmdExpire, argList);
+
+        HRN_STORAGE_PUT_EMPTY(storageRepoWrite(), STORAGE_REPO_BACKUP "/" BOGUS_STR);
+        HRN_STORAGE_PUT_EMPTY(storageRepoWrite(), STORAGE_REPO_BACKUP "/" BOGUS_STR "2");
+
+        remove = (ExpireRemove){.repoIdx = 0, .jobList = lstNewP(sizeof(ExpireRemoveJob))};
+        expireRemoveAdd(&remove, STRDEF(STORAGE_REPO_BACKUP "/" BOGUS_STR), true);
+        expireRemoveAdd(&remove, STRDEF(STORAGE_REPO_BACKUP "/" BOGUS_STR "2"), true);
+
+        TEST_ERROR(
+            expireRemoveProcess(&remove), PathOpenError,
+            "raised from local-1 shim protocol: unable to list file info for path '" TEST_PATH "/repo/backup/db/BOGUS': [20] Not a"
+            " directory");
+    }
+
     FUNCTION_HARNESS_RETURN_VOID();
 }
@@ -60,6 +60,7 @@ testRun(void)
         "    expire          Expire backups that exceed retention.\n"
         "    help            Get help.\n"
         "    info            Retrieve information about backups.\n"
+        "    repo-copy       Copy backups and WAL to another repository.\n"
         "    repo-get        Get a file from a repository.\n"
         "    repo-ls         List files in a repository.\n"
         "    restore         Restore a database cluster.\n"
@@ -200,11 +201,20 @@ testRun(void)
             "  --db-exclude                      restore excluding the specified databases\n"
             "  --db-include                      restore only specified databases\n"
             "                                    [current=db1, db2]\n"
+            "  --fanout-path                     restore to additional data directories\n"
             "  --force                           force a restore [default=n]\n"
             "  --link-all                        restore all symlinks [default=n]\n"
             "  --link-map                        modify the destination of a symlink\n"
             "                                    [current=/link1=/dest1, /link2=/dest2]\n"
             "  --recovery-option                 set an option in recovery.conf\n"
+            "  --repo-share                      read files from all repositories that\n"
+            "                                    contain the backup set [default=n]\n"
+            "  --restore-priority                restore files needed to start the cluster\n"
+            "                                    and small files first [default=n]\n"
+            "  --restore-progress                interval between restore progress messages\n"
+            "                                    [default=60]\n"
+            "  --restore-sparse                  write blocks that are all zeros as holes\n"
+            "                                    [default=n]\n"
             "  --set                             backup set to restore [default=latest]\n"
             "  --tablespace-map                  restore a tablespace into the specified\n"
             "                                    directory\n"
@@ -234,18 +244,30 @@ testRun(void)
             "                                    [default=/etc/pgbackrest]\n"
             "  --delta                           restore or backup using checksums\n"
             "                                    [default=n]\n"
+            "  --io-rate-iops                    I/O operations per second limit [default=0]\n"
+            "  --io-rate-read                    read bandwidth limit [default=0]\n"
+            "  --io-rate-write                   write bandwidth limit [default=0]\n"
             "  --io-timeout                      I/O timeout [default=60]\n"
             "  --lock-path                       path where lock files are stored\n"
             "                                    [default=/tmp/pgbackrest]\n"
             "  --neutral-umask                   use a neutral umask [default=y]\n"
+            "  --process-fork                    fork local processes without executing a\n"
+            "                                    new binary [default=n]\n"
+            "  --process-latency-target          target latency for adapting the number of\n"
+            "                                    processes\n"
             "  --process-max                     max processes to use for compress/transfer\n"
             "                                    [default=1]\n"
+            "  --process-min                     min processes to use for compress/transfer\n"
             "  --protocol-timeout                protocol timeout [default=1830]\n"
             "  --sck-keep-alive                  keep-alive enable [default=y]\n"
             "  --stanza                          defines the stanza\n"
+            "  --stat-file                       file where statistics are written at\n"
+            "                                    command end\n"
             "  --tcp-keep-alive-count            keep-alive count\n"
             "  --tcp-keep-alive-idle             keep-alive idle time\n"
             "  --tcp-keep-alive-interval         keep-alive interval time\n"
+            "  --trace-file                      file where a trace of the command is\n"
+            "                                    written at command end\n"
             "\n"
             "Log Options:\n"
             "\n"
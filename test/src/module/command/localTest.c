@@ -1,8 +1,11 @@
 /***********************************************************************************************************************************
 Test Local Command
 ***********************************************************************************************************************************/
+#include "common/exec.h"
 #include "common/io/fdRead.h"
 #include "common/io/fdWrite.h"
+#include "common/io/filter/rate.h"
+#include "common/io/io.h"
 #include "protocol/client.h"
 #include "protocol/server.h"
 
@@ -47,6 +50,94 @@ testRun(void)
             HRN_FORK_PARENT_END();
         }
         HRN_FORK_END();
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("local with tracing and rate limits enabled");
+
+        HRN_FORK_BEGIN()
+        {
+            HRN_FORK_CHILD_BEGIN()
+            {
+                StringList *argList = strLstNew();
+                hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+                hrnCfgArgRawZ(argList, cfgOptPgPath, "/path/to/pg");
+                hrnCfgArgRawZ(argList, cfgOptProcess, "2");
+                hrnCfgArgRawZ(argList, cfgOptTraceFile, TEST_PATH "/trace.json");
+                hrnCfgArgRawZ(argList, cfgOptIoRateRead, "1MiB");
+                hrnCfgArgRawStrId(argList, cfgOptRemoteType, protocolStorageTypePg);
+                HRN_CFG_LOAD(cfgCmdBackup, argList, .role = cfgCmdRoleLocal);
+
+                cmdLocal(
+                    protocolServerNew(
+                        PROTOCOL_SERVICE_LOCAL_STR, PROTOCOL_SERVICE_LOCAL_STR, HRN_FORK_CHILD_READ(), HRN_FORK_CHILD_WRITE()));
+
+                TEST_RESULT_BOOL(traceEnabled(), true, "tracing enabled");
+
+                IoFilterGroup *const filterGroup = ioFilterGroupNew();
+                ioRateAdd(filterGroup, ioRateTypeRead);
+                TEST_RESULT_UINT(ioFilterGroupSize(filterGroup), 1, "rate limited");
+            }
+            HRN_FORK_CHILD_END();
+
+            HRN_FORK_PARENT_BEGIN()
+            {
+                ProtocolClient *client = protocolClientNew(
+                    STRDEF("test"), PROTOCOL_SERVICE_LOCAL_STR, HRN_FORK_PARENT_READ(0), HRN_FORK_PARENT_WRITE(0));
+                protocolClientNoOp(client);
+                protocolClientFree(client);
+            }
+            HRN_FORK_PARENT_END();
+        }
+        HRN_FORK_END();
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("cmdLocalFork()"))
+    {
+        TEST_TITLE("local in forked process");
+
+        StringList *argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, "/path/to/pg");
+        hrnCfgArgRawZ(argList, cfgOptProcess, "1");
+        hrnCfgArgRawStrId(argList, cfgOptRemoteType, protocolStorageTypeRepo);
+        hrnCfgArgRawNegate(argList, cfgOptConfig);
+        hrnCfgArgRawZ(argList, cfgOptLogLevelConsole, "off");
+        hrnCfgArgRawZ(argList, cfgOptLogLevelStderr, "error");
+        hrnCfgArgRawZ(argList, cfgOptLogLevelFile, "off");
+        strLstAddZ(argList, CFGCMD_ARCHIVE_GET ":" CONFIG_COMMAND_ROLE_LOCAL);
+
+        Exec *exec = NULL;
+        TEST_ASSIGN(
+            exec, execNewP(STRDEF("pgbackrest"), argList, STRDEF("local"), 5000, .fork = cmdLocalFork, .ringSize = ioBufferSize()),
+            "new local");
+        TEST_RESULT_VOID(execOpen(exec), "fork local");
+
+        ProtocolClient *client = NULL;
+        TEST_ASSIGN(
+            client, protocolClientNew(STRDEF("test"), PROTOCOL_SERVICE_LOCAL_STR, execIoRead(exec), execIoWrite(exec)),
+            "new client");
+        TEST_RESULT_VOID(protocolClientNoOp(client), "noop");
+        TEST_RESULT_VOID(protocolClientFree(client), "free client");
+        TEST_RESULT_VOID(execFree(exec), "free local");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("error in forked local");
+
+        argList = strLstNew();
+        hrnCfgArgRawNegate(argList, cfgOptConfig);
+        hrnCfgArgRawZ(argList, cfgOptLogLevelConsole, "off");
+        hrnCfgArgRawZ(argList, cfgOptLogLevelStderr, "error");
+        hrnCfgArgRawZ(argList, cfgOptLogLevelFile, "off");
+        strLstAddZ(argList, CFGCMD_ARCHIVE_GET ":" CONFIG_COMMAND_ROLE_LOCAL);
+
+        TEST_ASSIGN(exec, execNewP(STRDEF("pgbackrest"), argList, STRDEF("local"), 5000, .fork = cmdLocalFork), "new local");
+        TEST_RESULT_VOID(execOpen(exec), "fork local");
+
+        TEST_ERROR(
+            protocolClientNew(STRDEF("test"), PROTOCOL_SERVICE_LOCAL_STR, execIoRead(exec), execIoWrite(exec)), OptionRequiredError,
+            "local terminated unexpectedly [37]");
+        TEST_RESULT_VOID(execFree(exec), "free local");
     }
 
     FUNCTION_HARNESS_RETURN_VOID();
@@ -1,15 +1,79 @@
 /***********************************************************************************************************************************
 Test Repo Commands
 ***********************************************************************************************************************************/
+#include "common/crypto/cipherBlock.h"
 #include "common/io/bufferRead.h"
 #include "common/io/bufferWrite.h"
 #include "storage/posix/storage.h"
 
 #include "common/harnessConfig.h"
 #include "common/harnessInfo.h"
+#include "common/harnessPostgres.h"
 
 #include "info/infoArchive.h"
 #include "info/infoBackup.h"
+#include "info/manifest.h"
+
+/***********************************************************************************************************************************
+Build a manifest for the repo copy tests
+***********************************************************************************************************************************/
+static const char *
+testRepoCopyManifest(
+    const char *const label, const char *const prior, const unsigned int pgId, const bool pg11, const char *const file)
+{
+    return zNewFmt(
+        "[backup]\n"
+        "backup-archive-start=\"000000010000000000000001\"\n"
+        "backup-archive-stop=\"000000010000000000000001\"\n"
+        "backup-label=\"%s\"\n"
+        "%s"
+        "backup-timestamp-copy-start=0\n"
+        "backup-timestamp-start=0\n"
+        "backup-timestamp-stop=0\n"
+        "backup-type=\"%s\"\n"
+        "\n"
+        "[backup:db]\n"
+        "db-catalog-version=%s\n"
+        "db-control-version=%s\n"
+        "db-id=%u\n"
+        "db-system-id=%s\n"
+        "db-version=\"%s\"\n"
+        "\n"
+        "[backup:option]\n"
+        "option-archive-check=false\n"
+        "option-archive-copy=false\n"
+        "option-checksum-page=false\n"
+        "option-compress=false\n"
+        "option-compress-type=\"none\"\n"
+        "option-hardlink=false\n"
+        "option-online=false\n"
+        "\n"
+        "[backup:target]\n"
+        "pg_data={\"path\":\"/pg/base\",\"type\":\"path\"}\n"
+        "\n"
+        "[db]\n"
+        "postgres={\"db-id\":12173,\"db-last-system-id\":12168}\n"
+        "\n"
+        "[target:file]\n"
+        "pg_data/PG_VERSION={\"checksum\":\"184473f470864e067ee3a22e64b47b0a1c356f29\",\"size\":4,\"timestamp\":1565282114}\n"
+        "%s"
+        "\n"
+        "[target:file:default]\n"
+        "group=\"group1\"\n"
+        "mode=\"0600\"\n"
+        "user=\"user1\"\n"
+        "\n"
+        "[target:path]\n"
+        "pg_data={}\n"
+        "\n"
+        "[target:path:default]\n"
+        "group=\"group1\"\n"
+        "mode=\"0700\"\n"
+        "user=\"user1\"\n",
+        label, prior == NULL ? "" : zNewFmt("backup-prior=\"%s\"\n", prior), prior == NULL ? "full" : "diff",
+        pg11 ? "201809051" : "201409291", pg11 ? "1100" : "942", pgId, pg11 ? HRN_PG_SYSTEMID_11_Z : HRN_PG_SYSTEMID_94_Z,
+        pg11 ? "11" : "9.4", file == NULL ? "" : file);
+}
 
 /***********************************************************************************************************************************
 Test Run
@@ -852,5 +916,324 @@ testRun(void)
         TEST_STORAGE_LIST(storageRepo(), NULL, "path/\n", .comment = "check path exists and file removed");
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("cmdRepoCopy()"))
+    {
+        StringList *argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test");
+        hrnCfgArgKeyRawZ(argList, cfgOptRepoPath, 1, TEST_PATH "/repo1");
+        hrnCfgArgKeyRawZ(argList, cfgOptRepoPath, 2, TEST_PATH "/repo2");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("error on invalid target repo");
+
+        StringList *argListTarget = strLstDup(argList);
+        hrnCfgArgRawZ(argListTarget, cfgOptRepoTarget, "1");
+        HRN_CFG_LOAD(cfgCmdRepoCopy, argListTarget);
+
+        TEST_ERROR(
+            cmdRepoCopy(), OptionInvalidError,
+            "'1' is not valid for 'repo-target' option\n"
+            "HINT: the repo must be configured and not be the repo selected for the copy.");
+
+        argListTarget = strLstDup(argList);
+        hrnCfgArgRawZ(argListTarget, cfgOptRepoTarget, "3");
+        HRN_CFG_LOAD(cfgCmdRepoCopy, argListTarget);
+
+        TEST_ERROR(
+            cmdRepoCopy(), OptionInvalidError,
+            "'3' is not valid for 'repo-target' option\n"
+            "HINT: the repo must be configured and not be the repo selected for the copy.");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("error on different cipher type");
+
+        argListTarget = strLstDup(argList);
+        hrnCfgArgRawZ(argListTarget, cfgOptRepoTarget, "2");
+        hrnCfgArgKeyRawStrId(argListTarget, cfgOptRepoCipherType, 2, cipherTypeAes256Cbc);
+        hrnCfgEnvKeyRawZ(cfgOptRepoCipherPass, 2, TEST_CIPHER_PASS);
+        HRN_CFG_LOAD(cfgCmdRepoCopy, argListTarget);
+        hrnCfgEnvKeyRemoveRaw(cfgOptRepoCipherPass, 2);
+
+        TEST_ERROR(
+            cmdRepoCopy(), OptionInvalidError,
+            "'2' is not valid for 'repo-target' option\n"
+            "HINT: the repo must have the same 'repo2-cipher-type' as the repo selected for the copy.");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("copy WAL and backups that match the target history");
+
+        hrnCfgArgRawZ(argList, cfgOptRepoTarget, "2");
+        HRN_CFG_LOAD(cfgCmdRepoCopy, argList);
+
+        // Source repo has a 9.4 history that is not in the target and an 11 history that has a different id in the target
+        HRN_INFO_PUT(
+            storageRepoIdxWrite(0), INFO_ARCHIVE_PATH_FILE,
+            "[db]\n"
+            "db-id=2\n"
+            "db-system-id=" HRN_PG_SYSTEMID_11_Z "\n"
+            "db-version=\"11\"\n"
+            "\n"
+            "[db:history]\n"
+            "1={\"db-id\":" HRN_PG_SYSTEMID_94_Z ",\"db-version\":\"9.4\"}\n"
+            "2={\"db-id\":" HRN_PG_SYSTEMID_11_Z ",\"db-version\":\"11\"}\n");
+        HRN_INFO_PUT(
+            storageRepoIdxWrite(1), INFO_ARCHIVE_PATH_FILE,
+            "[db]\n"
+            "db-id=1\n"
+            "db-system-id=" HRN_PG_SYSTEMID_11_Z "\n"
+            "db-version=\"11\"\n"
+            "\n"
+            "[db:history]\n"
+            "1={\"db-id\":" HRN_PG_SYSTEMID_11_Z ",\"db-version\":\"11\"}\n");
+
+        #define TEST_REPO_COPY_BACKUP(label, prior, type, pgId)                                                                    \
+            label "={\"backrest-format\":5,\"backrest-version\":\"2.48\","                                                         \
+            "\"backup-archive-start\":\"000000010000000000000001\",\"backup-archive-stop\":\"000000010000000000000001\","          \
+            "\"backup-info-repo-size\":4,\"backup-info-repo-size-delta\":4,\"backup-info-size\":4,"                                \
+            "\"backup-info-size-delta\":4," prior "\"backup-timestamp-start\":0,\"backup-timestamp-stop\":0,"                      \
+            "\"backup-type\":\"" type "\",\"db-id\":" pgId ",\"option-archive-check\":false,\"option-archive-copy\":false,"        \
+            "\"option-backup-standby\":false,\"option-checksum-page\":false,\"option-compress\":false,"                            \
+            "\"option-hardlink\":false,\"option-online\":false}\n"
+
+        HRN_INFO_PUT(
+            storageRepoIdxWrite(0), INFO_BACKUP_PATH_FILE,
+            "[backup:current]\n"
+            TEST_REPO_COPY_BACKUP("20190101-000000F", "", "full", "1")
+            TEST_REPO_COPY_BACKUP(
+                "20190101-000000F_20190102-000000I", "\"backup-prior\":\"20190101-000000F\",", "incr", "1")
+            TEST_REPO_COPY_BACKUP("20190103-000000F", "", "full", "2")
+            TEST_REPO_COPY_BACKUP(
+                "20190103-000000F_20190104-000000D", "\"backup-prior\":\"20190103-000000F\",", "diff", "2")
+            "\n"
+            "[db]\n"
+            "db-catalog-version=201809051\n"
+            "db-control-version=1100\n"
+            "db-id=2\n"
+            "db-system-id=" HRN_PG_SYSTEMID_11_Z "\n"
+            "db-version=\"11\"\n"
+            "\n"
+            "[db:history]\n"
+            "1={\"db-catalog-version\":201409291,\"db-control-version\":942,\"db-system-id\":" HRN_PG_SYSTEMID_94_Z ","
+                "\"db-version\":\"9.4\"}\n"
+            "2={\"db-catalog-version\":201809051,\"db-control-version\":1100,\"db-system-id\":" HRN_PG_SYSTEMID_11_Z ","
+                "\"db-version\":\"11\"}\n");
+        HRN_INFO_PUT(
+            storageRepoIdxWrite(1), INFO_BACKUP_PATH_FILE,
+            "[db]\n"
+            "db-catalog-version=201809051\n"
+            "db-control-version=1100\n"
+            "db-id=1\n"
+            "db-system-id=" HRN_PG_SYSTEMID_11_Z "\n"
+            "db-version=\"11\"\n"
+            "\n"
+            "[db:history]\n"
+            "1={\"db-catalog-version\":201809051,\"db-control-version\":1100,\"db-system-id\":" HRN_PG_SYSTEMID_11_Z ","
+                "\"db-version\":\"11\"}\n");
+
+        // WAL
+        HRN_STORAGE_PUT_Z(storageRepoIdxWrite(0), STORAGE_REPO_ARCHIVE "/9.4-1/0000000100000000/000000010000000000000001", "94");
+        HRN_STORAGE_PUT_Z(storageRepoIdxWrite(0), STORAGE_REPO_ARCHIVE "/11-2/00000002.history", "HISTORY");
+        HRN_STORAGE_PUT_Z(storageRepoIdxWrite(0), STORAGE_REPO_ARCHIVE "/11-2/0000000100000000/000000010000000000000001", "WAL1");
+        HRN_STORAGE_PUT_Z(storageRepoIdxWrite(0), STORAGE_REPO_ARCHIVE "/11-2/0000000100000000/000000010000000000000002", "WAL2");
+        HRN_STORAGE_PUT_Z(
+            storageRepoIdxWrite(1), STORAGE_REPO_ARCHIVE "/11-1/0000000100000000/000000010000000000000001", "WAL1-TARGET");
+
+        #define TEST_REPO_COPY_WAL3                                         "0000000100000000/000000010000000000000003"
+        #define TEST_REPO_COPY_WAL3_SHA1                                    "1111111111111111111111111111111111111111"
+        #define TEST_REPO_COPY_WAL3_SHA2                                    "2222222222222222222222222222222222222222"
+
+        HRN_STORAGE_PUT_Z(
+            storageRepoIdxWrite(0), STORAGE_REPO_ARCHIVE "/11-2/" TEST_REPO_COPY_WAL3 "-" TEST_REPO_COPY_WAL3_SHA1 ".gz",
+            "WAL3");
+        HRN_STORAGE_PUT_Z(
+            storageRepoIdxWrite(0), STORAGE_REPO_ARCHIVE "/11-2/" TEST_REPO_COPY_WAL3 ".00000028.backup", "BACKUP3");
+        HRN_STORAGE_PUT_Z(
+            storageRepoIdxWrite(1), STORAGE_REPO_ARCHIVE "/11-1/" TEST_REPO_COPY_WAL3 "-" TEST_REPO_COPY_WAL3_SHA2 ".gz",
+            "WAL3-TARGET");
+
+        // Backups
+        HRN_INFO_PUT(
+            storageRepoIdxWrite(0), STORAGE_REPO_BACKUP "/20190101-000000F/" BACKUP_MANIFEST_FILE,
+            testRepoCopyManifest("20190101-000000F", NULL, 1, false, NULL));
+
+        HRN_INFO_PUT(
+            storageRepoIdxWrite(0), STORAGE_REPO_BACKUP "/20190103-000000F/" BACKUP_MANIFEST_FILE,
+            testRepoCopyManifest("20190103-000000F", NULL, 2, true, NULL));
+        HRN_INFO_PUT(
+            storageRepoIdxWrite(0), STORAGE_REPO_BACKUP "/20190103-000000F/" BACKUP_MANIFEST_FILE INFO_COPY_EXT,
+            testRepoCopyManifest("20190103-000000F", NULL, 2, true, NULL));
+        HRN_STORAGE_PUT_Z(storageRepoIdxWrite(0), STORAGE_REPO_BACKUP "/20190103-000000F/pg_data/PG_VERSION", "11");
+
+        #define TEST_REPO_COPY_DEDUP1                                       "1111111111111111111111111111111111111111"
+        #define TEST_REPO_COPY_DEDUP2                                       "2222222222222222222222222222222222222222"
+
+        HRN_INFO_PUT(
+            storageRepoIdxWrite(0), STORAGE_REPO_BACKUP "/20190103-000000F_20190104-000000D/" BACKUP_MANIFEST_FILE,
+            testRepoCopyManifest(
+                "20190103-000000F_20190104-000000D", "20190103-000000F", 2, true,
+                "pg_data/a={\"checksum\":\"" TEST_REPO_COPY_DEDUP1 "\",\"dedup\":true,\"size\":1,\"timestamp\":1565282114}\n"
+                "pg_data/b={\"checksum\":\"" TEST_REPO_COPY_DEDUP1 "\",\"dedup\":true,\"size\":1,\"timestamp\":1565282114}\n"
+                "pg_data/c={\"checksum\":\"" TEST_REPO_COPY_DEDUP2 "\",\"dedup\":true,\"size\":1,\"timestamp\":1565282114}\n"));
+        HRN_STORAGE_PUT_Z(storageRepoIdxWrite(0), STORAGE_REPO_BACKUP "/20190103-000000F_20190104-000000D/bundle/1", "BUNDLE");
+        HRN_STORAGE_PUT_Z(storageRepoIdxWrite(0), STORAGE_REPO_BACKUP "/dedup/11/" TEST_REPO_COPY_DEDUP1, "1");
+        HRN_STORAGE_PUT_Z(storageRepoIdxWrite(0), STORAGE_REPO_BACKUP "/dedup/22/" TEST_REPO_COPY_DEDUP2, "2");
+        HRN_STORAGE_PUT_Z(storageRepoIdxWrite(1), STORAGE_REPO_BACKUP "/dedup/22/" TEST_REPO_COPY_DEDUP2, "2-TARGET");
+
+        TEST_RESULT_VOID(cmdRepoCopy(), "copy");
+        TEST_RESULT_LOG(
+            "P00   WARN: archive '9.4-1' does not match the history of repo2\n"
+            "            HINT: has the stanza been upgraded in repo2?\n"
+            "P00   WARN: backup '20190101-000000F' does not match the history of repo2\n"
+            "            HINT: has the stanza been upgraded in repo2?\n"
+            "P00   WARN: backup '20190101-000000F_20190102-000000I' skipped since prior backup '20190101-000000F' does not exist in"
+                " repo2\n"
+            "P00   INFO: copy backup 20190103-000000F to repo2\n"
+            "P00   INFO: copy backup 20190103-000000F_20190104-000000D to repo2\n"
+            "P00   INFO: copied 2 backup(s) and 3 WAL file(s) to repo2 (0 file(s) copied by the storage server)");
+
+        TEST_STORAGE_LIST(
+            storageRepoIdx(1), STORAGE_REPO_ARCHIVE,
+            "11-1/\n"
+            "11-1/0000000100000000/\n"
+            "11-1/0000000100000000/000000010000000000000001\n"
+            "11-1/0000000100000000/000000010000000000000002\n"
+            "11-1/" TEST_REPO_COPY_WAL3 "-2222222222222222222222222222222222222222.gz\n"
+            "11-1/" TEST_REPO_COPY_WAL3 ".00000028.backup\n"
+            "11-1/00000002.history\n"
+            "archive.info\n",
+            .comment = "segment already in target with another checksum not copied");
+        TEST_STORAGE_GET(
+            storageRepoIdx(1), STORAGE_REPO_ARCHIVE "/11-1/0000000100000000/000000010000000000000001", "WAL1-TARGET",
+            .comment = "existing WAL not copied");
+        TEST_STORAGE_GET(storageRepoIdx(1), STORAGE_REPO_ARCHIVE "/11-1/0000000100000000/000000010000000000000002", "WAL2");
+
+        TEST_STORAGE_LIST(
+            storageRepoIdx(1), STORAGE_REPO_BACKUP,
+            "20190103-000000F/\n"
+            "20190103-000000F/backup.manifest\n"
+            "20190103-000000F/backup.manifest.copy\n"
+            "20190103-000000F/pg_data/\n"
+            "20190103-000000F/pg_data/PG_VERSION\n"
+            "20190103-000000F_20190104-000000D/\n"
+            "20190103-000000F_20190104-000000D/backup.manifest\n"
+            "20190103-000000F_20190104-000000D/backup.manifest.copy\n"
+            "20190103-000000F_20190104-000000D/bundle/\n"
+            "20190103-000000F_20190104-000000D/bundle/1\n"
+            "backup.history/\n"
+            "backup.history/2019/\n"
+            "backup.history/2019/20190103-000000F.manifest.gz\n"
+            "backup.history/2019/20190103-000000F_20190104-000000D.manifest.gz\n"
+            "backup.info\n"
+            "backup.info.copy\n"
+            "dedup/\n"
+            "dedup/11/\n"
+            "dedup/11/" TEST_REPO_COPY_DEDUP1 "\n"
+            "dedup/22/\n"
+            "dedup/22/" TEST_REPO_COPY_DEDUP2 "\n"
+            "latest>\n");
+        TEST_STORAGE_GET(
+            storageRepoIdx(1), STORAGE_REPO_BACKUP "/dedup/22/" TEST_REPO_COPY_DEDUP2, "2-TARGET",
+            .comment = "existing dedup file not copied");
+
+        InfoBackup *infoBackup = NULL;
+        TEST_ASSIGN(
+            infoBackup, infoBackupLoadFile(storageRepoIdx(1), INFO_BACKUP_PATH_FILE_STR, cipherTypeNone, NULL),
+            "load target backup.info");
+        TEST_RESULT_STRLST_Z(
+            infoBackupDataLabelList(infoBackup, NULL), "20190103-000000F\n20190103-000000F_20190104-000000D\n", "target backups");
+        TEST_RESULT_UINT(infoBackupData(infoBackup, 1).backupPgId, 1, "target pg id");
+
+        Manifest *manifest = NULL;
+        TEST_ASSIGN(
+            manifest,
+            manifestLoadFile(
+                storageRepoIdx(1), STRDEF(STORAGE_REPO_BACKUP "/20190103-000000F_20190104-000000D/" BACKUP_MANIFEST_FILE),
+                cipherTypeNone, NULL),
+            "load target manifest");
+        TEST_RESULT_UINT(manifestData(manifest)->pgId, 1, "target manifest pg id");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("nothing to copy");
+
+        TEST_RESULT_VOID(cmdRepoCopy(), "copy");
+        TEST_RESULT_LOG(
+            "P00   WARN: archive '9.4-1' does not match the history of repo2\n"
+            "            HINT: has the stanza been upgraded in repo2?\n"
+            "P00   WARN: backup '20190101-000000F' does not match the history of repo2\n"
+            "            HINT: has the stanza been upgraded in repo2?\n"
+            "P00   WARN: backup '20190101-000000F_20190102-000000I' skipped since prior backup '20190101-000000F' does not exist in"
+                " repo2\n"
+            "P00   INFO: copied 0 backup(s) and 0 WAL file(s) to repo2 (0 file(s) copied by the storage server)");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("copy between encrypted repos");
+
+        HRN_STORAGE_PATH_REMOVE(storageRepoIdxWrite(0), NULL, .recurse = true);
+        HRN_STORAGE_PATH_REMOVE(storageRepoIdxWrite(1), NULL, .recurse = true);
+
+        hrnCfgArgKeyRawStrId(argList, cfgOptRepoCipherType, 1, cipherTypeAes256Cbc);
+        hrnCfgArgKeyRawStrId(argList, cfgOptRepoCipherType, 2, cipherTypeAes256Cbc);
+        hrnCfgEnvKeyRawZ(cfgOptRepoCipherPass, 1, "pass1");
+        hrnCfgEnvKeyRawZ(cfgOptRepoCipherPass, 2, "pass2");
+        HRN_CFG_LOAD(cfgCmdRepoCopy, argList);
+        hrnCfgEnvKeyRemoveRaw(cfgOptRepoCipherPass, 1);
+        hrnCfgEnvKeyRemoveRaw(cfgOptRepoCipherPass, 2);
+
+        infoArchiveSaveFile(
+            infoArchiveNew(PG_VERSION_11, HRN_PG_SYSTEMID_11, STRDEF("archive1")), storageRepoIdxWrite(0),
+            INFO_ARCHIVE_PATH_FILE_STR, cipherTypeAes256Cbc, STRDEF("pass1"));
+        infoArchiveSaveFile(
+            infoArchiveNew(PG_VERSION_11, HRN_PG_SYSTEMID_11, STRDEF("archive2")), storageRepoIdxWrite(1),
+            INFO_ARCHIVE_PATH_FILE_STR, cipherTypeAes256Cbc, STRDEF("pass2"));
+
+        HRN_STORAGE_PUT_Z(
+            storageRepoIdxWrite(0), STORAGE_REPO_ARCHIVE "/11-1/0000000100000000/000000010000000000000001", "WAL1",
+            .cipherType = cipherTypeAes256Cbc, .cipherPass = "archive1");
+
+        TEST_ASSIGN(
+            manifest,
+            manifestNewLoad(ioBufferReadNew(harnessInfoChecksumZ(testRepoCopyManifest("20190105-000000F", NULL, 1, true, NULL)))),
+            "load manifest");
+        manifestCipherSubPassSet(manifest, STRDEF("backup"));
+
+        IoWrite *write = storageWriteIo(
+            storageNewWriteP(storageRepoIdxWrite(0), STRDEF(STORAGE_REPO_BACKUP "/20190105-000000F/" BACKUP_MANIFEST_FILE)));
+        cipherBlockFilterGroupAdd(ioWriteFilterGroup(write), cipherTypeAes256Cbc, cipherModeEncrypt, STRDEF("backup1"));
+        manifestSave(manifest, write);
+
+        HRN_STORAGE_PUT_Z(
+            storageRepoIdxWrite(0), STORAGE_REPO_BACKUP "/20190105-000000F/pg_data/PG_VERSION", "11",
+            .cipherType = cipherTypeAes256Cbc, .cipherPass = "backup");
+
+        infoBackup = infoBackupNew(PG_VERSION_11, HRN_PG_SYSTEMID_11, hrnPgCatalogVersion(PG_VERSION_11), STRDEF("backup1"));
+        infoBackupDataAdd(infoBackup, manifest);
+        infoBackupSaveFile(
+            infoBackup, storageRepoIdxWrite(0), INFO_BACKUP_PATH_FILE_STR, cipherTypeAes256Cbc, STRDEF("pass1"));
+        infoBackupSaveFile(
+            infoBackupNew(PG_VERSION_11, HRN_PG_SYSTEMID_11, hrnPgCatalogVersion(PG_VERSION_11), STRDEF("backup2")),
+            storageRepoIdxWrite(1), INFO_BACKUP_PATH_FILE_STR, cipherTypeAes256Cbc, STRDEF("pass2"));
+
+        TEST_RESULT_VOID(cmdRepoCopy(), "copy");
+        TEST_RESULT_LOG(
+            "P00   INFO: copy backup 20190105-000000F to repo2\n"
+            "P00   INFO: copied 1 backup(s) and 1 WAL file(s) to repo2 (0 file(s) copied by the storage server)");
+
+        TEST_STORAGE_GET(
+            storageRepoIdx(1), STORAGE_REPO_ARCHIVE "/11-1/0000000100000000/000000010000000000000001", "WAL1",
+            .cipherType = cipherTypeAes256Cbc, .cipherPass = "archive2", .comment = "WAL encrypted with target pass");
+        TEST_STORAGE_GET(
+            storageRepoIdx(1), STORAGE_REPO_BACKUP "/20190105-000000F/pg_data/PG_VERSION", "11",
+            .cipherType = cipherTypeAes256Cbc, .cipherPass = "backup", .comment = "backup file copied as stored");
+
+        TEST_ASSIGN(
+            manifest,
+            manifestLoadFile(
+                storageRepoIdx(1), STRDEF(STORAGE_REPO_BACKUP "/20190105-000000F/" BACKUP_MANIFEST_FILE), cipherTypeAes256Cbc,
+                STRDEF("backup2")),
+            "load target manifest");
+        TEST_RESULT_STR_Z(manifestCipherSubPass(manifest), "backup", "manifest cipher pass");
+    }
+
     FUNCTION_HARNESS_RETURN_VOID();
 }
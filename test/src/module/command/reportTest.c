@@ -0,0 +1,155 @@
+/***********************************************************************************************************************************
+Test Command Reports
+***********************************************************************************************************************************/
+#include "command/exit.h"
+#include "common/stat.h"
+#include "common/trace.h"
+#include "storage/posix/storage.h"
+
+#include "common/harnessConfig.h"
+#include "common/harnessStorage.h"
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+static void
+testRun(void)
+{
+    FUNCTION_HARNESS_VOID();
+
+    Storage *storageTest = storagePosixNewP(TEST_PATH_STR, .write = true);
+
+    // *****************************************************************************************************************************
+    if (testBegin("cmdReportStatCollect() and cmdReportWrite()"))
+    {
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("stats only collected when reported");
+
+        StringList *argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test");
+        HRN_CFG_LOAD(cfgCmdArchivePush, argList);
+
+        TEST_RESULT_BOOL(cmdReportStat(), false, "stats not logged or written");
+
+        harnessLogLevelSet(logLevelDetail);
+        TEST_RESULT_BOOL(cmdReportStat(), true, "stats logged");
+        harnessLogLevelReset();
+
+        TEST_RESULT_VOID(cmdReportStatCollect(), "collect nothing");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("no reports written when none requested");
+
+        TEST_RESULT_VOID(cmdReportWrite(), "write");
+        TEST_STORAGE_LIST_EMPTY(storageTest, NULL, .comment = "no reports");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("stat file written once");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test");
+        hrnCfgArgRawZ(argList, cfgOptStatFile, TEST_PATH "/stat.json");
+        HRN_CFG_LOAD(cfgCmdArchivePush, argList);
+
+        cmdReportLocal.written = false;
+
+        TEST_RESULT_BOOL(cmdReportStat(), true, "stats written");
+        TEST_RESULT_VOID(cmdReportStatCollect(), "collect");
+
+        statInc(STRDEF("test"));
+
+        TEST_RESULT_VOID(cmdReportWrite(), "write");
+        TEST_STORAGE_GET(storageTest, "stat.json", "{\"test\":{\"total\":1}}", .remove = true);
+
+        TEST_RESULT_VOID(cmdReportWrite(), "write again");
+        TEST_STORAGE_LIST_EMPTY(storageTest, NULL, .comment = "not written again");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("stat file written when the command fails");
+
+        HRN_CFG_LOAD(cfgCmdArchivePush, argList);
+
+        cmdReportLocal.written = false;
+        exitReportInit(cmdReportWrite);
+
+        TRY_BEGIN()
+        {
+            THROW(RuntimeError, "test error message");
+        }
+        CATCH_FATAL()
+        {
+            TEST_RESULT_INT(exitSafe(0, true, signalTypeNone), errorTypeCode(&RuntimeError), "exit with error");
+            TEST_RESULT_LOG(
+                "P00  ERROR: [122]: test error message\n"
+                "P00   INFO: archive-push command end: aborted with exception [122]");
+        }
+        TRY_END();
+
+        // Stats from writing the first stat file are also included
+        TEST_RESULT_BOOL(
+            strEndsWithZ(strNewBuf(storageGetP(storageNewReadP(storageTest, STRDEF("stat.json")))), "\"test\":{\"total\":1}}"),
+            true, "stat file written");
+        HRN_STORAGE_REMOVE(storageTest, "stat.json");
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("cmdReportInit()"))
+    {
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("trace not started when no trace file");
+
+        StringList *argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, "/pg");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        TEST_RESULT_VOID(cmdReportInit(), "init");
+        TEST_RESULT_BOOL(traceEnabled(), false, "trace disabled");
+        TEST_RESULT_VOID(cmdReportWrite(), "write");
+        TEST_STORAGE_LIST_EMPTY(storageTest, NULL, .comment = "no reports");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("trace file written when the command fails");
+
+        hrnCfgArgRawZ(argList, cfgOptTraceFile, TEST_PATH "/trace.json");
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        cmdReportLocal.written = false;
+        exitReportInit(cmdReportWrite);
+
+        TEST_RESULT_VOID(cmdReportInit(), "init");
+        TEST_RESULT_BOOL(traceEnabled(), true, "trace enabled");
+
+        TRY_BEGIN()
+        {
+            traceEndP("test", traceBegin());
+            THROW(RuntimeError, "test error message");
+        }
+        CATCH_FATAL()
+        {
+            TEST_RESULT_INT(exitSafe(0, true, signalTypeNone), errorTypeCode(&RuntimeError), "exit with error");
+            TEST_RESULT_LOG(
+                "P00  ERROR: [122]: test error message\n"
+                "P00   INFO: backup command end: aborted with exception [122]");
+        }
+        TRY_END();
+
+        TEST_RESULT_BOOL(
+            strstr(strZ(strNewBuf(storageGetP(storageNewReadP(storageTest, STRDEF("trace.json"))))), "\"name\":\"test\"") != NULL,
+            true, "trace file written");
+        HRN_STORAGE_REMOVE(storageTest, "trace.json");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("trace file name kept when the command changes");
+
+        cmdReportLocal.written = false;
+        cfgCommandSet(cfgCmdExpire, cfgCmdRoleMain);
+
+        TEST_RESULT_VOID(cmdReportWrite(), "write");
+        TEST_STORAGE_EXISTS(storageTest, "trace.json", .remove = true);
+    }
+
+    FUNCTION_HARNESS_RETURN_VOID();
+}
@@ -1,6 +1,8 @@
 /***********************************************************************************************************************************
 Test Restore Command
 ***********************************************************************************************************************************/
+#include <sys/stat.h>
+
 #include "common/compress/helper.h"
 #include "common/crypto/cipherBlock.h"
 #include "postgres/version.h"
@@ -191,10 +193,131 @@ testRun(void)
         TEST_ERROR(
             restoreFile(
                 strNewFmt(STORAGE_REPO_BACKUP "/%s/%s.gz", strZ(repoFileReferenceFull), strZ(repoFile1)), repoIdx, compressTypeGz,
-                0, false, false, STRDEF("badpass"), fileList),
+                0, false, false, false, STRDEF("badpass"), NULL, NULL, fileList),
             ChecksumError,
             "error restoring 'normal': actual checksum 'd1cd8a7d11daa26814b93eb604e1d49ab4b43770' does not match expected checksum"
                 " 'ffffffffffffffffffffffffffffffffffffffff'");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("trace span for each file restored");
+
+        traceInit(1);
+
+        HRN_STORAGE_PUT_Z(
+            storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/gzfile", strZ(repoFileReferenceFull)), "acefile",
+            .compressType = compressTypeGz, .comment = "create a compressed repo file");
+        HRN_STORAGE_PUT_Z(
+            storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/file", strZ(repoFileReferenceFull)), "acefile",
+            .comment = "create a repo file");
+
+        fileList = lstNewP(sizeof(RestoreFile));
+        file.name = STRDEF("gzfile");
+        file.checksum = STRDEF("d1cd8a7d11daa26814b93eb604e1d49ab4b43770");
+        lstAdd(fileList, &file);
+
+        TEST_RESULT_VOID(
+            restoreFile(
+                strNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/gzfile.gz", strZ(repoFileReferenceFull)), repoIdx, compressTypeGz, 0,
+                false, false, false, NULL, NULL, NULL, fileList),
+            "restore compressed file");
+        TEST_RESULT_BOOL(
+            strBeginsWithZ(traceEvent(), "{\"args\":{\"decompressTime\":"), true, "trace span with decompress time");
+        TEST_RESULT_BOOL(
+            strstr(strZ(traceEvent()), "\"size\":7},\"dur\":") != NULL, true, "trace span with size");
+        TEST_RESULT_BOOL(
+            strstr(strZ(traceEvent()), "\"name\":\"restoreFile\",\"ph\":\"X\",\"pid\":1,") != NULL, true, "trace span name");
+
+        traceReset();
+
+        fileList = lstNewP(sizeof(RestoreFile));
+        file.name = STRDEF("file");
+        lstAdd(fileList, &file);
+
+        TEST_RESULT_VOID(
+            restoreFile(
+                strNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/file", strZ(repoFileReferenceFull)), repoIdx, compressTypeNone, 0, false,
+                false, false, NULL, NULL, NULL, fileList),
+            "restore file");
+        TEST_RESULT_BOOL(
+            strBeginsWithZ(traceEvent(), "{\"args\":{\"file\":\"file\",\"hashTime\":"), true,
+            "trace span without decompress time");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("zero blocks are only written as holes when sparse is enabled");
+
+        Buffer *const zeroBuffer = bufNew(16384);
+        memset(bufPtr(zeroBuffer), 0, bufSize(zeroBuffer));
+        bufUsedSet(zeroBuffer, bufSize(zeroBuffer));
+
+        HRN_STORAGE_PUT(
+            storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/zero", strZ(repoFileReferenceFull)), zeroBuffer,
+            .comment = "create a repo file with zero blocks");
+
+        fileList = lstNewP(sizeof(RestoreFile));
+        file.name = STRDEF("zero");
+        file.checksum = STRDEF("897256b6709e1a4da9daba92b6bde39ccfccd8c1");
+        file.size = 16384;
+        lstAdd(fileList, &file);
+
+        struct stat statFile;
+
+        TEST_RESULT_VOID(
+            restoreFile(
+                strNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/zero", strZ(repoFileReferenceFull)), repoIdx, compressTypeNone, 0, false,
+                false, false, NULL, NULL, NULL, fileList),
+            "restore file");
+        TEST_RESULT_INT(stat(TEST_PATH "/pg/zero", &statFile), 0, "stat file");
+        TEST_RESULT_BOOL(statFile.st_blocks > 0, true, "file is not sparse");
+
+        HRN_STORAGE_REMOVE(storagePgWrite(), "zero");
+
+        TEST_RESULT_VOID(
+            restoreFile(
+                strNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/zero", strZ(repoFileReferenceFull)), repoIdx, compressTypeNone, 0, false,
+                false, true, NULL, NULL, NULL, fileList),
+            "restore sparse file");
+        TEST_RESULT_INT(stat(TEST_PATH "/pg/zero", &statFile), 0, "stat file");
+        TEST_RESULT_INT(statFile.st_size, 16384, "file size");
+        TEST_RESULT_INT(statFile.st_blocks, 0, "file is sparse");
+
+        file.size = 7;
+        file.checksum = STRDEF("d1cd8a7d11daa26814b93eb604e1d49ab4b43770");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("fan-out to additional paths");
+
+        HRN_STORAGE_PATH_CREATE(storageTest, "fanout1", .mode = 0700);
+        HRN_STORAGE_PATH_CREATE(storageTest, "fanout2", .mode = 0700);
+
+        StringList *fanoutPathList = strLstNew();
+        strLstAddZ(fanoutPathList, TEST_PATH "/fanout1");
+        strLstAddZ(fanoutPathList, TEST_PATH "/fanout2");
+
+        fileList = lstNewP(sizeof(RestoreFile));
+        file.name = STRDEF(TEST_PATH "/pg/fanout");
+        lstAdd(fileList, &file);
+
+        RestoreFile fileZero = file;
+        fileZero.name = STRDEF(TEST_PATH "/pg/fanout-zero");
+        fileZero.size = 4;
+        fileZero.zero = true;
+        lstAdd(fileList, &fileZero);
+
+        TEST_RESULT_VOID(
+            restoreFile(
+                strNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/gzfile.gz", strZ(repoFileReferenceFull)), repoIdx, compressTypeGz, 0,
+                false, false, false, NULL, NULL, fanoutPathList, fileList),
+            "restore file to pg and fan-out paths");
+
+        TEST_STORAGE_GET(storagePg(), "fanout", "acefile");
+        TEST_STORAGE_GET(storageTest, "fanout1/fanout", "acefile");
+        TEST_STORAGE_GET(storageTest, "fanout2/fanout", "acefile");
+        TEST_STORAGE_LIST(
+            storageTest, "fanout1", "fanout {s=7, t=1557432154}\nfanout-zero {s=4, t=1557432154}\n",
+            .level = storageInfoLevelBasic);
+        TEST_STORAGE_LIST(
+            storageTest, "fanout2", "fanout {s=7, t=1557432154}\nfanout-zero {s=4, t=1557432154}\n",
+            .level = storageInfoLevelBasic);
     }
 
     // *****************************************************************************************************************************
@@ -1085,7 +1208,7 @@ testRun(void)
         userLocalData.userId = TEST_USER_ID + 1;
 
         TEST_ERROR(
-            restoreCleanBuild(manifest, NULL, NULL), PathOpenError,
+            restoreCleanBuild(manifest, NULL, NULL, false), PathOpenError,
             "unable to restore to path '" TEST_PATH "/pg' not owned by current user");
 
         TEST_RESULT_LOG("P00 DETAIL: check '" TEST_PATH "/pg' exists");
@@ -1093,7 +1216,7 @@ testRun(void)
         userLocalData.userRoot = true;
 
         TEST_ERROR(
-            restoreCleanBuild(manifest, TEST_USER_STR, TEST_GROUP_STR), PathOpenError,
+            restoreCleanBuild(manifest, TEST_USER_STR, TEST_GROUP_STR, false), PathOpenError,
             "unable to restore to path '" TEST_PATH "/pg' without rwx permissions");
 
         TEST_RESULT_LOG("P00 DETAIL: check '" TEST_PATH "/pg' exists");
@@ -1101,7 +1224,7 @@ testRun(void)
         userInitInternal();
 
         TEST_ERROR(
-            restoreCleanBuild(manifest, NULL, NULL), PathOpenError,
+            restoreCleanBuild(manifest, NULL, NULL, false), PathOpenError,
             "unable to restore to path '" TEST_PATH "/pg' without rwx permissions");
 
         TEST_RESULT_LOG("P00 DETAIL: check '" TEST_PATH "/pg' exists");
@@ -1115,7 +1238,7 @@ testRun(void)
         HRN_STORAGE_PUT_EMPTY(storagePgWrite(), PG_FILE_RECOVERYCONF);
 
         TEST_ERROR(
-            restoreCleanBuild(manifest, NULL, NULL), PathNotEmptyError,
+            restoreCleanBuild(manifest, NULL, NULL, false), PathNotEmptyError,
             "unable to restore to path '" TEST_PATH "/pg' because it contains files\n"
                 "HINT: try using --delta if this is what you intended.");
 
@@ -1135,7 +1258,7 @@ testRun(void)
 
         HRN_STORAGE_PATH_CREATE(storageTest, "conf", .mode = 0700);
 
-        TEST_RESULT_VOID(restoreCleanBuild(manifest, NULL, NULL), "restore");
+        TEST_RESULT_VOID(restoreCleanBuild(manifest, NULL, NULL, false), "restore");
 
         TEST_RESULT_LOG(
             "P00 DETAIL: check '" TEST_PATH "/pg' exists\n"
@@ -1149,7 +1272,7 @@ testRun(void)
         HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "../conf/pg_hba.conf");
 
         TEST_ERROR(
-            restoreCleanBuild(manifest, NULL, NULL), FileExistsError,
+            restoreCleanBuild(manifest, NULL, NULL, false), FileExistsError,
             "unable to restore file '" TEST_PATH "/conf/pg_hba.conf' because it already exists\n"
             "HINT: try using --delta if this is what you intended.");
 
@@ -1171,7 +1294,7 @@ testRun(void)
         hrnCfgArgRawZ(argList, cfgOptType, "preserve");
         HRN_CFG_LOAD(cfgCmdRestore, argList);
 
-        TEST_RESULT_VOID(restoreCleanBuild(manifest, NULL, NULL), "restore");
+        TEST_RESULT_VOID(restoreCleanBuild(manifest, NULL, NULL, false), "restore");
 
         TEST_RESULT_LOG(
             "P00 DETAIL: check '" TEST_PATH "/pg' exists\n"
@@ -1181,7 +1304,7 @@ testRun(void)
         HRN_SYSTEM_FMT("rm -rf %s/*", strZ(pgPath));
 
         HRN_STORAGE_PUT_EMPTY(storagePgWrite(), PG_FILE_RECOVERYCONF);
-        TEST_RESULT_VOID(restoreCleanBuild(manifest, NULL, NULL), "normal restore ignore recovery.conf");
+        TEST_RESULT_VOID(restoreCleanBuild(manifest, NULL, NULL, false), "normal restore ignore recovery.conf");
 
         TEST_RESULT_LOG(
             "P00 DETAIL: check '" TEST_PATH "/pg' exists\n"
@@ -1195,7 +1318,7 @@ testRun(void)
 
         manifest->pub.data.pgVersion = PG_VERSION_12;
 
-        TEST_RESULT_VOID(restoreCleanBuild(manifest, NULL, NULL), "restore");
+        TEST_RESULT_VOID(restoreCleanBuild(manifest, NULL, NULL, false), "restore");
 
         TEST_RESULT_LOG(
             "P00 DETAIL: check '" TEST_PATH "/pg' exists\n"
@@ -1213,7 +1336,7 @@ testRun(void)
         HRN_STORAGE_PUT_EMPTY(storagePgWrite(), PG_FILE_RECOVERYSIGNAL);
         HRN_STORAGE_PUT_EMPTY(storagePgWrite(), PG_FILE_STANDBYSIGNAL);
 
-        TEST_RESULT_VOID(restoreCleanBuild(manifest, NULL, NULL), "restore");
+        TEST_RESULT_VOID(restoreCleanBuild(manifest, NULL, NULL, false), "restore");
 
         TEST_RESULT_LOG(
             "P00 DETAIL: check '" TEST_PATH "/pg' exists\n"
@@ -1232,12 +1355,134 @@ testRun(void)
         hrnCfgArgRaw(argList, cfgOptPgPath, pgPath);
         HRN_CFG_LOAD(cfgCmdRestore, argList);
 
-        TEST_RESULT_VOID(restoreCleanBuild(manifest, NULL, NULL), "restore");
+        TEST_RESULT_VOID(restoreCleanBuild(manifest, NULL, NULL, false), "restore");
+
+        TEST_RESULT_LOG(
+            "P00 DETAIL: check '" TEST_PATH "/pg' exists\n"
+            "P00 DETAIL: check '" TEST_PATH "/conf' exists\n"
+            "P00 DETAIL: create symlink '" TEST_PATH "/pg/pg_hba.conf' to '../conf/pg_hba.conf'");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("clean paths with jobs");
+
+        HRN_SYSTEM_FMT("rm -rf %s/*", strZ(pgPath));
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
+        hrnCfgArgRaw(argList, cfgOptPgPath, pgPath);
+        hrnCfgArgRawBool(argList, cfgOptDelta, true);
+        HRN_CFG_LOAD(cfgCmdRestore, argList);
+
+        manifest->pub.data.pgCatalogVersion = hrnPgCatalogVersion(PG_VERSION_12);
+
+        manifestTargetAdd(
+            manifest, &(ManifestTarget){
+                .name = STRDEF(MANIFEST_TARGET_PGTBLSPC "/1"), .path = STRDEF(TEST_PATH "/ts/1"), .tablespaceId = 1,
+                .tablespaceName = STRDEF("ts1"), .type = manifestTargetTypeLink});
+        manifestLinkAdd(
+            manifest,
+            &(ManifestLink){
+                .name = STRDEF(MANIFEST_TARGET_PGDATA "/" MANIFEST_TARGET_PGTBLSPC "/1"),
+                .destination = STRDEF(TEST_PATH "/ts/1")});
+        manifestPathAdd(manifest, &(ManifestPath){.name = STRDEF(MANIFEST_TARGET_PGDATA "/base"), .mode = 0700});
+        manifestPathAdd(manifest, &(ManifestPath){.name = STRDEF(MANIFEST_TARGET_PGDATA "/base/1"), .mode = 0700});
+        manifestPathAdd(manifest, &(ManifestPath){.name = STRDEF(MANIFEST_TARGET_PGDATA "/base/2"), .mode = 0700});
+        manifestPathAdd(
+            manifest, &(ManifestPath){.name = STRDEF(MANIFEST_TARGET_PGDATA "/" MANIFEST_TARGET_PGTBLSPC), .mode = 0700});
+        manifestPathAdd(manifest, &(ManifestPath){.name = STRDEF(MANIFEST_TARGET_PGTBLSPC), .mode = 0700});
+        manifestPathAdd(manifest, &(ManifestPath){.name = STRDEF(MANIFEST_TARGET_PGTBLSPC "/1"), .mode = 0700});
+        manifestPathAdd(
+            manifest, &(ManifestPath){.name = STRDEF(MANIFEST_TARGET_PGTBLSPC "/1/PG_12_201909212"), .mode = 0700});
+        manifestPathAdd(
+            manifest, &(ManifestPath){.name = STRDEF(MANIFEST_TARGET_PGTBLSPC "/1/PG_12_201909212/1"), .mode = 0700});
+        manifestFileAdd(manifest, &(ManifestFile){.name = STRDEF(MANIFEST_TARGET_PGDATA "/base/1/1"), .mode = 0600});
+        manifestFileAdd(manifest, &(ManifestFile){.name = STRDEF(MANIFEST_TARGET_PGTBLSPC "/1/PG_12_201909212/1/1"), .mode = 0600});
+
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), PG_FILE_PGVERSION, .modeFile = 0600);
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), BACKUP_MANIFEST_FILE);
+        HRN_STORAGE_PATH_CREATE(storagePgWrite(), "base/1", .mode = 0700);
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "base/1/1", .modeFile = 0600);
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "base/1/bogus", .modeFile = 0600);
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "base/2", .modeFile = 0600);
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "bogus/bogus", .modeFile = 0600);
+        HRN_STORAGE_PATH_CREATE(storagePgWrite(), MANIFEST_TARGET_PGTBLSPC, .mode = 0700);
+        HRN_SYSTEM_FMT("ln -s %s/ts/1 %s/" MANIFEST_TARGET_PGTBLSPC "/1", TEST_PATH, strZ(pgPath));
+        HRN_SYSTEM_FMT("ln -s %s/base %s/base/link", strZ(pgPath), strZ(pgPath));
+        HRN_STORAGE_PATH_CREATE(storageTest, "ts/1/PG_12_201909212/1", .mode = 0700);
+        HRN_STORAGE_PUT_EMPTY(storageTest, "ts/1/PG_12_201909212/1/1", .modeFile = 0640);
+        HRN_STORAGE_PUT_EMPTY(storageTest, "ts/1/PG_12_201909212/bogus", .modeFile = 0600);
+
+        List *cleanList = NULL;
+        TEST_ASSIGN(cleanList, restoreCleanBuild(manifest, NULL, NULL, true), "build clean jobs");
 
         TEST_RESULT_LOG(
             "P00 DETAIL: check '" TEST_PATH "/pg' exists\n"
             "P00 DETAIL: check '" TEST_PATH "/conf' exists\n"
+            "P00 DETAIL: check '" TEST_PATH "/ts/1/PG_12_201909212' exists\n"
+            "P00   INFO: remove invalid files/links/paths from '" TEST_PATH "/pg'\n"
+            "P00   INFO: remove invalid files/links/paths from '" TEST_PATH "/ts/1/PG_12_201909212'");
+
+        String *const cleanStr = strNew();
+
+        for (unsigned int cleanIdx = 0; cleanIdx < lstSize(cleanList); cleanIdx++)
+        {
+            const RestoreCleanJob *const cleanJob = lstGet(cleanList, cleanIdx);
+
+            strCatFmt(
+                cleanStr, "%s {path: %s, queue: %d, entries: %u, ignore: %s}\n", strZ(cleanJob->name),
+                strZ(cleanJob->pgPath), (int)cleanJob->queueIdx, lstSize(cleanJob->entryList),
+                cleanJob->fileIgnore == NULL ? "null" : strZ(strLstJoin(cleanJob->fileIgnore, ",")));
+
+            TEST_RESULT_VOID(restoreClean(cleanJob->pgPath, cleanJob->fileIgnore, cleanJob->entryList), "clean");
+        }
+
+        TEST_RESULT_STR_Z(
+            cleanStr,
+            "pg_data {path: " TEST_PATH "/pg, queue: -1, entries: 4, ignore: backup.manifest}\n"
+            "pg_data/base {path: " TEST_PATH "/pg/base, queue: 0, entries: 2, ignore: null}\n"
+            "pg_data/base/1 {path: " TEST_PATH "/pg/base/1, queue: 0, entries: 1, ignore: null}\n"
+            "pg_data/pg_tblspc {path: " TEST_PATH "/pg/pg_tblspc, queue: -1, entries: 1, ignore: null}\n"
+            "pg_tblspc/1/PG_12_201909212 {path: " TEST_PATH "/ts/1/PG_12_201909212, queue: 1, entries: 1, ignore: null}\n"
+            "pg_tblspc/1/PG_12_201909212/1 {path: " TEST_PATH "/ts/1/PG_12_201909212/1, queue: 1, entries: 1, ignore: null}\n",
+            "check jobs");
+
+        TEST_RESULT_LOG(
+            "P00 DETAIL: remove invalid path '" TEST_PATH "/pg/bogus'\n"
+            "P00 DETAIL: remove invalid file '" TEST_PATH "/pg/base/2'\n"
+            "P00 DETAIL: remove invalid link '" TEST_PATH "/pg/base/link'\n"
+            "P00 DETAIL: remove invalid file '" TEST_PATH "/pg/base/1/bogus'\n"
+            "P00 DETAIL: remove invalid file '" TEST_PATH "/ts/1/PG_12_201909212/bogus'\n"
+            "P00 DETAIL: update mode for '" TEST_PATH "/ts/1/PG_12_201909212/1/1' to 0600");
+
+        TEST_RESULT_VOID(restoreCleanBuildPath(manifest, NULL, NULL, 1), "build tablespace queue");
+        TEST_RESULT_VOID(restoreCleanBuildPath(manifest, NULL, NULL, 0), "build data queue");
+
+        TEST_RESULT_LOG(
+            "P00 DETAIL: create path '" TEST_PATH "/pg/base/2'\n"
             "P00 DETAIL: create symlink '" TEST_PATH "/pg/pg_hba.conf' to '../conf/pg_hba.conf'");
+
+        TEST_STORAGE_LIST(
+            storagePg(), NULL,
+            "PG_VERSION\n"
+            "backup.manifest\n"
+            "base/\n"
+            "base/1/\n"
+            "base/1/1\n"
+            "base/2/\n"
+            "pg_hba.conf>\n"
+            "pg_tblspc/\n"
+            "pg_tblspc/1>\n",
+            .level = storageInfoLevelType);
+        TEST_STORAGE_LIST(
+            storageTest, "ts/1",
+            "PG_12_201909212/\n"
+            "PG_12_201909212/1/\n"
+            "PG_12_201909212/1/1\n",
+            .level = storageInfoLevelType);
+
+        TEST_RESULT_UINT(
+            restoreQueueIdx(manifest, STRDEF(MANIFEST_TARGET_PGTBLSPC "/2")), 0, "unknown tablespace is in the first queue");
     }
 
     // *****************************************************************************************************************************
@@ -2121,6 +2366,530 @@ testRun(void)
             "pg_tblspc/\n",
             .level = storageInfoLevelBasic, .includeDot = true);
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("fan-out restore errors");
+
+        #define TEST_REPO1_MISSING_LOG                                                                                             \
+            "P00   WARN: repo1: [FileMissingError] unable to load info file '" TEST_PATH "/repo/backup/test1/backup.info' or"      \
+            " '" TEST_PATH "/repo/backup/test1/backup.info.copy':\n"                                                               \
+            "            FileMissingError: unable to open missing file '" TEST_PATH "/repo/backup/test1/backup.info' for read\n"   \
+            "            FileMissingError: unable to open missing file '" TEST_PATH "/repo/backup/test1/backup.info.copy'"         \
+            " for read\n"                                                                                                          \
+            "            HINT: backup.info cannot be opened and is required to perform a backup.\n"                                \
+            "            HINT: has a stanza-create been performed?\n"                                                              \
+            "P00   INFO: repo2: restore backup set 20161219-212741F"
+
+        StringList *argListFanout = strLstNew();
+        hrnCfgArgRawZ(argListFanout, cfgOptStanza, "test1");
+        hrnCfgArgKeyRaw(argListFanout, cfgOptRepoPath, 1, repoPath);
+        hrnCfgArgKeyRaw(argListFanout, cfgOptRepoPath, 2, repoPathEncrpyt);
+        hrnCfgArgRaw(argListFanout, cfgOptPgPath, pgPath);
+        hrnCfgArgRawZ(argListFanout, cfgOptSet, "20161219-212741F");
+        hrnCfgArgKeyRawStrId(argListFanout, cfgOptRepoCipherType, 2, cipherTypeAes256Cbc);
+        hrnCfgEnvKeyRawZ(cfgOptRepoCipherPass, 2, TEST_CIPHER_PASS);
+        hrnCfgArgRawZ(argListFanout, cfgOptFanoutPath, TEST_PATH "/fanout1");
+
+        argList = strLstDup(argListFanout);
+        hrnCfgArgRawBool(argList, cfgOptDelta, true);
+        HRN_CFG_LOAD(cfgCmdRestore, argList);
+
+        TEST_ERROR(cmdRestore(), OptionInvalidError, "option 'fanout-path' not valid with 'delta' or 'force' options");
+        TEST_RESULT_LOG(TEST_REPO1_MISSING_LOG);
+
+        argList = strLstDup(argListFanout);
+        hrnCfgArgRawZ(argList, cfgOptFanoutPath, TEST_PATH "/pg/fanout");
+        HRN_CFG_LOAD(cfgCmdRestore, argList);
+
+        TEST_ERROR(
+            cmdRestore(), OptionInvalidError,
+            "'" TEST_PATH "/pg/fanout' is not valid for 'fanout-path' option\n"
+            "HINT: fan-out paths must not overlap with each other or '" TEST_PATH "/pg'.");
+        TEST_RESULT_LOG(TEST_REPO1_MISSING_LOG);
+
+        argList = strLstDup(argListFanout);
+        hrnCfgArgRawZ(argList, cfgOptFanoutPath, "fanout");
+        HRN_CFG_LOAD(cfgCmdRestore, argList);
+
+        TEST_ERROR(
+            cmdRestore(), OptionInvalidError,
+            "'fanout' is not valid for 'fanout-path' option\n"
+            "HINT: fan-out paths must be absolute and not '/'.");
+        TEST_RESULT_LOG(TEST_REPO1_MISSING_LOG);
+
+        HRN_CFG_LOAD(cfgCmdRestore, argListFanout);
+        HRN_STORAGE_PUT_EMPTY(storageTest, "fanout1/file");
+
+        TEST_ERROR(
+            cmdRestore(), PathNotEmptyError, "unable to restore to fan-out path '" TEST_PATH "/fanout1' because it contains files");
+        TEST_RESULT_LOG(TEST_REPO1_MISSING_LOG);
+
+        HRN_STORAGE_PATH_REMOVE(storageTest, "fanout1", .recurse = true, .errorOnMissing = true);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("fan-out restore");
+
+        hrnCfgArgRawZ(argListFanout, cfgOptFanoutPath, TEST_PATH "/fanout2");
+        HRN_CFG_LOAD(cfgCmdRestore, argListFanout);
+
+        HRN_STORAGE_PATH_REMOVE(storagePgWrite(), NULL, .recurse = true, .errorOnMissing = true);
+        HRN_STORAGE_PATH_CREATE(storagePgWrite(), NULL, .mode = 0700);
+        HRN_STORAGE_PATH_CREATE(storageTest, "fanout2", .mode = 0750);
+
+        TEST_RESULT_VOID(cmdRestore(), "successful restore");
+
+        TEST_RESULT_LOG(
+            TEST_REPO1_MISSING_LOG "\n"
+            "P00 DETAIL: create fan-out path '" TEST_PATH "/fanout1'\n"
+            "P00 DETAIL: create fan-out path '" TEST_PATH "/fanout2'\n"
+            "P00 DETAIL: update mode for '" TEST_PATH "/fanout2' to 0700\n"
+            "P00 DETAIL: check '" TEST_PATH "/pg' exists\n"
+            "P00 DETAIL: create path '" TEST_PATH "/pg/global'\n"
+            "P00 DETAIL: create path '" TEST_PATH "/pg/pg_tblspc'\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/PG_VERSION (4B, 100.00%) checksum b74d60e763728399bcd3fb63f7dd1f97b46c6b44\n"
+            "P00   INFO: write " TEST_PATH "/pg/recovery.conf\n"
+            "P00 DETAIL: sync path '" TEST_PATH "/pg'\n"
+            "P00 DETAIL: sync path '" TEST_PATH "/pg/pg_tblspc'\n"
+            "P00   WARN: backup does not contain 'global/pg_control' -- cluster will not start\n"
+            "P00 DETAIL: sync path '" TEST_PATH "/pg/global'\n"
+            "P00   INFO: restore size = 4B, file total = 1");
+
+        HRN_STORAGE_REMOVE(storagePgWrite(), PG_FILE_RECOVERYCONF, .errorOnMissing = true);
+
+        TEST_STORAGE_LIST(
+            storageTest, "fanout1",
+            "./\n"
+            "PG_VERSION\n"
+            "global/\n"
+            "pg_tblspc/\n"
+            "recovery.conf\n",
+            .level = storageInfoLevelType, .includeDot = true);
+        TEST_STORAGE_GET(storageTest, "fanout2/" PG_FILE_PGVERSION, PG_VERSION_90_STR "\n");
+        TEST_RESULT_UINT(storageInfoP(storageTest, STRDEF("fanout2")).mode, 0700, "fan-out path mode");
+
+        HRN_STORAGE_PATH_REMOVE(storageTest, "fanout1", .recurse = true, .errorOnMissing = true);
+        HRN_STORAGE_PATH_REMOVE(storageTest, "fanout2", .recurse = true, .errorOnMissing = true);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("delta restore with clean jobs");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgKeyRaw(argList, cfgOptRepoPath, 1, repoPath);
+        hrnCfgArgKeyRaw(argList, cfgOptRepoPath, 2, repoPathEncrpyt);
+        hrnCfgArgRaw(argList, cfgOptPgPath, pgPath);
+        hrnCfgArgRawBool(argList, cfgOptDelta, true);
+        hrnCfgArgRawZ(argList, cfgOptProcessMax, "2");
+        hrnCfgArgRawZ(argList, cfgOptSet, "20161219-212741F");
+        hrnCfgArgKeyRawStrId(argList, cfgOptRepoCipherType, 2, cipherTypeAes256Cbc);
+        hrnCfgEnvKeyRawZ(cfgOptRepoCipherPass, 2, TEST_CIPHER_PASS);
+        HRN_CFG_LOAD(cfgCmdRestore, argList);
+
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "bogus-file");
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "bogus-path/bogus-file");
+        HRN_STORAGE_PATH_REMOVE(storagePgWrite(), MANIFEST_TARGET_PGTBLSPC, .errorOnMissing = true);
+
+        hrnLogReplaceAdd("P0[1-2] DETAIL: re", "P0[1-2]", "PID", false);
+
+        TEST_RESULT_VOID(cmdRestore(), "successful restore");
+
+        TEST_RESULT_LOG(
+            zNewFmt(
+                "P00   WARN: repo1: [FileMissingError] unable to load info file"
+                " '%s/repo/backup/test1/backup.info' or '%s/repo/backup/test1/backup.info.copy':\n"
+                "            FileMissingError: unable to open missing file '%s/repo/backup/test1/backup.info' for read\n"
+                "            FileMissingError: unable to open missing file '%s/repo/backup/test1/backup.info.copy' for read\n"
+                "            HINT: backup.info cannot be opened and is required to perform a backup.\n"
+                "            HINT: has a stanza-create been performed?\n"
+                "P00   INFO: repo2: restore backup set 20161219-212741F\n"
+                "P00 DETAIL: check '" TEST_PATH "/pg' exists\n"
+                "P00   INFO: remove invalid files/links/paths from '" TEST_PATH "/pg'\n"
+                "[PID] DETAIL: remove invalid file '" TEST_PATH "/pg/bogus-file'\n"
+                "[PID] DETAIL: remove invalid path '" TEST_PATH "/pg/bogus-path'\n"
+                "P00 DETAIL: create path '" TEST_PATH "/pg/pg_tblspc'\n"
+                "[PID] DETAIL: restore file " TEST_PATH "/pg/PG_VERSION - exists and matches backup (4B, 100.00%%) checksum"
+                    " b74d60e763728399bcd3fb63f7dd1f97b46c6b44\n"
+                "P00   INFO: write " TEST_PATH "/pg/recovery.conf\n"
+                "P00 DETAIL: sync path '" TEST_PATH "/pg'\n"
+                "P00 DETAIL: sync path '" TEST_PATH "/pg/pg_tblspc'\n"
+                "P00   WARN: backup does not contain 'global/pg_control' -- cluster will not start\n"
+                "P00 DETAIL: sync path '" TEST_PATH "/pg/global'\n"
+                "P00   INFO: restore size = 4B, file total = 1",
+                TEST_PATH, TEST_PATH, TEST_PATH, TEST_PATH));
+
+        hrnLogReplaceClear();
+
+        HRN_STORAGE_REMOVE(storagePgWrite(), PG_FILE_RECOVERYCONF, .errorOnMissing = true);
+
+        TEST_STORAGE_LIST(
+            storagePg(), NULL,
+            "./\n"
+            "PG_VERSION {s=4, t=1482182860}\n"
+            "global/\n"
+            "pg_tblspc/\n",
+            .level = storageInfoLevelBasic, .includeDot = true);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("delta restore shared between repos");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgKeyRaw(argList, cfgOptRepoPath, 1, repoPath);
+        hrnCfgArgKeyRaw(argList, cfgOptRepoPath, 2, repoPathEncrpyt);
+        hrnCfgArgRaw(argList, cfgOptPgPath, pgPath);
+        hrnCfgArgRawBool(argList, cfgOptDelta, true);
+        hrnCfgArgRawBool(argList, cfgOptRepoShare, true);
+        hrnCfgArgRawZ(argList, cfgOptProcessMax, "2");
+        hrnCfgArgRawZ(argList, cfgOptSet, "20161219-212741F");
+        hrnCfgArgKeyRawStrId(argList, cfgOptRepoCipherType, 2, cipherTypeAes256Cbc);
+        hrnCfgEnvKeyRawZ(cfgOptRepoCipherPass, 2, TEST_CIPHER_PASS);
+        HRN_CFG_LOAD(cfgCmdRestore, argList);
+
+        // Store backup.info to repo1 so the backup set is found in both repos
+        HRN_INFO_PUT(storageRepoIdxWrite(0), INFO_BACKUP_PATH_FILE, TEST_RESTORE_BACKUP_INFO "\n" TEST_RESTORE_BACKUP_INFO_DB);
+
+        // Add a file to the manifest in both repos but only store it in repo1 so reading it from repo2 fails. The file is smaller
+        // than PG_VERSION so it is in the second job, which is given to repo2 while repo1 is reading PG_VERSION.
+        const Buffer *const manifestEncryptedBuffer = storageGetP(
+            storageNewReadP(storageRepoIdx(1), STRDEF(STORAGE_REPO_BACKUP "/" TEST_LABEL "/" BACKUP_MANIFEST_FILE)));
+
+        for (unsigned int repoIdx = 0; repoIdx < 2; repoIdx++)
+        {
+            const CipherType cipherType = repoIdx == 0 ? cipherTypeNone : cipherTypeAes256Cbc;
+            const String *const cipherPass = repoIdx == 0 ? NULL : STRDEF(TEST_CIPHER_PASS_MANIFEST);
+
+            Manifest *const manifestShare = manifestLoadFile(
+                storageRepoIdx(repoIdx), STRDEF(STORAGE_REPO_BACKUP "/" TEST_LABEL "/" BACKUP_MANIFEST_FILE), cipherType,
+                cipherPass);
+
+            MEM_CONTEXT_OBJ_BEGIN(manifestShare)
+            {
+                manifestFileAdd(
+                    manifestShare,
+                    &(ManifestFile){
+                        .name = STRDEF(TEST_PGDATA "shared"), .size = 2, .timestamp = 1482182860, .mode = 0600,
+                        .group = groupName(), .user = userName(), .checksumSha1 = "66fd9f95a8bec4b3a5a704d1b4d0927a3138cffc"});
+                lstSort(manifestShare->pub.fileList, sortOrderAsc);
+            }
+            MEM_CONTEXT_OBJ_END();
+
+            write = storageWriteIo(
+                storageNewWriteP(
+                    storageRepoIdxWrite(repoIdx), STRDEF(STORAGE_REPO_BACKUP "/" TEST_LABEL "/" BACKUP_MANIFEST_FILE)));
+            cipherBlockFilterGroupAdd(ioWriteFilterGroup(write), cipherType, cipherModeEncrypt, cipherPass);
+            manifestSave(manifestShare, write);
+        }
+
+        HRN_STORAGE_PUT_Z(storageRepoIdxWrite(0), TEST_REPO_PATH "shared", "SH");
+
+        // Log at info level since the order of restored files depends on which process finishes first
+        harnessLogLevelSet(logLevelInfo);
+
+        TEST_RESULT_VOID(cmdRestore(), "successful restore");
+
+        TEST_RESULT_LOG(
+            "P00   INFO: repo1: restore backup set 20161219-212741F\n"
+            "P00   INFO: repo2: share restore of backup set 20161219-212741F (2/2 files)\n"
+            "P00   INFO: remove invalid files/links/paths from '" TEST_PATH "/pg'\n"
+            "P00   WARN: repo2: [FileMissingError] raised from local-2 shim protocol: unable to open missing file"
+                " '" TEST_PATH "/repo-encrypt/backup/test1/20161219-212741F/pg_data/shared' for read\n"
+            "            HINT: files will no longer be read from this repo.\n"
+            "P00   INFO: write " TEST_PATH "/pg/recovery.conf\n"
+            "P00   WARN: backup does not contain 'global/pg_control' -- cluster will not start\n"
+            "P00   INFO: restore size = 6B, file total = 2");
+
+        harnessLogLevelSet(logLevelDetail);
+
+        HRN_STORAGE_REMOVE(storagePgWrite(), PG_FILE_RECOVERYCONF, .errorOnMissing = true);
+
+        TEST_STORAGE_LIST(
+            storagePg(), NULL,
+            "./\n"
+            "PG_VERSION {s=4, t=1482182860}\n"
+            "global/\n"
+            "pg_tblspc/\n"
+            "shared {s=2, t=1482182860}\n",
+            .level = storageInfoLevelBasic, .includeDot = true);
+
+        HRN_STORAGE_REMOVE(storagePgWrite(), "shared", .errorOnMissing = true);
+        HRN_STORAGE_PUT(
+            storageRepoIdxWrite(1), STORAGE_REPO_BACKUP "/" TEST_LABEL "/" BACKUP_MANIFEST_FILE, manifestEncryptedBuffer);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("restore split file in parts");
+
+        StringList *const argListSplit = strLstNew();
+        hrnCfgArgRawZ(argListSplit, cfgOptStanza, "test1");
+        hrnCfgArgRaw(argListSplit, cfgOptRepoPath, repoPath);
+        hrnCfgArgRaw(argListSplit, cfgOptPgPath, pgPath);
+        hrnCfgArgRawBool(argListSplit, cfgOptDelta, true);
+        hrnCfgArgRawZ(argListSplit, cfgOptSet, "20161219-212741F");
+        HRN_CFG_LOAD(cfgCmdRestore, argListSplit);
+
+        // Add a file stored in parts of 4 bytes to the manifest
+        const Buffer *const manifestSplitBuffer = storageGetP(
+            storageNewReadP(storageRepoIdx(0), STRDEF(STORAGE_REPO_BACKUP "/" TEST_LABEL "/" BACKUP_MANIFEST_FILE)));
+        Manifest *const manifestSplit = manifestLoadFile(
+            storageRepoIdx(0), STRDEF(STORAGE_REPO_BACKUP "/" TEST_LABEL "/" BACKUP_MANIFEST_FILE), cipherTypeNone, NULL);
+
+        MEM_CONTEXT_OBJ_BEGIN(manifestSplit)
+        {
+            manifestFileAdd(
+                manifestSplit,
+                &(ManifestFile){
+                    .name = STRDEF(TEST_PGDATA "split"), .size = 10, .timestamp = 1482182860, .mode = 0600, .group = groupName(),
+                    .user = userName(), .checksumSha1 = "6c0bd9cec8de265cb8ce722bcb30c80f9656e829", .splitSize = 4,
+                    .splitChecksum = STRDEF(
+                        "c4b5c86bd577da3d93fea7c89cba61c78b48e589" "83787f060a59493aefdcd4b2369990e7303e186e"
+                        "16b06bd9b738835e2d134fe8d596e9ab0086a985")});
+            lstSort(manifestSplit->pub.fileList, sortOrderAsc);
+        }
+        MEM_CONTEXT_OBJ_END();
+
+        manifestSave(
+            manifestSplit,
+            storageWriteIo(
+                storageNewWriteP(storageRepoIdxWrite(0), STRDEF(STORAGE_REPO_BACKUP "/" TEST_LABEL "/" BACKUP_MANIFEST_FILE))));
+
+        HRN_STORAGE_PUT_Z(storageRepoIdxWrite(0), TEST_REPO_PATH "split." PROJECT_BIN ".part.0", "0123");
+        HRN_STORAGE_PUT_Z(storageRepoIdxWrite(0), TEST_REPO_PATH "split." PROJECT_BIN ".part.1", "4567");
+        HRN_STORAGE_PUT_Z(storageRepoIdxWrite(0), TEST_REPO_PATH "split." PROJECT_BIN ".part.2", "89");
+
+        TEST_RESULT_VOID(cmdRestore(), "successful restore");
+
+        TEST_RESULT_LOG(
+            "P00   INFO: repo1: restore backup set 20161219-212741F\n"
+            "P00 DETAIL: check '" TEST_PATH "/pg' exists\n"
+            "P00   INFO: remove invalid files/links/paths from '" TEST_PATH "/pg'\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/split part 1/3 (4B, 25.00%) checksum"
+                " c4b5c86bd577da3d93fea7c89cba61c78b48e589\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/split part 2/3 (4B, 50.00%) checksum"
+                " 83787f060a59493aefdcd4b2369990e7303e186e\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/split part 3/3 (2B, 62.50%) checksum"
+                " 16b06bd9b738835e2d134fe8d596e9ab0086a985\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/PG_VERSION - exists and matches backup (4B, 87.50%) checksum"
+                " b74d60e763728399bcd3fb63f7dd1f97b46c6b44\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/shared (2B, 100.00%) checksum 66fd9f95a8bec4b3a5a704d1b4d0927a3138cffc\n"
+            "P00   INFO: write " TEST_PATH "/pg/recovery.conf\n"
+            "P00 DETAIL: sync path '" TEST_PATH "/pg'\n"
+            "P00 DETAIL: sync path '" TEST_PATH "/pg/pg_tblspc'\n"
+            "P00   WARN: backup does not contain 'global/pg_control' -- cluster will not start\n"
+            "P00 DETAIL: sync path '" TEST_PATH "/pg/global'\n"
+            "P00   INFO: restore size = 16B, file total = 3");
+
+        TEST_STORAGE_GET(storagePg(), "split", "0123456789");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("restore split file in parts with delta force");
+
+        hrnCfgArgRawBool(argListSplit, cfgOptForce, true);
+        HRN_CFG_LOAD(cfgCmdRestore, argListSplit);
+
+        // Size and timestamp match after the file is truncated but the parts are compared by checksum
+        HRN_STORAGE_PUT_Z(storagePgWrite(), "split", "0123XXXX89AB", .modeFile = 0600, .timeModified = 1482182860);
+        HRN_STORAGE_REMOVE(storagePgWrite(), PG_FILE_RECOVERYCONF, .errorOnMissing = true);
+
+        TEST_RESULT_VOID(cmdRestore(), "successful restore");
+
+        TEST_RESULT_LOG(
+            "P00   INFO: repo1: restore backup set 20161219-212741F\n"
+            "P00 DETAIL: check '" TEST_PATH "/pg' exists\n"
+            "P00   INFO: remove invalid files/links/paths from '" TEST_PATH "/pg'\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/split part 1/3 - exists and matches backup (4B, 25.00%) checksum"
+                " c4b5c86bd577da3d93fea7c89cba61c78b48e589\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/split part 2/3 (4B, 50.00%) checksum"
+                " 83787f060a59493aefdcd4b2369990e7303e186e\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/split part 3/3 - exists and matches backup (2B, 62.50%) checksum"
+                " 16b06bd9b738835e2d134fe8d596e9ab0086a985\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/PG_VERSION - exists and matches size 4 and modification time 1482182860"
+                " (4B, 87.50%) checksum b74d60e763728399bcd3fb63f7dd1f97b46c6b44\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/shared - exists and matches size 2 and modification time 1482182860"
+                " (2B, 100.00%) checksum 66fd9f95a8bec4b3a5a704d1b4d0927a3138cffc\n"
+            "P00   INFO: write " TEST_PATH "/pg/recovery.conf\n"
+            "P00 DETAIL: sync path '" TEST_PATH "/pg'\n"
+            "P00 DETAIL: sync path '" TEST_PATH "/pg/pg_tblspc'\n"
+            "P00   WARN: backup does not contain 'global/pg_control' -- cluster will not start\n"
+            "P00 DETAIL: sync path '" TEST_PATH "/pg/global'\n"
+            "P00   INFO: restore size = 16B, file total = 3");
+
+        HRN_STORAGE_REMOVE(storagePgWrite(), PG_FILE_RECOVERYCONF, .errorOnMissing = true);
+
+        TEST_STORAGE_GET(storagePgWrite(), "split", "0123456789", .remove = true);
+        HRN_STORAGE_REMOVE(storagePgWrite(), "shared", .errorOnMissing = true);
+        HRN_STORAGE_PUT(
+            storageRepoIdxWrite(0), STORAGE_REPO_BACKUP "/" TEST_LABEL "/" BACKUP_MANIFEST_FILE, manifestSplitBuffer);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("files needed to start the cluster");
+
+        TEST_RESULT_BOOL(restoreProcessQueuePriority(STRDEF(TEST_PGDATA "global/pg_control")), true, "global");
+        TEST_RESULT_BOOL(restoreProcessQueuePriority(STRDEF(TEST_PGDATA "base/1/PG_VERSION")), true, "version");
+        TEST_RESULT_BOOL(restoreProcessQueuePriority(STRDEF(TEST_PGDATA "base/1/pg_filenode.map")), true, "relation map");
+        TEST_RESULT_BOOL(restoreProcessQueuePriority(STRDEF(TEST_PGDATA "base/1/1259_fsm")), true, "catalog fork");
+        TEST_RESULT_BOOL(restoreProcessQueuePriority(STRDEF(TEST_PGDATA "base/1/2613.1")), true, "catalog segment");
+        TEST_RESULT_BOOL(
+            restoreProcessQueuePriority(STRDEF("pg_tblspc/16385/PG_11_201809051/16384/1259")), true, "catalog in tablespace");
+        TEST_RESULT_BOOL(restoreProcessQueuePriority(STRDEF(TEST_PGDATA "base/1/16384")), false, "user relation");
+        TEST_RESULT_BOOL(restoreProcessQueuePriority(STRDEF(TEST_PGDATA "base/1/123456")), false, "long relfilenode");
+        TEST_RESULT_BOOL(restoreProcessQueuePriority(STRDEF(TEST_PGDATA "base/1/1259x")), false, "not a relation");
+        TEST_RESULT_BOOL(restoreProcessQueuePriority(STRDEF(TEST_PGDATA "base/1/pg_internal.init")), false, "not a relation");
+        TEST_RESULT_BOOL(restoreProcessQueuePriority(STRDEF(TEST_PGDATA "pg_xact/0000")), false, "not a database path");
+        TEST_RESULT_BOOL(restoreProcessQueuePriority(STRDEF("1259")), false, "no path");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("restore files needed to start first and log progress");
+
+        StringList *const argListPriority = strLstNew();
+        hrnCfgArgRawZ(argListPriority, cfgOptStanza, "test1");
+        hrnCfgArgRaw(argListPriority, cfgOptRepoPath, repoPath);
+        hrnCfgArgRaw(argListPriority, cfgOptPgPath, pgPath);
+        hrnCfgArgRawBool(argListPriority, cfgOptDelta, true);
+        hrnCfgArgRawZ(argListPriority, cfgOptSet, "20161219-212741F");
+        hrnCfgArgRawBool(argListPriority, cfgOptRestorePriority, true);
+        hrnCfgArgRawZ(argListPriority, cfgOptRestoreProgress, "0");
+        HRN_CFG_LOAD(cfgCmdRestore, argListPriority);
+
+        // Add catalog, global, small, large, and zero length files to the manifest
+        Manifest *const manifestPriority = manifestLoadFile(
+            storageRepoIdx(0), STRDEF(STORAGE_REPO_BACKUP "/" TEST_LABEL "/" BACKUP_MANIFEST_FILE), cipherTypeNone, NULL);
+
+        MEM_CONTEXT_OBJ_BEGIN(manifestPriority)
+        {
+            manifestPathAdd(
+                manifestPriority,
+                &(ManifestPath){.name = STRDEF(TEST_PGDATA PG_PATH_BASE), .mode = 0700, .group = groupName(), .user = userName()});
+            manifestPathAdd(
+                manifestPriority,
+                &(ManifestPath){
+                    .name = STRDEF(TEST_PGDATA PG_PATH_BASE "/1"), .mode = 0700, .group = groupName(), .user = userName()});
+            lstSort(manifestPriority->pub.pathList, sortOrderAsc);
+
+            const struct
+            {
+                const char *name;
+                uint64_t size;
+                const char *checksum;
+            } fileList[] =
+            {
+                {TEST_PGDATA PG_PATH_BASE "/1/2608", 2, "5f8459982f9f619f4b0d9af2542a2086e56a4bef"},
+                {TEST_PGDATA PG_PATH_BASE "/1/16384", 5, "11904a4e8b77f6242e2d288705023adad00a9310"},
+                {TEST_PGDATA PG_PATH_GLOBAL "/1262", 3, "a9993e364706816aba3e25717850c26c9cd0d89d"},
+                {TEST_PGDATA "big", 8, "7c222fb2927d828af22f592134e8932480637c0d"},
+                {TEST_PGDATA "small", 1, "86f7e437faa5a7fce15d1ddcb9eaeaea377667b8"},
+                {TEST_PGDATA "zero", 0, ""},
+            };
+
+            for (unsigned int fileIdx = 0; fileIdx < LENGTH_OF(fileList); fileIdx++)
+            {
+                ManifestFile file =
+                {
+                    .name = STR(fileList[fileIdx].name), .size = fileList[fileIdx].size, .timestamp = 1482182860, .mode = 0600,
+                    .group = groupName(), .user = userName(),
+                };
+
+                strncpy(file.checksumSha1, fileList[fileIdx].checksum, sizeof(file.checksumSha1) - 1);
+                manifestFileAdd(manifestPriority, &file);
+            }
+
+            lstSort(manifestPriority->pub.fileList, sortOrderAsc);
+        }
+        MEM_CONTEXT_OBJ_END();
+
+        manifestSave(
+            manifestPriority,
+            storageWriteIo(
+                storageNewWriteP(storageRepoIdxWrite(0), STRDEF(STORAGE_REPO_BACKUP "/" TEST_LABEL "/" BACKUP_MANIFEST_FILE))));
+
+        HRN_STORAGE_PUT_Z(storageRepoIdxWrite(0), TEST_REPO_PATH PG_PATH_BASE "/1/2608", "xy");
+        HRN_STORAGE_PUT_Z(storageRepoIdxWrite(0), TEST_REPO_PATH PG_PATH_BASE "/1/16384", "01234");
+        HRN_STORAGE_PUT_Z(storageRepoIdxWrite(0), TEST_REPO_PATH PG_PATH_GLOBAL "/1262", "abc");
+        HRN_STORAGE_PUT_Z(storageRepoIdxWrite(0), TEST_REPO_PATH "big", "12345678");
+        HRN_STORAGE_PUT_Z(storageRepoIdxWrite(0), TEST_REPO_PATH "small", "a");
+
+        // The throughput and time remaining depend on timing
+        hrnLogReplaceAdd(", [0-9.]+[A-Z]+/s, eta [0-9]+s", "[0-9.]+[A-Z]+/s, eta [0-9]+s", "RATE", false);
+
+        TEST_RESULT_VOID(cmdRestore(), "successful restore");
+
+        TEST_RESULT_LOG(
+            "P00   INFO: repo1: restore backup set 20161219-212741F\n"
+            "P00 DETAIL: check '" TEST_PATH "/pg' exists\n"
+            "P00   INFO: remove invalid files/links/paths from '" TEST_PATH "/pg'\n"
+            "P00 DETAIL: create path '" TEST_PATH "/pg/base'\n"
+            "P00 DETAIL: create path '" TEST_PATH "/pg/base/1'\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/base/1/2608 (2B, 8.00%) checksum 5f8459982f9f619f4b0d9af2542a2086e56a4bef\n"
+            "P00   INFO: restore progress 8.00% (2B of 25B), [RATE]\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/PG_VERSION - exists and matches backup (4B, 24.00%) checksum"
+                " b74d60e763728399bcd3fb63f7dd1f97b46c6b44\n"
+            "P00   INFO: restore progress 24.00% (6B of 25B), [RATE]\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/global/1262 (3B, 36.00%) checksum a9993e364706816aba3e25717850c26c9cd0d89d\n"
+            "P00   INFO: restore progress 36.00% (9B of 25B), [RATE]\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/zero (0B, 36.00%)\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/small (1B, 40.00%) checksum 86f7e437faa5a7fce15d1ddcb9eaeaea377667b8\n"
+            "P00   INFO: restore progress 40.00% (10B of 25B), [RATE]\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/big (8B, 72.00%) checksum 7c222fb2927d828af22f592134e8932480637c0d\n"
+            "P00   INFO: restore progress 72.00% (18B of 25B), [RATE]\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/shared (2B, 80.00%) checksum 66fd9f95a8bec4b3a5a704d1b4d0927a3138cffc\n"
+            "P00   INFO: restore progress 80.00% (20B of 25B), [RATE]\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/base/1/16384 (5B, 100.00%) checksum"
+                " 11904a4e8b77f6242e2d288705023adad00a9310\n"
+            "P00   INFO: write " TEST_PATH "/pg/recovery.conf\n"
+            "P00 DETAIL: sync path '" TEST_PATH "/pg'\n"
+            "P00 DETAIL: sync path '" TEST_PATH "/pg/base'\n"
+            "P00 DETAIL: sync path '" TEST_PATH "/pg/base/1'\n"
+            "P00 DETAIL: sync path '" TEST_PATH "/pg/pg_tblspc'\n"
+            "P00   WARN: backup does not contain 'global/pg_control' -- cluster will not start\n"
+            "P00 DETAIL: sync path '" TEST_PATH "/pg/global'\n"
+            "P00   INFO: restore size = 25B, file total = 8");
+
+        hrnLogReplaceClear();
+
+        HRN_STORAGE_REMOVE(storagePgWrite(), PG_FILE_RECOVERYCONF, .errorOnMissing = true);
+        HRN_STORAGE_PATH_REMOVE(storagePgWrite(), PG_PATH_BASE, .recurse = true, .errorOnMissing = true);
+        HRN_STORAGE_REMOVE(storagePgWrite(), PG_PATH_GLOBAL "/1262", .errorOnMissing = true);
+        HRN_STORAGE_REMOVE(storagePgWrite(), "big", .errorOnMissing = true);
+        HRN_STORAGE_REMOVE(storagePgWrite(), "shared", .errorOnMissing = true);
+        HRN_STORAGE_REMOVE(storagePgWrite(), "small", .errorOnMissing = true);
+        HRN_STORAGE_REMOVE(storagePgWrite(), "zero", .errorOnMissing = true);
+        HRN_STORAGE_PUT(
+            storageRepoIdxWrite(0), STORAGE_REPO_BACKUP "/" TEST_LABEL "/" BACKUP_MANIFEST_FILE, manifestSplitBuffer);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("repos that cannot share the restore");
+
+        hrnCfgArgKeyRawZ(argList, cfgOptRepoPath, 3, TEST_PATH "/repo3");
+        HRN_CFG_LOAD(cfgCmdRestore, argList);
+
+        // Backup set is missing in repo3
+        HRN_INFO_PUT(storageRepoIdxWrite(2), INFO_BACKUP_PATH_FILE, TEST_RESTORE_BACKUP_INFO_DB);
+
+        // Compression type does not match in repo2
+        Manifest *const manifestShare = manifestLoadFile(
+            storageRepoIdx(0), STRDEF(STORAGE_REPO_BACKUP "/" TEST_LABEL "/" BACKUP_MANIFEST_FILE), cipherTypeNone, NULL);
+        manifestShare->pub.data.backupOptionCompressType = compressTypeGz;
+
+        List *const repoList = lstNewP(sizeof(RestoreRepo));
+        lstAdd(repoList, &(RestoreRepo){.repoIdx = 0});
+
+        TEST_RESULT_VOID(restoreRepoShare(repoList, manifestShare), "share restore");
+        TEST_RESULT_UINT(lstSize(repoList), 1, "no repos added");
+        TEST_RESULT_LOG(
+            "P00 DETAIL: repo2: unable to share restore: [FormatError] backup set 20161219-212741F has no files that match\n"
+            "P00 DETAIL: repo3: unable to share restore: [BackupSetInvalidError] backup set 20161219-212741F is not valid");
+
+        // A file that is not in a repo is read from the backup set repo
+        lstAdd(repoList, &(RestoreRepo){.repoIdx = 1, .fileList = strLstNew()});
+
+        TEST_RESULT_UINT(
+            restoreJobRepo(&(RestoreJobData){.repoList = repoList}, STRDEF(TEST_PGDATA PG_FILE_PGVERSION), 4), 0,
+            "backup set repo");
+
+        // A file split into parts of a different size is not stored the same way
+        TEST_RESULT_BOOL(
+            restoreRepoFileEq(
+                &(ManifestFile){.size = 32768, .splitSize = 16384},
+                &(ManifestFile){.size = 32768, .splitSize = 8192}),
+            false, "split size does not match");
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("full restore with delta force");
 
@@ -2184,8 +2953,10 @@ testRun(void)
                 &(ManifestFile){
                     .name = STRDEF(MANIFEST_TARGET_PGDATA "/postgresql.conf"), .size = 10,
                     .timestamp = 1482182860, .mode = 0600, .group = groupName(), .user = userName(),
-                    .checksumSha1 = "1a49a3c2240449fee1422e4afcf44d5b96378511"});
-            HRN_STORAGE_PUT_Z(storageRepoWrite(), TEST_REPO_PATH "/postgresql.conf", "VALID_CONF");
+                    .checksumSha1 = "1a49a3c2240449fee1422e4afcf44d5b96378511", .dedup = true});
+            HRN_STORAGE_PUT_Z(
+                storageRepoWrite(), STORAGE_REPO_BACKUP "/" MANIFEST_PATH_DEDUP "/1a/1a49a3c2240449fee1422e4afcf44d5b96378511",
+                "VALID_CONF");
 
             manifestFileAdd(
                 manifest,
@@ -2333,6 +3104,7 @@ testRun(void)
         hrnCfgArgRawStrId(argList, cfgOptType, CFGOPTVAL_TYPE_PRESERVE);
         hrnCfgArgRawZ(argList, cfgOptSet, "20161219-212741F");
         hrnCfgArgRawBool(argList, cfgOptForce, true);
+        hrnCfgArgRawZ(argList, cfgOptProcessMin, "1");
         HRN_CFG_LOAD(cfgCmdRestore, argList);
 
         cmdRestore();
@@ -3021,6 +3793,84 @@ testRun(void)
         // Check stanza archive spool path was removed
         TEST_STORAGE_LIST_EMPTY(storageSpool(), STORAGE_PATH_ARCHIVE);
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("incremental delta selective restore with files needed to start first");
+
+        StringList *const argListPriority2 = strLstDup(argList);
+        hrnCfgArgRawBool(argListPriority2, cfgOptRestorePriority, true);
+        HRN_CFG_LOAD(cfgCmdRestore, argListPriority2);
+
+        TEST_RESULT_VOID(cmdRestore(), "successful restore");
+
+        TEST_RESULT_LOG(
+            "P00   INFO: repo2: restore backup set 20161219-212741F_20161219-212918I, recovery will start at [TIME]\n"
+            "P00   INFO: map link 'pg_hba.conf' to '../config/pg_hba.conf'\n"
+            "P00   INFO: map link 'pg_wal' to '../wal'\n"
+            "P00   INFO: map link 'postgresql.conf' to '../config/postgresql.conf'\n"
+            "P00 DETAIL: databases found for selective restore (1, 16384, 32768)\n"
+            "P00 DETAIL: databases excluded (zeroed) from selective restore (32768)\n"
+            "P00 DETAIL: check '" TEST_PATH "/pg' exists\n"
+            "P00 DETAIL: check '" TEST_PATH "/config' exists\n"
+            "P00 DETAIL: check '" TEST_PATH "/wal' exists\n"
+            "P00 DETAIL: check '" TEST_PATH "/ts/1/PG_10_201707211' exists\n"
+            "P00 DETAIL: skip 'tablespace_map' -- tablespace links will be created based on mappings\n"
+            "P00 DETAIL: remove 'global/pg_control' so cluster will not start if restore does not complete\n"
+            "P00   INFO: remove invalid files/links/paths from '" TEST_PATH "/pg'\n"
+            "P00   INFO: remove invalid files/links/paths from '" TEST_PATH "/wal'\n"
+            "P00   INFO: remove invalid files/links/paths from '" TEST_PATH "/ts/1/PG_10_201707211'\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/global/888 - exists and is zero size (0B, [PCT])\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/global/999 - exists and is zero size (0B, [PCT])\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/base/1/10 - exists and matches backup (bundle 20161219-212741F/1/1,"
+                " 8KB, [PCT]) checksum 28757c756c03c37aca13692cb719c18d1510c190\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/global/pg_control.pgbackrest.tmp (8KB, [PCT])"
+                " checksum 5e2b96c19c4f5c63a5afa2de504d29fe64a4c908\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/PG_VERSION - exists and matches backup (bundle 1/0, 4B, [PCT])"
+                " checksum 8dbabb96e032b8d9f1993c0e4b9141e71ade01a1\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/base/1/PG_VERSION - exists and matches backup (bundle 1/4, 4B, [PCT])"
+                " checksum 8dbabb96e032b8d9f1993c0e4b9141e71ade01a1\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/base/1/2 - exists and matches backup (8KB, [PCT])"
+                " checksum 4d7b2a36c5387decf799352a3751883b7ceb96aa\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/base/1/20 - exists and matches backup (bundle"
+                " 20161219-212741F_20161219-212800D/2/1, 1B, [PCT]) checksum c032adc1ff629c9b66f22749ad667e6beadf144b\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/base/1/21 - exists and matches backup (bundle"
+                " 20161219-212741F_20161219-212800D/2/2, 1B, [PCT]) checksum e9d71f5ee7c92d6dc9e92ffdad17b8bd49418f98\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/base/1/30 - exists and matches backup (bundle"
+                " 20161219-212741F_20161219-212900I/2/1, 1B, [PCT]) checksum c032adc1ff629c9b66f22749ad667e6beadf144b\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/base/1/31 - exists and matches backup (bundle"
+                " 20161219-212741F_20161219-212900I/2/2, 1B, [PCT]) checksum e9d71f5ee7c92d6dc9e92ffdad17b8bd49418f98\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/base/16384/PG_VERSION - exists and matches backup (4B, [PCT])"
+                " checksum 8dbabb96e032b8d9f1993c0e4b9141e71ade01a1\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/base/32768/PG_VERSION - exists and matches backup (4B, [PCT])"
+                " checksum 8dbabb96e032b8d9f1993c0e4b9141e71ade01a1\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/zero-length - exists and is zero size (bundle 1/16, 0B, [PCT])\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/yyy - exists and matches backup (bundle 1/8, 3B, [PCT])"
+                " checksum 186154712b2d5f6791d85b9a0987b98fa231779c\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/xxxxx - exists and matches backup (bundle 1/11, 5B, [PCT])"
+                " checksum 9addbf544119efa4a64223b649750a510f0d463f\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/zz - exists and matches backup (bundle 1/17, 2B, [PCT])"
+                " checksum d7dacae2c968388960bf8970080a980ed5c5dcb7\n"
+            "P01 DETAIL: restore zeroed file " TEST_PATH "/pg/base/32768/32769 (32KB, [PCT])\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/pg_hba.conf - exists and matches backup (11B, [PCT])"
+                " checksum 401215e092779574988a854d8c7caed7f91dba4b\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/postgresql.conf - exists and matches backup (15B, [PCT])"
+                " checksum 98b8abb2e681e2a5a7d8ab082c0a79727887558d\n"
+            "P01 DETAIL: restore file " TEST_PATH "/pg/base/16384/16385 - exists and matches backup (16KB, [PCT])"
+                " checksum d74e5f7ebe52a3ed468ba08c5b6aefaccd1ca88f\n"
+            "P00 DETAIL: sync path '" TEST_PATH "/config'\n"
+            "P00 DETAIL: sync path '" TEST_PATH "/pg'\n"
+            "P00 DETAIL: sync path '" TEST_PATH "/pg/base'\n"
+            "P00 DETAIL: sync path '" TEST_PATH "/pg/base/1'\n"
+            "P00 DETAIL: sync path '" TEST_PATH "/pg/base/16384'\n"
+            "P00 DETAIL: sync path '" TEST_PATH "/pg/base/32768'\n"
+            "P00 DETAIL: sync path '" TEST_PATH "/pg/pg_tblspc'\n"
+            "P00 DETAIL: sync path '" TEST_PATH "/pg/pg_wal'\n"
+            "P00 DETAIL: sync path '" TEST_PATH "/pg/pg_xact'\n"
+            "P00 DETAIL: sync path '" TEST_PATH "/pg/pg_tblspc/1'\n"
+            "P00 DETAIL: sync path '" TEST_PATH "/pg/pg_tblspc/1/PG_10_201707211'\n"
+            "P00   INFO: restore global/pg_control (performed last to ensure aborted restores cannot be started)\n"
+            "P00 DETAIL: sync path '" TEST_PATH "/pg/global'\n"
+            "P00   INFO: restore size = [SIZE], file total = 21");
+
         // -------------------------------------------------------------------------------------------------------------------------
         // Keep this test at the end since is corrupts the repo
         TEST_TITLE("remove a repo file so a restore job errors");
@@ -2,6 +2,9 @@
 Test Server Command
 ***********************************************************************************************************************************/
 #include "command/exit.h"
+#include "common/io/socket/client.h"
+#include "common/io/tls/client.h"
+#include "common/stat.h"
 #include "storage/posix/storage.h"
 #include "storage/remote/storage.h"
 
@@ -125,6 +128,7 @@ testRun(void)
                             CFGOPT_TLS_SERVER_CERT_FILE "=" HRN_SERVER_CERT "\n"
                             CFGOPT_TLS_SERVER_KEY_FILE "=" HRN_SERVER_KEY "\n"
                             CFGOPT_TLS_SERVER_AUTH "=pgbackrest-client=db\n"
+                            CFGOPT_TLS_SERVER_WORKER_REUSE "=1\n"
                             "repo1-path=" TEST_PATH "/repo\n");
 
                         StringList *argList = strLstNew();
@@ -142,8 +146,7 @@ testRun(void)
                         // Add a fake pid to ensure SIGTERM is sent to unterminated children
                         cmdServerInit();
 
-                        int fakePid = INT_MAX;
-                        lstAdd(serverLocal.processList, &fakePid);
+                        lstAdd(serverLocal.processList, &(ServerProcess){.pid = INT_MAX});
 
                         // Get pid of this process to identify child process later
                         pid_t pid = getpid();
@@ -190,6 +193,112 @@ testRun(void)
             HRN_FORK_PARENT_END();
         }
         HRN_FORK_END();
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("worker reuse and session resumption");
+
+        HRN_FORK_BEGIN(.timeout = 15000)
+        {
+            HRN_FORK_CHILD_BEGIN(.prefix = "client")
+            {
+                StringList *argList = strLstNew();
+                hrnCfgArgRawZ(argList, cfgOptPgPath, "/BOGUS");
+                hrnCfgArgRaw(argList, cfgOptRepoHost, hrnServerHost());
+                hrnCfgArgRawZ(argList, cfgOptRepoHostConfig, TEST_PATH "/pgbackrest.conf");
+                hrnCfgArgRawZ(argList, cfgOptRepoHostType, "tls");
+#if !TEST_IN_CONTAINER
+                hrnCfgArgRawZ(argList, cfgOptRepoHostCaFile, HRN_SERVER_CA);
+#endif
+                hrnCfgArgRawZ(argList, cfgOptRepoHostCertFile, HRN_SERVER_CLIENT_CERT);
+                hrnCfgArgRawZ(argList, cfgOptRepoHostKeyFile, HRN_SERVER_CLIENT_KEY);
+                hrnCfgArgRawFmt(argList, cfgOptRepoHostPort, "%u", hrnServerPort(0));
+                hrnCfgArgRawZ(argList, cfgOptStanza, "db");
+                HRN_CFG_LOAD(cfgCmdArchiveGet, argList);
+
+                // Wait for the server to start
+                HRN_FORK_CHILD_NOTIFY_GET();
+
+                // Connection 1 loads the client configuration in the worker
+                const Storage *storageRemote = NULL;
+                TEST_ASSIGN(
+                    storageRemote,
+                    storageRemoteNew(
+                        STORAGE_MODE_FILE_DEFAULT, STORAGE_MODE_PATH_DEFAULT, true, NULL,
+                        protocolRemoteGet(protocolStorageTypeRepo, 0), cfgOptionUInt(cfgOptCompressLevelNetwork)),
+                    "new storage");
+
+                HRN_STORAGE_PUT_Z(storageRemote, "client4.txt", "CLIENT4");
+
+                TEST_RESULT_VOID(protocolRemoteFree(0), "free client");
+
+                // Connections 2 and 3 use the same TLS client so the second connection resumes the session of the first
+                IoClient *const tlsClient = tlsClientNewP(
+                    sckClientNew(hrnServerHost(), hrnServerPort(0), 5000, 5000), hrnServerHost(), 5000, 5000, false);
+
+                statReset();
+
+                for (unsigned int connectionIdx = 0; connectionIdx < 2; connectionIdx++)
+                {
+                    MEM_CONTEXT_TEMP_BEGIN()
+                    {
+                        IoSession *const tlsSession = ioClientOpen(tlsClient);
+                        ProtocolClient *const protocolClient = protocolClientNew(
+                            STRDEF("test"), PROTOCOL_SERVICE_REMOTE_STR, ioSessionIoReadP(tlsSession),
+                            ioSessionIoWrite(tlsSession));
+
+                        protocolClientNoExit(protocolClient);
+                        TEST_RESULT_VOID(protocolClientNoOp(protocolClient), "noop");
+                        protocolClientFree(protocolClient);
+
+                        // Close cleanly so the session can be resumed
+                        ioSessionClose(tlsSession);
+                    }
+                    MEM_CONTEXT_TEMP_END();
+                }
+
+                TEST_RESULT_BOOL(
+                    strstr(strZ(statToJsonP()), "\"tls.resume\":{\"total\":1}") != NULL, true, "session resumed");
+            }
+            HRN_FORK_CHILD_END();
+
+            HRN_FORK_CHILD_BEGIN(.prefix = "server")
+            {
+                StringList *argList = strLstNew();
+                hrnCfgArgRawZ(argList, cfgOptConfig, TEST_PATH "/pgbackrest.conf");
+                hrnCfgArgRawFmt(argList, cfgOptTlsServerPort, "%u", hrnServerPort(0));
+                hrnCfgArgRawZ(argList, cfgOptTlsServerWorkerReuse, "3");
+                hrnCfgArgRawZ(argList, cfgOptLogLevelStderr, CFGOPTVAL_ARCHIVE_MODE_OFF_Z);
+                hrnCfgArgRawZ(argList, cfgOptLogLevelFile, CFGOPTVAL_ARCHIVE_MODE_OFF_Z);
+                HRN_CFG_LOAD(cfgCmdServer, argList);
+
+                exitInit();
+                harnessLogLevelSet(logLevelError);
+                cmdServerInit();
+
+                // Add parameters to arg list required to restore the server configuration
+                strLstInsert(argList, 0, cfgExe());
+                strLstAddZ(argList, CFGCMD_SERVER);
+
+                serverLocal.argListSize = strLstSize(argList);
+                serverLocal.argList = strLstPtr(argList);
+
+                // Notify the client that the server is ready
+                HRN_FORK_CHILD_NOTIFY_PUT();
+
+                TEST_RESULT_UINT(cmdServerWorker(cmdServerWorkerAccept()), 3, "worker processed all connections");
+            }
+            HRN_FORK_CHILD_END();
+
+            HRN_FORK_PARENT_BEGIN(.prefix = "control")
+            {
+                HRN_FORK_PARENT_NOTIFY_GET(1);
+                HRN_FORK_PARENT_NOTIFY_PUT(0);
+            }
+            HRN_FORK_PARENT_END();
+        }
+        HRN_FORK_END();
+
+        TEST_STORAGE_GET(storageTest, "repo/client4.txt", "CLIENT4");
     }
 
     // *****************************************************************************************************************************
@@ -243,6 +352,7 @@ testRun(void)
                         hrnCfgArgRawZ(argList, cfgOptTlsServerCertFile, HRN_SERVER_CERT);
                         hrnCfgArgRawZ(argList, cfgOptTlsServerKeyFile, HRN_SERVER_KEY);
                         hrnCfgArgRawZ(argList, cfgOptTlsServerAuth, "bogus=*");
+                        hrnCfgArgRawZ(argList, cfgOptTlsServerWorkerReuse, "1");
                         hrnCfgArgRawFmt(argList, cfgOptTlsServerPort, "%u", hrnServerPort(0));
                         HRN_CFG_LOAD(cfgCmdServer, argList);
 
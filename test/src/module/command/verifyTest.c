@@ -253,7 +253,7 @@ testRun(void)
         harnessLogLevelSet(logLevelDetail);
 
         backupResult.status = backupValid;
-        TEST_ASSIGN(manifest, verifyManifestFile(&backupResult, NULL, false, infoPg, &jobErrorTotal), "verify manifest");
+        TEST_ASSIGN(manifest, verifyManifestFile(&backupResult, NULL, false, infoPg, &jobErrorTotal, NULL), "verify manifest");
         TEST_RESULT_PTR(manifest, NULL, "manifest not set - pg version mismatch");
         TEST_RESULT_UINT(backupResult.status, backupInvalid, "manifest unusable - backup invalid");
         TEST_RESULT_LOG(
@@ -288,7 +288,7 @@ testRun(void)
             .comment = "manifest copy - invalid system-id");
 
         backupResult.status = backupValid;
-        TEST_ASSIGN(manifest, verifyManifestFile(&backupResult, NULL, false, infoPg, &jobErrorTotal), "verify manifest");
+        TEST_ASSIGN(manifest, verifyManifestFile(&backupResult, NULL, false, infoPg, &jobErrorTotal, NULL), "verify manifest");
         TEST_RESULT_PTR(manifest, NULL, "manifest not set - pg system-id mismatch");
         TEST_RESULT_UINT(backupResult.status, backupInvalid, "manifest unusable - backup invalid");
         TEST_RESULT_LOG(
@@ -322,7 +322,7 @@ testRun(void)
             .comment = "manifest copy - invalid db-id");
 
         backupResult.status = backupValid;
-        TEST_ASSIGN(manifest, verifyManifestFile(&backupResult, NULL, false, infoPg, &jobErrorTotal), "verify manifest");
+        TEST_ASSIGN(manifest, verifyManifestFile(&backupResult, NULL, false, infoPg, &jobErrorTotal, NULL), "verify manifest");
         TEST_RESULT_PTR(manifest, NULL, "manifest not set - pg db-id mismatch");
         TEST_RESULT_UINT(backupResult.status, backupInvalid, "manifest unusable - backup invalid");
         TEST_RESULT_LOG(
@@ -340,7 +340,7 @@ testRun(void)
             storageRepoWrite(), TEST_PATH "/repo/" STORAGE_PATH_BACKUP "/db/" TEST_BACKUP_LABEL_FULL "/" BACKUP_MANIFEST_FILE
             INFO_COPY_EXT, TEST_INVALID_BACKREST_INFO, .comment = "invalid manifest copy");
 
-        TEST_ASSIGN(manifest, verifyManifestFile(&backupResult, NULL, false, infoPg, &jobErrorTotal), "verify manifest");
+        TEST_ASSIGN(manifest, verifyManifestFile(&backupResult, NULL, false, infoPg, &jobErrorTotal, NULL), "verify manifest");
         TEST_RESULT_UINT(backupResult.status, backupInvalid, "manifest unusable - backup invalid");
         TEST_RESULT_LOG(
             "P00 DETAIL: unable to open missing file '" TEST_PATH "/repo/backup/db/20181119-152138F/backup.manifest' for read\n"
@@ -354,7 +354,7 @@ testRun(void)
             storageRepoWrite(), TEST_PATH "/repo/" STORAGE_PATH_BACKUP "/db/" TEST_BACKUP_LABEL_FULL "/" BACKUP_MANIFEST_FILE,
             TEST_INVALID_BACKREST_INFO, .comment = "invalid manifest");
 
-        TEST_ASSIGN(manifest, verifyManifestFile(&backupResult, NULL, true, infoPg, &jobErrorTotal), "verify manifest");
+        TEST_ASSIGN(manifest, verifyManifestFile(&backupResult, NULL, true, infoPg, &jobErrorTotal, NULL), "verify manifest");
         TEST_RESULT_PTR(manifest, NULL, "manifest not set");
         TEST_RESULT_UINT(backupResult.status, backupInvalid, "manifest unusable - backup invalid");
         TEST_RESULT_LOG(
@@ -380,7 +380,7 @@ testRun(void)
             .comment = "valid manifest");
 
         backupResult.status = backupValid;
-        TEST_ASSIGN(manifest, verifyManifestFile(&backupResult, NULL, true, infoPg, &jobErrorTotal), "verify manifest");
+        TEST_ASSIGN(manifest, verifyManifestFile(&backupResult, NULL, true, infoPg, &jobErrorTotal, NULL), "verify manifest");
         TEST_RESULT_PTR_NE(manifest, NULL, "manifest set");
         TEST_RESULT_UINT(backupResult.status, backupValid, "manifest usable");
         TEST_RESULT_LOG("P00 DETAIL: backup '20181119-152138F' manifest.copy does not match manifest");
@@ -932,20 +932,21 @@ testRun(void)
         String *filePathName = strNewZ(STORAGE_REPO_ARCHIVE "/testfile");
         HRN_STORAGE_PUT_EMPTY(storageRepoWrite(), strZ(filePathName));
         TEST_RESULT_UINT(
-            verifyFile(filePathName, 0, NULL, compressTypeNone, STRDEF(HASH_TYPE_SHA1_ZERO), 0, NULL), verifyOk, "file ok");
+            verifyFile(filePathName, 0, NULL, compressTypeNone, STRDEF(HASH_TYPE_SHA1_ZERO), 0, NULL, NULL), verifyOk, "file ok");
 
         //--------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("file size invalid in archive");
 
         HRN_STORAGE_PUT_Z(storageRepoWrite(), strZ(filePathName), fileContents);
         TEST_RESULT_UINT(
-            verifyFile(filePathName, 0, NULL, compressTypeNone, fileChecksum, 0, NULL), verifySizeInvalid, "file size invalid");
+            verifyFile(filePathName, 0, NULL, compressTypeNone, fileChecksum, 0, NULL, NULL), verifySizeInvalid,
+            "file size invalid");
 
         //--------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("file missing in archive");
 
         TEST_RESULT_UINT(
-            verifyFile(strNewFmt(STORAGE_REPO_ARCHIVE "/missingFile"), 0, NULL, compressTypeNone, fileChecksum, 0, NULL),
+            verifyFile(strNewFmt(STORAGE_REPO_ARCHIVE "/missingFile"), 0, NULL, compressTypeNone, fileChecksum, 0, NULL, NULL),
             verifyFileMissing, "file missing");
 
         //--------------------------------------------------------------------------------------------------------------------------
@@ -959,12 +960,41 @@ testRun(void)
 
         strCatZ(filePathName, ".gz");
         TEST_RESULT_UINT(
-            verifyFile(filePathName, 0, NULL, compressTypeGz, fileChecksum, fileSize, STRDEF("pass")),
+            verifyFile(filePathName, 0, NULL, compressTypeGz, fileChecksum, fileSize, STRDEF("pass"), NULL),
             verifyOk, "file encrypted compressed ok");
         TEST_RESULT_UINT(
-            verifyFile(
-                filePathName, 0, NULL, compressTypeGz, STRDEF("badchecksum"), fileSize, STRDEF("pass")), verifyChecksumMismatch,
-                "file encrypted compressed checksum mismatch");
+            verifyFile(filePathName, 0, NULL, compressTypeGz, STRDEF("badchecksum"), fileSize, STRDEF("pass"), NULL),
+            verifyChecksumMismatch, "file encrypted compressed checksum mismatch");
+
+        //--------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("verify with repo storage info only");
+
+        const uint64_t repoSize = storageInfoP(storageRepo(), filePathName).size;
+
+        TEST_RESULT_UINT(
+            verifyFileRepo(filePathName, false, 0, repoSize, STRDEF("4c7c9ab025b5a395f8711dcba8636dc8")), verifyOk, "file ok");
+        TEST_RESULT_UINT(verifyFileRepo(filePathName, false, 0, repoSize + 1, NULL), verifySizeInvalid, "file size invalid");
+        TEST_RESULT_UINT(verifyFileRepo(filePathName, true, 1, repoSize - 1, NULL), verifyOk, "bundled file ok");
+        TEST_RESULT_UINT(verifyFileRepo(filePathName, true, 1, repoSize, NULL), verifySizeInvalid, "bundled file past end");
+        TEST_RESULT_UINT(
+            verifyFileRepo(STRDEF(STORAGE_REPO_BACKUP "/missingFile"), false, 0, 0, NULL), verifyFileMissing, "file missing");
+
+        //--------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("checksum reported by repo storage");
+
+        const StorageInfo info =
+        {
+            .exists = true, .size = 9, .checksum = STRDEF("4c7c9ab025b5a395f8711dcba8636dc8"),
+        };
+
+        TEST_RESULT_UINT(
+            verifyFileRepoInfo(&info, false, 0, 9, STRDEF("4c7c9ab025b5a395f8711dcba8636dc8")), verifyOk, "checksum ok");
+        TEST_RESULT_UINT(
+            verifyFileRepoInfo(&info, false, 0, 9, STRDEF("00000000000000000000000000000000")), verifyChecksumMismatch,
+            "checksum mismatch");
+        TEST_RESULT_UINT(
+            verifyFileRepoInfo(&info, true, 4, 5, STRDEF("00000000000000000000000000000000")), verifyOk,
+            "checksum not compared when the repo file holds other files");
     }
 
     // *****************************************************************************************************************************
@@ -1543,6 +1573,21 @@ testRun(void)
                 " total valid files: 0\n"
             "                checksum invalid: 1");
 
+        //--------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("fast verify checks repo size without reading the file");
+
+        argList = strLstDup(argListBase);
+        hrnCfgArgRawZ(argList, cfgOptType, "fast");
+        HRN_CFG_LOAD(cfgCmdVerify, argList);
+
+        TEST_RESULT_VOID(verifyProcess(cfgOptionBool(cfgOptVerbose)), "process");
+        TEST_RESULT_LOG(
+            "P01   INFO: invalid size '20181119-152900F/pg_data/PG_VERSION'\n"
+            "P01   INFO: invalid size '20181119-152900F/pg_data/PG_VERSION'");
+
+        argList = strLstDup(argListBase);
+        HRN_CFG_LOAD(cfgCmdVerify, argList);
+
         //--------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("valid backup, prior backup verification complete - referenced file not checked");
 
@@ -1613,6 +1658,7 @@ testRun(void)
                 TEST_MANIFEST_DB
                 "\n"
                 "[target:file]\n"
+                "pg_data/dedupfile={\"checksum\":\"%s\",\"dedup\":true,\"size\":%u,\"timestamp\":1565282114}\n"
                 "pg_data/validfile={\"bni\":1,\"bno\":3,\"checksum\":\"%s\",\"size\":%u,\"timestamp\":1565282114}\n"
                 "pg_data/zerofile={\"size\":0,\"timestamp\":1565282114}\n"
                 TEST_MANIFEST_FILE_DEFAULT
@@ -1620,7 +1666,7 @@ testRun(void)
                 TEST_MANIFEST_LINK_DEFAULT
                 TEST_MANIFEST_PATH
                 TEST_MANIFEST_PATH_DEFAULT,
-                strZ(fileChecksum), (unsigned int)fileSize);
+                strZ(fileChecksum), (unsigned int)fileSize, strZ(fileChecksum), (unsigned int)fileSize);
 
         HRN_INFO_PUT(
             storageRepoWrite(), STORAGE_REPO_BACKUP "/20201119-163000F/" BACKUP_MANIFEST_FILE, strZ(manifestContent),
@@ -1632,6 +1678,9 @@ testRun(void)
         HRN_STORAGE_PUT_Z(
             storageRepoWrite(), STORAGE_REPO_BACKUP  "/20201119-163000F/bundle/1", zNewFmt("XXX%s", fileContents),
             .comment = "valid file");
+        HRN_STORAGE_PUT_Z(
+            storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/" MANIFEST_PATH_DEDUP "/d1/%s", strZ(fileChecksum)), fileContents,
+            .comment = "valid file in dedup store");
 
         // Create WAL file with just header info and small WAL size
         Buffer *walBuffer = bufNew((size_t)(1024 * 1024));
@@ -1670,6 +1719,185 @@ testRun(void)
             "              backup: 20181119-152900F_20181119-152909D, status: invalid, total files checked: 1,"
                 " total valid files: 0\n"
             "                checksum invalid: 1");
+
+        //--------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("incremental verify records valid backups and WAL ranges");
+
+        argList = strLstDup(argListBase);
+        hrnCfgArgRawBool(argList, cfgOptIncremental, true);
+        HRN_CFG_LOAD(cfgCmdVerify, argList);
+
+        #define TEST_RESULT_INCR                                                                                                   \
+            "stanza: db\n"                                                                                                         \
+            "status: error\n"                                                                                                      \
+            "  backup: 20181119-152900F, status: invalid, total files checked: 3, total valid files: 0\n"                          \
+            "    missing: 1, checksum invalid: 1, size invalid: 1\n"                                                               \
+            "  backup: 20181119-152900F_20181119-152909D, status: invalid, total files checked: 1, total valid files: 0\n"         \
+            "    checksum invalid: 1"
+
+        TEST_RESULT_STR_Z(verifyProcess(false), TEST_RESULT_INCR, "process");
+        TEST_RESULT_LOG(
+            "P01   INFO: invalid checksum '20181119-152900F/pg_data/PG_VERSION'\n"
+            "P01   INFO: invalid size '20181119-152900F/pg_data/base/1/555_init'\n"
+            "P01   INFO: file missing '20181119-152900F/pg_data/base/1/555_init.1'");
+
+        VerifyJobData jobData = {.memContext = memContextCurrent()};
+
+        TEST_RESULT_VOID(verifyStateLoad(&jobData, 0), "load state");
+        TEST_RESULT_UINT(lstSize(jobData.stateBackupList), 1, "backup total");
+        TEST_RESULT_STR_Z(((VerifyStateBackup *)lstGet(jobData.stateBackupList, 0))->backupLabel, "20201119-163000F", "backup");
+        TEST_RESULT_UINT(lstSize(jobData.stateWalList), 1, "WAL range total");
+        TEST_RESULT_STR_Z(((VerifyStateWal *)lstGet(jobData.stateWalList, 0))->archiveId, "11-2", "WAL range archive id");
+        TEST_RESULT_STR_Z(
+            ((VerifyStateWal *)lstGet(jobData.stateWalList, 0))->start, "000000020000000000000001", "WAL range start");
+        TEST_RESULT_STR_Z(((VerifyStateWal *)lstGet(jobData.stateWalList, 0))->stop, "000000020000000000000001", "WAL range stop");
+        TEST_RESULT_BOOL(((VerifyStateWal *)lstGet(jobData.stateWalList, 0))->skip, true, "WAL range skipped");
+
+        //--------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("incremental verify skips recorded backups and WAL ranges");
+
+        HRN_STORAGE_PUT_Z(
+            storageRepoWrite(), STORAGE_REPO_BACKUP  "/20201119-163000F/bundle/1", zNewFmt("XXX%s", "invalid"),
+            .comment = "invalid file");
+        Buffer *const walBufferInvalid = bufDup(walBuffer);
+        bufPtr(walBufferInvalid)[bufUsed(walBufferInvalid) - 1] = 0xFF;
+
+        HRN_STORAGE_PUT(
+            storageRepoWrite(),
+            zNewFmt(STORAGE_REPO_ARCHIVE "/11-2/0000000200000000/000000020000000000000001-%s", walBufferSha1), walBufferInvalid,
+            .comment = "invalid WAL");
+
+        TEST_RESULT_STR_Z(verifyProcess(false), TEST_RESULT_INCR, "process");
+        TEST_RESULT_LOG(
+            "P01   INFO: invalid checksum '20181119-152900F/pg_data/PG_VERSION'\n"
+            "P01   INFO: invalid size '20181119-152900F/pg_data/base/1/555_init'\n"
+            "P01   INFO: file missing '20181119-152900F/pg_data/base/1/555_init.1'");
+
+        //--------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("sample verifies recorded objects again");
+
+        hrnCfgArgRawZ(argList, cfgOptSample, "100");
+        HRN_CFG_LOAD(cfgCmdVerify, argList);
+
+        TEST_RESULT_STR_Z(
+            verifyProcess(false),
+            "stanza: db\n"
+            "status: error\n"
+            "  archiveId: 11-2, total WAL checked: 1, total valid WAL: 0\n"
+            "    checksum invalid: 1\n"
+            "  backup: 20181119-152900F, status: invalid, total files checked: 3, total valid files: 0\n"
+            "    missing: 1, checksum invalid: 1, size invalid: 1\n"
+            "  backup: 20181119-152900F_20181119-152909D, status: invalid, total files checked: 1, total valid files: 0\n"
+            "    checksum invalid: 1\n"
+            "  backup: 20201119-163000F, status: invalid, total files checked: 3, total valid files: 2\n"
+            "    checksum invalid: 1",
+            "process");
+        TEST_RESULT_LOG(
+            "P01   INFO: invalid checksum '11-2/0000000200000000/000000020000000000000001"
+                "-55400c400c6817876a23374f92d77c938eb01046'\n"
+            "P01   INFO: invalid checksum '20181119-152900F/pg_data/PG_VERSION'\n"
+            "P01   INFO: invalid size '20181119-152900F/pg_data/base/1/555_init'\n"
+            "P01   INFO: file missing '20181119-152900F/pg_data/base/1/555_init.1'\n"
+            "P01   INFO: invalid checksum '20201119-163000F/pg_data/validfile'");
+
+        jobData = (VerifyJobData){.memContext = memContextCurrent()};
+
+        TEST_RESULT_VOID(verifyStateLoad(&jobData, 0), "load state");
+        TEST_RESULT_UINT(lstSize(jobData.stateBackupList), 0, "no backups");
+        TEST_RESULT_UINT(lstSize(jobData.stateWalList), 0, "no WAL ranges");
+
+        //--------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("invalid state is ignored");
+
+        HRN_STORAGE_PUT_Z(storageRepoWrite(), STORAGE_REPO_BACKUP "/" VERIFY_STATE_FILE, "BOGUS");
+
+        jobData = (VerifyJobData){.memContext = memContextCurrent()};
+
+        TEST_RESULT_VOID(verifyStateLoad(&jobData, 0), "load state");
+        TEST_RESULT_UINT(lstSize(jobData.stateBackupList), 0, "no backups");
+        TEST_RESULT_LOG("");
+
+        //--------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("parts of a split file are verified separately");
+
+        argList = strLstDup(argListBase);
+        HRN_CFG_LOAD(cfgCmdVerify, argList);
+
+        #define TEST_BACKUP_INFO_SPLIT                                                                                             \
+            "[backup:current]\n"                                                                                                   \
+            TEST_BACKUP_DB2_CURRENT_FULL1                                                                                          \
+            "\n"                                                                                                                   \
+            "[db]\n"                                                                                                               \
+            TEST_BACKUP_DB2_11                                                                                                     \
+            "\n"                                                                                                                   \
+            "[db:history]\n"                                                                                                       \
+            TEST_BACKUP_DB1_HISTORY                                                                                                \
+            "\n"                                                                                                                   \
+            TEST_BACKUP_DB2_HISTORY
+
+        HRN_STORAGE_PATH_REMOVE(storageRepoWrite(), STORAGE_REPO_BACKUP "/20181119-152900F", .recurse = true);
+        HRN_STORAGE_PATH_REMOVE(storageRepoWrite(), STORAGE_REPO_BACKUP "/20181119-152900F_20181119-152909D", .recurse = true);
+        HRN_INFO_PUT(storageRepoWrite(), INFO_BACKUP_PATH_FILE, TEST_BACKUP_INFO_SPLIT);
+        HRN_INFO_PUT(storageRepoWrite(), INFO_BACKUP_PATH_FILE INFO_COPY_EXT, TEST_BACKUP_INFO_SPLIT);
+
+        manifestContent = strNewZ(
+            TEST_MANIFEST_HEADER
+            "\n"
+            "[backup:db]\n"
+            TEST_BACKUP_DB2_11
+            TEST_MANIFEST_OPTION_ALL
+            TEST_MANIFEST_TARGET
+            TEST_MANIFEST_DB
+            "\n"
+            "[target:file]\n"
+            "pg_data/split={\"checksum\":\"6c0bd9cec8de265cb8ce722bcb30c80f9656e829\",\"size\":10,\"split-checksum\":"
+                "\"c4b5c86bd577da3d93fea7c89cba61c78b48e58983787f060a59493aefdcd4b2369990e7303e186e"
+                "16b06bd9b738835e2d134fe8d596e9ab0086a985\",\"split-size\":4,\"timestamp\":1565282114}\n"
+            TEST_MANIFEST_FILE_DEFAULT
+            TEST_MANIFEST_LINK
+            TEST_MANIFEST_LINK_DEFAULT
+            TEST_MANIFEST_PATH
+            TEST_MANIFEST_PATH_DEFAULT);
+
+        HRN_INFO_PUT(
+            storageRepoWrite(), STORAGE_REPO_BACKUP "/20201119-163000F/" BACKUP_MANIFEST_FILE, strZ(manifestContent),
+            .comment = "manifest with split file");
+        HRN_INFO_PUT(
+            storageRepoWrite(), STORAGE_REPO_BACKUP "/20201119-163000F/" BACKUP_MANIFEST_FILE INFO_COPY_EXT, strZ(manifestContent),
+            .comment = "manifest copy with split file");
+
+        HRN_STORAGE_PUT_Z(storageRepoWrite(), STORAGE_REPO_BACKUP "/20201119-163000F/pg_data/split." PROJECT_BIN ".part.0", "0123");
+        HRN_STORAGE_PUT_Z(storageRepoWrite(), STORAGE_REPO_BACKUP "/20201119-163000F/pg_data/split." PROJECT_BIN ".part.1", "45X7");
+        HRN_STORAGE_PUT(
+            storageRepoWrite(),
+            zNewFmt(STORAGE_REPO_ARCHIVE "/11-2/0000000200000000/000000020000000000000001-%s", walBufferSha1), walBuffer,
+            .comment = "valid WAL");
+
+        TEST_RESULT_STR_Z(
+            verifyProcess(false),
+            "stanza: db\n"
+            "status: error\n"
+            "  backup: 20201119-163000F, status: invalid, total files checked: 3, total valid files: 1\n"
+            "    missing: 1, checksum invalid: 1",
+            "process");
+        TEST_RESULT_LOG(
+            "P01   INFO: invalid checksum '20201119-163000F/pg_data/split." PROJECT_BIN ".part.1'\n"
+            "P01   INFO: file missing '20201119-163000F/pg_data/split." PROJECT_BIN ".part.2'");
+
+        //--------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("fast verify checks that the parts of a split file exist");
+
+        hrnCfgArgRawZ(argList, cfgOptType, "fast");
+        HRN_CFG_LOAD(cfgCmdVerify, argList);
+
+        TEST_RESULT_STR_Z(
+            verifyProcess(false),
+            "stanza: db\n"
+            "status: error\n"
+            "  backup: 20201119-163000F, status: invalid, total files checked: 3, total valid files: 2\n"
+            "    missing: 1",
+            "process");
+        TEST_RESULT_LOG("P01   INFO: file missing '20201119-163000F/pg_data/split." PROJECT_BIN ".part.2'");
     }
     // *****************************************************************************************************************************
     if (testBegin("cmdVerify() verbose text"))
@@ -324,11 +324,205 @@ testRun(void)
         TEST_RESULT_STR_Z(
             zstDecompressToLog(decompress), "{inputSame: true, inputOffset: 999, frameDone false, done: true}",
             "format object");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("zstDictTrain()");
+
+        Buffer *sample = bufNew(0);
+        size_t sampleSizeList[256];
+
+        TEST_RESULT_PTR(zstDictTrain(sample, NULL, 0, 4096), NULL, "no samples");
+
+        for (unsigned int sampleIdx = 0; sampleIdx < LENGTH_OF(sampleSizeList); sampleIdx++)
+        {
+            const String *const sampleData = strNewFmt(
+                "# config file %u\nshared_buffers = %uMB\nwork_mem = %uMB\nmax_connections = %u\nlisten_addresses = '*'\n",
+                sampleIdx, sampleIdx * 7, sampleIdx % 13, sampleIdx * 3 + 100);
+
+            bufCat(sample, BUFSTR(sampleData));
+            sampleSizeList[sampleIdx] = strSize(sampleData);
+        }
+
+        Buffer *dict = NULL;
+
+        TEST_ASSIGN(dict, zstDictTrain(sample, sampleSizeList, LENGTH_OF(sampleSizeList), 4096), "train dictionary");
+        TEST_RESULT_BOOL(dict != NULL && bufUsed(dict) > 0 && bufUsed(dict) <= 4096, true, "check dictionary");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("compress and decompress with dictionary");
+
+        const Buffer *const dictData = BUFSTRDEF(
+            "# config file 999\nshared_buffers = 2048MB\nwork_mem = 4MB\nmax_connections = 500\nlisten_addresses = '*'\n");
+        Buffer *compressed = NULL;
+
+        TEST_ASSIGN(
+            compressed, testCompress(compressFilterDict(compressTypeZst, 3, dict), bufDup(dictData), 1024, 1024), "compress");
+        TEST_RESULT_BOOL(
+            bufUsed(compressed) < bufUsed(testCompress(zstCompressNew(3), bufDup(dictData), 1024, 1024)), true,
+            "smaller than without dictionary");
+        TEST_RESULT_BOOL(
+            bufEq(dictData, testDecompress(decompressFilterDict(compressTypeZst, dict), compressed, 1024, 1024)), true,
+            "decompress");
+        TEST_ERROR(
+            testDecompress(zstDecompressNew(), compressed, 1024, 1024), FormatError,
+            "zst error: [-32] Dictionary mismatch");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("compressFilterPack() with dictionary");
+
+        IoFilter *filter = compressFilterDict(compressTypeZst, 3, dict);
+
+        TEST_RESULT_BOOL(
+            bufEq(
+                compressed,
+                testCompress(
+                    compressFilterPack(ioFilterType(filter), ioFilterParamList(filter)), bufDup(dictData), 1024, 1024)),
+            true, "compress from pack");
+
+        filter = decompressFilterDict(compressTypeZst, dict);
+
+        TEST_RESULT_BOOL(
+            bufEq(
+                dictData,
+                testDecompress(compressFilterPack(ioFilterType(filter), ioFilterParamList(filter)), compressed, 1024, 1024)),
+            true, "decompress from pack");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("dictionary is only sent with the first filter param");
+
+        TEST_RESULT_UINT(zstDictId(dict) != 0, true, "trained dictionary has id");
+        TEST_RESULT_BOOL(
+            bufUsed(pckToBuf(ioFilterParamList(compressFilterDict(compressTypeZst, 3, dict)))) < bufUsed(dict), true,
+            "compress param without dictionary");
+        TEST_RESULT_BOOL(
+            bufUsed(pckToBuf(ioFilterParamList(decompressFilterDict(compressTypeZst, dict)))) < bufUsed(dict), true,
+            "decompress param without dictionary");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("compressDictPackWrite() and compressDictPackRead()");
+
+        PackWrite *packWrite = pckWriteNewP();
+        const Buffer *const dictRaw = BUFSTRDEF("raw dictionary without id");
+
+        TEST_RESULT_VOID(compressDictPackWrite(packWrite, compressTypeNone, NULL, false), "no dictionary");
+        TEST_RESULT_VOID(compressDictPackWrite(packWrite, compressTypeZst, dict, false), "dictionary id");
+        TEST_RESULT_VOID(compressDictPackWrite(packWrite, compressTypeZst, dictRaw, false), "dictionary without id");
+        TEST_RESULT_VOID(
+            compressDictPackWrite(packWrite, compressTypeZst, zstDictTrain(sample, sampleSizeList, 128, 2048), false),
+            "dictionary id not sent");
+        TEST_RESULT_VOID(pckWriteEndP(packWrite), "end");
+
+        PackRead *packRead = pckReadNew(pckWriteResult(packWrite));
+
+        TEST_RESULT_PTR(compressDictPackRead(packRead), NULL, "no dictionary");
+        TEST_RESULT_BOOL(bufEq(compressDictPackRead(packRead), dict), true, "dictionary found by id");
+        TEST_RESULT_BOOL(bufEq(compressDictPackRead(packRead), dictRaw), true, "dictionary without id");
+        TEST_ERROR(compressDictPackRead(packRead), AssertError, "dictionary 1866372408 has not been sent");
 #else
         TEST_ERROR(compressTypePresent(compressTypeZst), OptionInvalidValueError, "pgBackRest not compiled with zst support");
 #endif // HAVE_LIBZST
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("probe"))
+    {
+        // Random data does not compress while text compresses well
+        Buffer *const incompressible = bufNew(128 * 1024);
+        uint32_t seed = 1;
+
+        for (size_t byteIdx = 0; byteIdx < bufSize(incompressible); byteIdx++)
+        {
+            seed = seed * 1103515245 + 12345;
+            *(bufPtr(incompressible) + byteIdx) = (unsigned char)(seed >> 24);
+        }
+
+        bufUsedSet(incompressible, bufSize(incompressible));
+
+        const char *const text = "a simple string that compresses well\n";
+        Buffer *const compressible = bufNew(128 * 1024);
+
+        for (size_t byteIdx = 0; byteIdx < bufSize(compressible); byteIdx++)
+            *(bufPtr(compressible) + byteIdx) = (unsigned char)text[byteIdx % strlen(text)];
+
+        bufUsedSet(compressible, bufSize(compressible));
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("compressible data is compressed at the configured level");
+
+        Buffer *compressed = bufNew(0);
+        IoWrite *write = ioBufferWriteNew(compressed);
+        ioFilterGroupAdd(ioWriteFilterGroup(write), compressFilterProbe(compressTypeGz, 6));
+        ioWriteOpen(write);
+        ioWrite(write, compressible);
+        ioWriteClose(write);
+
+        TEST_RESULT_BOOL(
+            pckReadBoolP(ioFilterGroupResultP(ioWriteFilterGroup(write), COMPRESS_PROBE_FILTER_TYPE)), false, "not fast");
+        TEST_RESULT_BOOL(
+            bufEq(compressed, testCompress(compressFilter(compressTypeGz, 6), compressible, 1024 * 1024, 1024 * 1024)), true,
+            "same as configured level");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("incompressible data is compressed at the fastest level");
+
+        compressed = bufNew(0);
+        write = ioBufferWriteNew(compressed);
+        ioFilterGroupAdd(ioWriteFilterGroup(write), compressFilterProbe(compressTypeGz, 6));
+        ioWriteOpen(write);
+        ioWrite(write, incompressible);
+        ioWriteClose(write);
+
+        TEST_RESULT_BOOL(pckReadBoolP(ioFilterGroupResultP(ioWriteFilterGroup(write), COMPRESS_PROBE_FILTER_TYPE)), true, "fast");
+        TEST_RESULT_BOOL(
+            bufEq(compressed, testCompress(compressFilter(compressTypeGz, 0), incompressible, 1024 * 1024, 1024 * 1024)), true,
+            "same as fastest level");
+        TEST_RESULT_BOOL(
+            bufEq(incompressible, testDecompress(decompressFilter(compressTypeGz), compressed, 1024, 1024)), true,
+            "decompress");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("small input, small output buffer, and fastest level are not probed");
+
+        TEST_RESULT_BOOL(
+            bufEq(
+                testCompress(compressFilterProbe(compressTypeGz, 6), incompressible, 1024, 1),
+                testCompress(compressFilter(compressTypeGz, 6), incompressible, 1024, 1)),
+            true, "small input");
+
+        TEST_RESULT_BOOL(
+            bufEq(
+                testCompress(compressFilterProbe(compressTypeGz, 0), incompressible, 1024 * 1024, 1024),
+                testCompress(compressFilter(compressTypeGz, 0), incompressible, 1024 * 1024, 1024)),
+            true, "fastest level");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("no input");
+
+        compressed = bufNew(0);
+        write = ioBufferWriteNew(compressed);
+        ioFilterGroupAdd(ioWriteFilterGroup(write), compressFilterProbe(compressTypeGz, 6));
+        ioWriteOpen(write);
+        ioWriteClose(write);
+
+        TEST_RESULT_BOOL(
+            pckReadBoolP(ioFilterGroupResultP(ioWriteFilterGroup(write), COMPRESS_PROBE_FILTER_TYPE)), false, "not fast");
+        TEST_RESULT_UINT(
+            bufUsed(testDecompress(decompressFilter(compressTypeGz), compressed, 1024, 1024)), 0, "decompress");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("compressFilterPack()");
+
+        IoFilter *filter = compressFilterProbe(compressTypeGz, 6);
+
+        TEST_ASSIGN(filter, compressFilterPack(ioFilterType(filter), ioFilterParamList(filter)), "filter from pack");
+        TEST_RESULT_UINT(ioFilterType(filter), COMPRESS_PROBE_FILTER_TYPE, "filter type");
+        TEST_RESULT_BOOL(
+            bufEq(
+                testCompress(filter, incompressible, 1024 * 1024, 1024 * 1024),
+                testCompress(compressFilter(compressTypeGz, 0), incompressible, 1024 * 1024, 1024 * 1024)),
+            true, "fastest level");
+    }
+
     // Test everything in the helper that is not tested in the individual compression type tests
     // *****************************************************************************************************************************
     if (testBegin("helper"))
@@ -361,6 +555,11 @@ testRun(void)
 
         TEST_RESULT_PTR(compressFilterPack(STRID5("bogus", 0x13a9de20), NULL), NULL, "no filter match");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("compressDictSupported()");
+
+        TEST_RESULT_BOOL(compressDictSupported(compressTypeGz), false, "gz does not support dictionaries");
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("compressExtStr()");
 
@@ -386,6 +585,11 @@ testRun(void)
 
         TEST_RESULT_INT(compressLevelDefault(compressTypeNone), 0, "none level=0");
         TEST_RESULT_INT(compressLevelDefault(compressTypeGz), 6, "gz level=6");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("compressLevelFast()");
+
+        TEST_RESULT_INT(compressLevelFast(compressTypeGz), 0, "gz level=0");
     }
 
     FUNCTION_HARNESS_RETURN_VOID();
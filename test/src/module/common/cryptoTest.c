@@ -148,6 +148,27 @@ testRun(void)
 
         ioFilterFree(blockEncryptFilter);
 
+        // Resume encrypt with the salt from the header
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_ERROR(
+            cipherBlockNewResume(cipherTypeAes256Cbc, testPass, NULL, BUFSTRDEF("Salted__")), CryptoError, "cipher header invalid");
+        TEST_ERROR(
+            cipherBlockNewResume(cipherTypeAes256Cbc, testPass, NULL, BUFSTRDEF("Salty___12345678")), CryptoError,
+            "cipher header invalid");
+
+        Buffer *resumeBuffer = bufNew(TEST_BUFFER_SIZE);
+
+        IoFilter *resumeFilter = cipherBlockNewResume(
+            cipherTypeAes256Cbc, testPass, NULL, bufNewC(bufPtr(encryptBuffer), CIPHER_BLOCK_HEADER_SIZE));
+        resumeFilter = cipherBlockNewPack(ioFilterParamList(resumeFilter));
+
+        ioFilterProcessInOut(resumeFilter, testPlainText, resumeBuffer);
+        ioFilterProcessInOut(resumeFilter, testPlainText, resumeBuffer);
+        ioFilterProcessInOut(resumeFilter, NULL, resumeBuffer);
+        TEST_RESULT_BOOL(bufEq(resumeBuffer, encryptBuffer), true, "encrypted bytes are the same");
+
+        ioFilterFree(resumeFilter);
+
         // Decrypt in one pass
         // -------------------------------------------------------------------------------------------------------------------------
         Buffer *decryptBuffer = bufNew(TEST_BUFFER_SIZE);
@@ -366,6 +387,52 @@ testRun(void)
         TEST_RESULT_VOID(ioFilterProcessIn(hash, BUFSTRZ("1")), "add 1");
         TEST_RESULT_STR_Z(pckReadStrP(pckReadNew(ioFilterResult(hash))), "5c99876f9cafa7f485eac9c7a8a2764c", "check hash");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("partial hash");
+
+        TEST_ASSIGN(hash, cryptoHashNew(hashTypeSha1), "create sha1 hash");
+        TEST_RESULT_VOID(ioFilterProcessIn(hash, BUFSTRDEF("123")), "add 123");
+        TEST_RESULT_STR(cryptoHashPartial(hash), bufHex(cryptoHashOne(hashTypeSha1, BUFSTRDEF("123"))), "check partial hash");
+        TEST_RESULT_VOID(ioFilterProcessIn(hash, BUFSTRDEF("45")), "add 45");
+        TEST_RESULT_STR_Z(
+            pckReadStrP(pckReadNew(ioFilterResult(hash))), "8cb2237d0679ca88db6464eac60da96345513964", "check hash");
+
+        TEST_ASSIGN(hash, cryptoHashNew(hashTypeMd5), "create md5 hash");
+        TEST_RESULT_STR_Z(cryptoHashPartial(hash), HASH_TYPE_MD5_ZERO, "check partial hash");
+        TEST_RESULT_VOID(ioFilterProcessIn(hash, BUFSTRDEF("12345")), "add 12345");
+        TEST_RESULT_STR(cryptoHashPartial(hash), bufHex(cryptoHashOne(hashTypeMd5, BUFSTRDEF("12345"))), "check partial hash");
+        TEST_RESULT_STR(
+            pckReadStrP(pckReadNew(ioFilterResult(hash))), bufHex(cryptoHashOne(hashTypeMd5, BUFSTRDEF("12345"))), "check hash");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("split hash");
+
+        const String *const partHashList = strNewFmt(
+            "%s%s%s", strZ(bufHex(cryptoHashOne(hashTypeSha1, BUFSTRDEF("123")))),
+            strZ(bufHex(cryptoHashOne(hashTypeSha1, BUFSTRDEF("456")))), strZ(bufHex(cryptoHashOne(hashTypeSha1, BUFSTRDEF("7")))));
+
+        TEST_RESULT_STR_Z(
+            cryptoHashSplitCombine(hashTypeSha1, partHashList), "c7da7e1feb3440d3cf88ad7e9ecbb3080aed99a2", "combine part hashes");
+
+        packWrite = pckWriteNewP();
+        pckWriteStrIdP(packWrite, hashTypeSha1);
+        pckWriteU64P(packWrite, 3);
+        pckWriteEndP(packWrite);
+
+        TEST_ASSIGN(hash, cryptoHashNewPack(pckWriteResult(packWrite)), "create split sha1 hash");
+        TEST_RESULT_VOID(ioFilterProcessIn(hash, BUFSTRDEF("12")), "add 12");
+        TEST_RESULT_VOID(ioFilterProcessIn(hash, BUFSTRDEF("3456")), "add 3456");
+        TEST_RESULT_VOID(ioFilterProcessIn(hash, BUFSTRDEF("7")), "add 7");
+        TEST_RESULT_STR(
+            pckReadStrP(pckReadNew(ioFilterResult(hash))), cryptoHashSplitCombine(hashTypeSha1, partHashList), "check hash");
+
+        TEST_ASSIGN(hash, cryptoHashNewSplit(hashTypeSha1, 3), "create split sha1 hash");
+        TEST_RESULT_VOID(ioFilterProcessIn(hash, BUFSTRDEF("123456")), "add 123456");
+        TEST_RESULT_STR(
+            pckReadStrP(pckReadNew(ioFilterResult(hash))),
+            cryptoHashSplitCombine(hashTypeSha1, strSubN(partHashList, 0, HASH_TYPE_SHA1_SIZE_HEX * 2)),
+            "check hash ending on a part boundary");
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_ASSIGN(hash, cryptoHashNew(hashTypeSha256), "create sha256 hash");
         TEST_RESULT_STR_Z(pckReadStrP(pckReadNew(ioFilterResult(hash))), HASH_TYPE_SHA256_ZERO, "    check empty hash");
@@ -3,6 +3,21 @@ Execute Process
 ***********************************************************************************************************************************/
 #include "common/harnessFork.h"
 
+/***********************************************************************************************************************************
+Function to call in the forked process that writes the first parameter and then echoes a line read from the parent
+***********************************************************************************************************************************/
+static int
+testExecFork(const StringList *const param, IoRead *const forkRead, IoWrite *const forkWrite)
+{
+    ioWriteStrLine(forkWrite, strLstGet(param, 1));
+    ioWriteFlush(forkWrite);
+
+    ioWriteStrLine(forkWrite, ioReadLine(forkRead));
+    ioWriteFlush(forkWrite);
+
+    return 0;
+}
+
 /***********************************************************************************************************************************
 Test Run
 ***********************************************************************************************************************************/
@@ -16,7 +31,7 @@ testRun(void)
     {
         Exec *exec = NULL;
 
-        TEST_ASSIGN(exec, execNew(STRDEF("catt"), NULL, STRDEF("cat"), 1000), "invalid exec");
+        TEST_ASSIGN(exec, execNewP(STRDEF("catt"), NULL, STRDEF("cat"), 1000), "invalid exec");
         TEST_RESULT_VOID(execOpen(exec), "open invalid exec");
         TEST_RESULT_VOID(ioWriteStrLine(execIoWrite(exec), EMPTY_STR), "write invalid exec");
         sleep(1);
@@ -26,7 +41,7 @@ testRun(void)
         TEST_RESULT_VOID(execFree(exec), "free exec");
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_ASSIGN(exec, execNew(STRDEF("cat"), NULL, STRDEF("cat"), 1000), "new cat exec");
+        TEST_ASSIGN(exec, execNewP(STRDEF("cat"), NULL, STRDEF("cat"), 1000), "new cat exec");
         TEST_RESULT_PTR(execMemContext(exec), objMemContext(exec), "get mem context");
         TEST_RESULT_INT(execFdRead(exec), exec->fdRead, "check read file descriptor");
         TEST_RESULT_VOID(execOpen(exec), "open cat exec");
@@ -38,7 +53,7 @@ testRun(void)
         TEST_RESULT_VOID(execFree(exec), "free exec");
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_ASSIGN(exec, execNew(STRDEF("cat"), NULL, STRDEF("cat"), 1000), "new cat exec");
+        TEST_ASSIGN(exec, execNewP(STRDEF("cat"), NULL, STRDEF("cat"), 1000), "new cat exec");
         TEST_RESULT_VOID(execOpen(exec), "open cat exec");
         close(exec->fdWrite);
 
@@ -46,7 +61,7 @@ testRun(void)
         TEST_RESULT_VOID(execFree(exec), "free exec");
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_ASSIGN(exec, execNew(STRDEF("cat"), NULL, STRDEF("cat"), 1000), "new cat exec");
+        TEST_ASSIGN(exec, execNewP(STRDEF("cat"), NULL, STRDEF("cat"), 1000), "new cat exec");
         TEST_RESULT_VOID(execOpen(exec), "open cat exec");
         kill(exec->processId, SIGKILL);
 
@@ -57,7 +72,7 @@ testRun(void)
         StringList *option = strLstNew();
         strLstAddZ(option, "-b");
 
-        TEST_ASSIGN(exec, execNew(STRDEF("cat"), option, STRDEF("cat"), 1000), "new cat exec");
+        TEST_ASSIGN(exec, execNewP(STRDEF("cat"), option, STRDEF("cat"), 1000), "new cat exec");
         TEST_RESULT_VOID(execOpen(exec), "open cat exec");
 
         TEST_RESULT_VOID(ioWriteStrLine(execIoWrite(exec), message), "write cat exec");
@@ -79,7 +94,7 @@ testRun(void)
                 StringList *option = strLstNew();
                 strLstAddZ(option, "-b");
 
-                TEST_ASSIGN(exec, execNew(STRDEF("cat"), option , STRDEF("cat"), 1000), "new cat exec");
+                TEST_ASSIGN(exec, execNewP(STRDEF("cat"), option , STRDEF("cat"), 1000), "new cat exec");
                 TEST_RESULT_VOID(execOpen(exec), "open cat exec");
 
                 TEST_RESULT_VOID(ioWriteStrLine(execIoWrite(exec), message), "write cat exec");
@@ -91,11 +106,40 @@ testRun(void)
         }
         HRN_FORK_END();
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("call function in forked process");
+
+        option = strLstNew();
+        strLstAddZ(option, "ACKBYACK");
+
+        TEST_ASSIGN(exec, execNewP(STRDEF("fork"), option, STRDEF("fork"), 1000, .fork = testExecFork), "new fork exec");
+        TEST_RESULT_VOID(execOpen(exec), "open fork exec");
+        TEST_RESULT_STR_Z(ioReadLine(execIoRead(exec)), "ACKBYACK", "read fork exec");
+        TEST_RESULT_VOID(ioWriteStrLine(execIoWrite(exec), STRDEF("ECHO")), "write fork exec");
+        TEST_RESULT_VOID(ioWriteFlush(execIoWrite(exec)), "flush fork exec");
+        TEST_RESULT_STR_Z(ioReadLine(execIoRead(exec)), "ECHO", "read echo from fork exec");
+        TEST_ERROR(strZ(ioReadLine(execIoRead(exec))), UnknownError, "fork terminated unexpectedly [0]");
+        TEST_RESULT_VOID(execFree(exec), "free exec");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("call function in forked process using shared memory rings");
+
+        TEST_ASSIGN(
+            exec, execNewP(STRDEF("fork"), option, STRDEF("fork"), 1000, .fork = testExecFork, .ringSize = 4), "new fork exec");
+        TEST_RESULT_VOID(execOpen(exec), "open fork exec");
+        TEST_RESULT_BOOL(execFdRead(exec) != exec->fdRead, true, "read fd is not the read pipe");
+        TEST_RESULT_STR_Z(ioReadLine(execIoRead(exec)), "ACKBYACK", "read fork exec");
+        TEST_RESULT_VOID(ioWriteStrLine(execIoWrite(exec), STRDEF("ECHO")), "write fork exec");
+        TEST_RESULT_VOID(ioWriteFlush(execIoWrite(exec)), "flush fork exec");
+        TEST_RESULT_STR_Z(ioReadLine(execIoRead(exec)), "ECHO", "read echo from fork exec");
+        TEST_ERROR(strZ(ioReadLine(execIoRead(exec))), UnknownError, "fork terminated unexpectedly [0]");
+        TEST_RESULT_VOID(execFree(exec), "free exec");
+
         // -------------------------------------------------------------------------------------------------------------------------
         option = strLstNew();
         strLstAddZ(option, "2");
 
-        TEST_ASSIGN(exec, execNew(STRDEF("sleep"), option, STRDEF("sleep"), 1000), "new sleep exec");
+        TEST_ASSIGN(exec, execNewP(STRDEF("sleep"), option, STRDEF("sleep"), 1000), "new sleep exec");
         TEST_RESULT_VOID(execOpen(exec), "open cat exec");
 
         TEST_ERROR(execFreeResource(exec), ExecuteError, "sleep did not exit when expected");
@@ -378,6 +378,12 @@ testRun(void)
         TEST_RESULT_PTR(
             ioFilterGroupResultP(ioReadFilterGroup(bufferRead), STRID5("bogus", 0x13a9de20)), NULL,
             "    check missing filter result");
+        TEST_RESULT_BOOL(
+            ioFilterGroupResultTimeP(ioReadFilterGroup(bufferRead), ioFilterType(sizeFilter), .idx = 1) < 1000000, true,
+            "    check filter time");
+        TEST_RESULT_UINT(
+            ioFilterGroupResultTimeP(ioReadFilterGroup(bufferRead), STRID5("bogus", 0x13a9de20)), 0,
+            "    check missing filter time");
 
         TEST_RESULT_PTR(ioFilterDriver(bufferFilter), bufferFilter->pub.driver, "    check filter driver");
         TEST_RESULT_PTR(ioFilterInterface(bufferFilter), &bufferFilter->pub.interface, "    check filter interface");
@@ -585,6 +591,417 @@ testRun(void)
             pckReadU64P(ioFilterGroupResultP(filterGroup, ioFilterType(sizeFilter))), 9, "    check filter result");
         TEST_RESULT_UINT(
             pckReadU64P(ioFilterGroupResultP(filterGroup, STRID5("size2", 0x1c2e9330))), 22, "    check filter result");
+        TEST_RESULT_BOOL(ioFilterGroupOutput(filterGroup), true, "    filters produce output");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("flush with filters that do not produce output");
+
+        buffer = bufNew(0);
+
+        TEST_ASSIGN(bufferWrite, ioBufferWriteNew(buffer), "create buffer write object");
+        ioFilterGroupAdd(ioWriteFilterGroup(bufferWrite), ioSizeNew());
+        TEST_RESULT_BOOL(ioFilterGroupOutput(ioWriteFilterGroup(bufferWrite)), false, "filters do not produce output");
+
+        ioWriteOpen(bufferWrite);
+        TEST_RESULT_VOID(ioWriteStr(bufferWrite, STRDEF("AB")), "write string");
+        TEST_RESULT_STR_Z(strNewBuf(buffer), "", "no change because output buffer is not full");
+        TEST_RESULT_VOID(ioWriteFlush(bufferWrite), "flush");
+        TEST_RESULT_STR_Z(strNewBuf(buffer), "AB", "check write");
+        TEST_RESULT_VOID(ioWriteClose(bufferWrite), "close buffer write object");
+        TEST_RESULT_UINT(pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(bufferWrite), SIZE_FILTER_TYPE)), 2, "check size");
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("IoRing"))
+    {
+        ioBufferSizeSet(32);
+
+        IoRing *ringParent = NULL;
+        IoRing *ringChild = NULL;
+
+        TEST_ASSIGN(ringParent, ioRingNew(16), "new ring written by parent");
+        TEST_ASSIGN(ringChild, ioRingNew(16), "new ring written by child");
+
+        HRN_FORK_BEGIN()
+        {
+            HRN_FORK_CHILD_BEGIN()
+            {
+                IoRead *ringRead = NULL;
+                IoWrite *ringWrite = NULL;
+
+                TEST_ASSIGN(ringRead, ioRingReadNew(STRDEF("child read"), ringParent, 1000), "new read");
+                ioReadOpen(ringRead);
+                TEST_ASSIGN(ringWrite, ioRingWriteNew(STRDEF("child write"), ringChild, 1000), "new write");
+                ioWriteOpen(ringWrite);
+
+                // Echo a line that is larger than the ring
+                TEST_RESULT_STR_Z(ioReadLine(ringRead), "0123456789ABCDEFGHIJ", "read line");
+                TEST_RESULT_VOID(ioWriteStrLine(ringWrite, STRDEF("0123456789ABCDEFGHIJ")), "write line");
+                TEST_RESULT_VOID(ioWriteFlush(ringWrite), "flush line");
+
+                // Read the ring after the parent has filled it
+                char notify;
+                TEST_RESULT_INT(read(HRN_FORK_CHILD_READ_FD(), &notify, 1), 1, "wait for parent");
+
+                Buffer *buffer = bufNew(8);
+                TEST_RESULT_UINT(ioRead(ringRead, buffer), 8, "read half of full ring");
+                TEST_RESULT_STR_Z(strNewBuf(buffer), "01234567", "check buffer");
+
+                bufUsedZero(buffer);
+                TEST_RESULT_UINT(ioRead(ringRead, buffer), 8, "read rest of ring");
+                TEST_RESULT_STR_Z(strNewBuf(buffer), "89ABCDEF", "check buffer");
+
+                // Close so the parent sees eof
+                TEST_RESULT_VOID(ioWriteStrLine(ringWrite, STRDEF("end")), "write end");
+                TEST_RESULT_VOID(ioWriteClose(ringWrite), "close write");
+
+                // Exit when the parent has filled the ring again
+                TEST_RESULT_INT(read(HRN_FORK_CHILD_READ_FD(), &notify, 1), 1, "wait for parent");
+            }
+            HRN_FORK_CHILD_END();
+
+            HRN_FORK_PARENT_BEGIN()
+            {
+                IoRead *ringRead = NULL;
+                IoWrite *ringWrite = NULL;
+
+                TEST_ASSIGN(ringRead, ioRingReadNew(STRDEF("parent read"), ringChild, 1000), "new read");
+                ioReadOpen(ringRead);
+                TEST_ASSIGN(ringWrite, ioRingWriteNew(STRDEF("parent write"), ringParent, 1000), "new write");
+                ioWriteOpen(ringWrite);
+
+                TEST_RESULT_INT(ioReadFd(ringRead), ringChild->fdData[0], "check fd");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("read timeout");
+
+                ((IoRingRead *)ioReadDriver(ringRead))->timeout = 1;
+                TEST_ERROR(
+                    ioRead(ringRead, bufNew(1)), FileReadError, "timeout after 1ms waiting for read from 'parent read'");
+                ((IoRingRead *)ioReadDriver(ringRead))->timeout = 1000;
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("write and read line larger than the ring");
+
+                TEST_RESULT_VOID(ioWriteStrLine(ringWrite, STRDEF("0123456789ABCDEFGHIJ")), "write line");
+                TEST_RESULT_VOID(ioWriteFlush(ringWrite), "flush line");
+                TEST_RESULT_STR_Z(ioReadLine(ringRead), "0123456789ABCDEFGHIJ", "read echo");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("write timeout when the ring is full");
+
+                ((IoRingWrite *)ringWrite->driver)->timeout = 100;
+                TEST_RESULT_VOID(ioRingWrite(ringWrite->driver, BUFSTRDEF("01234567")), "write to empty ring");
+                TEST_RESULT_VOID(ioRingWrite(ringWrite->driver, BUFSTRDEF("89ABCDEF")), "write to ring with data");
+                TEST_ERROR(
+                    ioRingWrite(ringWrite->driver, BUFSTRDEF("X")), FileWriteError,
+                    "timeout after 100ms waiting for write to 'parent write'");
+                ((IoRingWrite *)ringWrite->driver)->timeout = 1000;
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("read until eof");
+
+                TEST_RESULT_INT(write(HRN_FORK_PARENT_WRITE_FD(0), "", 1), 1, "notify child");
+
+                TEST_RESULT_STR_Z(ioReadLine(ringRead), "end", "read end");
+                TEST_RESULT_UINT(ioRead(ringRead, bufNew(1)), 0, "read eof");
+                TEST_RESULT_BOOL(ioReadEof(ringRead), true, "check eof");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("write error when reader closed");
+
+                TEST_RESULT_VOID(ioRingWrite(ringWrite->driver, BUFSTRDEF("0123456789ABCDEF")), "fill ring");
+
+                TEST_RESULT_INT(write(HRN_FORK_PARENT_WRITE_FD(0), "", 1), 1, "notify child");
+
+                TEST_ERROR(
+                    ioRingWrite(ringWrite->driver, BUFSTRDEF("X")), FileWriteError,
+                    "unable to write to parent write: reader closed");
+            }
+            HRN_FORK_PARENT_END();
+        }
+        HRN_FORK_END();
+
+        TEST_RESULT_VOID(ioRingFree(ringParent), "free ring");
+        TEST_RESULT_VOID(ioRingFree(ringChild), "free ring");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("wakeup is not lost when the writer publishes while the reader drains");
+
+        // The writer publishes one byte at a time so it frequently finds the ring empty and sends a wakeup while the reader is
+        // draining. The reader only waits on the fd after a non-blocking read so a lost wakeup results in a timeout.
+        #define TEST_RING_TOTAL                                     100000
+
+        IoRing *ring = NULL;
+
+        TEST_ASSIGN(ring, ioRingNew(16), "new ring");
+
+        HRN_FORK_BEGIN()
+        {
+            HRN_FORK_CHILD_BEGIN()
+            {
+                IoWrite *ringWrite = ioRingWriteNew(STRDEF("child write"), ring, 5000);
+                ioWriteOpen(ringWrite);
+
+                for (unsigned int writeIdx = 0; writeIdx < TEST_RING_TOTAL; writeIdx++)
+                    ioRingWrite(ringWrite->driver, BUFSTRDEF("X"));
+
+                TEST_RESULT_VOID(ioWriteClose(ringWrite), "close write");
+            }
+            HRN_FORK_CHILD_END();
+
+            HRN_FORK_PARENT_BEGIN()
+            {
+                IoRead *ringRead = ioRingReadNew(STRDEF("parent read"), ring, 5000);
+                ioReadOpen(ringRead);
+
+                Buffer *const buffer = bufNew(32);
+                uint64_t total = 0;
+
+                // Only wait on the fd when the last read did not fill the buffer, since otherwise data may remain in the ring
+                while (total < TEST_RING_TOTAL && (bufFull(buffer) || fdReadyRead(ioReadFd(ringRead), 1000)))
+                {
+                    bufUsedZero(buffer);
+                    total += ioRingRead(ioReadDriver(ringRead), buffer, false);
+                }
+
+                TEST_RESULT_UINT(total, TEST_RING_TOTAL, "all data read without a lost wakeup");
+                TEST_RESULT_UINT(ioRead(ringRead, bufNew(1)), 0, "read eof");
+            }
+            HRN_FORK_PARENT_END();
+        }
+        HRN_FORK_END();
+
+        TEST_RESULT_VOID(ioRingFree(ring), "free ring");
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("IoRate"))
+    {
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("take tokens from a bucket");
+
+        uint64_t bucketTime = 0;
+
+        TEST_RESULT_UINT(ioRateTake(&bucketTime, 10000000, 500, 1000), 0, "full bucket");
+        TEST_RESULT_UINT(bucketTime, 9500000, "check bucket time");
+        TEST_RESULT_UINT(ioRateTake(&bucketTime, 10000000, 500, 1000), 0, "empty bucket");
+        TEST_RESULT_UINT(ioRateTake(&bucketTime, 10000000, 250, 1000), 250000, "wait for tokens");
+        TEST_RESULT_UINT(ioRateTake(&bucketTime, 10500000, 250, 1000), 0, "tokens replenished");
+        TEST_RESULT_UINT(ioRateTake(&bucketTime, 20000000, 2000, 1000), 1000000, "more tokens than the bucket holds");
+        bucketTime = 0;
+
+        TEST_RESULT_UINT(ioRateTake(&bucketTime, 500000, 100, 1000), 0, "time less than one second");
+        TEST_RESULT_UINT(bucketTime, 100000, "check bucket time");
+
+        bucketTime = 100000000;
+
+        TEST_RESULT_UINT(ioRateTake(&bucketTime, 20000000, 500, 1000), 80500000, "wait for tokens owed to other processes");
+        TEST_RESULT_UINT(bucketTime, 100500000, "check bucket time");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("no filter before limits are set");
+
+        IoWrite *write = ioBufferWriteNew(bufNew(0));
+
+        TEST_RESULT_VOID(ioRateInit(STRDEF(TEST_PATH "/none.rate"), 0, 0, 0), "no limits");
+        TEST_RESULT_VOID(ioRateAdd(ioWriteFilterGroup(write), ioRateTypeWrite), "add filter");
+        TEST_RESULT_UINT(ioFilterGroupSize(ioWriteFilterGroup(write)), 0, "no filter added");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("error on rate file");
+
+        IoFilter *filter = NULL;
+
+        TEST_ERROR_FMT(
+            ioRateNew(STRDEF(TEST_PATH), ioRateTypeRead, 1, 0), FileOpenError,
+            "unable to open rate file '" TEST_PATH "': [21] Is a directory");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("buckets from before a reboot are reset");
+
+        const String *const fileBoot = STRDEF(TEST_PATH "/boot" IO_RATE_FILE_EXT);
+
+        TEST_ASSIGN(filter, ioRateNew(fileBoot, ioRateTypeRead, 1, 0), "new filter");
+
+        IoRateShared *const shared = ((IoRate *)ioFilterDriver(filter))->shared;
+
+        TEST_RESULT_BOOL(shared->bootTime == ioRateBootTime(), true, "check boot time");
+
+        shared->bootTime = 1;
+        shared->byteTime[ioRateTypeRead] = 100000000;
+        shared->byteTime[ioRateTypeWrite] = 200000000;
+        shared->opTime = 300000000;
+
+        TEST_RESULT_VOID(ioRateNew(STRDEF(TEST_PATH "/none.rate"), ioRateTypeRead, 1, 0), "map another file");
+        TEST_ASSIGN(filter, ioRateNew(fileBoot, ioRateTypeRead, 1, 0), "new filter");
+        TEST_RESULT_BOOL(shared->bootTime == ioRateBootTime(), true, "check boot time");
+        TEST_RESULT_UINT(shared->byteTime[ioRateTypeRead], 0, "check read bucket");
+        TEST_RESULT_UINT(shared->byteTime[ioRateTypeWrite], 0, "check write bucket");
+        TEST_RESULT_UINT(shared->opTime, 0, "check op bucket");
+
+        TEST_TITLE("buckets from the same boot are not reset");
+
+        shared->bootTime -= 30;
+        shared->byteTime[ioRateTypeRead] = 100000000;
+
+        TEST_RESULT_VOID(ioRateNew(STRDEF(TEST_PATH "/none.rate"), ioRateTypeRead, 1, 0), "map another file");
+        TEST_ASSIGN(filter, ioRateNew(fileBoot, ioRateTypeRead, 1, 0), "new filter");
+        TEST_RESULT_UINT(shared->byteTime[ioRateTypeRead], 100000000, "check read bucket");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("aggregate rate of concurrent processes does not exceed the limit");
+
+        // Each process takes one second of tokens so the tokens owed exceed one second while the processes wait. The bucket starts
+        // full so one second of tokens is allowed in addition to the rate, plus some slack for the sleep resolution.
+        #define TEST_RATE_PROCESS                                   4
+        #define TEST_RATE_BYTE                                      1000
+
+        const String *const fileAggregate = STRDEF(TEST_PATH "/aggregate" IO_RATE_FILE_EXT);
+        TimeMSec timeBegin = timeMSec();
+
+        HRN_FORK_BEGIN()
+        {
+            for (unsigned int processIdx = 0; processIdx < TEST_RATE_PROCESS; processIdx++)
+            {
+                HRN_FORK_CHILD_BEGIN()
+                {
+                    IoFilter *const filterChild = ioRateNew(fileAggregate, ioRateTypeRead, TEST_RATE_BYTE, 0);
+
+                    ioFilterProcessIn(filterChild, bufNewC(zNewFmt("%01000d", 0), TEST_RATE_BYTE));
+                }
+                HRN_FORK_CHILD_END();
+            }
+
+            HRN_FORK_PARENT_BEGIN()
+            {
+            }
+            HRN_FORK_PARENT_END();
+        }
+        HRN_FORK_END();
+
+        const TimeMSec timeElapsed = timeMSec() - timeBegin;
+
+        TEST_RESULT_BOOL(
+            TEST_RATE_PROCESS * TEST_RATE_BYTE * MSEC_PER_SEC <= TEST_RATE_BYTE * (timeElapsed + MSEC_PER_SEC + 100), true,
+            "check aggregate rate");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("limits are shared between processes");
+
+        const String *const file = STRDEF(TEST_PATH "/lock/test" IO_RATE_FILE_EXT);
+
+        HRN_FORK_BEGIN()
+        {
+            HRN_FORK_CHILD_BEGIN()
+            {
+                // Create the rate file and take more tokens than the bucket holds so the parent must wait for tokens even after the
+                // child has waited
+                TEST_RESULT_VOID(ioRateInit(file, 10000, 0, 0), "set limits");
+
+                write = ioBufferWriteNew(bufNew(0));
+                TEST_RESULT_VOID(ioRateAdd(ioWriteFilterGroup(write), ioRateTypeWrite), "add write filter");
+                TEST_RESULT_UINT(ioFilterGroupSize(ioWriteFilterGroup(write)), 0, "no filter added without write limit");
+                TEST_RESULT_VOID(ioRateAdd(ioWriteFilterGroup(write), ioRateTypeRead), "add read filter");
+                ioWriteOpen(write);
+
+                TEST_RESULT_VOID(ioWrite(write, bufNewC(zNewFmt("%015000d", 0), 15000)), "write");
+
+                ioWriteClose(write);
+            }
+            HRN_FORK_CHILD_END();
+
+            // The tokens have been taken when the child exits at the end of the fork block
+            HRN_FORK_PARENT_BEGIN()
+            {
+            }
+            HRN_FORK_PARENT_END();
+        }
+        HRN_FORK_END();
+
+        TEST_RESULT_VOID(ioRateInit(file, 10000, 0, 10), "set limits");
+
+        write = ioBufferWriteNew(bufNew(0));
+        TEST_RESULT_VOID(ioRateAdd(ioWriteFilterGroup(write), ioRateTypeRead), "add filter");
+        TEST_RESULT_UINT(ioFilterGroupSize(ioWriteFilterGroup(write)), 1, "filter added");
+        ioWriteOpen(write);
+
+        timeBegin = timeMSec();
+        TEST_RESULT_VOID(ioWrite(write, bufNewC("12345678", 1000)), "write after waiting for tokens taken by child");
+        TEST_RESULT_BOOL(timeMSec() - timeBegin >= 50, true, "check time");
+
+        ioWriteClose(write);
+
+        TEST_RESULT_BOOL(
+            pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), IO_RATE_FILTER_TYPE)) >= 50, true, "check wait");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("operation limit applies to writes");
+
+        write = ioBufferWriteNew(bufNew(0));
+        TEST_RESULT_VOID(ioRateAdd(ioWriteFilterGroup(write), ioRateTypeWrite), "add filter");
+        TEST_RESULT_UINT(ioFilterGroupSize(ioWriteFilterGroup(write)), 1, "filter added");
+        ioWriteOpen(write);
+
+        timeBegin = timeMSec();
+
+        for (unsigned int opIdx = 0; opIdx < 12; opIdx++)
+            ioWrite(write, BUFSTRDEF("1"));
+
+        TEST_RESULT_BOOL(timeMSec() - timeBegin >= 100, true, "check time");
+
+        ioWriteClose(write);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("filter from pack");
+
+        TEST_ASSIGN(filter, ioRateNew(STRDEF(TEST_PATH "/test2" IO_RATE_FILE_EXT), ioRateTypeWrite, 2000, 0), "new filter");
+        TEST_ASSIGN(filter, ioRateNewPack(ioFilterParamList(filter)), "new filter from pack");
+        TEST_RESULT_UINT(ioFilterType(filter), IO_RATE_FILTER_TYPE, "check type");
+        TEST_RESULT_UINT(((IoRate *)ioFilterDriver(filter))->type, ioRateTypeWrite, "check rate type");
+        TEST_RESULT_UINT(((IoRate *)ioFilterDriver(filter))->byteRate, 2000, "check byte rate");
+        TEST_RESULT_UINT(((IoRate *)ioFilterDriver(filter))->opRate, 0, "check op rate");
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("IoTee"))
+    {
+        ioBufferSizeSet(3);
+
+        Buffer *const buffer = bufNew(0);
+        Buffer *const bufferTee = bufNew(0);
+        IoWrite *const write = ioBufferWriteNew(buffer);
+        IoWrite *const writeTee = ioBufferWriteNew(bufferTee);
+
+        TEST_RESULT_VOID(ioFilterGroupAdd(ioWriteFilterGroup(write), ioTeeNew(writeTee, false)), "add filter");
+
+        ioWriteOpen(writeTee);
+        ioWriteOpen(write);
+        TEST_RESULT_VOID(ioWriteStr(write, STRDEF("ABCDEFG")), "write");
+        ioWriteClose(write);
+        ioWriteClose(writeTee);
+
+        TEST_RESULT_STR_Z(strNewBuf(buffer), "ABCDEFG", "check write");
+        TEST_RESULT_STR_Z(strNewBuf(bufferTee), "ABCDEFG", "check tee");
+        TEST_RESULT_UINT(pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), TEE_FILTER_TYPE)), 7, "check filter result");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("catch tee write error");
+
+        IoWrite *const writeError = ioBufferWriteNew(bufNew(0));
+        IoWrite *const writeTeeError = ioFdWriteNewOpen(STRDEF("tee"), -1, 1000);
+
+        TEST_RESULT_VOID(ioFilterGroupAdd(ioWriteFilterGroup(writeError), ioTeeNew(writeTeeError, true)), "add filter");
+
+        ioWriteOpen(writeError);
+        TEST_RESULT_VOID(ioWriteStr(writeError, STRDEF("ABCDEFG")), "write");
+        TEST_RESULT_VOID(ioWriteStr(writeError, STRDEF("HIJ")), "write after error");
+        ioWriteClose(writeError);
+
+        PackRead *const result = ioFilterGroupResultP(ioWriteFilterGroup(writeError), TEE_FILTER_TYPE);
+
+        TEST_RESULT_UINT(pckReadU64P(result), 0, "check size");
+        TEST_RESULT_STR_Z(pckReadStrP(result), "[FileWriteError] unable to write to tee: [9] Bad file descriptor", "check error");
     }
 
     // *****************************************************************************************************************************
@@ -931,6 +931,26 @@ testRun(void)
                 TEST_RESULT_VOID(ioRead(ioSessionIoReadP(session, .ignoreUnexpectedEof = true), output), "ignore syscall error");
                 TEST_RESULT_STR_Z(strNewBuf(output), "0123456789AC", "all bytes read");
 
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("session resumed after clean close");
+
+                hrnServerScriptAccept(tls);
+                hrnServerScriptReplyZ(tls, "RESUME");
+                hrnServerScriptClose(tls);
+
+                TEST_ASSIGN(session, ioClientOpen(client), "open client (full handshake)");
+
+                output = bufNew(6);
+                TEST_RESULT_UINT(ioRead(ioSessionIoReadP(session), output), 6, "read output");
+                TEST_RESULT_VOID(ioSessionClose(session), "close");
+
+                hrnServerScriptAccept(tls);
+                hrnServerScriptClose(tls);
+
+                TEST_ASSIGN(session, ioClientOpen(client), "open client (resumed)");
+                TEST_RESULT_BOOL(SSL_session_reused(((TlsSession *)session->pub.driver)->session), true, "session resumed");
+                TEST_RESULT_VOID(ioSessionClose(session), "close");
+
                 // -----------------------------------------------------------------------------------------------------------------
                 TEST_TITLE("close connection");
 
@@ -946,7 +966,7 @@ testRun(void)
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("stastistics exist");
 
-        TEST_RESULT_PTR_NE(statToJson(), NULL, "check");
+        TEST_RESULT_PTR_NE(statToJsonP(), NULL, "check");
     }
 
     FUNCTION_HARNESS_RETURN_VOID();
@@ -260,6 +260,35 @@ testRun(void)
 
         // Release lock manually
         lockReleaseFile(lockFdTest, lockFileTest);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("forget locks");
+
+        TEST_RESULT_VOID(lockForget(), "forget when no lock is held");
+
+        TEST_RESULT_BOOL(lockAcquire(TEST_PATH_STR, stanza, STRDEF("1-test"), lockTypeAll, 0, true), true, "all lock");
+        TEST_RESULT_VOID(lockForget(), "forget all locks");
+        TEST_RESULT_BOOL(lockRelease(false), false, "no lock is held");
+        TEST_RESULT_BOOL(storageExistsP(storageTest, archiveLockFile), true, "archive lock file was not removed");
+        TEST_RESULT_BOOL(storageExistsP(storageTest, backupLockFile), true, "backup lock file was not removed");
+
+        TEST_RESULT_BOOL(
+            lockAcquire(TEST_PATH_STR, stanza, STRDEF("2-test"), lockTypeAll, 0, true), true, "all lock since files were closed");
+        TEST_RESULT_VOID(lockRelease(true), "release all locks");
+
+        TEST_TITLE("forget lock acquired on the same exec-id");
+
+        TEST_RESULT_BOOL(lockAcquire(TEST_PATH_STR, stanza, STRDEF("1-test"), lockTypeBackup, 0, true), true, "backup lock");
+
+        lockFdTest = lockLocal.file[lockTypeBackup].fd;
+        lockFileTest = strDup(lockLocal.file[lockTypeBackup].name);
+        lockLocal.held = lockTypeNone;
+
+        TEST_RESULT_BOOL(lockAcquire(TEST_PATH_STR, stanza, STRDEF("1-test"), lockTypeBackup, 0, true), true, "backup lock again");
+        TEST_RESULT_INT(lockLocal.file[lockTypeBackup].fd, LOCK_ON_EXEC_ID, "lock held by exec-id");
+        TEST_RESULT_VOID(lockForget(), "forget backup lock");
+
+        lockReleaseFile(lockFdTest, lockFileTest);
     }
 
     // *****************************************************************************************************************************
@@ -1,6 +1,7 @@
 /***********************************************************************************************************************************
 Test Statistics Collector
 ***********************************************************************************************************************************/
+#include "common/time.h"
 #include "common/type/json.h"
 
 /***********************************************************************************************************************************
@@ -19,7 +20,7 @@ testRun(void)
 
         TEST_RESULT_UINT(lstSize(statLocalData.stat), 0, "stat list is empty");
 
-        TEST_RESULT_STR_Z(statToJson(), NULL, "no stats yet");
+        TEST_RESULT_STR_Z(statToJsonP(), NULL, "no stats yet");
 
         TEST_RESULT_VOID(statInc(statTlsClient), "inc tls.client");
         TEST_RESULT_UINT(lstSize(statLocalData.stat), 1, "stat list has one stat");
@@ -29,7 +30,111 @@ testRun(void)
         TEST_RESULT_UINT(lstSize(statLocalData.stat), 2, "stat list has two stats");
 
         TEST_RESULT_STR_Z(
-            statToJson(), "{\"http.session\":{\"total\":1},\"tls.client\":{\"total\":2}}", "stat output");
+            statToJsonP(), "{\"http.session\":{\"total\":1},\"tls.client\":{\"total\":2}}", "stat output");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("add to counter");
+
+        TEST_RESULT_VOID(statAdd(statHttpSession, 1024), "add");
+        TEST_RESULT_STR_Z(
+            statToJsonP(), "{\"http.session\":{\"total\":1025},\"tls.client\":{\"total\":2}}", "stat output");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("latency histogram");
+
+        const String *const statLatencyKey = STRDEF("latency");
+
+        TEST_RESULT_VOID(statLatency(statLatencyKey, 1000), "latency 1000");
+        TEST_RESULT_VOID(statLatency(statLatencyKey, 0), "latency 0");
+        TEST_RESULT_VOID(statLatency(statLatencyKey, 7), "latency 7");
+        TEST_RESULT_VOID(statLatency(statLatencyKey, 8), "latency 8");
+        TEST_RESULT_VOID(statLatency(statLatencyKey, 1023), "latency 1023");
+        TEST_RESULT_VOID(statLatency(statLatencyKey, UINT64_MAX), "latency max");
+
+        TEST_RESULT_UINT(statBucketIdx(UINT64_MAX), STAT_BUCKET_TOTAL - 1, "max bucket");
+        TEST_RESULT_UINT(statBucketMin(STAT_BUCKET_TOTAL - 1), 0xF000000000000000, "max bucket min");
+        TEST_RESULT_UINT(statBucketIdx(statBucketMin(63)), 63, "bucket min is in bucket");
+
+        TEST_RESULT_STR_Z(
+            statToJsonP(),
+            "{\"http.session\":{\"total\":1025},"
+            "\"latency\":{\"count\":6,\"max\":18446744073709551615,\"min\":0,\"p50\":8,\"p90\":18446744073709551615,"
+            "\"p99\":18446744073709551615,\"sum\":2037},"
+            "\"tls.client\":{\"total\":2}}",
+            "stat output");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("latency and counter on the same stat with timer");
+
+        const uint64_t timeBegin = statTimeBegin();
+        sleepMSec(2);
+
+        TEST_RESULT_VOID(statTimeEnd(statTlsClient, timeBegin), "time end");
+        TEST_RESULT_BOOL(statToJsonP() != NULL, true, "stat output");
+
+        const Stat *const stat = lstFind(statLocalData.stat, &statTlsClient);
+
+        TEST_RESULT_UINT(stat->histogram->count, 1, "count");
+        TEST_RESULT_BOOL(stat->histogram->min >= 2000, true, "min");
+        TEST_RESULT_UINT(stat->total, 2, "total");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("merge stats from another process");
+
+        String *const statJson = statToJsonP(.histogram = true);
+
+        TEST_RESULT_BOOL(
+            strBeginsWithZ(
+                statJson,
+                "{\"http.session\":{\"total\":1025},"
+                "\"latency\":{\"bucket\":[[0,1],[7,1],[8,1],[960,2],[17293822569102704640,1]],\"count\":6,"),
+            true, "stat output with histogram");
+
+        TEST_RESULT_VOID(statReset(), "reset");
+        TEST_RESULT_STR_Z(statToJsonP(), NULL, "no stats");
+
+        TEST_RESULT_VOID(statMerge(NULL), "merge nothing");
+        TEST_RESULT_VOID(statMerge(statJson), "merge");
+        TEST_RESULT_STR(statToJsonP(.histogram = true), statJson, "merged stats match");
+
+        TEST_RESULT_VOID(
+            statMerge(
+                STRDEF(
+                    "{\"latency\":{\"bucket\":[[1,2]],\"count\":2,\"max\":1,\"min\":1,\"p50\":1,\"p90\":1,\"p99\":1,"
+                    "\"sum\":2},\"new\":{\"total\":3}}")),
+            "merge again");
+        TEST_RESULT_BOOL(
+            strBeginsWithZ(
+                statToJsonP(),
+                "{\"http.session\":{\"total\":1025},"
+                "\"latency\":{\"count\":8,\"max\":18446744073709551615,\"min\":0,\"p50\":7,\"p90\":18446744073709551615,"
+                "\"p99\":18446744073709551615,\"sum\":2039},"
+                "\"new\":{\"total\":3},"),
+            true, "merged stats");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("key from prefix and StringId");
+
+        const String *const statKey = statKeyStrId("prefix", strIdFromZ("cmd"));
+
+        TEST_RESULT_STR_Z(statKey, "prefix.cmd", "key");
+        TEST_RESULT_BOOL(statKeyStrId("prefix", strIdFromZ("cmd")) == statKey, true, "key is cached");
+        TEST_RESULT_STR_Z(statKeyStrId("other", strIdFromZ("cmd")), "other.cmd", "key with other prefix");
+        TEST_RESULT_UINT(lstSize(statLocalData.key), 2, "two keys cached");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("stats are not added before init");
+
+        MemContext *const memContext = statLocalData.memContext;
+        statLocalData.memContext = NULL;
+
+        TEST_RESULT_VOID(statAdd(statHttpSession, 1), "add");
+        TEST_RESULT_VOID(statLatency(statHttpSession, 1), "latency");
+        TEST_RESULT_STR_Z(statKeyStrId("prefix", strIdFromZ("cmd")), "prefix.cmd", "key is not cached");
+
+        statLocalData.memContext = memContext;
+
+        TEST_RESULT_UINT(((Stat *)lstFind(statLocalData.stat, &statHttpSession))->total, 1025, "total unchanged");
     }
 
     FUNCTION_HARNESS_RETURN_VOID();
@@ -0,0 +1,77 @@
+/***********************************************************************************************************************************
+Test Trace Collector
+***********************************************************************************************************************************/
+#include "common/regExp.h"
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+static void
+testRun(void)
+{
+    FUNCTION_HARNESS_VOID();
+
+    // *****************************************************************************************************************************
+    if (testBegin("all"))
+    {
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("spans are not recorded before init");
+
+        TEST_RESULT_BOOL(traceEnabled(), false, "not enabled");
+        TEST_RESULT_UINT(traceBegin(), 0, "no begin time");
+        TEST_RESULT_VOID(traceEndP("span", 0), "end");
+        TEST_RESULT_STR(traceEvent(), NULL, "no events");
+        TEST_RESULT_VOID(traceMerge(NULL), "merge nothing");
+        TEST_RESULT_VOID(traceReset(), "reset");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("record spans");
+
+        TEST_RESULT_VOID(traceInit(3), "init");
+        TEST_RESULT_BOOL(traceEnabled(), true, "enabled");
+        TEST_RESULT_STR(traceEvent(), NULL, "no events");
+        TEST_RESULT_STR_Z(traceToJson(), "[]\n", "empty trace");
+
+        const uint64_t timeBegin = traceBegin();
+        TEST_RESULT_BOOL(timeBegin > 0, true, "begin time");
+
+        TEST_RESULT_VOID(traceEndP("span1", timeBegin), "end span without args");
+
+        KeyValue *const arg = kvNew();
+        kvPut(arg, VARSTRDEF("size"), VARUINT64(8192));
+        kvPut(arg, VARSTRDEF("file"), VARSTRDEF("base/1/2"));
+
+        TEST_RESULT_VOID(traceEndP("span2", timeBegin, .arg = arg), "end span with args");
+        TEST_RESULT_UINT(varLstSize(kvKeyList(arg)), 2, "args are not moved");
+
+        const String *const event = strDup(traceEvent());
+
+        TEST_RESULT_BOOL(
+            regExpMatchOne(
+                STRDEF(
+                    "^\\{\"dur\":[0-9]+,\"name\":\"span1\",\"ph\":\"X\",\"pid\":3,\"tid\":0,\"ts\":[0-9]+\\},\n"
+                    "\\{\"args\":\\{\"file\":\"base/1/2\",\"size\":8192\\},\"dur\":[0-9]+,\"name\":\"span2\",\"ph\":\"X\","
+                    "\"pid\":3,\"tid\":0,\"ts\":[0-9]+\\}$"),
+                event),
+            true, "check events");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("merge events from another process");
+
+        TEST_RESULT_VOID(traceReset(), "reset");
+        TEST_RESULT_STR(traceEvent(), NULL, "no events");
+
+        TEST_RESULT_VOID(traceMerge(STRDEF("{\"name\":\"other\"}")), "merge");
+        TEST_RESULT_VOID(traceMerge(event), "merge");
+        TEST_RESULT_STR(traceEvent(), strNewFmt("{\"name\":\"other\"},\n%s", strZ(event)), "check events");
+        TEST_RESULT_STR(traceToJson(), strNewFmt("[\n{\"name\":\"other\"},\n%s\n]\n", strZ(event)), "check trace");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("init discards events, e.g. after fork");
+
+        TEST_RESULT_VOID(traceInit(1), "init");
+        TEST_RESULT_STR(traceEvent(), NULL, "no events");
+    }
+
+    FUNCTION_HARNESS_RETURN_VOID();
+}
@@ -193,6 +193,16 @@ testRun(void)
         TEST_RESULT_INT(lstComparatorZ(&string1, &string1), 0, "strings are equal");
         TEST_RESULT_BOOL(lstComparatorZ(&string1, &string2) < 0, true, "first string is less");
         TEST_RESULT_BOOL(lstComparatorZ(&string2, &string1) > 0, true, "first string is greater");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("lstComparatorUInt()");
+
+        const unsigned int uint1 = 1;
+        const unsigned int uint2 = UINT_MAX;
+
+        TEST_RESULT_INT(lstComparatorUInt(&uint1, &uint1), 0, "values are equal");
+        TEST_RESULT_INT(lstComparatorUInt(&uint1, &uint2), -1, "first value is less");
+        TEST_RESULT_INT(lstComparatorUInt(&uint2, &uint1), 1, "first value is greater");
     }
 
     // *****************************************************************************************************************************
@@ -220,6 +220,58 @@ testRun(void)
             "'50.5' is not valid for 'protocol-timeout' option\n"
                 "HINT 'protocol-timeout' option (50.5) should be greater than 'db-timeout' option (100000).");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("error when process-min is greater than process-max");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test");
+        hrnCfgArgKeyRawZ(argList, cfgOptPgPath, 1, "/pg1");
+        hrnCfgArgRawZ(argList, cfgOptProcessMax, "2");
+        hrnCfgArgRawZ(argList, cfgOptProcessMin, "3");
+        TEST_ERROR(
+            hrnCfgLoadP(cfgCmdBackup, argList), OptionInvalidValueError,
+            "'3' is not valid for 'process-min' option\n"
+                "HINT 'process-min' option must not be greater than 'process-max' option (2).");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("error when compress-level-min is greater than compress-level or compress-level-max");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test");
+        hrnCfgArgKeyRawZ(argList, cfgOptPgPath, 1, "/pg1");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        hrnCfgArgRawZ(argList, cfgOptCompressLevelMin, "7");
+        TEST_ERROR(
+            hrnCfgLoadP(cfgCmdBackup, argList), OptionInvalidValueError,
+            "'7' is not valid for 'compress-level-min' option\n"
+                "HINT 'compress-level-min' option must not be greater than 'compress-level' option (6).");
+
+        hrnCfgArgRawZ(argList, cfgOptCompressLevelMax, "5");
+        TEST_ERROR(
+            hrnCfgLoadP(cfgCmdBackup, argList), OptionInvalidValueError,
+            "'7' is not valid for 'compress-level-min' option\n"
+                "HINT 'compress-level-min' option must not be greater than 'compress-level-max' option (5).");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("error when split-size is less than the page size");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test");
+        hrnCfgArgKeyRawZ(argList, cfgOptPgPath, 1, "/pg1");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        hrnCfgArgRawZ(argList, cfgOptSplitSize, "8191");
+        TEST_ERROR(
+            hrnCfgLoadP(cfgCmdBackup, argList), OptionInvalidValueError,
+            "'8191' is not valid for 'split-size' option\n"
+                "HINT 'split-size' option must be 0 or at least the page size (8192).");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test");
+        hrnCfgArgKeyRawZ(argList, cfgOptPgPath, 1, "/pg1");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        hrnCfgArgRawZ(argList, cfgOptSplitSize, "8KiB");
+        TEST_RESULT_VOID(hrnCfgLoadP(cfgCmdBackup, argList), "split-size is the page size");
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("very small protocol-timeout triggers db-timeout special handling");
 
@@ -31,7 +31,7 @@ testRun(void)
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_RESULT_UINT(sizeof(ManifestLoadFound), TEST_64BIT() ? 1 : 1, "check size of ManifestLoadFound");
         TEST_RESULT_UINT(sizeof(ManifestPath), TEST_64BIT() ? 32 : 16, "check size of ManifestPath");
-        TEST_RESULT_UINT(sizeof(ManifestFile), TEST_64BIT() ? 136 : 108, "check size of ManifestFile");
+        TEST_RESULT_UINT(sizeof(ManifestFile), TEST_64BIT() ? 184 : 152, "check size of ManifestFile");
     }
 
     // *****************************************************************************************************************************
@@ -1091,7 +1091,7 @@ testRun(void)
                 manifestPrior,
                 &(ManifestFile){
                 .name = STRDEF(MANIFEST_TARGET_PGDATA "/" PG_FILE_PGVERSION), .size = 4, .sizeRepo = 4, .timestamp = 1482182860,
-                .checksumSha1 = "aaaaaaaaaabbbbbbbbbbccccccccccdddddddddd"});
+                .checksumSha1 = "aaaaaaaaaabbbbbbbbbbccccccccccdddddddddd", .dedup = true});
         }
         OBJ_NEW_END();
 
@@ -1113,8 +1113,8 @@ testRun(void)
                 "pg_data/BOGUS={\"size\":6,\"timestamp\":1482182860}\n"
                 "pg_data/FILE3={\"reference\":\"20190101-010101F\",\"size\":0,\"timestamp\":1482182860}\n"
                 "pg_data/FILE4={\"size\":55,\"timestamp\":1482182861}\n"
-                "pg_data/PG_VERSION={\"checksum\":\"aaaaaaaaaabbbbbbbbbbccccccccccdddddddddd\",\"reference\":\"20190101-010101F\","
-                    "\"size\":4,\"timestamp\":1482182860}\n"
+                "pg_data/PG_VERSION={\"checksum\":\"aaaaaaaaaabbbbbbbbbbccccccccccdddddddddd\",\"dedup\":true,"
+                    "\"reference\":\"20190101-010101F\",\"size\":4,\"timestamp\":1482182860}\n"
                 TEST_MANIFEST_FILE_DEFAULT
                 "\n"
                 "[target:path]\n"
@@ -1162,8 +1162,8 @@ testRun(void)
                 "[target:file]\n"
                 "pg_data/FILE1={\"checksum\":\"aaaaaaaaaabbbbbbbbbbccccccccccdddddddddd\","
                     "\"reference\":\"20190101-010101F_20190202-010101D\",\"size\":4,\"timestamp\":1482182860}\n"
-                "pg_data/PG_VERSION={\"checksum\":\"aaaaaaaaaabbbbbbbbbbccccccccccdddddddddd\",\"reference\":\"20190101-010101F\","
-                    "\"size\":4,\"timestamp\":1482182860}\n"
+                "pg_data/PG_VERSION={\"checksum\":\"aaaaaaaaaabbbbbbbbbbccccccccccdddddddddd\",\"dedup\":true,"
+                    "\"reference\":\"20190101-010101F\",\"size\":4,\"timestamp\":1482182860}\n"
                 TEST_MANIFEST_FILE_DEFAULT
                 "\n"
                 "[target:path]\n"
@@ -1438,6 +1438,7 @@ testRun(void)
             "backup-archive-start=\"000000030000028500000089\"\n"                                                                  \
             "backup-archive-stop=\"000000030000028500000089\"\n"                                                                   \
             "backup-bundle=true\n"                                                                                                 \
+            "backup-bundle-dict=true\n"                                                                                            \
             "backup-label=\"20190818-084502F_20190820-084502D\"\n"                                                                 \
             "backup-lsn-start=\"285/89000028\"\n"                                                                                  \
             "backup-lsn-stop=\"285/89001F88\"\n"                                                                                   \
@@ -1501,15 +1502,18 @@ testRun(void)
             "[target:file]\n"                                                                                                      \
             "pg_data/=equal=more=={\"mode\":\"0640\",\"size\":0,\"timestamp\":1565282120}\n"                                       \
             "pg_data/PG_VERSION={\"checksum\":\"184473f470864e067ee3a22e64b47b0a1c356f29\""                                        \
-                ",\"reference\":\"20190818-084502F_20190819-084506D\",\"size\":4,\"timestamp\":1565282114}\n"                      \
+                ",\"checksum-repo\":\"0f1a3e68e8c5e45e1bca3d9fb8a9c4d2\",\"reference\":\"20190818-084502F_20190819-084506D\""      \
+                ",\"size\":4,\"timestamp\":1565282114}\n"                                                                          \
             "pg_data/base/16384/17000={\"bni\":1,\"checksum\":\"e0101dd8ffb910c9c202ca35b5f828bcb9697bed\",\"checksum-page\":false"\
-                ",\"checksum-page-error\":[1],\"repo-size\":4096,\"size\":8192,\"timestamp\":1565282114}\n"                        \
+                ",\"checksum-page-error\":[1],\"dict\":true,\"repo-size\":4096,\"size\":8192,\"timestamp\":1565282114}\n"          \
             "pg_data/base/16384/PG_VERSION={\"bni\":1,\"bno\":1,\"checksum\":\"184473f470864e067ee3a22e64b47b0a1c356f29\""         \
                 ",\"group\":\"group2\",\"size\":4,\"timestamp\":1565282115,\"user\":false}\n"                                      \
             "pg_data/base/32768/33000={\"checksum\":\"7a16d165e4775f7c92e8cdf60c0af57313f0bf90\",\"checksum-page\":true"           \
-                ",\"reference\":\"20190818-084502F\",\"size\":1073741824,\"timestamp\":1565282116}\n"                              \
-            "pg_data/base/32768/33000.32767={\"checksum\":\"6e99b589e550e68e934fd235ccba59fe5b592a9e\",\"checksum-page\":true"     \
-                ",\"reference\":\"20190818-084502F\",\"size\":32768,\"timestamp\":1565282114}\n"                                   \
+                ",\"compress-fast\":true,\"dedup\":true,\"reference\":\"20190818-084502F\",\"size\":1073741824"                    \
+                ",\"timestamp\":1565282116}\n"                                                                                     \
+            "pg_data/base/32768/33000.32767={\"checksum\":\"d285cfdc0aa85c95d6d9e2dd413f02607f4020f4\",\"checksum-page\":true"     \
+                ",\"reference\":\"20190818-084502F\",\"size\":32768,\"split-checksum\":\"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" \
+                "bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb\",\"split-size\":16384,\"timestamp\":1565282114}\n"                      \
             "pg_data/postgresql.conf={\"size\":4457,\"timestamp\":1565282114}\n"                                                   \
             "pg_data/special-@#!$^&*()_+~`{}[]\\:;={\"mode\":\"0640\",\"size\":0,\"timestamp\":1565282120,\"user\":false}\n"
 
@@ -1606,29 +1610,75 @@ testRun(void)
         TEST_TITLE("manifest validation");
 
         // Munge files to produce errors
-        manifestFileUpdate(manifest, STRDEF("pg_data/postgresql.conf"), 4457, 0, NULL, NULL, false, false, NULL, 0, 0);
-        manifestFileUpdate(manifest, STRDEF("pg_data/base/32768/33000.32767"), 0, 0, NULL, NULL, true, false, NULL, 0, 0);
+        manifestFileUpdate(
+            manifest, STRDEF("pg_data/postgresql.conf"), 4457, 0, NULL, NULL, false, false, NULL, 0, 0, false, false, false, NULL, 0,
+            NULL);
+        manifestFileUpdate(
+            manifest, STRDEF("pg_data/base/32768/33000.32767"), 0, 0, NULL, NULL, true, false, NULL, 0, 0, false, false, false,
+            NULL, 0, NULL);
+        manifestFileUpdate(
+            manifest, STRDEF("pg_data/PG_VERSION"), 4, 4, NULL, NULL, false, false, NULL, 0, 0, false, false, false,
+            "0f1a3e68e8c5e45e1bca3d9fb8a9c4d2", 8192, STRDEF("cccccccccccccccccccccccccccccccccccccccc"));
+        manifestFileUpdate(
+            manifest, STRDEF("pg_data/base/32768/33000"), 1073741824, 1073741824, NULL, NULL, true, false, NULL, 0, 0, false, false,
+            true, NULL, 536870912, STRDEF("cccccccccccccccccccccccccccccccccccccccc"));
 
         TEST_ERROR(
             manifestValidate(manifest, false), FormatError,
             "manifest validation failed:\n"
+            "split checksum does not match checksum '184473f470864e067ee3a22e64b47b0a1c356f29' for file 'pg_data/PG_VERSION'\n"
+            "invalid split checksum for file 'pg_data/base/32768/33000' with 2 part(s)\n"
             "missing checksum for file 'pg_data/postgresql.conf'");
 
         TEST_ERROR(
             manifestValidate(manifest, true), FormatError,
             "manifest validation failed:\n"
-            "invalid checksum '6e99b589e550e68e934fd235ccba59fe5b592a9e' for zero size file 'pg_data/base/32768/33000.32767'\n"
+            "split checksum does not match checksum '184473f470864e067ee3a22e64b47b0a1c356f29' for file 'pg_data/PG_VERSION'\n"
+            "invalid split checksum for file 'pg_data/base/32768/33000' with 2 part(s)\n"
+            "invalid checksum 'd285cfdc0aa85c95d6d9e2dd413f02607f4020f4' for zero size file 'pg_data/base/32768/33000.32767'\n"
             "missing checksum for file 'pg_data/postgresql.conf'\n"
             "repo size must be > 0 for file 'pg_data/postgresql.conf'");
 
         // Undo changes made to files
-        manifestFileUpdate(manifest, STRDEF("pg_data/base/32768/33000.32767"), 32768, 32768, NULL, NULL, true, false, NULL, 0, 0);
+        manifestFileUpdate(
+            manifest, STRDEF("pg_data/base/32768/33000.32767"), 32768, 32768, NULL, NULL, true, false, NULL, 0, 0, false, false,
+            false, NULL, 16384, STRDEF("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" "bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb"));
+        manifestFileUpdate(
+            manifest, STRDEF("pg_data/PG_VERSION"), 4, 4, NULL, NULL, false, false, NULL, 0, 0, false, false, false,
+            "0f1a3e68e8c5e45e1bca3d9fb8a9c4d2", 0, NULL);
+        manifestFileUpdate(
+            manifest, STRDEF("pg_data/base/32768/33000"), 1073741824, 1073741824, NULL, NULL, true, false, NULL, 0, 0, false, true,
+            true, NULL, 0, NULL);
         manifestFileUpdate(
             manifest, STRDEF("pg_data/postgresql.conf"), 4457, 4457, "184473f470864e067ee3a22e64b47b0a1c356f29", NULL, false,
-            false, NULL, 0, 0);
+            false, NULL, 0, 0, false, false, false, NULL, 0, NULL);
 
         TEST_RESULT_VOID(manifestValidate(manifest, true), "successful validate");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("split file");
+
+        ManifestFile fileSplit = manifestFileFind(manifest, STRDEF("pg_data/base/32768/33000.32767"));
+
+        TEST_RESULT_UINT(manifestSplitTotal(&fileSplit), 2, "split total");
+        TEST_RESULT_STR_Z(manifestSplitChecksum(&fileSplit, 1), "bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb", "split checksum");
+        TEST_RESULT_STR_Z(
+            manifestSplitFile(fileSplit.name, 1, compressTypeGz), "pg_data/base/32768/33000.32767.pgbackrest.part.1.gz",
+            "split file");
+
+        manifestFileUpdate(
+            manifest, STRDEF("pg_data/base/32768/33000.32767"), 40000, 32768, NULL, NULL, true, true, STRDEF("[1]"), 0, 0, false,
+            false, false, NULL, 16384, STRDEF("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" "bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb" "cccccccccccccccccccccccccccccccccccccccc"));
+        fileSplit = manifestFileFind(manifest, STRDEF("pg_data/base/32768/33000.32767"));
+
+        TEST_RESULT_STR_Z(fileSplit.checksumPageErrorList, "[1]", "checksum page error list");
+        TEST_RESULT_UINT(manifestSplitTotal(&fileSplit), 3, "split total");
+        TEST_RESULT_STR_Z(manifestSplitChecksum(&fileSplit, 2), "cccccccccccccccccccccccccccccccccccccccc", "split checksum");
+
+        manifestFileUpdate(
+            manifest, STRDEF("pg_data/base/32768/33000.32767"), 32768, 32768, NULL, NULL, true, false, NULL, 0, 0, false, false,
+            false, NULL, 16384, STRDEF("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" "bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb"));
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("manifest complete");
 
@@ -1679,6 +1729,10 @@ testRun(void)
                 STRDEF("285/89001F88"), STRDEF("000000030000028500000089"), 1, 1000000000000000094, pckWriteResult(dbList),
                 true, true, 16384, 3, 6, true, 32, false, annotationKV),
             "manifest complete with db");
+        TEST_RESULT_VOID(manifestBundleDictSet(manifest, true), "bundle dict set");
+        TEST_RESULT_VOID(manifestPgIdSet(manifest, 2), "pg id set");
+        TEST_RESULT_UINT(manifestData(manifest)->pgId, 2, "check pg id");
+        manifestPgIdSet(manifest, 1);
 
         TEST_RESULT_STR_Z(manifestPathPg(STRDEF("pg_data")), NULL, "check pg_data path");
         TEST_RESULT_STR_Z(manifestPathPg(STRDEF("pg_data/PG_VERSION")), "PG_VERSION", "check pg_data path/file");
@@ -1793,7 +1847,8 @@ testRun(void)
 
         TEST_RESULT_VOID(
             manifestFileUpdate(
-                manifest, STRDEF("pg_data/postgresql.conf"), 4457, 4457, NULL, varNewStr(NULL), false, false, NULL, 0, 0),
+                manifest, STRDEF("pg_data/postgresql.conf"), 4457, 4457, NULL, varNewStr(NULL), false, false, NULL, 0, 0, false,
+                false, false, NULL, 0, NULL),
             "update file");
 
         // ManifestDb getters
@@ -1895,6 +1950,11 @@ testRun(void)
         TEST_ERROR(
             manifestNewLoad(ioBufferReadNew(BUFSTRDEF("[target:file]\npg_data/bogus={\"timestamp\":0}"))), FormatError,
             "missing size for file 'pg_data/bogus'");
+        TEST_ERROR(
+            manifestNewLoad(
+                ioBufferReadNew(
+                    BUFSTRDEF("[target:file]\npg_data/bogus={\"size\":1,\"split-checksum\":\"\",\"timestamp\":0}"))),
+            FormatError, "missing split size for file 'pg_data/bogus'");
     }
 
     // *****************************************************************************************************************************
@@ -1902,6 +1962,16 @@ testRun(void)
     {
         Manifest *manifest = NULL;
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("dedup file name");
+
+        TEST_RESULT_STR_Z(
+            manifestDedupFile("aaaaaaaaaabbbbbbbbbbccccccccccdddddddddd", compressTypeGz),
+            "dedup/aa/aaaaaaaaaabbbbbbbbbbccccccccccdddddddddd.gz", "dedup file");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("load missing manifest");
+
         TEST_ERROR(
             manifestLoadFile(storageTest, BACKUP_MANIFEST_FILE_STR, cipherTypeNone, NULL), FileMissingError,
             "unable to load backup manifest file '" TEST_PATH "/backup.manifest' or '" TEST_PATH "/backup.manifest.copy':\n"
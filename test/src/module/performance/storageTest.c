@@ -201,6 +201,49 @@ testRun(void)
         HRN_FORK_END();
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("storagePosixList()"))
+    {
+        // Ten thousand files represents a fairly large database directory
+        ASSERT(TEST_SCALE <= 2000);
+        const unsigned int fileTotal = 10000 * TEST_SCALE;
+
+        TEST_TITLE_FMT("list %u files at each info level", fileTotal);
+
+        HRN_SYSTEM_FMT("mkdir " TEST_PATH "/list && cd " TEST_PATH "/list && seq -w 1 %u | xargs touch", fileTotal);
+
+        const Storage *const storageTest = storagePosixNewP(STRDEF(TEST_PATH));
+
+        static const struct
+        {
+            StorageInfoLevel level;
+            const char *name;
+        } levelList[] =
+        {
+            {.level = storageInfoLevelExists, .name = "exists"},
+            {.level = storageInfoLevelType, .name = "type"},
+            {.level = storageInfoLevelBasic, .name = "basic"},
+            {.level = storageInfoLevelDetail, .name = "detail"},
+        };
+
+        for (unsigned int levelIdx = 0; levelIdx < LENGTH_OF(levelList); levelIdx++)
+        {
+            const TimeMSec timeBegin = timeMSec();
+            unsigned int listTotal = 0;
+
+            StorageIterator *const storageItr = storageNewItrP(storageTest, STRDEF("list"), .level = levelList[levelIdx].level);
+
+            while (storageItrMore(storageItr))
+            {
+                storageItrNext(storageItr);
+                listTotal++;
+            }
+
+            TEST_RESULT_UINT(listTotal, fileTotal, "check total");
+            TEST_LOG_FMT("level %s listed in %ums", levelList[levelIdx].name, (unsigned int)(timeMSec() - timeBegin));
+        }
+    }
+
     // *****************************************************************************************************************************
     if (testBegin("benchmark filters"))
     {
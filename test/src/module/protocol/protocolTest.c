@@ -186,6 +186,28 @@ static ProtocolParallelJob *testParallelJobCallback(void *data, unsigned int cli
     FUNCTION_TEST_RETURN(PROTOCOL_PARALLEL_JOB, NULL);
 }
 
+/***********************************************************************************************************************************
+Test local run in a forked process
+***********************************************************************************************************************************/
+static int
+testLocalFork(const StringList *const param, IoRead *const forkRead, IoWrite *const forkWrite)
+{
+    FUNCTION_HARNESS_BEGIN();
+        FUNCTION_HARNESS_PARAM(STRING_LIST, param);
+        FUNCTION_HARNESS_PARAM(IO_READ, forkRead);
+        FUNCTION_HARNESS_PARAM(IO_WRITE, forkWrite);
+    FUNCTION_HARNESS_END();
+
+    // Inherited clients have been forgotten
+    ASSERT(protocolHelper.memContext == NULL);
+
+    ProtocolServer *const server = protocolServerNew(STRDEF("test"), PROTOCOL_SERVICE_LOCAL_STR, forkRead, forkWrite);
+    const ProtocolServerHandler commandHandler[] = {TEST_PROTOCOL_SERVER_HANDLER_LIST};
+    protocolServerProcess(server, NULL, commandHandler, LENGTH_OF(commandHandler));
+
+    FUNCTION_HARNESS_RETURN(INT, 0);
+}
+
 /***********************************************************************************************************************************
 Test Run
 ***********************************************************************************************************************************/
@@ -636,6 +658,13 @@ testRun(void)
 
                 TEST_RESULT_VOID(protocolClientNoOp(client), "noop");
 
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("stat command");
+
+                TEST_RESULT_VOID(protocolClientStat(client), "stat");
+                TEST_RESULT_BOOL(
+                    strstr(strZ(statToJsonP()), "\"protocol.latency.noop\":{\"count\":1,") != NULL, true, "noop latency");
+
                 // -----------------------------------------------------------------------------------------------------------------
                 TEST_TITLE("simple command");
 
@@ -937,6 +966,11 @@ testRun(void)
                 TEST_RESULT_VOID(protocolServerDataPut(server, pckWriteU32P(protocolPackNew(), 1)), "data end put");
                 TEST_RESULT_VOID(protocolServerDataEndPut(server), "data end put");
 
+                // Command with output while the parent waits for jobs
+                TEST_RESULT_UINT(protocolServerCommandGet(server).id, strIdFromZ("c-four"), "c-four command get");
+                TEST_RESULT_VOID(protocolServerDataPut(server, pckWriteU32P(protocolPackNew(), 4)), "data end put");
+                TEST_RESULT_VOID(protocolServerDataEndPut(server), "data end put");
+
                 // Wait for exit
                 TEST_RESULT_UINT(protocolServerCommandGet(server).id, PROTOCOL_COMMAND_EXIT, "noop command get");
             }
@@ -974,7 +1008,8 @@ testRun(void)
                 TestParallelJobCallback data = {.jobList = lstNewP(sizeof(ProtocolParallelJob *))};
                 ProtocolParallel *parallel = NULL;
                 TEST_ASSIGN(parallel, protocolParallelNew(2000, testParallelJobCallback, &data), "create parallel");
-                TEST_RESULT_STR_Z(protocolParallelToLog(parallel), "{state: pending, clientTotal: 0, jobTotal: 0}", "check log");
+                TEST_RESULT_STR_Z(
+                    protocolParallelToLog(parallel), "{state: pending, clientTotal: 0, clientActive: 0, jobTotal: 0}", "check log");
 
                 // Add client
                 ProtocolClient *client[HRN_FORK_CHILD_MAX];
@@ -1046,6 +1081,9 @@ testRun(void)
                     protocolParallelJobProcessId(job) >= 1 && protocolParallelJobProcessId(job) <= 2, true,
                     "check process id is valid");
                 TEST_RESULT_UINT(pckReadU32P(protocolParallelJobResult(job)), 2, "check result is 2");
+                TEST_RESULT_BOOL(protocolParallelJobTime(job) > 0, true, "check time is set");
+                TEST_RESULT_VOID(protocolParallelSample(parallel, 1024 * 1024, 1000), "sample ignored when not adapting");
+                TEST_RESULT_UINT(protocolParallelClientActive(parallel), 2, "all clients active");
 
                 TEST_RESULT_PTR(protocolParallelResult(parallel), NULL, "check no more results");
 
@@ -1100,6 +1138,85 @@ testRun(void)
 
                 TEST_RESULT_VOID(protocolParallelFree(parallel), "free parallel");
 
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("wait for jobs while results are not collected");
+
+                TEST_ASSIGN(parallel, protocolParallelNew(2000, testParallelJobCallback, &data), "create parallel");
+                TEST_RESULT_VOID(protocolParallelClientAdd(parallel, client[0]), "add client");
+                TEST_RESULT_VOID(protocolParallelWait(parallel), "wait");
+
+                job = protocolParallelJobNew(varNewStr(STRDEF("job4")), protocolCommandNew(strIdFromZ("c-four")));
+                TEST_RESULT_VOID(lstAdd(data.jobList, &job), "add job");
+
+                TEST_RESULT_INT(protocolParallelProcess(parallel), 0, "process jobs");
+                TEST_RESULT_INT(protocolParallelProcess(parallel), 1, "process jobs");
+                TEST_RESULT_BOOL(protocolParallelDone(parallel), false, "check not done");
+
+                TEST_ASSIGN(job, protocolParallelResult(parallel), "get result");
+                TEST_RESULT_UINT(pckReadU32P(protocolParallelJobResult(job)), 4, "check result is 4");
+                TEST_RESULT_BOOL(protocolParallelDone(parallel), false, "check not done while client waits");
+
+                TEST_RESULT_INT(protocolParallelProcess(parallel), 0, "process zero jobs");
+                TEST_RESULT_BOOL(protocolParallelDone(parallel), true, "check done");
+
+                TEST_RESULT_VOID(protocolParallelFree(parallel), "free parallel");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("adapt active clients to twice the lowest latency");
+
+                TEST_ASSIGN(parallel, protocolParallelNew(2000, testParallelJobCallback, &data), "create parallel");
+                TEST_RESULT_VOID(protocolParallelClientAdd(parallel, client[0]), "add client");
+                TEST_RESULT_VOID(protocolParallelClientAdd(parallel, client[1]), "add client");
+                TEST_RESULT_VOID(protocolParallelAdapt(parallel, 1, 0), "adapt");
+
+                TEST_RESULT_INT(protocolParallelProcess(parallel), 0, "process zero jobs");
+                TEST_RESULT_UINT(protocolParallelClientActive(parallel), 1, "start with min clients");
+
+                TEST_RESULT_VOID(protocolParallelSample(parallel, 1024, 1000000), "small sample ignored");
+                TEST_RESULT_UINT(protocolParallelClientActive(parallel), 1, "min clients");
+
+                TEST_RESULT_VOID(protocolParallelSample(parallel, 1024 * 1024, 10000), "sample under target");
+                TEST_RESULT_UINT(protocolParallelClientActive(parallel), 2, "client activated");
+
+                TEST_RESULT_VOID(protocolParallelSample(parallel, 1024 * 1024, 15000), "sample");
+                TEST_RESULT_UINT(protocolParallelClientActive(parallel), 2, "not enough samples to adjust");
+                TEST_RESULT_VOID(protocolParallelSample(parallel, 1024 * 1024, 35000), "sample over target");
+                TEST_RESULT_UINT(protocolParallelClientActive(parallel), 1, "client parked");
+
+                TEST_RESULT_VOID(protocolParallelSample(parallel, 1024 * 1024, 25000), "sample over target");
+                TEST_RESULT_UINT(protocolParallelClientActive(parallel), 1, "min clients");
+                TEST_RESULT_VOID(protocolParallelSample(parallel, 1024 * 1024, 17000), "sample near target");
+                TEST_RESULT_UINT(protocolParallelClientActive(parallel), 1, "no change");
+
+                TEST_RESULT_VOID(protocolParallelSample(parallel, 1024 * 1024, 1000), "lower latency");
+                TEST_RESULT_UINT(protocolParallelClientActive(parallel), 2, "client activated");
+                TEST_RESULT_VOID(protocolParallelSample(parallel, 1024 * 1024, 1000), "sample");
+                TEST_RESULT_VOID(protocolParallelSample(parallel, 1024 * 1024, 1000), "sample under target");
+                TEST_RESULT_UINT(protocolParallelClientActive(parallel), 2, "max clients");
+                TEST_RESULT_VOID(protocolParallelSample(parallel, 2 * 1024 * 1024, 100000), "sample");
+                TEST_RESULT_VOID(protocolParallelSample(parallel, 2 * 1024 * 1024, 100000), "sample over target");
+                TEST_RESULT_UINT(protocolParallelClientActive(parallel), 1, "client parked");
+
+                TEST_RESULT_BOOL(protocolParallelDone(parallel), true, "check done");
+                TEST_RESULT_VOID(protocolParallelFree(parallel), "free parallel");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("adapt active clients to latency target");
+
+                TEST_ASSIGN(parallel, protocolParallelNew(2000, testParallelJobCallback, &data), "create parallel");
+                TEST_RESULT_VOID(protocolParallelClientAdd(parallel, client[0]), "add client");
+                TEST_RESULT_VOID(protocolParallelClientAdd(parallel, client[1]), "add client");
+                TEST_RESULT_VOID(protocolParallelAdapt(parallel, 1, 10), "adapt");
+
+                TEST_RESULT_INT(protocolParallelProcess(parallel), 0, "process zero jobs");
+                TEST_RESULT_VOID(protocolParallelSample(parallel, 1024 * 1024, 12000), "sample over target");
+                TEST_RESULT_UINT(protocolParallelClientActive(parallel), 1, "min clients");
+                TEST_RESULT_VOID(protocolParallelSample(parallel, 1024 * 1024, 5000), "sample under target");
+                TEST_RESULT_UINT(protocolParallelClientActive(parallel), 2, "client activated");
+
+                TEST_RESULT_BOOL(protocolParallelDone(parallel), true, "check done");
+                TEST_RESULT_VOID(protocolParallelFree(parallel), "free parallel");
+
                 // -----------------------------------------------------------------------------------------------------------------
                 TEST_TITLE("free clients");
 
@@ -1129,6 +1246,11 @@ testRun(void)
 
         TEST_RESULT_VOID(protocolKeepAlive(), "keep alive");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("call stat collect before any remotes exist");
+
+        TEST_RESULT_VOID(protocolStatCollect(), "stat collect");
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("simple protocol start");
 
@@ -1148,6 +1270,7 @@ testRun(void)
         TEST_RESULT_PTR(protocolRemoteGet(protocolStorageTypeRepo, 0), client, "get remote cached protocol");
         TEST_RESULT_PTR(protocolHelper.clientRemote[0].client, client, "check position in cache");
         TEST_RESULT_VOID(protocolKeepAlive(), "keep alive");
+        TEST_RESULT_VOID(protocolStatCollect(), "stat collect");
         TEST_RESULT_VOID(protocolFree(), "free remote protocol objects");
         TEST_RESULT_VOID(protocolFree(), "free remote protocol objects again");
 
@@ -1244,8 +1367,28 @@ testRun(void)
         TEST_ASSIGN(client, protocolLocalGet(protocolStorageTypeRepo, 0, 1), "get local protocol");
         TEST_RESULT_PTR(protocolLocalGet(protocolStorageTypeRepo, 0, 1), client, "get local cached protocol");
         TEST_RESULT_PTR(protocolHelper.clientLocal[0].client, client, "check location in cache");
+        TEST_RESULT_VOID(protocolStatCollect(), "stat collect");
 
         TEST_RESULT_VOID(protocolFree(), "free local and remote protocol objects");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("start local protocol in forked process");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "db");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, "/path/to/pg");
+        hrnCfgArgRawZ(argList, cfgOptProtocolTimeout, "10");
+        hrnCfgArgRawZ(argList, cfgOptProcessMax, "2");
+        hrnCfgArgRawBool(argList, cfgOptProcessFork, true);
+        HRN_CFG_LOAD(cfgCmdArchiveGet, argList);
+
+        TEST_RESULT_VOID(protocolLocalForkInit(testLocalFork), "set fork function");
+
+        TEST_ASSIGN(client, protocolLocalGet(protocolStorageTypeRepo, 0, 1), "get local protocol");
+        TEST_ASSIGN(client, protocolLocalGet(protocolStorageTypeRepo, 0, 2), "get local protocol when another exists");
+        TEST_RESULT_PTR(protocolHelper.clientLocal[1].client, client, "check location in cache");
+
+        TEST_RESULT_VOID(protocolFree(), "free local protocol objects");
     }
 
     FUNCTION_HARNESS_RETURN_VOID();
@@ -32,6 +32,7 @@ typedef struct TestRequestParam
     VAR_PARAM_HEADER;
     const char *content;
     const char *blobType;
+    const char *copySource;
     const char *range;
 } TestRequestParam;
 
@@ -94,6 +95,10 @@ testRequest(IoWrite *write, const char *verb, const char *path, TestRequestParam
     if (param.blobType != NULL)
         strCatFmt(request, "x-ms-blob-type:%s\r\n", param.blobType);
 
+    // Add copy source
+    if (param.copySource != NULL)
+        strCatFmt(request, "x-ms-copy-source:%s\r\n", param.copySource);
+
     // Add version
     if (driver->sharedKey != NULL)
         strCatZ(request, "x-ms-version:2019-02-02\r\n");
@@ -653,6 +658,48 @@ testRun(void)
                 TEST_ASSIGN(write, storageNewWriteP(storage, STRDEF("file.txt")), "new write");
                 TEST_RESULT_VOID(storagePutP(write, BUFSTRDEF("12345678901234567890")), "write");
 
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("checkpoint block upload");
+
+                Pack *checkpoint = NULL;
+
+                TEST_ASSIGN(write, storageNewWriteP(storage, STRDEF("file.txt")), "new write");
+                TEST_RESULT_VOID(ioWriteOpen(storageWriteIo(write)), "open");
+                TEST_RESULT_PTR(storageWriteCheckpoint(write), NULL, "no checkpoint before a block is uploaded");
+
+                testRequestP(
+                    service, HTTP_VERB_PUT, "/file.txt?blockid=0AAAAAAACCCCCCCEx0000000&comp=block", .content = "1234567890");
+                testResponseP(service);
+
+                TEST_RESULT_VOID(ioWrite(storageWriteIo(write), BUFSTRDEF("1234567890")), "write partial block");
+                TEST_ASSIGN(checkpoint, storageWriteCheckpoint(write), "checkpoint");
+
+                PackRead *checkpointRead = pckReadNew(checkpoint);
+                TEST_RESULT_UINT(pckReadU64P(checkpointRead), 0x0AAAAAAACCCCCCCE, "check file id");
+                TEST_RESULT_STRLST_Z(pckReadStrLstP(checkpointRead), "0AAAAAAACCCCCCCEx0000000\n", "check block list");
+                TEST_RESULT_UINT(pckReadU64P(checkpointRead), 10, "check size");
+                TEST_RESULT_VOID(storageWriteFree(write), "free without close");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("resume block upload from checkpoint");
+
+                testRequestP(
+                    service, HTTP_VERB_PUT, "/file.txt?blockid=0AAAAAAACCCCCCCEx0000001&comp=block", .content = "1234567890");
+                testResponseP(service);
+
+                testRequestP(
+                    service, HTTP_VERB_PUT, "/file.txt?comp=blocklist",
+                    .content =
+                        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                        "<BlockList>"
+                        "<Uncommitted>0AAAAAAACCCCCCCEx0000000</Uncommitted>"
+                        "<Uncommitted>0AAAAAAACCCCCCCEx0000001</Uncommitted>"
+                        "</BlockList>\n");
+                testResponseP(service);
+
+                TEST_ASSIGN(write, storageNewWriteP(storage, STRDEF("file.txt"), .resume = checkpoint), "new write");
+                TEST_RESULT_VOID(storagePutP(write, BUFSTRDEF("12345678901234567890")), "write");
+
                 // -----------------------------------------------------------------------------------------------------------------
                 TEST_TITLE("info for / does not exist");
 
@@ -693,6 +740,26 @@ testRun(void)
                 TEST_RESULT_UINT(info.size, 0, "check exists");
                 TEST_RESULT_INT(info.timeModified, 0, "check time");
 
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("info with checksum");
+
+                testRequestP(service, HTTP_VERB_HEAD, "/subdir/file1.txt");
+                testResponseP(
+                    service,
+                    .header =
+                        "content-length:9999\r\nLast-Modified: Wed, 21 Oct 2015 07:28:00 GMT\r\n"
+                        "Content-MD5: nworHD1OX2BxgpOktcbX6A==");
+
+                TEST_ASSIGN(info, storageInfoP(storage, STRDEF("subdir/file1.txt"), .checksum = true), "file exists");
+                TEST_RESULT_STR_Z(info.checksum, "9f0a2b1c3d4e5f60718293a4b5c6d7e8", "check checksum");
+
+                testRequestP(service, HTTP_VERB_HEAD, "/subdir/file2.txt");
+                testResponseP(service, .header = "content-length:777\r\nLast-Modified: Wed, 22 Oct 2015 07:28:00 GMT");
+
+                TEST_RESULT_STR(
+                    storageInfoP(storage, STRDEF("subdir/file2.txt"), .checksum = true).checksum, NULL,
+                    "no checksum for block list upload");
+
                 // -----------------------------------------------------------------------------------------------------------------
                 TEST_TITLE("list basic level");
 
@@ -754,6 +821,48 @@ testRun(void)
                     "test1.txt\n",
                     .noRecurse = true);
 
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("list path and subpath");
+
+                testRequestP(service, HTTP_VERB_GET, "?comp=list&delimiter=%2F&prefix=path%2F&restype=container");
+                testResponseP(
+                    service,
+                    .content =
+                        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+                        "<EnumerationResults>"
+                        "    <Blobs>"
+                        "        <Blob>"
+                        "            <Name>path/test1.txt</Name>"
+                        "            <Properties/>"
+                        "        </Blob>"
+                        "        <BlobPrefix>"
+                        "            <Name>path/to/</Name>"
+                        "        </BlobPrefix>"
+                        "    </Blobs>"
+                        "    <NextMarker/>"
+                        "</EnumerationResults>");
+
+                testRequestP(service, HTTP_VERB_GET, "?comp=list&delimiter=%2F&prefix=path%2Fto%2F&restype=container");
+                testResponseP(
+                    service,
+                    .content =
+                        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+                        "<EnumerationResults>"
+                        "    <Blobs>"
+                        "        <Blob>"
+                        "            <Name>path/to/test2.txt</Name>"
+                        "            <Properties/>"
+                        "        </Blob>"
+                        "    </Blobs>"
+                        "    <NextMarker/>"
+                        "</EnumerationResults>");
+
+                TEST_STORAGE_LIST(
+                    storage, "/path",
+                    "test1.txt\n"
+                    "to/\n"
+                    "to/test2.txt\n");
+
                 // -----------------------------------------------------------------------------------------------------------------
                 TEST_TITLE("list a file in root with expression");
 
@@ -869,6 +978,45 @@ testRun(void)
                     "test3.txt\n",
                     .level = storageInfoLevelExists, .noRecurse = true, .expression = "^test(1|3)");
 
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("copy file on server and wait for pending copy");
+
+                Storage *storageSource = storageAzureNew(
+                    STRDEF("/source"), false, NULL, STRDEF("container2"), TEST_ACCOUNT_STR, storageAzureKeyTypeShared,
+                    TEST_KEY_SHARED_STR, 16, hrnServerHost(), storageAzureUriStylePath, hrnServerPort(0), 5000, true, NULL, NULL);
+                const String *const copySource = strNewFmt(
+                    "https://%s:%u/" TEST_ACCOUNT "/container2/source/file.txt", strZ(hrnServerHost()), hrnServerPort(0));
+
+                testRequestP(service, HTTP_VERB_PUT, "/path/to/copy.txt", .copySource = strZ(copySource));
+                testResponseP(service, .code = 202, .header = "x-ms-copy-status:pending");
+
+                testRequestP(service, HTTP_VERB_HEAD, "/path/to/copy.txt");
+                testResponseP(service, .header = "x-ms-copy-status:success");
+
+                TEST_RESULT_BOOL(
+                    storageCopyServerP(storageSource, STRDEF("file.txt"), storage, STRDEF("/path/to/copy.txt")), true, "copy");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("copy file on server fails");
+
+                testRequestP(service, HTTP_VERB_PUT, "/path/to/copy.txt", .copySource = strZ(copySource));
+                testResponseP(service, .code = 202, .header = "x-ms-copy-status:failed");
+
+                TEST_ERROR(
+                    storageCopyServerP(storageSource, STRDEF("file.txt"), storage, STRDEF("/path/to/copy.txt")), FileWriteError,
+                    "unable to copy '/source/file.txt' to '/path/to/copy.txt': copy status is 'failed'");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("no copy on server when account differs");
+
+                storageSource = storageAzureNew(
+                    STRDEF("/source"), false, NULL, STRDEF("container2"), STRDEF("account2"), storageAzureKeyTypeShared,
+                    TEST_KEY_SHARED_STR, 16, hrnServerHost(), storageAzureUriStylePath, hrnServerPort(0), 5000, true, NULL, NULL);
+
+                TEST_RESULT_BOOL(
+                    storageCopyServerP(storageSource, STRDEF("file.txt"), storage, STRDEF("/path/to/copy.txt")), false,
+                    "account differs");
+
                 // -----------------------------------------------------------------------------------------------------------------
                 TEST_TITLE("switch to SAS auth");
 
@@ -920,6 +1068,9 @@ testRun(void)
                 // -----------------------------------------------------------------------------------------------------------------
                 TEST_TITLE("remove files from root");
 
+                // Allow only one delete request at a time since the test server handles one session at a time
+                driver->deleteAsyncMax = 1;
+
                 testRequestP(service, HTTP_VERB_GET, "?comp=list&restype=container");
                 testResponseP(
                     service,
@@ -999,6 +1150,41 @@ testRun(void)
 
                 TEST_RESULT_VOID(storagePathRemoveP(storage, STRDEF("/path"), .recurse = true), "remove");
 
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("remove files with concurrent delete requests");
+
+                driver->deleteAsyncMax = 2;
+
+                testRequestP(service, HTTP_VERB_GET, "?comp=list&prefix=path%2F&restype=container");
+                testResponseP(
+                    service,
+                    .content =
+                        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+                        "<EnumerationResults>"
+                        "    <Blobs>"
+                        "        <Blob>"
+                        "            <Name>path/test1.txt</Name>"
+                        "            <Properties/>"
+                        "        </Blob>"
+                        "        <Blob>"
+                        "            <Name>path/test2.txt</Name>"
+                        "            <Properties/>"
+                        "        </Blob>"
+                        "    </Blobs>"
+                        "    <NextMarker/>"
+                        "</EnumerationResults>");
+
+                testRequestP(service, HTTP_VERB_DELETE, "/path/test1.txt");
+                testResponseP(service);
+
+                // The second request is sent on a new session before the response to the first request is read
+                hrnServerScriptAccept(service);
+
+                testRequestP(service, HTTP_VERB_DELETE, "/path/test2.txt");
+                testResponseP(service);
+
+                TEST_RESULT_VOID(storagePathRemoveP(storage, STRDEF("/path"), .recurse = true), "remove");
+
                 // -----------------------------------------------------------------------------------------------------------------
                 hrnServerScriptEnd(service);
             }
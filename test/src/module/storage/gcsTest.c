@@ -70,7 +70,9 @@ typedef struct TestRequestParam
     bool noBucket;
     bool upload;
     bool noAuth;
+    const char *bucket;
     const char *object;
+    const char *rewriteTo;
     const char *query;
     const char *contentRange;
     const char *content;
@@ -83,13 +85,20 @@ typedef struct TestRequestParam
 static void
 testRequest(IoWrite *write, const char *verb, TestRequestParam param)
 {
-    String *request = strCatFmt(
-        strNew(), "%s %s/storage/v1/b%s", verb, param.upload ? "/upload" : "", param.noBucket ? "" : "/bucket/o");
+    String *request = strCatFmt(strNew(), "%s %s/storage/v1/b", verb, param.upload ? "/upload" : "");
+
+    // Add bucket
+    if (!param.noBucket)
+        strCatFmt(request, "/%s/o", param.bucket == NULL ? TEST_BUCKET : param.bucket);
 
     // Add object
     if (param.object != NULL)
         strCatFmt(request, "/%s", strZ(httpUriEncode(STR(param.object), false)));
 
+    // Add rewrite destination
+    if (param.rewriteTo != NULL)
+        strCatFmt(request, "/rewriteTo/b/" TEST_BUCKET "/o/%s", strZ(httpUriEncode(STR(param.rewriteTo), false)));
+
     // Add query
     if (param.query != NULL)
         strCatFmt(request, "?%s", param.query);
@@ -625,6 +634,101 @@ testRun(void)
                 TEST_ASSIGN(write, storageNewWriteP(storage, STRDEF("file.txt")), "new write");
                 TEST_RESULT_VOID(storagePutP(write, BUFSTRDEF("12345678901234567890")), "write");
 
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("checkpoint resumable upload");
+
+                Pack *checkpoint = NULL;
+
+                TEST_ASSIGN(write, storageNewWriteP(storage, STRDEF("file.txt")), "new write");
+                TEST_RESULT_VOID(ioWriteOpen(storageWriteIo(write)), "open");
+                TEST_RESULT_PTR(storageWriteCheckpoint(write), NULL, "no checkpoint before upload is started");
+
+                testRequestP(service, HTTP_VERB_POST, .upload = true, .query = "name=file.txt&uploadType=resumable");
+                testResponseP(service, .header = "x-guploader-uploadid:ulcp");
+
+                testRequestP(
+                    service, HTTP_VERB_PUT, .upload = true, .noAuth = true,
+                    .query = "name=file.txt&uploadType=resumable&upload_id=ulcp", .contentRange = "0-15/*",
+                    .content = "1234567890123456");
+                testResponseP(service, .code = 308);
+
+                TEST_RESULT_VOID(ioWrite(storageWriteIo(write), BUFSTRDEF("1234567890123456")), "write chunk");
+                TEST_ASSIGN(checkpoint, storageWriteCheckpoint(write), "checkpoint");
+
+                PackRead *checkpointRead = pckReadNew(checkpoint);
+                TEST_RESULT_STR_Z(pckReadStrP(checkpointRead), "ulcp", "check upload id");
+                TEST_RESULT_UINT(pckReadU64P(checkpointRead), 16, "check size");
+
+                TEST_RESULT_VOID(ioWrite(storageWriteIo(write), BUFSTRDEF("7890")), "write unaligned data");
+                TEST_RESULT_PTR(storageWriteCheckpoint(write), NULL, "no checkpoint");
+                TEST_RESULT_VOID(storageWriteFree(write), "free without close");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("resume resumable upload from checkpoint");
+
+                testRequestP(
+                    service, HTTP_VERB_PUT, .upload = true, .noAuth = true,
+                    .query = "fields=md5Hash%2Csize&name=file.txt&uploadType=resumable&upload_id=ulcp", .contentRange = "16-19/20",
+                    .content = "7890");
+                testResponseP(service, .content = "{\"md5Hash\":\"/YXmLZvrRUKHcexohBiycQ==\",\"size\":\"20\"}");
+
+                TEST_ASSIGN(write, storageNewWriteP(storage, STRDEF("file.txt"), .resume = checkpoint), "new write");
+                TEST_RESULT_VOID(storagePutP(write, BUFSTRDEF("12345678901234567890")), "write");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("resume resumable upload with all data uploaded before the checkpoint");
+
+                testRequestP(
+                    service, HTTP_VERB_PUT, .upload = true, .noAuth = true,
+                    .query = "fields=md5Hash%2Csize&name=file.txt&uploadType=resumable&upload_id=ulcp", .contentRange = "*/16");
+                testResponseP(service, .content = "{\"md5Hash\":\"q+rAfTwowb755zAALHU+1A==\",\"size\":\"16\"}");
+
+                TEST_ASSIGN(write, storageNewWriteP(storage, STRDEF("file.txt"), .resume = checkpoint), "new write");
+                TEST_RESULT_VOID(storagePutP(write, BUFSTRDEF("1234567890123456")), "write");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("abort resumable upload");
+
+                testRequestP(
+                    service, HTTP_VERB_DELETE, .upload = true, .noAuth = true,
+                    .query = "name=file.txt&uploadType=resumable&upload_id=ulcp");
+                testResponseP(service, .code = 499);
+
+                TEST_ASSIGN(write, storageNewWriteP(storage, STRDEF("file.txt"), .resume = checkpoint), "new write");
+                TEST_RESULT_VOID(ioWriteOpen(storageWriteIo(write)), "open");
+                TEST_RESULT_VOID(storageWriteAbort(write), "abort");
+                TEST_RESULT_VOID(storageWriteFree(write), "free");
+
+                testRequestP(
+                    service, HTTP_VERB_DELETE, .upload = true, .noAuth = true,
+                    .query = "name=file.txt&uploadType=resumable&upload_id=ulcp");
+                testResponseP(service, .code = 404);
+
+                TEST_ASSIGN(write, storageNewWriteP(storage, STRDEF("file.txt"), .resume = checkpoint), "new write");
+                TEST_RESULT_VOID(ioWriteOpen(storageWriteIo(write)), "open");
+                TEST_RESULT_VOID(storageWriteAbort(write), "abort missing upload");
+
+                testRequestP(
+                    service, HTTP_VERB_DELETE, .upload = true, .noAuth = true,
+                    .query = "name=file.txt&uploadType=resumable&upload_id=ulcp");
+                testResponseP(service, .code = 403);
+
+                TEST_ASSIGN(write, storageNewWriteP(storage, STRDEF("file.txt"), .resume = checkpoint), "new write");
+                TEST_RESULT_VOID(ioWriteOpen(storageWriteIo(write)), "open");
+                TEST_ERROR_FMT(
+                    storageWriteAbort(write), ProtocolError,
+                    "HTTP request failed with 403 (Forbidden):\n"
+                    "*** Path/Query ***:\n"
+                    "DELETE /upload/storage/v1/b/bucket/o?name=file.txt&uploadType=resumable&upload_id=<redacted>\n"
+                    "*** Request Headers ***:\n"
+                    "content-length: 0\n"
+                    "host: %s",
+                    strZ(hrnServerHost()));
+
+                TEST_ASSIGN(write, storageNewWriteP(storage, STRDEF("file.txt")), "new write");
+                TEST_RESULT_VOID(ioWriteOpen(storageWriteIo(write)), "open");
+                TEST_RESULT_VOID(storageWriteAbort(write), "abort before upload is started");
+
                 // -----------------------------------------------------------------------------------------------------------------
                 TEST_TITLE("error on resumable upload (upload_id is redacted)");
 
@@ -690,6 +794,27 @@ testRun(void)
                 TEST_RESULT_UINT(info.size, 0, "check exists");
                 TEST_RESULT_INT(info.timeModified, 0, "check time");
 
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("info with checksum");
+
+                testRequestP(
+                    service, HTTP_VERB_GET, .object = "subdir/file1.txt", .query = "fields=size%2Cupdated%2Cmd5Hash");
+                testResponseP(
+                    service,
+                    .content =
+                        "{\"md5Hash\":\"nworHD1OX2BxgpOktcbX6A==\",\"size\":\"9999\",\"updated\":\"2015-10-21T07:28:00.000Z\"}");
+
+                TEST_ASSIGN(info, storageInfoP(storage, STRDEF("subdir/file1.txt"), .checksum = true), "file exists");
+                TEST_RESULT_UINT(info.size, 9999, "check size");
+                TEST_RESULT_STR_Z(info.checksum, "9f0a2b1c3d4e5f60718293a4b5c6d7e8", "check checksum");
+
+                testRequestP(service, HTTP_VERB_GET, .object = "subdir/file2.txt", .query = "fields=md5Hash");
+                testResponseP(service, .content = "{}");
+
+                TEST_RESULT_STR(
+                    storageInfoP(storage, STRDEF("subdir/file2.txt"), .level = storageInfoLevelExists, .checksum = true).checksum,
+                    NULL, "no checksum for composite object");
+
                 // -----------------------------------------------------------------------------------------------------------------
                 TEST_TITLE("list basic level");
 
@@ -747,6 +872,46 @@ testRun(void)
                     "test1.txt\n",
                     .noRecurse = true);
 
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("list path and subpath");
+
+                testRequestP(
+                    service, HTTP_VERB_GET,
+                    .query = "delimiter=%2F&fields=nextPageToken%2Cprefixes%2Citems%28name%29&prefix=path%2F");
+                testResponseP(
+                    service,
+                    .content =
+                        "{"
+                        "  \"prefixes\": ["
+                        "     \"path/to/\""
+                        "  ],"
+                        "  \"items\": ["
+                        "    {"
+                        "      \"name\": \"path/test1.txt\""
+                        "    }"
+                        "  ]"
+                        "}");
+
+                testRequestP(
+                    service, HTTP_VERB_GET,
+                    .query = "delimiter=%2F&fields=nextPageToken%2Cprefixes%2Citems%28name%29&prefix=path%2Fto%2F");
+                testResponseP(
+                    service,
+                    .content =
+                        "{"
+                        "  \"items\": ["
+                        "    {"
+                        "      \"name\": \"path/to/test2.txt\""
+                        "    }"
+                        "  ]"
+                        "}");
+
+                TEST_STORAGE_LIST(
+                    storage, "/path",
+                    "test1.txt\n"
+                    "to/\n"
+                    "to/test2.txt\n");
+
                 // -----------------------------------------------------------------------------------------------------------------
                 TEST_TITLE("list a file in root with expression");
 
@@ -818,6 +983,78 @@ testRun(void)
                     "test3.txt\n",
                     .noRecurse = true);
 
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("list large path in concurrent ranges");
+
+                String *const rangeContent = strCatZ(
+                    strNew(), "{\"nextPageToken\": \"page2\", \"prefixes\": [\"path/to/y/\"], \"items\": [");
+                String *const rangeList = strNew();
+
+                for (unsigned int fileIdx = 0; fileIdx < 99; fileIdx++)
+                {
+                    strCatFmt(rangeContent, "%s{\"name\": \"path/to/a%02u\"}", fileIdx == 0 ? "" : ",", fileIdx);
+                    strCatFmt(rangeList, "a%02u\n", fileIdx);
+                }
+
+                strCatZ(rangeContent, "]}");
+
+                testRequestP(
+                    service, HTTP_VERB_GET,
+                    .query = "delimiter=%2F&fields=nextPageToken%2Cprefixes%2Citems%28name%29&prefix=path%2Fto%2F");
+                testResponseP(service, .content = strZ(rangeContent));
+
+                // The first page is full so the names after y/ are split at z. The request for the range after z is sent on the
+                // existing connection and remains in flight while the next page of the first range is requested on a new
+                // connection. GCS includes the start offset in the range so z is skipped.
+                testRequestP(
+                    service, HTTP_VERB_GET,
+                    .query =
+                        "delimiter=%2F&fields=nextPageToken%2Cprefixes%2Citems%28name%29&prefix=path%2Fto%2F"
+                        "&startOffset=path%2Fto%2Fz");
+                testResponseP(
+                    service, .header = "connection:close",
+                    .content =
+                        "{"
+                        "  \"prefixes\": ["
+                        "     \"path/to/zz/\""
+                        "  ],"
+                        "  \"items\": ["
+                        "    {"
+                        "      \"name\": \"path/to/z\""
+                        "    },"
+                        "    {"
+                        "      \"name\": \"path/to/z0\""
+                        "    }"
+                        "  ]"
+                        "}");
+                hrnServerScriptClose(service);
+
+                hrnServerScriptAccept(service);
+                testRequestP(
+                    service, HTTP_VERB_GET,
+                    .query = "delimiter=%2F&fields=nextPageToken%2Cprefixes%2Citems%28name%29&pageToken=page2&prefix=path%2Fto%2F");
+                testResponseP(
+                    service,
+                    .content =
+                        "{"
+                        "  \"nextPageToken\": \"page3\","
+                        "  \"items\": ["
+                        "    {"
+                        "      \"name\": \"path/to/y0\""
+                        "    },"
+                        "    {"
+                        "      \"name\": \"path/to/z\""
+                        "    },"
+                        "    {"
+                        "      \"name\": \"path/to/z0\""
+                        "    }"
+                        "  ]"
+                        "}");
+
+                strCatZ(rangeList, "y/\ny0\nz\nz0\nzz/\n");
+
+                TEST_STORAGE_LIST(storage, "/path/to", strZ(rangeList), .noRecurse = true);
+
                 // -----------------------------------------------------------------------------------------------------------------
                 TEST_TITLE("list files with expression");
 
@@ -881,9 +1118,44 @@ testRun(void)
 
                 TEST_RESULT_VOID(storageRemoveP(storage, STRDEF("/path/to/missing.txt")), "remove");
 
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("copy file on server in multiple steps");
+
+                const String *const endpoint = strNewFmt("%s:%u", strZ(hrnServerHost()), testPort);
+                Storage *storageSource = storageGcsNew(
+                    STRDEF("/source"), false, NULL, STRDEF("bucket2"), storageGcsKeyTypeToken, TEST_TOKEN_STR, 16, endpoint,
+                    TEST_TIMEOUT, true, NULL, NULL);
+
+                testRequestP(
+                    service, HTTP_VERB_POST, .bucket = "bucket2", .object = "source/file.txt", .rewriteTo = "path/to/copy.txt",
+                    .query = "fields=done%2CrewriteToken");
+                testResponseP(service, .content = "{\"done\":false,\"rewriteToken\":\"token1\"}");
+
+                testRequestP(
+                    service, HTTP_VERB_POST, .bucket = "bucket2", .object = "source/file.txt", .rewriteTo = "path/to/copy.txt",
+                    .query = "fields=done%2CrewriteToken&rewriteToken=token1");
+                testResponseP(service, .content = "{\"done\":true}");
+
+                TEST_RESULT_BOOL(
+                    storageCopyServerP(storageSource, STRDEF("file.txt"), storage, STRDEF("/path/to/copy.txt")), true, "copy");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("no copy on server when credentials differ");
+
+                storageSource = storageGcsNew(
+                    STRDEF("/source"), false, NULL, STRDEF("bucket2"), storageGcsKeyTypeToken, STRDEF("Y Y"), 16, endpoint,
+                    TEST_TIMEOUT, true, NULL, NULL);
+
+                TEST_RESULT_BOOL(
+                    storageCopyServerP(storageSource, STRDEF("file.txt"), storage, STRDEF("/path/to/copy.txt")), false,
+                    "token differs");
+
                 // -----------------------------------------------------------------------------------------------------------------
                 TEST_TITLE("remove files from root");
 
+                // Allow only one delete request at a time since the test server handles one session at a time
+                ((StorageGcs *)storageDriver(storage))->deleteAsyncMax = 1;
+
                 testRequestP(service, HTTP_VERB_GET, .query = "fields=nextPageToken%2Cprefixes%2Citems%28name%29");
                 testResponseP(
                     service,
@@ -947,6 +1219,37 @@ testRun(void)
 
                 TEST_RESULT_VOID(storagePathRemoveP(storage, STRDEF("/path"), .recurse = true), "remove");
 
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("remove files with concurrent delete requests");
+
+                ((StorageGcs *)storageDriver(storage))->deleteAsyncMax = 2;
+
+                testRequestP(service, HTTP_VERB_GET, .query = "fields=nextPageToken%2Cprefixes%2Citems%28name%29&prefix=path%2F");
+                testResponseP(
+                    service,
+                    .content =
+                        "{"
+                        "  \"items\": ["
+                        "    {"
+                        "      \"name\": \"path/test1.txt\""
+                        "    },"
+                        "    {"
+                        "      \"name\": \"path/test2.txt\""
+                        "    }"
+                        "  ]"
+                        "}");
+
+                testRequestP(service, HTTP_VERB_DELETE, .object = "path/test1.txt");
+                testResponseP(service);
+
+                // The second request is sent on a new session before the response to the first request is read
+                hrnServerScriptAccept(service);
+
+                testRequestP(service, HTTP_VERB_DELETE, .object = "path/test2.txt");
+                testResponseP(service);
+
+                TEST_RESULT_VOID(storagePathRemoveP(storage, STRDEF("/path"), .recurse = true), "remove");
+
                 // -----------------------------------------------------------------------------------------------------------------
                 hrnServerScriptEnd(service);
             }
@@ -26,6 +26,43 @@ storageTestPathExpression(const String *expression, const String *path)
     return result;
 }
 
+/***********************************************************************************************************************************
+Test function to list multiple paths, which the Posix driver does not implement
+***********************************************************************************************************************************/
+static unsigned int storageTestListMultiTotal = 0;
+
+static List *
+storageTestListMulti(
+    void *const thisVoid, const StringList *const pathList, const StorageInfoLevel level, const StorageInterfaceListParam param)
+{
+    List *const result = lstNewP(sizeof(StorageList *));
+
+    for (unsigned int pathIdx = 0; pathIdx < strLstSize(pathList); pathIdx++)
+    {
+        StorageList *const list = storageInterfaceListP(thisVoid, strLstGet(pathList, pathIdx), level, .expression = param.expression);
+        lstAdd(result, &list);
+    }
+
+    storageTestListMultiTotal++;
+
+    return result;
+}
+
+/***********************************************************************************************************************************
+Test function to copy a file on the server, which the Posix driver does not implement
+***********************************************************************************************************************************/
+static bool
+storageTestCopy(
+    void *const thisVoid, const void *const sourceDriver, const String *const source, const String *const destination,
+    const StorageInterfaceCopyParam param)
+{
+    (void)thisVoid;
+    (void)sourceDriver;
+    (void)param;
+
+    return strEqZ(source, TEST_PATH "/source.txt") && strEqZ(destination, TEST_PATH "/destination.txt");
+}
+
 /***********************************************************************************************************************************
 Macro to create a path and file that cannot be accessed
 ***********************************************************************************************************************************/
@@ -369,12 +406,16 @@ testRun(void)
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("helper function - storagePosixListEntry()");
 
+        const int pathFd = open(TEST_PATH, O_RDONLY);
+        StoragePosixListOwner owner = {.memContext = memContextCurrent()};
+
         TEST_RESULT_VOID(
             storagePosixListEntry(
-                (StoragePosix *)storageDriver(storageTest), storageLstNew(storageInfoLevelBasic), STRDEF("pg"), "missing",
-                storageInfoLevelBasic),
+                storageLstNew(storageInfoLevelBasic), STRDEF(TEST_PATH), pathFd, "missing", storageInfoLevelBasic, &owner),
             "missing path");
 
+        close(pathFd);
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("path with only dot");
 
@@ -495,6 +536,73 @@ testRun(void)
             storageTest, "pg",
             "path/file {s=8, t=1656434296}\n",
             .level = storageInfoLevelBasic, .expression = "\\/file$");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("list multiple paths at once");
+
+        ((StoragePosix *)storageDriver(storageTest))->interface.listMulti = storageTestListMulti;
+
+        HRN_STORAGE_PUT_EMPTY(storageTest, "multi/a/file");
+        HRN_STORAGE_PUT_EMPTY(storageTest, "multi/b/sub/file");
+        HRN_STORAGE_PATH_CREATE(storageTest, "multi/b/sub2");
+        HRN_STORAGE_PATH_CREATE(storageTest, "multi/c");
+        HRN_STORAGE_PUT_EMPTY(storageTest, "multi/d");
+
+        TEST_STORAGE_LIST(
+            storageTest, "multi",
+            "a/\n"
+            "a/file\n"
+            "b/\n"
+            "b/sub/\n"
+            "b/sub/file\n"
+            "b/sub2/\n"
+            "c/\n"
+            "d\n",
+            .level = storageInfoLevelType);
+        TEST_RESULT_UINT(storageTestListMultiTotal, 2, "a, b, and c listed together, then b/sub and b/sub2");
+
+        TEST_STORAGE_LIST(
+            storageTest, "multi",
+            "b/sub/file\n",
+            .level = storageInfoLevelType, .expression = "\\/sub\\/");
+        TEST_RESULT_UINT(storageTestListMultiTotal, 4, "list with expression");
+
+        HRN_SYSTEM("mkdir -p " TEST_PATH "/multi-max/p1 " TEST_PATH "/multi-max/p2 " TEST_PATH "/multi-max/p3 " TEST_PATH
+            "/multi-max/p4 " TEST_PATH "/multi-max/p5 " TEST_PATH "/multi-max/p6 " TEST_PATH "/multi-max/p7 " TEST_PATH
+            "/multi-max/p8 " TEST_PATH "/multi-max/p9");
+
+        TEST_STORAGE_LIST(
+            storageTest, "multi-max",
+            "p1/\np2/\np3/\np4/\np5/\np6/\np7/\np8/\np9/\n",
+            .level = storageInfoLevelType);
+        TEST_RESULT_UINT(storageTestListMultiTotal, 6, "p1-p8 listed together, then p9");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("path removed after it was listed with other paths");
+
+        TEST_ASSIGN(storageItr, storageNewItrP(storageTest, STRDEF("multi"), .recurse = true, .sortOrder = sortOrderAsc), "new");
+
+        HRN_STORAGE_PATH_REMOVE(storageTest, "multi/c", .errorOnMissing = true);
+
+        TEST_RESULT_BOOL(storageItrMore(storageItr), true, "more");
+        TEST_RESULT_STR_Z(storageItrNext(storageItr).name, "a", "a listed with b and c");
+        TEST_RESULT_BOOL(storageItrMore(storageItr), true, "more");
+        TEST_RESULT_STR_Z(storageItrNext(storageItr).name, "a/file", "next");
+        TEST_RESULT_BOOL(storageItrMore(storageItr), true, "more");
+        TEST_RESULT_STR_Z(storageItrNext(storageItr).name, "b", "next");
+        TEST_RESULT_BOOL(storageItrMore(storageItr), true, "more");
+        TEST_RESULT_STR_Z(storageItrNext(storageItr).name, "b/sub", "next");
+        TEST_RESULT_BOOL(storageItrMore(storageItr), true, "more");
+        TEST_RESULT_STR_Z(storageItrNext(storageItr).name, "b/sub/file", "next");
+        TEST_RESULT_BOOL(storageItrMore(storageItr), true, "more");
+        TEST_RESULT_STR_Z(storageItrNext(storageItr).name, "b/sub2", "next");
+        TEST_RESULT_BOOL(storageItrMore(storageItr), true, "more");
+        TEST_RESULT_STR_Z(storageItrNext(storageItr).name, "c", "c still returned since it was in the list");
+        TEST_RESULT_BOOL(storageItrMore(storageItr), true, "more");
+        TEST_RESULT_STR_Z(storageItrNext(storageItr).name, "d", "next");
+        TEST_RESULT_BOOL(storageItrMore(storageItr), false, "no more");
+
+        ((StoragePosix *)storageDriver(storageTest))->interface.listMulti = NULL;
     }
 
     // *****************************************************************************************************************************
@@ -576,6 +684,33 @@ testRun(void)
         TEST_RESULT_BOOL(storageCopyP(source, destination), true, "copy file");
         TEST_RESULT_BOOL(bufEq(expectedBuffer, storageGetP(storageNewReadP(storageTest, destinationFile))), true, "check file");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("copy on server - not supported by driver");
+
+        TEST_RESULT_BOOL(storageCopyServerP(storageTest, sourceFile, storageTest, destinationFile), false, "no server copy");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("copy on server - storage types differ");
+
+        storageTest->pub.interface.copy = storageTestCopy;
+        ((StoragePosix *)storageDriver(storageTest))->interface.copy = storageTestCopy;
+
+        TEST_RESULT_BOOL(
+            storageCopyServerP(
+                storageCifsNew(TEST_PATH_STR, STORAGE_MODE_FILE_DEFAULT, STORAGE_MODE_PATH_DEFAULT, false, NULL), sourceFile,
+                storageTest, destinationFile),
+            false, "no server copy");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("copy on server - success");
+
+        TEST_RESULT_BOOL(
+            storageCopyServerP(storagePosixNewP(TEST_PATH_STR), STRDEF("source.txt"), storageTest, STRDEF("destination.txt")),
+            true, "server copy");
+
+        storageTest->pub.interface.copy = NULL;
+        ((StoragePosix *)storageDriver(storageTest))->interface.copy = NULL;
+
         storageRemoveP(storageTest, sourceFile, .errorOnMissing = true);
         storageRemoveP(storageTest, destinationFile, .errorOnMissing = true);
     }
@@ -1189,6 +1324,35 @@ testRun(void)
         TEST_RESULT_VOID(storageReadFree(storageNewReadP(storageTest, fileName)), "free file");
 
         TEST_RESULT_VOID(storageReadMove(NULL, memContextTop()), "move null file");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("read sparse file");
+
+        // Create a file with a hole at the beginning and the end
+        fileName = STRDEF(TEST_PATH "/sparse.file");
+        Buffer *const sparse = bufNew(20480);
+        memset(bufPtr(sparse), 0, bufSize(sparse));
+        memset(bufPtr(sparse) + 8192, 'b', 4096);
+        bufUsedSet(sparse, bufSize(sparse));
+
+        int fd = open(strZ(fileName), O_CREAT | O_TRUNC | O_WRONLY, 0640);
+        TEST_RESULT_INT(pwrite(fd, bufPtr(sparse) + 8192, 4096, 8192), 4096, "write data");
+        TEST_RESULT_INT(ftruncate(fd, 20480), 0, "extend file");
+        TEST_RESULT_INT(close(fd), 0, "close file");
+
+        TEST_ASSIGN(file, storageNewReadP(storageTest, fileName), "new read file");
+        TEST_RESULT_BOOL(ioReadOpen(storageReadIo(file)), true, "open file");
+        TEST_RESULT_BOOL(((StorageReadPosix *)file->driver)->sparse, true, "file is sparse");
+        TEST_RESULT_BOOL(bufEq(ioReadBuf(storageReadIo(file)), sparse), true, "check file contents");
+
+        TEST_ASSIGN(file, storageNewReadP(storageTest, fileName, .offset = 4096, .limit = VARUINT64(12288)), "new read file");
+        TEST_RESULT_BOOL(
+            bufEq(storageGetP(file), BUF(bufPtr(sparse) + 4096, 12288)), true, "check file contents with offset and limit");
+
+        TEST_ASSIGN(file, storageNewReadP(storageTest, STRDEF(TEST_PATH "/test.file")), "new read file");
+        TEST_RESULT_BOOL(ioReadOpen(storageReadIo(file)), true, "open file");
+        TEST_RESULT_BOOL(((StorageReadPosix *)file->driver)->sparse, false, "file is not sparse");
+        TEST_RESULT_VOID(ioReadClose(storageReadIo(file)), "close file");
     }
 
     // *****************************************************************************************************************************
@@ -1330,6 +1494,109 @@ testRun(void)
         TEST_RESULT_INT(storageInfoP(storageTest, fileName).mode, 0600, "check file mode");
 
         storageRemoveP(storageTest, fileName, .errorOnMissing = true);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("write sparse file ending in a hole");
+
+        ioBufferSizeSet(8192);
+
+        Buffer *sparse = bufNew(20480);
+        memset(bufPtr(sparse), 0, bufSize(sparse));
+        memset(bufPtr(sparse), 'a', 100);
+        memset(bufPtr(sparse) + 8192, 'b', 4096);
+        bufUsedSet(sparse, bufSize(sparse));
+
+        TEST_RESULT_VOID(storagePutP(storageNewWriteP(storageTest, fileName, .sparse = true), sparse), "write file");
+        TEST_RESULT_BOOL(bufEq(storageGetP(storageNewReadP(storageTest, fileName)), sparse), true, "check file contents");
+
+        struct stat statFile;
+        TEST_RESULT_INT(stat(strZ(fileName), &statFile), 0, "stat file");
+        TEST_RESULT_INT(statFile.st_size, 20480, "check size");
+        TEST_RESULT_BOOL(statFile.st_blocks * 512 < statFile.st_size, true, "check file is sparse");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("write sparse file ending in a partial block");
+
+        sparse = bufNew(20580);
+        memset(bufPtr(sparse), 0, bufSize(sparse));
+        memset(bufPtr(sparse) + 4096, 'a', 4096);
+        bufUsedSet(sparse, bufSize(sparse));
+
+        TEST_RESULT_VOID(storagePutP(storageNewWriteP(storageTest, fileName, .sparse = true), sparse), "write file");
+        TEST_RESULT_BOOL(bufEq(storageGetP(storageNewReadP(storageTest, fileName)), sparse), true, "check file contents");
+        TEST_RESULT_INT(stat(strZ(fileName), &statFile), 0, "stat file");
+        TEST_RESULT_INT(statFile.st_size, 20580, "check size");
+        TEST_RESULT_BOOL(statFile.st_blocks * 512 < statFile.st_size, true, "check file is sparse");
+
+        storageRemoveP(storageTest, fileName, .errorOnMissing = true);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("checkpoint sparse file ending in a hole");
+
+        Pack *checkpoint = NULL;
+
+        TEST_ASSIGN(file, storageNewWriteP(storageTest, fileName, .noAtomic = true, .sparse = true), "new write");
+        TEST_RESULT_VOID(ioWriteOpen(storageWriteIo(file)), "open");
+        TEST_RESULT_VOID(ioWrite(storageWriteIo(file), BUF(bufPtr(sparse), 12288)), "write");
+        TEST_ASSIGN(checkpoint, storageWriteCheckpoint(file), "checkpoint");
+        TEST_RESULT_UINT(pckReadU64P(pckReadNew(checkpoint)), 12288, "check checkpoint size");
+        TEST_RESULT_INT(stat(strZ(fileName), &statFile), 0, "stat file");
+        TEST_RESULT_INT(statFile.st_size, 12288, "check size");
+        TEST_RESULT_VOID(ioWrite(storageWriteIo(file), BUFSTRDEF("XXXX")), "write data that will be discarded");
+        TEST_RESULT_VOID(ioWriteFlush(storageWriteIo(file)), "flush");
+        TEST_RESULT_VOID(storageWriteFree(file), "free without close");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("resume sparse file from checkpoint");
+
+        TEST_ASSIGN(
+            file, storageNewWriteP(storageTest, fileName, .noAtomic = true, .sparse = true, .resume = checkpoint), "new write");
+        TEST_RESULT_VOID(ioWriteOpen(storageWriteIo(file)), "open");
+        TEST_RESULT_INT(stat(strZ(fileName), &statFile), 0, "stat file");
+        TEST_RESULT_INT(statFile.st_size, 12288, "check size is truncated to checkpoint");
+        TEST_RESULT_VOID(ioWrite(storageWriteIo(file), BUF(bufPtr(sparse), 10000)), "write skipped data");
+        TEST_RESULT_VOID(ioWrite(storageWriteIo(file), BUF(bufPtr(sparse) + 10000, bufUsed(sparse) - 10000)), "write data");
+        TEST_RESULT_VOID(ioWriteClose(storageWriteIo(file)), "close");
+        TEST_RESULT_BOOL(bufEq(storageGetP(storageNewReadP(storageTest, fileName)), sparse), true, "check file contents");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("resume errors");
+
+        TEST_RESULT_VOID(storagePutP(storageNewWriteP(storageTest, fileName), BUFSTRDEF("TOOSMALL")), "write short file");
+        TEST_ERROR_FMT(
+            ioWriteOpen(storageWriteIo(storageNewWriteP(storageTest, fileName, .noAtomic = true, .resume = checkpoint))),
+            FileWriteError, "unable to resume '%s' at 12288 bytes since the file has only 8 bytes", strZ(fileName));
+
+        storageRemoveP(storageTest, fileName, .errorOnMissing = true);
+
+        TEST_ERROR_FMT(
+            ioWriteOpen(storageWriteIo(storageNewWriteP(storageTest, fileName, .noAtomic = true, .resume = checkpoint))),
+            FileMissingError, "unable to resume missing file '%s'", strZ(fileName));
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("write sparse file in parts at offsets");
+
+        StorageWrite *const fileLast = storageNewWriteP(
+            storageTest, fileName, .noAtomic = true, .sparse = true, .noTruncate = true, .offset = 12288);
+        TEST_RESULT_VOID(ioWriteOpen(storageWriteIo(fileLast)), "open last part");
+        TEST_RESULT_VOID(ioWrite(storageWriteIo(fileLast), BUF(bufPtr(sparse) + 12288, 8292)), "write last part");
+
+        TEST_ASSIGN(
+            file, storageNewWriteP(storageTest, fileName, .noAtomic = true, .sparse = true, .noTruncate = true, .offset = 4096),
+            "new write");
+        TEST_RESULT_VOID(ioWriteOpen(storageWriteIo(file)), "open middle part");
+        TEST_RESULT_VOID(ioWrite(storageWriteIo(file), BUF(bufPtr(sparse) + 4096, 8192)), "write middle part");
+        TEST_RESULT_VOID(ioWriteClose(storageWriteIo(fileLast)), "close last part");
+        TEST_RESULT_VOID(ioWriteClose(storageWriteIo(file)), "close middle part ending in a hole");
+
+        TEST_ASSIGN(file, storageNewWriteP(storageTest, fileName, .noAtomic = true, .sparse = true, .noTruncate = true), "new write");
+        TEST_RESULT_VOID(ioWriteOpen(storageWriteIo(file)), "open first part");
+        TEST_RESULT_VOID(ioWrite(storageWriteIo(file), BUF(bufPtr(sparse), 4096)), "write first part");
+        TEST_RESULT_VOID(ioWriteClose(storageWriteIo(file)), "close first part ending in a hole");
+
+        TEST_RESULT_BOOL(bufEq(storageGetP(storageNewReadP(storageTest, fileName)), sparse), true, "check file contents");
+
+        storageRemoveP(storageTest, fileName, .errorOnMissing = true);
     }
 
     // *****************************************************************************************************************************
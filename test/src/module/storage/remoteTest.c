@@ -142,6 +142,15 @@ testRun(void)
         TEST_RESULT_INT(info.timeModified, 1555160001, "mod time");
         TEST_RESULT_STR(info.user, NULL, "user not set");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("file info with checksum (posix does not provide it)");
+
+        TEST_ASSIGN(
+            info, storageInfoP(storageRepo, STRDEF("test"), .level = storageInfoLevelBasic, .checksum = true),
+            "file checksum info");
+        TEST_RESULT_UINT(info.size, 6, "size");
+        TEST_RESULT_STR(info.checksum, NULL, "checksum not set");
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("special info");
 
@@ -300,9 +309,10 @@ testRun(void)
             fileRead, storageNewReadP(storageRepo, STRDEF(TEST_PATH "/repo128/test.txt"), .limit = VARUINT64(8)), "new read");
 
         IoFilterGroup *filterGroup = ioReadFilterGroup(storageReadIo(fileRead));
+        ioFilterGroupAdd(filterGroup, ioRateNew(STRDEF(TEST_PATH "/test" IO_RATE_FILE_EXT), ioRateTypeRead, 1000000, 100));
         ioFilterGroupAdd(filterGroup, ioSizeNew());
         ioFilterGroupAdd(filterGroup, cryptoHashNew(hashTypeSha1));
-        ioFilterGroupAdd(filterGroup, pageChecksumNew(0, PG_SEGMENT_PAGE_DEFAULT, 0));
+        ioFilterGroupAdd(filterGroup, pageChecksumNew(0, PG_SEGMENT_PAGE_DEFAULT, 0, 0));
         ioFilterGroupAdd(filterGroup, cipherBlockNew(cipherModeEncrypt, cipherTypeAes256Cbc, BUFSTRZ("x"), NULL));
         ioFilterGroupAdd(filterGroup, cipherBlockNew(cipherModeDecrypt, cipherTypeAes256Cbc, BUFSTRZ("x"), NULL));
         ioFilterGroupAdd(filterGroup, compressFilter(compressTypeGz, 3));
@@ -312,9 +322,9 @@ testRun(void)
 
         TEST_RESULT_STR_Z(
             hrnPackToStr(ioFilterGroupResultAll(filterGroup)),
-            "1:strid:size, 2:pack:<1:u64:8>, 3:strid:hash, 4:pack:<1:str:bbbcf2c59433f68f22376cd2439d6cd309378df6>,"
-                " 5:strid:pg-chksum, 6:pack:<2:bool:false, 3:bool:false>, 7:strid:cipher-blk, 9:strid:cipher-blk, 11:strid:gz-cmp,"
-                " 13:strid:gz-dcmp, 15:strid:buffer",
+            "1:strid:rate, 2:pack:<>, 3:strid:size, 4:pack:<1:u64:8>, 5:strid:hash,"
+                " 6:pack:<1:str:bbbcf2c59433f68f22376cd2439d6cd309378df6>, 7:strid:pg-chksum, 8:pack:<2:bool:false, 3:bool:false>,"
+                " 9:strid:cipher-blk, 11:strid:cipher-blk, 13:strid:gz-cmp, 15:strid:gz-dcmp, 17:strid:buffer",
             "filter results");
 
         // Check protocol function directly (file exists but all data goes to sink)